@@ -0,0 +1,759 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_dpdk.c
+ * @brief  DPDK adapter of the RLE library, encapsulation and decapsulation of rte_mbuf
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include "rle_dpdk.h"
+#include "rle_allocator.h"
+#include "constants.h"
+#include "header.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#define MODULE_ID RLE_MOD_ID_DPDK
+
+/** Max size of a FPDU label */
+#define RLE_DPDK_MAX_LABEL_SIZE  6
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE STRUCTS AND TYPEDEFS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** DPDK RLE transmitter */
+struct rle_dpdk_tx {
+	struct rle_transmitter *transmitter;            /**< The RLE transmitter              */
+	struct rte_mempool *fpdu_pool;                  /**< The mempool of the FPDU mbufs    */
+	struct rte_mbuf *sdus[RLE_MAX_FRAG_NUMBER];     /**< The SDU of each context, or NULL */
+	size_t sdus_nr;                                 /**< The number of SDUs owned         */
+	uint8_t contexts_nr;                            /**< The number of contexts           */
+	uint8_t next_frag_id;                           /**< The next context to serve        */
+	unsigned char label[RLE_DPDK_MAX_LABEL_SIZE];   /**< The FPDU label fields            */
+	size_t label_size;                              /**< Size of the FPDU label fields    */
+	size_t fpdu_size;                               /**< The size of the FPDUs            */
+	struct rle_allocator allocator;                 /**< Allocator of the DPDK transmitter */
+};
+
+/** DPDK RLE receiver */
+struct rle_dpdk_rx {
+	struct rle_receiver *receiver;                           /**< The RLE receiver            */
+	struct rte_mempool *sdu_pool;                            /**< The mempool of the SDUs     */
+	unsigned char payload_label[RLE_DPDK_MAX_LABEL_SIZE];    /**< The last payload label      */
+	size_t payload_label_size;                               /**< The size of payload labels  */
+	uint64_t sdus_dropped;                                   /**< The number of SDUs dropped  */
+	struct rte_mbuf *fpdu;                                   /**< The FPDU being decapsulated */
+	struct rte_mbuf **sdus;                                  /**< The SDUs of the burst       */
+	uint16_t sdus_max_nr;                                    /**< The max number of SDUs      */
+	uint16_t sdus_nr;                                        /**< The number of SDUs          */
+	struct rle_allocator allocator;                          /**< Allocator of the receiver   */
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PRIVATE FUNCTIONS --------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Check whether a SDU mbuf can be encapsulated in place.
+ *
+ * @param[in]     mbuf                    The SDU mbuf.
+ *
+ * @return        true if the mbuf is contiguous, direct, unshared, and with room for the ALPDU
+ *                header and trailer, else false.
+ */
+static bool mbuf_is_encapsulable_in_place(const struct rte_mbuf *const mbuf);
+
+/**
+ * @brief         Encapsulate a SDU mbuf, in place if possible.
+ *
+ * @param[in,out] tx                      The DPDK transmitter.
+ * @param[in]     mbuf                    The SDU mbuf.
+ * @param[in]     protocol_type           The protocol type (uncompressed) of the SDU.
+ * @param[in]     frag_id                 The free context of the SDU.
+ *
+ * @return        Encapsulation status.
+ */
+static enum rle_encap_status encap_mbuf(struct rle_dpdk_tx *const tx,
+                                        struct rte_mbuf *const mbuf,
+                                        const uint16_t protocol_type,
+                                        const uint8_t frag_id);
+
+/**
+ * @brief         Check whether a PPDU is the last one of its ALPDU.
+ *
+ * @param[in]     ppdu                    The PPDU.
+ *
+ * @return        true for an END or COMPLETE PPDU, else false.
+ */
+static bool ppdu_is_last(const unsigned char *const ppdu);
+
+/**
+ * @brief         Check whether a buffer lies in the data buffer of a contiguous and direct mbuf.
+ *
+ * @param[in]     mbuf                    The mbuf.
+ * @param[in]     buffer                  The buffer.
+ * @param[in]     length                  The size of the buffer.
+ *
+ * @return        true if the buffer may be shared with an indirect mbuf, else false.
+ */
+static bool mbuf_holds(const struct rte_mbuf *const mbuf, const unsigned char *const buffer,
+                       const size_t length);
+
+/**
+ * @brief         Copy data at the end of a mbuf chain, in the last mbuf of the chain if it is
+ *                direct, then in new mbufs chained to it.
+ *
+ * @param[in,out] head                    The first mbuf of the chain.
+ * @param[in]     pool                    The mempool of the new mbufs.
+ * @param[in]     data                    The data to copy, NULL to write zeros.
+ * @param[in]     length                  The size of the data.
+ *
+ * @return        0 if OK, 1 if a mbuf cannot be allocated or chained.
+ */
+static int mbuf_write(struct rte_mbuf *const head, struct rte_mempool *const pool,
+                      const unsigned char *const data, const size_t length);
+
+/**
+ * @brief         Chain to a mbuf chain an indirect mbuf attached to a part of another mbuf.
+ *
+ * @param[in,out] head                    The first mbuf of the chain.
+ * @param[in]     pool                    The mempool of the indirect mbuf.
+ * @param[in]     mbuf                    The mbuf holding the part, contiguous and direct.
+ * @param[in]     buffer                  The part of the mbuf.
+ * @param[in]     length                  The size of the part.
+ *
+ * @return        0 if OK, 1 if the indirect mbuf cannot be allocated or chained.
+ */
+static int mbuf_chain_part(struct rte_mbuf *const head, struct rte_mempool *const pool,
+                           struct rte_mbuf *const mbuf, const unsigned char *const buffer,
+                           const size_t length);
+
+/**
+ * @brief         Fragment the next PPDU of a context and pack it in a FPDU mbuf.
+ *
+ * @param[in,out] tx                      The DPDK transmitter.
+ * @param[in]     frag_id                 The context, with a SDU.
+ * @param[in,out] fpdu                    The FPDU.
+ *
+ * @return        Frame packing status, as \ref rle_fragment_pack.
+ */
+static enum rle_pack_status fragment_pack_mbuf(struct rle_dpdk_tx *const tx,
+                                               const uint8_t frag_id,
+                                               struct rte_mbuf *const fpdu);
+
+/**
+ * @brief         Fill a FPDU mbuf with the PPDUs of the contexts served in turn.
+ *
+ * @param[in,out] tx                      The DPDK transmitter.
+ * @param[in,out] fpdu                    The empty FPDU.
+ */
+static void fill_fpdu(struct rle_dpdk_tx *const tx, struct rte_mbuf *const fpdu);
+
+/**
+ * @brief         Free the SDU mbuf of a context.
+ *
+ * @param[in,out] tx                      The DPDK transmitter.
+ * @param[in]     frag_id                 The context, with a SDU.
+ */
+static void release_sdu(struct rle_dpdk_tx *const tx, const uint8_t frag_id);
+
+/**
+ * @brief         Deliver one SDU as a mbuf, delivery callback of the in-place decapsulation.
+ *
+ * @param[in,out] arg                     The argument of the delivery, the DPDK receiver.
+ * @param[in]     sdu                     The SDU, left in the FPDU or in the reassembly storage.
+ */
+static void deliver_sdu(void *const arg, const struct rle_sdu *const sdu);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PRIVATE FUNCTIONS CODE ------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static bool mbuf_is_encapsulable_in_place(const struct rte_mbuf *const mbuf)
+{
+	return rte_pktmbuf_is_contiguous(mbuf) && RTE_MBUF_DIRECT(mbuf) &&
+	       rte_mbuf_refcnt_read(mbuf) == 1 &&
+	       rte_pktmbuf_headroom(mbuf) >= RLE_ENCAP_HEADROOM &&
+	       rte_pktmbuf_tailroom(mbuf) >= RLE_ENCAP_TAILROOM;
+}
+
+static enum rle_encap_status encap_mbuf(struct rle_dpdk_tx *const tx,
+                                        struct rte_mbuf *const mbuf,
+                                        const uint16_t protocol_type,
+                                        const uint8_t frag_id)
+{
+	struct rle_sdu_segment segments[RLE_DPDK_MAX_SEGMENTS];
+	const struct rte_mbuf *seg;
+	size_t segments_nr = 0;
+
+	if (mbuf_is_encapsulable_in_place(mbuf)) {
+		const struct rle_sdu sdu = {
+			.buffer = rte_pktmbuf_mtod(mbuf, unsigned char *),
+			.size = mbuf->data_len,
+			.protocol_type = protocol_type,
+		};
+
+		return rle_encapsulate_zero_copy(tx->transmitter, &sdu, rte_pktmbuf_headroom(mbuf),
+		                                 rte_pktmbuf_tailroom(mbuf), frag_id);
+	}
+
+	if (mbuf->nb_segs > RLE_DPDK_MAX_SEGMENTS) {
+		RLE_ERR("%u-segment SDU, at most %d segments supported", mbuf->nb_segs,
+		        RLE_DPDK_MAX_SEGMENTS);
+		return RLE_ENCAP_ERR;
+	}
+
+	for (seg = mbuf; seg != NULL; seg = seg->next) {
+		segments[segments_nr].buffer = rte_pktmbuf_mtod(seg, const unsigned char *);
+		segments[segments_nr].size = seg->data_len;
+		segments_nr++;
+	}
+
+	return rle_encapsulate_segments(tx->transmitter, segments, segments_nr, protocol_type,
+	                                frag_id);
+}
+
+static bool ppdu_is_last(const unsigned char *const ppdu)
+{
+	const rle_ppdu_hdr_t *const ppdu_hdr = (const rle_ppdu_hdr_t *)ppdu;
+
+	return ppdu_hdr->common.end_ind == 1;
+}
+
+static bool mbuf_holds(const struct rte_mbuf *const mbuf, const unsigned char *const buffer,
+                       const size_t length)
+{
+	const unsigned char *const buf_start = (const unsigned char *)mbuf->buf_addr;
+
+	return rte_pktmbuf_is_contiguous(mbuf) && RTE_MBUF_DIRECT(mbuf) && buffer >= buf_start &&
+	       buffer + length <= buf_start + mbuf->buf_len;
+}
+
+static int mbuf_write(struct rte_mbuf *const head, struct rte_mempool *const pool,
+                      const unsigned char *const data, const size_t length)
+{
+	size_t written = 0;
+
+	while (written < length) {
+		struct rte_mbuf *last = rte_pktmbuf_lastseg(head);
+		size_t room = RTE_MBUF_DIRECT(last) ? rte_pktmbuf_tailroom(last) : 0;
+		char *dst;
+
+		/* the tailroom of an indirect mbuf belongs to the mbuf it is attached to */
+		if (room == 0) {
+			last = rte_pktmbuf_alloc(pool);
+			if (last == NULL) {
+				return 1;
+			}
+			if (rte_pktmbuf_chain(head, last) != 0) {
+				rte_pktmbuf_free(last);
+				return 1;
+			}
+			room = rte_pktmbuf_tailroom(last);
+		}
+		if (room > (length - written)) {
+			room = length - written;
+		}
+
+		dst = rte_pktmbuf_append(head, (uint16_t)room);
+		if (data != NULL) {
+			memcpy(dst, data + written, room);
+		} else {
+			memset(dst, 0, room);
+		}
+		written += room;
+	}
+
+	return 0;
+}
+
+static int mbuf_chain_part(struct rte_mbuf *const head, struct rte_mempool *const pool,
+                           struct rte_mbuf *const mbuf, const unsigned char *const buffer,
+                           const size_t length)
+{
+	struct rte_mbuf *const indirect = rte_pktmbuf_alloc(pool);
+
+	if (indirect == NULL) {
+		return 1;
+	}
+
+	rte_pktmbuf_attach(indirect, mbuf);
+	indirect->data_off = (uint16_t)(buffer - (const unsigned char *)indirect->buf_addr);
+	indirect->data_len = (uint16_t)length;
+	indirect->pkt_len = (uint32_t)length;
+
+	if (rte_pktmbuf_chain(head, indirect) != 0) {
+		rte_pktmbuf_free(indirect);
+		return 1;
+	}
+
+	return 0;
+}
+
+static enum rle_pack_status fragment_pack_mbuf(struct rle_dpdk_tx *const tx,
+                                               const uint8_t frag_id,
+                                               struct rte_mbuf *const fpdu)
+{
+	enum rle_pack_status status;
+	enum rle_frag_status frag_status;
+	const size_t ppdu_base_hdr_len = 2;
+	unsigned char *ppdu;
+	size_t ppdu_length;
+	size_t label_len_in_fpdu;
+	size_t room;
+
+	/* the FPDU label is only written before the first PPDU of the FPDU */
+	label_len_in_fpdu = (fpdu->pkt_len == 0 ? tx->label_size : 0);
+
+	if ((tx->fpdu_size - fpdu->pkt_len) <= label_len_in_fpdu) {
+		status = RLE_PACK_ERR_FPDU_TOO_SMALL;
+		goto exit_label;
+	}
+
+	/* a single PPDU cannot be larger than its length field allows */
+	room = tx->fpdu_size - fpdu->pkt_len - label_len_in_fpdu;
+	if (room > (RLE_MAX_PPDU_PL_SIZE + ppdu_base_hdr_len)) {
+		room = RLE_MAX_PPDU_PL_SIZE + ppdu_base_hdr_len;
+	}
+
+	frag_status = rle_fragment(tx->transmitter, frag_id, room, &ppdu, &ppdu_length);
+	switch (frag_status) {
+	case RLE_FRAG_OK:
+		break;
+	case RLE_FRAG_ERR_BURST_TOO_SMALL:
+		status = RLE_PACK_ERR_FPDU_TOO_SMALL;
+		goto exit_label;
+	case RLE_FRAG_ERR_CONTEXT_IS_NULL:
+		status = RLE_PACK_ERR_INVALID_PPDU;
+		goto exit_label;
+	default:
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	if (label_len_in_fpdu > 0 &&
+	    mbuf_write(fpdu, tx->fpdu_pool, tx->label, label_len_in_fpdu) != 0) {
+		RLE_ERR("FPDU label not written, SDU dropped");
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	/* nothing is written over the last PPDU of an ALPDU encapsulated in place anymore, it is
+	 * shared with the SDU mbuf rather than copied */
+	if (ppdu_is_last(ppdu) && mbuf_holds(tx->sdus[frag_id], ppdu, ppdu_length)) {
+		if (mbuf_chain_part(fpdu, tx->fpdu_pool, tx->sdus[frag_id], ppdu, ppdu_length) != 0) {
+			RLE_ERR("%zu-byte PPDU not chained to the FPDU, SDU dropped", ppdu_length);
+			status = RLE_PACK_ERR;
+			goto exit_label;
+		}
+	} else if (mbuf_write(fpdu, tx->fpdu_pool, ppdu, ppdu_length) != 0) {
+		RLE_ERR("%zu-byte PPDU not copied in the FPDU, SDU dropped", ppdu_length);
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	status = RLE_PACK_OK;
+
+exit_label:
+	return status;
+}
+
+static void fill_fpdu(struct rle_dpdk_tx *const tx, struct rte_mbuf *const fpdu)
+{
+	uint8_t served;
+
+	for (served = 0; served < tx->contexts_nr && tx->sdus_nr > 0; served++) {
+		const uint8_t frag_id = tx->next_frag_id;
+
+		if (tx->sdus[frag_id] != NULL) {
+			const enum rle_pack_status status = fragment_pack_mbuf(tx, frag_id, fpdu);
+
+			if (status == RLE_PACK_ERR_FPDU_TOO_SMALL) {
+				/* the FPDU is full, the context is served first in the next FPDU */
+				return;
+			}
+			if (status != RLE_PACK_OK) {
+				RLE_ERR("SDU of context %u not fragmented, SDU dropped", frag_id);
+				release_sdu(tx, frag_id);
+			} else if (rle_transmitter_stats_get_queue_size(tx->transmitter, frag_id) > 0) {
+				/* the PPDU filled the FPDU, the context goes on in the next FPDU */
+				return;
+			} else {
+				release_sdu(tx, frag_id);
+			}
+		}
+
+		tx->next_frag_id = (frag_id + 1) % tx->contexts_nr;
+	}
+}
+
+static void release_sdu(struct rle_dpdk_tx *const tx, const uint8_t frag_id)
+{
+	/* the last PPDU of the SDU may still be shared with a FPDU */
+	rte_pktmbuf_free(tx->sdus[frag_id]);
+	tx->sdus[frag_id] = NULL;
+	tx->sdus_nr--;
+}
+
+static void deliver_sdu(void *const arg, const struct rle_sdu *const sdu)
+{
+	struct rle_dpdk_rx *const rx = (struct rle_dpdk_rx *)arg;
+	struct rte_mbuf *mbuf;
+
+	if (rx->sdus_nr == rx->sdus_max_nr) {
+		RLE_WARN("SDUs burst full, %zu-byte SDU dropped", sdu->size);
+		rx->sdus_dropped++;
+		return;
+	}
+
+	mbuf = rte_pktmbuf_alloc(rx->sdu_pool);
+	if (mbuf == NULL) {
+		RLE_WARN("no mbuf for the %zu-byte SDU, SDU dropped", sdu->size);
+		rx->sdus_dropped++;
+		return;
+	}
+
+	if (mbuf_holds(rx->fpdu, sdu->buffer, sdu->size)) {
+		/* SDU of a COMPLETE PPDU, shared with the FPDU */
+		rte_pktmbuf_attach(mbuf, rx->fpdu);
+		mbuf->data_off = (uint16_t)(sdu->buffer - (const unsigned char *)mbuf->buf_addr);
+		mbuf->data_len = (uint16_t)sdu->size;
+		mbuf->pkt_len = (uint32_t)sdu->size;
+	} else if (mbuf_write(mbuf, rx->sdu_pool, sdu->buffer, sdu->size) != 0) {
+		/* SDU reassembled in the storage of the receiver, only valid during the callback */
+		RLE_WARN("no mbuf for the %zu-byte SDU, SDU dropped", sdu->size);
+		rte_pktmbuf_free(mbuf);
+		rx->sdus_dropped++;
+		return;
+	}
+
+	switch (sdu->protocol_type) {
+	case RLE_PROTO_TYPE_IPV4_UNCOMP:
+		mbuf->packet_type = RTE_PTYPE_L3_IPV4;
+		break;
+	case RLE_PROTO_TYPE_IPV6_UNCOMP:
+		mbuf->packet_type = RTE_PTYPE_L3_IPV6;
+		break;
+	default:
+		mbuf->packet_type = RTE_PTYPE_UNKNOWN;
+		break;
+	}
+
+	rx->sdus[rx->sdus_nr++] = mbuf;
+}
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+struct rle_dpdk_tx * rle_dpdk_tx_new(const struct rle_config *const conf,
+                                     struct rte_mempool *const fpdu_pool,
+                                     const unsigned char *const label,
+                                     const size_t label_size,
+                                     const size_t fpdu_size)
+{
+	struct rle_dpdk_tx *tx = NULL;
+	struct rle_allocator allocator;
+
+	if (conf == NULL || fpdu_pool == NULL) {
+		RLE_ERR("configuration or FPDU mempool is NULL");
+		goto error;
+	}
+	if ((label_size != 0 && label_size != 3 && label_size != 6) ||
+	    (label_size > 0 && label == NULL)) {
+		RLE_ERR("invalid %zu-byte FPDU label", label_size);
+		goto error;
+	}
+	if (fpdu_size <= label_size) {
+		RLE_ERR("%zu-byte FPDUs too small for a %zu-byte FPDU label", fpdu_size, label_size);
+		goto error;
+	}
+
+	rle_get_allocator(&allocator);
+
+	tx = (struct rle_dpdk_tx *)rle_alloc(&allocator, sizeof(struct rle_dpdk_tx));
+	if (tx == NULL) {
+		RLE_ERR("DPDK transmitter not allocated");
+		goto error;
+	}
+	memset(tx, 0, sizeof(struct rle_dpdk_tx));
+	tx->allocator = allocator;
+
+	tx->transmitter = rle_transmitter_new_with_allocator(conf, &allocator);
+	if (tx->transmitter == NULL) {
+		RLE_ERR("RLE transmitter not created");
+		goto free_tx;
+	}
+
+	tx->fpdu_pool = fpdu_pool;
+	tx->contexts_nr = (conf->fragment_contexts_nr == 0 ? RLE_MAX_FRAG_NUMBER :
+	                   conf->fragment_contexts_nr);
+	if (label_size > 0) {
+		memcpy(tx->label, label, label_size);
+	}
+	tx->label_size = label_size;
+	tx->fpdu_size = fpdu_size;
+
+	return tx;
+
+free_tx:
+	rle_free(&allocator, tx);
+error:
+	return NULL;
+}
+
+void rle_dpdk_tx_destroy(struct rle_dpdk_tx **const tx)
+{
+	struct rle_allocator allocator;
+	uint8_t frag_id;
+
+	if (tx == NULL || *tx == NULL) {
+		goto out;
+	}
+
+	for (frag_id = 0; frag_id < (*tx)->contexts_nr; frag_id++) {
+		if ((*tx)->sdus[frag_id] != NULL) {
+			release_sdu(*tx, frag_id);
+		}
+	}
+	rle_transmitter_destroy(&(*tx)->transmitter);
+
+	/* the allocator is read before it is released with the DPDK transmitter */
+	allocator = (*tx)->allocator;
+	rle_free(&allocator, *tx);
+	*tx = NULL;
+
+out:
+	return;
+}
+
+struct rle_transmitter * rle_dpdk_tx_get_transmitter(const struct rle_dpdk_tx *const tx)
+{
+	return tx->transmitter;
+}
+
+uint16_t rle_dpdk_encap_burst(struct rle_dpdk_tx *const tx,
+                              struct rte_mbuf *sdus[],
+                              const uint16_t protocol_types[],
+                              const uint16_t sdus_nr)
+{
+	uint16_t consumed_nr = 0;
+	uint8_t frag_id = 0;
+
+	if (tx == NULL || sdus == NULL || protocol_types == NULL) {
+		goto out;
+	}
+
+	for (consumed_nr = 0; consumed_nr < sdus_nr; consumed_nr++) {
+		struct rte_mbuf *const sdu = sdus[consumed_nr];
+
+		/* each SDU gets the first free context */
+		while (frag_id < tx->contexts_nr && tx->sdus[frag_id] != NULL) {
+			frag_id++;
+		}
+		if (frag_id == tx->contexts_nr) {
+			break;
+		}
+
+		if (encap_mbuf(tx, sdu, protocol_types[consumed_nr], frag_id) != RLE_ENCAP_OK) {
+			RLE_WARN("%u-byte SDU not encapsulated, SDU dropped", sdu->pkt_len);
+			rte_pktmbuf_free(sdu);
+			continue;
+		}
+
+		tx->sdus[frag_id] = sdu;
+		tx->sdus_nr++;
+	}
+
+out:
+	return consumed_nr;
+}
+
+uint16_t rle_dpdk_fpdu_burst(struct rle_dpdk_tx *const tx,
+                             struct rte_mbuf *fpdus[],
+                             const uint16_t fpdus_max_nr)
+{
+	uint16_t fpdus_nr = 0;
+
+	if (tx == NULL || fpdus == NULL) {
+		goto out;
+	}
+
+	while (fpdus_nr < fpdus_max_nr && tx->sdus_nr > 0) {
+		struct rte_mbuf *const fpdu = rte_pktmbuf_alloc(tx->fpdu_pool);
+
+		if (fpdu == NULL) {
+			RLE_WARN("no mbuf for the next FPDU");
+			break;
+		}
+
+		fill_fpdu(tx, fpdu);
+
+		if (fpdu->pkt_len == 0 ||
+		    mbuf_write(fpdu, tx->fpdu_pool, NULL, tx->fpdu_size - fpdu->pkt_len) != 0) {
+			rte_pktmbuf_free(fpdu);
+			break;
+		}
+
+		fpdus[fpdus_nr++] = fpdu;
+	}
+
+out:
+	return fpdus_nr;
+}
+
+struct rle_dpdk_rx * rle_dpdk_rx_new(const struct rle_config *const conf,
+                                     struct rte_mempool *const sdu_pool,
+                                     const size_t payload_label_size)
+{
+	struct rle_dpdk_rx *rx = NULL;
+	struct rle_allocator allocator;
+
+	if (conf == NULL || sdu_pool == NULL) {
+		RLE_ERR("configuration or SDU mempool is NULL");
+		goto error;
+	}
+	if (payload_label_size != 0 && payload_label_size != 3 && payload_label_size != 6) {
+		RLE_ERR("invalid %zu-byte payload label", payload_label_size);
+		goto error;
+	}
+
+	rle_get_allocator(&allocator);
+
+	rx = (struct rle_dpdk_rx *)rle_alloc(&allocator, sizeof(struct rle_dpdk_rx));
+	if (rx == NULL) {
+		RLE_ERR("DPDK receiver not allocated");
+		goto error;
+	}
+	memset(rx, 0, sizeof(struct rle_dpdk_rx));
+	rx->allocator = allocator;
+
+	rx->receiver = rle_receiver_new_with_allocator(conf, &allocator);
+	if (rx->receiver == NULL) {
+		RLE_ERR("RLE receiver not created");
+		goto free_rx;
+	}
+
+	rx->sdu_pool = sdu_pool;
+	rx->payload_label_size = payload_label_size;
+
+	return rx;
+
+free_rx:
+	rle_free(&allocator, rx);
+error:
+	return NULL;
+}
+
+void rle_dpdk_rx_destroy(struct rle_dpdk_rx **const rx)
+{
+	struct rle_allocator allocator;
+
+	if (rx == NULL || *rx == NULL) {
+		goto out;
+	}
+
+	rle_receiver_destroy(&(*rx)->receiver);
+
+	/* the allocator is read before it is released with the DPDK receiver */
+	allocator = (*rx)->allocator;
+	rle_free(&allocator, *rx);
+	*rx = NULL;
+
+out:
+	return;
+}
+
+struct rle_receiver * rle_dpdk_rx_get_receiver(const struct rle_dpdk_rx *const rx)
+{
+	return rx->receiver;
+}
+
+uint64_t rle_dpdk_rx_get_sdus_dropped(const struct rle_dpdk_rx *const rx)
+{
+	return rx->sdus_dropped;
+}
+
+uint16_t rle_dpdk_decap_burst(struct rle_dpdk_rx *const rx,
+                              struct rte_mbuf *fpdus[],
+                              const uint16_t fpdus_nr,
+                              struct rte_mbuf *sdus[],
+                              const uint16_t sdus_max_nr)
+{
+	const struct rle_decap_callbacks callbacks = {
+		.alloc = NULL, .deliver = deliver_sdu, .arg = rx,
+	};
+	uint16_t i;
+
+	if (rx == NULL || fpdus == NULL || sdus == NULL) {
+		return 0;
+	}
+
+	rx->sdus = sdus;
+	rx->sdus_max_nr = sdus_max_nr;
+	rx->sdus_nr = 0;
+
+	for (i = 0; i < fpdus_nr; i++) {
+		struct rte_mbuf *const fpdu = fpdus[i];
+		enum rle_decap_status status;
+		size_t sdus_nr;
+
+		/* the VLAN protocol types are rebuilt inside the FPDU */
+		if ((!rte_pktmbuf_is_contiguous(fpdu) && rte_pktmbuf_linearize(fpdu) != 0) ||
+		    !RTE_MBUF_DIRECT(fpdu) || rte_mbuf_refcnt_read(fpdu) != 1) {
+			RLE_ERR("%u-byte FPDU not contiguous nor writable, FPDU dropped", fpdu->pkt_len);
+			rte_pktmbuf_free(fpdu);
+			continue;
+		}
+
+		rx->fpdu = fpdu;
+		status = rle_decapsulate_cb(rx->receiver, rte_pktmbuf_mtod(fpdu, unsigned char *),
+		                            fpdu->data_len, &callbacks, &sdus_nr, rx->payload_label,
+		                            rx->payload_label_size);
+		if (status != RLE_DECAP_OK) {
+			RLE_WARN("FPDU #%u of the burst partially decapsulated", i + 1);
+		}
+
+		/* the SDUs of its COMPLETE PPDUs still hold the FPDU */
+		rte_pktmbuf_free(fpdu);
+	}
+
+	rx->fpdu = NULL;
+	rx->sdus = NULL;
+
+	return rx->sdus_nr;
+}
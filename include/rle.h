@@ -57,6 +57,30 @@
 /**  Max number of fragment id */
 #define RLE_MAX_FRAG_NUMBER                     (RLE_MAX_FRAG_ID + 1)
 
+/** Number of traffic classes sharing the fragment ids of a transmitter, 0 is the highest priority */
+#define RLE_TRAFFIC_CLASSES_NR                  4
+
+/** Headroom required before the SDU for zero-copy encapsulation (PPDU and ALPDU headers) */
+#define RLE_ENCAP_HEADROOM                      7
+
+/** Tailroom required after the SDU for zero-copy encapsulation (ALPDU trailer) */
+#define RLE_ENCAP_TAILROOM                      4
+
+/** Alignment of the memory of the transmitters and receivers initialized in place */
+#define RLE_IN_PLACE_ALIGNMENT                  64
+
+/** Size of the small SDU buffers of a receiver SDU pool */
+#define RLE_SDU_POOL_SMALL_SIZE                 128
+
+/** Size of the medium SDU buffers of a receiver SDU pool, an Ethernet frame */
+#define RLE_SDU_POOL_MEDIUM_SIZE                1536
+
+/** Size of the jumbo SDU buffers of a receiver SDU pool, any SDU */
+#define RLE_SDU_POOL_JUMBO_SIZE                 RLE_MAX_PDU_SIZE
+
+/** Max number of ALPDUs in a transmitter pipe */
+#define RLE_TX_PIPE_MAX_DEPTH                   4096
+
 /** Status of the encapsulation. */
 enum rle_encap_status {
 	RLE_ENCAP_OK,                /**< Ok.                                    */
@@ -64,7 +88,9 @@ enum rle_encap_status {
 	RLE_ENCAP_ERR_NULL_TRMT,     /**< Error. The transmitter is NULL.        */
 	RLE_ENCAP_ERR_NULL_F_BUFF,   /**< Error. Fragmentation buffer is NULL.   */
 	RLE_ENCAP_ERR_N_INIT_F_BUFF, /**< Error. Fragmentation buffer not init.  */
-	RLE_ENCAP_ERR_SDU_TOO_BIG    /**< Error. SDU too big to be encapsulated. */
+	RLE_ENCAP_ERR_SDU_TOO_BIG,   /**< Error. SDU too big to be encapsulated. */
+	RLE_ENCAP_ERR_NO_ROOM,       /**< Error. Not enough headroom or tailroom. */
+	RLE_ENCAP_ERR_PIPE_FULL      /**< Error. The transmitter pipe is full. No drop. */
 };
 
 /** Status of the fragmentation. */
@@ -97,7 +123,23 @@ enum rle_decap_status {
 	RLE_DECAP_ERR_SOME_DROP, /**< Error. Some SDUs were dropped. Some may be lost.          */
 	RLE_DECAP_ERR_INV_FPDU,  /**< Error. Invalid FPDU. Maybe Null or bad size.              */
 	RLE_DECAP_ERR_INV_SDUS,  /**< Error. Given preallocated SDUs array is invalid.          */
-	RLE_DECAP_ERR_INV_PL     /**< Error. Given preallocated payload label array is invalid. */
+	RLE_DECAP_ERR_INV_PL,    /**< Error. Given preallocated payload label array is invalid. */
+	RLE_DECAP_PAUSED         /**< Ok. SDUs array full, FPDU partially parsed, to be resumed. */
+};
+
+/** Classes of the SDU buffers of a receiver SDU pool, by size */
+enum rle_sdu_pool_class {
+	RLE_SDU_POOL_SMALL,     /**< Buffers of RLE_SDU_POOL_SMALL_SIZE bytes.  */
+	RLE_SDU_POOL_MEDIUM,    /**< Buffers of RLE_SDU_POOL_MEDIUM_SIZE bytes. */
+	RLE_SDU_POOL_JUMBO,     /**< Buffers of RLE_SDU_POOL_JUMBO_SIZE bytes.  */
+	RLE_SDU_POOL_CLASSES_NR /**< The number of classes.                    */
+};
+
+/** Verification of the FPDU padding by the receiver. */
+enum rle_padding_check {
+	RLE_PADDING_CHECK_STRICT,  /**< The padding of every FPDU is verified.                    */
+	RLE_PADDING_CHECK_SAMPLED, /**< The padding of one FPDU out of RLE_PADDING_CHECK_SAMPLING. */
+	RLE_PADDING_CHECK_NONE     /**< The padding is not verified.                              */
 };
 
 /** Status of RLE header size. */
@@ -115,6 +157,12 @@ enum rle_fpdu_types {
 	RLE_TRAFFIC_CTRL_FPDU, /**< Traffic and control FPDU. */
 };
 
+/** Kernels available for the ALPDU CRC32 computation. */
+enum rle_crc_impl {
+	RLE_CRC_IMPL_SLICE_BY_8, /**< Portable C, 8 octets per step with 8 lookup tables. */
+	RLE_CRC_IMPL_PCLMUL,     /**< x86 carry-less multiplication (PCLMULQDQ).          */
+};
+
 /** Protocol types field values compressed. */
 enum {
 	/* for signaling. */
@@ -163,6 +211,108 @@ enum {
 	RLE_PROTO_TYPE_ADJACENT_2BYTES_PTYPE
 };
 
+/**
+ * Classes of the protocol types of the SDUs counted by a transmitter, to choose the implicit
+ * protocol type omitted from the most ALPDU headers.
+ */
+enum rle_ptype_class {
+	RLE_PTYPE_CLASS_IPV4,   /**< IPv4 SDUs.                                  */
+	RLE_PTYPE_CLASS_IPV6,   /**< IPv6 SDUs.                                  */
+	RLE_PTYPE_CLASS_VLAN,   /**< 802.1Q VLAN SDUs.                           */
+	RLE_PTYPE_CLASS_ARP,    /**< ARP SDUs.                                   */
+	RLE_PTYPE_CLASS_OTHER,  /**< Signalling and any other protocol type.     */
+	RLE_PTYPE_CLASSES_NR    /**< Number of classes.                          */
+};
+
+/** Max number of worker threads of a decapsulation engine. */
+#define RLE_DECAP_ENGINE_MAX_WORKERS  64
+
+/** Period, in FPDUs, of the padding verification in RLE_PADDING_CHECK_SAMPLED mode. */
+#define RLE_PADDING_CHECK_SAMPLING  16
+
+/**
+ * Number of buckets of a timing histogram. Bucket n counts the durations from 2^n to 2^(n+1) - 1
+ * ns, bucket 0 the durations below 2 ns, the last bucket the longer ones.
+ */
+#define RLE_TIMING_BUCKETS_NR  32
+
+/**
+ * Number of buckets of the SDU sizes histograms. Bucket n counts the SDUs from 2^n to 2^(n+1) - 1
+ * octets, bucket 0 the SDUs below 2 octets.
+ */
+#define RLE_SDU_SIZE_BUCKETS_NR  12
+
+/**
+ * Number of buckets of the PPDUs per SDU histograms. Bucket n counts the SDUs sent or received in
+ * n + 1 PPDUs, the last bucket the SDUs in more.
+ */
+#define RLE_PPDUS_BUCKETS_NR  16
+
+/**
+ * Fragment id of the histograms of the SDUs received in COMPLETE PPDUs, which carry no fragment
+ * id.
+ */
+#define RLE_SIZE_STATS_COMP_ID  RLE_MAX_FRAG_NUMBER
+
+/**
+ * Stages timed when the library is built with the TIMING_STATS option.
+ *
+ * The reassembly stages are ordered as the PPDU types, from their start and end indicators.
+ */
+enum rle_timing_stage {
+	RLE_TIMING_ALPDU_HDR,   /**< Transmitter, push of the ALPDU header.                      */
+	RLE_TIMING_CRC,         /**< Transmitter, CRC of a SDU encapsulated in place.            */
+	RLE_TIMING_SDU_COPY,    /**< Transmitter, copy of a SDU, with its CRC computed on the fly. */
+	RLE_TIMING_PPDU_HDR,    /**< Transmitter, push of a PPDU header.                         */
+	RLE_TIMING_PACK,        /**< Library-wide, packing of a PPDU in a FPDU.                  */
+	RLE_TIMING_RASM_CONT,   /**< Receiver, reassembly of a CONTINUATION PPDU.                */
+	RLE_TIMING_RASM_END,    /**< Receiver, reassembly of an END PPDU.                        */
+	RLE_TIMING_RASM_START,  /**< Receiver, reassembly of a START PPDU.                       */
+	RLE_TIMING_RASM_COMP,   /**< Receiver, reassembly of a COMPLETE PPDU.                    */
+	RLE_TIMING_STAGES_NR    /**< Number of stages.                                           */
+};
+
+/**
+ * Stages whose copies and CRC are counted when the library is built with the COPY_STATS option.
+ */
+enum rle_copy_stage {
+	RLE_COPY_SDU,         /**< Transmitter, copy of a SDU in a fragmentation buffer, with its
+	                           CRC if computed on the fly.                                   */
+	RLE_COPY_CRC,         /**< Transmitter, CRC of a SDU out of its copy.                     */
+	RLE_COPY_ALPDU_HDR,   /**< Transmitter, move of the VLAN header whose protocol type is
+	                           omitted.                                                      */
+	RLE_COPY_PACK,        /**< Copy of the FPDU label and a PPDU in a FPDU. Library-wide for
+	                           rle_pack(), per transmitter for rle_fragment_pack().          */
+	RLE_COPY_RASM_FRAG,   /**< Receiver, copy of a START, CONT or END fragment in a reassembly
+	                           buffer, with its CRC if computed on the fly.                  */
+	RLE_COPY_RASM_COMP,   /**< Receiver, copy of the SDU of a COMPLETE PPDU.                  */
+	RLE_COPY_RASM_END,    /**< Receiver, copy of a reassembled SDU at END.                    */
+	RLE_COPY_RASM_CRC,    /**< Receiver, CRC of a reassembled SDU out of its copy.            */
+	RLE_COPY_DELIVER,     /**< Receiver, copy of a SDU in the buffer of the delivery callback. */
+	RLE_COPY_WRAP,        /**< Receiver, copy of a PPDU straddling the end of the first segment
+	                           of a FPDU given to rle_decapsulate_wrapped().                 */
+	RLE_COPY_STAGES_NR    /**< Number of stages.                                              */
+};
+
+/**
+ * Reasons of the rejection of a PPDU or a SDU by a receiver, counted to monitor the errors
+ * without parsing the logs.
+ */
+enum rle_rcv_error {
+	RLE_RCV_ERR_PPDU_LEN,       /**< PPDU longer than the rest of its FPDU, FPDU dropped.     */
+	RLE_RCV_ERR_ALPDU_HDR,      /**< Invalid ALPDU header, or protocol type not supported.    */
+	RLE_RCV_ERR_CTX_BUSY,       /**< START on a reassembly context already in use.            */
+	RLE_RCV_ERR_CTX_FREE,       /**< CONT or END on a free reassembly context.                */
+	RLE_RCV_ERR_SDU_TOO_LONG,   /**< More SDU bytes received than given by the START.         */
+	RLE_RCV_ERR_SDU_TOO_SHORT,  /**< SDU or trailer bytes missing at START or END.            */
+	RLE_RCV_ERR_NO_STORAGE,     /**< No reassembly storage left for a START.                  */
+	RLE_RCV_ERR_VLAN,           /**< VLAN protocol type not deduced from the VLAN payload.    */
+	RLE_RCV_ERR_CRC,            /**< Wrong CRC trailer.                                       */
+	RLE_RCV_ERR_SEQNO,          /**< Sequence number inconsistency.                           */
+	RLE_RCV_ERR_NO_BUFFER,      /**< No SDU buffer left, or no buffer given by the allocator. */
+	RLE_RCV_ERR_REASONS_NR      /**< Number of reasons.                                       */
+};
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*-------------------------------- PROTECTED STRUCTS AND TYPEDEFS --------------------------------*/
@@ -180,6 +330,31 @@ struct rle_transmitter;
  */
 struct rle_receiver;
 
+/**
+ * RLE receiver set.
+ * For decapsulation of the FPDUs of many terminals, one receiver per payload label.
+ */
+struct rle_receiver_set;
+
+/**
+ * RLE decapsulation engine.
+ * For parallel decapsulation of the FPDUs of many receivers by worker threads, user space only.
+ */
+struct rle_decap_engine;
+
+/**
+ * RLE transmitter pipe.
+ * For the encapsulation of SDUs on another thread than the fragmentation of their ALPDUs.
+ */
+struct rle_tx_pipe;
+
+/**
+ * RLE fragmentation configuration.
+ * Immutable once created, shared by any number of threads for the contextless batch
+ * fragmentation.
+ */
+struct rle_frag_conf;
+
 /**
  * Fragmentation buffer.
  * Used to stock an SDU, encapsulate it in ALPDU and fragment it in PPDU.
@@ -203,6 +378,201 @@ struct rle_sdu {
 	uint16_t protocol_type;  /**< The protocol type (uncompressed) of the RLE SDU. */
 };
 
+#ifndef __KERNEL__
+
+/**
+ * Decapsulation job of the decapsulation engine.
+ * One FPDU to decapsulate with a receiver, same parameters and results as rle_decapsulate().
+ */
+struct rle_decap_job {
+	struct rle_receiver *receiver;  /**< The receiver module.                                  */
+	unsigned char *fpdu;            /**< The FPDU to decapsulate.                              */
+	size_t fpdu_length;             /**< The size of the FPDU.                                 */
+	struct rle_sdu *sdus;           /**< The SDUs array to extract from the FPDU, preallocated.*/
+	size_t sdus_max_nr;             /**< The SDUs array size.                                  */
+	size_t sdus_nr;                 /**< Output, the number of SDUs in the SDUs array.         */
+	unsigned char *payload_label;   /**< The payload label, preallocated, may be NULL.         */
+	size_t payload_label_size;      /**< The size of the payload label.                        */
+	enum rle_decap_status status;   /**< Output, the decapsulation status.                     */
+};
+
+/**
+ * Completion callback of the decapsulation engine, called by the worker that ran the job.
+ */
+typedef void (*rle_decap_complete_cb_t)(void *const arg, const unsigned int worker,
+                                        struct rle_decap_job *const job);
+
+#endif
+
+/**
+ * Allocator callback of the callback decapsulation, called for each SDU about to be delivered.
+ * Shall return a buffer of at least \e sdu_length bytes, or NULL to drop the SDU.
+ */
+typedef unsigned char *(*rle_sdu_alloc_cb_t)(void *const arg, const size_t sdu_length);
+
+/**
+ * Delivery callback of the callback decapsulation, called for each SDU in FPDU order, with the
+ * buffer given by the allocator callback, or in place without allocator callback.
+ */
+typedef void (*rle_sdu_deliver_cb_t)(void *const arg, const struct rle_sdu *const sdu);
+
+/**
+ * Callbacks of the callback decapsulation.
+ */
+struct rle_decap_callbacks {
+	rle_sdu_alloc_cb_t alloc;      /**< The allocator of the SDUs buffers, or NULL. */
+	rle_sdu_deliver_cb_t deliver;  /**< The delivery of the SDUs.                   */
+	void *arg;                     /**< The user argument given to both callbacks.  */
+};
+
+/** Verdicts of the SDUs streamed by a receiver, one per SDU, see rle_receiver_set_stream(). */
+enum rle_stream_verdict {
+	RLE_STREAM_OK,         /**< The SDU is complete and its trailer valid, it may be used.  */
+	RLE_STREAM_ERR_CRC,    /**< The CRC of the SDU is wrong, it shall be discarded.          */
+	RLE_STREAM_ERR_SEQNO,  /**< The sequence number of the SDU is wrong, same.               */
+	RLE_STREAM_LOST,       /**< The SDU is incomplete or invalid, or its context aged, same. */
+};
+
+/**
+ * Bytes of a SDU streamed by a receiver, in the FPDU being decapsulated.
+ */
+struct rle_stream_chunk {
+	const unsigned char *data;  /**< The SDU bytes, valid during the callback only.  */
+	size_t length;              /**< The number of SDU bytes, may be 0.              */
+	size_t offset;              /**< The offset of the bytes in the SDU.             */
+	size_t sdu_size;            /**< The size of the whole SDU.                      */
+	uint16_t protocol_type;     /**< The protocol type of the SDU.                   */
+};
+
+/**
+ * Data callback of the streamed SDUs, called for each PPDU START, CONT and END of a SDU with its
+ * bytes, in order, the first one with an offset of 0.
+ */
+typedef void (*rle_stream_data_cb_t)(void *const arg, const uint8_t frag_id,
+                                     const struct rle_stream_chunk *const chunk);
+
+/**
+ * Verdict callback of the streamed SDUs, called once per SDU after its last bytes, or when it is
+ * given up. The next SDU of the same fragment id starts after it.
+ */
+typedef void (*rle_stream_end_cb_t)(void *const arg, const uint8_t frag_id,
+                                    const enum rle_stream_verdict verdict);
+
+/**
+ * Callbacks of the streamed SDUs.
+ */
+struct rle_stream_callbacks {
+	rle_stream_data_cb_t data;  /**< The bytes of the SDUs.                         */
+	rle_stream_end_cb_t end;    /**< The verdicts of the SDUs.                      */
+	void *arg;                  /**< The user argument given to both callbacks.     */
+};
+
+/**
+ * Cursor of the resumable decapsulation, position of the parsing in a FPDU.
+ * Shall be initialized with rle_decap_cursor_init(), its fields are private.
+ */
+struct rle_decap_cursor {
+	unsigned char *fpdu;  /**< The FPDU being decapsulated.            */
+	size_t fpdu_length;   /**< The size of the FPDU.                   */
+	size_t offset;        /**< The offset of the next PPDU to parse.   */
+};
+
+/**
+ * FPDU of a decapsulation burst, same parameters and results as rle_decapsulate().
+ */
+struct rle_decap_burst_fpdu {
+	unsigned char *fpdu;            /**< The FPDU to decapsulate.                              */
+	size_t fpdu_length;             /**< The size of the FPDU.                                 */
+	unsigned char *payload_label;   /**< The payload label, preallocated, may be NULL.         */
+	size_t payload_label_size;      /**< The size of the payload label.                        */
+	size_t first_sdu;               /**< Output, the index of the first SDU of the FPDU.       */
+	size_t sdus_nr;                 /**< Output, the number of SDUs of the FPDU.               */
+	enum rle_decap_status status;   /**< Output, the decapsulation status.                     */
+};
+
+/** Fragment types of the PPDUs indexed by rle_fpdu_index(). */
+enum rle_ppdu_type {
+	RLE_PPDU_TYPE_COMPLETE,  /**< PPDU COMPLETE, a whole ALPDU.      */
+	RLE_PPDU_TYPE_START,     /**< PPDU START, the first ALPDU bytes. */
+	RLE_PPDU_TYPE_CONT,      /**< PPDU CONT, more ALPDU bytes.       */
+	RLE_PPDU_TYPE_END,       /**< PPDU END, the last ALPDU bytes.    */
+};
+
+/**
+ * PPDU of a FPDU, described by rle_fpdu_index() from its headers only.
+ */
+struct rle_ppdu_index {
+	size_t offset;               /**< The offset of the PPDU in the FPDU.                     */
+	size_t ppdu_length;          /**< The size of the PPDU, header included.                  */
+	enum rle_ppdu_type type;     /**< The fragment type of the PPDU.                          */
+	uint8_t frag_id;             /**< The fragment id, 0 for a PPDU COMPLETE.                 */
+	size_t alpdu_total_len;      /**< The ALPDU size given by a PPDU START, else 0.           */
+	uint16_t protocol_type;      /**< The SDU protocol type, uncompressed, of a PPDU COMPLETE
+	                                  or START, 0 otherwise or if it cannot be found.         */
+};
+
+/**
+ * PPDU of a burst plan, built by rle_plan_bursts() and packed by rle_pack_plan().
+ */
+struct rle_burst_plan_ppdu {
+	size_t burst;        /**< The index of the burst the PPDU is packed in.          */
+	uint8_t frag_id;     /**< The fragment id of the context the PPDU is built from. */
+	size_t ppdu_length;  /**< The size of the PPDU, header included.                 */
+};
+
+/**
+ * PPDU of a contextless batch, built by rle_frag_contextless_batch() in its fragmentation buffer,
+ * or PPDU of a burst, built by rle_fragment_bursts() in the burst.
+ */
+struct rle_ppdu_desc {
+	unsigned char *ppdu;          /**< The PPDU, NULL on error.                              */
+	size_t ppdu_length;           /**< The size of the PPDU, header included.                */
+	enum rle_frag_status status;  /**< The fragmentation status of the buffer.               */
+};
+
+/**
+ * PPDUs an SDU would produce in a sequence of bursts, computed by rle_estimate_overhead().
+ */
+struct rle_overhead_estimate {
+	size_t ppdus_nr;        /**< The number of PPDUs.                                       */
+	size_t bursts_nr;       /**< The number of bursts carrying at least one PPDU.            */
+	size_t ppdus_bytes;     /**< The size of the PPDUs, headers included.                    */
+	size_t overhead_bytes;  /**< The PPDU and ALPDU headers and trailer bytes in the PPDUs.  */
+	size_t remaining;       /**< The ALPDU bytes left when the bursts are full, 0 if sent.   */
+};
+
+/**
+ * Segment of a RLE Service Data Unit.
+ * Interface for the scatter-gather encapsulation functions, an SDU being described by an array of
+ * segments in order.
+ */
+struct rle_sdu_segment {
+	const unsigned char *buffer; /**< The buffer containing the segment. */
+	size_t size;                 /**< The size of the previous buffer.   */
+};
+
+/**
+ * Allocation callback of an allocator, shall return at least \e size bytes suitably aligned for
+ * any type, or NULL on failure.
+ */
+typedef void *(*rle_alloc_cb_t)(void *const context, const size_t size);
+
+/**
+ * Release callback of an allocator, called with memory given by its allocation callback, never
+ * NULL.
+ */
+typedef void (*rle_free_cb_t)(void *const context, void *const ptr);
+
+/**
+ * Allocator of the memory of the library, e.g. a hugepage-backed arena or a NUMA-local pool.
+ * Modules remember the allocator they are created with, and release their memory with it.
+ */
+struct rle_allocator {
+	rle_alloc_cb_t alloc;  /**< The allocation callback.                   */
+	rle_free_cb_t free;    /**< The release callback.                      */
+	void *context;         /**< The user context given to both callbacks.  */
+};
+
 /**
  * RLE configuration
  *
@@ -232,7 +602,8 @@ struct rle_config {
 	 * If set to 1, RLE may use CRC for protection. If set to 0, RLE may not.
 	 *
 	 * If both allow_alpdu_crc and allow_alpdu_sequence_number are set to 1,
-	 * RLE uses sequence number.
+	 * RLE uses sequence number, unless the transmitter chooses per SDU, see
+	 * rle_transmitter_set_protection_policy().
 	 */
 	int allow_alpdu_crc;
 
@@ -243,7 +614,8 @@ struct rle_config {
 	 * RLE may not.
 	 *
 	 * If both allow_alpdu_crc and allow_alpdu_sequence_number are set to 1,
-	 * RLE uses sequence number.
+	 * RLE uses sequence number, unless the transmitter chooses per SDU, see
+	 * rle_transmitter_set_protection_policy().
 	 */
 	int allow_alpdu_sequence_number;
 
@@ -294,6 +666,34 @@ struct rle_config {
 	 * Not used at the moment.
 	 */
 	uint8_t type_0_alpdu_label_size;
+
+	/**
+	 * @brief The number of fragmentation contexts of a transmitter
+	 *
+	 * The transmitter only holds the contexts with fragment ids below this
+	 * value, the fragmentation buffer of a context being only allocated when
+	 * it is first used, sized for the SDUs it carries.
+	 *
+	 * 0 for all the RLE_MAX_FRAG_NUMBER contexts. Not used by receivers,
+	 * which shall accept all the fragment ids.
+	 */
+	uint8_t fragment_contexts_nr;
+
+	/**
+	 * @brief Whether the modules run in real-time mode
+	 *
+	 * If set to 1, every buffer of a module is reserved when it is created or
+	 * configured: the fragmentation buffers of the contexts of a transmitter,
+	 * of its queues and of its pipes, sized for the largest SDU, and the
+	 * reassembly storages of a receiver, kept apart from the pool shared by
+	 * the receivers. rle_encapsulate(), rle_fragment(), rle_pack() and
+	 * rle_decapsulate() then never allocate, and their work is bounded by the
+	 * size of the SDU or FPDU.
+	 *
+	 * The receiver sets still create the receivers of new terminals while
+	 * decapsulating. If set to 0, the buffers are allocated when first used.
+	 */
+	int realtime;
 };
 
 /**
@@ -308,6 +708,34 @@ struct rle_transmitter_stats {
 	uint64_t bytes_dropped; /**< Number of octets dropped.              */
 };
 
+/**
+ * The choice of the ALPDU protection of each SDU by a transmitter allowed both the CRC and the
+ * sequence number, see rle_transmitter_set_protection_policy().
+ *
+ * The PPDUs of a SDU are estimated from the expected burst size. A SDU expected in a COMPLETE PPDU
+ * needs no trailer and is given a sequence number, which costs nothing unless it is fragmented
+ * after all. Otherwise the sequence number is used, unless the SDU is expected in more PPDUs than
+ * seqnum_ppdus_max, or is expected to lose one of its PPDUs on the link with a probability above
+ * sdu_loss_ppm_max: a lost PPDU is only revealed by the ALPDU length then, and the CRC also checks
+ * the content of the SDU. The START PPDU header tells the receivers the trailer of each SDU.
+ */
+struct rle_protection_policy {
+	size_t burst_size;          /**< The expected burst size, above 4 octets.                   */
+	size_t seqnum_ppdus_max;    /**< The most PPDUs of a SDU protected by a sequence number.    */
+	uint32_t ppdu_loss_ppm;     /**< The PPDU loss rate of the link, in parts per million.      */
+	uint32_t sdu_loss_ppm_max;  /**< The most SDU loss probability left to a sequence number.   */
+};
+
+/**
+ * The ALPDUs waiting in a RLE transmitter, see rle_transmitter_stats_get_backlog().
+ */
+struct rle_transmitter_backlog {
+	uint64_t alpdu_bytes;  /**< ALPDU octets left to send, trailers once fragmented. */
+	uint64_t alpdus_nr;    /**< ALPDUs with octets left to send.                     */
+	uint64_t ppdus_nr;     /**< Estimated PPDUs to send them in bursts of the size.   */
+	uint64_t ppdu_bytes;   /**< Estimated PPDU octets, headers and trailers included. */
+};
+
 /**
  * RLE receiver statistics.
  */
@@ -321,10 +749,85 @@ struct rle_receiver_stats {
 	uint64_t bytes_dropped;     /**< Number of octets dropped.              */
 };
 
+/**
+ * Log2 histogram of the durations of a stage, in ns.
+ */
+struct rle_timing_histogram {
+	uint64_t count;                            /**< Number of durations measured.  */
+	uint64_t total_ns;                         /**< Sum of the durations.          */
+	uint64_t max_ns;                           /**< Longest duration.              */
+	uint64_t buckets[RLE_TIMING_BUCKETS_NR];   /**< Durations per power of 2 of ns. */
+};
+
+/**
+ * Copies and CRC of a stage.
+ */
+struct rle_copy_counters {
+	uint64_t calls;          /**< Number of copies, or of CRC out of a copy. */
+	uint64_t bytes_copied;   /**< Number of octets copied or moved.          */
+	uint64_t bytes_crc;      /**< Number of octets of SDU in a CRC.          */
+};
+
+/**
+ * Histograms of the SDUs of a context, by size and by number of PPDUs.
+ */
+struct rle_size_histogram {
+	uint64_t sdus;                                 /**< Number of SDUs.                 */
+	uint64_t bytes;                                /**< Number of octets of SDUs.       */
+	uint64_t ppdus;                                /**< Number of PPDUs of the SDUs.    */
+	uint64_t sizes[RLE_SDU_SIZE_BUCKETS_NR];       /**< SDUs per power of 2 of octets.  */
+	uint64_t fragments[RLE_PPDUS_BUCKETS_NR];      /**< SDUs per number of PPDUs.       */
+};
+
+/**
+ * Memory taken by a RLE module from its allocator, without the overhead of the allocator itself.
+ */
+struct rle_memory_footprint {
+	size_t bytes;        /**< Octets held now.                                             */
+	size_t allocations;  /**< Memory blocks held now.                                      */
+	size_t max_bytes;    /**< Octets held once all the buffers hold the largest SDUs, with
+	                          the current queues.                                          */
+};
+
+/**
+ * RLE receiver set statistics of one terminal.
+ */
+struct rle_receiver_set_stats {
+	unsigned char payload_label[6];   /**< The payload label of the terminal, 3 or 6 bytes long. */
+	struct rle_receiver_stats stats;  /**< The sum of the statistics of all the queues.          */
+};
+
 /*------------------------------------------------------------------------------------------------*/
 /*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
 
+/**
+ * @brief         Set the allocator of the modules created without allocator.
+ *
+ *                The allocator is read when a module is created, and kept by the module until it is
+ *                destroyed, so that changing it does not affect the existing modules. It shall be
+ *                set while no module is being created. The allocator of the system, malloc() in
+ *                userspace and kmalloc() in the kernel, is used by default.
+ *
+ * @param[in]     allocator               The allocator, copied, NULL for the allocator of the
+ *                                        system.
+ *
+ * @return        0 if OK, else 1 if a callback is missing.
+ *
+ * @ingroup       RLE allocator
+ */
+int rle_set_allocator(const struct rle_allocator *const allocator)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the allocator of the modules created without allocator.
+ *
+ * @param[out]    allocator               The allocator.
+ *
+ * @ingroup       RLE allocator
+ */
+void rle_get_allocator(struct rle_allocator *const allocator);
+
 /**
  * @brief         Create and initialize a RLE transmitter module.
  *
@@ -338,280 +841,1880 @@ struct rle_transmitter * rle_transmitter_new(const struct rle_config *const conf
 __attribute__((warn_unused_result));
 
 /**
- * @brief         Destroy a RLE transmitter module.
+ * @brief         Create and initialize a RLE transmitter module with its own allocator.
  *
- * @param[in,out] transmitter              The transmitter to destroy.
+ *                The transmitter and all its fragmentation buffers and queues are allocated with
+ *                the given allocator.
+ *
+ * @param[in]     conf       The configuration of the RLE transmitter.
+ * @param[in]     allocator  The allocator, copied, NULL for the one set by rle_set_allocator().
+ *
+ * @return        A pointer to the transmitter module.
  *
  * @ingroup       RLE transmitter
  */
-void rle_transmitter_destroy(struct rle_transmitter **const transmitter);
+struct rle_transmitter * rle_transmitter_new_with_allocator(const struct rle_config *const conf,
+                                                            const struct rle_allocator *const
+                                                            allocator)
+__attribute__((warn_unused_result));
 
 /**
- * @brief         Create and initialize a RLE receiver module.
+ * @brief         Get the size of the memory of a RLE transmitter module initialized in place.
  *
- * @param[in]     conf  The configuration of the RLE receiver.
+ * @param[in]     conf  The configuration of the RLE transmitter.
  *
- * @return        A pointer to the receiver module.
+ * @return        The size of the memory in bytes, 0 if the configuration is invalid.
  *
- * @ingroup       RLE receiver
+ * @ingroup       RLE transmitter
  */
-struct rle_receiver * rle_receiver_new(const struct rle_config *const conf)
+size_t rle_transmitter_size(const struct rle_config *const conf)
 __attribute__((warn_unused_result));
 
 /**
- * @brief         Destroy a RLE receiver module.
+ * @brief         Get the memory taken by a RLE transmitter module.
  *
- * @param[in,out] receiver                 The receiver to destroy.
+ *                The transmitter, its fragmentation buffers, its queues and their buffers are
+ *                counted. The buffers are allocated on encapsulation, sized for the SDUs, so that
+ *                the footprint grows up to max_bytes. The memory of a transmitter initialized in
+ *                place belongs to the caller and is not counted, see rle_transmitter_size().
  *
- * @ingroup       RLE receiver
+ * @param[in]     transmitter  The transmitter.
+ * @param[out]    footprint    The memory taken.
+ *
+ * @return        0 if OK, else 1 if the transmitter or the footprint is NULL.
+ *
+ * @ingroup       RLE transmitter
  */
-void rle_receiver_destroy(struct rle_receiver **const receiver);
+int rle_transmitter_memory_footprint(const struct rle_transmitter *const transmitter,
+                                     struct rle_memory_footprint *const footprint)
+__attribute__((warn_unused_result));
 
 /**
- * @brief         Create a new fragmentation buffer.
+ * @brief         Initialize a RLE transmitter module in caller memory.
  *
- * @return        The fragmentation buffer if OK, else NULL
+ *                The transmitter and the fragmentation buffers of all its contexts, sized for the
+ *                largest SDUs, are laid out in the given memory, so that nothing is allocated on
+ *                encapsulation. Only the queues set by rle_transmitter_set_queue_depth() and their
+ *                buffers are allocated, with the allocator set by rle_set_allocator(). The memory
+ *                belongs to the caller until rle_transmitter_fini() is called.
  *
- * @ingroup       RLE Fragmentation buffer
+ * @param[out]    mem       The memory, aligned on RLE_IN_PLACE_ALIGNMENT bytes.
+ * @param[in]     mem_size  The size of the memory, at least rle_transmitter_size() bytes.
+ * @param[in]     conf      The configuration of the RLE transmitter.
+ *
+ * @return        A pointer to the transmitter module, at the start of the memory, NULL on error.
+ *
+ * @ingroup       RLE transmitter
  */
-struct rle_frag_buf * rle_frag_buf_new(void)
+struct rle_transmitter * rle_transmitter_init_in_place(void *const mem, const size_t mem_size,
+                                                       const struct rle_config *const conf)
 __attribute__((warn_unused_result));
 
 /**
- * @brief         Destroy a fragmentation buffer.
+ * @brief         Finalize a RLE transmitter module initialized in place.
  *
- * @param[in,out] f_buff                   The fragmentation buffer to destroy.
+ *                The memory taken after the initialization is released, the memory of the
+ *                transmitter itself is given back to the caller. rle_transmitter_destroy() may be
+ *                used as well.
  *
- * @ingroup       RLE Fragmentation buffer
+ * @param[in,out] transmitter  The transmitter to finalize.
+ *
+ * @ingroup       RLE transmitter
  */
-void rle_frag_buf_del(struct rle_frag_buf **const f_buff);
+void rle_transmitter_fini(struct rle_transmitter *const transmitter);
 
 /**
- * @brief         Initialize (eventually reinitialize) a fragmentation buffer.
- *
- * @param[in,out] f_buff                   The fragmentation buffer to (re)initialize.
+ * @brief         Destroy a RLE transmitter module.
  *
- * @return        0 if OK, else 1.
+ * @param[in,out] transmitter              The transmitter to destroy.
  *
- * @ingroup       RLE Fragmentation buffer
+ * @ingroup       RLE transmitter
  */
-int rle_frag_buf_init(struct rle_frag_buf *const f_buff)
-__attribute__((warn_unused_result));
+void rle_transmitter_destroy(struct rle_transmitter **const transmitter);
 
 /**
- * @brief         Copy an SDU in a fragmentation buffer.
+ * @brief         Set the depth of the queue of SDUs of a context of a RLE transmitter module.
  *
- *                SDU is copied in context when given for encapsulation, thus, the SDU given
- *                as argument to this function can be freed once encapsulation is done.
+ *                Without queue, the default, a SDU cannot be encapsulated in a context until the
+ *                previous one is fully fragmented. With a queue of \e depth SDUs, up to \e depth
+ *                SDUs given for encapsulation wait behind the current one, already encapsulated,
+ *                and the next one takes the context as soon as the current one is fully
+ *                fragmented. The queue shall be empty.
  *
- * @param[in,out] f_buff   The fragmentation buffer. Must contains an SDU and be
- *                         initialized.
- * @param[in]     sdu      The SDU to copy.
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     fragment_id             The context of the queue.
+ * @param[in]     depth                   The max number of queued SDUs, 0 for no queue.
  *
  * @return        0 if OK, else 1.
  *
- * @ingroup       RLE Fragmentation buffer
+ * @ingroup       RLE transmitter
  */
-int rle_frag_buf_cpy_sdu(struct rle_frag_buf *const f_buff,
-                         const struct rle_sdu *const sdu)
+int rle_transmitter_set_queue_depth(struct rle_transmitter *const transmitter,
+                                    const uint8_t fragment_id,
+                                    const size_t depth)
 __attribute__((warn_unused_result));
 
 /**
- * @brief         RLE encapsulation. Encapsulate a SDU in a RLE ALPDU frame.
+ * @brief         Reserve contexts of a RLE transmitter module to a traffic class.
  *
- *                The ALPDU is stored in the internal context of the RLE transmitter
- *                waiting for eventual fragmentation. The fragments are retrieved
- *                by one or more calls to the \ref rle_fragment API function.
- *                SDU is copied in context when given for encapsulation, thus, the SDU given
- *                as argument to this function can be freed once encapsulation is done.
+ *                By default, all the contexts belong to the class 0, in strict priority. The
+ *                given contexts are taken away from their previous class, so that classes never
+ *                share a context.
  *
  * @param[in,out] transmitter             The transmitter module.
- * @param[in]     sdu                     The RLE Service data unit to encapsulate.
- * @param[in]     frag_id                 Identify the context to which belongs the datas to encap.
+ * @param[in]     traffic_class           The traffic class, below RLE_TRAFFIC_CLASSES_NR.
+ * @param[in]     frag_ids                The bitmap of the contexts to reserve, bit i for the
+ *                                        fragment id i, may be 0 to only change the weight.
+ * @param[in]     weight                  The number of PPDUs served in a row in weighted round
+ *                                        robin, 0 for strict priority.
  *
- * @return        Encapsulation status.
+ * @return        0 if OK, else 1.
  *
  * @ingroup       RLE transmitter
  */
-enum rle_encap_status rle_encapsulate(struct rle_transmitter *const transmitter,
-                                      const struct rle_sdu *const sdu,
-                                      const uint8_t frag_id)
+int rle_transmitter_set_traffic_class(struct rle_transmitter *const transmitter,
+                                      const uint8_t traffic_class,
+                                      const uint8_t frag_ids,
+                                      const uint8_t weight)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Suggest the implicit protocol type omitted from the most ALPDU headers, given the
+ *                protocol types of the SDUs encapsulated since the last epoch.
+ *
+ *                The candidates are RLE_PROTO_TYPE_IP_COMP, RLE_PROTO_TYPE_IPV4_COMP,
+ *                RLE_PROTO_TYPE_IPV6_COMP, RLE_PROTO_TYPE_VLAN_COMP and RLE_PROTO_TYPE_ARP_COMP.
+ *                On a tie, the current implicit protocol type is kept.
+ *
+ * @param[in]     transmitter             The transmitter module.
+ * @param[out]    implicit_protocol_type  The compressed implicit protocol type suggested.
+ *
+ * @return        0 if OK, else 1, also if the protocol type omission is not allowed.
+ *
+ * @ingroup       RLE transmitter
+ */
+int rle_transmitter_suggest_implicit_ptype(const struct rle_transmitter *const transmitter,
+                                           uint8_t *const implicit_protocol_type)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Change the implicit protocol type of a RLE transmitter module, starting an epoch.
+ *
+ *                The SDUs encapsulated afterwards omit the new implicit protocol type, so the
+ *                receivers shall change theirs with rle_receiver_set_implicit_ptype() at the same
+ *                epoch boundary, signalled out of band. All the contexts shall be free, and the
+ *                pipe of the transmitter empty, so that no SDU encapsulated with the previous
+ *                implicit protocol type is left to fragment. The SDUs encapsulated without context
+ *                are the responsibility of the caller. The protocol types counted for
+ *                rle_transmitter_suggest_implicit_ptype() are reset.
+ *
+ * @warning       With a pipe, the encapsulation stage shall be quiesced during the change: the
+ *                protocol type table it reads in \ref rle_tx_pipe_encapsulate is replaced.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     implicit_protocol_type  The compressed implicit protocol type.
+ *
+ * @return        0 if OK, else 1, also if the protocol type omission is not allowed, a context
+ *                is in use or ALPDUs are in the pipe.
+ *
+ * @ingroup       RLE transmitter
+ */
+int rle_transmitter_set_implicit_ptype(struct rle_transmitter *const transmitter,
+                                       const uint8_t implicit_protocol_type)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Choose the ALPDU protection of each SDU with a policy, instead of the sequence
+ *                number for all of them.
+ *
+ *                The SDUs encapsulated afterwards are protected as the policy chooses, the others
+ *                keep their protection. May be called again as the link loss rate changes.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     policy                  The policy, NULL to use the sequence number again.
+ *
+ * @return        0 if OK, else 1, also if the CRC and the sequence number are not both allowed.
+ *
+ * @ingroup       RLE transmitter
+ */
+int rle_transmitter_set_protection_policy(struct rle_transmitter *const transmitter,
+                                          const struct rle_protection_policy *const policy)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Create and initialize a RLE receiver module.
+ *
+ * @param[in]     conf  The configuration of the RLE receiver.
+ *
+ * @return        A pointer to the receiver module.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_receiver * rle_receiver_new(const struct rle_config *const conf)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Create and initialize a RLE receiver module with its own allocator.
+ *
+ *                The receiver and all its reassembly buffers are allocated with the given
+ *                allocator. Unless it is the allocator of the system, their storages are not
+ *                shared with the other receivers.
+ *
+ * @param[in]     conf       The configuration of the RLE receiver.
+ * @param[in]     allocator  The allocator, copied, NULL for the one set by rle_set_allocator().
+ *
+ * @return        A pointer to the receiver module.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_receiver * rle_receiver_new_with_allocator(const struct rle_config *const conf,
+                                                      const struct rle_allocator *const allocator)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the size of the memory of a RLE receiver module initialized in place.
+ *
+ * @param[in]     conf  The configuration of the RLE receiver.
+ *
+ * @return        The size of the memory in bytes, 0 if the configuration is invalid.
+ *
+ * @ingroup       RLE receiver
+ */
+size_t rle_receiver_size(const struct rle_config *const conf)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the memory taken by a RLE receiver module.
+ *
+ *                The receiver, its reassembly buffers and the storages of the SDUs it reassembles
+ *                or hands over are counted. The storages of the allocator of the system come from
+ *                a pool shared by receivers, whose free storages are not counted. The memory of a
+ *                receiver initialized in place belongs to the caller and is not counted, see
+ *                rle_receiver_size().
+ *
+ * @param[in]     receiver   The receiver.
+ * @param[out]    footprint  The memory taken.
+ *
+ * @return        0 if OK, else 1 if the receiver or the footprint is NULL.
+ *
+ * @ingroup       RLE receiver
+ */
+int rle_receiver_memory_footprint(const struct rle_receiver *const receiver,
+                                  struct rle_memory_footprint *const footprint)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Initialize a RLE receiver module in caller memory.
+ *
+ *                The receiver and the reassembly buffers of all its contexts are laid out in the
+ *                given memory. The storages of the SDUs being reassembled are still taken on START
+ *                PPDUs from the pool shared by receivers, or from the allocator set by
+ *                rle_set_allocator(), so that idle receivers cost their footprint only. The memory
+ *                belongs to the caller until rle_receiver_fini() is called.
+ *
+ * @param[out]    mem       The memory, aligned on RLE_IN_PLACE_ALIGNMENT bytes.
+ * @param[in]     mem_size  The size of the memory, at least rle_receiver_size() bytes.
+ * @param[in]     conf      The configuration of the RLE receiver.
+ *
+ * @return        A pointer to the receiver module, at the start of the memory, NULL on error.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_receiver * rle_receiver_init_in_place(void *const mem, const size_t mem_size,
+                                                 const struct rle_config *const conf)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Finalize a RLE receiver module initialized in place.
+ *
+ *                The storages still held are released, the memory of the receiver itself is given
+ *                back to the caller. rle_receiver_destroy() may be used as well.
+ *
+ * @param[in,out] receiver  The receiver to finalize.
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_receiver_fini(struct rle_receiver *const receiver);
+
+/**
+ * @brief         Destroy a RLE receiver module.
+ *
+ * @param[in,out] receiver                 The receiver to destroy.
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_receiver_destroy(struct rle_receiver **const receiver);
+
+/**
+ * @brief         Set how the receiver verifies that the FPDU padding is made of 0x00 octets.
+ *
+ *                Non-zero padding is counted, see rle_receiver_stats_get_counter_padding_errors().
+ *                Verification is strict by default.
+ *
+ * @param[in,out] receiver                 The receiver module.
+ * @param[in]     padding_check            The padding verification mode.
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_receiver_set_padding_check(struct rle_receiver *const receiver,
+                                    const enum rle_padding_check padding_check);
+
+/**
+ * @brief         Set whether the receiver validates each FPDU before it parses any PPDU of it.
+ *
+ *                The validation only reads the FPDU: the chain of PPDU lengths, the length of
+ *                the PPDU headers, and the consistency of the fragments of each fragment id
+ *                within the FPDU, a START followed by CONT and END PPDUs carrying the ALPDU
+ *                length it gives. A FPDU failing it is dropped before any fragment is copied or
+ *                any reassembly context changed, its rejection is counted, see
+ *                rle_receiver_stats_get_counter_errors(). The fragments of SDUs started in
+ *                previous FPDUs are left to the reassembly, so that a lost FPDU does not make
+ *                the next ones be dropped. The FPDUs wrapped in two segments, see
+ *                rle_decapsulate_wrapped(), are validated across them. Validation is disabled by
+ *                default.
+ *
+ * @param[in,out] receiver                 The receiver module.
+ * @param[in]     enabled                  1 if the FPDUs are validated, 0 otherwise.
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_receiver_set_fpdu_validation(struct rle_receiver *const receiver, const int enabled);
+
+/**
+ * @brief         Set the timeout of the reassembly contexts.
+ *
+ *                A context whose SDU is not fully reassembled when the timeout elapses is freed,
+ *                and its SDU counted as lost, by rle_receiver_tick(). The timeout applies to the
+ *                contexts started afterwards.
+ *
+ * @param[in,out] receiver                 The receiver module.
+ * @param[in]     timeout                  The timeout in the time unit of the caller clock given
+ *                                         to rle_receiver_tick(), 0 to never expire contexts
+ *                                         (default).
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_receiver_set_ctx_timeout(struct rle_receiver *const receiver, const uint64_t timeout);
+
+/**
+ * @brief         Change the implicit protocol type of a RLE receiver module at an epoch boundary.
+ *
+ *                The implicit protocol type is swapped atomically, so that it may be changed by
+ *                the thread receiving the epoch signalling while another one decapsulates: each
+ *                ALPDU header is decoded with either the previous or the new one. A fragmented SDU
+ *                keeps the protocol type of its START PPDU.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     implicit_protocol_type  The compressed implicit protocol type, the one of the
+ *                                        transmitter, see rle_transmitter_set_implicit_ptype().
+ *
+ * @return        0 if OK, else 1, also if the protocol type omission is not allowed.
+ *
+ * @ingroup       RLE receiver
+ */
+int rle_receiver_set_implicit_ptype(struct rle_receiver *const receiver,
+                                    const uint8_t implicit_protocol_type)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Advance the receiver clock and free the expired reassembly contexts.
+ *
+ *                Contexts are started at the time of the last tick, and expire at the first tick
+ *                at or after their start time plus the timeout. At most a turn of the timer wheel
+ *                is visited, whatever the elapsed time.
+ *
+ * @param[in,out] receiver                 The receiver module.
+ * @param[in]     now                      The current time of the caller clock, non-decreasing.
+ *
+ * @return        The number of expired contexts.
+ *
+ * @ingroup       RLE receiver
+ */
+size_t rle_receiver_tick(struct rle_receiver *const receiver, const uint64_t now);
+
+/**
+ * @brief         Create a new fragmentation buffer.
+ *
+ * @return        The fragmentation buffer if OK, else NULL
+ *
+ * @ingroup       RLE Fragmentation buffer
+ */
+struct rle_frag_buf * rle_frag_buf_new(void)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Destroy a fragmentation buffer.
+ *
+ * @param[in,out] f_buff                   The fragmentation buffer to destroy.
+ *
+ * @ingroup       RLE Fragmentation buffer
+ */
+void rle_frag_buf_del(struct rle_frag_buf **const f_buff);
+
+/**
+ * @brief         Get the memory taken by a fragmentation buffer.
+ *
+ *                A buffer laid out in caller memory takes nothing.
+ *
+ * @param[in]     f_buff                   The fragmentation buffer.
+ * @param[out]    footprint                The memory taken.
+ *
+ * @return        0 if OK, else 1 if the buffer or the footprint is NULL.
+ *
+ * @ingroup       RLE Fragmentation buffer
+ */
+int rle_frag_buf_memory_footprint(const struct rle_frag_buf *const f_buff,
+                                  struct rle_memory_footprint *const footprint)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Initialize (eventually reinitialize) a fragmentation buffer.
+ *
+ * @param[in,out] f_buff                   The fragmentation buffer to (re)initialize.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE Fragmentation buffer
+ */
+int rle_frag_buf_init(struct rle_frag_buf *const f_buff)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Copy an SDU in a fragmentation buffer.
+ *
+ *                SDU is copied in context when given for encapsulation, thus, the SDU given
+ *                as argument to this function can be freed once encapsulation is done.
+ *
+ * @param[in,out] f_buff   The fragmentation buffer. Must contains an SDU and be
+ *                         initialized.
+ * @param[in]     sdu      The SDU to copy.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE Fragmentation buffer
+ */
+int rle_frag_buf_cpy_sdu(struct rle_frag_buf *const f_buff,
+                         const struct rle_sdu *const sdu)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Gather an SDU given in segments in a fragmentation buffer.
+ *
+ *                Same as \ref rle_frag_buf_cpy_sdu, for an SDU whose headers and payload are in
+ *                separate buffers. The segments can be freed once the function returns.
+ *
+ * @param[in,out] f_buff         The fragmentation buffer. Must be initialized.
+ * @param[in]     segments       The segments of the SDU, in order.
+ * @param[in]     segments_nr    The number of segments.
+ * @param[in]     protocol_type  The protocol type (uncompressed) of the SDU.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE Fragmentation buffer
+ */
+int rle_frag_buf_cpy_sdu_segments(struct rle_frag_buf *const f_buff,
+                                  const struct rle_sdu_segment segments[],
+                                  const size_t segments_nr,
+                                  const uint16_t protocol_type)
 __attribute__((warn_unused_result));
 
 /**
  * @brief         RLE encapsulation. Encapsulate a SDU in a RLE ALPDU frame.
  *
- * @param[in,out] transmitter             The transmitter module. Used for its conf only, its
- *                                        context is not use.
- * @param[in,out] f_buff                  The fragmentation buffer (containing an SDU).
+ *                The ALPDU is stored in the internal context of the RLE transmitter
+ *                waiting for eventual fragmentation. The fragments are retrieved
+ *                by one or more calls to the \ref rle_fragment API function.
+ *                SDU is copied in context when given for encapsulation, thus, the SDU given
+ *                as argument to this function can be freed once encapsulation is done.
+ *                If the context is busy, the SDU waits in its queue, see
+ *                \ref rle_transmitter_set_queue_depth.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     sdu                     The RLE Service data unit to encapsulate.
+ * @param[in]     frag_id                 Identify the context to which belongs the datas to encap.
+ *
+ * @return        Encapsulation status.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_encap_status rle_encapsulate(struct rle_transmitter *const transmitter,
+                                      const struct rle_sdu *const sdu,
+                                      const uint8_t frag_id)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE encapsulation. Encapsulate a SDU in a context of the given traffic class.
+ *
+ *                Same as \ref rle_encapsulate, in the first free context reserved to the traffic
+ *                class. If none is free, the SDU waits in the queue of the first context of the
+ *                class whose queue is not full.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     sdu                     The RLE Service data unit to encapsulate.
+ * @param[in]     traffic_class           The traffic class of the SDU.
+ * @param[out]    frag_id                 The context chosen for the SDU.
+ *
+ * @return        Encapsulation status, RLE_ENCAP_ERR if no context of the class is available.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_encap_status rle_encapsulate_auto(struct rle_transmitter *const transmitter,
+                                           const struct rle_sdu *const sdu,
+                                           const uint8_t traffic_class,
+                                           uint8_t *const frag_id)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE zero-copy encapsulation. Encapsulate a SDU in a RLE ALPDU frame in place.
+ *
+ *                Same as \ref rle_encapsulate, but the SDU is not copied in the context of the
+ *                RLE transmitter: the ALPDU header and trailer are written in the headroom and
+ *                tailroom reserved by the caller around the SDU, and the PPDUs returned by
+ *                \ref rle_fragment point in the caller's memory.
+ *
+ * @warning       The memory of the SDU, from RLE_ENCAP_HEADROOM octets before its buffer up to
+ *                RLE_ENCAP_TAILROOM octets after its end, belongs to the transmitter until the
+ *                ALPDU is fully fragmented. Its content is modified by the PPDU headers.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     sdu                     The RLE Service data unit to encapsulate.
+ * @param[in]     headroom                The number of octets available before the SDU buffer.
+ * @param[in]     tailroom                The number of octets available after the SDU buffer.
+ * @param[in]     frag_id                 Identify the context to which belongs the datas to encap.
+ *
+ * @return        Encapsulation status, RLE_ENCAP_ERR_NO_ROOM if the headroom or the tailroom is
+ *                too small.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_encap_status rle_encapsulate_zero_copy(struct rle_transmitter *const transmitter,
+                                                const struct rle_sdu *const sdu,
+                                                const size_t headroom,
+                                                const size_t tailroom,
+                                                const uint8_t frag_id)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE scatter-gather encapsulation. Encapsulate a SDU given in segments in a RLE
+ *                ALPDU frame.
+ *
+ *                Same as \ref rle_encapsulate, for an SDU whose headers and payload are in
+ *                separate buffers. The segments are gathered in the internal context of the RLE
+ *                transmitter while the CRC is computed, so they can be freed once encapsulation
+ *                is done. The protocol type suppression for VLAN is done whatever the segment
+ *                boundaries.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     segments                The segments of the SDU, in order.
+ * @param[in]     segments_nr             The number of segments.
+ * @param[in]     protocol_type           The protocol type (uncompressed) of the SDU.
+ * @param[in]     frag_id                 Identify the context to which belongs the datas to encap.
+ *
+ * @return        Encapsulation status.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_encap_status rle_encapsulate_segments(struct rle_transmitter *const transmitter,
+                                               const struct rle_sdu_segment segments[],
+                                               const size_t segments_nr,
+                                               const uint16_t protocol_type,
+                                               const uint8_t frag_id)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE encapsulation. Encapsulate a batch of SDUs, each in its own context.
+ *
+ *                Equivalent to calling rle_encapsulate() on each SDU in turn, with the checks and
+ *                configuration decisions common to all the SDUs made once for the batch. A failure
+ *                on one SDU does not stop the batch.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     sdus                    The SDUs to encapsulate.
+ * @param[in]     frag_ids                The context of each SDU, sdus_nr entries.
+ * @param[in]     sdus_nr                 The number of SDUs.
+ * @param[out]    statuses                The encapsulation status of each SDU, sdus_nr entries.
+ *
+ * @return        The number of SDUs successfully encapsulated.
+ *
+ * @ingroup       RLE transmitter
+ */
+size_t rle_encapsulate_batch(struct rle_transmitter *const transmitter,
+                             const struct rle_sdu sdus[],
+                             const uint8_t frag_ids[],
+                             const size_t sdus_nr,
+                             enum rle_encap_status statuses[]);
+
+/**
+ * @brief         RLE encapsulation. Encapsulate a SDU in a RLE ALPDU frame.
+ *
+ * @param[in,out] transmitter             The transmitter module. Used for its conf only, its
+ *                                        context is not use.
+ * @param[in,out] f_buff                  The fragmentation buffer (containing an SDU).
+ *
+ * @return        Encapsulation status.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_encap_status rle_encap_contextless(struct rle_transmitter *const transmitter,
+                                            struct rle_frag_buf *const f_buff)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE fragmentation. Get the next PPDU fragment.
+ *
+ *                The ALPDU is stored in the internal context of the RLE transmitter.
+ *                Call this function to retrieve a fragment of the ALPDU. Use function
+ *                \ref rle_transmitter_stats_get_queue_size to determine if there is
+ *                some ALPDU data to fragment.
+ *
+ * @warning       /!\ REAL ZERO COPY /!\ The PPDU returned belongs to the fragmentation buffer.
+ *                If the library user does not copy nor send it before asking for another one, the
+ *                first PPDU might be corrupted by the PPDU header of the second one.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     frag_id                 Identify the ALPDU to which belongs the datas to fragment.
+ * @param[in]     remaining_burst_size    Remaining size in the burst.
+ * @param[out]    ppdu                    Extracted Payload-adapted PDU (fragment of ALPDU).
+ * @param[out]    ppdu_length             Size of the extracted PPDU.
+ *
+ * @return        Fragmentation status.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_frag_status rle_fragment(struct rle_transmitter *const transmitter,
+                                  const uint8_t frag_id,
+                                  const size_t remaining_burst_size,
+                                  unsigned char *ppdu[],
+                                  size_t *const ppdu_length)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE fragmentation. Get the next PPDU fragment of the context to serve next.
+ *
+ *                The context is chosen among the ones with ALPDU data to fragment: first the
+ *                strict priority traffic classes, in class order, then the weighted ones in
+ *                weighted round robin, weights counted in PPDUs. The contexts of a class are
+ *                served in round robin. See \ref rle_transmitter_set_traffic_class.
+ *
+ * @warning       Same as \ref rle_fragment.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     remaining_burst_size    Remaining size in the burst.
+ * @param[out]    ppdu                    Extracted Payload-adapted PDU (fragment of ALPDU).
+ * @param[out]    ppdu_length             Size of the extracted PPDU.
+ * @param[out]    frag_id                 The context the PPDU belongs to.
+ *
+ * @return        Fragmentation status, RLE_FRAG_ERR_CONTEXT_IS_NULL if there is no ALPDU data to
+ *                fragment.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_frag_status rle_fragment_next(struct rle_transmitter *const transmitter,
+                                       const size_t remaining_burst_size,
+                                       unsigned char *ppdu[],
+                                       size_t *const ppdu_length,
+                                       uint8_t *const frag_id)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE fragmentation of a whole ALPDU in a sequence of bursts, in one call.
+ *
+ *                Same as calling \ref rle_fragment once per burst, the PPDU of the burst \e i
+ *                being at most \e burst_sizes[i] bytes and copied at the start of \e bursts[i].
+ *                The context is checked once, and its counters and the backlog of the transmitter
+ *                are updated once for all the PPDUs. The fragmentation stops when the ALPDU is
+ *                fully sent, or before the first burst too small for a PPDU. In the latter case
+ *                the ALPDU left is fragmented by the next calls.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     frag_id                 Identify the ALPDU to which belongs the datas to fragment.
+ * @param[in]     burst_sizes             The max size of the PPDU of each burst.
+ * @param[out]    bursts                  The buffer of each burst, at least its size.
+ * @param[in]     bursts_nr               The number of bursts.
+ * @param[out]    ppdus                   The PPDU of each burst, in \e bursts, \e ppdus_nr of the
+ *                                        \e bursts_nr entries being set.
+ * @param[out]    ppdus_nr                The number of PPDUs built, in the first bursts.
+ *
+ * @return        Fragmentation status, RLE_FRAG_OK if the bursts were used until the ALPDU was
+ *                fully sent or the bursts were used up, RLE_FRAG_ERR_BURST_TOO_SMALL if a burst
+ *                was too small for a PPDU.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_frag_status rle_fragment_bursts(struct rle_transmitter *const transmitter,
+                                         const uint8_t frag_id,
+                                         const size_t burst_sizes[],
+                                         unsigned char *const bursts[],
+                                         const size_t bursts_nr,
+                                         struct rle_ppdu_desc ppdus[],
+                                         size_t *const ppdus_nr)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE fragmentation. Get the next PPDU fragment.
+ *
+ *                RLE fragmentation of ALPDU created without context.
+ *                As there is not context, only COMPLETE PPDU is supported.
+ *
+ * @warning       /!\ REAL ZERO COPY /!\ The PPDU returned belongs to the fragmentation buffer.
+ *                If the library user does not copy nor send it before asking for another one, the
+ *                first PPDU might be corrupted by the PPDU header of the second one.
+ *
+ * @param[in,out] transmitter             The transmitter module. Used for its conf only, its
+ *                                        context is not use.
+ * @param[in,out] f_buff                  The fragmentation buffer (containing an ALPDU).
+ * @param[out]    ppdu                    Extracted Payload-adapted PDU (fragment of ALPDU).
+ * @param[in,out] ppdu_length             Asked size of the extracted PPDU. The size returned is the
+ *                                        one really extracted.
+ *                                        for instance, if the caller wants a 100 octets PPDU, but
+ *                                        the RLE library can only return 80 octets PPDU,
+ *                                        ppdu_length will be overwritten with 80.
+ *
+ * @return        Fragmentation status.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_frag_status rle_frag_contextless(struct rle_transmitter *const transmitter,
+                                          struct rle_frag_buf *const f_buff,
+                                          unsigned char **const ppdu,
+                                          size_t *const ppdu_length)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Create a fragmentation configuration, for the contextless batch fragmentation.
+ *
+ *                The configuration is read-only once created: any number of threads may use it
+ *                at once, each one with its own fragmentation buffers.
+ *
+ * @param[in]     conf                    The RLE configuration.
+ *
+ * @return        A pointer to the fragmentation configuration, NULL on error.
+ *
+ * @ingroup       RLE transmitter
+ */
+struct rle_frag_conf * rle_frag_conf_new(const struct rle_config *const conf)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Destroy a fragmentation configuration, once no thread uses it anymore.
+ *
+ * @param[in,out] frag_conf               The fragmentation configuration to destroy.
+ *
+ * @ingroup       RLE transmitter
+ */
+void rle_frag_conf_destroy(struct rle_frag_conf **const frag_conf);
+
+/**
+ * @brief         RLE contextless batch fragmentation. Encapsulate the SDUs of fragmentation
+ *                buffers and fragment each of them in one PPDU.
+ *
+ *                Same as \ref rle_encap_contextless then \ref rle_frag_contextless on each
+ *                fragmentation buffer in turn, with a fragmentation configuration instead of a
+ *                transmitter, so that many threads may each fragment their own buffers with the
+ *                same configuration, without shared mutable state. As there is no context, each
+ *                ALPDU is sent in a COMPLETE PPDU of at most \e burst_size bytes, and carries no
+ *                ALPDU trailer. A failure on one buffer does not stop the batch.
+ *
+ * @warning       Same as \ref rle_frag_contextless, the PPDUs belong to the fragmentation
+ *                buffers.
+ *
+ * @param[in]     frag_conf               The fragmentation configuration.
+ * @param[in,out] frag_bufs               The fragmentation buffers, each containing an SDU.
+ * @param[in]     frag_bufs_nr            The number of fragmentation buffers.
+ * @param[in]     burst_size              The max size of each PPDU.
+ * @param[out]    ppdus                   The PPDU of each fragmentation buffer, frag_bufs_nr
+ *                                        entries. A buffer whose ALPDU exceeds the burst is
+ *                                        left encapsulated, with RLE_FRAG_ERR_BURST_TOO_SMALL.
+ *
+ * @return        The number of PPDUs built, 0 if the configuration is NULL.
+ *
+ * @ingroup       RLE transmitter
+ */
+size_t rle_frag_contextless_batch(const struct rle_frag_conf *const frag_conf,
+                                  struct rle_frag_buf *const frag_bufs[],
+                                  const size_t frag_bufs_nr,
+                                  const size_t burst_size,
+                                  struct rle_ppdu_desc ppdus[]);
+
+/**
+ * @brief         Create a pipe of ALPDUs from an encapsulation stage to the fragmentation stage
+ *                of a transmitter.
+ *
+ *                The encapsulation stage, a single thread, encapsulates SDUs in the pipe with
+ *                \ref rle_tx_pipe_encapsulate. The fragmentation stage, another single thread,
+ *                hands them over to the contexts of the transmitter with \ref rle_tx_pipe_dispatch,
+ *                then fragments and packs them as usual. The pipe is lock-free, and the ALPDUs
+ *                are not copied from one stage to the other.
+ *
+ *                While the pipe is in use, the SDUs are only given to the transmitter through the
+ *                pipe, and its configuration and protocol type mix are not changed. The allocator
+ *                of the transmitter is called by the encapsulation stage. A transmitter has one
+ *                pipe at most.
+ *
+ * @param[in]     transmitter             The transmitter of the fragmentation stage.
+ * @param[in]     depth                   The max number of ALPDUs in the pipe, a power of 2 from
+ *                                        2 to RLE_TX_PIPE_MAX_DEPTH.
+ *
+ * @return        A pointer to the pipe, NULL on error.
+ *
+ * @ingroup       RLE transmitter
+ */
+struct rle_tx_pipe * rle_tx_pipe_new(struct rle_transmitter *const transmitter,
+                                     const size_t depth)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Destroy a transmitter pipe, before its transmitter.
+ *
+ *                The ALPDUs not dispatched yet are dropped.
+ *
+ * @param[in,out] pipe                    The pipe to destroy.
+ *
+ * @ingroup       RLE transmitter
+ */
+void rle_tx_pipe_destroy(struct rle_tx_pipe **const pipe);
+
+/**
+ * @brief         RLE encapsulation. Encapsulate a SDU in a ALPDU of a transmitter pipe, by the
+ *                encapsulation stage.
+ *
+ *                Same as \ref rle_encapsulate, the ALPDU waits in the pipe until the fragmentation
+ *                stage dispatches it to its context. The ALPDU is published to the fragmentation
+ *                stage once complete.
+ *
+ * @warning       The ALPDU header omits the implicit protocol type of the transmitter, which shall
+ *                not be changed meanwhile: the pipe shall be drained and the encapsulation stage
+ *                quiesced before an epoch change, see \ref rle_transmitter_set_implicit_ptype.
+ *
+ * @param[in,out] pipe                    The transmitter pipe.
+ * @param[in]     sdu                     The RLE Service data unit to encapsulate.
+ * @param[in]     frag_id                 Identify the context the ALPDU goes to.
+ *
+ * @return        Encapsulation status, RLE_ENCAP_ERR_PIPE_FULL if the SDU must be given again
+ *                once the fragmentation stage made room.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_encap_status rle_tx_pipe_encapsulate(struct rle_tx_pipe *const pipe,
+                                              const struct rle_sdu *const sdu,
+                                              const uint8_t frag_id)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Hand the ALPDUs of a transmitter pipe over to the contexts of its transmitter, by
+ *                the fragmentation stage.
+ *
+ *                The ALPDUs are handed over in order, to their context if it is free, else to its
+ *                queue, see \ref rle_transmitter_set_queue_depth. The first ALPDU whose context
+ *                cannot take it stops the dispatch until the next call.
+ *
+ * @warning       The buffers of the previous SDUs of the contexts go back to the encapsulation
+ *                stage: the PPDUs fragmented before must be copied or sent beforehand.
+ *
+ * @param[in,out] pipe                    The transmitter pipe.
+ *
+ * @return        The number of ALPDUs handed over.
+ *
+ * @ingroup       RLE transmitter
+ */
+size_t rle_tx_pipe_dispatch(struct rle_tx_pipe *const pipe);
+
+/**
+ * @brief         Get the number of ALPDUs in a transmitter pipe, by either stage.
+ *
+ * @param[in]     pipe                    The transmitter pipe.
+ *
+ * @return        The number of ALPDUs encapsulated and not dispatched yet.
+ *
+ * @ingroup       RLE transmitter
+ */
+size_t rle_tx_pipe_get_size(const struct rle_tx_pipe *const pipe)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Init the given FPDU with the given Payload Label
+ *
+ * @param[in]     label                   The FPDU label fields.
+ * @param[in]     label_size              Size of the FPDU label field
+ * @param[in,out] fpdu                    Generated/modified Frame PDU
+ * @param[in,out] fpdu_current_pos        Current position in the FPDU
+ * @param[in,out] fpdu_remaining_size     Remaining size in the FPDU
+ *
+ * @return        Frame packing status
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_pack_status rle_pack_init(const unsigned char *const label,
+                                   const size_t label_size,
+                                   unsigned char *const fpdu,
+                                   size_t *const fpdu_current_pos,
+                                   size_t *const fpdu_remaining_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE frame packing. Pack the given PPDU in the given FPDU.
+ *
+ * @param[in]     ppdu                    A PPDU to pack.
+ * @param[in]     ppdu_length             The PPDU size.
+ * @param[in]     label                   The FPDU label fields.
+ * @param[in]     label_size              Size of the FPDU label fields.
+ * @param[in,out] fpdu                    Generated/modified Frame PDU.
+ * @param[in,out] fpdu_current_pos        Current position in the FPDU.
+ * @param[in,out] fpdu_remaining_size     Remaining size in the FPDU.
+ *
+ * @return        Frame packing status.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_pack_status rle_pack(const unsigned char *const ppdu,
+                              const size_t ppdu_length,
+                              const unsigned char *const label,
+                              const size_t label_size,
+                              unsigned char *const fpdu,
+                              size_t *const fpdu_current_pos,
+                              size_t *const fpdu_remaining_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE fragmentation and packing in a single pass.
+ *
+ *                Build the next PPDU of the given fragmentation context so that it fits in the room
+ *                left in the FPDU, and write it directly at the current FPDU position. If the FPDU
+ *                is empty, the FPDU label is written first, as rle_pack_init() would do. On
+ *                failure, the FPDU is left untouched.
+ *
+ * @param[in,out] transmitter             The transmitter holding the context to fragment.
+ * @param[in]     frag_id                 The fragment id of the context.
+ * @param[in]     label                   The FPDU label fields.
+ * @param[in]     label_size              Size of the FPDU label fields.
+ * @param[in,out] fpdu                    Generated/modified Frame PDU.
+ * @param[in,out] fpdu_current_pos        Current position in the FPDU.
+ * @param[in,out] fpdu_remaining_size     Remaining size in the FPDU.
+ * @param[out]    used_size               Number of FPDU bytes used, label included.
+ *
+ * @return        Frame packing status. RLE_PACK_ERR_FPDU_TOO_SMALL if the room left in the FPDU
+ *                is too small for the next PPDU, RLE_PACK_ERR_INVALID_PPDU if the context has no
+ *                ALPDU to fragment.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_pack_status rle_fragment_pack(struct rle_transmitter *const transmitter,
+                                       const uint8_t frag_id,
+                                       const unsigned char *const label,
+                                       const size_t label_size,
+                                       unsigned char *const fpdu,
+                                       size_t *const fpdu_current_pos,
+                                       size_t *const fpdu_remaining_size,
+                                       size_t *const used_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Plan the fragmentation and packing of the pending ALPDUs in a list of bursts.
+ *
+ *                The plan covers the ALPDUs being sent by the contexts of the transmitter, not the
+ *                SDUs queued behind them. The ALPDUs that fit whole in a burst are sent in one
+ *                PPDU, placed best-fit, largest first. The other ones are spread over the largest
+ *                rooms left, in burst order, and a fragment that would carry less payload than a
+ *                few PPDU headers is not built. The ALPDUs already fragmented are planned first.
+ *                The bytes that do not fit in the bursts are left for the next plan.
+ *
+ *                The PPDUs of the plan are sorted by burst index, in the order they shall be
+ *                built. The transmitter shall not be used between the planning and the packing.
+ *
+ * @param[in]     transmitter             The transmitter holding the contexts to plan.
+ * @param[in]     burst_sizes             The sizes of the bursts, FPDU label included.
+ * @param[in]     bursts_nr               The number of bursts.
+ * @param[in]     label_size              Size of the FPDU label fields.
+ * @param[out]    plan                    The PPDUs of the plan, preallocated.
+ * @param[in]     plan_max_nr             The plan array size.
+ * @param[out]    plan_nr                 The number of PPDUs in the plan.
+ *
+ * @return        0 if OK, else 1, for instance if the plan array is too small.
+ *
+ * @ingroup       RLE transmitter
+ */
+int rle_plan_bursts(const struct rle_transmitter *const transmitter,
+                    const size_t burst_sizes[],
+                    const size_t bursts_nr,
+                    const size_t label_size,
+                    struct rle_burst_plan_ppdu plan[],
+                    const size_t plan_max_nr,
+                    size_t *const plan_nr)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Fragment and pack the PPDUs of a burst plan in their FPDUs.
+ *
+ *                The FPDUs are written as rle_pack() would do, the FPDU label being written before
+ *                the first PPDU of each FPDU. Padding is left to rle_pad().
+ *
+ * @param[in,out] transmitter             The transmitter the plan was built from.
+ * @param[in]     plan                    The PPDUs of the plan.
+ * @param[in]     plan_nr                 The number of PPDUs in the plan.
+ * @param[in]     label                   The FPDU label fields.
+ * @param[in]     label_size              Size of the FPDU label fields.
+ * @param[in,out] fpdus                   The FPDUs, one per burst of the plan.
+ * @param[in,out] fpdus_current_pos       The current positions in the FPDUs.
+ * @param[in,out] fpdus_remaining_size    The remaining sizes in the FPDUs.
+ *
+ * @return        Frame packing status, of the first PPDU that failed if any.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_pack_status rle_pack_plan(struct rle_transmitter *const transmitter,
+                                   const struct rle_burst_plan_ppdu plan[],
+                                   const size_t plan_nr,
+                                   const unsigned char *const label,
+                                   const size_t label_size,
+                                   unsigned char *const fpdus[],
+                                   size_t fpdus_current_pos[],
+                                   size_t fpdus_remaining_size[])
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Fill the FPDUs of a superframe with the pending ALPDUs of the transmitter.
+ *
+ *                The FPDUs are planned as rle_plan_bursts() does, except that the room left is
+ *                filled down to the smallest fragment, so that as little as possible is padded.
+ *                The PPDUs are packed, then every FPDU is padded, even the ones left without a
+ *                PPDU, which only hold their FPDU label.
+ *
+ * @param[in,out] transmitter             The transmitter holding the contexts to send.
+ * @param[in]     label                   The FPDU label fields.
+ * @param[in]     label_size              Size of the FPDU label fields.
+ * @param[in,out] fpdus                   The FPDUs of the superframe.
+ * @param[in]     fpdus_sizes             The sizes of the FPDUs, FPDU label included.
+ * @param[in]     fpdus_nr                The number of FPDUs.
+ * @param[out]    plan                    The PPDUs packed, preallocated.
+ * @param[in]     plan_max_nr             The plan array size.
+ * @param[out]    padding_size            The number of padding bytes in the FPDUs.
+ *
+ * @return        Frame packing status, RLE_PACK_ERR if the plan array is too small.
+ *
+ * @ingroup       RLE transmitter
+ */
+enum rle_pack_status rle_pack_superframe(struct rle_transmitter *const transmitter,
+                                         const unsigned char *const label,
+                                         const size_t label_size,
+                                         unsigned char *const fpdus[],
+                                         const size_t fpdus_sizes[],
+                                         const size_t fpdus_nr,
+                                         struct rle_burst_plan_ppdu plan[],
+                                         const size_t plan_max_nr,
+                                         size_t *const padding_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         RLE padding. Pad the given FPDU with 0x00 octets.
+ *
+ * @param[in,out] fpdu                    Frame PDU to pad.
+ * @param[in]     fpdu_current_pos        Current position in the FPDU.
+ * @param[in]     fpdu_remaining_size     Remaining size in the FPDU.
+ *
+ * @ingroup       RLE transmitter
+ */
+void rle_pad(unsigned char *const fpdu,
+             const size_t fpdu_current_pos,
+             const size_t fpdu_remaining_size);
+
+/**
+ * @brief Decapsulate the given FPDU into zero or more SDUs
+ *
+ * The function returns all of the SDUs that are fully decapsulated. If some
+ * PPDU fragments are missing for some of them, the fragments that are already
+ * received are kept in the internal contexts of the library. Next calls to
+ * the function may complete them, they will then be added to the \e sdus output
+ * parameter.
+ *
+ * The payload label is extracted in a preallocated buffer depending on the size
+ * given by the caller. This size is known by the type of FPDU awaited and the
+ * predefined size given by ETSI EN 301 545-2 V1.2.1, tab. 7-10 p. 119.
+ *
+ * The array of SDUs \e sdus shall be initialized by the caller with
+ * \e sdus_max_nr memory areas of at least 4095 bytes each. The \e sdus[n].size
+ * and \e sdus[n].protocol_type shall be set to 0.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[in,out] sdus                    The SDUs array to extract from the FPDU, preallocated.
+ * @param[in]     sdus_max_nr             The SDUs array size, max number of extractable SDUs.
+ * @param[out]    sdus_nr                 The current number of SDUs in the SDUs array.
+ * @param[in,out] payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        decapsulation status.
+ *
+ * @ingroup       RLE receiver
+ */
+enum rle_decap_status rle_decapsulate(struct rle_receiver *const receiver,
+                                      unsigned char *const fpdu,
+                                      const size_t fpdu_length,
+                                      struct rle_sdu sdus[],
+                                      const size_t sdus_max_nr,
+                                      size_t *const sdus_nr,
+                                      unsigned char *const payload_label,
+                                      const size_t payload_label_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief Decapsulate the given FPDU into zero or more SDUs, without copying them in the
+ *        preallocated buffers
+ *
+ * Same as rle_decapsulate(), except that the SDUs are not copied:
+ *  - the buffer of the \e sdus entry of a COMPLETE PPDU is set to point to the SDU inside the
+ *    FPDU. Such SDUs are valid as long as the FPDU is. The Ethernet/VLAN/IP SDUs whose VLAN
+ *    protocol type is rebuilt are rebuilt inside the FPDU, over the end of the PPDU header, so
+ *    the FPDU is modified.
+ *  - the buffer of the \e sdus entry of a SDU reassembled from fragments is set to point to the
+ *    reassembly storage of the receiver. Such SDUs are valid until the next decapsulation with
+ *    the same receiver, or its destruction. Past RLE_MAX_FRAG_NUMBER reassembled SDUs in a
+ *    single FPDU, the next ones are copied in the preallocated buffers.
+ *
+ * As the buffers of the \e sdus entries may be replaced, the caller shall set them back to its
+ * preallocated memory areas before each call.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[in,out] sdus                    The SDUs array to extract from the FPDU, preallocated.
+ * @param[in]     sdus_max_nr             The SDUs array size, max number of extractable SDUs.
+ * @param[out]    sdus_nr                 The current number of SDUs in the SDUs array.
+ * @param[in,out] payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        decapsulation status.
+ *
+ * @ingroup       RLE receiver
+ */
+enum rle_decap_status rle_decapsulate_zero_copy(struct rle_receiver *const receiver,
+                                                unsigned char *const fpdu,
+                                                const size_t fpdu_length,
+                                                struct rle_sdu sdus[],
+                                                const size_t sdus_max_nr,
+                                                size_t *const sdus_nr,
+                                                unsigned char *const payload_label,
+                                                const size_t payload_label_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief Decapsulate the given FPDU into zero or more SDUs, delivered through callbacks
+ *
+ * Same as rle_decapsulate(), except that no SDUs array is needed: for each SDU, the allocator
+ * callback is called with the SDU length, the SDU is copied in the returned buffer, then the
+ * delivery callback is called. The SDU buffers are owned by the caller. The SDUs the allocator
+ * callback refuses are dropped, and RLE_DECAP_ERR_SOME_DROP is returned.
+ *
+ * Without allocator callback, the SDUs are delivered in place, as rle_decapsulate_zero_copy()
+ * gives them: inside the FPDU or inside the reassembly storage of the receiver. The SDUs inside
+ * the FPDU are valid as long as the FPDU is, the reassembled ones only during the delivery
+ * callback.
+ *
+ * As with rle_decapsulate_zero_copy(), the FPDU may be modified.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[in]     callbacks               The allocator and delivery callbacks.
+ * @param[out]    sdus_nr                 The number of SDUs delivered.
+ * @param[in,out] payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        decapsulation status.
+ *
+ * @ingroup       RLE receiver
+ */
+enum rle_decap_status rle_decapsulate_cb(struct rle_receiver *const receiver,
+                                         unsigned char *const fpdu,
+                                         const size_t fpdu_length,
+                                         const struct rle_decap_callbacks *const callbacks,
+                                         size_t *const sdus_nr,
+                                         unsigned char *const payload_label,
+                                         const size_t payload_label_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Give a receiver a pool of SDU buffers, for rle_decapsulate_pooled().
+ *
+ *                The buffers of all the classes are allocated at once with the allocator of
+ *                the receiver. A previous pool of the receiver is replaced, its buffers still
+ *                held by the caller stay valid until released.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     buffers_nr              The number of buffers of each class, NULL to remove
+ *                                        the pool.
+ *
+ * @return        0 if OK, else 1 if the receiver is NULL, the pool empty, or not allocated,
+ *                as with the caller allocator.
+ *
+ * @ingroup       RLE receiver
+ */
+int rle_receiver_set_sdu_pool(struct rle_receiver *const receiver,
+                              const size_t buffers_nr[RLE_SDU_POOL_CLASSES_NR])
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Stream the fragmented SDUs of a receiver to callbacks, instead of reassembling
+ *                them.
+ *
+ *                The bytes of each PPDU START, CONT and END are given to the data callback as they
+ *                are decapsulated, from the FPDU, without reassembly storage nor copy. The CRC and
+ *                the sequence number are checked on the fly, and the verdict given at the PPDU
+ *                END, so that the consumer commits or discards the bytes it already used. Those
+ *                SDUs are not in the \e sdus of the decapsulation, the SDUs of PPDUs COMPLETE
+ *                still are. The SDUs whose VLAN protocol type is suppressed are still reassembled,
+ *                as the field is inserted back at their start.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     callbacks               The callbacks, copied, NULL to reassemble the SDUs.
+ *
+ * @return        0 if OK, else 1 if the receiver is NULL, a callback is NULL, or a SDU is being
+ *                reassembled or streamed.
+ *
+ * @ingroup       RLE receiver
+ */
+int rle_receiver_set_stream(struct rle_receiver *const receiver,
+                            const struct rle_stream_callbacks *const callbacks)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief Decapsulate the given FPDU into zero or more SDUs, copied in buffers of the SDU pool of
+ *        the receiver
+ *
+ * Same as rle_decapsulate(), except that the buffers of the \e sdus entries are not given by the
+ * caller: each SDU is copied in the smallest buffer of the pool it fits in, a larger one if all
+ * of them are in use, and the buffer of its \e sdus entry is set to it. The caller owns the
+ * buffers then, and gives each of them back with rle_sdu_buffer_release(). The SDUs no buffer
+ * is left for are dropped, and RLE_DECAP_ERR_SOME_DROP is returned.
+ *
+ * As with rle_decapsulate_zero_copy(), the FPDU may be modified.
+ *
+ * @param[in,out] receiver                The receiver module, with a SDU pool.
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[out]    sdus                    The SDUs array to extract from the FPDU.
+ * @param[in]     sdus_max_nr             The SDUs array size, max number of extractable SDUs.
+ * @param[out]    sdus_nr                 The current number of SDUs in the SDUs array.
+ * @param[in,out] payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        decapsulation status, RLE_DECAP_ERR_INV_SDUS without SDU pool.
+ *
+ * @ingroup       RLE receiver
+ */
+enum rle_decap_status rle_decapsulate_pooled(struct rle_receiver *const receiver,
+                                             unsigned char *const fpdu,
+                                             const size_t fpdu_length,
+                                             struct rle_sdu sdus[],
+                                             const size_t sdus_max_nr,
+                                             size_t *const sdus_nr,
+                                             unsigned char *const payload_label,
+                                             const size_t payload_label_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Give a SDU buffer back to the pool it comes from.
+ *
+ *                May be called from any thread, without lock, even once the receiver of the
+ *                pool is destroyed: the pool is released with its last buffer.
+ *
+ * @param[in]     buffer                  The buffer of a SDU from rle_decapsulate_pooled().
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_sdu_buffer_release(unsigned char *const buffer);
+
+/**
+ * @brief         Get the size of a SDU buffer of a pool, the size of its class.
+ *
+ * @param[in]     buffer                  The buffer of a SDU from rle_decapsulate_pooled().
+ *
+ * @return        The size of the buffer.
+ *
+ * @ingroup       RLE receiver
+ */
+size_t rle_sdu_buffer_get_size(const unsigned char *const buffer)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Initialize a resumable decapsulation cursor at the start of the given FPDU.
+ *
+ * @param[out]    cursor                  The cursor.
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_decap_cursor_init(struct rle_decap_cursor *const cursor,
+                           unsigned char *const fpdu,
+                           const size_t fpdu_length);
+
+/**
+ * @brief Decapsulate the FPDU of the given cursor into zero or more SDUs, from the position of
+ *        the cursor
+ *
+ * Same as rle_decapsulate(), except that when the SDUs array is full while the FPDU is not fully
+ * parsed, the parsing is paused rather than the remaining PPDUs dropped: RLE_DECAP_PAUSED is
+ * returned and the cursor is left at the first PPDU not parsed. Calling the function again with
+ * the same cursor goes on with the next SDUs. The payload label is only given by the first call.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in,out] cursor                  The cursor, initialized with rle_decap_cursor_init().
+ * @param[in,out] sdus                    The SDUs array to extract from the FPDU, preallocated.
+ * @param[in]     sdus_max_nr             The SDUs array size, max number of extractable SDUs.
+ * @param[out]    sdus_nr                 The current number of SDUs in the SDUs array.
+ * @param[in,out] payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        decapsulation status, RLE_DECAP_PAUSED if the FPDU is to be resumed.
+ *
+ * @ingroup       RLE receiver
+ */
+enum rle_decap_status rle_decapsulate_resume(struct rle_receiver *const receiver,
+                                             struct rle_decap_cursor *const cursor,
+                                             struct rle_sdu sdus[],
+                                             const size_t sdus_max_nr,
+                                             size_t *const sdus_nr,
+                                             unsigned char *const payload_label,
+                                             const size_t payload_label_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Decapsulate a burst of FPDUs, in order, into one SDUs array.
+ *
+ *                Equivalent to calling rle_decapsulate() on each FPDU in turn, with the checks
+ *                common to all the FPDUs made once for the burst. The SDUs of each FPDU follow the
+ *                ones of the previous FPDUs in the SDUs array. A failure on one FPDU does not stop
+ *                the burst. Once the SDUs array is full, the SDUs of the next FPDUs are dropped.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in,out] fpdus                   The FPDUs to decapsulate, with their results.
+ * @param[in]     fpdus_nr                The number of FPDUs.
+ * @param[in,out] sdus                    The SDUs array to extract from the FPDUs, preallocated.
+ * @param[in]     sdus_max_nr             The SDUs array size, max number of extractable SDUs.
+ * @param[out]    sdus_nr                 The number of SDUs in the SDUs array.
+ *
+ * @return        The number of FPDUs successfully decapsulated.
+ *
+ * @ingroup       RLE receiver
+ */
+size_t rle_decapsulate_burst(struct rle_receiver *const receiver,
+                             struct rle_decap_burst_fpdu fpdus[],
+                             const size_t fpdus_nr,
+                             struct rle_sdu sdus[],
+                             const size_t sdus_max_nr,
+                             size_t *const sdus_nr);
+
+/**
+ * @brief Decapsulate a FPDU that wraps around the end of a ring buffer into zero or more SDUs
+ *
+ * Same as rle_decapsulate(), on the FPDU made of the end of a ring buffer, \e first, followed by
+ * its start, \e second, as a DMA engine writes back-to-back FPDUs in a ring. The PPDUs are parsed
+ * in place in both segments. Only a PPDU that straddles the end of \e first is copied, once, in a
+ * buffer on the stack. A FPDU that fits in \e first is decapsulated as usual, \e second is not
+ * used then.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     first                   The first bytes of the FPDU, up to the end of the ring.
+ * @param[in]     first_length            The bytes available in \e first.
+ * @param[in]     second                  The next bytes of the FPDU, from the start of the ring.
+ * @param[in]     second_length           The bytes available in \e second.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[in,out] sdus                    The SDUs array to extract from the FPDU, preallocated.
+ * @param[in]     sdus_max_nr             The SDUs array size, max number of extractable SDUs.
+ * @param[out]    sdus_nr                 The current number of SDUs in the SDUs array.
+ * @param[in,out] payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ * @param[out]    consumed                The bytes of the ring the tail may move forward,
+ *                                        \e fpdu_length once the FPDU is parsed, even with
+ *                                        errors, 0 if the arguments are invalid.
+ *
+ * @return        decapsulation status.
+ *
+ * @ingroup       RLE receiver
+ */
+enum rle_decap_status rle_decapsulate_wrapped(struct rle_receiver *const receiver,
+                                              unsigned char *const first,
+                                              const size_t first_length,
+                                              unsigned char *const second,
+                                              const size_t second_length,
+                                              const size_t fpdu_length,
+                                              struct rle_sdu sdus[],
+                                              const size_t sdus_max_nr,
+                                              size_t *const sdus_nr,
+                                              unsigned char *const payload_label,
+                                              const size_t payload_label_size,
+                                              size_t *const consumed)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Describe the PPDUs of a FPDU, without decapsulating them.
+ *
+ *                Only the PPDU headers and the ALPDU headers of the PPDUs COMPLETE and START are
+ *                read: no receiver is needed, no SDU is copied and nothing is allocated, so that
+ *                monitoring probes index captures as fast as they read them. The fragments are
+ *                not checked against each other, see rle_receiver_set_fpdu_validation() for that.
+ *
+ * @param[in]     conf                    The configuration of the transmitter of the FPDU.
+ * @param[in]     fpdu                    The FPDU.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[in]     payload_label_size      The size of the payload label, before the PPDUs.
+ * @param[out]    ppdus                   The descriptions of the PPDUs, in order.
+ * @param[in]     ppdus_max_nr            The size of the descriptions array.
+ * @param[out]    ppdus_nr                The number of PPDUs described.
+ *
+ * @return        RLE_DECAP_OK if all the PPDUs are described, RLE_DECAP_ERR_SOME_DROP if the
+ *                descriptions array is full first, RLE_DECAP_ERR_INV_FPDU if a PPDU is longer
+ *                than the FPDU or shorter than its header, the PPDUs before being described,
+ *                RLE_DECAP_ERR_INV_SDUS if the descriptions array is invalid, RLE_DECAP_ERR if the
+ *                configuration is.
+ *
+ * @ingroup       RLE receiver
+ */
+enum rle_decap_status rle_fpdu_index(const struct rle_config *const conf,
+                                     const unsigned char *const fpdu,
+                                     const size_t fpdu_length,
+                                     const size_t payload_label_size,
+                                     struct rle_ppdu_index ppdus[],
+                                     const size_t ppdus_max_nr,
+                                     size_t *const ppdus_nr)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Create a RLE receiver set, demultiplexing FPDUs to terminals by payload label.
+ *
+ *                The receiver of a terminal is created with the first FPDU that carries its
+ *                payload label. When \e terminals_max terminals are active, the least recently
+ *                seen one is evicted to make room for a new one.
+ *
+ * @param[in]     conf                    The configuration of the RLE receivers.
+ * @param[in]     payload_label_size      The size of the payload label identifying terminals, 3
+ *                                        or 6.
+ * @param[in]     terminals_max           The max number of active terminals.
+ *
+ * @return        A pointer to the receiver set, NULL on error.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_receiver_set * rle_receiver_set_new(const struct rle_config *const conf,
+                                               const size_t payload_label_size,
+                                               const size_t terminals_max)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Create a RLE receiver set with its own allocator.
+ *
+ *                Same as rle_receiver_set_new(), the set, its table and the receivers of its
+ *                terminals being allocated with the given allocator. The receiver of a new
+ *                terminal is allocated while decapsulating its first FPDU, in the kernel an
+ *                allocator that does not sleep shall be given to decapsulate in atomic context.
+ *
+ * @param[in]     conf                    The configuration of the RLE receivers.
+ * @param[in]     payload_label_size      The size of the payload label identifying terminals, 3
+ *                                        or 6.
+ * @param[in]     terminals_max           The max number of active terminals.
+ * @param[in]     allocator               The allocator, copied, NULL for the one set by
+ *                                        rle_set_allocator().
+ *
+ * @return        A pointer to the receiver set, NULL on error.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_receiver_set * rle_receiver_set_new_with_allocator(const struct rle_config *const conf,
+                                                              const size_t payload_label_size,
+                                                              const size_t terminals_max,
+                                                              const struct rle_allocator *const
+                                                              allocator)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Destroy a RLE receiver set and the receivers of all its terminals.
+ *
+ * @param[in,out] set                      The receiver set to destroy.
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_receiver_set_destroy(struct rle_receiver_set **const set);
+
+/**
+ * @brief         Decapsulate the given FPDU with the receiver of the terminal it comes from.
+ *
+ *                Same as rle_decapsulate(), the terminal being identified by the payload label
+ *                at the start of the FPDU.
+ *
+ * @param[in,out] set                     The receiver set.
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[in,out] sdus                    The SDUs array to extract from the FPDU, preallocated.
+ * @param[in]     sdus_max_nr             The SDUs array size, max number of extractable SDUs.
+ * @param[out]    sdus_nr                 The current number of SDUs in the SDUs array.
+ * @param[out]    payload_label           The payload label of the terminal, preallocated with
+ *                                        the payload label size of the set.
+ *
+ * @return        decapsulation status.
+ *
+ * @ingroup       RLE receiver
+ */
+enum rle_decap_status rle_receiver_set_decapsulate(struct rle_receiver_set *const set,
+                                                   unsigned char *const fpdu,
+                                                   const size_t fpdu_length,
+                                                   struct rle_sdu sdus[],
+                                                   const size_t sdus_max_nr,
+                                                   size_t *const sdus_nr,
+                                                   unsigned char *const payload_label)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the receiver of a terminal, for instance to read its statistics.
+ *
+ * @param[in]     set                     The receiver set.
+ * @param[in]     payload_label           The payload label of the terminal.
+ *
+ * @return        The receiver of the terminal, NULL if the terminal is not active.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_receiver * rle_receiver_set_get_receiver(const struct rle_receiver_set *const set,
+                                                    const unsigned char *const payload_label)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Evict the terminals that sent no FPDU recently, partial SDUs are dropped.
+ *
+ * @param[in,out] set                     The receiver set.
+ * @param[in]     idle_fpdus              The number of FPDUs decapsulated by the set without any
+ *                                        FPDU of a terminal after which it is evicted.
+ *
+ * @return        The number of evicted terminals.
+ *
+ * @ingroup       RLE receiver
+ */
+size_t rle_receiver_set_evict_idle(struct rle_receiver_set *const set, const uint64_t idle_fpdus);
+
+/**
+ * @brief         Get the number of active terminals of a receiver set.
+ *
+ * @param[in]     set                     The receiver set.
+ *
+ * @return        The number of active terminals.
+ *
+ * @ingroup       RLE receiver statistics
+ */
+size_t rle_receiver_set_get_terminals_nr(const struct rle_receiver_set *const set)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Dump the statistics of all the active terminals of a receiver set at once.
+ *
+ * @param[in]     set                     The receiver set.
+ * @param[out]    terminals               The statistics of the terminals, in no particular order.
+ * @param[in]     terminals_max           The size of the terminals array, statistics of the
+ *                                        terminals beyond are not dumped.
+ *
+ * @return        The number of terminals dumped.
+ *
+ * @ingroup       RLE receiver statistics
+ */
+size_t rle_receiver_set_stats_dump(const struct rle_receiver_set *const set,
+                                   struct rle_receiver_set_stats terminals[],
+                                   const size_t terminals_max)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Dump the statistics of all the active terminals of a receiver set, and reset
+ *                them, in a single pass.
+ *
+ *                See rle_receiver_stats_fetch_and_reset(), the terminals beyond terminals_max are
+ *                neither dumped nor reset.
  *
- * @return        Encapsulation status.
+ * @param[in,out] set                     The receiver set.
+ * @param[out]    terminals               The statistics of the terminals since their last reset,
+ *                                        in no particular order.
+ * @param[in]     terminals_max           The size of the terminals array.
  *
- * @ingroup       RLE transmitter
+ * @return        The number of terminals dumped.
+ *
+ * @ingroup       RLE receiver statistics
  */
-enum rle_encap_status rle_encap_contextless(struct rle_transmitter *const transmitter,
-                                            struct rle_frag_buf *const f_buff)
+size_t rle_receiver_set_stats_fetch_and_reset(struct rle_receiver_set *const set,
+                                              struct rle_receiver_set_stats terminals[],
+                                              const size_t terminals_max)
 __attribute__((warn_unused_result));
 
+#ifndef __KERNEL__
+
 /**
- * @brief         RLE fragmentation. Get the next PPDU fragment.
- *
- *                The ALPDU is stored in the internal context of the RLE transmitter.
- *                Call this function to retrieve a fragment of the ALPDU. Use function
- *                \ref rle_transmitter_stats_get_queue_size to determine if there is
- *                some ALPDU data to fragment.
+ * @brief         Create a decapsulation engine running jobs on worker threads.
  *
- * @warning       /!\ REAL ZERO COPY /!\ The PPDU returned belongs to the fragmentation buffer.
- *                If the library user does not copy nor send it before asking for another one, the
- *                first PPDU might be corrupted by the PPDU header of the second one.
+ *                The jobs of a receiver always run on a single worker, in the order of the batch,
+ *                so receivers need no locking. Receivers are hashed to lanes owned by workers, and
+ *                idle workers steal whole lanes from busy ones to balance the load.
  *
- * @param[in,out] transmitter             The transmitter module.
- * @param[in]     frag_id                 Identify the ALPDU to which belongs the datas to fragment.
- * @param[in]     remaining_burst_size    Remaining size in the burst.
- * @param[out]    ppdu                    Extracted Payload-adapted PDU (fragment of ALPDU).
- * @param[out]    ppdu_length             Size of the extracted PPDU.
+ * @param[in]     workers_nr              The number of worker threads, from 1 to
+ *                                        RLE_DECAP_ENGINE_MAX_WORKERS.
+ * @param[in]     jobs_max                The max number of jobs of a batch.
+ * @param[in]     complete                The completion callback, called by the worker of each
+ *                                        job once done, may be NULL.
+ * @param[in]     complete_arg            The argument given to the completion callback.
  *
- * @return        Fragmentation status.
+ * @return        A pointer to the engine, NULL on error.
  *
- * @ingroup       RLE transmitter
+ * @ingroup       RLE receiver
  */
-enum rle_frag_status rle_fragment(struct rle_transmitter *const transmitter,
-                                  const uint8_t frag_id,
-                                  const size_t remaining_burst_size,
-                                  unsigned char *ppdu[],
-                                  size_t *const ppdu_length)
+struct rle_decap_engine * rle_decap_engine_new(const unsigned int workers_nr,
+                                               const size_t jobs_max,
+                                               const rle_decap_complete_cb_t complete,
+                                               void *const complete_arg)
 __attribute__((warn_unused_result));
 
 /**
- * @brief         RLE fragmentation. Get the next PPDU fragment.
+ * @brief         Stop the worker threads and destroy a decapsulation engine.
  *
- *                RLE fragmentation of ALPDU created without context.
- *                As there is not context, only COMPLETE PPDU is supported.
+ * @param[in,out] engine                  The engine to destroy.
  *
- * @warning       /!\ REAL ZERO COPY /!\ The PPDU returned belongs to the fragmentation buffer.
- *                If the library user does not copy nor send it before asking for another one, the
- *                first PPDU might be corrupted by the PPDU header of the second one.
+ * @ingroup       RLE receiver
+ */
+void rle_decap_engine_destroy(struct rle_decap_engine **const engine);
+
+/**
+ * @brief         Run a batch of decapsulation jobs on the workers, and wait for their completion.
  *
- * @param[in,out] transmitter             The transmitter module. Used for its conf only, its
- *                                        context is not use.
- * @param[in,out] f_buff                  The fragmentation buffer (containing an ALPDU).
- * @param[out]    ppdu                    Extracted Payload-adapted PDU (fragment of ALPDU).
- * @param[in,out] ppdu_length             Asked size of the extracted PPDU. The size returned is the
- *                                        one really extracted.
- *                                        for instance, if the caller wants a 100 octets PPDU, but
- *                                        the RLE library can only return 80 octets PPDU,
- *                                        ppdu_length will be overwritten with 80.
+ *                The receivers of the jobs shall not be used by the caller nor by another engine
+ *                until the batch completes. The trace callback may be called by every worker.
  *
- * @return        Fragmentation status.
+ * @param[in,out] engine                  The engine.
+ * @param[in,out] jobs                    The jobs, their status and SDUs are set on completion.
+ * @param[in]     jobs_nr                 The number of jobs, at most the max of the engine.
  *
- * @ingroup       RLE transmitter
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE receiver
  */
-enum rle_frag_status rle_frag_contextless(struct rle_transmitter *const transmitter,
-                                          struct rle_frag_buf *const f_buff,
-                                          unsigned char **const ppdu,
-                                          size_t *const ppdu_length)
+int rle_decap_engine_run(struct rle_decap_engine *const engine,
+                         struct rle_decap_job jobs[],
+                         const size_t jobs_nr)
 __attribute__((warn_unused_result));
 
+#endif
+
+#ifdef __KERNEL__
+
+/** Stubs for visibility */
+struct sk_buff;
+struct sk_buff_head;
+struct net_device;
+
 /**
- * @brief         Init the given FPDU with the given Payload Label
+ * @brief         RLE encapsulation of a socket buffer. Encapsulate a SDU given in a sk_buff in a
+ *                RLE ALPDU frame.
  *
- * @param[in]     label                   The FPDU label fields.
- * @param[in]     label_size              Size of the FPDU label field
- * @param[in,out] fpdu                    Generated/modified Frame PDU
- * @param[in,out] fpdu_current_pos        Current position in the FPDU
- * @param[in,out] fpdu_remaining_size     Remaining size in the FPDU
+ *                A linear and writable skb with RLE_ENCAP_HEADROOM octets of headroom and
+ *                RLE_ENCAP_TAILROOM octets of tailroom is encapsulated in place, as
+ *                \ref rle_encapsulate_zero_copy does, the ALPDU header and trailer being written
+ *                in the skb. Otherwise, the linear part and the page fragments of the skb are
+ *                gathered in the context, as \ref rle_encapsulate_segments does. A skb with a
+ *                fragment list is linearized first.
  *
- * @return        Frame packing status
+ * @warning       The skb shall be kept untouched until the context is fully fragmented, and given
+ *                to each \ref rle_fragment_pack_skb call of the context.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in,out] skb                     The SDU to encapsulate.
+ * @param[in]     protocol_type           The protocol type (uncompressed) of the SDU.
+ * @param[in]     frag_id                 Identify the context to which belongs the datas to encap.
+ *
+ * @return        Encapsulation status.
  *
  * @ingroup       RLE transmitter
  */
-enum rle_pack_status rle_pack_init(const unsigned char *const label,
-                                   const size_t label_size,
-                                   unsigned char *const fpdu,
-                                   size_t *const fpdu_current_pos,
-                                   size_t *const fpdu_remaining_size)
+enum rle_encap_status rle_encapsulate_skb(struct rle_transmitter *const transmitter,
+                                          struct sk_buff *const skb,
+                                          const uint16_t protocol_type,
+                                          const uint8_t frag_id)
 __attribute__((warn_unused_result));
 
 /**
- * @brief         RLE frame packing. Pack the given PPDU in the given FPDU.
- *
- * @param[in]     ppdu                    A PPDU to pack.
- * @param[in]     ppdu_length             The PPDU size.
+ * @brief         RLE fragmentation and packing of a socket buffer in a FPDU socket buffer.
+ *
+ *                Same as \ref rle_fragment_pack, with a FPDU of \e fpdu_size octets built in the
+ *                \e fpdu skb. The END and COMPLETE PPDUs of a SDU encapsulated in place are not
+ *                copied: a clone of the SDU skb, trimmed to the PPDU, is chained to the fragment
+ *                list of the FPDU. The START and CONTINUATION PPDUs are copied, as the header of
+ *                the next PPDU of the context is written over their end.
+ *
+ * @param[in,out] transmitter             The transmitter holding the context to fragment.
+ * @param[in]     frag_id                 The fragment id of the context.
+ * @param[in]     sdu                     The skb given to \ref rle_encapsulate_skb for the
+ *                                        context.
  * @param[in]     label                   The FPDU label fields.
  * @param[in]     label_size              Size of the FPDU label fields.
- * @param[in,out] fpdu                    Generated/modified Frame PDU.
- * @param[in,out] fpdu_current_pos        Current position in the FPDU.
- * @param[in,out] fpdu_remaining_size     Remaining size in the FPDU.
+ * @param[in,out] fpdu                    The FPDU, a linear skb with at least \e fpdu_size octets
+ *                                        of tailroom when empty.
+ * @param[in]     fpdu_size               The size of the FPDU.
  *
- * @return        Frame packing status.
+ * @return        Frame packing status, as \ref rle_fragment_pack.
  *
  * @ingroup       RLE transmitter
  */
-enum rle_pack_status rle_pack(const unsigned char *const ppdu,
-                              const size_t ppdu_length,
-                              const unsigned char *const label,
-                              const size_t label_size,
-                              unsigned char *const fpdu,
-                              size_t *const fpdu_current_pos,
-                              size_t *const fpdu_remaining_size)
+enum rle_pack_status rle_fragment_pack_skb(struct rle_transmitter *const transmitter,
+                                           const uint8_t frag_id,
+                                           const struct sk_buff *const sdu,
+                                           const unsigned char *const label,
+                                           const size_t label_size,
+                                           struct sk_buff *const fpdu,
+                                           const size_t fpdu_size)
 __attribute__((warn_unused_result));
 
 /**
- * @brief         RLE padding. Pad the given FPDU with 0x00 octets.
+ * @brief         Pad a FPDU socket buffer built by \ref rle_fragment_pack_skb up to its size.
  *
- * @param[in,out] fpdu                    Frame PDU to pad.
- * @param[in]     fpdu_current_pos        Current position in the FPDU.
- * @param[in]     fpdu_remaining_size     Remaining size in the FPDU.
+ * @param[in,out] fpdu                    The FPDU.
+ * @param[in]     fpdu_size               The size of the FPDU.
+ *
+ * @return        0 if OK, else 1.
  *
  * @ingroup       RLE transmitter
  */
-void rle_pad(unsigned char *const fpdu,
-             const size_t fpdu_current_pos,
-             const size_t fpdu_remaining_size);
+int rle_pad_skb(struct sk_buff *const fpdu, const size_t fpdu_size)
+__attribute__((warn_unused_result));
 
 /**
- * @brief Decapsulate the given FPDU into zero or more SDUs
- *
- * The function returns all of the SDUs that are fully decapsulated. If some
- * PPDU fragments are missing for some of them, the fragments that are already
- * received are kept in the internal contexts of the library. Next calls to
- * the function may complete them, they will then be added to the \e sdus output
- * parameter.
- *
- * The payload label is extracted in a preallocated buffer depending on the size
- * given by the caller. This size is known by the type of FPDU awaited and the
- * predefined size given by ETSI EN 301 545-2 V1.2.1, tab. 7-10 p. 119.
+ * @brief         Decapsulate the given FPDU socket buffer into zero or more SDU socket buffers.
  *
- * The array of SDUs \e sdus shall be initialized by the caller with
- * \e sdus_max_nr memory areas of at least 4095 bytes each. The \e sdus[n].size
- * and \e sdus[n].protocol_type shall be set to 0.
+ *                Same as \ref rle_decapsulate_cb, with the SDUs queued as skbs ready for
+ *                netif_receive_skb(). The SDUs of COMPLETE PPDUs are not copied, their skbs are
+ *                clones of the FPDU trimmed to the SDU. The SDUs reassembled from fragments are
+ *                copied once in new skbs. The FPDU is linearized and unshared if needed, it stays
+ *                owned by the caller.
  *
  * @param[in,out] receiver                The receiver module.
- * @param[in]     fpdu                    The FPDU to decapsulate.
- * @param[in]     fpdu_length             The size of the FPDU.
- * @param[in,out] sdus                    The SDUs array to extract from the FPDU, preallocated.
- * @param[in]     sdus_max_nr             The SDUs array size, max number of extractable SDUs.
- * @param[out]    sdus_nr                 The current number of SDUs in the SDUs array.
+ * @param[in,out] fpdu                    The FPDU to decapsulate.
+ * @param[in]     dev                     The network device receiving the SDUs, may be NULL.
+ * @param[in,out] sdus                    The queue the SDU skbs are appended to.
  * @param[in,out] payload_label           The identifier of the RCST, preallocated.
  * @param[in]     payload_label_size      The size of the paylod label.
  *
- * @return        decapsulation status.
+ * @return        decapsulation status, RLE_DECAP_ERR_SOME_DROP if a SDU skb is not allocated.
  *
  * @ingroup       RLE receiver
  */
-enum rle_decap_status rle_decapsulate(struct rle_receiver *const receiver,
-                                      unsigned char *const fpdu,
-                                      const size_t fpdu_length,
-                                      struct rle_sdu sdus[],
-                                      const size_t sdus_max_nr,
-                                      size_t *const sdus_nr,
-                                      unsigned char *const payload_label,
-                                      const size_t payload_label_size)
+enum rle_decap_status rle_decapsulate_skb(struct rle_receiver *const receiver,
+                                          struct sk_buff *const fpdu,
+                                          struct net_device *const dev,
+                                          struct sk_buff_head *const sdus,
+                                          unsigned char *const payload_label,
+                                          const size_t payload_label_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Decapsulate the given FPDU socket buffer with the receiver of the terminal it
+ *                comes from.
+ *
+ *                Same as \ref rle_decapsulate_skb, the terminal being identified by the payload
+ *                label at the start of the FPDU, as \ref rle_receiver_set_decapsulate does.
+ *
+ * @param[in,out] set                     The receiver set.
+ * @param[in,out] fpdu                    The FPDU to decapsulate.
+ * @param[in]     dev                     The network device receiving the SDUs, may be NULL.
+ * @param[in,out] sdus                    The queue the SDU skbs are appended to.
+ * @param[out]    payload_label           The payload label of the terminal, preallocated with
+ *                                        the payload label size of the set.
+ *
+ * @return        decapsulation status, RLE_DECAP_ERR_SOME_DROP if a SDU skb is not allocated.
+ *
+ * @ingroup       RLE receiver
+ */
+enum rle_decap_status rle_receiver_set_decapsulate_skb(struct rle_receiver_set *const set,
+                                                       struct sk_buff *const fpdu,
+                                                       struct net_device *const dev,
+                                                       struct sk_buff_head *const sdus,
+                                                       unsigned char *const payload_label)
+__attribute__((warn_unused_result));
+
+/** Per-CPU RLE receiver sets, each CPU decapsulating the FPDUs it polls without lock */
+struct rle_receiver_set_percpu;
+
+/**
+ * @brief         Create a RLE receiver set per possible CPU.
+ *
+ *                The receivers of new terminals are allocated without sleeping, so that the sets
+ *                can decapsulate in softirq context, and the pool of reassembly storages is filled
+ *                at creation so that their START PPDUs seldom allocate. Shall be called in a
+ *                context that may sleep.
+ *
+ * @param[in]     conf                    The configuration of the RLE receivers.
+ * @param[in]     payload_label_size      The size of the payload label identifying terminals, 3
+ *                                        or 6.
+ * @param[in]     terminals_max           The max number of active terminals per CPU.
+ *
+ * @return        A pointer to the per-CPU receiver sets, NULL on error.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_receiver_set_percpu * rle_receiver_set_percpu_new(const struct rle_config *const conf,
+                                                             const size_t payload_label_size,
+                                                             const size_t terminals_max)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Destroy per-CPU RLE receiver sets, once no CPU polls them anymore.
+ *
+ * @param[in,out] sets                     The per-CPU receiver sets to destroy.
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_receiver_set_percpu_destroy(struct rle_receiver_set_percpu **const sets);
+
+/**
+ * @brief         Get the receiver set of a CPU, for instance to read its statistics.
+ *
+ * @param[in]     sets                     The per-CPU receiver sets.
+ * @param[in]     cpu                      The CPU, a possible one.
+ *
+ * @return        The receiver set of the CPU.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_receiver_set * rle_receiver_set_percpu_get(const struct rle_receiver_set_percpu *const
+                                                      sets,
+                                                      const int cpu)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Decapsulate a budget of FPDU socket buffers with the receiver set of the current
+ *                CPU, as the poll function of a NAPI instance does.
+ *
+ *                At most \e budget FPDUs are dequeued from \e fpdus and decapsulated with
+ *                \ref rle_receiver_set_decapsulate_skb, then released. The FPDUs of a terminal
+ *                shall always be polled on the same CPU, for instance by steering the carriers of
+ *                a terminal to the same receive queue, as its SDUs are reassembled by the set of
+ *                that CPU. Shall be called with the bottom halves disabled, as in a NAPI poll.
+ *
+ * @param[in,out] sets                    The per-CPU receiver sets.
+ * @param[in,out] fpdus                   The queue of the FPDUs to decapsulate, not locked.
+ * @param[in]     dev                     The network device receiving the SDUs, may be NULL.
+ * @param[in,out] sdus                    The queue the SDU skbs are appended to, not locked.
+ * @param[in]     budget                  The max number of FPDUs to decapsulate.
+ *
+ * @return        The number of FPDUs decapsulated or dropped, less than \e budget if \e fpdus
+ *                was emptied.
+ *
+ * @ingroup       RLE receiver
+ */
+int rle_decapsulate_poll(struct rle_receiver_set_percpu *const sets,
+                         struct sk_buff_head *const fpdus,
+                         struct net_device *const dev,
+                         struct sk_buff_head *const sdus,
+                         const int budget)
 __attribute__((warn_unused_result));
 
+#endif
+
 /**
  * @brief         Get occupied size of a queue (frag_id) in an RLE transmitter module.
  *
+ *                The ALPDUs of the SDUs queued behind the current one are counted too.
+ *
  * @param[in]     transmitter             The transmitter module. Must be initialize.
  * @param[in]     fragment_id             Fragment id to use. Must be valid.
  *
@@ -623,6 +2726,44 @@ size_t rle_transmitter_stats_get_queue_size(const struct rle_transmitter *const
                                             const uint8_t fragment_id)
 __attribute__((warn_unused_result));
 
+/**
+ * @brief         Get the backlog of a traffic class or of a whole RLE transmitter module.
+ *
+ *                The ALPDU octets and ALPDUs are maintained on each SDU and PPDU, so that they
+ *                are read in constant time, and may be read by another thread than the one of
+ *                the transmitter. The PPDUs are estimated as if each ALPDU was sent in bursts of
+ *                the given size: a PPDU per ALPDU, plus a PPDU per burst of ALPDU octets, each
+ *                fragmented ALPDU getting a START PPDU header and a trailer.
+ *
+ * @param[in]     transmitter             The transmitter module.
+ * @param[in]     traffic_class           The traffic class, RLE_TRAFFIC_CLASSES_NR for all.
+ * @param[in]     burst_size              The burst size of the estimate, above 4 octets.
+ * @param[out]    backlog                 The backlog.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE transmitter statistics
+ */
+int rle_transmitter_stats_get_backlog(const struct rle_transmitter *const transmitter,
+                                      const uint8_t traffic_class,
+                                      const size_t burst_size,
+                                      struct rle_transmitter_backlog *const backlog)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the number of SDUs queued behind the current one of a context.
+ *
+ * @param[in]     transmitter             The transmitter module. Must be initialize.
+ * @param[in]     fragment_id             Fragment id to use. Must be valid.
+ *
+ * @return        Number of SDUs waiting in the queue, not counting the current one.
+ *
+ * @ingroup       RLE transmitter statistics
+ */
+size_t rle_transmitter_stats_get_queued_sdus(const struct rle_transmitter *const transmitter,
+                                             const uint8_t fragment_id)
+__attribute__((warn_unused_result));
+
 /**
  * @brief         Get total number of ready to be sent SDU of an RLE transmitter queue.
  *
@@ -683,60 +2824,127 @@ uint64_t rle_transmitter_stats_get_counter_bytes_in(const struct rle_transmitter
 __attribute__((warn_unused_result));
 
 /**
- * @brief         Get total number of sent octets of an RLE transmitter queue.
- *
- * @param[in]     trans              The transmitter module. Must be initialize.
- * @param[in]     fragment_id        The fragment id of the queue.
+ * @brief         Get total number of sent octets of an RLE transmitter queue.
+ *
+ * @param[in]     trans              The transmitter module. Must be initialize.
+ * @param[in]     fragment_id        The fragment id of the queue.
+ *
+ * @return        Number of octets sent.
+ *
+ * @ingroup       RLE transmitter statistics
+ */
+uint64_t rle_transmitter_stats_get_counter_bytes_sent(const struct rle_transmitter *const trans,
+                                                      const uint8_t fragment_id)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get total number of dropped octetsof an RLE transmitter queue.
+ *
+ * @param[in]     trans              The transmitter module. Must be initialize.
+ * @param[in]     fragment_id        The fragment id of the queue.
+ *
+ * @return        Number of octets sent.
+ *
+ * @ingroup       RLE transmitter statistics
+ */
+uint64_t rle_transmitter_stats_get_counter_bytes_dropped(const struct rle_transmitter *const trans,
+                                                         const uint8_t fragment_id)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Dump all the statistics of a given RLE transmitter queue in an RLE stats
+ *                structure.
+ *
+ * @param[in]     transmitter              The transmitter module. Must be initialize.
+ * @param[in]     fragment_id              The fragment id of the queue.
+ * @param[out]    stats                    The RLE stats structure.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE transmitter statistics
+ */
+int rle_transmitter_stats_get_counters(const struct rle_transmitter *const transmitter,
+                                       const uint8_t fragment_id,
+                                       struct rle_transmitter_stats *const stats)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Dump the statistics of all the RLE transmitter queues in RLE stats structures,
+ *                and their sum.
+ *
+ * @param[in]     transmitter              The transmitter module. Must be initialize.
+ * @param[out]    stats                    The RLE stats structures, indexed by fragment id. May be
+ *                                         NULL if only the total is needed.
+ * @param[out]    total                    The sum of the statistics of all the queues. May be NULL
+ *                                         if only the queues statistics are needed.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE transmitter statistics
+ */
+int rle_transmitter_stats_get_all_counters(const struct rle_transmitter *const transmitter,
+                                           struct rle_transmitter_stats stats[RLE_MAX_FRAG_NUMBER],
+                                           struct rle_transmitter_stats *const total)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Reset all the statistics of a given RLE transmitter queue in an RLE stats
  *
- * @return        Number of octets sent.
+ * @param[in,out] transmitter              The transmitter module. Must be initialize.
+ * @param[in]     fragment_id              The fragment id of the queue.
  *
  * @ingroup       RLE transmitter statistics
  */
-uint64_t rle_transmitter_stats_get_counter_bytes_sent(const struct rle_transmitter *const trans,
-                                                      const uint8_t fragment_id)
-__attribute__((warn_unused_result));
+void rle_transmitter_stats_reset_counters(struct rle_transmitter *const transmitter,
+                                          const uint8_t fragment_id);
 
 /**
- * @brief         Get total number of dropped octetsof an RLE transmitter queue.
+ * @brief         Dump the statistics of all the RLE transmitter queues since their last reset,
+ *                and their sum, and reset them, in a single pass.
  *
- * @param[in]     trans              The transmitter module. Must be initialize.
- * @param[in]     fragment_id        The fragment id of the queue.
+ *                The data path never sees the reset: each counter is read once and the next
+ *                dump starts from the value read, so that no SDU encapsulated meanwhile is lost
+ *                when polling a transmitter in use by another thread. The histograms of the
+ *                SIZE_STATS option are left as they are.
  *
- * @return        Number of octets sent.
+ * @param[in,out] transmitter              The transmitter module. Must be initialize.
+ * @param[out]    stats                    The RLE stats structures, indexed by fragment id. May be
+ *                                         NULL if only the total is needed.
+ * @param[out]    total                    The sum of the statistics of all the queues. May be NULL
+ *                                         if only the queues statistics are needed.
+ *
+ * @return        0 if OK, else 1.
  *
  * @ingroup       RLE transmitter statistics
  */
-uint64_t rle_transmitter_stats_get_counter_bytes_dropped(const struct rle_transmitter *const trans,
-                                                         const uint8_t fragment_id)
+int rle_transmitter_stats_fetch_and_reset(struct rle_transmitter *const transmitter,
+                                          struct rle_transmitter_stats stats[RLE_MAX_FRAG_NUMBER],
+                                          struct rle_transmitter_stats *const total)
 __attribute__((warn_unused_result));
 
 /**
- * @brief         Dump all the statistics of a given RLE transmitter queue in an RLE stats
- *                structure.
+ * @brief         Get the number of SDUs encapsulated by a RLE transmitter per class of protocol
+ *                type, since the last epoch or reset.
  *
- * @param[in]     transmitter              The transmitter module. Must be initialize.
- * @param[in]     fragment_id              The fragment id of the queue.
- * @param[out]    stats                    The RLE stats structure.
+ * @param[in]     transmitter              The transmitter module.
+ * @param[out]    mix                      The number of SDUs of each class.
  *
  * @return        0 if OK, else 1.
  *
  * @ingroup       RLE transmitter statistics
  */
-int rle_transmitter_stats_get_counters(const struct rle_transmitter *const transmitter,
-                                       const uint8_t fragment_id,
-                                       struct rle_transmitter_stats *const stats)
+int rle_transmitter_stats_get_ptype_mix(const struct rle_transmitter *const transmitter,
+                                        uint64_t mix[RLE_PTYPE_CLASSES_NR])
 __attribute__((warn_unused_result));
 
 /**
- * @brief         Reset all the statistics of a given RLE transmitter queue in an RLE stats
+ * @brief         Reset the numbers of SDUs per class of protocol type of a RLE transmitter.
  *
- * @param[in,out] transmitter              The transmitter module. Must be initialize.
- * @param[in]     fragment_id              The fragment id of the queue.
+ * @param[in,out] transmitter              The transmitter module.
  *
  * @ingroup       RLE transmitter statistics
  */
-void rle_transmitter_stats_reset_counters(struct rle_transmitter *const transmitter,
-                                          const uint8_t fragment_id);
+void rle_transmitter_stats_reset_ptype_mix(struct rle_transmitter *const transmitter);
 
 /**
  * @brief         Get occupied size of a queue (frag_id) in a RLE receiver queue.
@@ -863,6 +3071,9 @@ __attribute__((warn_unused_result));
  * @brief         Dump all the statistics of a given RLE receiver queue in an RLE stats
  *                structure.
  *
+ *                The counters are consistent with each other, see
+ *                rle_receiver_stats_get_all_counters().
+ *
  * @param[in]     receiver                 The receiver module. Must be initialize.
  * @param[in]     fragment_id              The fragment id of the queue.
  * @param[out]    stats                    The RLE stats structure.
@@ -876,17 +3087,335 @@ int rle_receiver_stats_get_counters(const struct rle_receiver *const receiver,
                                     struct rle_receiver_stats *const stats)
 __attribute__((warn_unused_result));
 
+/**
+ * @brief         Dump the statistics of all the RLE receiver queues in RLE stats structures, and
+ *                their sum.
+ *
+ *                The snapshot is consistent: it is taken between the decapsulations of two FPDUs,
+ *                without locking, so that a monitoring thread may poll receivers in use by other
+ *                threads. It shall not be taken from the trace callback.
+ *
+ * @param[in]     receiver                 The receiver module. Must be initialize.
+ * @param[out]    stats                    The RLE stats structures, indexed by fragment id. May be
+ *                                         NULL if only the total is needed.
+ * @param[out]    total                    The sum of the statistics of all the queues. May be NULL
+ *                                         if only the queues statistics are needed.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE receiver statistics
+ */
+int rle_receiver_stats_get_all_counters(const struct rle_receiver *const receiver,
+                                        struct rle_receiver_stats stats[RLE_MAX_FRAG_NUMBER],
+                                        struct rle_receiver_stats *const total)
+__attribute__((warn_unused_result));
+
 /**
  * @brief         Reset all the statistics of a given RLE receiver queue in an RLE stats
  *
  * @param[in,out] receiver                 The receiver module. Must be initialize.
- * @param[in]     fragment_id              The fragment id of the queue.
+ * @param[in]     fragment_id              The fragment id of the queue, or
+ *                                         RLE_SIZE_STATS_COMP_ID for the histograms of the SDUs
+ *                                         of COMPLETE PPDUs only.
  *
  * @ingroup       RLE receiver statistics
  */
 void rle_receiver_stats_reset_counters(struct rle_receiver *const receiver,
                                        const uint8_t fragment_id);
 
+/**
+ * @brief         Dump the statistics of all the RLE receiver queues since their last reset, and
+ *                their sum, and reset them, in a single pass.
+ *
+ *                The snapshot is consistent, as with rle_receiver_stats_get_all_counters(), and
+ *                the next dump starts from it: no SDU decapsulated meanwhile is lost. The data
+ *                path never sees the reset. The histograms of the SIZE_STATS option are left as
+ *                they are.
+ *
+ * @param[in,out] receiver                 The receiver module. Must be initialize.
+ * @param[out]    stats                    The RLE stats structures, indexed by fragment id. May be
+ *                                         NULL if only the total is needed.
+ * @param[out]    total                    The sum of the statistics of all the queues. May be NULL
+ *                                         if only the queues statistics are needed.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE receiver statistics
+ */
+int rle_receiver_stats_fetch_and_reset(struct rle_receiver *const receiver,
+                                       struct rle_receiver_stats stats[RLE_MAX_FRAG_NUMBER],
+                                       struct rle_receiver_stats *const total)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Whether the library is built with the TIMING_STATS option, measuring the
+ *                duration of the encapsulation and decapsulation stages.
+ *
+ *                Built without, timing costs nothing and no histogram may be fetched.
+ *
+ * @return        1 if the stages are timed, 0 otherwise.
+ *
+ * @ingroup       RLE timing
+ */
+int rle_timing_is_enabled(void)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the durations histogram of a stage of a RLE transmitter.
+ *
+ *                The histogram is read without locking, as the counters, so that a monitoring
+ *                thread may poll transmitters in use by other threads.
+ *
+ * @param[in]     transmitter              The transmitter module.
+ * @param[in]     stage                    A stage of the transmitter, from RLE_TIMING_ALPDU_HDR
+ *                                         to RLE_TIMING_PPDU_HDR.
+ * @param[out]    histogram                The histogram of the stage.
+ *
+ * @return        0 if OK, else 1, also if the stages are not timed.
+ *
+ * @ingroup       RLE timing
+ */
+int rle_transmitter_timing_get(const struct rle_transmitter *const transmitter,
+                               const enum rle_timing_stage stage,
+                               struct rle_timing_histogram *const histogram)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Reset the durations histograms of all the stages of a RLE transmitter.
+ *
+ * @param[in,out] transmitter              The transmitter module.
+ *
+ * @ingroup       RLE timing
+ */
+void rle_transmitter_timing_reset(struct rle_transmitter *const transmitter);
+
+/**
+ * @brief         Get the durations histogram of a stage of a RLE receiver.
+ *
+ *                The histogram is read without locking, as the counters.
+ *
+ * @param[in]     receiver                 The receiver module.
+ * @param[in]     stage                    A stage of the receiver, from RLE_TIMING_RASM_CONT to
+ *                                         RLE_TIMING_RASM_COMP.
+ * @param[out]    histogram                The histogram of the stage.
+ *
+ * @return        0 if OK, else 1, also if the stages are not timed.
+ *
+ * @ingroup       RLE timing
+ */
+int rle_receiver_timing_get(const struct rle_receiver *const receiver,
+                            const enum rle_timing_stage stage,
+                            struct rle_timing_histogram *const histogram)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Reset the durations histograms of all the stages of a RLE receiver.
+ *
+ * @param[in,out] receiver                 The receiver module.
+ *
+ * @ingroup       RLE timing
+ */
+void rle_receiver_timing_reset(struct rle_receiver *const receiver);
+
+/**
+ * @brief         Get the durations histogram of the packing, shared by the whole library as
+ *                rle_pack() has no module.
+ *
+ * @param[out]    histogram                The histogram of RLE_TIMING_PACK.
+ *
+ * @return        0 if OK, else 1, also if the stages are not timed.
+ *
+ * @ingroup       RLE timing
+ */
+int rle_pack_timing_get(struct rle_timing_histogram *const histogram)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Reset the durations histogram of the packing.
+ *
+ * @ingroup       RLE timing
+ */
+void rle_pack_timing_reset(void);
+
+/**
+ * @brief         Whether the library is built with the COPY_STATS option, counting the octets
+ *                copied and covered by a CRC on the data path.
+ *
+ *                Built without, counting costs nothing and no counter may be fetched.
+ *
+ * @return        1 if the copies are counted, 0 otherwise.
+ *
+ * @ingroup       RLE copy statistics
+ */
+int rle_copy_stats_is_enabled(void)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the copies and CRC of a stage of a RLE transmitter.
+ *
+ *                The counters are read without locking, as the transmitter statistics.
+ *
+ * @param[in]     transmitter              The transmitter module.
+ * @param[in]     stage                    A stage of the transmitter, from RLE_COPY_SDU to
+ *                                         RLE_COPY_PACK.
+ * @param[out]    counters                 The counters of the stage.
+ *
+ * @return        0 if OK, else 1, also if the copies are not counted.
+ *
+ * @ingroup       RLE copy statistics
+ */
+int rle_transmitter_copy_stats_get(const struct rle_transmitter *const transmitter,
+                                   const enum rle_copy_stage stage,
+                                   struct rle_copy_counters *const counters)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Reset the copies and CRC counters of all the stages of a RLE transmitter.
+ *
+ * @param[in,out] transmitter              The transmitter module.
+ *
+ * @ingroup       RLE copy statistics
+ */
+void rle_transmitter_copy_stats_reset(struct rle_transmitter *const transmitter);
+
+/**
+ * @brief         Get the copies and CRC of a stage of a RLE receiver.
+ *
+ *                The counters are read without locking, as the receiver statistics.
+ *
+ * @param[in]     receiver                 The receiver module.
+ * @param[in]     stage                    A stage of the receiver, from RLE_COPY_RASM_FRAG to
+ *                                         RLE_COPY_WRAP.
+ * @param[out]    counters                 The counters of the stage.
+ *
+ * @return        0 if OK, else 1, also if the copies are not counted.
+ *
+ * @ingroup       RLE copy statistics
+ */
+int rle_receiver_copy_stats_get(const struct rle_receiver *const receiver,
+                                const enum rle_copy_stage stage,
+                                struct rle_copy_counters *const counters)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Reset the copies and CRC counters of all the stages of a RLE receiver.
+ *
+ * @param[in,out] receiver                 The receiver module.
+ *
+ * @ingroup       RLE copy statistics
+ */
+void rle_receiver_copy_stats_reset(struct rle_receiver *const receiver);
+
+/**
+ * @brief         Get the copies of rle_pack(), shared by the whole library as it has no module.
+ *
+ * @param[out]    counters                 The counters of RLE_COPY_PACK.
+ *
+ * @return        0 if OK, else 1, also if the copies are not counted.
+ *
+ * @ingroup       RLE copy statistics
+ */
+int rle_pack_copy_stats_get(struct rle_copy_counters *const counters)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Reset the copies counters of rle_pack().
+ *
+ * @ingroup       RLE copy statistics
+ */
+void rle_pack_copy_stats_reset(void);
+
+/**
+ * @brief         Whether the library is built with the SIZE_STATS option, counting the SDUs of
+ *                each context by size and by number of PPDUs.
+ *
+ *                Built without, counting costs nothing and no histogram may be fetched.
+ *
+ * @return        1 if the SDUs are counted, 0 otherwise.
+ *
+ * @ingroup       RLE size statistics
+ */
+int rle_size_stats_is_enabled(void)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the histograms of the SDUs sent by a RLE transmitter queue.
+ *
+ *                A SDU is counted once its last PPDU is fragmented. The histograms are read
+ *                without locking, as the counters, and reset with them by
+ *                rle_transmitter_stats_reset_counters().
+ *
+ * @param[in]     transmitter              The transmitter module.
+ * @param[in]     fragment_id              The fragment id of the queue.
+ * @param[out]    histogram                The histograms of the queue.
+ *
+ * @return        0 if OK, else 1, also if the SDUs are not counted.
+ *
+ * @ingroup       RLE size statistics
+ */
+int rle_transmitter_stats_get_size_histogram(const struct rle_transmitter *const transmitter,
+                                             const uint8_t fragment_id,
+                                             struct rle_size_histogram *const histogram)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the histograms of the SDUs reassembled by a RLE receiver queue.
+ *
+ *                A SDU is counted once reassembled, the SDUs dropped are not. The histograms are
+ *                read without locking, as the counters, and reset with them by
+ *                rle_receiver_stats_reset_counters().
+ *
+ * @param[in]     receiver                 The receiver module.
+ * @param[in]     fragment_id              The fragment id of the queue, or RLE_SIZE_STATS_COMP_ID
+ *                                         for the SDUs of COMPLETE PPDUs.
+ * @param[out]    histogram                The histograms of the queue.
+ *
+ * @return        0 if OK, else 1, also if the SDUs are not counted.
+ *
+ * @ingroup       RLE size statistics
+ */
+int rle_receiver_stats_get_size_histogram(const struct rle_receiver *const receiver,
+                                          const uint8_t fragment_id,
+                                          struct rle_size_histogram *const histogram)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the number of verified FPDUs whose padding contains non-zero octets.
+ *
+ * @param[in]     receiver                 The receiver module.
+ *
+ * @return        The number of FPDUs with invalid padding, 0 if the receiver is NULL.
+ *
+ * @ingroup       RLE receiver statistics
+ */
+uint64_t rle_receiver_stats_get_counter_padding_errors(const struct rle_receiver *const receiver)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the number of PPDUs or SDUs rejected by a receiver for a given reason.
+ *
+ *                Each rejection is counted once, under its first reason.
+ *
+ * @param[in]     receiver                 The receiver module.
+ * @param[in]     reason                   The reason of the rejection.
+ *
+ * @return        The number of rejections, 0 if the receiver is NULL or the reason is invalid.
+ *
+ * @ingroup       RLE receiver statistics
+ */
+uint64_t rle_receiver_stats_get_counter_errors(const struct rle_receiver *const receiver,
+                                               const enum rle_rcv_error reason)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Reset the rejection counters of a receiver, for all the reasons.
+ *
+ * @param[in,out] receiver                 The receiver module.
+ *
+ * @ingroup       RLE receiver statistics
+ */
+void rle_receiver_stats_reset_errors(struct rle_receiver *const receiver);
+
 /**
  * @brief       RLE header decompression of protocol type function.
  *
@@ -946,6 +3475,72 @@ enum rle_header_size_status rle_get_header_size(const struct rle_config *const c
                                                 size_t *const rle_header_size)
 __attribute__((warn_unused_result));
 
+/**
+ * @brief         Get the size of the ALPDU header of a protocol type.
+ *
+ *                The size is given by the same classification of protocol types as the one
+ *                the transmitter precomputes, so it matches what the transmitter sends.
+ *
+ * @param[in]     conf               The rle module configuration.
+ * @param[in]     protocol_type      The uncompressed protocol type of the SDU.
+ * @param[out]    alpdu_header_size  The size of the ALPDU header in octets, without label nor
+ *                                   protection bytes.
+ *
+ * @return        RLE_HEADER_SIZE_OK if size is calculated,
+ *                RLE_HEADER_SIZE_ERR on generic errors,
+ *                RLE_HEADER_SIZE_ERR_NON_DETERMINISTIC when size depends on the SDU payload
+ *                (VLAN frames, or IPv4/IPv6 with the IP implicit protocol type).
+ *
+ * @ingroup       RLE header
+ */
+enum rle_header_size_status rle_get_alpdu_header_size(const struct rle_config *const conf,
+                                                      const uint16_t protocol_type,
+                                                      size_t *const alpdu_header_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Estimate the PPDUs an SDU produces in a sequence of bursts, without building them.
+ *
+ *                The PPDUs are sized as rle_fragment() would build them if it was given each room
+ *                in turn, as long as the ALPDU does not fit, with at most RLE_MAX_PPDU_PL_SIZE
+ *                bytes of payload per PPDU. A room too small for the next PPDU is skipped. Nothing
+ *                is allocated nor copied.
+ *
+ * @param[in]     conf               The rle module configuration.
+ * @param[in]     sdu_length         The size of the SDU.
+ * @param[in]     protocol_type      The uncompressed protocol type of the SDU.
+ * @param[in]     burst_sizes        The rooms left for PPDUs in the bursts, FPDU label excluded.
+ * @param[in]     bursts_nr          The number of bursts.
+ * @param[out]    estimate           The PPDUs of the SDU.
+ *
+ * @return        RLE_HEADER_SIZE_OK if the estimate is computed,
+ *                RLE_HEADER_SIZE_ERR on generic errors,
+ *                RLE_HEADER_SIZE_ERR_NON_DETERMINISTIC when the ALPDU header size depends on the
+ *                SDU payload, see rle_get_alpdu_header_size().
+ *
+ * @ingroup       RLE header
+ */
+enum rle_header_size_status rle_estimate_overhead(const struct rle_config *const conf,
+                                                  const size_t sdu_length,
+                                                  const uint16_t protocol_type,
+                                                  const size_t burst_sizes[],
+                                                  const size_t bursts_nr,
+                                                  struct rle_overhead_estimate *const estimate)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Get the kernel used for the ALPDU CRC32 computation.
+ *
+ *                The kernel is selected once, at first use, depending on the running CPU. All
+ *                kernels give the same results.
+ *
+ * @return        The CRC32 kernel in use.
+ *
+ * @ingroup       RLE trailer
+ */
+enum rle_crc_impl rle_crc_get_implementation(void)
+__attribute__((warn_unused_result));
+
 /**
  * Enum listing all log levels
  */
@@ -973,7 +3568,13 @@ typedef enum {
 	RLE_MOD_ID_CTX = 9,
 	RLE_MOD_ID_RECEIVER = 10,
 	RLE_MOD_ID_TRANSMITTER = 11,
-	RLE_MOD_ID_TRAILER = 12
+	RLE_MOD_ID_TRAILER = 12,
+	RLE_MOD_ID_RECEIVER_SET = 13,
+	RLE_MOD_ID_DECAP_ENGINE = 14,
+	RLE_MOD_ID_SKB = 15,
+	RLE_MOD_ID_DPDK = 16,
+	RLE_MOD_ID_TX_PIPE = 17,
+	RLE_MOD_ID_SDU_POOL = 18
 } rle_mod_id_t;
 
 
@@ -1014,6 +3615,10 @@ typedef void (*rle_trace_callback_t) (const int module_id,
 
 /**
  * @brief register the log trace callback
+ *
+ * The callback may be registered from any thread, the logs traced meanwhile go to either the
+ * previous callback or the new one. It is the fallback of the instances without log sink.
+ *
  * @param callback the callback to register
  */
 void rle_set_trace_callback(rle_trace_callback_t callback);
@@ -1024,4 +3629,79 @@ void rle_set_trace_callback(rle_trace_callback_t callback);
  */
 rle_trace_callback_t rle_get_trace_callback(void);
 
+/**
+ * @brief set the most verbose log level given to the log trace callback
+ *
+ * The level is checked before the log message is built, so filtered logs cost almost nothing.
+ * All the levels are traced by default. Debug logs may also be compiled out with the
+ * RLE_LOG_NO_DEBUG build option.
+ *
+ * @param level the most verbose log level traced, e.g. RLE_LOG_LEVEL_ERROR to trace errors and
+ *              critical logs only
+ */
+void rle_set_log_level(const rle_log_level_t level);
+
+/**
+ * @brief retrieve the most verbose log level given to the log trace callback
+ * @return the most verbose log level traced
+ */
+rle_log_level_t rle_get_log_level(void);
+
+/**
+ * @brief Callback function of a log sink, see rle_log_sink
+ * @param context the context of the log sink
+ * @param module_id the rle internal module id
+ * @param level the log level requested (DEBUG, WARNING, etc.)
+ * @param file the filename in librle in which the log was requested
+ * @param line the line at which the log was requested in librle
+ * @param func the function in librle in which the log was requested
+ * @param fmt the string which contains the format of the message
+ * @param ... the additional parameters used to format the message
+ */
+typedef void (*rle_log_sink_callback_t) (void *const context,
+                                         const int module_id,
+                                         const int level,
+                                         const char *const file,
+                                         const int line,
+                                         const char *const func,
+                                         const char *const message,
+                                         ...);
+
+/**
+ * Log sink of a transmitter or a receiver, instead of the log trace callback and level.
+ * The sink belongs to the caller, it shall not change nor be released while it is set.
+ */
+struct rle_log_sink {
+	rle_log_sink_callback_t callback;  /**< The callback given the logs of the instance */
+	void *context;                     /**< The context given to the callback           */
+	rle_log_level_t level;             /**< The most verbose log level of the instance   */
+};
+
+/**
+ * @brief set the log sink of a transmitter
+ *
+ * The logs of the transmitter go to its sink, with its own level, instead of the log trace
+ * callback. The sink may be set or removed from another thread than the one of the transmitter.
+ *
+ * @param transmitter the transmitter
+ * @param sink the log sink, NULL to go back to the log trace callback and level
+ * @return 0 if OK, else 1 if the transmitter is NULL or the sink has no callback
+ */
+int rle_transmitter_set_log_sink(struct rle_transmitter *const transmitter,
+                                 const struct rle_log_sink *const sink)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief set the log sink of a receiver
+ *
+ * Same as rle_transmitter_set_log_sink(), for a receiver.
+ *
+ * @param receiver the receiver
+ * @param sink the log sink, NULL to go back to the log trace callback and level
+ * @return 0 if OK, else 1 if the receiver is NULL or the sink has no callback
+ */
+int rle_receiver_set_log_sink(struct rle_receiver *const receiver,
+                              const struct rle_log_sink *const sink)
+__attribute__((warn_unused_result));
+
 #endif /* __RLE_H__ */
@@ -0,0 +1,228 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_dpdk.h
+ * @brief  Interface of the DPDK adapter of the RLE library, working on rte_mbuf
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#ifndef __RLE_DPDK_H__
+#define __RLE_DPDK_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rle.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*---------------------------------- PUBLIC CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** Max number of segments of a SDU mbuf chain */
+#define RLE_DPDK_MAX_SEGMENTS  16
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** Stubs for visibility */
+struct rte_mbuf;
+struct rte_mempool;
+
+/** DPDK RLE transmitter, a RLE transmitter owning the SDU mbufs being fragmented */
+struct rle_dpdk_tx;
+
+/** DPDK RLE receiver, a RLE receiver delivering the SDUs as mbufs */
+struct rle_dpdk_rx;
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Create a DPDK RLE transmitter.
+ *
+ * @param[in]     conf                    The configuration of the RLE transmitter.
+ * @param[in]     fpdu_pool               The mempool of the FPDU mbufs.
+ * @param[in]     label                   The FPDU label fields, copied.
+ * @param[in]     label_size              Size of the FPDU label fields, 0, 3 or 6.
+ * @param[in]     fpdu_size               The size of the FPDUs, FPDU label included.
+ *
+ * @return        A pointer to the DPDK transmitter, NULL on error.
+ *
+ * @ingroup       RLE DPDK
+ */
+struct rle_dpdk_tx * rle_dpdk_tx_new(const struct rle_config *const conf,
+                                     struct rte_mempool *const fpdu_pool,
+                                     const unsigned char *const label,
+                                     const size_t label_size,
+                                     const size_t fpdu_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Destroy a DPDK RLE transmitter, and free the SDU mbufs it owns.
+ *
+ * @param[in,out] tx                      The DPDK transmitter, set to NULL.
+ *
+ * @ingroup       RLE DPDK
+ */
+void rle_dpdk_tx_destroy(struct rle_dpdk_tx **const tx);
+
+/**
+ * @brief         Get the RLE transmitter of a DPDK RLE transmitter, for its statistics.
+ *
+ * @param[in]     tx                      The DPDK transmitter.
+ *
+ * @return        The RLE transmitter.
+ *
+ * @ingroup       RLE DPDK
+ */
+struct rle_transmitter * rle_dpdk_tx_get_transmitter(const struct rle_dpdk_tx *const tx);
+
+/**
+ * @brief         Encapsulate a burst of SDU mbufs, each in a free fragmentation context.
+ *
+ *                Same semantics as rte_eth_tx_burst(): the mbufs consumed are owned by the
+ *                transmitter, the other ones, from the first SDU without free context, are left
+ *                to the caller. A contiguous, direct and unshared mbuf with RLE_ENCAP_HEADROOM
+ *                octets of headroom and RLE_ENCAP_TAILROOM octets of tailroom is encapsulated in
+ *                place, as \ref rle_encapsulate_zero_copy does. The segments of the other mbufs
+ *                are gathered in the context, as \ref rle_encapsulate_segments does. The SDUs
+ *                that cannot be encapsulated are consumed and freed.
+ *
+ * @param[in,out] tx                      The DPDK transmitter.
+ * @param[in,out] sdus                    The SDU mbufs.
+ * @param[in]     protocol_types          The protocol type (uncompressed) of each SDU.
+ * @param[in]     sdus_nr                 The number of SDUs.
+ *
+ * @return        The number of SDU mbufs consumed.
+ *
+ * @ingroup       RLE DPDK
+ */
+uint16_t rle_dpdk_encap_burst(struct rle_dpdk_tx *const tx,
+                              struct rte_mbuf *sdus[],
+                              const uint16_t protocol_types[],
+                              const uint16_t sdus_nr);
+
+/**
+ * @brief         Build a burst of FPDU mbufs from the SDUs being fragmented.
+ *
+ *                Same semantics as rte_eth_rx_burst(): up to \e fpdus_max_nr padded FPDUs are
+ *                built, and owned by the caller. The contexts are served in turn, an unfinished
+ *                context being served first in the next FPDU. The END and COMPLETE PPDUs of a SDU
+ *                encapsulated in place are not copied: an indirect mbuf attached to the SDU mbuf
+ *                is chained to the FPDU. The START and CONTINUATION PPDUs are copied, as the
+ *                header of the next PPDU of the context is written over their end. The SDU mbufs
+ *                are freed once fully fragmented.
+ *
+ * @param[in,out] tx                      The DPDK transmitter.
+ * @param[out]    fpdus                   The FPDU mbufs.
+ * @param[in]     fpdus_max_nr            The max number of FPDUs to build.
+ *
+ * @return        The number of FPDUs built, 0 if no SDU is pending.
+ *
+ * @ingroup       RLE DPDK
+ */
+uint16_t rle_dpdk_fpdu_burst(struct rle_dpdk_tx *const tx,
+                             struct rte_mbuf *fpdus[],
+                             const uint16_t fpdus_max_nr);
+
+/**
+ * @brief         Create a DPDK RLE receiver.
+ *
+ * @param[in]     conf                    The configuration of the RLE receiver.
+ * @param[in]     sdu_pool                The mempool of the SDU mbufs.
+ * @param[in]     payload_label_size      The size of the FPDU labels.
+ *
+ * @return        A pointer to the DPDK receiver, NULL on error.
+ *
+ * @ingroup       RLE DPDK
+ */
+struct rle_dpdk_rx * rle_dpdk_rx_new(const struct rle_config *const conf,
+                                     struct rte_mempool *const sdu_pool,
+                                     const size_t payload_label_size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Destroy a DPDK RLE receiver.
+ *
+ * @param[in,out] rx                      The DPDK receiver, set to NULL.
+ *
+ * @ingroup       RLE DPDK
+ */
+void rle_dpdk_rx_destroy(struct rle_dpdk_rx **const rx);
+
+/**
+ * @brief         Get the RLE receiver of a DPDK RLE receiver, for its statistics.
+ *
+ * @param[in]     rx                      The DPDK receiver.
+ *
+ * @return        The RLE receiver.
+ *
+ * @ingroup       RLE DPDK
+ */
+struct rle_receiver * rle_dpdk_rx_get_receiver(const struct rle_dpdk_rx *const rx);
+
+/**
+ * @brief         Get the number of SDUs the DPDK RLE receiver dropped, for lack of mbufs or of
+ *                room in the SDU bursts.
+ *
+ * @param[in]     rx                      The DPDK receiver.
+ *
+ * @return        The number of SDUs dropped.
+ *
+ * @ingroup       RLE DPDK
+ */
+uint64_t rle_dpdk_rx_get_sdus_dropped(const struct rle_dpdk_rx *const rx);
+
+/**
+ * @brief         Decapsulate a burst of FPDU mbufs into a burst of SDU mbufs.
+ *
+ *                Same semantics as rte_eth_rx_burst() for the SDUs: up to \e sdus_max_nr SDU
+ *                mbufs are returned, owned by the caller, the next SDUs being dropped. All the
+ *                FPDU mbufs are consumed. The SDUs of COMPLETE PPDUs are not copied, their mbufs
+ *                are indirect mbufs attached to the FPDU. The SDUs reassembled from fragments are
+ *                copied once in mbufs drawn from the SDU mempool. The packet type of the IPv4 and
+ *                IPv6 SDU mbufs is set to RTE_PTYPE_L3_IPV4 and RTE_PTYPE_L3_IPV6.
+ *
+ * @param[in,out] rx                      The DPDK receiver.
+ * @param[in,out] fpdus                   The FPDU mbufs.
+ * @param[in]     fpdus_nr                The number of FPDUs.
+ * @param[out]    sdus                    The SDU mbufs.
+ * @param[in]     sdus_max_nr             The max number of SDUs.
+ *
+ * @return        The number of SDU mbufs returned.
+ *
+ * @ingroup       RLE DPDK
+ */
+uint16_t rle_dpdk_decap_burst(struct rle_dpdk_rx *const rx,
+                              struct rte_mbuf *fpdus[],
+                              const uint16_t fpdus_nr,
+                              struct rte_mbuf *sdus[],
+                              const uint16_t sdus_max_nr);
+
+
+#endif /* __RLE_DPDK_H__ */
@@ -29,6 +29,12 @@
 #include <linux/module.h>
 #include "rle.h"
 
+#ifdef RLE_TRACEPOINTS
+/* the tracepoints of the librle system are created here, and fired in the library */
+#define CREATE_TRACE_POINTS
+#include "rle_trace_events.h"
+#endif
+
 #define PACKAGE_NAME    "RLE library"
 #define PACKAGE_VERSION "0.0.1"
 #define PACKAGE_LICENSE "Copyright (C) 2015, Thales Alenia Space France - All Rights Reserved"
@@ -39,17 +45,76 @@ MODULE_AUTHOR("Didier Barvaux, Henrick Deschamps, "
               "Thales Alenia Space France, Viveris Technologies");
 MODULE_DESCRIPTION(PACKAGE_NAME ", version " PACKAGE_VERSION);
 
+EXPORT_SYMBOL(rle_set_allocator);
+EXPORT_SYMBOL(rle_get_allocator);
 EXPORT_SYMBOL(rle_transmitter_new);
+EXPORT_SYMBOL(rle_transmitter_new_with_allocator);
+EXPORT_SYMBOL(rle_transmitter_size);
+EXPORT_SYMBOL(rle_transmitter_memory_footprint);
+EXPORT_SYMBOL(rle_transmitter_init_in_place);
+EXPORT_SYMBOL(rle_transmitter_fini);
 EXPORT_SYMBOL(rle_transmitter_destroy);
+EXPORT_SYMBOL(rle_transmitter_set_queue_depth);
+EXPORT_SYMBOL(rle_transmitter_set_traffic_class);
+EXPORT_SYMBOL(rle_transmitter_suggest_implicit_ptype);
+EXPORT_SYMBOL(rle_transmitter_set_implicit_ptype);
+EXPORT_SYMBOL(rle_transmitter_set_protection_policy);
 EXPORT_SYMBOL(rle_receiver_new);
+EXPORT_SYMBOL(rle_receiver_new_with_allocator);
+EXPORT_SYMBOL(rle_receiver_size);
+EXPORT_SYMBOL(rle_receiver_memory_footprint);
+EXPORT_SYMBOL(rle_receiver_init_in_place);
+EXPORT_SYMBOL(rle_receiver_fini);
 EXPORT_SYMBOL(rle_receiver_destroy);
+EXPORT_SYMBOL(rle_receiver_set_padding_check);
+EXPORT_SYMBOL(rle_receiver_set_fpdu_validation);
+EXPORT_SYMBOL(rle_receiver_set_ctx_timeout);
+EXPORT_SYMBOL(rle_receiver_set_implicit_ptype);
+EXPORT_SYMBOL(rle_receiver_tick);
+EXPORT_SYMBOL(rle_receiver_set_new);
+EXPORT_SYMBOL(rle_receiver_set_new_with_allocator);
+EXPORT_SYMBOL(rle_receiver_set_destroy);
+EXPORT_SYMBOL(rle_receiver_set_decapsulate);
+EXPORT_SYMBOL(rle_receiver_set_get_receiver);
+EXPORT_SYMBOL(rle_receiver_set_evict_idle);
+EXPORT_SYMBOL(rle_receiver_set_get_terminals_nr);
+EXPORT_SYMBOL(rle_receiver_set_stats_dump);
+EXPORT_SYMBOL(rle_receiver_set_stats_fetch_and_reset);
 EXPORT_SYMBOL(rle_encapsulate);
+EXPORT_SYMBOL(rle_encapsulate_auto);
+EXPORT_SYMBOL(rle_encapsulate_zero_copy);
+EXPORT_SYMBOL(rle_encapsulate_segments);
+EXPORT_SYMBOL(rle_encapsulate_batch);
 EXPORT_SYMBOL(rle_fragment);
+EXPORT_SYMBOL(rle_fragment_next);
+EXPORT_SYMBOL(rle_fragment_bursts);
 EXPORT_SYMBOL(rle_pack);
+EXPORT_SYMBOL(rle_fragment_pack);
+EXPORT_SYMBOL(rle_plan_bursts);
+EXPORT_SYMBOL(rle_pack_plan);
+EXPORT_SYMBOL(rle_pack_superframe);
 EXPORT_SYMBOL(rle_pack_init);
 EXPORT_SYMBOL(rle_pad);
 EXPORT_SYMBOL(rle_decapsulate);
+EXPORT_SYMBOL(rle_decapsulate_zero_copy);
+EXPORT_SYMBOL(rle_decapsulate_cb);
+EXPORT_SYMBOL(rle_fpdu_index);
+EXPORT_SYMBOL(rle_receiver_set_sdu_pool);
+EXPORT_SYMBOL(rle_receiver_set_stream);
+EXPORT_SYMBOL(rle_decapsulate_pooled);
+EXPORT_SYMBOL(rle_sdu_buffer_release);
+EXPORT_SYMBOL(rle_sdu_buffer_get_size);
+EXPORT_SYMBOL(rle_decap_cursor_init);
+EXPORT_SYMBOL(rle_decapsulate_resume);
+EXPORT_SYMBOL(rle_decapsulate_burst);
+EXPORT_SYMBOL(rle_decapsulate_wrapped);
+EXPORT_SYMBOL(rle_set_log_level);
+EXPORT_SYMBOL(rle_get_log_level);
+EXPORT_SYMBOL(rle_transmitter_set_log_sink);
+EXPORT_SYMBOL(rle_receiver_set_log_sink);
 EXPORT_SYMBOL(rle_transmitter_stats_get_queue_size);
+EXPORT_SYMBOL(rle_transmitter_stats_get_backlog);
+EXPORT_SYMBOL(rle_transmitter_stats_get_queued_sdus);
 EXPORT_SYMBOL(rle_transmitter_stats_get_counter_sdus_in);
 EXPORT_SYMBOL(rle_transmitter_stats_get_counter_sdus_sent);
 EXPORT_SYMBOL(rle_transmitter_stats_get_counter_sdus_dropped);
@@ -57,7 +122,11 @@ EXPORT_SYMBOL(rle_transmitter_stats_get_counter_bytes_in);
 EXPORT_SYMBOL(rle_transmitter_stats_get_counter_bytes_sent);
 EXPORT_SYMBOL(rle_transmitter_stats_get_counter_bytes_dropped);
 EXPORT_SYMBOL(rle_transmitter_stats_get_counters);
+EXPORT_SYMBOL(rle_transmitter_stats_get_all_counters);
 EXPORT_SYMBOL(rle_transmitter_stats_reset_counters);
+EXPORT_SYMBOL(rle_transmitter_stats_fetch_and_reset);
+EXPORT_SYMBOL(rle_transmitter_stats_get_ptype_mix);
+EXPORT_SYMBOL(rle_transmitter_stats_reset_ptype_mix);
 EXPORT_SYMBOL(rle_receiver_stats_get_queue_size);
 EXPORT_SYMBOL(rle_receiver_stats_get_counter_sdus_received);
 EXPORT_SYMBOL(rle_receiver_stats_get_counter_sdus_reassembled);
@@ -67,14 +136,58 @@ EXPORT_SYMBOL(rle_receiver_stats_get_counter_bytes_received);
 EXPORT_SYMBOL(rle_receiver_stats_get_counter_bytes_reassembled);
 EXPORT_SYMBOL(rle_receiver_stats_get_counter_bytes_dropped);
 EXPORT_SYMBOL(rle_receiver_stats_get_counters);
+EXPORT_SYMBOL(rle_receiver_stats_get_all_counters);
 EXPORT_SYMBOL(rle_receiver_stats_reset_counters);
+EXPORT_SYMBOL(rle_receiver_stats_fetch_and_reset);
+EXPORT_SYMBOL(rle_receiver_stats_get_counter_padding_errors);
+EXPORT_SYMBOL(rle_receiver_stats_get_counter_errors);
+EXPORT_SYMBOL(rle_receiver_stats_reset_errors);
+EXPORT_SYMBOL(rle_timing_is_enabled);
+EXPORT_SYMBOL(rle_transmitter_timing_get);
+EXPORT_SYMBOL(rle_transmitter_timing_reset);
+EXPORT_SYMBOL(rle_receiver_timing_get);
+EXPORT_SYMBOL(rle_receiver_timing_reset);
+EXPORT_SYMBOL(rle_pack_timing_get);
+EXPORT_SYMBOL(rle_pack_timing_reset);
+EXPORT_SYMBOL(rle_copy_stats_is_enabled);
+EXPORT_SYMBOL(rle_transmitter_copy_stats_get);
+EXPORT_SYMBOL(rle_transmitter_copy_stats_reset);
+EXPORT_SYMBOL(rle_receiver_copy_stats_get);
+EXPORT_SYMBOL(rle_receiver_copy_stats_reset);
+EXPORT_SYMBOL(rle_pack_copy_stats_get);
+EXPORT_SYMBOL(rle_pack_copy_stats_reset);
+EXPORT_SYMBOL(rle_size_stats_is_enabled);
+EXPORT_SYMBOL(rle_transmitter_stats_get_size_histogram);
+EXPORT_SYMBOL(rle_receiver_stats_get_size_histogram);
 EXPORT_SYMBOL(rle_header_ptype_decompression);
 EXPORT_SYMBOL(rle_header_ptype_is_compressible);
 EXPORT_SYMBOL(rle_header_ptype_compression);
 EXPORT_SYMBOL(rle_get_header_size);
+EXPORT_SYMBOL(rle_get_alpdu_header_size);
+EXPORT_SYMBOL(rle_estimate_overhead);
 EXPORT_SYMBOL(rle_frag_buf_new);
+EXPORT_SYMBOL(rle_frag_buf_memory_footprint);
 EXPORT_SYMBOL(rle_frag_buf_del);
 EXPORT_SYMBOL(rle_frag_buf_init);
 EXPORT_SYMBOL(rle_frag_buf_cpy_sdu);
+EXPORT_SYMBOL(rle_frag_buf_cpy_sdu_segments);
 EXPORT_SYMBOL(rle_encap_contextless);
 EXPORT_SYMBOL(rle_frag_contextless);
+EXPORT_SYMBOL(rle_frag_conf_new);
+EXPORT_SYMBOL(rle_frag_conf_destroy);
+EXPORT_SYMBOL(rle_frag_contextless_batch);
+EXPORT_SYMBOL(rle_tx_pipe_new);
+EXPORT_SYMBOL(rle_tx_pipe_destroy);
+EXPORT_SYMBOL(rle_tx_pipe_encapsulate);
+EXPORT_SYMBOL(rle_tx_pipe_dispatch);
+EXPORT_SYMBOL(rle_tx_pipe_get_size);
+EXPORT_SYMBOL(rle_crc_get_implementation);
+EXPORT_SYMBOL(rle_encapsulate_skb);
+EXPORT_SYMBOL(rle_fragment_pack_skb);
+EXPORT_SYMBOL(rle_pad_skb);
+EXPORT_SYMBOL(rle_decapsulate_skb);
+EXPORT_SYMBOL(rle_receiver_set_decapsulate_skb);
+EXPORT_SYMBOL(rle_receiver_set_percpu_new);
+EXPORT_SYMBOL(rle_receiver_set_percpu_destroy);
+EXPORT_SYMBOL(rle_receiver_set_percpu_get);
+EXPORT_SYMBOL(rle_decapsulate_poll);
@@ -0,0 +1,197 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   kmod_percpu.c
+ * @brief  Per-CPU RLE receiver sets and NAPI-style decapsulation of socket buffers
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include <linux/percpu.h>
+#include <linux/skbuff.h>
+#include <linux/netdevice.h>
+#include <linux/slab.h>
+
+#include "rle.h"
+#include "constants.h"
+#include "rle_allocator.h"
+#include "reassembly_buffer.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#define MODULE_ID RLE_MOD_ID_SKB
+
+/** The max size of a payload label */
+#define RLE_PERCPU_MAX_PAYLOAD_LABEL_SIZE  6
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE STRUCTS AND TYPEDEFS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** Per-CPU RLE receiver sets */
+struct rle_receiver_set_percpu {
+	struct rle_receiver_set *__percpu *sets;  /**< The receiver set of each possible CPU */
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PRIVATE FUNCTIONS --------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Destroy the receiver sets of all the possible CPUs, and release the pool of
+ *                reassembly storages.
+ *
+ * @param[in,out] sets                    The per-CPU receiver sets, their array included.
+ */
+static void percpu_sets_release(struct rle_receiver_set_percpu *const sets);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PRIVATE FUNCTIONS CODE ------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static void percpu_sets_release(struct rle_receiver_set_percpu *const sets)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		rle_receiver_set_destroy(per_cpu_ptr(sets->sets, cpu));
+	}
+	free_percpu(sets->sets);
+	rasm_buf_pool_put();
+}
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+struct rle_receiver_set_percpu * rle_receiver_set_percpu_new(const struct rle_config *const conf,
+                                                             const size_t payload_label_size,
+                                                             const size_t terminals_max)
+{
+	struct rle_receiver_set_percpu *sets;
+	int cpu;
+
+	if (payload_label_size > RLE_PERCPU_MAX_PAYLOAD_LABEL_SIZE) {
+		RLE_ERR("failed to create per-CPU receiver sets: payload label of %zu bytes",
+		        payload_label_size);
+		goto error;
+	}
+
+	sets = kzalloc(sizeof(struct rle_receiver_set_percpu), GFP_KERNEL);
+	if (sets == NULL) {
+		RLE_ERR("allocating per-CPU receiver sets failed");
+		goto error;
+	}
+
+	/* zeroed, so that the sets not created yet are skipped on release */
+	sets->sets = alloc_percpu(struct rle_receiver_set *);
+	if (sets->sets == NULL) {
+		RLE_ERR("allocating per-CPU receiver set pointers failed");
+		goto free_sets;
+	}
+
+	/* the pool is kept filled while the sets exist, even without terminal yet */
+	rasm_buf_pool_get();
+
+	for_each_possible_cpu(cpu) {
+		struct rle_receiver_set *const set =
+			rle_receiver_set_new_with_allocator(conf, payload_label_size, terminals_max,
+			                                    &rle_atomic_allocator);
+
+		if (set == NULL) {
+			RLE_ERR("failed to create the receiver set of CPU %d", cpu);
+			goto release_sets;
+		}
+		*per_cpu_ptr(sets->sets, cpu) = set;
+	}
+
+	rasm_buf_pool_fill();
+
+	return sets;
+
+release_sets:
+	percpu_sets_release(sets);
+free_sets:
+	kfree(sets);
+error:
+	return NULL;
+}
+
+void rle_receiver_set_percpu_destroy(struct rle_receiver_set_percpu **const sets)
+{
+	if (!sets || !*sets) {
+		/* Nothing to do. */
+		goto out;
+	}
+
+	percpu_sets_release(*sets);
+	kfree(*sets);
+	*sets = NULL;
+
+out:
+	return;
+}
+
+struct rle_receiver_set * rle_receiver_set_percpu_get(const struct rle_receiver_set_percpu *const
+                                                      sets,
+                                                      const int cpu)
+{
+	return *per_cpu_ptr(sets->sets, cpu);
+}
+
+int rle_decapsulate_poll(struct rle_receiver_set_percpu *const sets,
+                         struct sk_buff_head *const fpdus,
+                         struct net_device *const dev,
+                         struct sk_buff_head *const sdus,
+                         const int budget)
+{
+	/* the bottom halves are disabled, the CPU stays the same during the poll */
+	struct rle_receiver_set *const set = *this_cpu_ptr(sets->sets);
+	unsigned char payload_label[RLE_PERCPU_MAX_PAYLOAD_LABEL_SIZE];
+	int work_done;
+
+	for (work_done = 0; work_done < budget; work_done++) {
+		struct sk_buff *const fpdu = __skb_dequeue(fpdus);
+		enum rle_decap_status status;
+
+		if (fpdu == NULL) {
+			break;
+		}
+
+		/* the SDUs of COMPLETE PPDUs are clones of the FPDU, released with it */
+		status = rle_receiver_set_decapsulate_skb(set, fpdu, dev, sdus, payload_label);
+		if (status == RLE_DECAP_OK || status == RLE_DECAP_ERR_SOME_DROP) {
+			consume_skb(fpdu);
+		} else {
+			kfree_skb(fpdu);
+		}
+	}
+
+	return work_done;
+}
@@ -0,0 +1,522 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   kmod_skb.c
+ * @brief  RLE encapsulation and decapsulation of Linux kernel socket buffers
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include <linux/skbuff.h>
+#include <linux/netdevice.h>
+#include <linux/highmem.h>
+#include <linux/string.h>
+
+#include "rle.h"
+#include "constants.h"
+#include "header.h"
+#include "rle_receiver_set.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#define MODULE_ID RLE_MOD_ID_SKB
+
+/** Max number of segments of a SDU skb: its linear part and its page fragments */
+#define RLE_SKB_MAX_SEGMENTS  (1 + MAX_SKB_FRAGS)
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE STRUCTS AND TYPEDEFS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** The argument of the in-place delivery of the SDU skbs */
+struct skb_decap_arg {
+	struct sk_buff *fpdu;        /**< The FPDU being decapsulated            */
+	struct net_device *dev;      /**< The device receiving the SDUs, or NULL */
+	struct sk_buff_head *sdus;   /**< The queue of the SDU skbs              */
+	size_t dropped_nr;           /**< The number of SDUs without skb         */
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PRIVATE FUNCTIONS --------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Check whether a SDU skb can be encapsulated in place.
+ *
+ * @param[in]     skb                     The SDU skb.
+ *
+ * @return        true if the skb is linear, writable, and with room for the ALPDU header and
+ *                trailer, else false.
+ */
+static bool skb_is_encapsulable_in_place(const struct sk_buff *const skb);
+
+/**
+ * @brief         Check whether all the page fragments of a skb are mapped in the kernel.
+ *
+ * @param[in]     skb                     The skb.
+ *
+ * @return        true if no page fragment is in high memory, else false.
+ */
+static bool skb_frags_are_mapped(const struct sk_buff *const skb);
+
+/**
+ * @brief         Check whether a PPDU is the last one of its ALPDU.
+ *
+ * @param[in]     ppdu                    The PPDU.
+ *
+ * @return        true for an END or COMPLETE PPDU, else false.
+ */
+static bool ppdu_is_last(const unsigned char *const ppdu);
+
+/**
+ * @brief         Get the last skb of the fragment list of a FPDU.
+ *
+ * @param[in]     fpdu                    The FPDU, with a fragment list.
+ *
+ * @return        The last skb of the fragment list.
+ */
+static struct sk_buff * fpdu_get_last_chained(const struct sk_buff *const fpdu);
+
+/**
+ * @brief         Chain a skb at the end of the fragment list of a FPDU.
+ *
+ * @param[in,out] fpdu                    The FPDU.
+ * @param[in]     skb                     The skb to chain, owned by the FPDU afterwards.
+ */
+static void fpdu_chain(struct sk_buff *const fpdu, struct sk_buff *const skb);
+
+/**
+ * @brief         Extend the data of a FPDU, in its linear part as long as nothing is chained to
+ *                it, then in the last skb chained if it is writable, or in a new chained skb.
+ *
+ * @param[in,out] fpdu                    The FPDU.
+ * @param[in]     len                     The number of octets to add.
+ * @param[in]     fpdu_size               The size of the FPDU.
+ *
+ * @return        The start of the added octets, NULL if no skb can be allocated.
+ */
+static unsigned char * fpdu_put(struct sk_buff *const fpdu, const size_t len,
+                                const size_t fpdu_size);
+
+/**
+ * @brief         Chain a PPDU left in a SDU skb to a FPDU, without copying it.
+ *
+ * @param[in,out] fpdu                    The FPDU.
+ * @param[in]     sdu                     The SDU skb holding the PPDU.
+ * @param[in]     ppdu                    The PPDU.
+ * @param[in]     ppdu_length             The size of the PPDU.
+ *
+ * @return        0 if OK, 1 if the SDU skb cannot be cloned.
+ */
+static int fpdu_chain_ppdu(struct sk_buff *const fpdu, const struct sk_buff *const sdu,
+                           const unsigned char *const ppdu, const size_t ppdu_length);
+
+/**
+ * @brief         Deliver one SDU as a skb, delivery callback of the in-place decapsulation.
+ *
+ * @param[in,out] arg                     The argument of the delivery, a skb_decap_arg.
+ * @param[in]     sdu                     The SDU, left in the FPDU or in the reassembly storage.
+ */
+static void skb_deliver_sdu(void *const arg, const struct rle_sdu *const sdu);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PRIVATE FUNCTIONS CODE ------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static bool skb_is_encapsulable_in_place(const struct sk_buff *const skb)
+{
+	return !skb_is_nonlinear(skb) && !skb_cloned(skb) &&
+	       skb_headroom(skb) >= RLE_ENCAP_HEADROOM && skb_tailroom(skb) >= RLE_ENCAP_TAILROOM;
+}
+
+static bool skb_frags_are_mapped(const struct sk_buff *const skb)
+{
+	int i;
+
+	for (i = 0; i < skb_shinfo(skb)->nr_frags; i++) {
+		if (PageHighMem(skb_frag_page(&skb_shinfo(skb)->frags[i]))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool ppdu_is_last(const unsigned char *const ppdu)
+{
+	const rle_ppdu_hdr_t *const ppdu_hdr = (const rle_ppdu_hdr_t *)ppdu;
+
+	return ppdu_hdr->common.end_ind == 1;
+}
+
+static struct sk_buff * fpdu_get_last_chained(const struct sk_buff *const fpdu)
+{
+	struct sk_buff *last = skb_shinfo(fpdu)->frag_list;
+
+	while (last->next != NULL) {
+		last = last->next;
+	}
+
+	return last;
+}
+
+static void fpdu_chain(struct sk_buff *const fpdu, struct sk_buff *const skb)
+{
+	if (!skb_has_frag_list(fpdu)) {
+		skb_shinfo(fpdu)->frag_list = skb;
+	} else {
+		fpdu_get_last_chained(fpdu)->next = skb;
+	}
+	skb->next = NULL;
+
+	fpdu->len += skb->len;
+	fpdu->data_len += skb->len;
+	fpdu->truesize += skb->truesize;
+}
+
+static unsigned char * fpdu_put(struct sk_buff *const fpdu, const size_t len,
+                                const size_t fpdu_size)
+{
+	struct sk_buff *chunk;
+
+	/* the linear part of the FPDU has room for the whole FPDU */
+	if (!skb_has_frag_list(fpdu)) {
+		return skb_put(fpdu, len);
+	}
+
+	/* past a chained PPDU, the next octets go in a chained chunk */
+	chunk = fpdu_get_last_chained(fpdu);
+	if (skb_cloned(chunk) || skb_tailroom(chunk) < (int)len) {
+		chunk = alloc_skb(fpdu_size - fpdu->len, GFP_ATOMIC);
+		if (chunk == NULL) {
+			return NULL;
+		}
+		fpdu_chain(fpdu, chunk);
+	}
+
+	fpdu->len += len;
+	fpdu->data_len += len;
+
+	return skb_put(chunk, len);
+}
+
+static int fpdu_chain_ppdu(struct sk_buff *const fpdu, const struct sk_buff *const sdu,
+                           const unsigned char *const ppdu, const size_t ppdu_length)
+{
+	struct sk_buff *const clone = skb_clone((struct sk_buff *)sdu, GFP_ATOMIC);
+
+	if (clone == NULL) {
+		return 1;
+	}
+
+	/* the PPDU header is in the headroom of the SDU, the ALPDU trailer in its tailroom */
+	if (ppdu < clone->data) {
+		skb_push(clone, clone->data - ppdu);
+	} else {
+		skb_pull(clone, ppdu - clone->data);
+	}
+	if (clone->len < ppdu_length) {
+		skb_put(clone, ppdu_length - clone->len);
+	} else {
+		skb_trim(clone, ppdu_length);
+	}
+
+	fpdu_chain(fpdu, clone);
+
+	return 0;
+}
+
+static void skb_deliver_sdu(void *const arg, const struct rle_sdu *const sdu)
+{
+	struct skb_decap_arg *const decap = (struct skb_decap_arg *)arg;
+	struct sk_buff *const fpdu = decap->fpdu;
+	struct sk_buff *skb;
+
+	if (sdu->buffer >= fpdu->data && sdu->buffer + sdu->size <= skb_tail_pointer(fpdu)) {
+		/* SDU of a COMPLETE PPDU, shared with the FPDU */
+		skb = skb_clone(fpdu, GFP_ATOMIC);
+		if (skb != NULL) {
+			skb_pull(skb, sdu->buffer - fpdu->data);
+			skb_trim(skb, sdu->size);
+		}
+	} else {
+		/* SDU reassembled in the storage of the receiver, only valid during the callback */
+		skb = netdev_alloc_skb_ip_align(decap->dev, sdu->size);
+		if (skb != NULL) {
+			skb_put_data(skb, sdu->buffer, sdu->size);
+		}
+	}
+
+	if (skb == NULL) {
+		RLE_WARN("no skb for the %zu-byte SDU, SDU dropped", sdu->size);
+		decap->dropped_nr++;
+		return;
+	}
+
+	skb->dev = decap->dev;
+	skb->protocol = htons(sdu->protocol_type);
+	skb_reset_mac_header(skb);
+	skb_reset_network_header(skb);
+
+	__skb_queue_tail(decap->sdus, skb);
+}
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+enum rle_encap_status rle_encapsulate_skb(struct rle_transmitter *const transmitter,
+                                          struct sk_buff *const skb,
+                                          const uint16_t protocol_type,
+                                          const uint8_t frag_id)
+{
+	struct rle_sdu_segment segments[RLE_SKB_MAX_SEGMENTS];
+	size_t segments_nr = 0;
+	int i;
+
+	if (skb == NULL) {
+		return RLE_ENCAP_ERR;
+	}
+
+	/* the fragment lists and the unmapped pages are rare enough to pay for a copy */
+	if ((skb_has_frag_list(skb) || !skb_frags_are_mapped(skb)) && __skb_linearize(skb) != 0) {
+		RLE_ERR("%u-byte SDU not linearized", skb->len);
+		return RLE_ENCAP_ERR;
+	}
+
+	if (skb_is_encapsulable_in_place(skb)) {
+		const struct rle_sdu sdu = {
+			.buffer = skb->data,
+			.size = skb->len,
+			.protocol_type = protocol_type,
+		};
+
+		return rle_encapsulate_zero_copy(transmitter, &sdu, skb_headroom(skb), skb_tailroom(skb),
+		                                 frag_id);
+	}
+
+	segments[segments_nr].buffer = skb->data;
+	segments[segments_nr].size = skb_headlen(skb);
+	segments_nr++;
+	for (i = 0; i < skb_shinfo(skb)->nr_frags; i++) {
+		const skb_frag_t *const frag = &skb_shinfo(skb)->frags[i];
+
+		segments[segments_nr].buffer = skb_frag_address(frag);
+		segments[segments_nr].size = skb_frag_size(frag);
+		segments_nr++;
+	}
+
+	return rle_encapsulate_segments(transmitter, segments, segments_nr, protocol_type, frag_id);
+}
+
+enum rle_pack_status rle_fragment_pack_skb(struct rle_transmitter *const transmitter,
+                                           const uint8_t frag_id,
+                                           const struct sk_buff *const sdu,
+                                           const unsigned char *const label,
+                                           const size_t label_size,
+                                           struct sk_buff *const fpdu,
+                                           const size_t fpdu_size)
+{
+	enum rle_pack_status status;
+	enum rle_frag_status frag_status;
+	const size_t ppdu_base_hdr_len = 2;
+	unsigned char *ppdu;
+	unsigned char *dst;
+	size_t ppdu_length;
+	size_t label_len_in_fpdu;
+	size_t room;
+
+	if ((label_size != 0 && label_size != 3 && label_size != 6) ||
+	    (label_size > 0 && label == NULL)) {
+		status = RLE_PACK_ERR_INVALID_LAB;
+		goto exit_label;
+	}
+	if (sdu == NULL || fpdu == NULL || fpdu->len > fpdu_size) {
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+	if (fpdu->len == 0 && (skb_is_nonlinear(fpdu) || skb_tailroom(fpdu) < (int)fpdu_size)) {
+		RLE_ERR("FPDU with %d octets of tailroom, %zu required", skb_tailroom(fpdu), fpdu_size);
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	/* the FPDU label is only written before the first PPDU of the FPDU */
+	label_len_in_fpdu = (fpdu->len == 0 ? label_size : 0);
+
+	if ((fpdu_size - fpdu->len) <= label_len_in_fpdu) {
+		status = RLE_PACK_ERR_FPDU_TOO_SMALL;
+		goto exit_label;
+	}
+
+	/* a single PPDU cannot be larger than its length field allows */
+	room = fpdu_size - fpdu->len - label_len_in_fpdu;
+	if (room > (RLE_MAX_PPDU_PL_SIZE + ppdu_base_hdr_len)) {
+		room = RLE_MAX_PPDU_PL_SIZE + ppdu_base_hdr_len;
+	}
+
+	frag_status = rle_fragment(transmitter, frag_id, room, &ppdu, &ppdu_length);
+	switch (frag_status) {
+	case RLE_FRAG_OK:
+		break;
+	case RLE_FRAG_ERR_BURST_TOO_SMALL:
+		status = RLE_PACK_ERR_FPDU_TOO_SMALL;
+		goto exit_label;
+	case RLE_FRAG_ERR_CONTEXT_IS_NULL:
+		status = RLE_PACK_ERR_INVALID_PPDU;
+		goto exit_label;
+	default:
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	if (label_len_in_fpdu > 0) {
+		skb_put_data(fpdu, label, label_len_in_fpdu);
+	}
+
+	/* nothing is written over the last PPDU of an ALPDU encapsulated in place anymore, it is
+	 * shared with the SDU skb rather than copied */
+	if (ppdu_is_last(ppdu) && !skb_is_nonlinear(sdu) && ppdu >= sdu->head &&
+	    ppdu + ppdu_length <= skb_end_pointer(sdu)) {
+		if (fpdu_chain_ppdu(fpdu, sdu, ppdu, ppdu_length) != 0) {
+			RLE_ERR("%zu-byte PPDU not chained to the FPDU, SDU dropped", ppdu_length);
+			status = RLE_PACK_ERR;
+			goto exit_label;
+		}
+	} else {
+		dst = fpdu_put(fpdu, ppdu_length, fpdu_size);
+		if (dst == NULL) {
+			RLE_ERR("%zu-byte PPDU not copied in the FPDU, SDU dropped", ppdu_length);
+			status = RLE_PACK_ERR;
+			goto exit_label;
+		}
+		memcpy(dst, ppdu, ppdu_length);
+	}
+
+	status = RLE_PACK_OK;
+
+exit_label:
+	return status;
+}
+
+int rle_pad_skb(struct sk_buff *const fpdu, const size_t fpdu_size)
+{
+	unsigned char *padding;
+	size_t padding_length;
+
+	if (fpdu == NULL || fpdu->len > fpdu_size) {
+		return 1;
+	}
+
+	padding_length = fpdu_size - fpdu->len;
+	if (padding_length == 0) {
+		return 0;
+	}
+
+	padding = fpdu_put(fpdu, padding_length, fpdu_size);
+	if (padding == NULL) {
+		return 1;
+	}
+	memset(padding, 0, padding_length);
+
+	return 0;
+}
+
+enum rle_decap_status rle_decapsulate_skb(struct rle_receiver *const receiver,
+                                          struct sk_buff *const fpdu,
+                                          struct net_device *const dev,
+                                          struct sk_buff_head *const sdus,
+                                          unsigned char *const payload_label,
+                                          const size_t payload_label_size)
+{
+	struct skb_decap_arg decap = {
+		.fpdu = fpdu, .dev = dev, .sdus = sdus, .dropped_nr = 0,
+	};
+	const struct rle_decap_callbacks callbacks = {
+		.alloc = NULL, .deliver = skb_deliver_sdu, .arg = &decap,
+	};
+	enum rle_decap_status status;
+	size_t sdus_nr;
+
+	if (fpdu == NULL || sdus == NULL) {
+		return RLE_DECAP_ERR_INV_FPDU;
+	}
+
+	/* the VLAN protocol types are rebuilt inside the FPDU */
+	if (skb_linearize(fpdu) != 0 || skb_unclone(fpdu, GFP_ATOMIC) != 0) {
+		RLE_ERR("%u-byte FPDU not linearized", fpdu->len);
+		return RLE_DECAP_ERR;
+	}
+
+	status = rle_decapsulate_cb(receiver, fpdu->data, fpdu->len, &callbacks, &sdus_nr,
+	                            payload_label, payload_label_size);
+	if (status == RLE_DECAP_OK && decap.dropped_nr > 0) {
+		status = RLE_DECAP_ERR_SOME_DROP;
+	}
+
+	return status;
+}
+
+enum rle_decap_status rle_receiver_set_decapsulate_skb(struct rle_receiver_set *const set,
+                                                       struct sk_buff *const fpdu,
+                                                       struct net_device *const dev,
+                                                       struct sk_buff_head *const sdus,
+                                                       unsigned char *const payload_label)
+{
+	struct rle_receiver *receiver;
+
+	if (set == NULL) {
+		return RLE_DECAP_ERR_NULL_RCVR;
+	}
+
+	if (fpdu == NULL || sdus == NULL) {
+		return RLE_DECAP_ERR_INV_FPDU;
+	}
+
+	if (payload_label == NULL) {
+		return RLE_DECAP_ERR_INV_PL;
+	}
+
+	/* the payload label is read in the linear part, rle_decapsulate_skb() keeps it as is */
+	if (skb_linearize(fpdu) != 0 || skb_unclone(fpdu, GFP_ATOMIC) != 0) {
+		RLE_ERR("%u-byte FPDU not linearized", fpdu->len);
+		return RLE_DECAP_ERR;
+	}
+
+	if (fpdu->len < set->payload_label_size) {
+		return RLE_DECAP_ERR_INV_FPDU;
+	}
+
+	receiver = rle_receiver_set_get_receiver_of_fpdu(set, fpdu->data, fpdu->len);
+	if (receiver == NULL) {
+		return RLE_DECAP_ERR;
+	}
+
+	return rle_decapsulate_skb(receiver, fpdu, dev, sdus, payload_label, set->payload_label_size);
+}
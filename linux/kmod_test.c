@@ -31,6 +31,13 @@
 #include <linux/uaccess.h>
 #include <linux/proc_fs.h>
 #include <linux/string.h>
+#include <linux/skbuff.h>
+#include <linux/if_ether.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+#include <linux/smp.h>
+#include <linux/bottom_half.h>
+#include <linux/slab.h>
 
 #include "rle.h"
 
@@ -65,6 +72,15 @@ static int param_use_alpdu_crc = 0;             /** Seq No per default.      */
 static int param_use_ptype_omission = 1;        /** Ommission per default.   */
 static int param_use_compressed_ptype = 1;      /** Compression per default. */
 
+/** Module parameters - sk_buff benchmark, run at load time if some SDUs are given. */
+static int param_skb_bench_sdus = 0;         /** No benchmark per default.  */
+static int param_skb_bench_sdu_size = 1000;  /** 1000-byte SDUs per default. */
+
+/** Module parameters - NAPI-style poll benchmark, run at load time on each online CPU. */
+static int param_poll_bench_fpdus = 0;        /** No benchmark per default.   */
+static int param_poll_bench_sdu_size = 100;   /** 100-byte SDUs per default.  */
+static int param_poll_bench_budget = 64;      /** NAPI_POLL_WEIGHT per default. */
+
 /** A couple of RLE transmitter/receiver and the related buffers */
 struct rle_couple {
 	/** The RLE transmitter created by the module */
@@ -119,6 +135,27 @@ static uint8_t frag_id = 0;
 static int couple_initialized = 0;
 
 
+/**
+ * @brief Build the RLE configuration from the module parameters
+ *
+ * @param conf  The RLE configuration to build
+ */
+static void rle_conf_from_params(struct rle_config *conf)
+{
+	memset(conf, '\0', sizeof(struct rle_config));
+
+	conf->allow_ptype_omission = param_use_ptype_omission > 0 ? 1 : 0;
+	conf->use_compressed_ptype = param_use_compressed_ptype > 0 ? 1 : 0;
+	conf->allow_alpdu_crc = param_use_alpdu_crc > 0 ? 1 : 0;
+	conf->allow_alpdu_sequence_number = param_use_alpdu_crc > 0 ? 0 : 1;
+	conf->use_explicit_payload_header_map = 0;
+	conf->implicit_protocol_type = (uint8_t)param_implicit_protocol_type;
+	conf->implicit_ppdu_label_size = 0;
+	conf->implicit_payload_label_size = 0;
+	conf->type_0_alpdu_label_size = 0;
+}
+
+
 /**
  * @brief Init a RLE couple
  *
@@ -131,15 +168,7 @@ int rle_couple_init(struct rle_couple *couple)
 
 	memset(couple, '\0', sizeof(struct rle_couple));
 
-	couple->conf.allow_ptype_omission = param_use_ptype_omission > 0 ? 1 : 0;
-	couple->conf.use_compressed_ptype = param_use_compressed_ptype > 0 ? 1 : 0;
-	couple->conf.allow_alpdu_crc = param_use_alpdu_crc > 0 ? 1 : 0;
-	couple->conf.allow_alpdu_sequence_number = param_use_alpdu_crc > 0 ? 0 : 1;
-	couple->conf.use_explicit_payload_header_map = 0;
-	couple->conf.implicit_protocol_type = (uint8_t)param_implicit_protocol_type;
-	couple->conf.implicit_ppdu_label_size = 0;
-	couple->conf.implicit_payload_label_size = 0;
-	couple->conf.type_0_alpdu_label_size = 0;
+	rle_conf_from_params(&couple->conf);
 
 	/* create the transmitter */
 	couple->transmitter = rle_transmitter_new(&couple->conf);
@@ -507,6 +536,396 @@ void rle_proc_release(void)
 }
 
 
+/**
+ * @brief Pad and decapsulate a FPDU of the sk_buff benchmark
+ *
+ * @param receiver  The RLE receiver
+ * @param fpdu_skb  The FPDU, freed by the function
+ * @param sdu_size  The size of the SDUs
+ * @return          The number of SDUs received, -1 in case of error
+ */
+static int rle_skb_bench_receive(struct rle_receiver *receiver, struct sk_buff *fpdu_skb,
+                                 const size_t sdu_size)
+{
+	struct sk_buff_head sdus;
+	struct sk_buff *sdu_skb;
+	int sdus_nr = -1;
+
+	__skb_queue_head_init(&sdus);
+
+	if (rle_pad_skb(fpdu_skb, MAX_FPDU_SIZE) != 0) {
+		pr_err("[%s] \t failed to pad FPDU\n", THIS_MODULE->name);
+		goto free_fpdu;
+	}
+
+	if (rle_decapsulate_skb(receiver, fpdu_skb, NULL, &sdus, NULL, 0) != RLE_DECAP_OK) {
+		pr_err("[%s] \t failed to decapsulate FPDU\n", THIS_MODULE->name);
+		goto free_sdus;
+	}
+
+	sdus_nr = 0;
+	while ((sdu_skb = __skb_dequeue(&sdus)) != NULL) {
+		if (sdu_skb->len == sdu_size) {
+			sdus_nr++;
+		}
+		kfree_skb(sdu_skb);
+	}
+
+free_sdus:
+	__skb_queue_purge(&sdus);
+free_fpdu:
+	kfree_skb(fpdu_skb);
+	return sdus_nr;
+}
+
+
+/**
+ * @brief Run the sk_buff benchmark
+ *
+ * SDUs are encapsulated in skbs, fragmented and packed in FPDU skbs, then decapsulated in SDU
+ * skbs, as an RLE network device would do on a loopback link.
+ *
+ * @return  0 in case of success, non-zero otherwise
+ */
+static int rle_skb_bench(void)
+{
+	const size_t sdus_nr = (size_t)param_skb_bench_sdus;
+	const size_t sdu_size = (size_t)param_skb_bench_sdu_size;
+	struct rle_transmitter *transmitter;
+	struct rle_receiver *receiver;
+	struct rle_config conf;
+	struct sk_buff *fpdu_skb = NULL;
+	size_t received_nr = 0;
+	u64 duration;
+	u64 start;
+	size_t i;
+	int ret = 1;
+
+	if (sdu_size == 0 || sdu_size > MAX_SDU_LENGTH) {
+		pr_err("[%s] \t invalid %zu-byte SDUs for the sk_buff benchmark\n",
+		       THIS_MODULE->name, sdu_size);
+		goto error;
+	}
+
+	rle_conf_from_params(&conf);
+
+	transmitter = rle_transmitter_new(&conf);
+	if (transmitter == NULL) {
+		pr_err("[%s] \t Error: RLE transmitter not created\n", THIS_MODULE->name);
+		goto error;
+	}
+	receiver = rle_receiver_new(&conf);
+	if (receiver == NULL) {
+		pr_err("[%s] \t Error: RLE receiver not created\n", THIS_MODULE->name);
+		goto free_transmitter;
+	}
+
+	start = ktime_get_ns();
+
+	for (i = 0; i < sdus_nr; i++) {
+		struct sk_buff *sdu_skb;
+		unsigned char *sdu;
+
+		/* an IPv4 SDU with room for the ALPDU and PPDU headers and the ALPDU trailer */
+		sdu_skb = alloc_skb(RLE_ENCAP_HEADROOM + sdu_size + RLE_ENCAP_TAILROOM, GFP_KERNEL);
+		if (sdu_skb == NULL) {
+			pr_err("[%s] \t failed to allocate SDU #%zu\n", THIS_MODULE->name, i + 1);
+			goto free_fpdu;
+		}
+		skb_reserve(sdu_skb, RLE_ENCAP_HEADROOM);
+		sdu = skb_put(sdu_skb, sdu_size);
+		memset(sdu, (int)(i & 0xff), sdu_size);
+		sdu[0] = 0x45;
+
+		if (rle_encapsulate_skb(transmitter, sdu_skb, ETH_P_IP, frag_id) != RLE_ENCAP_OK) {
+			pr_err("[%s] \t failed to encapsulate SDU #%zu\n", THIS_MODULE->name, i + 1);
+			kfree_skb(sdu_skb);
+			goto free_fpdu;
+		}
+
+		while (rle_transmitter_stats_get_queue_size(transmitter, frag_id) > 0) {
+			enum rle_pack_status pack_status;
+
+			if (fpdu_skb == NULL) {
+				fpdu_skb = alloc_skb(MAX_FPDU_SIZE, GFP_KERNEL);
+				if (fpdu_skb == NULL) {
+					pr_err("[%s] \t failed to allocate FPDU\n", THIS_MODULE->name);
+					kfree_skb(sdu_skb);
+					goto free_fpdu;
+				}
+			}
+
+			pack_status = rle_fragment_pack_skb(transmitter, frag_id, sdu_skb, NULL, 0,
+			                                    fpdu_skb, MAX_FPDU_SIZE);
+			if (pack_status == RLE_PACK_ERR_FPDU_TOO_SMALL && fpdu_skb->len > 0) {
+				/* the FPDU is full, send it */
+				const int sdus_received = rle_skb_bench_receive(receiver, fpdu_skb, sdu_size);
+
+				fpdu_skb = NULL;
+				if (sdus_received < 0) {
+					kfree_skb(sdu_skb);
+					goto free_fpdu;
+				}
+				received_nr += sdus_received;
+			} else if (pack_status != RLE_PACK_OK) {
+				pr_err("[%s] \t failed to fragment and pack SDU #%zu\n", THIS_MODULE->name,
+				       i + 1);
+				kfree_skb(sdu_skb);
+				goto free_fpdu;
+			}
+		}
+
+		/* the last PPDU of the SDU may still be shared with the FPDU */
+		consume_skb(sdu_skb);
+	}
+
+	if (fpdu_skb != NULL) {
+		const int sdus_received = rle_skb_bench_receive(receiver, fpdu_skb, sdu_size);
+
+		fpdu_skb = NULL;
+		if (sdus_received < 0) {
+			goto free_fpdu;
+		}
+		received_nr += sdus_received;
+	}
+
+	duration = ktime_get_ns() - start;
+
+	pr_info("[%s] sk_buff benchmark: %zu %zu-byte SDUs sent, %zu received, %llu ns per SDU\n",
+	        THIS_MODULE->name, sdus_nr, sdu_size, received_nr,
+	        sdus_nr > 0 ? div64_u64(duration, sdus_nr) : 0);
+
+	ret = (received_nr == sdus_nr ? 0 : 1);
+
+free_fpdu:
+	if (fpdu_skb != NULL) {
+		kfree_skb(fpdu_skb);
+	}
+	rle_receiver_destroy(&receiver);
+free_transmitter:
+	rle_transmitter_destroy(&transmitter);
+error:
+	return ret;
+}
+
+
+/** The run of the poll benchmark on a CPU */
+struct rle_poll_bench {
+	struct rle_receiver_set_percpu *sets;  /**< The per-CPU receiver sets      */
+	const struct sk_buff_head *fpdus;      /**< The FPDUs, copied for each CPU */
+	size_t sdu_size;                       /**< The size of the SDUs           */
+	size_t sdus_nr;                        /**< The number of SDUs received    */
+	u64 duration;                          /**< The duration of the run, in ns */
+};
+
+
+/**
+ * @brief Build the FPDUs of the poll benchmark, packed with SDUs of a single terminal
+ *
+ * @param fpdus     The queue of the FPDUs, filled with \e fpdus_nr FPDUs
+ * @param fpdus_nr  The number of FPDUs
+ * @param sdu_size  The size of the SDUs
+ * @return          0 in case of success, non-zero otherwise
+ */
+static int rle_poll_bench_build(struct sk_buff_head *fpdus, const size_t fpdus_nr,
+                                const size_t sdu_size)
+{
+	static const unsigned char label[3] = { 0x01, 0x02, 0x03 };
+	struct rle_transmitter *transmitter;
+	struct rle_config conf;
+	struct rle_sdu sdu;
+	unsigned char *sdu_buffer;
+	unsigned char *fpdu_buffer;
+	size_t fpdu_pos = 0;
+	size_t fpdu_remain = MAX_FPDU_SIZE;
+	int ret = 1;
+
+	rle_conf_from_params(&conf);
+
+	sdu_buffer = kmalloc(sdu_size, GFP_KERNEL);
+	fpdu_buffer = kmalloc(MAX_FPDU_SIZE, GFP_KERNEL);
+	transmitter = rle_transmitter_new(&conf);
+	if (sdu_buffer == NULL || fpdu_buffer == NULL || transmitter == NULL) {
+		pr_err("[%s] \t failed to allocate the poll benchmark transmitter\n",
+		       THIS_MODULE->name);
+		goto free;
+	}
+	memset(sdu_buffer, 0x5a, sdu_size);
+	sdu_buffer[0] = 0x45;
+	sdu.buffer = sdu_buffer;
+	sdu.size = sdu_size;
+	sdu.protocol_type = ETH_P_IP;
+
+	while (skb_queue_len(fpdus) < fpdus_nr) {
+		if (rle_encapsulate(transmitter, &sdu, frag_id) != RLE_ENCAP_OK) {
+			pr_err("[%s] \t failed to encapsulate SDU\n", THIS_MODULE->name);
+			goto free;
+		}
+
+		while (rle_transmitter_stats_get_queue_size(transmitter, frag_id) > 0 &&
+		       skb_queue_len(fpdus) < fpdus_nr) {
+			enum rle_pack_status pack_status;
+			struct sk_buff *fpdu_skb;
+			size_t used_size;
+
+			pack_status = rle_fragment_pack(transmitter, frag_id, label, sizeof(label),
+			                                fpdu_buffer, &fpdu_pos, &fpdu_remain, &used_size);
+			if (pack_status == RLE_PACK_OK) {
+				continue;
+			}
+			if (pack_status != RLE_PACK_ERR_FPDU_TOO_SMALL || fpdu_pos == 0) {
+				pr_err("[%s] \t failed to fragment and pack SDU\n", THIS_MODULE->name);
+				goto free;
+			}
+
+			/* the FPDU is full, queue it */
+			rle_pad(fpdu_buffer, fpdu_pos, fpdu_remain);
+			fpdu_skb = alloc_skb(MAX_FPDU_SIZE, GFP_KERNEL);
+			if (fpdu_skb == NULL) {
+				pr_err("[%s] \t failed to allocate FPDU\n", THIS_MODULE->name);
+				goto free;
+			}
+			skb_put_data(fpdu_skb, fpdu_buffer, MAX_FPDU_SIZE);
+			__skb_queue_tail(fpdus, fpdu_skb);
+			fpdu_pos = 0;
+			fpdu_remain = MAX_FPDU_SIZE;
+		}
+	}
+
+	ret = 0;
+
+free:
+	rle_transmitter_destroy(&transmitter);
+	kfree(fpdu_buffer);
+	kfree(sdu_buffer);
+	return ret;
+}
+
+
+/**
+ * @brief Decapsulate a copy of the FPDUs of the poll benchmark on the current CPU
+ *
+ * Called by smp_call_on_cpu(), in process context bound to the CPU. The FPDUs are polled by
+ * budgets with the bottom halves disabled, as a NAPI poll would be, and the SDUs are released as
+ * they are received, in place of their delivery to the stack.
+ *
+ * @param arg  The run of the benchmark, a struct rle_poll_bench
+ * @return     0 in case of success, non-zero otherwise
+ */
+static int rle_poll_bench_run(void *arg)
+{
+	struct rle_poll_bench *const bench = arg;
+	struct sk_buff_head fpdus;
+	struct sk_buff_head sdus;
+	struct sk_buff *skb;
+	u64 start;
+	int work_done;
+
+	__skb_queue_head_init(&fpdus);
+	__skb_queue_head_init(&sdus);
+	bench->sdus_nr = 0;
+
+	/* the copies are not timed */
+	skb_queue_walk(bench->fpdus, skb) {
+		struct sk_buff *const copy = skb_copy(skb, GFP_KERNEL);
+
+		if (copy == NULL) {
+			__skb_queue_purge(&fpdus);
+			return 1;
+		}
+		__skb_queue_tail(&fpdus, copy);
+	}
+
+	start = ktime_get_ns();
+
+	do {
+		local_bh_disable();
+		work_done = rle_decapsulate_poll(bench->sets, &fpdus, NULL, &sdus,
+		                                 param_poll_bench_budget);
+		local_bh_enable();
+
+		while ((skb = __skb_dequeue(&sdus)) != NULL) {
+			if (skb->len == bench->sdu_size) {
+				bench->sdus_nr++;
+			}
+			kfree_skb(skb);
+		}
+	} while (work_done == param_poll_bench_budget);
+
+	bench->duration = ktime_get_ns() - start;
+
+	return 0;
+}
+
+
+/**
+ * @brief Run the NAPI-style poll benchmark
+ *
+ * The same FPDUs are decapsulated on each online CPU, with the receiver set of that CPU, and the
+ * rate of SDUs received by a single core is reported in Mpps.
+ *
+ * @return  0 in case of success, non-zero otherwise
+ */
+static int rle_poll_bench(void)
+{
+	const size_t fpdus_nr = (size_t)param_poll_bench_fpdus;
+	const size_t sdu_size = (size_t)param_poll_bench_sdu_size;
+	struct rle_poll_bench bench;
+	struct sk_buff_head fpdus;
+	struct rle_config conf;
+	int cpu;
+	int ret = 1;
+
+	if (sdu_size == 0 || sdu_size > MAX_SDU_LENGTH || param_poll_bench_budget <= 0) {
+		pr_err("[%s] \t invalid %zu-byte SDUs or budget %d for the poll benchmark\n",
+		       THIS_MODULE->name, sdu_size, param_poll_bench_budget);
+		goto error;
+	}
+
+	__skb_queue_head_init(&fpdus);
+	if (rle_poll_bench_build(&fpdus, fpdus_nr, sdu_size) != 0) {
+		goto purge_fpdus;
+	}
+
+	rle_conf_from_params(&conf);
+	bench.sets = rle_receiver_set_percpu_new(&conf, 3, 1);
+	if (bench.sets == NULL) {
+		pr_err("[%s] \t Error: per-CPU RLE receiver sets not created\n", THIS_MODULE->name);
+		goto purge_fpdus;
+	}
+	bench.fpdus = &fpdus;
+	bench.sdu_size = sdu_size;
+
+	for_each_online_cpu(cpu) {
+		u64 mpps_milli;
+		u64 mpps;
+		u32 mpps_frac;
+
+		if (smp_call_on_cpu(cpu, rle_poll_bench_run, &bench, false) != 0) {
+			pr_err("[%s] \t poll benchmark failed on CPU %d\n", THIS_MODULE->name, cpu);
+			goto destroy_sets;
+		}
+
+		/* thousandths of millions of SDUs per second */
+		mpps_milli = bench.duration > 0 ? div64_u64((u64)bench.sdus_nr * 1000000, bench.duration)
+		                                : 0;
+		mpps = div_u64_rem(mpps_milli, 1000, &mpps_frac);
+		pr_info("[%s] poll benchmark: CPU %d, %zu FPDUs, %zu %zu-byte SDUs received, "
+		        "%llu.%03u Mpps\n", THIS_MODULE->name, cpu, fpdus_nr, bench.sdus_nr,
+		        sdu_size, mpps, mpps_frac);
+	}
+
+	ret = 0;
+
+destroy_sets:
+	rle_receiver_set_percpu_destroy(&bench.sets);
+purge_fpdus:
+	__skb_queue_purge(&fpdus);
+error:
+	return ret;
+}
+
+
 /**
  * @brief The entry point of the kernel module
  *
@@ -540,8 +959,21 @@ int __init rle_test_init(void)
 
 	memset((void *)fpdu, '\0', MAX_FPDU_SIZE);
 
+	if (param_skb_bench_sdus > 0 && rle_skb_bench() != 0) {
+		pr_err("[%s] sk_buff benchmark failed\n", THIS_MODULE->name);
+		goto release_proc;
+	}
+
+	if (param_poll_bench_fpdus > 0 && rle_poll_bench() != 0) {
+		pr_err("[%s] poll benchmark failed\n", THIS_MODULE->name);
+		goto release_proc;
+	}
+
 	return 0;
 
+release_proc:
+	rle_proc_release();
+
 error:
 	return 1;
 }
@@ -563,6 +995,11 @@ module_param(param_implicit_protocol_type, int, 0);
 module_param(param_use_alpdu_crc, int, 0);
 module_param(param_use_ptype_omission, int, 0);
 module_param(param_use_compressed_ptype, int, 0);
+module_param(param_skb_bench_sdus, int, 0);
+module_param(param_skb_bench_sdu_size, int, 0);
+module_param(param_poll_bench_fpdus, int, 0);
+module_param(param_poll_bench_sdu_size, int, 0);
+module_param(param_poll_bench_budget, int, 0);
 
 MODULE_VERSION(PACKAGE_VERSION);
 MODULE_LICENSE("Copyright (C) 2015, Thales Alenia Space France - All Rights Reserved");
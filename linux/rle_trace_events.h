@@ -0,0 +1,167 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_trace_events.h
+ * @brief  Kernel tracepoints of the fragmentation and reassembly events, see rle_trace.h
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * The tracepoints are created in kmod.c, for example:
+ *   echo 1 > /sys/kernel/tracing/events/librle/enable
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM librle
+
+#if !defined(__RLE_TRACE_EVENTS_H__) || defined(TRACE_HEADER_MULTI_READ)
+#define __RLE_TRACE_EVENTS_H__
+
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(librle_sdu_enqueued,
+	TP_PROTO(u8 frag_id, size_t sdu_len, u16 protocol_type),
+	TP_ARGS(frag_id, sdu_len, protocol_type),
+	TP_STRUCT__entry(
+		__field(u8, frag_id)
+		__field(size_t, sdu_len)
+		__field(u16, protocol_type)
+	),
+	TP_fast_assign(
+		__entry->frag_id = frag_id;
+		__entry->sdu_len = sdu_len;
+		__entry->protocol_type = protocol_type;
+	),
+	TP_printk("frag_id=%u sdu_len=%zu protocol_type=0x%04x", __entry->frag_id,
+	          __entry->sdu_len, __entry->protocol_type)
+);
+
+TRACE_EVENT(librle_ppdu_emitted,
+	TP_PROTO(u8 frag_id, size_t ppdu_len, size_t alpdu_remaining_len),
+	TP_ARGS(frag_id, ppdu_len, alpdu_remaining_len),
+	TP_STRUCT__entry(
+		__field(u8, frag_id)
+		__field(size_t, ppdu_len)
+		__field(size_t, alpdu_remaining_len)
+	),
+	TP_fast_assign(
+		__entry->frag_id = frag_id;
+		__entry->ppdu_len = ppdu_len;
+		__entry->alpdu_remaining_len = alpdu_remaining_len;
+	),
+	TP_printk("frag_id=%u ppdu_len=%zu alpdu_remaining_len=%zu", __entry->frag_id,
+	          __entry->ppdu_len, __entry->alpdu_remaining_len)
+);
+
+DECLARE_EVENT_CLASS(librle_ppdu_received,
+	TP_PROTO(u8 frag_id, size_t ppdu_len, size_t sdu_len),
+	TP_ARGS(frag_id, ppdu_len, sdu_len),
+	TP_STRUCT__entry(
+		__field(u8, frag_id)
+		__field(size_t, ppdu_len)
+		__field(size_t, sdu_len)
+	),
+	TP_fast_assign(
+		__entry->frag_id = frag_id;
+		__entry->ppdu_len = ppdu_len;
+		__entry->sdu_len = sdu_len;
+	),
+	TP_printk("frag_id=%u ppdu_len=%zu sdu_len=%zu", __entry->frag_id, __entry->ppdu_len,
+	          __entry->sdu_len)
+);
+
+/* the SDU length is the total one announced by the START PPDU */
+DEFINE_EVENT(librle_ppdu_received, librle_start_received,
+	TP_PROTO(u8 frag_id, size_t ppdu_len, size_t sdu_len),
+	TP_ARGS(frag_id, ppdu_len, sdu_len)
+);
+
+/* the SDU length is the one reassembled so far */
+DEFINE_EVENT(librle_ppdu_received, librle_cont_received,
+	TP_PROTO(u8 frag_id, size_t ppdu_len, size_t sdu_len),
+	TP_ARGS(frag_id, ppdu_len, sdu_len)
+);
+
+/* the SDU length is the one reassembled so far */
+DEFINE_EVENT(librle_ppdu_received, librle_end_received,
+	TP_PROTO(u8 frag_id, size_t ppdu_len, size_t sdu_len),
+	TP_ARGS(frag_id, ppdu_len, sdu_len)
+);
+
+TRACE_EVENT(librle_ctx_freed,
+	TP_PROTO(u8 frag_id),
+	TP_ARGS(frag_id),
+	TP_STRUCT__entry(
+		__field(u8, frag_id)
+	),
+	TP_fast_assign(
+		__entry->frag_id = frag_id;
+	),
+	TP_printk("frag_id=%u", __entry->frag_id)
+);
+
+TRACE_EVENT(librle_crc_mismatch,
+	TP_PROTO(u8 frag_id, size_t sdu_len, u32 crc_received, u32 crc_expected),
+	TP_ARGS(frag_id, sdu_len, crc_received, crc_expected),
+	TP_STRUCT__entry(
+		__field(u8, frag_id)
+		__field(size_t, sdu_len)
+		__field(u32, crc_received)
+		__field(u32, crc_expected)
+	),
+	TP_fast_assign(
+		__entry->frag_id = frag_id;
+		__entry->sdu_len = sdu_len;
+		__entry->crc_received = crc_received;
+		__entry->crc_expected = crc_expected;
+	),
+	TP_printk("frag_id=%u sdu_len=%zu crc_received=0x%08x crc_expected=0x%08x",
+	          __entry->frag_id, __entry->sdu_len, __entry->crc_received, __entry->crc_expected)
+);
+
+TRACE_EVENT(librle_seqnum_loss,
+	TP_PROTO(u8 frag_id, u8 seq_nb_received, u8 seq_nb_expected, size_t lost_nr),
+	TP_ARGS(frag_id, seq_nb_received, seq_nb_expected, lost_nr),
+	TP_STRUCT__entry(
+		__field(u8, frag_id)
+		__field(u8, seq_nb_received)
+		__field(u8, seq_nb_expected)
+		__field(size_t, lost_nr)
+	),
+	TP_fast_assign(
+		__entry->frag_id = frag_id;
+		__entry->seq_nb_received = seq_nb_received;
+		__entry->seq_nb_expected = seq_nb_expected;
+		__entry->lost_nr = lost_nr;
+	),
+	TP_printk("frag_id=%u seq_nb_received=%u seq_nb_expected=%u lost_nr=%zu",
+	          __entry->frag_id, __entry->seq_nb_received, __entry->seq_nb_expected,
+	          __entry->lost_nr)
+);
+
+#endif /* __RLE_TRACE_EVENTS_H__ */
+
+/* out of the kernel tree, the header is found in the include path of the module */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE rle_trace_events
+#include <trace/define_trace.h>
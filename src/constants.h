@@ -52,6 +52,8 @@
 
 #endif
 
+#include "rle.h"
+
 #ifndef _REENTRANT
 #define _REENTRANT
 #endif
@@ -73,17 +75,68 @@ enum {
 	RLE_PDU_END_FRAG,   /** END packet/fragment of PDU */
 };
 
+/** The most verbose log level traced, see rle_set_log_level(). Defined in rle_log.c. */
+extern int rle_log_level_max;
+
+/* the log level is checked inline, so that the arguments of filtered logs are not evaluated */
 #define RLE_LOG(level, x, ...) \
 	do { \
-		rle_trace_callback_t the_cb = rle_get_trace_callback(); \
-		if (the_cb != NULL) { \
-			the_cb(MODULE_ID, level, __FILE__, __LINE__, __func__, x, ## __VA_ARGS__); \
+		if ((int)(level) <= rle_log_level_max) { \
+			rle_trace_callback_t the_cb = rle_get_trace_callback(); \
+			if (the_cb != NULL) { \
+				the_cb(MODULE_ID, level, __FILE__, __LINE__, __func__, x, ## __VA_ARGS__); \
+			} \
 		} \
 	} while (0)
+
+/* the log sink of an instance, if any, is loaded once from the instance, else RLE_LOG() */
+#define RLE_LOG_TO(log_sink, log_level, x, ...) \
+	do { \
+		const struct rle_log_sink *const the_sink = \
+			__atomic_load_n((log_sink), __ATOMIC_ACQUIRE); \
+		if (the_sink == NULL) { \
+			RLE_LOG(log_level, x, ## __VA_ARGS__); \
+		} else if ((int)(log_level) <= (int)the_sink->level) { \
+			the_sink->callback(the_sink->context, MODULE_ID, log_level, __FILE__, \
+			                   __LINE__, __func__, x, ## __VA_ARGS__); \
+		} \
+	} while (0)
+
+#ifdef RLE_LOG_NO_DEBUG
+/* debug logs are compiled out, arguments are still type-checked but never evaluated */
+#define RLE_DEBUG(x, ...) \
+	do { \
+		if (0) { \
+			rle_trace_callback_t the_cb = NULL; \
+			the_cb(MODULE_ID, RLE_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __func__, x, \
+			       ## __VA_ARGS__); \
+		} \
+	} while (0)
+#define RLE_DEBUG_TO(log_sink, x, ...) \
+	do { \
+		if (0) { \
+			(void)(log_sink); \
+			RLE_DEBUG(x, ## __VA_ARGS__); \
+		} \
+	} while (0)
+#else
 #define RLE_DEBUG(x, ...) RLE_LOG(RLE_LOG_LEVEL_DEBUG, x, ## __VA_ARGS__)
+#define RLE_DEBUG_TO(log_sink, x, ...) RLE_LOG_TO(log_sink, RLE_LOG_LEVEL_DEBUG, x, ## __VA_ARGS__)
+#endif
 #define RLE_WARN(x, ...) RLE_LOG(RLE_LOG_LEVEL_WARNING, x, ## __VA_ARGS__)
 #define RLE_ERR(x, ...) RLE_LOG(RLE_LOG_LEVEL_ERROR, x, ## __VA_ARGS__)
 
+/* the logs of a transmitter or a receiver, given the address of its log sink */
+#define RLE_WARN_TO(log_sink, x, ...) \
+	RLE_LOG_TO(log_sink, RLE_LOG_LEVEL_WARNING, x, ## __VA_ARGS__)
+#define RLE_ERR_TO(log_sink, x, ...) \
+	RLE_LOG_TO(log_sink, RLE_LOG_LEVEL_ERROR, x, ## __VA_ARGS__)
+
+/** Size of a cache line, for the isolation of data shared between threads */
+#define RLE_CACHE_LINE_SIZE  64
+
+/* MALLOC and FREE back the allocator of the system only, the modules allocate their memory with
+ * their allocator, see rle_allocator.h */
 #ifndef __KERNEL__
 
 #define MALLOC(size_bytes)      malloc(size_bytes)
@@ -94,6 +147,8 @@ enum {
 /* vmalloc allocates size with 4K modulo so for 8*2565 = 20520B it would alloc 24K
  * kmalloc allocates size with power of two so for 20520B it would alloc 32K */
 #define MALLOC(size_bytes)      kmalloc(size_bytes, GFP_KERNEL) /* vmalloc(size_bytes); */
+/* the data path may run in softirq context, where sleeping is forbidden */
+#define MALLOC_ATOMIC(size_bytes) kmalloc(size_bytes, GFP_ATOMIC)
 #define FREE(buf_addr)          kfree(buf_addr) /* vfree(buf_addr); */
 
 #define assert BUG_ON
@@ -80,12 +80,27 @@
  */
 
 #include "crc.h"
+#include "rle.h"
+
+#if !defined(__KERNEL__) && defined(__x86_64__) && defined(__GNUC__)
+#define CRC_HAVE_PCLMUL
+#include <immintrin.h>
+#endif
 
 
 /*------------------------------------------------------------------------------------------------*/
 /*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
 
+/** CRC-32 polynomial, MSB-first, implicit x^32 term */
+#define CRC_POLY 0x04c11db7
+
+/** Number of tables used by the slice-by-8 kernel */
+#define CRC_SLICES 8
+
+/** Minimal length, in octets, for which the carry-less multiply kernel is used */
+#define CRC_PCLMUL_MIN_LEN 64
+
 /** CRC-32 table */
 static const uint32_t crctab[] =
 {
@@ -143,6 +158,254 @@ static const uint32_t crctab[] =
 	0xa2f33668, 0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4
 };
 
+/** Slice-by-8 tables, crc_slice_tab[n][b] is the CRC of octet b followed by n null octets */
+static uint32_t crc_slice_tab[CRC_SLICES][256];
+
+/** Folding constants x^576, x^512, x^192 and x^128 mod P, used by the carry-less kernel */
+static uint32_t crc_fold_k[4];
+
+/** Selected kernel, -1 until the engine is initialized */
+static int crc_impl = -1;
+
+/** Whether a thread started the initialization of the engine, set once */
+static int crc_init_started = 0;
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PRIVATE FUNCTIONS CODES -----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ *  @brief   Compute x^n mod P
+ *
+ *  @param   n  The power of x
+ *
+ *  @return  The remainder of x^n by the CRC-32 polynomial
+ */
+static uint32_t crc_xpow_mod(const unsigned int n)
+{
+	uint32_t rem = 1;
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		rem = (rem << 1) ^ ((rem & 0x80000000) ? CRC_POLY : 0);
+	}
+
+	return rem;
+}
+
+/**
+ *  @brief   Compute CRC32 with the slice-by-8 tables, copying the data on the way if asked
+ *
+ *  @param   dst       The copy destination, NULL if no copy is required
+ *  @param   data      The data
+ *  @param   length    Length of the data
+ *  @param   crc_init  Initial CRC value
+ *
+ *  @return          The CRC32
+ */
+static uint32_t crc_slice_by_8(unsigned char *dst, const unsigned char *data, size_t length,
+                               const uint32_t crc_init)
+{
+	uint32_t crc = crc_init;
+
+	while (length >= CRC_SLICES) {
+		crc = crc_slice_tab[7][(crc >> 24) ^ data[0]] ^
+		      crc_slice_tab[6][((crc >> 16) & 0xff) ^ data[1]] ^
+		      crc_slice_tab[5][((crc >> 8) & 0xff) ^ data[2]] ^
+		      crc_slice_tab[4][(crc & 0xff) ^ data[3]] ^
+		      crc_slice_tab[3][data[4]] ^
+		      crc_slice_tab[2][data[5]] ^
+		      crc_slice_tab[1][data[6]] ^
+		      crc_slice_tab[0][data[7]];
+		if (dst) {
+			memcpy(dst, data, CRC_SLICES);
+			dst += CRC_SLICES;
+		}
+		data += CRC_SLICES;
+		length -= CRC_SLICES;
+	}
+
+	if (dst && length > 0) {
+		memcpy(dst, data, length);
+	}
+
+	while (length > 0) {
+		crc = crc << 8 ^ crctab[crc >> 24 ^ *data];
+		data++;
+		length--;
+	}
+
+	return crc;
+}
+
+#ifdef CRC_HAVE_PCLMUL
+
+/**
+ *  @brief   Fold a 128-bit remainder over the next 128 bits of data
+ *
+ *  @param   acc   The current remainder, as a polynomial of degree < 128
+ *  @param   k     The folding constants, x^(n + 64) mod P in high lane, x^n mod P in low lane
+ *  @param   next  The next data, already put in polynomial order
+ *
+ *  @return  acc * x^n + next, congruent modulo P
+ */
+__attribute__((target("pclmul,ssse3")))
+static __m128i crc_pclmul_fold(const __m128i acc, const __m128i k, const __m128i next)
+{
+	const __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+	const __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+
+	return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+/**
+ *  @brief   Compute CRC32 with the PCLMULQDQ instruction
+ *
+ *           Data is folded 64 octets at a time on four independent remainders, then down to a
+ *           single 128-bit remainder which has the same CRC as the data folded so far. This
+ *           remainder and the tail are then given to the slice-by-8 kernel. When a copy is
+ *           required, each block is stored to the destination as soon as it is loaded.
+ *
+ *  @param   dst       The copy destination, NULL if no copy is required
+ *  @param   data      The data, at least CRC_PCLMUL_MIN_LEN octets
+ *  @param   length    Length of the data
+ *  @param   crc_init  Initial CRC value
+ *
+ *  @return          The CRC32
+ */
+__attribute__((target("pclmul,ssse3")))
+static uint32_t crc_pclmul(unsigned char *dst, const unsigned char *data, size_t length,
+                           const uint32_t crc_init)
+{
+	const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	const __m128i k512 = _mm_set_epi64x(crc_fold_k[0], crc_fold_k[1]);
+	const __m128i k128 = _mm_set_epi64x(crc_fold_k[2], crc_fold_k[3]);
+	unsigned char rem[16];
+	__m128i x0;
+	__m128i x1;
+	__m128i x2;
+	__m128i x3;
+	__m128i y0;
+	__m128i y1;
+	__m128i y2;
+	__m128i y3;
+
+#define CRC_LOAD(var, offset) \
+	do { \
+		const __m128i raw = _mm_loadu_si128((const __m128i *)(data + (offset))); \
+		if (dst) { \
+			_mm_storeu_si128((__m128i *)(dst + (offset)), raw); \
+		} \
+		(var) = _mm_shuffle_epi8(raw, bswap); \
+	} while (0)
+	CRC_LOAD(x0, 0);
+	CRC_LOAD(x1, 16);
+	CRC_LOAD(x2, 32);
+	CRC_LOAD(x3, 48);
+	/* Initial CRC value is equivalent to XOR-ing it in the first 4 octets */
+	x0 = _mm_xor_si128(x0, _mm_set_epi32((int)crc_init, 0, 0, 0));
+	data += 64;
+	dst = dst ? dst + 64 : NULL;
+	length -= 64;
+
+	while (length >= 64) {
+		CRC_LOAD(y0, 0);
+		CRC_LOAD(y1, 16);
+		CRC_LOAD(y2, 32);
+		CRC_LOAD(y3, 48);
+		x0 = crc_pclmul_fold(x0, k512, y0);
+		x1 = crc_pclmul_fold(x1, k512, y1);
+		x2 = crc_pclmul_fold(x2, k512, y2);
+		x3 = crc_pclmul_fold(x3, k512, y3);
+		data += 64;
+		dst = dst ? dst + 64 : NULL;
+		length -= 64;
+	}
+
+	x0 = crc_pclmul_fold(x0, k128, x1);
+	x0 = crc_pclmul_fold(x0, k128, x2);
+	x0 = crc_pclmul_fold(x0, k128, x3);
+
+	while (length >= 16) {
+		CRC_LOAD(y0, 0);
+		x0 = crc_pclmul_fold(x0, k128, y0);
+		data += 16;
+		dst = dst ? dst + 16 : NULL;
+		length -= 16;
+	}
+#undef CRC_LOAD
+
+	_mm_storeu_si128((__m128i *)rem, _mm_shuffle_epi8(x0, bswap));
+
+	return crc_slice_by_8(dst, data, length, crc_slice_by_8(NULL, rem, sizeof(rem), 0));
+}
+
+#endif /* CRC_HAVE_PCLMUL */
+
+/**
+ *  @brief   Build the tables and select the best kernel available on the running CPU
+ */
+static void crc_engine_init(void)
+{
+	int impl = RLE_CRC_IMPL_SLICE_BY_8;
+	size_t slice;
+	size_t i;
+
+	for (i = 0; i < 256; i++) {
+		crc_slice_tab[0][i] = crctab[i];
+	}
+	for (slice = 1; slice < CRC_SLICES; slice++) {
+		for (i = 0; i < 256; i++) {
+			const uint32_t prev = crc_slice_tab[slice - 1][i];
+			crc_slice_tab[slice][i] = prev << 8 ^ crctab[prev >> 24];
+		}
+	}
+
+	crc_fold_k[0] = crc_xpow_mod(512 + 64);
+	crc_fold_k[1] = crc_xpow_mod(512);
+	crc_fold_k[2] = crc_xpow_mod(128 + 64);
+	crc_fold_k[3] = crc_xpow_mod(128);
+
+#ifdef CRC_HAVE_PCLMUL
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3")) {
+		impl = RLE_CRC_IMPL_PCLMUL;
+	}
+#endif
+
+	/* Tables are published before the kernel */
+	__atomic_store_n(&crc_impl, impl, __ATOMIC_RELEASE);
+}
+
+/**
+ *  @brief   Get the selected kernel, initializing the engine on first call
+ *
+ *           The first thread to call initializes the engine, the concurrent first calls of the
+ *           other threads wait for the kernel to be published, so that the tables are written
+ *           once and never read while being written.
+ *
+ *  @return  The selected kernel
+ */
+static int crc_get_impl(void)
+{
+	int impl = __atomic_load_n(&crc_impl, __ATOMIC_ACQUIRE);
+
+	if (impl < 0) {
+		int not_started = 0;
+
+		if (__atomic_compare_exchange_n(&crc_init_started, &not_started, 1, 0,
+		                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			crc_engine_init();
+		}
+		while ((impl = __atomic_load_n(&crc_impl, __ATOMIC_ACQUIRE)) < 0) {
+			/* another thread is building the tables */
+		}
+	}
+
+	return impl;
+}
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*------------------------------------ PUBLIC FUNCTIONS CODES ------------------------------------*/
@@ -151,6 +414,9 @@ static const uint32_t crctab[] =
 /**
  *  @brief   Compute CRC32
  *
+ *           The result is the same whatever the kernel selected, one octet at a time through
+ *           crctab.
+ *
  *  @param   data      The data
  *  @param   length    Length of the data
  *  @param   crc_init  Initial CRC value
@@ -159,12 +425,46 @@ static const uint32_t crctab[] =
  */
 uint32_t compute_crc(const unsigned char *data, const size_t length, const uint32_t crc_init)
 {
-	uint32_t crc = crc_init;
-	size_t i;
+	const int impl = crc_get_impl();
 
-#define COMPUTE(var, ch)  (var) = (var) << 8 ^ crctab[(var) >> 24 ^ (ch)]
-	for (i = 0; i < length; i++) {
-		COMPUTE(crc, data[i]);
+#ifdef CRC_HAVE_PCLMUL
+	if (impl == RLE_CRC_IMPL_PCLMUL && length >= CRC_PCLMUL_MIN_LEN) {
+		return crc_pclmul(NULL, data, length, crc_init);
 	}
-	return crc;
+#else
+	(void)impl;
+#endif
+
+	return crc_slice_by_8(NULL, data, length, crc_init);
+}
+
+/**
+ *  @brief   Copy data and compute its CRC32 in a single pass
+ *
+ *  @param   dst       The destination of the copy, must not overlap the data
+ *  @param   data      The data
+ *  @param   length    Length of the data
+ *  @param   crc_init  Initial CRC value
+ *
+ *  @return          The CRC32, same as compute_crc() on the data
+ */
+uint32_t compute_crc_cpy(unsigned char *const dst, const unsigned char *data,
+                         const size_t length, const uint32_t crc_init)
+{
+	const int impl = crc_get_impl();
+
+#ifdef CRC_HAVE_PCLMUL
+	if (impl == RLE_CRC_IMPL_PCLMUL && length >= CRC_PCLMUL_MIN_LEN) {
+		return crc_pclmul(dst, data, length, crc_init);
+	}
+#else
+	(void)impl;
+#endif
+
+	return crc_slice_by_8(dst, data, length, crc_init);
+}
+
+enum rle_crc_impl rle_crc_get_implementation(void)
+{
+	return (enum rle_crc_impl)crc_get_impl();
 }
@@ -30,6 +30,7 @@
 #include "rle_ctx.h"
 #include "constants.h"
 #include "reassembly_buffer.h"
+#include "rle_conf.h"
 #include "rle.h"
 
 #ifndef __KERNEL__
@@ -42,6 +43,7 @@
 #else
 
 #include <linux/string.h>
+#include <linux/prefetch.h>
 
 #endif
 
@@ -52,66 +54,614 @@
 
 #define MODULE_ID RLE_MOD_ID_DEENCAP
 
+/** Number of machine words tested at once by the padding scan */
+#define PADDING_SCAN_WORDS  4
+
+/** Max size of a PPDU, header included: its length field is 11-bit long */
+#define PPDU_MAX_LEN  (2 + 0x7ff)
+
+#ifndef __KERNEL__
+/** Prefetch memory that is about to be read, as the kernel helper does */
+#define prefetch(addr) __builtin_prefetch((addr), 0)
+#endif
+
 
 /*------------------------------------------------------------------------------------------------*/
-/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------ PRIVATE STRUCTS -------------------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
 
-enum rle_decap_status rle_decapsulate(struct rle_receiver *const receiver,
-                                      unsigned char *const fpdu,
-                                      const size_t fpdu_length,
-                                      struct rle_sdu sdus[],
-                                      const size_t sdus_max_nr,
-                                      size_t *const sdus_nr,
-                                      unsigned char *const payload_label,
-                                      const size_t payload_label_size)
+/**
+ * Where the SDUs of a decapsulated FPDU go: either a SDUs array, with its buffers or the ones
+ * of a SDU pool, or the user callbacks
+ */
+struct decap_output {
+	struct rle_sdu *sdus;                         /**< The SDUs array, NULL with callbacks.  */
+	size_t sdus_max_nr;                           /**< The SDUs array size.                  */
+	const struct rle_decap_callbacks *callbacks;  /**< The callbacks, NULL with SDUs array.  */
+	struct rle_sdu_pool *pool;                    /**< The SDU buffers, NULL if given.       */
+	bool zero_copy;                               /**< Whether the SDUs may be left in place.*/
+	bool resumable;                               /**< Whether a full array pauses parsing.  */
+};
+
+/** A FPDU in two segments, the end of a ring buffer then its start */
+struct fpdu_segments {
+	unsigned char *starts[2];  /**< The segments.                                     */
+	size_t lengths[2];         /**< The bytes of the FPDU in each segment, the first
+	                                one shorter than the FPDU if it wraps.            */
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Find the first non-zero octet of the FPDU padding.
+ *
+ *                The padding is scanned several aligned machine words at a time, only the
+ *                unaligned head and the tail, or the block holding a non-zero octet, are scanned
+ *                byte per byte.
+ *
+ * @param[in]     padding                 The padding.
+ * @param[in]     padding_length          The size of the padding.
+ *
+ * @return        The offset of the first non-zero octet, padding_length if all octets are zero.
+ */
+static size_t padding_find_non_zero(const unsigned char *const padding,
+                                    const size_t padding_length)
 {
-	enum rle_decap_status status = RLE_DECAP_ERR;
-	int padding_detected = false;
+	const size_t block_size = PADDING_SCAN_WORDS * sizeof(unsigned long);
 	size_t offset = 0;
 
-	/* checks inputs */
-	if (receiver == NULL) {
-		status = RLE_DECAP_ERR_NULL_RCVR;
+	while (offset < padding_length &&
+	       ((uintptr_t)(padding + offset) & (sizeof(unsigned long) - 1)) != 0) {
+		if (padding[offset] != 0x00) {
+			goto out;
+		}
+		offset++;
+	}
+
+	while ((offset + block_size) <= padding_length) {
+		unsigned long words[PADDING_SCAN_WORDS];
+		unsigned long acc = 0;
+		size_t i;
+
+		memcpy(words, padding + offset, block_size);
+		for (i = 0; i < PADDING_SCAN_WORDS; i++) {
+			acc |= words[i];
+		}
+		if (acc != 0) {
+			break;
+		}
+		offset += block_size;
+	}
+
+	while (offset < padding_length && padding[offset] == 0x00) {
+		offset++;
+	}
+
+out:
+	return offset;
+}
+
+/**
+ * @brief         Verify the FPDU padding according to the receiver padding check mode.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     padding                 The padding.
+ * @param[in]     padding_length          The size of the padding.
+ */
+static void check_padding(struct rle_receiver *const receiver,
+                          const unsigned char *const padding,
+                          const size_t padding_length)
+{
+	size_t non_zero;
+
+	switch (receiver->padding_check) {
+	case RLE_PADDING_CHECK_NONE:
 		goto out;
+	case RLE_PADDING_CHECK_SAMPLED:
+		if ((receiver->padding_sample++ % RLE_PADDING_CHECK_SAMPLING) != 0) {
+			goto out;
+		}
+		break;
+	default:
+		break;
 	}
 
-	if ((fpdu == NULL) || (fpdu_length == 0)) {
-		status = RLE_DECAP_ERR_INV_FPDU;
+	non_zero = padding_find_non_zero(padding, padding_length);
+	if (non_zero < padding_length) {
+		RLE_DEBUG_TO(&receiver->log_sink,
+		             "FPDU padding contains octets non equal to 0x00 (at least byte #%zu "
+		             "of the %zu-byte padding)", non_zero + 1, padding_length);
+		rle_ctx_counter_add(receiver->padding_errors, 1);
+	}
+
+out:
+	return;
+}
+
+/**
+ * @brief         Give one SDU to the user through the callbacks of the callback decapsulation.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     callbacks               The allocator and delivery callbacks, without allocator
+ *                                        callback for the in-place delivery.
+ * @param[in,out] sdu                     The SDU, left in the FPDU or in the reassembly storage.
+ *
+ * @return        true if the SDU was delivered, false if the allocator refused it.
+ */
+static bool deliver_sdu(struct rle_receiver *const receiver,
+                        const struct rle_decap_callbacks *const callbacks,
+                        struct rle_sdu *const sdu)
+{
+	bool delivered = false;
+	unsigned char *buffer;
+
+	if (callbacks->alloc == NULL) {
+		/* in-place delivery, the SDU is valid until its storage is released below */
+		callbacks->deliver(callbacks->arg, sdu);
+		delivered = true;
 		goto out;
 	}
 
-	if ((fpdu_length < payload_label_size)) {
-		status = RLE_DECAP_ERR_INV_FPDU;
+	buffer = callbacks->alloc(callbacks->arg, sdu->size);
+	if (buffer == NULL) {
+		RLE_WARN_TO(&receiver->log_sink,
+		            "no buffer given for the %zu-byte SDU, SDU dropped", sdu->size);
+		rle_rcv_count_error(receiver, RLE_RCV_ERR_NO_BUFFER);
 		goto out;
 	}
-	RLE_DEBUG("decapsulate one %zu-byte FPDU with a %zu-byte Payload Label",
-	          fpdu_length, payload_label_size);
 
-	if (sdus == NULL || sdus_max_nr == 0 || sdus_nr == NULL) {
-		status = RLE_DECAP_ERR_INV_SDUS;
+	memcpy(buffer, sdu->buffer, sdu->size);
+	rle_copy_count(&receiver->copy_stats, RLE_COPY_DELIVER, sdu->size, 0);
+	sdu->buffer = buffer;
+	callbacks->deliver(callbacks->arg, sdu);
+	delivered = true;
+
+out:
+	/* the reassembly storage of the SDU, if any, is not used anymore */
+	rle_receiver_release_delivered(receiver);
+
+	return delivered;
+}
+
+/**
+ * @brief         Copy one SDU in a buffer of the SDU pool of the pooled decapsulation.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in,out] pool                    The SDU pool of the receiver.
+ * @param[in,out] sdu                     The SDU, left in the FPDU or in the reassembly storage,
+ *                                        then in its buffer.
+ *
+ * @return        true if the SDU was copied, false if no buffer is left for it.
+ */
+static bool pool_sdu(struct rle_receiver *const receiver,
+                     struct rle_sdu_pool *const pool,
+                     struct rle_sdu *const sdu)
+{
+	bool pooled = false;
+	unsigned char *buffer;
+
+	buffer = rle_sdu_pool_take(pool, sdu->size);
+	if (buffer == NULL) {
+		RLE_WARN_TO(&receiver->log_sink,
+		            "no pool buffer left for the %zu-byte SDU, SDU dropped", sdu->size);
+		rle_rcv_count_error(receiver, RLE_RCV_ERR_NO_BUFFER);
 		goto out;
 	}
 
+	memcpy(buffer, sdu->buffer, sdu->size);
+	rle_copy_count(&receiver->copy_stats, RLE_COPY_DELIVER, sdu->size, 0);
+	sdu->buffer = buffer;
+	pooled = true;
+
+out:
+	/* the reassembly storage of the SDU, if any, is not used anymore */
+	rle_receiver_release_delivered(receiver);
+
+	return pooled;
+}
+
+/**
+ * @brief         Check the FPDU given to decapsulate.
+ *
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        RLE_DECAP_OK if the FPDU is valid, else RLE_DECAP_ERR_INV_FPDU.
+ */
+static enum rle_decap_status check_fpdu(const unsigned char *const fpdu,
+                                        const size_t fpdu_length,
+                                        const size_t payload_label_size)
+{
+	if ((fpdu == NULL) || (fpdu_length == 0)) {
+		return RLE_DECAP_ERR_INV_FPDU;
+	}
+
+	if ((fpdu_length < payload_label_size)) {
+		return RLE_DECAP_ERR_INV_FPDU;
+	}
+
+	return RLE_DECAP_OK;
+}
+
+/**
+ * @brief         Check where the SDUs of the decapsulation go.
+ *
+ * @param[in]     output                  Where the SDUs go.
+ * @param[in]     sdus_nr                 The number of SDUs decapsulated.
+ *
+ * @return        RLE_DECAP_OK if the output is valid, else RLE_DECAP_ERR_INV_SDUS.
+ */
+static enum rle_decap_status check_output(const struct decap_output *const output,
+                                          const size_t *const sdus_nr)
+{
+	if (sdus_nr == NULL) {
+		return RLE_DECAP_ERR_INV_SDUS;
+	}
+
+	if (output->callbacks != NULL) {
+		if (output->callbacks->deliver == NULL) {
+			return RLE_DECAP_ERR_INV_SDUS;
+		}
+	} else if (output->sdus == NULL || output->sdus_max_nr == 0) {
+		return RLE_DECAP_ERR_INV_SDUS;
+	}
+
+	return RLE_DECAP_OK;
+}
+
+/**
+ * @brief         Check the payload label given to decapsulate.
+ *
+ * @param[in]     payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        RLE_DECAP_OK if the payload label is valid, else RLE_DECAP_ERR_INV_PL.
+ */
+static enum rle_decap_status check_payload_label(const unsigned char *const payload_label,
+                                                 const size_t payload_label_size)
+{
 	if ((payload_label == NULL) ^ (payload_label_size == 0)) {
-		status = RLE_DECAP_ERR_INV_PL;
-		goto out;
+		return RLE_DECAP_ERR_INV_PL;
 	}
 
 	if ((payload_label_size != 0) && (payload_label_size != 3) && (payload_label_size != 6)) {
-		status = RLE_DECAP_ERR_INV_PL;
-		goto out;
+		return RLE_DECAP_ERR_INV_PL;
+	}
+
+	return RLE_DECAP_OK;
+}
+
+/**
+ * @brief         Parse a PPDU into zero or one SDU.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     ppdu                    The PPDU, its length already checked.
+ * @param[in]     ppdu_length             The size of the PPDU.
+ * @param[in]     remaining_length        The bytes of the FPDU left to parse, the PPDU included.
+ * @param[in]     output                  Where the SDUs go.
+ * @param[in,out] sdus_nr                 The number of SDUs decapsulated from the FPDU.
+ * @param[in,out] status                  The decapsulation status of the FPDU.
+ *
+ * @return        true if the PPDU was parsed, false if the parsing of the FPDU shall stop since
+ *                there is no more SDU buffer.
+ */
+static bool parse_ppdu(struct rle_receiver *const receiver,
+                       unsigned char *const ppdu,
+                       const size_t ppdu_length,
+                       const size_t remaining_length,
+                       const struct decap_output *const output,
+                       size_t *const sdus_nr,
+                       enum rle_decap_status *const status)
+{
+	struct rle_sdu sdu_cb = { .buffer = NULL, .size = 0, .protocol_type = 0 };
+	struct rle_sdu *sdu;
+	int fragment_id;
+	int ret;
+
+	if (output->callbacks != NULL) {
+		sdu = &sdu_cb;
+	} else if ((*sdus_nr) < output->sdus_max_nr) {
+		sdu = &output->sdus[*sdus_nr];
+	} else if (output->resumable) {
+		RLE_DEBUG_TO(&receiver->log_sink,
+		             "all %zu SDU buffers are full, pause with %zu bytes of FPDU left",
+		             output->sdus_max_nr, remaining_length);
+		*status = RLE_DECAP_PAUSED;
+		return false;
+	} else {
+		RLE_ERR_TO(&receiver->log_sink,
+		           "failed to decapsulate all SDUs from the FPDU: all %zu "
+		           "SDU buffers are full, but FPDU is not fully parsed "
+		           "(current %zu-byte PPDU fragment will be lost, as well "
+		           "as the %zu bytes of FPDU that remain to be parsed)\n",
+		           output->sdus_max_nr, ppdu_length, remaining_length);
+		rle_rcv_count_error(receiver, RLE_RCV_ERR_NO_BUFFER);
+		*status = RLE_DECAP_ERR_SOME_DROP;
+		return false;
+	}
+
+	/* parse the PPDU fragment */
+	RLE_DEBUG_TO(&receiver->log_sink, "decapsule the %zu-byte PPDU", ppdu_length);
+	ret = rle_receiver_deencap_data(receiver, ppdu, ppdu_length, &fragment_id, sdu,
+	                                output->zero_copy);
+
+	if ((ret != C_OK) && (ret != C_REASSEMBLY_OK)) {
+		RLE_ERR_TO(&receiver->log_sink, "Error during reassembly\n");
+		if (fragment_id != -1) {
+			rle_receiver_free_context(receiver, fragment_id);
+		}
+		*status = RLE_DECAP_ERR;
+	} else if (ret == C_REASSEMBLY_OK) {
+		/* Potential SDU received. */
+		bool kept = true;
+
+		if (output->callbacks != NULL) {
+			kept = deliver_sdu(receiver, output->callbacks, sdu);
+		} else if (output->pool != NULL) {
+			kept = pool_sdu(receiver, output->pool, sdu);
+		}
+		if (kept) {
+			(*sdus_nr)++;
+		} else {
+			*status = RLE_DECAP_ERR_SOME_DROP;
+		}
 	}
 
+	return true;
+}
+
+/**
+ * @brief         Copy bytes of a FPDU in two segments, across the end of the first one.
+ *
+ * @param[out]    dst                     Where to copy the bytes.
+ * @param[in]     fpdu                    The FPDU.
+ * @param[in]     offset                  The offset of the first byte to copy in the FPDU.
+ * @param[in]     length                  The number of bytes to copy, all in the FPDU.
+ */
+static void segments_copy(unsigned char *const dst,
+                          const struct fpdu_segments *const fpdu,
+                          const size_t offset,
+                          const size_t length)
+{
+	size_t first_length = 0;
+
+	if (offset < fpdu->lengths[0]) {
+		first_length = fpdu->lengths[0] - offset;
+		if (first_length > length) {
+			first_length = length;
+		}
+		memcpy(dst, fpdu->starts[0] + offset, first_length);
+	}
+	memcpy(dst + first_length, fpdu->starts[1] + (offset + first_length - fpdu->lengths[0]),
+	       length - first_length);
+}
+
+/**
+ * @brief         Get the first bytes of a PPDU of a FPDU in two segments, in place if they are in
+ *                one segment, copied otherwise.
+ *
+ * @param[out]    bounce                  Where the bytes are copied if needed, the bytes beyond
+ *                                        the end of the FPDU zeroed.
+ * @param[in]     fpdu                    The FPDU.
+ * @param[in]     offset                  The offset of the PPDU in the FPDU.
+ * @param[in]     length                  The number of bytes to get.
+ *
+ * @return        The bytes, in either segment or in the bounce buffer.
+ */
+static const unsigned char *segments_peek(unsigned char *const bounce,
+                                          const struct fpdu_segments *const fpdu,
+                                          const size_t offset,
+                                          const size_t length)
+{
+	const size_t fpdu_length = fpdu->lengths[0] + fpdu->lengths[1];
+
+	if (offset < fpdu->lengths[0]) {
+		if ((fpdu->lengths[0] - offset) >= length) {
+			return fpdu->starts[0] + offset;
+		}
+	} else if ((fpdu_length - offset) >= length) {
+		return fpdu->starts[1] + (offset - fpdu->lengths[0]);
+	}
+
+	memset(bounce, 0, length);
+	segments_copy(bounce, fpdu, offset,
+	              (fpdu_length - offset) < length ? fpdu_length - offset : length);
+
+	return bounce;
+}
+
+/**
+ * @brief         Validate a FPDU before any of its PPDUs is parsed, reading it only.
+ *
+ *                The PPDU lengths shall chain up to the padding or the end of the FPDU, and each
+ *                PPDU be long enough for its header. The fragments of a fragment id started in
+ *                the FPDU shall carry the ALPDU length given by the START, once: a CONT or END
+ *                holding more bytes, an END holding fewer, a START or a CONT after a START or an
+ *                END with no END in between, cannot come from a transmitter. The fragments of
+ *                the SDUs started in previous FPDUs are left to the reassembly, since the FPDUs
+ *                before may have been lost.
+ *
+ * @param[in,out] receiver                The receiver module, its rejections counted.
+ * @param[in]     fpdu                    The FPDU to validate, in one or two segments.
+ * @param[in]     offset                  The offset of the first PPDU in the FPDU.
+ *
+ * @return        true if the FPDU is well-formed, false if it is to be dropped.
+ */
+static bool validate_fpdu(struct rle_receiver *const receiver,
+                          const struct fpdu_segments *const fpdu,
+                          size_t offset)
+{
+	const size_t fpdu_length = fpdu->lengths[0] + fpdu->lengths[1];
+	/* the ALPDU bytes still expected for the fragment ids started in the FPDU */
+	size_t alpdu_left[RLE_MAX_FRAG_NUMBER];
+	/* the longest PPDU header, when it straddles the end of a segment */
+	unsigned char bounce[sizeof(rle_ppdu_hdr_start_t)];
+	uint8_t started = 0;
+	uint8_t ended = 0;
+
+	while ((offset + 1) < fpdu_length) {
+		const unsigned char *const ppdu = segments_peek(bounce, fpdu, offset, sizeof(bounce));
+		const rle_ppdu_hdr_t *const header = (const rle_ppdu_hdr_t *)ppdu;
+		size_t ppdu_length;
+		int fragment_type;
+		size_t alpdu_frag_len;
+		uint8_t frag_bit;
+
+		if (ppdu[0] == 0x00 && ppdu[1] == 0x00) {
+			break;
+		}
+		ppdu_length = get_fragment_length(ppdu);
+		fragment_type = rle_ppdu_get_fragment_type(header);
+
+		if (ppdu_length > (fpdu_length - offset)) {
+			RLE_ERR_TO(&receiver->log_sink,
+			           "FPDU dropped: %zu-byte PPDU at byte #%zu with %zu bytes remaining",
+			           ppdu_length, offset + 1, fpdu_length - offset);
+			rle_rcv_count_error(receiver, RLE_RCV_ERR_PPDU_LEN);
+			return false;
+		}
+
+		switch (fragment_type) {
+		case RLE_PDU_START_FRAG: {
+			const rle_ppdu_hdr_start_t *const start = (const rle_ppdu_hdr_start_t *)header;
+			const size_t alpdu_total_len = rle_ppdu_hdr_start_get_total_len(start);
+			const size_t trailer_len = (rle_start_ppdu_hdr_get_use_crc(start) ?
+			                            sizeof(rle_alpdu_crc_trailer_t) :
+			                            sizeof(rle_alpdu_seqno_trailer_t));
+
+			frag_bit = (uint8_t)(1 << rle_start_ppdu_hdr_get_frag_id(start));
+			if (ppdu_length < sizeof(rle_ppdu_hdr_start_t)) {
+				RLE_ERR_TO(&receiver->log_sink,
+				           "FPDU dropped: %zu-byte PPDU START at byte #%zu too short for "
+				           "its header", ppdu_length, offset + 1);
+				rle_rcv_count_error(receiver, RLE_RCV_ERR_SDU_TOO_SHORT);
+				return false;
+			}
+			if ((started & frag_bit) != 0) {
+				RLE_ERR_TO(&receiver->log_sink,
+				           "FPDU dropped: PPDU START at byte #%zu while the previous one is "
+				           "not ended", offset + 1);
+				rle_rcv_count_error(receiver, RLE_RCV_ERR_CTX_BUSY);
+				return false;
+			}
+			alpdu_frag_len = ppdu_length - sizeof(rle_ppdu_hdr_start_t);
+			if (alpdu_frag_len > alpdu_total_len || alpdu_total_len < trailer_len) {
+				RLE_ERR_TO(&receiver->log_sink,
+				           "FPDU dropped: PPDU START at byte #%zu with %zu ALPDU bytes of "
+				           "%zu in total", offset + 1, alpdu_frag_len, alpdu_total_len);
+				rle_rcv_count_error(receiver, alpdu_frag_len > alpdu_total_len ?
+				                    RLE_RCV_ERR_SDU_TOO_LONG : RLE_RCV_ERR_SDU_TOO_SHORT);
+				return false;
+			}
+			alpdu_left[rle_start_ppdu_hdr_get_frag_id(start)] = alpdu_total_len - alpdu_frag_len;
+			started |= frag_bit;
+			ended &= (uint8_t)~frag_bit;
+			break;
+		}
+		case RLE_PDU_CONT_FRAG:
+		case RLE_PDU_END_FRAG: {
+			const rle_ppdu_hdr_cont_end_t *const cont_end =
+				(const rle_ppdu_hdr_cont_end_t *)header;
+			const uint8_t frag_id = rle_cont_end_ppdu_hdr_get_frag_id(cont_end);
+
+			frag_bit = (uint8_t)(1 << frag_id);
+			if ((ended & frag_bit) != 0) {
+				RLE_ERR_TO(&receiver->log_sink,
+				           "FPDU dropped: PPDU %s at byte #%zu after the END of its fragment "
+				           "id", fragment_type == RLE_PDU_END_FRAG ? "END" : "CONT",
+				           offset + 1);
+				rle_rcv_count_error(receiver, RLE_RCV_ERR_CTX_FREE);
+				return false;
+			}
+			if ((started & frag_bit) == 0) {
+				/* the SDU was started in a previous FPDU */
+				break;
+			}
+			alpdu_frag_len = ppdu_length - sizeof(rle_ppdu_hdr_cont_end_t);
+			if (alpdu_frag_len > alpdu_left[frag_id] ||
+			    (fragment_type == RLE_PDU_END_FRAG && alpdu_frag_len < alpdu_left[frag_id])) {
+				RLE_ERR_TO(&receiver->log_sink,
+				           "FPDU dropped: PPDU %s at byte #%zu with %zu ALPDU bytes while "
+				           "%zu bytes are left", fragment_type == RLE_PDU_END_FRAG ?
+				           "END" : "CONT", offset + 1, alpdu_frag_len, alpdu_left[frag_id]);
+				rle_rcv_count_error(receiver, alpdu_frag_len > alpdu_left[frag_id] ?
+				                    RLE_RCV_ERR_SDU_TOO_LONG : RLE_RCV_ERR_SDU_TOO_SHORT);
+				return false;
+			}
+			alpdu_left[frag_id] -= alpdu_frag_len;
+			if (fragment_type == RLE_PDU_END_FRAG) {
+				started &= (uint8_t)~frag_bit;
+				ended |= frag_bit;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+
+		offset += ppdu_length;
+	}
+
+	return true;
+}
+
+/**
+ * @brief         Parse the PPDUs of the given FPDU, already checked, into zero or more SDUs.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[in,out] fpdu_offset             The offset of the first PPDU to parse, 0 for the start
+ *                                        of the FPDU, updated if the parsing is paused.
+ * @param[in]     output                  Where the SDUs go.
+ * @param[out]    sdus_nr                 The number of SDUs decapsulated.
+ * @param[in,out] payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        decapsulation status.
+ */
+static enum rle_decap_status parse_fpdu(struct rle_receiver *const receiver,
+                                        unsigned char *const fpdu,
+                                        const size_t fpdu_length,
+                                        size_t *const fpdu_offset,
+                                        const struct decap_output *const output,
+                                        size_t *const sdus_nr,
+                                        unsigned char *const payload_label,
+                                        const size_t payload_label_size)
+{
+	/* the FPDU as one segment, the second one empty */
+	const struct fpdu_segments segments = {
+		.starts = { fpdu, fpdu + fpdu_length },
+		.lengths = { fpdu_length, 0 },
+	};
+	enum rle_decap_status status = RLE_DECAP_ERR;
+	int padding_detected = false;
+	size_t offset = *fpdu_offset;
+
+	RLE_DEBUG_TO(&receiver->log_sink,
+	             "decapsulate one %zu-byte FPDU with a %zu-byte Payload Label",
+	             fpdu_length, payload_label_size);
+
 	/* no SDUs decapsulated yet */
 	*sdus_nr = 0;
 
-	/* copy payload label to user if present */
-	if (payload_label_size != 0) {
+	/* copy payload label to user if present, the FPDU is not resumed */
+	if (offset == 0 && payload_label_size != 0) {
 		memcpy(payload_label, fpdu, payload_label_size);
 		offset += payload_label_size;
 	}
 
+	/* a FPDU resumed was validated before its first PPDU was parsed */
+	if (receiver->fpdu_validation && *fpdu_offset == 0 &&
+	    !validate_fpdu(receiver, &segments, offset)) {
+		status = RLE_DECAP_ERR;
+		goto out;
+	}
+
 	status = RLE_DECAP_OK;
 
 	/* parse all PPDUs that the FPDU contains until there is less than 2 bytes
@@ -119,73 +669,653 @@ enum rle_decap_status rle_decapsulate(struct rle_receiver *const receiver,
 	while ((offset + 1) < fpdu_length && !padding_detected) {
 		unsigned char *const ppdu = &fpdu[offset];
 		size_t ppdu_length;
-		int fragment_id;
-		int ret;
 
 		/* is there padding? */
 		if (ppdu[0] == 0x00 && ppdu[1] == 0x00) {
-			RLE_DEBUG("padding detected at byte #%zu in FPDU", offset + 1);
+			RLE_DEBUG_TO(&receiver->log_sink,
+			             "padding detected at byte #%zu in FPDU", offset + 1);
 			padding_detected = true;
 			continue;
 		}
 
 		/* retrieve the fragment type and length in the first 2 bytes of the PPDU fragment */
 		ppdu_length = get_fragment_length(ppdu);
-		RLE_DEBUG("%zu-byte PPDU detected at byte #%zu in FPDU", ppdu_length, offset + 1);
+		RLE_DEBUG_TO(&receiver->log_sink,
+		             "%zu-byte PPDU detected at byte #%zu in FPDU", ppdu_length,
+		             offset + 1);
 
 		/* stop parsing the FPDU if the PPDU length is wrong */
 		if (ppdu_length > (fpdu_length - offset)) {
-			RLE_ERR("Invalid fragment size, fragment length too big for FPDU "
-			        "(fragment length = %zu, remaining FPDU size = %zu)\n",
-			        ppdu_length, fpdu_length - offset);
+			RLE_ERR_TO(&receiver->log_sink,
+			           "Invalid fragment size, fragment length too big for FPDU "
+			           "(fragment length = %zu, remaining FPDU size = %zu)\n",
+			           ppdu_length, fpdu_length - offset);
+			rle_rcv_count_error(receiver, RLE_RCV_ERR_PPDU_LEN);
 			status = RLE_DECAP_ERR;
 			goto out;
 		}
 
-		/* stop deencapulation if there is no more SDU buffers */
-		if ((*sdus_nr) == sdus_max_nr) {
-			RLE_ERR("failed to decapsulate all SDUs from the FPDU: all %zu "
-			        "SDU buffers are full, but FPDU is not fully parsed "
-			        "(current %zu-byte PPDU fragment will be lost, as well "
-			        "as the %zu bytes of FPDU that remain to be parsed)\n",
-			        sdus_max_nr, ppdu_length, fpdu_length - offset);
-			status = RLE_DECAP_ERR_SOME_DROP;
+		/* stop parsing the FPDU if there is no more SDU buffers */
+		if (!parse_ppdu(receiver, ppdu, ppdu_length, fpdu_length - offset, output, sdus_nr,
+		                &status)) {
 			goto out;
 		}
 
-		/* parse the PPDU fragment */
-		RLE_DEBUG("decapsule the %zu-byte PPDU", ppdu_length);
-		ret = rle_receiver_deencap_data(receiver, ppdu, ppdu_length, &fragment_id,
-		                                &sdus[*sdus_nr]);
-
-		/* PPDU fragment successfully parsed, skip it */
+		/* PPDU fragment parsed, skip it */
 		offset += ppdu_length;
+		RLE_DEBUG_TO(&receiver->log_sink,
+		             "%zu bytes remaining to be parsed in FPDU", fpdu_length - offset);
+	}
 
-		if ((ret != C_OK) && (ret != C_REASSEMBLY_OK)) {
-			RLE_ERR("Error during reassembly\n");
-			if (fragment_id != -1) {
-				rle_receiver_free_context(receiver, fragment_id);
-			}
+	/* remaining FPDU bytes are padding: they should be all zero, count it if it is not the case */
+	RLE_DEBUG_TO(&receiver->log_sink, "%zu-byte padding detected", fpdu_length - offset);
+	if (offset < fpdu_length) {
+		check_padding(receiver, &fpdu[offset], fpdu_length - offset);
+	}
+
+	RLE_DEBUG_TO(&receiver->log_sink, "%zu SDU(s) decapsuled from FPDU", *sdus_nr);
+
+out:
+	/* a paused FPDU resumes at the first PPDU not parsed, otherwise it is done */
+	*fpdu_offset = (status == RLE_DECAP_PAUSED) ? offset : fpdu_length;
+
+	return status;
+}
+
+/**
+ * @brief         Parse the PPDUs of the given FPDU in two segments, already checked, into zero or
+ *                more SDUs.
+ *
+ *                Same as parse_fpdu(), with the PPDUs parsed in place in either segment. Only the
+ *                PPDU, its header or the payload label that straddles the end of the first segment
+ *                is copied, in a buffer on the stack.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     output                  Where the SDUs go, without zero copy nor pause.
+ * @param[out]    sdus_nr                 The number of SDUs decapsulated.
+ * @param[in,out] payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        decapsulation status.
+ */
+static enum rle_decap_status parse_fpdu_segments(struct rle_receiver *const receiver,
+                                                 const struct fpdu_segments *const fpdu,
+                                                 const struct decap_output *const output,
+                                                 size_t *const sdus_nr,
+                                                 unsigned char *const payload_label,
+                                                 const size_t payload_label_size)
+{
+	const size_t fpdu_length = fpdu->lengths[0] + fpdu->lengths[1];
+	unsigned char bounce[PPDU_MAX_LEN];
+	enum rle_decap_status status = RLE_DECAP_OK;
+	int padding_detected = false;
+	size_t offset = 0;
+	size_t segment;
+
+	RLE_DEBUG_TO(&receiver->log_sink,
+	             "decapsulate one %zu-byte FPDU wrapped after %zu bytes with a %zu-byte "
+	             "Payload Label", fpdu_length, fpdu->lengths[0], payload_label_size);
+
+	*sdus_nr = 0;
+
+	if (payload_label_size != 0) {
+		segments_copy(payload_label, fpdu, 0, payload_label_size);
+		offset += payload_label_size;
+	}
+
+	if (receiver->fpdu_validation && !validate_fpdu(receiver, fpdu, offset)) {
+		status = RLE_DECAP_ERR;
+		goto out;
+	}
+
+	while ((offset + 1) < fpdu_length && !padding_detected) {
+		const size_t in_first = (offset < fpdu->lengths[0]) ? fpdu->lengths[0] - offset : 0;
+		unsigned char *ppdu;
+		size_t ppdu_length;
+
+		/* the PPDU is in place unless it straddles the end of the first segment */
+		if (in_first == 0) {
+			ppdu = fpdu->starts[1] + (offset - fpdu->lengths[0]);
+		} else if (in_first >= 2) {
+			ppdu = fpdu->starts[0] + offset;
+		} else {
+			segments_copy(bounce, fpdu, offset, 2);
+			ppdu = bounce;
+		}
+
+		if (ppdu[0] == 0x00 && ppdu[1] == 0x00) {
+			RLE_DEBUG_TO(&receiver->log_sink,
+			             "padding detected at byte #%zu in FPDU", offset + 1);
+			padding_detected = true;
+			continue;
+		}
+
+		ppdu_length = get_fragment_length(ppdu);
+		RLE_DEBUG_TO(&receiver->log_sink,
+		             "%zu-byte PPDU detected at byte #%zu in FPDU", ppdu_length,
+		             offset + 1);
+
+		if (ppdu_length > (fpdu_length - offset)) {
+			RLE_ERR_TO(&receiver->log_sink,
+			           "Invalid fragment size, fragment length too big for FPDU "
+			           "(fragment length = %zu, remaining FPDU size = %zu)\n",
+			           ppdu_length, fpdu_length - offset);
+			rle_rcv_count_error(receiver, RLE_RCV_ERR_PPDU_LEN);
 			status = RLE_DECAP_ERR;
-		} else if (ret == C_REASSEMBLY_OK) {
-			/* Potential SDU received. */
-			(*sdus_nr)++;
+			goto out;
+		}
+
+		if (in_first != 0 && ppdu_length > in_first) {
+			RLE_DEBUG_TO(&receiver->log_sink,
+			             "%zu-byte PPDU wraps after %zu bytes, copy it", ppdu_length,
+			             in_first);
+			segments_copy(bounce, fpdu, offset, ppdu_length);
+			rle_copy_count(&receiver->copy_stats, RLE_COPY_WRAP, ppdu_length, 0);
+			ppdu = bounce;
+		}
+
+		if (!parse_ppdu(receiver, ppdu, ppdu_length, fpdu_length - offset, output, sdus_nr,
+		                &status)) {
+			goto out;
+		}
+		offset += ppdu_length;
+	}
+
+	/* the padding is checked in each segment it spans */
+	for (segment = 0; segment < 2; segment++) {
+		const size_t start = (segment == 0) ? 0 : fpdu->lengths[0];
+		const size_t end = start + fpdu->lengths[segment];
+
+		if (offset < end) {
+			const size_t first = (offset > start) ? offset - start : 0;
+
+			check_padding(receiver, fpdu->starts[segment] + first,
+			              fpdu->lengths[segment] - first);
+		}
+	}
+
+	RLE_DEBUG_TO(&receiver->log_sink, "%zu SDU(s) decapsuled from FPDU", *sdus_nr);
+
+out:
+	return status;
+}
+
+/**
+ * @brief         Decapsulate the given FPDU into zero or more SDUs.
+ *
+ * @param[in,out] receiver                The receiver module.
+ * @param[in]     fpdu                    The FPDU to decapsulate.
+ * @param[in]     fpdu_length             The size of the FPDU.
+ * @param[in,out] fpdu_offset             The offset of the first PPDU to parse, 0 for the start
+ *                                        of the FPDU, updated if the parsing is paused.
+ * @param[in]     output                  Where the SDUs go.
+ * @param[out]    sdus_nr                 The number of SDUs decapsulated.
+ * @param[in,out] payload_label           The identifier of the RCST, preallocated.
+ * @param[in]     payload_label_size      The size of the paylod label.
+ *
+ * @return        decapsulation status.
+ */
+static enum rle_decap_status decapsulate_fpdu(struct rle_receiver *const receiver,
+                                              unsigned char *const fpdu,
+                                              const size_t fpdu_length,
+                                              size_t *const fpdu_offset,
+                                              const struct decap_output *const output,
+                                              size_t *const sdus_nr,
+                                              unsigned char *const payload_label,
+                                              const size_t payload_label_size)
+{
+	enum rle_decap_status status;
+
+	/* checks inputs */
+	if (receiver == NULL) {
+		status = RLE_DECAP_ERR_NULL_RCVR;
+		goto out;
+	}
+
+	/* the SDUs handed over by the previous decapsulation are not used anymore */
+	rle_receiver_release_delivered(receiver);
+
+	/* counters snapshots see all or none of the updates done for the FPDU */
+	stats_update_begin(receiver);
+
+	status = check_fpdu(fpdu, fpdu_length, payload_label_size);
+	if (status == RLE_DECAP_OK) {
+		status = check_output(output, sdus_nr);
+	}
+	if (status == RLE_DECAP_OK) {
+		status = check_payload_label(payload_label, payload_label_size);
+	}
+	if (status == RLE_DECAP_OK) {
+		status = parse_fpdu(receiver, fpdu, fpdu_length, fpdu_offset, output, sdus_nr,
+		                    payload_label, payload_label_size);
+	}
+
+	stats_update_end(receiver);
+
+out:
+	return status;
+}
+
+
+/**
+ * @brief         Find the protocol type of the SDU of a PPDU COMPLETE or START, as the receiver
+ *                decoder would.
+ *
+ * @param[in]     conf                    The configuration of the transmitter of the PPDU.
+ * @param[in]     is_signal               Whether the ALPDU label type is the signalling one.
+ * @param[in]     is_suppressed           Whether the protocol type is omitted from the ALPDU.
+ * @param[in]     alpdu_frag              The ALPDU bytes of the PPDU.
+ * @param[in]     alpdu_frag_len          The number of ALPDU bytes of the PPDU.
+ *
+ * @return        The protocol type, uncompressed, 0 if the ALPDU bytes do not give it.
+ */
+static uint16_t index_protocol_type(const struct rle_config *const conf, const bool is_signal,
+                                    const bool is_suppressed,
+                                    const unsigned char *const alpdu_frag,
+                                    const size_t alpdu_frag_len)
+{
+	alpdu_extract_sdu_frag_t extractor;
+	const unsigned char *sdu_frag;
+	size_t sdu_frag_len;
+	uint8_t comp_ptype;
+	uint16_t ptype = 0;
+
+	if (is_suppressed) {
+		extractor = (is_signal ? signal_alpdu_extract_sdu_frag : suppr_alpdu_extract_sdu_frag);
+	} else {
+		extractor = (conf->use_compressed_ptype ? comp_alpdu_extract_sdu_frag :
+		             uncomp_alpdu_extract_sdu_frag);
+	}
+	if (extractor(alpdu_frag, alpdu_frag_len, &ptype, &comp_ptype, &sdu_frag, &sdu_frag_len,
+	              NULL, conf) != 0) {
+		ptype = 0;
+	}
+
+	return ptype;
+}
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+enum rle_decap_status rle_decapsulate(struct rle_receiver *const receiver,
+                                      unsigned char *const fpdu,
+                                      const size_t fpdu_length,
+                                      struct rle_sdu sdus[],
+                                      const size_t sdus_max_nr,
+                                      size_t *const sdus_nr,
+                                      unsigned char *const payload_label,
+                                      const size_t payload_label_size)
+{
+	const struct decap_output output = {
+		.sdus = sdus, .sdus_max_nr = sdus_max_nr, .callbacks = NULL, .pool = NULL,
+		.zero_copy = false, .resumable = false,
+	};
+	size_t offset = 0;
+
+	return decapsulate_fpdu(receiver, fpdu, fpdu_length, &offset, &output, sdus_nr,
+	                        payload_label, payload_label_size);
+}
+
+enum rle_decap_status rle_decapsulate_zero_copy(struct rle_receiver *const receiver,
+                                                unsigned char *const fpdu,
+                                                const size_t fpdu_length,
+                                                struct rle_sdu sdus[],
+                                                const size_t sdus_max_nr,
+                                                size_t *const sdus_nr,
+                                                unsigned char *const payload_label,
+                                                const size_t payload_label_size)
+{
+	const struct decap_output output = {
+		.sdus = sdus, .sdus_max_nr = sdus_max_nr, .callbacks = NULL, .pool = NULL,
+		.zero_copy = true, .resumable = false,
+	};
+	size_t offset = 0;
+
+	return decapsulate_fpdu(receiver, fpdu, fpdu_length, &offset, &output, sdus_nr,
+	                        payload_label, payload_label_size);
+}
+
+enum rle_decap_status rle_decapsulate_cb(struct rle_receiver *const receiver,
+                                         unsigned char *const fpdu,
+                                         const size_t fpdu_length,
+                                         const struct rle_decap_callbacks *const callbacks,
+                                         size_t *const sdus_nr,
+                                         unsigned char *const payload_label,
+                                         const size_t payload_label_size)
+{
+	/* the SDUs are copied once, from the FPDU or the reassembly storage to the user buffers */
+	const struct decap_output output = {
+		.sdus = NULL, .sdus_max_nr = 0, .callbacks = callbacks, .pool = NULL,
+		.zero_copy = true, .resumable = false,
+	};
+	size_t offset = 0;
+
+	if (callbacks == NULL) {
+		return RLE_DECAP_ERR_INV_SDUS;
+	}
+
+	return decapsulate_fpdu(receiver, fpdu, fpdu_length, &offset, &output, sdus_nr,
+	                        payload_label, payload_label_size);
+}
+
+enum rle_decap_status rle_decapsulate_pooled(struct rle_receiver *const receiver,
+                                             unsigned char *const fpdu,
+                                             const size_t fpdu_length,
+                                             struct rle_sdu sdus[],
+                                             const size_t sdus_max_nr,
+                                             size_t *const sdus_nr,
+                                             unsigned char *const payload_label,
+                                             const size_t payload_label_size)
+{
+	/* the SDUs are copied once, from the FPDU or the reassembly storage to the pool buffers */
+	struct decap_output output = {
+		.sdus = sdus, .sdus_max_nr = sdus_max_nr, .callbacks = NULL, .pool = NULL,
+		.zero_copy = true, .resumable = false,
+	};
+	size_t offset = 0;
+
+	if (receiver == NULL) {
+		return RLE_DECAP_ERR_NULL_RCVR;
+	}
+	if (receiver->sdu_pool == NULL) {
+		return RLE_DECAP_ERR_INV_SDUS;
+	}
+	output.pool = receiver->sdu_pool;
+
+	return decapsulate_fpdu(receiver, fpdu, fpdu_length, &offset, &output, sdus_nr,
+	                        payload_label, payload_label_size);
+}
+
+void rle_decap_cursor_init(struct rle_decap_cursor *const cursor,
+                           unsigned char *const fpdu,
+                           const size_t fpdu_length)
+{
+	cursor->fpdu = fpdu;
+	cursor->fpdu_length = fpdu_length;
+	cursor->offset = 0;
+}
+
+enum rle_decap_status rle_decapsulate_resume(struct rle_receiver *const receiver,
+                                             struct rle_decap_cursor *const cursor,
+                                             struct rle_sdu sdus[],
+                                             const size_t sdus_max_nr,
+                                             size_t *const sdus_nr,
+                                             unsigned char *const payload_label,
+                                             const size_t payload_label_size)
+{
+	const struct decap_output output = {
+		.sdus = sdus, .sdus_max_nr = sdus_max_nr, .callbacks = NULL, .pool = NULL,
+		.zero_copy = false, .resumable = true,
+	};
+
+	if (cursor == NULL) {
+		return RLE_DECAP_ERR_INV_FPDU;
+	}
+
+	return decapsulate_fpdu(receiver, cursor->fpdu, cursor->fpdu_length, &cursor->offset,
+	                        &output, sdus_nr, payload_label, payload_label_size);
+}
+
+enum rle_decap_status rle_decapsulate_wrapped(struct rle_receiver *const receiver,
+                                              unsigned char *const first,
+                                              const size_t first_length,
+                                              unsigned char *const second,
+                                              const size_t second_length,
+                                              const size_t fpdu_length,
+                                              struct rle_sdu sdus[],
+                                              const size_t sdus_max_nr,
+                                              size_t *const sdus_nr,
+                                              unsigned char *const payload_label,
+                                              const size_t payload_label_size,
+                                              size_t *const consumed)
+{
+	const struct decap_output output = {
+		.sdus = sdus, .sdus_max_nr = sdus_max_nr, .callbacks = NULL, .pool = NULL,
+		.zero_copy = false, .resumable = false,
+	};
+	struct fpdu_segments fpdu;
+	enum rle_decap_status status;
+	size_t offset = 0;
+
+	if (consumed == NULL) {
+		return RLE_DECAP_ERR_INV_FPDU;
+	}
+	*consumed = 0;
+
+	/* a FPDU that does not wrap is decapsulated as usual */
+	if (fpdu_length <= first_length) {
+		status = decapsulate_fpdu(receiver, first, fpdu_length, &offset, &output, sdus_nr,
+		                          payload_label, payload_label_size);
+		goto out;
+	}
+
+	if (receiver == NULL) {
+		status = RLE_DECAP_ERR_NULL_RCVR;
+		goto out;
+	}
+	if (first == NULL || second == NULL || (fpdu_length - first_length) > second_length) {
+		status = RLE_DECAP_ERR_INV_FPDU;
+		goto out;
+	}
+
+	rle_receiver_release_delivered(receiver);
+	stats_update_begin(receiver);
+
+	status = check_fpdu(first, fpdu_length, payload_label_size);
+	if (status == RLE_DECAP_OK) {
+		status = check_output(&output, sdus_nr);
+	}
+	if (status == RLE_DECAP_OK) {
+		status = check_payload_label(payload_label, payload_label_size);
+	}
+	if (status == RLE_DECAP_OK) {
+		fpdu.starts[0] = first;
+		fpdu.lengths[0] = first_length;
+		fpdu.starts[1] = second;
+		fpdu.lengths[1] = fpdu_length - first_length;
+		status = parse_fpdu_segments(receiver, &fpdu, &output, sdus_nr, payload_label,
+		                             payload_label_size);
+		offset = fpdu_length;
+	}
+
+	stats_update_end(receiver);
+
+out:
+	/* the FPDU is consumed once parsed, successfully or not */
+	*consumed = (offset == fpdu_length) ? fpdu_length : 0;
+
+	return status;
+}
+
+size_t rle_decapsulate_burst(struct rle_receiver *const receiver,
+                             struct rle_decap_burst_fpdu fpdus[],
+                             const size_t fpdus_nr,
+                             struct rle_sdu sdus[],
+                             const size_t sdus_max_nr,
+                             size_t *const sdus_nr)
+{
+	const struct decap_output burst_output = {
+		.sdus = sdus, .sdus_max_nr = sdus_max_nr, .callbacks = NULL, .pool = NULL,
+		.zero_copy = false, .resumable = false,
+	};
+	enum rle_decap_status status;
+	size_t decapsulated_nr = 0;
+	size_t sdus_total_nr = 0;
+	size_t i;
+
+	if (fpdus == NULL) {
+		goto out;
+	}
+
+	/* the checks common to all the FPDUs are made once for the burst */
+	if (receiver == NULL) {
+		status = RLE_DECAP_ERR_NULL_RCVR;
+	} else {
+		status = check_output(&burst_output, sdus_nr);
+	}
+	if (status != RLE_DECAP_OK) {
+		for (i = 0; i < fpdus_nr; i++) {
+			fpdus[i].first_sdu = 0;
+			fpdus[i].sdus_nr = 0;
+			fpdus[i].status = status;
 		}
-		RLE_DEBUG("%zu bytes remaining to be parsed in FPDU", fpdu_length - offset);
+		goto out;
 	}
 
-	/* remaining FPDU bytes are padding: they should be all zero, warn if it is not the case */
-	RLE_DEBUG("%zu-byte padding detected", fpdu_length - offset);
-	for (; offset < fpdu_length; offset++) {
-		if (fpdu[offset] != 0x00) {
-			RLE_WARN("FPDU padding contains octets non equal to 0x00 (at least byte "
-			         "#%zu of the %zu-byte FPDU)\n", offset + 1, fpdu_length);
-			break; /* stop padding verification after first error */
+	RLE_DEBUG_TO(&receiver->log_sink, "decapsulate a burst of %zu FPDUs", fpdus_nr);
+
+	rle_receiver_release_delivered(receiver);
+
+	/* counters snapshots see all or none of the updates done for the burst */
+	stats_update_begin(receiver);
+
+	for (i = 0; i < fpdus_nr; i++) {
+		struct rle_decap_burst_fpdu *const burst_fpdu = &fpdus[i];
+		/* the SDUs of the FPDU follow the ones of the previous FPDUs in the SDUs array */
+		const struct decap_output output = {
+			.sdus = sdus + sdus_total_nr, .sdus_max_nr = sdus_max_nr - sdus_total_nr,
+			.callbacks = NULL, .pool = NULL, .zero_copy = false, .resumable = false,
+		};
+		size_t offset = 0;
+
+		/* warm up the first PPDU header of the next FPDU while the current one is parsed */
+		if ((i + 1) < fpdus_nr && fpdus[i + 1].fpdu != NULL) {
+			prefetch(fpdus[i + 1].fpdu);
+			prefetch(fpdus[i + 1].fpdu + fpdus[i + 1].payload_label_size);
+		}
+
+		burst_fpdu->first_sdu = sdus_total_nr;
+		burst_fpdu->sdus_nr = 0;
+
+		burst_fpdu->status = check_fpdu(burst_fpdu->fpdu, burst_fpdu->fpdu_length,
+		                                burst_fpdu->payload_label_size);
+		if (burst_fpdu->status == RLE_DECAP_OK) {
+			burst_fpdu->status = check_payload_label(burst_fpdu->payload_label,
+			                                         burst_fpdu->payload_label_size);
+		}
+		if (burst_fpdu->status == RLE_DECAP_OK) {
+			burst_fpdu->status = parse_fpdu(receiver, burst_fpdu->fpdu, burst_fpdu->fpdu_length,
+			                                &offset, &output, &burst_fpdu->sdus_nr,
+			                                burst_fpdu->payload_label,
+			                                burst_fpdu->payload_label_size);
+		}
+
+		sdus_total_nr += burst_fpdu->sdus_nr;
+		if (burst_fpdu->status == RLE_DECAP_OK) {
+			decapsulated_nr++;
 		}
 	}
 
-	RLE_DEBUG("%zu SDU(s) decapsuled from FPDU", *sdus_nr);
+	stats_update_end(receiver);
+
+	*sdus_nr = sdus_total_nr;
 
 out:
+	return decapsulated_nr;
+}
+
+enum rle_decap_status rle_fpdu_index(const struct rle_config *const conf,
+                                     const unsigned char *const fpdu,
+                                     const size_t fpdu_length,
+                                     const size_t payload_label_size,
+                                     struct rle_ppdu_index ppdus[],
+                                     const size_t ppdus_max_nr,
+                                     size_t *const ppdus_nr)
+{
+	enum rle_decap_status status;
+	size_t offset = payload_label_size;
+	size_t nr = 0;
+
+	if (ppdus_nr == NULL) {
+		return RLE_DECAP_ERR_INV_SDUS;
+	}
+	*ppdus_nr = 0;
+	if (ppdus == NULL || ppdus_max_nr == 0) {
+		return RLE_DECAP_ERR_INV_SDUS;
+	}
+	if (conf == NULL || !rle_config_check(conf)) {
+		return RLE_DECAP_ERR;
+	}
+	status = check_fpdu(fpdu, fpdu_length, payload_label_size);
+	if (status != RLE_DECAP_OK) {
+		return status;
+	}
+
+	/* the same walk as the decapsulation, up to the padding */
+	while ((offset + 1) < fpdu_length && (fpdu[offset] != 0x00 || fpdu[offset + 1] != 0x00)) {
+		const rle_ppdu_hdr_t *const header = (const rle_ppdu_hdr_t *)&fpdu[offset];
+		const size_t ppdu_length = get_fragment_length(&fpdu[offset]);
+		const int fragment_type = rle_ppdu_get_fragment_type(header);
+		struct rle_ppdu_index *ppdu;
+		size_t hdr_len;
+
+		if (nr == ppdus_max_nr) {
+			status = RLE_DECAP_ERR_SOME_DROP;
+			goto out;
+		}
+		switch (fragment_type) {
+		case RLE_PDU_COMPLETE:
+			hdr_len = sizeof(rle_ppdu_hdr_comp_t);
+			break;
+		case RLE_PDU_START_FRAG:
+			hdr_len = sizeof(rle_ppdu_hdr_start_t);
+			break;
+		default:
+			hdr_len = sizeof(rle_ppdu_hdr_cont_end_t);
+			break;
+		}
+		if (ppdu_length > (fpdu_length - offset) || ppdu_length < hdr_len) {
+			status = RLE_DECAP_ERR_INV_FPDU;
+			goto out;
+		}
+
+		ppdu = &ppdus[nr];
+		ppdu->offset = offset;
+		ppdu->ppdu_length = ppdu_length;
+		ppdu->frag_id = 0;
+		ppdu->alpdu_total_len = 0;
+		ppdu->protocol_type = 0;
+
+		switch (fragment_type) {
+		case RLE_PDU_COMPLETE: {
+			const rle_ppdu_hdr_comp_t *const comp = (const rle_ppdu_hdr_comp_t *)header;
+
+			ppdu->type = RLE_PPDU_TYPE_COMPLETE;
+			ppdu->protocol_type =
+				index_protocol_type(conf, rle_comp_ppdu_hdr_get_is_signal(comp),
+				                    rle_comp_ppdu_hdr_get_is_suppressed(comp),
+				                    &fpdu[offset + hdr_len], ppdu_length - hdr_len);
+			break;
+		}
+		case RLE_PDU_START_FRAG: {
+			const rle_ppdu_hdr_start_t *const start = (const rle_ppdu_hdr_start_t *)header;
+
+			ppdu->type = RLE_PPDU_TYPE_START;
+			ppdu->frag_id = rle_start_ppdu_hdr_get_frag_id(start);
+			ppdu->alpdu_total_len = rle_ppdu_hdr_start_get_total_len(start);
+			ppdu->protocol_type =
+				index_protocol_type(conf, rle_start_ppdu_hdr_get_is_signal(start),
+				                    rle_start_ppdu_hdr_get_is_suppressed(start),
+				                    &fpdu[offset + hdr_len], ppdu_length - hdr_len);
+			break;
+		}
+		default:
+			ppdu->type = (fragment_type == RLE_PDU_END_FRAG ? RLE_PPDU_TYPE_END :
+			              RLE_PPDU_TYPE_CONT);
+			ppdu->frag_id =
+				rle_cont_end_ppdu_hdr_get_frag_id((const rle_ppdu_hdr_cont_end_t *)header);
+			break;
+		}
+
+		nr++;
+		offset += ppdu_length;
+	}
+
+out:
+	*ppdus_nr = nr;
+
 	return status;
 }
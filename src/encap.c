@@ -33,6 +33,8 @@
 #include "rle_header_proto_type_field.h"
 #include "rle.h"
 #include "fragmentation_buffer.h"
+#include "rle_trace.h"
+#include "rle_tx_pipe.h"
 
 #ifndef __KERNEL__
 
@@ -44,6 +46,7 @@
 #else
 
 #include <linux/types.h>
+#include <linux/prefetch.h>
 
 #endif
 
@@ -54,6 +57,11 @@
 
 #define MODULE_ID RLE_MOD_ID_ENCAP
 
+#ifndef __KERNEL__
+/** Prefetch memory that is about to be written, as the kernel helper does */
+#define prefetchw(addr) __builtin_prefetch((addr), 1)
+#endif
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
@@ -69,82 +77,360 @@ static void set_nonfree_frag_ctx(struct rle_transmitter *const _this, const size
 	rle_ctx_set_nonfree(&_this->free_ctx, ctx_index);
 }
 
+/**
+ * @brief         Choose the ALPDU trailer of a SDU, from the configuration or the protection
+ *                policy.
+ *
+ * @param[in]     _this                   The transmitter module.
+ * @param[in]     sdu_size                The size of the SDU.
+ *
+ * @return        true if the ALPDU is protected by a CRC, false by a sequence number.
+ */
+static bool use_alpdu_crc(const struct rle_transmitter *const _this, const size_t sdu_size)
+{
+	const struct rle_protection_policy *const policy = &_this->protection;
+	/* the ALPDU header is not pushed yet, estimated with an uncompressed protocol type */
+	const size_t alpdu_len = sdu_size + RLE_PROTO_TYPE_FIELD_SIZE_UNCOMP;
+	size_t ppdus_nr;
 
-/*------------------------------------------------------------------------------------------------*/
-/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
-/*------------------------------------------------------------------------------------------------*/
+	if (!_this->protection_auto) {
+		return (_this->conf.allow_alpdu_sequence_number == 0 && _this->conf.allow_alpdu_crc == 1);
+	}
 
-enum rle_encap_status rle_encapsulate(struct rle_transmitter *const transmitter,
-                                      const struct rle_sdu *const sdu,
-                                      const uint8_t frag_id)
+	/* a COMPLETE PPDU has no trailer, the sequence number is only pushed if it is fragmented */
+	if (alpdu_len + sizeof(rle_ppdu_hdr_comp_t) <= policy->burst_size) {
+		return false;
+	}
+	ppdus_nr = 1 + (alpdu_len + RLE_SEQ_NO_FIELD_SIZE -
+	                (policy->burst_size - sizeof(rle_ppdu_hdr_start_t)) +
+	                policy->burst_size - sizeof(rle_ppdu_hdr_cont_end_t) - 1) /
+	           (policy->burst_size - sizeof(rle_ppdu_hdr_cont_end_t));
+
+	return (ppdus_nr > policy->seqnum_ppdus_max ||
+	        (uint64_t)ppdus_nr * policy->ppdu_loss_ppm > policy->sdu_loss_ppm_max);
+}
+
+/**
+ * @brief         Push the ALPDU header of the SDU of a fragmentation buffer, timing it and counting
+ *                the move of the VLAN header whose protocol type is omitted and the protocol type
+ *                of the SDU.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in,out] frag_buf                The fragmentation buffer.
+ */
+static void encap_push_alpdu_hdr(struct rle_transmitter *const transmitter,
+                                 struct rle_frag_buf *const frag_buf)
+{
+#ifdef RLE_COPY_STATS
+	const ssize_t sdu_len = frag_buf_get_sdu_len(frag_buf);
+#endif
+	uint64_t *const ptype_count =
+		&transmitter->ptype_mix[rle_ptype_get_class(frag_buf->sdu_info.protocol_type)];
+
+	/* single writer, the mix is read by rle_transmitter_suggest_implicit_ptype() */
+	__atomic_store_n(ptype_count, *ptype_count + 1, __ATOMIC_RELAXED);
+
+	rle_timing_run(&transmitter->timing, RLE_TIMING_ALPDU_HDR,
+	               push_alpdu_hdr(frag_buf, &transmitter->ptype_table));
+
+#ifdef RLE_COPY_STATS
+	/* the SDU only shrinks when the VLAN header is moved over its protocol type */
+	if (frag_buf_get_sdu_len(frag_buf) < sdu_len) {
+		rle_copy_count(&transmitter->copy_stats, RLE_COPY_ALPDU_HDR,
+		               sizeof(struct ether_header) + sizeof(struct vlan_hdr) - sizeof(uint16_t),
+		               0);
+	}
+#endif
+}
+
+
+/**
+ * @brief         Encapsulate a SDU in the context of the transmitter, either gathering it from
+ *                segments or in place.
+ *
+ *                The transmitter is not checked, and the configuration decisions shared by all
+ *                the SDUs are given by the caller.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     sdu                     The RLE Service data unit to encapsulate. Its buffer is
+ *                                        only used in place, else only its size and protocol type.
+ * @param[in]     segments                The segments to gather, whose sizes sum up to the SDU size.
+ *                                        NULL to use the SDU memory in place of the context buffer,
+ *                                        the caller checked its headroom and tailroom.
+ * @param[in]     segments_nr             The number of segments.
+ * @param[in]     frag_id                 Identify the context to which belongs the datas to encap.
+ *
+ * @return        Encapsulation status.
+ */
+static enum rle_encap_status encapsulate_sdu_in_ctx(struct rle_transmitter *const transmitter,
+                                                    const struct rle_sdu *const sdu,
+                                                    const struct rle_sdu_segment segments[],
+                                                    const size_t segments_nr,
+                                                    const uint8_t frag_id)
 {
 	enum rle_encap_status status = RLE_ENCAP_ERR;
 	enum rle_encap_status ret_encap;
 	struct rle_ctx_mngt *rle_ctx;
+	rle_frag_buf_t **frag_buf_slot;
 	rle_frag_buf_t *frag_buf;
+	bool queued = false;
 	int ret;
 
-#ifdef TIME_DEBUG
-	struct timeval tv_start = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_end = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_delta;
-	gettimeofday(&tv_start, NULL);
-#endif
-
-	if (transmitter == NULL) {
-		status = RLE_ENCAP_ERR_NULL_TRMT;
-		goto out;
-	}
-
-	if (sdu == NULL || frag_id >= RLE_MAX_FRAG_NUMBER) {
+	if (sdu == NULL || frag_id >= transmitter->contexts_nr) {
 		goto out;
 	}
-	RLE_DEBUG("encapsulate one %zu-byte SDU in context with ID %u", sdu->size, frag_id);
+	RLE_DEBUG_TO(&transmitter->log_sink,
+	             "encapsulate one %zu-byte SDU in context with ID %u", sdu->size, frag_id);
 
 	rle_ctx = &transmitter->rle_ctx_man[frag_id];
-	frag_buf = (rle_frag_buf_t *)rle_ctx->buff;
 
 	if (sdu->size <= 0 || sdu->size > RLE_MAX_PDU_SIZE) {
 		status = RLE_ENCAP_ERR_SDU_TOO_BIG;
+		if (!is_frag_ctx_free(transmitter, frag_id)) {
+			/* the SDU of the context is dropped */
+			rle_transmitter_backlog_update(transmitter, frag_id,
+			                               frag_buf_get_remaining_alpdu_length(rle_ctx->buff), 0);
+		}
 		rle_transmitter_free_context(transmitter, frag_id);
 		goto out;
 	}
 
-	if (is_frag_ctx_free(transmitter, frag_id) == false) {
-		RLE_ERR("frag id %d is not free", frag_id);
-		goto out;
+	if (is_frag_ctx_free(transmitter, frag_id)) {
+		frag_buf_slot = (rle_frag_buf_t **)&rle_ctx->buff;
+	} else {
+		/* the SDU waits behind the current one in the queue of the context, if any */
+		frag_buf_slot = rle_transmitter_queue_tail(transmitter, frag_id);
+		if (frag_buf_slot == NULL) {
+			RLE_ERR_TO(&transmitter->log_sink, "frag id %d is not free", frag_id);
+			goto out;
+		}
+		queued = true;
 	}
 
-	/* set to 'used' the previously free frag context */
-	set_nonfree_frag_ctx(transmitter, frag_id);
+	/* the buffer is sized for the SDUs carried, an in-place SDU only needs the bookkeeping */
+	if (frag_buf_reserve(frag_buf_slot, segments == NULL ? 0 : sdu->size,
+	                     &transmitter->allocator)) {
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "failed to allocate the buffer of context with ID %u", frag_id);
+		goto out;
+	}
+	frag_buf = *frag_buf_slot;
 
-	ret = rle_frag_buf_init(frag_buf);
-	assert(ret == 0); /* cannot fail since frag_buf is not NULL */
+	if (!queued) {
+		/* set to 'used' the previously free frag context */
+		set_nonfree_frag_ctx(transmitter, frag_id);
+	}
 
-	ret = rle_frag_buf_cpy_sdu(frag_buf, sdu);
-	assert(ret == 0); /* cannot fail since SDU length was already checked */
+	if (segments == NULL) {
+		ret = frag_buf_set_sdu_in_place(frag_buf, sdu);
+		assert(ret == 0); /* cannot fail since SDU length was already checked */
+
+		ret_encap = rle_encap_contextless(transmitter, frag_buf);
+		assert(ret_encap == RLE_ENCAP_OK); /* no way to fail here */
+	} else {
+		ret = rle_frag_buf_init(frag_buf);
+		assert(ret == 0); /* cannot fail since frag_buf is not NULL */
+
+		/* the CRC, if any, is computed during the copy, so that the SDU is read only once */
+		frag_buf->use_crc = use_alpdu_crc(transmitter, sdu->size);
+		rle_timing_run(&transmitter->timing, RLE_TIMING_SDU_COPY,
+		               ret = frag_buf_gather_sdu(frag_buf, segments, segments_nr,
+		                                         sdu->protocol_type, frag_buf->use_crc));
+		assert(ret == 0); /* cannot fail since SDU length was already checked */
+		rle_copy_count(&transmitter->copy_stats, RLE_COPY_SDU, sdu->size,
+		               frag_buf->use_crc ? sdu->size : 0);
+
+		encap_push_alpdu_hdr(transmitter, frag_buf);
+	}
 
-	ret_encap = rle_encap_contextless(transmitter, frag_buf);
-	assert(ret_encap == RLE_ENCAP_OK); /* no way to fail here */
+	if (queued) {
+		rle_transmitter_queue_push(transmitter, frag_id);
+	}
+	rle_transmitter_backlog_update(transmitter, frag_id, 0,
+	                               frag_buf_get_remaining_alpdu_length(frag_buf));
 
 	rle_ctx_incr_counter_in(rle_ctx);
 	rle_ctx_incr_counter_bytes_in(rle_ctx, sdu->size);
-
-#ifdef TIME_DEBUG
-	gettimeofday(&tv_end, NULL);
-	tv_delta.tv_sec = tv_end.tv_sec - tv_start.tv_sec;
-	tv_delta.tv_usec = tv_end.tv_usec - tv_start.tv_usec;
-	RLE_DEBUG("duration [%04ld.%06ld]\n", tv_delta.tv_sec, tv_delta.tv_usec);
-#endif
+	rle_trace(sdu_enqueued, frag_id, sdu->size, sdu->protocol_type);
 
 	status = RLE_ENCAP_OK;
-	RLE_DEBUG("%zu-byte SDU successfully encapsulated in context with ID %u",
-	          sdu->size, frag_id);
+	RLE_DEBUG_TO(&transmitter->log_sink,
+	             "%zu-byte SDU successfully encapsulated in context with ID %u",
+	             sdu->size, frag_id);
 
 out:
 	return status;
 }
 
+/**
+ * @brief         Encapsulate a SDU in the context of the transmitter, either gathering it from
+ *                segments or in place.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in]     sdu                     The RLE Service data unit to encapsulate.
+ * @param[in]     segments                The segments to gather, see encapsulate_sdu_in_ctx().
+ * @param[in]     segments_nr             The number of segments.
+ * @param[in]     frag_id                 Identify the context to which belongs the datas to encap.
+ *
+ * @return        Encapsulation status.
+ */
+static enum rle_encap_status encapsulate_sdu(struct rle_transmitter *const transmitter,
+                                             const struct rle_sdu *const sdu,
+                                             const struct rle_sdu_segment segments[],
+                                             const size_t segments_nr,
+                                             const uint8_t frag_id)
+{
+	enum rle_encap_status status;
+
+	if (transmitter == NULL) {
+		status = RLE_ENCAP_ERR_NULL_TRMT;
+		goto out;
+	}
+
+	status = encapsulate_sdu_in_ctx(transmitter, sdu, segments, segments_nr, frag_id);
+
+out:
+	return status;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+enum rle_encap_status rle_encapsulate(struct rle_transmitter *const transmitter,
+                                      const struct rle_sdu *const sdu,
+                                      const uint8_t frag_id)
+{
+	struct rle_sdu_segment segment = { .buffer = NULL, .size = 0 };
+
+	if (sdu != NULL) {
+		segment.buffer = sdu->buffer;
+		segment.size = sdu->size;
+	}
+
+	return encapsulate_sdu(transmitter, sdu, &segment, 1, frag_id);
+}
+
+enum rle_encap_status rle_encapsulate_auto(struct rle_transmitter *const transmitter,
+                                           const struct rle_sdu *const sdu,
+                                           const uint8_t traffic_class,
+                                           uint8_t *const frag_id)
+{
+	struct rle_sdu_segment segment = { .buffer = NULL, .size = 0 };
+
+	if (transmitter == NULL) {
+		return RLE_ENCAP_ERR_NULL_TRMT;
+	}
+
+	if (sdu == NULL || frag_id == NULL || traffic_class >= RLE_TRAFFIC_CLASSES_NR) {
+		return RLE_ENCAP_ERR;
+	}
+
+	if (!rle_transmitter_pick_free_context(transmitter, traffic_class, frag_id)) {
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "no context available in traffic class %u", traffic_class);
+		return RLE_ENCAP_ERR;
+	}
+
+	segment.buffer = sdu->buffer;
+	segment.size = sdu->size;
+
+	return encapsulate_sdu(transmitter, sdu, &segment, 1, *frag_id);
+}
+
+enum rle_encap_status rle_encapsulate_zero_copy(struct rle_transmitter *const transmitter,
+                                                const struct rle_sdu *const sdu,
+                                                const size_t headroom,
+                                                const size_t tailroom,
+                                                const uint8_t frag_id)
+{
+	if (headroom < RLE_ENCAP_HEADROOM || tailroom < RLE_ENCAP_TAILROOM) {
+		RLE_ERR("%zu octets of headroom and %zu octets of tailroom, at least %d and %d required",
+		        headroom, tailroom, RLE_ENCAP_HEADROOM, RLE_ENCAP_TAILROOM);
+		return RLE_ENCAP_ERR_NO_ROOM;
+	}
+
+	return encapsulate_sdu(transmitter, sdu, NULL, 0, frag_id);
+}
+
+enum rle_encap_status rle_encapsulate_segments(struct rle_transmitter *const transmitter,
+                                               const struct rle_sdu_segment segments[],
+                                               const size_t segments_nr,
+                                               const uint16_t protocol_type,
+                                               const uint8_t frag_id)
+{
+	struct rle_sdu sdu = {
+		.buffer = NULL,
+		.size = 0,
+		.protocol_type = protocol_type
+	};
+	size_t seg;
+
+	if (segments == NULL) {
+		if (transmitter == NULL) {
+			return RLE_ENCAP_ERR_NULL_TRMT;
+		}
+		return RLE_ENCAP_ERR;
+	}
+
+	for (seg = 0; seg < segments_nr; seg++) {
+		sdu.size += segments[seg].size;
+	}
+
+	return encapsulate_sdu(transmitter, &sdu, segments, segments_nr, frag_id);
+}
+
+size_t rle_encapsulate_batch(struct rle_transmitter *const transmitter,
+                             const struct rle_sdu sdus[],
+                             const uint8_t frag_ids[],
+                             const size_t sdus_nr,
+                             enum rle_encap_status statuses[])
+{
+	size_t encapsulated_nr = 0;
+	size_t i;
+
+	if (statuses == NULL) {
+		goto out;
+	}
+
+	if (transmitter == NULL || sdus == NULL || frag_ids == NULL) {
+		const enum rle_encap_status status =
+			(transmitter == NULL ? RLE_ENCAP_ERR_NULL_TRMT : RLE_ENCAP_ERR);
+
+		for (i = 0; i < sdus_nr; i++) {
+			statuses[i] = status;
+		}
+		goto out;
+	}
+
+	RLE_DEBUG_TO(&transmitter->log_sink, "encapsulate a batch of %zu SDUs", sdus_nr);
+
+	for (i = 0; i < sdus_nr; i++) {
+		const struct rle_sdu_segment segment = {
+			.buffer = sdus[i].buffer,
+			.size = sdus[i].size
+		};
+
+		/* warm up the buffer of the next context while the current SDU is copied */
+		if ((i + 1) < sdus_nr && frag_ids[i + 1] < transmitter->contexts_nr &&
+		    transmitter->rle_ctx_man[frag_ids[i + 1]].buff != NULL) {
+			const rle_frag_buf_t *const next_frag_buf =
+				(rle_frag_buf_t *)transmitter->rle_ctx_man[frag_ids[i + 1]].buff;
+
+			prefetchw(next_frag_buf);
+			prefetchw(next_frag_buf->buffer + sizeof(rle_ppdu_hdr_t) + sizeof(rle_alpdu_hdr_t));
+		}
+
+		statuses[i] = encapsulate_sdu_in_ctx(transmitter, &sdus[i], &segment, 1, frag_ids[i]);
+		if (statuses[i] == RLE_ENCAP_OK) {
+			encapsulated_nr++;
+		}
+	}
+
+out:
+	return encapsulated_nr;
+}
+
 enum rle_encap_status rle_encap_contextless(struct rle_transmitter *const transmitter,
                                             struct rle_frag_buf *const frag_buf)
 {
@@ -165,14 +451,83 @@ enum rle_encap_status rle_encap_contextless(struct rle_transmitter *const transm
 		goto out;
 	}
 
-	if (transmitter->conf.allow_alpdu_sequence_number == 0 &&
-	    transmitter->conf.allow_alpdu_crc == 1) {
-		frag_buf->crc = compute_crc32(&frag_buf->sdu_info);
+	if (frag_buf->mem_start == frag_buf->buffer) {
+		/* the SDU was copied in the buffer by rle_frag_buf_cpy_sdu() or its segments variant,
+		 * not given in place */
+		rle_copy_count(&transmitter->copy_stats, RLE_COPY_SDU, frag_buf->sdu_info.size, 0);
 	}
 
-	push_alpdu_hdr(frag_buf, &transmitter->conf);
+	frag_buf->use_crc = use_alpdu_crc(transmitter, frag_buf->sdu_info.size);
+	if (frag_buf->use_crc) {
+		rle_timing_run(&transmitter->timing, RLE_TIMING_CRC,
+		               frag_buf->crc = compute_crc32(&frag_buf->sdu_info));
+		rle_copy_count(&transmitter->copy_stats, RLE_COPY_CRC, 0, frag_buf->sdu_info.size);
+	}
+
+	encap_push_alpdu_hdr(transmitter, frag_buf);
 	status = RLE_ENCAP_OK;
 
 out:
 	return status;
 }
+
+enum rle_encap_status rle_tx_pipe_encapsulate(struct rle_tx_pipe *const pipe,
+                                              const struct rle_sdu *const sdu,
+                                              const uint8_t frag_id)
+{
+	struct rle_transmitter *transmitter;
+	struct rle_sdu_segment segment;
+	struct rle_tx_pipe_slot *slot;
+	bool with_crc;
+	size_t tail;
+	int ret;
+
+	if (pipe == NULL) {
+		return RLE_ENCAP_ERR_NULL_TRMT;
+	}
+	transmitter = pipe->transmitter;
+
+	if (sdu == NULL || frag_id >= transmitter->contexts_nr) {
+		return RLE_ENCAP_ERR;
+	}
+	if (sdu->size <= 0 || sdu->size > RLE_MAX_PDU_SIZE) {
+		return RLE_ENCAP_ERR_SDU_TOO_BIG;
+	}
+
+	/* the slots given back by the fragmentation stage are seen with their buffers */
+	tail = pipe->tail;
+	if ((tail - __atomic_load_n(&pipe->head, __ATOMIC_ACQUIRE)) > pipe->slots_mask) {
+		return RLE_ENCAP_ERR_PIPE_FULL;
+	}
+	slot = &pipe->slots[tail & pipe->slots_mask];
+
+	if (frag_buf_reserve(&slot->frag_buf, sdu->size, &transmitter->allocator)) {
+		RLE_ERR_TO(&transmitter->log_sink, "failed to allocate the buffer of a pipe slot");
+		return RLE_ENCAP_ERR;
+	}
+
+	ret = rle_frag_buf_init(slot->frag_buf);
+	assert(ret == 0); /* cannot fail since frag_buf is not NULL */
+
+	/* the ALPDU is contextless until dispatched, the CRC is computed during the copy */
+	segment.buffer = sdu->buffer;
+	segment.size = sdu->size;
+	with_crc = use_alpdu_crc(transmitter, sdu->size);
+	slot->frag_buf->use_crc = with_crc;
+	rle_timing_run(&transmitter->timing, RLE_TIMING_SDU_COPY,
+	               ret = frag_buf_gather_sdu(slot->frag_buf, &segment, 1, sdu->protocol_type,
+	                                         with_crc));
+	assert(ret == 0); /* cannot fail since SDU length was already checked */
+	rle_copy_count(&transmitter->copy_stats, RLE_COPY_SDU, sdu->size, with_crc ? sdu->size : 0);
+
+	encap_push_alpdu_hdr(transmitter, slot->frag_buf);
+	slot->frag_id = frag_id;
+
+	/* the ALPDU is complete before it is published to the fragmentation stage */
+	__atomic_store_n(&pipe->tail, tail + 1, __ATOMIC_RELEASE);
+	RLE_DEBUG_TO(&transmitter->log_sink,
+	             "%zu-byte SDU encapsulated in the pipe for context with ID %u", sdu->size,
+	             frag_id);
+
+	return RLE_ENCAP_OK;
+}
@@ -34,6 +34,8 @@
 #include "rle_ctx.h"
 #include "crc.h"
 #include "rle_header_proto_type_field.h"
+#include "rle_trace.h"
+#include "rle_copy_stats.h"
 
 #include "rle.h"
 
@@ -46,6 +48,7 @@
 
 #include <linux/stddef.h>
 #include <linux/types.h>
+#include <linux/string.h>
 
 #endif
 
@@ -71,13 +74,15 @@ enum rle_frag_status rle_fragment(struct rle_transmitter *const transmitter,
 
 	rle_frag_buf_t *frag_buf;
 	struct rle_ctx_mngt *rle_ctx;
+	size_t alpdu_len;
+	bool pushed;
 
 	if (transmitter == NULL) {
 		status = RLE_FRAG_ERR_NULL_TRMT;
 		goto out;
 	}
 
-	if (frag_id >= RLE_MAX_FRAG_NUMBER || ppdu == NULL || ppdu_length == NULL) {
+	if (frag_id >= transmitter->contexts_nr || ppdu == NULL || ppdu_length == NULL) {
 		goto out;
 	}
 
@@ -92,10 +97,14 @@ enum rle_frag_status rle_fragment(struct rle_transmitter *const transmitter,
 	}
 
 	frag_buf = (rle_frag_buf_t *)rle_ctx->buff;
+	alpdu_len = frag_buf_get_remaining_alpdu_length(frag_buf);
 
 	frag_buf_ppdu_init(frag_buf);
 
-	if (!push_ppdu_hdr(frag_buf, &transmitter->conf, remaining_burst_size, rle_ctx)) {
+	rle_timing_run(&transmitter->timing, RLE_TIMING_PPDU_HDR,
+	               pushed = transmitter->push_ppdu_hdr(frag_buf, &transmitter->conf,
+	                                                   remaining_burst_size, rle_ctx));
+	if (!pushed) {
 		/* Burst to small for header. */
 		status = RLE_FRAG_ERR_BURST_TOO_SMALL;
 		goto out;
@@ -108,7 +117,15 @@ enum rle_frag_status rle_fragment(struct rle_transmitter *const transmitter,
 	 * a CONT PPDU with 0 byte of payload may be confused with padding */
 	assert((*ppdu_length) > 2);
 
+	rle_trace(ppdu_emitted, frag_id, *ppdu_length, frag_buf_get_remaining_alpdu_length(frag_buf));
+	rle_size_ppdu(&rle_ctx->lk_status->size_stats);
+
+	/* the START PPDU pushes the trailer, the ALPDU may be longer once its first PPDU is sent */
+	rle_transmitter_backlog_update(transmitter, frag_id, alpdu_len,
+	                               frag_buf_get_remaining_alpdu_length(frag_buf));
+
 	if (frag_buf_get_remaining_alpdu_length(frag_buf) == 0) {
+		rle_size_sdu_end(&rle_ctx->lk_status->size_stats, (size_t)frag_buf_get_sdu_len(frag_buf));
 		rle_transmitter_free_context(transmitter, frag_id);
 		rle_ctx_incr_counter_ok(rle_ctx);
 	}
@@ -120,12 +137,122 @@ out:
 	return status;
 }
 
+enum rle_frag_status rle_fragment_next(struct rle_transmitter *const transmitter,
+                                       const size_t remaining_burst_size,
+                                       unsigned char *ppdu[],
+                                       size_t *const ppdu_length,
+                                       uint8_t *const frag_id)
+{
+	if (transmitter == NULL) {
+		return RLE_FRAG_ERR_NULL_TRMT;
+	}
+
+	if (frag_id == NULL) {
+		return RLE_FRAG_ERR;
+	}
+
+	if (!rle_transmitter_pick_next_context(transmitter, frag_id)) {
+		return RLE_FRAG_ERR_CONTEXT_IS_NULL;
+	}
+
+	return rle_fragment(transmitter, *frag_id, remaining_burst_size, ppdu, ppdu_length);
+}
+
+enum rle_frag_status rle_fragment_bursts(struct rle_transmitter *const transmitter,
+                                         const uint8_t frag_id,
+                                         const size_t burst_sizes[],
+                                         unsigned char *const bursts[],
+                                         const size_t bursts_nr,
+                                         struct rle_ppdu_desc ppdus[],
+                                         size_t *const ppdus_nr)
+{
+	enum rle_frag_status status = RLE_FRAG_ERR; /* Error by default. */
+	rle_frag_buf_t *frag_buf;
+	struct rle_ctx_mngt *rle_ctx;
+	size_t alpdu_len;
+	size_t bytes_ok = 0;
+	size_t i;
+
+	if (transmitter == NULL) {
+		status = RLE_FRAG_ERR_NULL_TRMT;
+		goto out;
+	}
+
+	if (frag_id >= transmitter->contexts_nr || burst_sizes == NULL || bursts == NULL ||
+	    ppdus == NULL || ppdus_nr == NULL) {
+		goto out;
+	}
+
+	*ppdus_nr = 0;
+
+	rle_ctx = &transmitter->rle_ctx_man[frag_id];
+
+	if (rle_ctx_is_free(transmitter->free_ctx, frag_id)) {
+		status = RLE_FRAG_ERR_CONTEXT_IS_NULL;
+		rle_transmitter_free_context(transmitter, frag_id);
+		goto out;
+	}
+
+	frag_buf = (rle_frag_buf_t *)rle_ctx->buff;
+	alpdu_len = frag_buf_get_remaining_alpdu_length(frag_buf);
+
+	status = RLE_FRAG_OK;
+	for (i = 0; i < bursts_nr && frag_buf_get_remaining_alpdu_length(frag_buf) > 0; i++) {
+		struct rle_ppdu_desc *const desc = &ppdus[i];
+		bool pushed;
+
+		frag_buf_ppdu_init(frag_buf);
+
+		rle_timing_run(&transmitter->timing, RLE_TIMING_PPDU_HDR,
+		               pushed = transmitter->push_ppdu_hdr(frag_buf, &transmitter->conf,
+		                                                   burst_sizes[i], rle_ctx));
+		if (!pushed) {
+			/* the ALPDU left is sent in the next bursts, with the next call */
+			status = RLE_FRAG_ERR_BURST_TOO_SMALL;
+			break;
+		}
+
+		/* copied out, as the header of the next PPDU is written over the end of this one */
+		desc->ppdu_length = frag_buf_get_current_ppdu_len(frag_buf);
+		assert(desc->ppdu_length > 2);
+		memcpy(bursts[i], frag_buf->ppdu.start, desc->ppdu_length);
+		desc->ppdu = bursts[i];
+		desc->status = RLE_FRAG_OK;
+		bytes_ok += desc->ppdu_length;
+		(*ppdus_nr)++;
+
+		rle_trace(ppdu_emitted, frag_id, desc->ppdu_length,
+		          frag_buf_get_remaining_alpdu_length(frag_buf));
+		rle_size_ppdu(&rle_ctx->lk_status->size_stats);
+	}
+
+	if (*ppdus_nr == 0) {
+		goto out;
+	}
+
+	/* the counters and the backlog are updated once for all the PPDUs */
+	rle_copy_count(&transmitter->copy_stats, RLE_COPY_PACK, bytes_ok, 0);
+	rle_transmitter_backlog_update(transmitter, frag_id, alpdu_len,
+	                               frag_buf_get_remaining_alpdu_length(frag_buf));
+
+	if (frag_buf_get_remaining_alpdu_length(frag_buf) == 0) {
+		rle_size_sdu_end(&rle_ctx->lk_status->size_stats, (size_t)frag_buf_get_sdu_len(frag_buf));
+		rle_transmitter_free_context(transmitter, frag_id);
+		rle_ctx_incr_counter_ok(rle_ctx);
+	}
+	rle_ctx_incr_counter_bytes_ok(rle_ctx, bytes_ok);
+
+out:
+	return status;
+}
+
 enum rle_frag_status rle_frag_contextless(struct rle_transmitter *const transmitter,
                                           struct rle_frag_buf *const frag_buf,
                                           unsigned char **const ppdu,
                                           size_t *const ppdu_length)
 {
 	enum rle_frag_status status = RLE_FRAG_ERR;
+	bool pushed;
 
 	if (!transmitter) {
 		status = RLE_FRAG_ERR_NULL_TRMT;
@@ -146,7 +273,7 @@ enum rle_frag_status rle_frag_contextless(struct rle_transmitter *const transmit
 		goto out;
 	}
 	if (!ppdu_length) {
-		RLE_ERR("No PPDU length provided");
+		RLE_ERR_TO(&transmitter->log_sink, "No PPDU length provided");
 		goto out;
 	}
 	if (*ppdu_length < sizeof(rle_ppdu_hdr_comp_t)) {
@@ -156,7 +283,10 @@ enum rle_frag_status rle_frag_contextless(struct rle_transmitter *const transmit
 
 	frag_buf_ppdu_init(frag_buf);
 
-	if (!push_ppdu_hdr(frag_buf, &transmitter->conf, *ppdu_length, NULL)) {
+	rle_timing_run(&transmitter->timing, RLE_TIMING_PPDU_HDR,
+	               pushed = transmitter->push_ppdu_hdr(frag_buf, &transmitter->conf, *ppdu_length,
+	                                                   NULL));
+	if (!pushed) {
 		goto out;
 	}
 
@@ -169,3 +299,58 @@ enum rle_frag_status rle_frag_contextless(struct rle_transmitter *const transmit
 out:
 	return status;
 }
+
+size_t rle_frag_contextless_batch(const struct rle_frag_conf *const frag_conf,
+                                  struct rle_frag_buf *const frag_bufs[],
+                                  const size_t frag_bufs_nr,
+                                  const size_t burst_size,
+                                  struct rle_ppdu_desc ppdus[])
+{
+	size_t ppdus_nr = 0;
+	size_t i;
+
+	if (!frag_conf || !frag_bufs || !ppdus) {
+		goto out;
+	}
+
+	for (i = 0; i < frag_bufs_nr; i++) {
+		struct rle_frag_buf *const frag_buf = frag_bufs[i];
+		struct rle_ppdu_desc *const desc = &ppdus[i];
+
+		desc->ppdu = NULL;
+		desc->ppdu_length = 0;
+
+		if (!frag_buf) {
+			desc->status = RLE_FRAG_ERR_NULL_F_BUFF;
+			continue;
+		}
+		if (!frag_buf_in_use(frag_buf)) {
+			desc->status = RLE_FRAG_ERR_N_INIT_F_BUFF;
+			continue;
+		}
+
+		/* only the configuration is read, the buffers belong to the calling thread */
+		push_alpdu_hdr(frag_buf, &frag_conf->ptype_table);
+
+		/* a COMPLETE PPDU or nothing, without context there is no START PPDU */
+		if (frag_buf_get_remaining_alpdu_length(frag_buf) + sizeof(rle_ppdu_hdr_comp_t) >
+		    burst_size) {
+			desc->status = RLE_FRAG_ERR_BURST_TOO_SMALL;
+			continue;
+		}
+
+		frag_buf_ppdu_init(frag_buf);
+		if (!frag_conf->push_ppdu_hdr(frag_buf, &frag_conf->conf, burst_size, NULL)) {
+			desc->status = RLE_FRAG_ERR;
+			continue;
+		}
+
+		desc->ppdu = frag_buf->ppdu.start;
+		desc->ppdu_length = frag_buf_get_current_ppdu_len(frag_buf);
+		desc->status = RLE_FRAG_OK;
+		ppdus_nr++;
+	}
+
+out:
+	return ppdus_nr;
+}
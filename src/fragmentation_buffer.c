@@ -29,6 +29,8 @@
 #include "rle.h"
 #include "constants.h"
 #include "fragmentation_buffer.h"
+#include "trailer.h"
+#include "crc.h"
 
 #ifndef __KERNEL__
 
@@ -57,25 +59,53 @@
 
 struct rle_frag_buf * rle_frag_buf_new(void)
 {
-	struct rle_frag_buf *frag_buf =
-		(struct rle_frag_buf *)MALLOC(sizeof(struct rle_frag_buf));
+	struct rle_allocator allocator;
 
-	if (!frag_buf) {
+	rle_get_allocator(&allocator);
+
+	return frag_buf_new_sized(RLE_MAX_PDU_SIZE, &allocator);
+}
+
+rle_frag_buf_t * frag_buf_new_sized(const size_t sdu_max_len,
+                                    const struct rle_allocator *const allocator)
+{
+	void *const mem = rle_alloc(allocator, frag_buf_get_size(sdu_max_len));
+
+	if (!mem) {
 		RLE_ERR("fragmentation buffer not allocated");
-		goto out;
+		return NULL;
 	}
 
+	return frag_buf_init_in_place(mem, sdu_max_len, allocator);
+}
+
+size_t frag_buf_get_size(const size_t sdu_max_len)
+{
+	return sizeof(struct rle_frag_buf) + sdu_max_len + RLE_F_BUFF_ROOM;
+}
+
+rle_frag_buf_t * frag_buf_init_in_place(void *const mem, const size_t sdu_max_len,
+                                        const struct rle_allocator *const allocator)
+{
+	struct rle_frag_buf *const frag_buf = (struct rle_frag_buf *)mem;
+
+	frag_buf->allocator = *allocator;
+	frag_buf->buffer_len = sdu_max_len + RLE_F_BUFF_ROOM;
 	frag_buf->sdu.frag_buf = frag_buf;
 	frag_buf->alpdu.frag_buf = frag_buf;
 	frag_buf->ppdu.frag_buf = frag_buf;
 
-out:
+	/* not in use until initialized, whatever the recycled memory holds */
+	frag_buf->sdu.start = NULL;
+	frag_buf->sdu.end = NULL;
 
 	return frag_buf;
 }
 
 void rle_frag_buf_del(struct rle_frag_buf **const frag_buf)
 {
+	struct rle_allocator allocator;
+
 	if (!frag_buf) {
 		RLE_WARN("fragmentation buffer pointer NULL, nothing can be done");
 		goto out;
@@ -86,7 +116,9 @@ void rle_frag_buf_del(struct rle_frag_buf **const frag_buf)
 		goto out;
 	}
 
-	FREE(*frag_buf);
+	/* the allocator is read before it is released with the buffer */
+	allocator = (*frag_buf)->allocator;
+	rle_free(&allocator, *frag_buf);
 	*frag_buf = NULL;
 
 out:
@@ -94,14 +126,34 @@ out:
 	return;
 }
 
+int rle_frag_buf_memory_footprint(const struct rle_frag_buf *const frag_buf,
+                                  struct rle_memory_footprint *const footprint)
+{
+	if (frag_buf == NULL || footprint == NULL) {
+		return 1;
+	}
+
+	memset(footprint, 0, sizeof(struct rle_memory_footprint));
+	if (!rle_allocator_is_caller(&frag_buf->allocator)) {
+		/* the buffer has a fixed size, given by its largest SDU */
+		footprint->bytes = frag_buf_get_size(frag_buf_get_sdu_max_len(frag_buf));
+		footprint->allocations = 1;
+		footprint->max_bytes = footprint->bytes;
+	}
+
+	return 0;
+}
+
 int rle_frag_buf_init(struct rle_frag_buf *const frag_buf)
 {
 	if (frag_buf == NULL) {
 		return 1;
 	}
 
-	memset(frag_buf->buffer, '\0', RLE_F_BUFF_LEN);
+	memset(frag_buf->buffer, '\0', frag_buf->buffer_len);
 
+	frag_buf->mem_start = frag_buf->buffer;
+	frag_buf->mem_end = frag_buf->buffer + frag_buf->buffer_len;
 	frag_buf->cur_pos = frag_buf->buffer + sizeof(rle_ppdu_hdr_t) + sizeof(rle_alpdu_hdr_t);
 
 	frag_buf_ptrs_set(&frag_buf->sdu, frag_buf->cur_pos);
@@ -113,7 +165,7 @@ int rle_frag_buf_init(struct rle_frag_buf *const frag_buf)
 
 int rle_frag_buf_cpy_sdu(struct rle_frag_buf *const frag_buf, const struct rle_sdu *const sdu)
 {
-	if (sdu->size > RLE_MAX_PDU_SIZE || frag_buf_in_use(frag_buf)) {
+	if (sdu->size > frag_buf_get_sdu_max_len(frag_buf) || frag_buf_in_use(frag_buf)) {
 		return 1;
 	}
 
@@ -127,6 +179,120 @@ int rle_frag_buf_cpy_sdu(struct rle_frag_buf *const frag_buf, const struct rle_s
 	return 0;
 }
 
+int frag_buf_reserve(rle_frag_buf_t **const frag_buf, const size_t sdu_len,
+                     const struct rle_allocator *const allocator)
+{
+	rle_frag_buf_t *new_frag_buf;
+	size_t sdu_max_len = RLE_F_BUFF_MIN_SDU_LEN;
+
+	assert(sdu_len <= RLE_MAX_PDU_SIZE);
+
+	if ((*frag_buf) != NULL && frag_buf_get_sdu_max_len(*frag_buf) >= sdu_len) {
+		return 0;
+	}
+
+	while (sdu_max_len < sdu_len) {
+		sdu_max_len <<= 1;
+	}
+	if (sdu_max_len > RLE_MAX_PDU_SIZE) {
+		sdu_max_len = RLE_MAX_PDU_SIZE;
+	}
+
+	new_frag_buf = frag_buf_new_sized(sdu_max_len, allocator);
+	if (new_frag_buf == NULL) {
+		return 1;
+	}
+
+	if ((*frag_buf) != NULL) {
+		rle_frag_buf_del(frag_buf);
+	}
+	*frag_buf = new_frag_buf;
+
+	return 0;
+}
+
+int frag_buf_set_sdu_in_place(rle_frag_buf_t *const frag_buf, const struct rle_sdu *const sdu)
+{
+	if (sdu->size > RLE_MAX_PDU_SIZE) {
+		return 1;
+	}
+
+	frag_buf->mem_start = sdu->buffer - RLE_ENCAP_HEADROOM;
+	frag_buf->mem_end = sdu->buffer + sdu->size + RLE_ENCAP_TAILROOM;
+	frag_buf->cur_pos = sdu->buffer;
+
+	frag_buf_ptrs_set(&frag_buf->sdu, frag_buf->cur_pos);
+	frag_buf_ptrs_set(&frag_buf->alpdu, frag_buf->cur_pos);
+	frag_buf_ptrs_set(&frag_buf->ppdu, frag_buf->cur_pos);
+
+	frag_buf_sdu_put(frag_buf, sdu->size);
+	frag_buf->sdu_info.buffer = frag_buf->sdu.start;
+	frag_buf->sdu_info.protocol_type = sdu->protocol_type;
+	frag_buf->sdu_info.size = sdu->size;
+
+	return 0;
+}
+
+int frag_buf_gather_sdu(rle_frag_buf_t *const frag_buf,
+                        const struct rle_sdu_segment segments[],
+                        const size_t segments_nr,
+                        const uint16_t protocol_type,
+                        const bool with_crc)
+{
+	unsigned char *dst;
+	uint32_t crc = 0;
+	size_t sdu_len = 0;
+	size_t seg;
+
+	for (seg = 0; seg < segments_nr; seg++) {
+		sdu_len += segments[seg].size;
+	}
+
+	if (sdu_len > frag_buf_get_sdu_max_len(frag_buf) || frag_buf_in_use(frag_buf)) {
+		return 1;
+	}
+
+	frag_buf_sdu_put(frag_buf, sdu_len);
+	frag_buf->sdu_info.buffer = frag_buf->sdu.start;
+	frag_buf->sdu_info.protocol_type = protocol_type;
+	frag_buf->sdu_info.size = sdu_len;
+
+	if (with_crc) {
+		crc = compute_crc32_ptype(protocol_type);
+	}
+
+	dst = frag_buf->sdu.start;
+	for (seg = 0; seg < segments_nr; seg++) {
+		if (segments[seg].size == 0) {
+			continue;
+		}
+		if (with_crc) {
+			crc = compute_crc_cpy(dst, segments[seg].buffer, segments[seg].size, crc);
+		} else {
+			memcpy(dst, segments[seg].buffer, segments[seg].size);
+		}
+		dst += segments[seg].size;
+	}
+
+	if (with_crc) {
+		frag_buf->crc = crc;
+	}
+
+	return 0;
+}
+
+int rle_frag_buf_cpy_sdu_segments(struct rle_frag_buf *const frag_buf,
+                                  const struct rle_sdu_segment segments[],
+                                  const size_t segments_nr,
+                                  const uint16_t protocol_type)
+{
+	if (frag_buf == NULL || (segments == NULL && segments_nr > 0)) {
+		return 1;
+	}
+
+	return frag_buf_gather_sdu(frag_buf, segments, segments_nr, protocol_type, false);
+}
+
 void frag_buf_sdu_push(rle_frag_buf_t *const frag_buf, const ssize_t size)
 {
 	frag_buf_ptrs_push(&frag_buf->sdu, size);
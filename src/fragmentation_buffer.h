@@ -32,6 +32,7 @@
 #include "rle.h"
 
 #include "constants.h"
+#include "rle_allocator.h"
 #include "header.h"
 #include "trailer.h"
 
@@ -41,10 +42,15 @@
 /*------------------------------------------------------------------------------------------------*/
 #define MODULE_ID RLE_MOD_ID_FRAGMENTATION_BUFFER
 
+/** Room of a fragmentation buffer around the SDU, for the PPDU, ALPDU headers and trailer. */
+#define RLE_F_BUFF_ROOM \
+	(sizeof(rle_ppdu_hdr_t) + sizeof(rle_alpdu_hdr_t) + sizeof(rle_alpdu_trailer_t))
+
 /** Maximum size for a fragmentation buffer. */
-#define RLE_F_BUFF_LEN \
-	(sizeof(rle_ppdu_hdr_t) + sizeof(rle_alpdu_hdr_t) + \
-	 (RLE_MAX_PDU_SIZE) + sizeof(rle_alpdu_trailer_t))
+#define RLE_F_BUFF_LEN ((RLE_MAX_PDU_SIZE) + RLE_F_BUFF_ROOM)
+
+/** Smallest SDU size a fragmentation buffer sized on demand is allocated for. */
+#define RLE_F_BUFF_MIN_SDU_LEN 128
 
 
 /*------------------------------------------------------------------------------------------------*/
@@ -93,6 +99,9 @@ typedef struct fragmentation_buffer_ptrs frag_buf_ptrs_t;
  *          start     start     start      end       end alpdu
  *          ppdu      alpdu      sdu       sdu       end ppdu
  *
+ * In zero-copy mode, the same layout is used in the memory given by the caller around its SDU
+ * instead of the buffer itself.
+ *
  */
 struct rle_frag_buf;
 
@@ -113,13 +122,22 @@ struct fragmentation_buffer_ptrs {
 
 /** Fragmentation buffer implementation. */
 struct rle_frag_buf {
-	unsigned char buffer[RLE_F_BUFF_LEN]; /** Buffer itself.                                     */
+	/* read and written on each PPDU, in the first cache line */
 	unsigned char *cur_pos;               /** Current position.                                  */
-	struct rle_sdu sdu_info;              /** RLE SDU struct used without buffer to store infos. */
-	uint32_t crc;                         /**< The computed CRC if needed */
-	frag_buf_ptrs_t sdu;                  /** SDU after copying it.                              */
 	frag_buf_ptrs_t alpdu;                /** ALPDU after encapsulation.                         */
 	frag_buf_ptrs_t ppdu;                 /** PPDU after each fragmentation.                     */
+	uint32_t crc;                         /**< The computed CRC if needed */
+	uint8_t ppdu_label;                   /**< Label bits of its COMPLETE/START PPDU headers */
+	bool use_crc;                         /**< Whether the ALPDU trailer is a CRC, else seqnum */
+	/* read and written on each SDU */
+	frag_buf_ptrs_t sdu;                  /** SDU after copying it.                              */
+	struct rle_sdu sdu_info;              /** RLE SDU struct used without buffer to store infos. */
+	unsigned char *mem_start;             /** Start of the memory in use, buffer or caller's.    */
+	unsigned char *mem_end;               /** End of the memory in use, buffer or caller's.      */
+	/* read when the buffer is reserved or released */
+	struct rle_allocator allocator;       /** Allocator of the fragmentation buffer.             */
+	size_t buffer_len;                    /** Size of the buffer itself.                         */
+	unsigned char buffer[];               /** Buffer itself.                                     */
 };
 
 
@@ -204,6 +222,106 @@ static void frag_buf_ptrs_put(frag_buf_ptrs_t *const ptrs, const size_t size);
  */
 void frag_buf_sdu_push(rle_frag_buf_t *const frag_buf, const ssize_t size);
 
+/**
+ * @brief         Create a new fragmentation buffer for SDUs up to the given size.
+ *
+ * @param[in]     sdu_max_len              The size of the largest SDU the buffer may hold, up to
+ *                                         RLE_MAX_PDU_SIZE.
+ * @param[in]     allocator                The allocator of the buffer, kept to release it.
+ *
+ * @return        The fragmentation buffer if OK, else NULL.
+ *
+ * @ingroup       RLE Fragmentation buffer.
+ */
+rle_frag_buf_t * frag_buf_new_sized(const size_t sdu_max_len,
+                                    const struct rle_allocator *const allocator);
+
+/**
+ * @brief         Get the size of the memory of a fragmentation buffer for SDUs up to the given size.
+ *
+ * @param[in]     sdu_max_len              The size of the largest SDU the buffer may hold, up to
+ *                                         RLE_MAX_PDU_SIZE.
+ *
+ * @return        The size of the memory, in bytes.
+ *
+ * @ingroup       RLE Fragmentation buffer.
+ */
+size_t frag_buf_get_size(const size_t sdu_max_len);
+
+/**
+ * @brief         Create a fragmentation buffer for SDUs up to the given size in caller memory.
+ *
+ * @param[in,out] mem                      The memory, at least frag_buf_get_size() bytes long and
+ *                                         suitably aligned for any type.
+ * @param[in]     sdu_max_len              The size of the largest SDU the buffer may hold, up to
+ *                                         RLE_MAX_PDU_SIZE.
+ * @param[in]     allocator                The allocator of the memory, kept to release it.
+ *
+ * @return        The fragmentation buffer.
+ *
+ * @ingroup       RLE Fragmentation buffer.
+ */
+rle_frag_buf_t * frag_buf_init_in_place(void *const mem, const size_t sdu_max_len,
+                                        const struct rle_allocator *const allocator);
+
+/**
+ * @brief         Make sure a fragmentation buffer, not in use, may hold an SDU of the given size.
+ *
+ *                The buffer is allocated if there is none, or replaced by a larger one if it is too
+ *                small, the size of the SDUs being rounded up to the next power of two, so that a
+ *                context grows only a few times. The buffer shall be initialized afterwards.
+ *
+ * @param[in,out] frag_buf                 The fragmentation buffer, may be NULL.
+ * @param[in]     sdu_len                  The size of the SDU, up to RLE_MAX_PDU_SIZE.
+ * @param[in]     allocator                The allocator of a new buffer.
+ *
+ * @return        0 if OK, else 1, the buffer being left unchanged.
+ *
+ * @ingroup       RLE Fragmentation buffer.
+ */
+int frag_buf_reserve(rle_frag_buf_t **const frag_buf, const size_t sdu_len,
+                     const struct rle_allocator *const allocator);
+
+/**
+ * @brief         Use the memory of an SDU and its headroom and tailroom in place of the
+ *                fragmentation buffer, without copy.
+ *
+ *                The ALPDU header and trailer and the PPDU headers are written in the caller's
+ *                memory, which belongs to the fragmentation buffer until the ALPDU is fully
+ *                fragmented.
+ *
+ * @param[in,out] frag_buf                 The fragmentation buffer.
+ * @param[in]     sdu                      The SDU, with at least RLE_ENCAP_HEADROOM octets
+ *                                         before and RLE_ENCAP_TAILROOM octets after its buffer.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE Fragmentation buffer.
+ */
+int frag_buf_set_sdu_in_place(rle_frag_buf_t *const frag_buf, const struct rle_sdu *const sdu);
+
+/**
+ * @brief         Gather the segments of an SDU in a fragmentation buffer.
+ *
+ *                If asked, the CRC for the ALPDU trailer is computed during the copy and stored in
+ *                the fragmentation buffer, so that the SDU is only read once.
+ *
+ * @param[in,out] frag_buf                 The fragmentation buffer. Must be initialized.
+ * @param[in]     segments                 The segments of the SDU, in order.
+ * @param[in]     segments_nr              The number of segments.
+ * @param[in]     protocol_type            The protocol type (uncompressed) of the SDU.
+ * @param[in]     with_crc                 Whether the CRC must be computed.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE Fragmentation buffer.
+ */
+int frag_buf_gather_sdu(rle_frag_buf_t *const frag_buf,
+                        const struct rle_sdu_segment segments[],
+                        const size_t segments_nr,
+                        const uint16_t protocol_type,
+                        const bool with_crc);
+
 /**
  * @brief         Put the SDU, ALPDU and PPDU pointers.
  *
@@ -290,6 +408,17 @@ static inline void frag_buf_set_cur_pos(rle_frag_buf_t *const frag_buf);
  */
 static inline int frag_buf_in_use(const rle_frag_buf_t *const frag_buf);
 
+/**
+ * @brief         Get the size of the largest SDU the fragmentation buffer may hold.
+ *
+ * @param[in]     frag_buf                   The fragmentation buffer.
+ *
+ * @return        The size of the largest SDU.
+ *
+ * @ingroup       RLE Fragmentation buffer.
+ */
+static inline size_t frag_buf_get_sdu_max_len(const rle_frag_buf_t *const frag_buf);
+
 /**
  * @brief         Get the length of the SDU in the fragmentation buffer.
  *
@@ -428,23 +557,21 @@ size_t frag_buf_get_current_ppdu_len(const rle_frag_buf_t *const frag_buf);
 
 static void frag_buf_ptrs_set(frag_buf_ptrs_t *const ptrs, unsigned char *const address)
 {
-	assert((address >= ptrs->frag_buf->buffer) &&
-	       (address < ptrs->frag_buf->buffer + sizeof(ptrs->frag_buf->buffer)));
+	assert((address >= ptrs->frag_buf->mem_start) && (address < ptrs->frag_buf->mem_end));
 
 	ptrs->start = ptrs->end = address;
 }
 
 static void frag_buf_ptrs_push(frag_buf_ptrs_t *const ptrs, const ssize_t size)
 {
-	assert((ptrs->frag_buf->buffer + size) <= ptrs->start);
+	assert((ptrs->frag_buf->mem_start + size) <= ptrs->start);
 
 	ptrs->start -= size;
 }
 
 static void frag_buf_ptrs_put(frag_buf_ptrs_t *const ptrs, const size_t size)
 {
-	const ptrdiff_t offset =
-		(ptrs->frag_buf->buffer + sizeof(ptrs->frag_buf->buffer)) - ptrs->end;
+	const ptrdiff_t offset = ptrs->frag_buf->mem_end - ptrs->end;
 
 	assert(size <= (size_t)offset);
 
@@ -489,6 +616,11 @@ static inline int frag_buf_in_use(const rle_frag_buf_t *const frag_buf)
 	return frag_buf->sdu.start != frag_buf->sdu.end;
 }
 
+static inline size_t frag_buf_get_sdu_max_len(const rle_frag_buf_t *const frag_buf)
+{
+	return frag_buf->buffer_len - RLE_F_BUFF_ROOM;
+}
+
 static inline ssize_t frag_buf_get_sdu_len(const rle_frag_buf_t *const frag_buf)
 {
 	return (ssize_t)(frag_buf->sdu.end - frag_buf->sdu.start);
@@ -515,9 +647,9 @@ static inline int frag_buf_dump_mem(const rle_frag_buf_t *const frag_buf,
 		goto out;
 	}
 
-	if ((start < frag_buf->buffer) || (end > (frag_buf->buffer + sizeof(frag_buf->buffer)))) {
-		RLE_ERR("address out of buffer ([%p - %p]/[%p - %p])", start, end, frag_buf->buffer,
-		        frag_buf->buffer + sizeof(frag_buf->buffer));
+	if ((start < frag_buf->mem_start) || (end > frag_buf->mem_end)) {
+		RLE_ERR("address out of buffer ([%p - %p]/[%p - %p])", start, end, frag_buf->mem_start,
+		        frag_buf->mem_end);
 		goto out;
 	}
 
@@ -639,8 +771,7 @@ static inline int frag_buf_dump_full_frag_buf(const rle_frag_buf_t *const frag_b
 		goto out;
 	}
 
-	ret = frag_buf_dump_mem(frag_buf, frag_buf->buffer, frag_buf->buffer +
-	                        sizeof(frag_buf->buffer));
+	ret = frag_buf_dump_mem(frag_buf, frag_buf->mem_start, frag_buf->mem_end);
 
 	if (ret != -1) {
 		goto out;
@@ -56,60 +56,91 @@
 
 #define MODULE_ID RLE_MOD_ID_HEADER
 
+/** Start and end indicators of the first 16-bit word of each PPDU header, in host byte order */
+#define RLE_PPDU_HDR_TMPL_COMP   0xc000
+#define RLE_PPDU_HDR_TMPL_START  0x8000
+#define RLE_PPDU_HDR_TMPL_CONT   0x0000
+#define RLE_PPDU_HDR_TMPL_END    0x4000
+
+/** Use CRC bit of the second 16-bit word of the START PPDU header */
+#define RLE_PPDU_HDR_START_CRC   0x8000
+
+/** Shift of the PPDU length and of the total length fields in their 16-bit word */
+#define RLE_PPDU_HDR_LEN_SHIFT   3
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*--------------------------------------- PRIVATE FUNCTIONS --------------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
 
 /**
- *  @brief         create and push uncompressed ALPDU header into a fragmentation buffer.
+ *  @brief         create and push compressed supported ALPDU header into a fragmentation buffer.
  *
  *
  *  @param[in,out] frag_buf     the fragmentation buffer in use.
- *  @param[in]     ptype        the SDU protocol type
+ *  @param[in]     ptype        the compressed SDU protocol type
  *
  *  @ingroup
  */
-static void push_uncomp_alpdu_hdr(struct rle_frag_buf *const frag_buf,
-                                  const uint16_t ptype);
+static void push_comp_supported_alpdu_hdr(struct rle_frag_buf *const frag_buf,
+                                          const uint8_t ptype);
 
 /**
- *  @brief         create and push compressed supported ALPDU header into a fragmentation buffer.
+ *  @brief         create and push compressed fallback ALPDU header into a fragmentation buffer.
  *
  *
  *  @param[in,out] frag_buf     the fragmentation buffer in use.
- *  @param[in]     ptype        the compressed SDU protocol type
+ *  @param[in]     ptype        the SDU protocol type
  *
  *  @ingroup
  */
-static void push_comp_supported_alpdu_hdr(struct rle_frag_buf *const frag_buf,
-                                          const uint8_t ptype);
+static void push_comp_fallback_alpdu_hdr(struct rle_frag_buf *const frag_buf,
+                                         const uint16_t ptype);
 
 /**
- *  @brief         create and push compressed fallback ALPDU header into a fragmentation buffer.
+ *  @brief         remove the protocol field of the VLAN header of an Ethernet/VLAN/IP SDU.
+ *
+ *  @param[in,out] frag_buf             the fragmentation buffer in use.
+ *
+ *  @ingroup
+ */
+static void push_vlan_wo_ptype(struct rle_frag_buf *const frag_buf);
+
+/**
+ *  @brief         push the ALPDU header template of a protocol type into a fragmentation buffer.
  *
  *
  *  @param[in,out] frag_buf     the fragmentation buffer in use.
+ *  @param[in]     hdr          the ALPDU header of the protocol type, not of the COMP_VLAN form.
  *  @param[in]     ptype        the SDU protocol type
  *
  *  @ingroup
  */
-static void push_comp_fallback_alpdu_hdr(struct rle_frag_buf *const frag_buf,
-                                         const uint16_t ptype);
+static inline void push_alpdu_hdr_tmpl(struct rle_frag_buf *const frag_buf,
+                                       const struct rle_ptype_hdr *const hdr,
+                                       const uint16_t ptype);
+
+/**
+ *  @brief         store a 16-bit word of a PPDU header, in network byte order.
+ *
+ *
+ *  @param[out]    bytes        the PPDU header bytes, not aligned.
+ *  @param[in]     word         the 16-bit word, in host byte order.
+ *
+ *  @ingroup
+ */
+static inline void ppdu_hdr_put16(unsigned char *const bytes, const uint16_t word);
 
 /**
  *  @brief         create and push COMPLETE PPDU header into a fragmentation buffer.
  *
  *
  *  @param[in,out] frag_buf          the fragmentation buffer in use.
- *  @param[in]     alpdu_label_type  the ALPDU label type field.
- *  @param[in]     ptype_suppressed  the protocol type suppressed field.
+ *  @param[in]     ppdu_label        the ALPDU label type and protocol type suppressed fields.
  *
  *  @ingroup
  */
-static void push_comp_ppdu_hdr(struct rle_frag_buf *const frag_buf,
-                               const uint8_t alpdu_label_type,
-                               const uint8_t ptype_suppressed);
+static void push_comp_ppdu_hdr(struct rle_frag_buf *const frag_buf, const uint8_t ppdu_label);
 
 /**
  *  @brief         create and push START PPDU header into a fragmentation buffer.
@@ -117,16 +148,14 @@ static void push_comp_ppdu_hdr(struct rle_frag_buf *const frag_buf,
  *
  *  @param[in,out] frag_buf          the fragmentation buffer in use.
  *  @param[in]     frag_id           the fragmentation context ID.
- *  @param[in]     alpdu_label_type  the ALPDU label type field.
- *  @param[in]     ptype_suppressed  the protocol type suppressed field.
+ *  @param[in]     ppdu_label        the ALPDU label type and protocol type suppressed fields.
  *  @param[in]     use_alpdu_crc     the use ALPDU CRC field.
  *
  *  @ingroup
  */
 static void push_start_ppdu_hdr(struct rle_frag_buf *const frag_buf,
                                 const uint8_t frag_id,
-                                const uint8_t alpdu_label_type,
-                                const uint8_t ptype_suppressed,
+                                const uint8_t ppdu_label,
                                 const bool use_alpdu_crc);
 
 /**
@@ -164,23 +193,43 @@ static bool get_uncomp_ptype_from_sdu(const uint8_t *const sdu,
                                       uint16_t *const pt)
 __attribute__((warn_unused_result, nonnull(1, 3)));
 
+/**
+ * @brief Classify an Ethernet/VLAN frame from the only bytes the decision depends on.
+ *
+ *        The Ethernet protocol type, the VLAN protocol type and the IP version are at fixed
+ *        offsets, they are gathered in a single key compared to the Ethernet/VLAN/IPv4 and
+ *        Ethernet/VLAN/IPv6 keys. The MAC addresses and the TCI do not change the decision.
+ *
+ * @param sdu      The SDU to check for Ethernet/VLAN/IP
+ * @param sdu_len  The length of the SDU to check
+ * @return         The compressed protocol type, see is_eth_vlan_ip_frame()
+ */
+static inline uint8_t classify_eth_vlan_frame(const uint8_t *const sdu, const size_t sdu_len)
+__attribute__((warn_unused_result, nonnull(1)));
+
+/**
+ * @brief Template of push_ppdu_hdr() for an ALPDU trailer.
+ *
+ *        Given a constant trailer, it compiles down to a specialization without the trailer
+ *        branches, see push_ppdu_hdr_crc() and push_ppdu_hdr_seqnum().
+ *
+ * @param frag_buf       The fragmentation buffer in use, with its ALPDU header pushed
+ * @param ppdu_len       The room for the PPDU
+ * @param rle_ctx        The RLE context if needed (NULL if not)
+ * @param use_alpdu_crc  Whether the ALPDU trailer is a CRC, else a sequence number
+ * @return               true if OK, false if the room is too small for the smallest PPDU
+ */
+static inline bool push_ppdu_hdr_tmpl(struct rle_frag_buf *const frag_buf,
+                                      const size_t ppdu_len,
+                                      struct rle_ctx_mngt *const rle_ctx,
+                                      const bool use_alpdu_crc)
+__attribute__((always_inline, warn_unused_result));
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*------------------------------------ PRIVATE FUNCTIONS CODE ------------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
 
-static void push_uncomp_alpdu_hdr(struct rle_frag_buf *const frag_buf, const uint16_t ptype)
-{
-	rle_alpdu_hdr_uncomp_t **alpdu_hdr;
-
-	RLE_DEBUG("prepend a 2-byte ALPDU header with an uncompressed protocol type");
-
-	alpdu_hdr = (rle_alpdu_hdr_uncomp_t **)&frag_buf->alpdu.start;
-
-	frag_buf_alpdu_push(frag_buf, sizeof(**alpdu_hdr));
-	(*alpdu_hdr)->proto_type = ptype;
-}
-
 static void push_comp_supported_alpdu_hdr(struct rle_frag_buf *const frag_buf, const uint8_t ptype)
 {
 	rle_alpdu_hdr_comp_supported_t **alpdu_hdr;
@@ -207,95 +256,108 @@ static void push_comp_fallback_alpdu_hdr(struct rle_frag_buf *const frag_buf, co
 	(*alpdu_hdr)->uncomp.proto_type = ptype;
 }
 
-static void push_comp_ppdu_hdr(struct rle_frag_buf *const frag_buf,
-                               const uint8_t alpdu_label_type,
-                               const uint8_t ptype_suppressed)
+static void push_vlan_wo_ptype(struct rle_frag_buf *const frag_buf)
+{
+	const size_t ptype_len = sizeof(uint16_t);
+
+	RLE_DEBUG("omit the protocol field of the VLAN header making SDU 2 bytes less "
+	          "(%zu bytes in total)", frag_buf_get_sdu_len(frag_buf) - ptype_len);
+	memmove(frag_buf->sdu.start + ptype_len, frag_buf->sdu.start,
+	        sizeof(struct ether_header) + sizeof(struct vlan_hdr) - ptype_len);
+	frag_buf_sdu_push(frag_buf, -(ptype_len));
+}
+
+static inline void push_alpdu_hdr_tmpl(struct rle_frag_buf *const frag_buf,
+                                       const struct rle_ptype_hdr *const hdr,
+                                       const uint16_t ptype)
+{
+	RLE_DEBUG("prepend a %u-byte ALPDU header", hdr->alpdu_hdr_len);
+
+	frag_buf_alpdu_push(frag_buf, hdr->alpdu_hdr_len);
+	memcpy(frag_buf->alpdu.start, hdr->alpdu_hdr, hdr->alpdu_hdr_len);
+
+	/* the default header of the table is shared by the protocol types without their own, the
+	 * uncompressed protocol type that ends it is the one of the SDU */
+	if (hdr->ptype != ptype && hdr->form != RLE_ALPDU_HDR_COMP) {
+		ppdu_hdr_put16(frag_buf->alpdu.start + hdr->alpdu_hdr_len -
+		               RLE_PROTO_TYPE_FIELD_SIZE_UNCOMP, ptype);
+	}
+}
+
+static inline void ppdu_hdr_put16(unsigned char *const bytes, const uint16_t word)
+{
+	bytes[0] = (unsigned char)(word >> 8);
+	bytes[1] = (unsigned char)(word & 0xff);
+}
+
+static void push_comp_ppdu_hdr(struct rle_frag_buf *const frag_buf, const uint8_t ppdu_label)
 {
-	rle_ppdu_hdr_comp_t **ppdu_hdr;
 	uint16_t ppdu_len_field;
 
 	RLE_DEBUG("prepend a 2-byte PPDU COMP header");
 
-	ppdu_hdr = (rle_ppdu_hdr_comp_t **)&frag_buf->ppdu.start;
-
-	frag_buf_ppdu_push(frag_buf, sizeof(**ppdu_hdr));
+	frag_buf_ppdu_push(frag_buf, sizeof(rle_ppdu_hdr_comp_t));
 
 	ppdu_len_field = frag_buf_get_current_ppdu_len(frag_buf) - 2;
 
-	(*ppdu_hdr)->start_ind = 1;
-	(*ppdu_hdr)->end_ind = 1;
-	rle_ppdu_hdr_set_ppdu_len((rle_ppdu_hdr_t *)*ppdu_hdr, ppdu_len_field);
-	(*ppdu_hdr)->label_type = alpdu_label_type;
-	(*ppdu_hdr)->proto_type_supp = ptype_suppressed;
+	ppdu_hdr_put16(frag_buf->ppdu.start,
+	               RLE_PPDU_HDR_TMPL_COMP | ((ppdu_len_field & 0x7ff) << RLE_PPDU_HDR_LEN_SHIFT) |
+	               ppdu_label);
 }
 
 static void push_start_ppdu_hdr(struct rle_frag_buf *const frag_buf,
                                 const uint8_t frag_id,
-                                const uint8_t alpdu_label_type,
-                                const uint8_t ptype_suppressed,
+                                const uint8_t ppdu_label,
                                 const bool use_alpdu_crc)
 {
-	rle_ppdu_hdr_start_t **ppdu_hdr;
 	uint16_t ppdu_len_field;
 	uint16_t total_len_field;
 
 	RLE_DEBUG("prepend a 4-byte PPDU START header");
 
-	ppdu_hdr = (rle_ppdu_hdr_start_t **)&frag_buf->ppdu.start;
-
-	frag_buf_ppdu_push(frag_buf, sizeof(**ppdu_hdr));
+	frag_buf_ppdu_push(frag_buf, sizeof(rle_ppdu_hdr_start_t));
 
 	ppdu_len_field = frag_buf_get_current_ppdu_len(frag_buf) - 2;
 	total_len_field = frag_buf_get_alpdu_hdr_len(frag_buf) +
 	                  frag_buf_get_sdu_len(frag_buf) +
 	                  frag_buf_get_alpdu_trailer_len(frag_buf);
 
-	(*ppdu_hdr)->start_ind = 1;
-	(*ppdu_hdr)->end_ind = 0;
-	rle_ppdu_hdr_set_ppdu_len((rle_ppdu_hdr_t *)*ppdu_hdr, ppdu_len_field);
-	(*ppdu_hdr)->frag_id = frag_id;
-	(*ppdu_hdr)->use_crc = (use_alpdu_crc ? 1 : 0);
-	rle_ppdu_hdr_start_set_total_len(*ppdu_hdr, total_len_field);
-	(*ppdu_hdr)->label_type = alpdu_label_type;
-	(*ppdu_hdr)->proto_type_supp = ptype_suppressed;
+	ppdu_hdr_put16(frag_buf->ppdu.start,
+	               RLE_PPDU_HDR_TMPL_START | ((ppdu_len_field & 0x7ff) << RLE_PPDU_HDR_LEN_SHIFT) |
+	               (frag_id & RLE_MAX_FRAG_ID));
+	ppdu_hdr_put16(frag_buf->ppdu.start + sizeof(uint16_t),
+	               (use_alpdu_crc ? RLE_PPDU_HDR_START_CRC : 0) |
+	               ((total_len_field & 0xfff) << RLE_PPDU_HDR_LEN_SHIFT) | ppdu_label);
 }
 
 static void push_cont_ppdu_hdr(struct rle_frag_buf *const frag_buf, const uint8_t frag_id)
 {
-	rle_ppdu_hdr_cont_end_t **ppdu_hdr;
 	uint16_t ppdu_len_field;
 
 	RLE_DEBUG("prepend a 2-byte PPDU CONT header");
 
-	ppdu_hdr = (rle_ppdu_hdr_cont_end_t **)&frag_buf->ppdu.start;
-
-	frag_buf_ppdu_push(frag_buf, sizeof(**ppdu_hdr));
+	frag_buf_ppdu_push(frag_buf, sizeof(rle_ppdu_hdr_cont_end_t));
 
 	ppdu_len_field = frag_buf_get_current_ppdu_len(frag_buf) - 2;
 
-	(*ppdu_hdr)->start_ind = 0;
-	(*ppdu_hdr)->end_ind = 0;
-	rle_ppdu_hdr_set_ppdu_len((rle_ppdu_hdr_t *)*ppdu_hdr, ppdu_len_field);
-	(*ppdu_hdr)->frag_id = frag_id;
+	ppdu_hdr_put16(frag_buf->ppdu.start,
+	               RLE_PPDU_HDR_TMPL_CONT | ((ppdu_len_field & 0x7ff) << RLE_PPDU_HDR_LEN_SHIFT) |
+	               (frag_id & RLE_MAX_FRAG_ID));
 }
 
 static void push_end_ppdu_hdr(struct rle_frag_buf *const frag_buf, const uint8_t frag_id)
 {
-	rle_ppdu_hdr_cont_end_t **ppdu_hdr;
 	uint16_t ppdu_len_field;
 
 	RLE_DEBUG("prepend a 2-byte PPDU END header");
 
-	ppdu_hdr = (rle_ppdu_hdr_cont_end_t **)&frag_buf->ppdu.start;
-
-	frag_buf_ppdu_push(frag_buf, sizeof(**ppdu_hdr));
+	frag_buf_ppdu_push(frag_buf, sizeof(rle_ppdu_hdr_cont_end_t));
 
 	ppdu_len_field = frag_buf_get_current_ppdu_len(frag_buf) - 2;
 
-	(*ppdu_hdr)->start_ind = 0;
-	(*ppdu_hdr)->end_ind = 1;
-	rle_ppdu_hdr_set_ppdu_len((rle_ppdu_hdr_t *)*ppdu_hdr, ppdu_len_field);
-	(*ppdu_hdr)->frag_id = frag_id;
+	ppdu_hdr_put16(frag_buf->ppdu.start,
+	               RLE_PPDU_HDR_TMPL_END | ((ppdu_len_field & 0x7ff) << RLE_PPDU_HDR_LEN_SHIFT) |
+	               (frag_id & RLE_MAX_FRAG_ID));
 }
 
 static bool get_uncomp_ptype_from_sdu(const uint8_t *const sdu,
@@ -331,140 +393,52 @@ error:
 	return false;
 }
 
-
-/*------------------------------------------------------------------------------------------------*/
-/*------------------------------------- PUBLIC FUNCTIONS CODE-------------------------------------*/
-/*------------------------------------------------------------------------------------------------*/
-
-int is_eth_vlan_ip_frame(const uint8_t *const sdu, const size_t sdu_len)
+static inline uint8_t classify_eth_vlan_frame(const uint8_t *const sdu, const size_t sdu_len)
 {
 	const size_t eth_vlan_hdr_min_len = sizeof(struct ether_header) + sizeof(struct vlan_hdr);
-	uint8_t comp_ptype = RLE_PROTO_TYPE_FALLBACK;
+	const size_t eth_type_offset = offsetof(struct ether_header, ether_type);
+	const size_t vlan_type_offset = sizeof(struct ether_header) + offsetof(struct vlan_hdr, tpid);
+	/* Ethernet protocol type, VLAN protocol type and IP version, from the most significant */
+	const uint64_t vlan_ipv4_key = ((uint64_t)RLE_PROTO_TYPE_VLAN_UNCOMP << 20) |
+	                               ((uint64_t)RLE_PROTO_TYPE_IPV4_UNCOMP << 4) | 4;
+	const uint64_t vlan_ipv6_key = ((uint64_t)RLE_PROTO_TYPE_VLAN_UNCOMP << 20) |
+	                               ((uint64_t)RLE_PROTO_TYPE_IPV6_UNCOMP << 4) | 6;
+	uint64_t key;
 
 	if (sdu_len <= eth_vlan_hdr_min_len) {
 		/* the protocol type of short Ethernet/VLAN frames cannot be compressed */
 		RLE_DEBUG("frame is not Ethernet/VLAN/IPv4/6 (too short VLAN frame)");
-		goto error;
+		return RLE_PROTO_TYPE_FALLBACK;
 	}
 
-	/* retrieve the Ethernet protocol type */
-	{
-		const struct ether_header *const eth_hdr = (struct ether_header *)sdu;
-		const uint16_t eth_proto_type = ntohs(eth_hdr->ether_type);
-
-		const struct vlan_hdr *const vlan_hdr = (struct vlan_hdr *)(eth_hdr + 1);
-		const uint16_t vlan_proto_type = ntohs(vlan_hdr->tpid);
+	key = ((uint64_t)sdu[eth_type_offset] << 28) | ((uint64_t)sdu[eth_type_offset + 1] << 20) |
+	      ((uint64_t)sdu[vlan_type_offset] << 12) | ((uint64_t)sdu[vlan_type_offset + 1] << 4) |
+	      ((uint64_t)sdu[eth_vlan_hdr_min_len] >> 4);
 
-		const uint8_t *const vlan_payload = (uint8_t *)(vlan_hdr + 1);
-		const uint8_t ip_version = (vlan_payload[0] >> 4) & 0x0f;
-
-		if (eth_proto_type != RLE_PROTO_TYPE_VLAN_UNCOMP) {
-			/* unexpected protocol type in Ethernet frame: it should be VLAN */
-			RLE_DEBUG("frame is not Ethernet/VLAN/IPv4/6 (malformed VLAN)");
-			goto error;
-		}
-
-		/* embedded IPv4 or IPv6 use a special compressed protocol type that indicates
-		 * to the RLE receiver that the protocol field of the VLAN header is suppressed */
-		if ((vlan_proto_type == RLE_PROTO_TYPE_IPV4_UNCOMP && ip_version == 4) ||
-		    (vlan_proto_type == RLE_PROTO_TYPE_IPV6_UNCOMP && ip_version == 6)) {
-			RLE_DEBUG("frame is Ethernet/VLAN/IPv4/6");
-			comp_ptype = RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD;
-		} else {
-			RLE_DEBUG("frame is Ethernet/VLAN but not Ethernet/VLAN/IPv4/6");
-			comp_ptype = RLE_PROTO_TYPE_VLAN_COMP;
-		}
+	/* embedded IPv4 or IPv6 use a special compressed protocol type that indicates
+	 * to the RLE receiver that the protocol field of the VLAN header is suppressed */
+	if (key == vlan_ipv4_key || key == vlan_ipv6_key) {
+		RLE_DEBUG("frame is Ethernet/VLAN/IPv4/6");
+		return RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD;
+	}
+	if ((key >> 20) != RLE_PROTO_TYPE_VLAN_UNCOMP) {
+		/* unexpected protocol type in Ethernet frame: it should be VLAN */
+		RLE_DEBUG("frame is not Ethernet/VLAN/IPv4/6 (malformed VLAN)");
+		return RLE_PROTO_TYPE_FALLBACK;
 	}
 
-error:
-	return comp_ptype;
+	RLE_DEBUG("frame is Ethernet/VLAN but not Ethernet/VLAN/IPv4/6");
+	return RLE_PROTO_TYPE_VLAN_COMP;
 }
 
-void push_alpdu_hdr(struct rle_frag_buf *const frag_buf, const struct rle_config *const rle_conf)
-{
-	uint16_t ptype;
-
-	RLE_DEBUG("prepend a ALPDU header");
-
-	ptype = frag_buf->sdu_info.protocol_type;
-
-	/* ALPDU: 4 cases, len € {0,1,2,3} */
-
-	/* don't fill ALPDU ptype field if given ptype is equal to the default one and suppression is
-	 * active, or if given ptype is for signalling packet */
-	if (!ptype_is_omissible(ptype, rle_conf, frag_buf)) {
-		const uint16_t net_ptype = ntohs(ptype);
-
-		/* suppression is not possible, is compression enabled? */
-		if (!rle_conf->use_compressed_ptype) {
-			/* No compression, no suppression, ALPDU len = 2 */
-			push_uncomp_alpdu_hdr(frag_buf, net_ptype);
-		} else {
-			/* No suppression, compression is enabled */
-			uint8_t comp_ptype;
-
-			/* is protocol type compressible? */
-			if (rle_header_ptype_is_compressible(ptype) == C_OK) {
-				comp_ptype = rle_header_ptype_compression(ptype, frag_buf);
-			} else {
-				comp_ptype = RLE_PROTO_TYPE_FALLBACK;
-			}
-
-			if (comp_ptype == RLE_PROTO_TYPE_FALLBACK) {
-				/* protocol type is NOT compressible, prepend the 3-byte ALPDU before the SDU */
-				push_comp_fallback_alpdu_hdr(frag_buf, net_ptype);
-			} else {
-				/* protocol type is compressible, ALPDU len = 1 */
-
-				/* special case if the payload is VLAN with embedded IPv4 or IPv6:
-				 *  - the RLE transmitter shall suppress the protocol field of the VLAN header,
-				 *  - the RLE receiver shall detect IPv4/IPv6 with the 4 first bits of the
-				 *    embedded payload. */
-				if (ptype == RLE_PROTO_TYPE_VLAN_UNCOMP &&
-				    comp_ptype == RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD) {
-					RLE_DEBUG("omit the protocol field of the VLAN header "
-					          "making SDU 2 bytes less (%zu bytes in total)",
-					          frag_buf_get_sdu_len(frag_buf) - sizeof(ptype));
-					memmove(frag_buf->sdu.start + sizeof(ptype),
-					        frag_buf->sdu.start, sizeof(struct ether_header) +
-					        sizeof(struct vlan_hdr) - sizeof(ptype));
-					frag_buf_sdu_push(frag_buf, -(sizeof(ptype)));
-				}
-
-				/* prepend the 1-byte ALPDU before the SDU */
-				push_comp_supported_alpdu_hdr(frag_buf, comp_ptype);
-			}
-		}
-	} else {
-		/* protocol type is omitted, ALPDU len == 0 */
-		RLE_DEBUG("prepend a 0-byte ALPDU header with protocol type omitted");
-
-		/* special case if the payload is VLAN with embedded IPv4 or IPv6:
-		 *  - the RLE transmitter shall suppress the protocol field of the VLAN header,
-		 *  - the RLE receiver shall detect IPv4/IPv6 with the 4 first bits of the
-		 *    embedded payload. */
-		if (ptype == RLE_PROTO_TYPE_VLAN_UNCOMP &&
-		    rle_conf->implicit_protocol_type == RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD) {
-			RLE_DEBUG("omit the protocol field of the VLAN header "
-			          "making SDU 2 bytes less (%zu bytes in total)",
-			          frag_buf_get_sdu_len(frag_buf) - sizeof(ptype));
-			memmove(frag_buf->sdu.start + sizeof(ptype), frag_buf->sdu.start,
-			        sizeof(struct ether_header) + sizeof(struct vlan_hdr) -
-			        sizeof(ptype));
-			frag_buf_sdu_push(frag_buf, -(sizeof(ptype)));
-		}
-	}
-}
 
-bool push_ppdu_hdr(struct rle_frag_buf *const frag_buf,
-                   const struct rle_config *const rle_conf,
-                   const size_t ppdu_len,
-                   struct rle_ctx_mngt *const rle_ctx)
+static inline bool push_ppdu_hdr_tmpl(struct rle_frag_buf *const frag_buf,
+                                      const size_t ppdu_len,
+                                      struct rle_ctx_mngt *const rle_ctx,
+                                      const bool use_alpdu_crc)
 {
 	size_t max_alpdu_frag_len = ppdu_len;
 	const size_t remain_alpdu_len = frag_buf_get_remaining_alpdu_length(frag_buf);
-	const bool use_alpdu_crc =
-		(rle_conf->allow_alpdu_sequence_number ? false : !!rle_conf->allow_alpdu_crc);
 
 	if (frag_buf_is_fragmented(frag_buf)) {
 		/* ALPDU is fragmented, use CONT or END PPDU */
@@ -528,11 +502,6 @@ bool push_ppdu_hdr(struct rle_frag_buf *const frag_buf,
 			}
 		}
 	} else {
-		const bool ptype_suppressed = (frag_buf_get_alpdu_hdr_len(frag_buf) == 0);
-		const uint8_t alpdu_label_type =
-			get_alpdu_label_type(frag_buf->sdu_info.protocol_type, ptype_suppressed,
-			                     rle_conf->type_0_alpdu_label_size);
-
 		max_alpdu_frag_len -= sizeof(rle_ppdu_hdr_comp_t);
 
 		if (remain_alpdu_len > max_alpdu_frag_len) {
@@ -555,12 +524,16 @@ bool push_ppdu_hdr(struct rle_frag_buf *const frag_buf,
 				goto error;
 			}
 
-			push_alpdu_trailer(frag_buf, rle_conf, rle_ctx);
+			if (use_alpdu_crc) {
+				push_alpdu_crc_trailer(frag_buf);
+			} else {
+				push_alpdu_seqno_trailer(frag_buf, rle_ctx);
+			}
 
 			frag_buf_ppdu_put(frag_buf, ppdu_len - sizeof(rle_ppdu_hdr_start_t));
 
-			push_start_ppdu_hdr(frag_buf, rle_ctx->frag_id, alpdu_label_type,
-			                    ptype_suppressed, use_alpdu_crc);
+			push_start_ppdu_hdr(frag_buf, rle_ctx->frag_id, frag_buf->ppdu_label,
+			                    use_alpdu_crc);
 		} else {
 			/* Complete PPDU */
 			if (ppdu_len < sizeof(rle_ppdu_hdr_comp_t)) {
@@ -569,7 +542,7 @@ bool push_ppdu_hdr(struct rle_frag_buf *const frag_buf,
 
 			frag_buf_ppdu_put(frag_buf, ppdu_len - sizeof(rle_ppdu_hdr_comp_t));
 
-			push_comp_ppdu_hdr(frag_buf, alpdu_label_type, ptype_suppressed);
+			push_comp_ppdu_hdr(frag_buf, frag_buf->ppdu_label);
 		}
 	}
 
@@ -581,6 +554,143 @@ error:
 	return false;
 }
 
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------- PUBLIC FUNCTIONS CODE-------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+int is_eth_vlan_ip_frame(const uint8_t *const sdu, const size_t sdu_len)
+{
+	return classify_eth_vlan_frame(sdu, sdu_len);
+}
+
+void push_alpdu_hdr(struct rle_frag_buf *const frag_buf,
+                    const struct rle_ptype_table *const ptype_table)
+{
+	const uint16_t ptype = frag_buf->sdu_info.protocol_type;
+	const struct rle_ptype_hdr *const hdr = rle_ptype_table_lookup(ptype_table, ptype);
+	uint8_t comp_ptype = hdr->comp_ptype;
+	uint8_t vlan_comp_ptype = RLE_PROTO_TYPE_FALLBACK;
+	bool is_omitted;
+
+	RLE_DEBUG("prepend a ALPDU header");
+
+	/* only VLAN frames and implicit IPv4/IPv6 need a look at the payload */
+	if (hdr->form == RLE_ALPDU_HDR_COMP_VLAN || hdr->omission == RLE_PTYPE_OMIT_VLAN_IP) {
+		vlan_comp_ptype = classify_eth_vlan_frame(frag_buf->sdu.start,
+		                                          frag_buf->sdu_info.size);
+		if (hdr->form == RLE_ALPDU_HDR_COMP_VLAN) {
+			comp_ptype = vlan_comp_ptype;
+		}
+	}
+
+	/* ALPDU: 4 cases, len € {0,1,2,3} */
+	switch (hdr->omission) {
+	case RLE_PTYPE_OMIT_ALWAYS:
+		is_omitted = true;
+		break;
+	case RLE_PTYPE_OMIT_IP_VERSION:
+	{
+		/* protocol omission is possible if the first 4 bits of the SDU contain a supported IP
+		 * version so that the RLE receiver is able to infer the IP version from them */
+		const uint8_t ip_version =
+			(frag_buf->sdu_info.size < 1) ? 0 : ((frag_buf->sdu.start[0] >> 4) & 0x0f);
+		is_omitted = ((ptype == RLE_PROTO_TYPE_IPV4_UNCOMP && ip_version == 4) ||
+		              (ptype == RLE_PROTO_TYPE_IPV6_UNCOMP && ip_version == 6));
+		break;
+	}
+	case RLE_PTYPE_OMIT_VLAN_IP:
+		is_omitted = (vlan_comp_ptype == RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD);
+		break;
+	default:
+		is_omitted = false;
+		break;
+	}
+
+	if (!is_omitted) {
+		const uint16_t net_ptype = ntohs(ptype);
+
+		switch (hdr->form) {
+		case RLE_ALPDU_HDR_COMP_VLAN:
+			if (comp_ptype == RLE_PROTO_TYPE_FALLBACK) {
+				/* VLAN frame is malformed, prepend the 3-byte ALPDU before the SDU */
+				push_comp_fallback_alpdu_hdr(frag_buf, net_ptype);
+				break;
+			}
+
+			/* special case if the payload is VLAN with embedded IPv4 or IPv6:
+			 *  - the RLE transmitter shall suppress the protocol field of the VLAN header,
+			 *  - the RLE receiver shall detect IPv4/IPv6 with the 4 first bits of the
+			 *    embedded payload. */
+			if (comp_ptype == RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD) {
+				push_vlan_wo_ptype(frag_buf);
+			}
+
+			/* protocol type is compressible, prepend the 1-byte ALPDU before the SDU */
+			push_comp_supported_alpdu_hdr(frag_buf, comp_ptype);
+			break;
+		default:
+			/* the header does not depend on the payload, prepend its template */
+			push_alpdu_hdr_tmpl(frag_buf, hdr, ptype);
+			break;
+		}
+	} else {
+		/* protocol type is omitted, ALPDU len == 0 */
+		RLE_DEBUG("prepend a 0-byte ALPDU header with protocol type omitted");
+
+		/* same special case for VLAN with embedded IPv4 or IPv6 */
+		if (hdr->vlan_wo_ptype) {
+			push_vlan_wo_ptype(frag_buf);
+		}
+	}
+	frag_buf->ppdu_label = hdr->ppdu_label[is_omitted ? 1 : 0];
+}
+
+bool push_ppdu_hdr(struct rle_frag_buf *const frag_buf,
+                   const struct rle_config *const rle_conf,
+                   const size_t ppdu_len,
+                   struct rle_ctx_mngt *const rle_ctx)
+{
+	const bool use_alpdu_crc =
+		(rle_conf->allow_alpdu_sequence_number ? false : !!rle_conf->allow_alpdu_crc);
+
+	return push_ppdu_hdr_tmpl(frag_buf, ppdu_len, rle_ctx, use_alpdu_crc);
+}
+
+bool push_ppdu_hdr_crc(struct rle_frag_buf *const frag_buf,
+                       const struct rle_config *const rle_conf __attribute__((unused)),
+                       const size_t ppdu_len,
+                       struct rle_ctx_mngt *const rle_ctx)
+{
+	return push_ppdu_hdr_tmpl(frag_buf, ppdu_len, rle_ctx, true);
+}
+
+bool push_ppdu_hdr_seqnum(struct rle_frag_buf *const frag_buf,
+                          const struct rle_config *const rle_conf __attribute__((unused)),
+                          const size_t ppdu_len,
+                          struct rle_ctx_mngt *const rle_ctx)
+{
+	return push_ppdu_hdr_tmpl(frag_buf, ppdu_len, rle_ctx, false);
+}
+
+bool push_ppdu_hdr_auto(struct rle_frag_buf *const frag_buf,
+                        const struct rle_config *const rle_conf __attribute__((unused)),
+                        const size_t ppdu_len,
+                        struct rle_ctx_mngt *const rle_ctx)
+{
+	return push_ppdu_hdr_tmpl(frag_buf, ppdu_len, rle_ctx, frag_buf->use_crc);
+}
+
+push_ppdu_hdr_t push_ppdu_hdr_select(const struct rle_config *const rle_conf)
+{
+	/* the sequence number takes precedence over the CRC, as in push_ppdu_hdr() */
+	if (rle_conf->allow_alpdu_sequence_number == 0 && rle_conf->allow_alpdu_crc != 0) {
+		return push_ppdu_hdr_crc;
+	}
+
+	return push_ppdu_hdr_seqnum;
+}
+
 void comp_ppdu_extract_alpdu_frag(unsigned char comp_ppdu[],
                                   const size_t ppdu_len,
                                   unsigned char **alpdu_frag,
@@ -636,12 +746,17 @@ int signal_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
                                   uint16_t *ptype,
                                   uint8_t *comp_ptype,
                                   const unsigned char *sdu_frag[],
-                                  size_t *const sdu_frag_len)
+                                  size_t *const sdu_frag_len,
+                                  size_t *const alpdu_hdr_len,
+                                  const struct rle_config *const rle_conf __attribute__((unused)))
 {
 	*ptype = RLE_PROTO_TYPE_SIGNAL_UNCOMP;
 	*comp_ptype = RLE_PROTO_TYPE_SIGNAL_COMP;
 	*sdu_frag = alpdu_frag;
 	*sdu_frag_len = alpdu_frag_len;
+	if (alpdu_hdr_len) {
+		*alpdu_hdr_len = 0;
+	}
 
 	return 0;
 }
@@ -652,9 +767,12 @@ int suppr_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
                                  uint8_t *comp_ptype,
                                  const unsigned char *sdu_frag[],
                                  size_t *const sdu_frag_len,
+                                 size_t *const alpdu_hdr_len,
                                  const struct rle_config *const rle_conf)
 {
-	const uint8_t default_ptype = rle_conf->implicit_protocol_type;
+	/* may be swapped by rle_receiver_set_implicit_ptype() while decapsulating */
+	const uint8_t default_ptype =
+		__atomic_load_n(&rle_conf->implicit_protocol_type, __ATOMIC_RELAXED);
 	int status = 0;
 
 	RLE_DEBUG("extract SDU from a %zu-byte ALPDU with protocol type omitted", alpdu_frag_len);
@@ -662,6 +780,9 @@ int suppr_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
 	*comp_ptype = default_ptype;
 	*sdu_frag = alpdu_frag;
 	*sdu_frag_len = alpdu_frag_len;
+	if (alpdu_hdr_len) {
+		*alpdu_hdr_len = 0;
+	}
 	RLE_DEBUG("%zu-byte SDU with implicit protocol type 0x%02x extracted from ALPDU",
 	          (*sdu_frag_len), default_ptype);
 
@@ -689,7 +810,9 @@ int uncomp_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
                                   uint16_t *ptype,
                                   uint8_t *comp_ptype,
                                   const unsigned char *sdu_frag[],
-                                  size_t *const sdu_frag_len)
+                                  size_t *const sdu_frag_len,
+                                  size_t *const alpdu_hdr_len,
+                                  const struct rle_config *const rle_conf __attribute__((unused)))
 {
 	const rle_alpdu_hdr_uncomp_t *const uncomp_alpdu_hdr =
 		(rle_alpdu_hdr_uncomp_t *)alpdu_frag;
@@ -707,6 +830,9 @@ int uncomp_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
 	*ptype = htons(uncomp_alpdu_hdr->proto_type);
 	*sdu_frag = alpdu_frag + sizeof(rle_alpdu_hdr_uncomp_t);
 	*sdu_frag_len = alpdu_frag_len - sizeof(rle_alpdu_hdr_uncomp_t);
+	if (alpdu_hdr_len) {
+		*alpdu_hdr_len = sizeof(rle_alpdu_hdr_uncomp_t);
+	}
 
 	RLE_DEBUG("%zu-byte SDU with uncompressed protocol type 0x%04x extracted "
 	          "from ALPDU", (*sdu_frag_len), (*ptype));
@@ -721,7 +847,8 @@ int comp_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
                                 uint8_t *comp_ptype,
                                 const unsigned char *sdu_frag[],
                                 size_t *const sdu_frag_len,
-                                size_t *const alpdu_hdr_len)
+                                size_t *const alpdu_hdr_len,
+                                const struct rle_config *const rle_conf __attribute__((unused)))
 {
 	const rle_alpdu_hdr_t *const alpdu_hdr = (rle_alpdu_hdr_t *)alpdu_frag;
 	int status = 0;
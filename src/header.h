@@ -253,23 +253,29 @@ struct vlan_hdr {
 int is_eth_vlan_ip_frame(const uint8_t *const sdu, const size_t sdu_len)
 __attribute__((warn_unused_result, nonnull(1)));
 
+/** Push the PPDU header of the next PPDU of a fragmentation buffer, see push_ppdu_hdr() */
+typedef bool (*push_ppdu_hdr_t)(struct rle_frag_buf *const frag_buf,
+                                const struct rle_config *const rle_conf,
+                                const size_t ppdu_len,
+                                struct rle_ctx_mngt *const rle_ctx);
+
 /**
  *  @brief         create and push ALPDU header into a fragmentation buffer.
  *
  *
  *  @param[in,out] frag_buf             the fragmentation buffer in use.
- *  @param[in]     rle_conf             the RLE configuration
+ *  @param[in]     ptype_table          the ALPDU headers of protocol types for the configuration
  *
  *  @ingroup RLE header
  */
 void push_alpdu_hdr(struct rle_frag_buf *const frag_buf,
-                    const struct rle_config *const rle_conf);
+                    const struct rle_ptype_table *const ptype_table);
 
 /**
  *  @brief         create and push PPDU header into a fragmentation buffer.
  *
  *
- *  @param[in,out] frag_buf             the fragmentation buffer in use.
+ *  @param[in,out] frag_buf             the fragmentation buffer in use, its ALPDU header pushed.
  *  @param[in]     rle_conf             the RLE configuration
  *  @param[in,out] rle_ctx              the RLE context if needed (NULL if not).
  *
@@ -283,6 +289,52 @@ bool push_ppdu_hdr(struct rle_frag_buf *const frag_buf,
                    const size_t ppdu_len,
                    struct rle_ctx_mngt *const rle_ctx);
 
+/**
+ *  @brief         push_ppdu_hdr() specialized for a CRC ALPDU trailer.
+ *
+ *  @ingroup RLE header
+ */
+bool push_ppdu_hdr_crc(struct rle_frag_buf *const frag_buf,
+                       const struct rle_config *const rle_conf,
+                       const size_t ppdu_len,
+                       struct rle_ctx_mngt *const rle_ctx);
+
+/**
+ *  @brief         push_ppdu_hdr() specialized for a sequence number ALPDU trailer.
+ *
+ *  @ingroup RLE header
+ */
+bool push_ppdu_hdr_seqnum(struct rle_frag_buf *const frag_buf,
+                          const struct rle_config *const rle_conf,
+                          const size_t ppdu_len,
+                          struct rle_ctx_mngt *const rle_ctx);
+
+/**
+ *  @brief         push_ppdu_hdr() with the ALPDU trailer chosen for the SDU of the buffer, see
+ *                 rle_transmitter_set_protection_policy().
+ *
+ *  @ingroup RLE header
+ */
+bool push_ppdu_hdr_auto(struct rle_frag_buf *const frag_buf,
+                        const struct rle_config *const rle_conf,
+                        const size_t ppdu_len,
+                        struct rle_ctx_mngt *const rle_ctx);
+
+/**
+ *  @brief         select the specialization of push_ppdu_hdr() for a configuration.
+ *
+ *                 The ALPDU trailer of a configuration never changes, so it is resolved once
+ *                 instead of on each PPDU. A protection policy selects push_ppdu_hdr_auto().
+ *
+ *  @param[in]     rle_conf             the RLE configuration
+ *
+ *  @return        push_ppdu_hdr_crc() or push_ppdu_hdr_seqnum()
+ *
+ *  @ingroup RLE header
+ */
+push_ppdu_hdr_t push_ppdu_hdr_select(const struct rle_config *const rle_conf)
+__attribute__((warn_unused_result, nonnull(1)));
+
 /**
  *  @brief         Extract ALPDU fragment from complete PPDU.
  *
@@ -335,6 +387,20 @@ void cont_end_ppdu_extract_alpdu_frag(const unsigned char cont_end_ppdu[],
                                       const unsigned char *alpdu_frag[],
                                       size_t *const alpdu_frag_len);
 
+/**
+ *  @brief         Extractor of the SDU fragment of an ALPDU, one per ALPDU header format.
+ *
+ *  @ingroup RLE header
+ */
+typedef int (*alpdu_extract_sdu_frag_t)(const unsigned char alpdu_frag[],
+                                        const size_t alpdu_frag_len,
+                                        uint16_t *ptype,
+                                        uint8_t *comp_ptype,
+                                        const unsigned char *sdu_frag[],
+                                        size_t *const sdu_frag_len,
+                                        size_t *const alpdu_hdr_len,
+                                        const struct rle_config *const rle_conf);
+
 /**
  *  @brief         Extract signel SDU from ALPDU.
  *
@@ -344,6 +410,8 @@ void cont_end_ppdu_extract_alpdu_frag(const unsigned char cont_end_ppdu[],
  *  @param[out]    comp_ptype      the compressed protocol type extracted from the ALPDU header
  *  @param[out]    sdu_frag        the fragment of SDU extracted.
  *  @param[out]    sdu_frag_len    the length of the SDU fragment.
+ *  @param[out]    alpdu_hdr_len   the length of the ALPDU header, may be NULL.
+ *  @param[in]     rle_conf        the RLE configuration, unused.
  *
  *  @return        0 if OK, 1 if KO.
  *
@@ -354,7 +422,9 @@ int signal_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
                                   uint16_t *ptype,
                                   uint8_t *comp_ptype,
                                   const unsigned char *sdu_frag[],
-                                  size_t *const sdu_frag_len);
+                                  size_t *const sdu_frag_len,
+                                  size_t *const alpdu_hdr_len,
+                                  const struct rle_config *const rle_conf);
 
 /**
  *  @brief         Extract SDU from supressed ALPDU.
@@ -365,7 +435,8 @@ int signal_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
  *  @param[out]    comp_ptype      the compressed protocol type extracted from the ALPDU header
  *  @param[out]    sdu_frag        the fragment of SDU extracted.
  *  @param[out]    sdu_frag_len    the length of the SDU fragment.
- *  @param[out]    rle_conf        the RLE configuration (for suppressed protocol type).
+ *  @param[out]    alpdu_hdr_len   the length of the ALPDU header, may be NULL.
+ *  @param[in]     rle_conf        the RLE configuration (for suppressed protocol type).
  *
  *  @return        0 if OK, 1 if KO.
  *
@@ -377,6 +448,7 @@ int suppr_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
                                  uint8_t *comp_ptype,
                                  const unsigned char *sdu_frag[],
                                  size_t *const sdu_frag_len,
+                                 size_t *const alpdu_hdr_len,
                                  const struct rle_config *const rle_conf);
 
 /**
@@ -389,6 +461,8 @@ int suppr_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
  *  @param[out]    comp_ptype      the compressed protocol type extracted from the ALPDU header
  *  @param[out]    sdu_frag        the fragment of SDU extracted.
  *  @param[out]    sdu_frag_len    the length of the SDU fragment.
+ *  @param[out]    alpdu_hdr_len   the length of the ALPDU header, may be NULL.
+ *  @param[in]     rle_conf        the RLE configuration, unused.
  *
  *  @return        0 if OK, 1 if KO.
  *
@@ -399,7 +473,9 @@ int uncomp_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
                                   uint16_t *ptype,
                                   uint8_t *comp_ptype,
                                   const unsigned char *sdu_frag[],
-                                  size_t *const sdu_frag_len);
+                                  size_t *const sdu_frag_len,
+                                  size_t *const alpdu_hdr_len,
+                                  const struct rle_config *const rle_conf);
 
 /**
  *  @brief         Extract SDU fragment from compressed ALPDU.
@@ -411,7 +487,8 @@ int uncomp_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
  *  @param[out]    comp_ptype      the compressed protocol type extracted from the ALPDU header
  *  @param[out]    sdu_frag        the fragment of SDU extracted.
  *  @param[out]    sdu_frag_len    the length of the SDU fragment.
- *  @param[out]    alpdu_hdr_len   the length of the ALPDU header
+ *  @param[out]    alpdu_hdr_len   the length of the ALPDU header, may be NULL.
+ *  @param[in]     rle_conf        the RLE configuration, unused.
  *
  *  @return        0 if OK, 1 if KO.
  *
@@ -423,7 +500,8 @@ int comp_alpdu_extract_sdu_frag(const unsigned char alpdu_frag[],
                                 uint8_t *comp_ptype,
                                 const unsigned char *sdu_frag[],
                                 size_t *const sdu_frag_len,
-                                size_t *const alpdu_hdr_len);
+                                size_t *const alpdu_hdr_len,
+                                const struct rle_config *const rle_conf);
 
 /**
  *  @brief         Set the PPDU length field of a PPDU header.
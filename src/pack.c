@@ -28,6 +28,14 @@
 
 #include "constants.h"
 #include "rle.h"
+#include "rle_transmitter.h"
+#include "fragmentation_buffer.h"
+#include "rle_ctx.h"
+#include "header.h"
+#include "trailer.h"
+#include "crc.h"
+#include "rle_timing.h"
+#include "rle_copy_stats.h"
 
 #ifndef __KERNEL__
 
@@ -49,6 +57,458 @@
 
 #define MODULE_NAME "PACK"
 
+/** The largest PPDU, header included */
+#define PLAN_MAX_PPDU_LEN (RLE_MAX_PPDU_PL_SIZE + sizeof(rle_ppdu_hdr_cont_end_t))
+
+/** The smallest payload of a PPDU that is not the last one of its ALPDU: a smaller fragment costs
+ *  more in headers than it carries, the room is better left to another ALPDU or to padding */
+#define PLAN_MIN_FRAG_LEN 8
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE STRUCTS AND TYPEDEFS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** ALPDU of a context, as seen by the burst planner */
+struct plan_alpdu {
+	uint8_t frag_id;     /**< The fragment id of the context                               */
+	bool started;        /**< Whether the START PPDU of the ALPDU is already built         */
+	size_t remaining;    /**< The ALPDU bytes left, trailer included once started          */
+	size_t hdr_len;      /**< The ALPDU header length, not fragmented by the START PPDU    */
+	size_t trailer_len;  /**< The ALPDU trailer length, added when the START PPDU is built */
+	size_t crc_len;      /**< The ALPDU trailer bytes that shall not be fragmented         */
+};
+
+#ifdef RLE_TIMING
+/** Durations of the packing, shared by the whole library as rle_pack() has no module */
+static struct rle_timing_histogram pack_timing;
+#endif
+
+#ifdef RLE_COPY_STATS
+/** Copies of rle_pack(), shared by the whole library as it has no module */
+static struct rle_copy_counters pack_copy_stats;
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PRIVATE FUNCTIONS --------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Get the room left in a burst of the plan.
+ *
+ * @param[in]     burst_sizes             The sizes of the bursts, FPDU label included.
+ * @param[in]     label_size              Size of the FPDU label fields.
+ * @param[in]     plan                    The PPDUs of the plan.
+ * @param[in]     plan_nr                 The number of PPDUs in the plan.
+ * @param[in]     burst                   The index of the burst.
+ *
+ * @return        The room left for PPDUs in the burst.
+ */
+static size_t plan_burst_room(const size_t burst_sizes[],
+                              const size_t label_size,
+                              const struct rle_burst_plan_ppdu plan[],
+                              const size_t plan_nr,
+                              const size_t burst);
+
+/**
+ * @brief         Size the next PPDU of an ALPDU in the given room, as push_ppdu_hdr() would do.
+ *
+ * @param[in,out] alpdu                   The ALPDU, updated with the PPDU if any.
+ * @param[in]     room                    The room for the PPDU.
+ * @param[in]     min_frag_len            The smallest payload of a PPDU that is not the last one
+ *                                        of the ALPDU, 1 to size as push_ppdu_hdr() does.
+ *
+ * @return        The size of the PPDU, 0 if no PPDU is worth building in the room.
+ */
+static size_t plan_fragment(struct plan_alpdu *const alpdu, const size_t room,
+                            const size_t min_frag_len);
+
+/**
+ * @brief         Append a PPDU to the plan.
+ *
+ * @param[in,out] plan                    The PPDUs of the plan.
+ * @param[in]     plan_max_nr             The plan array size.
+ * @param[in,out] plan_nr                 The number of PPDUs in the plan.
+ * @param[in]     burst                   The index of the burst of the PPDU.
+ * @param[in]     frag_id                 The fragment id of the context of the PPDU.
+ * @param[in]     ppdu_length             The size of the PPDU.
+ *
+ * @return        true if OK, false if the plan array is full.
+ */
+static bool plan_push(struct rle_burst_plan_ppdu plan[],
+                      const size_t plan_max_nr,
+                      size_t *const plan_nr,
+                      const size_t burst,
+                      const uint8_t frag_id,
+                      const size_t ppdu_length);
+
+/**
+ * @brief         Plan the fragmentation and packing of the pending ALPDUs in a list of bursts.
+ *
+ * @param[in]     transmitter             The transmitter holding the contexts to plan.
+ * @param[in]     burst_sizes             The sizes of the bursts, FPDU label included.
+ * @param[in]     bursts_nr               The number of bursts.
+ * @param[in]     label_size              Size of the FPDU label fields.
+ * @param[in]     min_frag_len            The smallest payload of a PPDU that is not the last one
+ *                                        of its ALPDU.
+ * @param[out]    plan                    The PPDUs of the plan, preallocated.
+ * @param[in]     plan_max_nr             The plan array size.
+ * @param[out]    plan_nr                 The number of PPDUs in the plan.
+ *
+ * @return        0 if OK, else 1.
+ */
+static int plan_bursts(const struct rle_transmitter *const transmitter,
+                       const size_t burst_sizes[],
+                       const size_t bursts_nr,
+                       const size_t label_size,
+                       const size_t min_frag_len,
+                       struct rle_burst_plan_ppdu plan[],
+                       const size_t plan_max_nr,
+                       size_t *const plan_nr);
+
+/**
+ * @brief         Fragment a PPDU of the plan and pack it in its FPDU.
+ *
+ * @param[in,out] transmitter             The transmitter the plan was built from.
+ * @param[in]     ppdu_plan               The PPDU of the plan.
+ * @param[in]     label                   The FPDU label fields, valid.
+ * @param[in]     label_size              Size of the FPDU label fields.
+ * @param[in,out] fpdu                    The FPDU of the PPDU.
+ * @param[in,out] fpdu_current_pos        Current position in the FPDU.
+ * @param[in,out] fpdu_remaining_size     Remaining size in the FPDU.
+ *
+ * @return        Frame packing status, the FPDU is left untouched on failure.
+ */
+static enum rle_pack_status plan_pack_ppdu(struct rle_transmitter *const transmitter,
+                                           const struct rle_burst_plan_ppdu *const ppdu_plan,
+                                           const unsigned char *const label,
+                                           const size_t label_size,
+                                           unsigned char *const fpdu,
+                                           size_t *const fpdu_current_pos,
+                                           size_t *const fpdu_remaining_size);
+
+/**
+ * @brief         Sort PPDUs of the plan by burst index, keeping the order of the PPDUs of a burst.
+ *
+ * @param[in,out] plan                    The PPDUs to sort.
+ * @param[in]     plan_nr                 The number of PPDUs to sort.
+ */
+static void plan_sort(struct rle_burst_plan_ppdu plan[], const size_t plan_nr);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PRIVATE FUNCTIONS CODE ------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static size_t plan_burst_room(const size_t burst_sizes[],
+                              const size_t label_size,
+                              const struct rle_burst_plan_ppdu plan[],
+                              const size_t plan_nr,
+                              const size_t burst)
+{
+	size_t room;
+	size_t i;
+
+	if (burst_sizes[burst] <= label_size) {
+		return 0;
+	}
+
+	room = burst_sizes[burst] - label_size;
+	for (i = 0; i < plan_nr; i++) {
+		if (plan[i].burst == burst) {
+			room -= plan[i].ppdu_length;
+		}
+	}
+
+	return room;
+}
+
+static size_t plan_fragment(struct plan_alpdu *const alpdu, const size_t room,
+                            const size_t min_frag_len)
+{
+	const size_t max_len = (room > PLAN_MAX_PPDU_LEN ? PLAN_MAX_PPDU_LEN : room);
+	size_t payload_len;
+
+	if (alpdu->remaining == 0 || max_len <= sizeof(rle_ppdu_hdr_cont_end_t)) {
+		return 0;
+	}
+
+	/* COMP or END PPDU: the last PPDU of the ALPDU is always worth building */
+	if (alpdu->remaining <= (max_len - sizeof(rle_ppdu_hdr_cont_end_t))) {
+		payload_len = alpdu->remaining;
+		alpdu->remaining = 0;
+		return sizeof(rle_ppdu_hdr_cont_end_t) + payload_len;
+	}
+
+	if (!alpdu->started) {
+		/* START PPDU: the full ALPDU header and one byte at least, the trailer is added */
+		if (max_len < (sizeof(rle_ppdu_hdr_start_t) + alpdu->hdr_len + 1) ||
+		    (max_len - sizeof(rle_ppdu_hdr_start_t)) < min_frag_len) {
+			return 0;
+		}
+		payload_len = max_len - sizeof(rle_ppdu_hdr_start_t);
+		alpdu->remaining += alpdu->trailer_len;
+		alpdu->remaining -= payload_len;
+		alpdu->started = true;
+		return max_len;
+	}
+
+	/* CONT PPDU, shortened so that the CRC is not fragmented */
+	payload_len = max_len - sizeof(rle_ppdu_hdr_cont_end_t);
+	if ((alpdu->remaining - payload_len) < alpdu->crc_len) {
+		payload_len = alpdu->remaining - alpdu->crc_len;
+	}
+	if (payload_len == 0 || payload_len < min_frag_len) {
+		return 0;
+	}
+	alpdu->remaining -= payload_len;
+
+	return sizeof(rle_ppdu_hdr_cont_end_t) + payload_len;
+}
+
+static bool plan_push(struct rle_burst_plan_ppdu plan[],
+                      const size_t plan_max_nr,
+                      size_t *const plan_nr,
+                      const size_t burst,
+                      const uint8_t frag_id,
+                      const size_t ppdu_length)
+{
+	if ((*plan_nr) >= plan_max_nr) {
+		return false;
+	}
+
+	plan[*plan_nr].burst = burst;
+	plan[*plan_nr].frag_id = frag_id;
+	plan[*plan_nr].ppdu_length = ppdu_length;
+	(*plan_nr)++;
+
+	return true;
+}
+
+static void plan_sort(struct rle_burst_plan_ppdu plan[], const size_t plan_nr)
+{
+	size_t i;
+
+	for (i = 1; i < plan_nr; i++) {
+		const struct rle_burst_plan_ppdu ppdu = plan[i];
+		size_t j = i;
+
+		while (j > 0 && plan[j - 1].burst > ppdu.burst) {
+			plan[j] = plan[j - 1];
+			j--;
+		}
+		plan[j] = ppdu;
+	}
+}
+
+
+static int plan_bursts(const struct rle_transmitter *const transmitter,
+                       const size_t burst_sizes[],
+                       const size_t bursts_nr,
+                       const size_t label_size,
+                       const size_t min_frag_len,
+                       struct rle_burst_plan_ppdu plan[],
+                       const size_t plan_max_nr,
+                       size_t *const plan_nr)
+{
+	struct plan_alpdu alpdus[RLE_MAX_FRAG_NUMBER];
+	size_t alpdus_nr = 0;
+	uint8_t frag_id;
+	size_t i;
+
+	if (transmitter == NULL || (burst_sizes == NULL && bursts_nr > 0) || plan == NULL ||
+	    plan_nr == NULL) {
+		return 1;
+	}
+	if (label_size != 0 && label_size != 3 && label_size != 6) {
+		return 1;
+	}
+
+	*plan_nr = 0;
+
+	/* collect the pending ALPDUs, the fragmented ones first as they hold a reassembly context of
+	 * the receiver, then the largest ones first as they are the hardest to place */
+	for (frag_id = 0; frag_id < transmitter->contexts_nr; frag_id++) {
+		const rle_frag_buf_t *frag_buf;
+		struct plan_alpdu alpdu;
+		size_t pos;
+
+		if (rle_ctx_is_free(transmitter->free_ctx, frag_id)) {
+			continue;
+		}
+
+		frag_buf = (const rle_frag_buf_t *)transmitter->rle_ctx_man[frag_id].buff;
+		if (frag_buf == NULL || !frag_buf_in_use(frag_buf)) {
+			continue;
+		}
+
+		alpdu.frag_id = frag_id;
+		alpdu.remaining = frag_buf_get_remaining_alpdu_length(frag_buf);
+		alpdu.started = (frag_buf->cur_pos > frag_buf->alpdu.start);
+		alpdu.hdr_len = (size_t)frag_buf_get_alpdu_hdr_len(frag_buf);
+		/* the trailer is chosen per SDU, see rle_transmitter_set_protection_policy() */
+		alpdu.trailer_len = (frag_buf->use_crc ? RLE_CRC_SIZE : RLE_SEQ_NO_FIELD_SIZE);
+		alpdu.crc_len = (frag_buf->use_crc ? RLE_CRC_SIZE : 0);
+		if (alpdu.remaining == 0) {
+			continue;
+		}
+
+		pos = alpdus_nr;
+		while (pos > 0 && (alpdus[pos - 1].started < alpdu.started ||
+		                   (alpdus[pos - 1].started == alpdu.started &&
+		                    alpdus[pos - 1].remaining < alpdu.remaining))) {
+			alpdus[pos] = alpdus[pos - 1];
+			pos--;
+		}
+		alpdus[pos] = alpdu;
+		alpdus_nr++;
+	}
+
+	/* the ALPDUs that fit whole in a burst are sent in one PPDU, in the burst they fill best */
+	for (i = 0; i < alpdus_nr; i++) {
+		const size_t whole_len = sizeof(rle_ppdu_hdr_cont_end_t) + alpdus[i].remaining;
+		size_t best_burst = bursts_nr;
+		size_t best_room = 0;
+		size_t burst;
+
+		if (whole_len > PLAN_MAX_PPDU_LEN) {
+			continue;
+		}
+
+		for (burst = 0; burst < bursts_nr; burst++) {
+			const size_t room = plan_burst_room(burst_sizes, label_size, plan, *plan_nr, burst);
+
+			if (room >= whole_len && (best_burst == bursts_nr || room < best_room)) {
+				best_burst = burst;
+				best_room = room;
+			}
+		}
+
+		if (best_burst != bursts_nr) {
+			const size_t ppdu_length = plan_fragment(&alpdus[i], whole_len, min_frag_len);
+
+			if (!plan_push(plan, plan_max_nr, plan_nr, best_burst, alpdus[i].frag_id,
+			               ppdu_length)) {
+				goto error;
+			}
+		}
+	}
+
+	/* the other ALPDUs are fragmented in the largest rooms left, so that they are cut in as few
+	 * PPDUs as possible, then the fragments are sized in burst order, the order of reception */
+	for (i = 0; i < alpdus_nr; i++) {
+		const size_t first = *plan_nr;
+		size_t to_claim;
+		size_t claimed = 0;
+		size_t kept;
+		size_t j;
+
+		if (alpdus[i].remaining == 0) {
+			continue;
+		}
+
+		to_claim = alpdus[i].remaining;
+		if (!alpdus[i].started) {
+			to_claim += alpdus[i].trailer_len + sizeof(rle_ppdu_hdr_start_t) -
+			            sizeof(rle_ppdu_hdr_cont_end_t);
+		}
+
+		while (claimed < to_claim) {
+			size_t best_burst = bursts_nr;
+			size_t best_room = 0;
+			size_t burst;
+
+			for (burst = 0; burst < bursts_nr; burst++) {
+				const size_t room = plan_burst_room(burst_sizes, label_size, plan, *plan_nr, burst);
+
+				if (room > best_room) {
+					best_burst = burst;
+					best_room = room;
+				}
+			}
+
+			if (best_burst == bursts_nr ||
+			    best_room <= sizeof(rle_ppdu_hdr_cont_end_t) ||
+			    (best_room < (sizeof(rle_ppdu_hdr_cont_end_t) + min_frag_len) &&
+			     best_room < (sizeof(rle_ppdu_hdr_cont_end_t) + to_claim - claimed))) {
+				break;
+			}
+
+			if (best_room > PLAN_MAX_PPDU_LEN) {
+				best_room = PLAN_MAX_PPDU_LEN;
+			}
+			if (!plan_push(plan, plan_max_nr, plan_nr, best_burst, alpdus[i].frag_id, best_room)) {
+				goto error;
+			}
+			claimed += best_room - sizeof(rle_ppdu_hdr_cont_end_t);
+		}
+
+		plan_sort(plan + first, (*plan_nr) - first);
+
+		/* size the fragments in the claimed rooms, and give the unused rooms back */
+		kept = first;
+		for (j = first; j < (*plan_nr); j++) {
+			const size_t ppdu_length =
+				plan_fragment(&alpdus[i], plan[j].ppdu_length, min_frag_len);
+
+			if (ppdu_length > 0) {
+				plan[kept] = plan[j];
+				plan[kept].ppdu_length = ppdu_length;
+				kept++;
+			}
+		}
+		*plan_nr = kept;
+	}
+
+	plan_sort(plan, *plan_nr);
+
+	return 0;
+
+error:
+	*plan_nr = 0;
+	return 1;
+}
+
+static enum rle_pack_status plan_pack_ppdu(struct rle_transmitter *const transmitter,
+                                           const struct rle_burst_plan_ppdu *const ppdu_plan,
+                                           const unsigned char *const label,
+                                           const size_t label_size,
+                                           unsigned char *const fpdu,
+                                           size_t *const fpdu_current_pos,
+                                           size_t *const fpdu_remaining_size)
+{
+	const size_t label_len_in_fpdu = ((*fpdu_current_pos) == 0 ? label_size : 0);
+	enum rle_frag_status frag_status;
+	unsigned char *ppdu;
+	size_t ppdu_length;
+
+	if (fpdu == NULL) {
+		return RLE_PACK_ERR;
+	}
+
+	/* check the room before fragmenting, so that no PPDU is built then lost */
+	if ((*fpdu_remaining_size) < (label_len_in_fpdu + ppdu_plan->ppdu_length)) {
+		return RLE_PACK_ERR_FPDU_TOO_SMALL;
+	}
+
+	frag_status = rle_fragment(transmitter, ppdu_plan->frag_id, ppdu_plan->ppdu_length, &ppdu,
+	                           &ppdu_length);
+	switch (frag_status) {
+	case RLE_FRAG_OK:
+		break;
+	case RLE_FRAG_ERR_BURST_TOO_SMALL:
+		return RLE_PACK_ERR_FPDU_TOO_SMALL;
+	case RLE_FRAG_ERR_CONTEXT_IS_NULL:
+		return RLE_PACK_ERR_INVALID_PPDU;
+	default:
+		return RLE_PACK_ERR;
+	}
+
+	return rle_pack(ppdu, ppdu_length, label, label_size, fpdu, fpdu_current_pos,
+	                fpdu_remaining_size);
+}
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
@@ -87,6 +547,9 @@ enum rle_pack_status rle_pack_init(const unsigned char *const label,
 
 	/* when FPDU is empty, copy the FPDU label before the first PPDU */
 	memcpy(fpdu, label, label_size);
+#ifdef RLE_COPY_STATS
+	rle_copy_add_shared(&pack_copy_stats, label_size);
+#endif
 	(*fpdu_current_pos) += label_size;
 	(*fpdu_remaining_size) -= label_size;
 
@@ -105,6 +568,9 @@ enum rle_pack_status rle_pack(const unsigned char *const ppdu,
                               size_t *const fpdu_remaining_size)
 {
 	enum rle_pack_status status;
+#ifdef RLE_TIMING
+	const uint64_t start = rle_timing_now();
+#endif
 
 	if (ppdu == NULL || ppdu_length == 0) {
 		status = RLE_PACK_ERR_INVALID_PPDU;
@@ -132,21 +598,291 @@ enum rle_pack_status rle_pack(const unsigned char *const ppdu,
 	/* when FPDU is empty, copy the FPDU label before the first PPDU */
 	if ((*fpdu_current_pos) == 0 && label_size > 0) {
 		memcpy(fpdu, label, label_size);
+#ifdef RLE_COPY_STATS
+		rle_copy_add_shared(&pack_copy_stats, label_size);
+#endif
 		(*fpdu_current_pos) += label_size;
 		(*fpdu_remaining_size) -= label_size;
 	}
 
 	/* copy the PPDU */
 	memcpy(fpdu + (*fpdu_current_pos), ppdu, ppdu_length);
+#ifdef RLE_COPY_STATS
+	rle_copy_add_shared(&pack_copy_stats, ppdu_length);
+#endif
 	(*fpdu_current_pos) += ppdu_length;
 	(*fpdu_remaining_size) -= ppdu_length;
 
 	status = RLE_PACK_OK;
 
+exit_label:
+#ifdef RLE_TIMING
+	rle_timing_add_shared(&pack_timing, rle_timing_now() - start);
+#endif
+	return status;
+}
+
+enum rle_pack_status rle_fragment_pack(struct rle_transmitter *const transmitter,
+                                       const uint8_t frag_id,
+                                       const unsigned char *const label,
+                                       const size_t label_size,
+                                       unsigned char *const fpdu,
+                                       size_t *const fpdu_current_pos,
+                                       size_t *const fpdu_remaining_size,
+                                       size_t *const used_size)
+{
+	enum rle_pack_status status;
+	enum rle_frag_status frag_status;
+	const size_t ppdu_base_hdr_len = 2;
+	unsigned char *ppdu;
+	size_t ppdu_length;
+	size_t label_len_in_fpdu;
+	size_t room;
+
+	if ((label_size != 0 && label_size != 3 && label_size != 6) ||
+	    (label_size > 0 && label == NULL)) {
+		status = RLE_PACK_ERR_INVALID_LAB;
+		goto exit_label;
+	}
+	if (fpdu == NULL || fpdu_current_pos == NULL || fpdu_remaining_size == NULL ||
+	    used_size == NULL) {
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	*used_size = 0;
+
+	/* the FPDU label is only written before the first PPDU of the FPDU */
+	label_len_in_fpdu = ((*fpdu_current_pos) == 0 ? label_size : 0);
+
+	if ((*fpdu_remaining_size) <= label_len_in_fpdu) {
+		status = RLE_PACK_ERR_FPDU_TOO_SMALL;
+		goto exit_label;
+	}
+
+	/* a single PPDU cannot be larger than its length field allows */
+	room = (*fpdu_remaining_size) - label_len_in_fpdu;
+	if (room > (RLE_MAX_PPDU_PL_SIZE + ppdu_base_hdr_len)) {
+		room = RLE_MAX_PPDU_PL_SIZE + ppdu_base_hdr_len;
+	}
+
+	frag_status = rle_fragment(transmitter, frag_id, room, &ppdu, &ppdu_length);
+	switch (frag_status) {
+	case RLE_FRAG_OK:
+		break;
+	case RLE_FRAG_ERR_BURST_TOO_SMALL:
+		status = RLE_PACK_ERR_FPDU_TOO_SMALL;
+		goto exit_label;
+	case RLE_FRAG_ERR_CONTEXT_IS_NULL:
+		status = RLE_PACK_ERR_INVALID_PPDU;
+		goto exit_label;
+	default:
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	/* the PPDU header and payload are contiguous in the fragmentation buffer, so the PPDU is
+	 * written in the FPDU with a single copy, right after the optional FPDU label */
+	if (label_len_in_fpdu > 0) {
+		memcpy(fpdu, label, label_len_in_fpdu);
+		rle_copy_count(&transmitter->copy_stats, RLE_COPY_PACK, label_len_in_fpdu, 0);
+	}
+	memcpy(fpdu + (*fpdu_current_pos) + label_len_in_fpdu, ppdu, ppdu_length);
+	rle_copy_count(&transmitter->copy_stats, RLE_COPY_PACK, ppdu_length, 0);
+
+	*used_size = label_len_in_fpdu + ppdu_length;
+	(*fpdu_current_pos) += (*used_size);
+	(*fpdu_remaining_size) -= (*used_size);
+
+	status = RLE_PACK_OK;
+
+exit_label:
+	return status;
+}
+
+int rle_plan_bursts(const struct rle_transmitter *const transmitter,
+                    const size_t burst_sizes[],
+                    const size_t bursts_nr,
+                    const size_t label_size,
+                    struct rle_burst_plan_ppdu plan[],
+                    const size_t plan_max_nr,
+                    size_t *const plan_nr)
+{
+	return plan_bursts(transmitter, burst_sizes, bursts_nr, label_size, PLAN_MIN_FRAG_LEN, plan,
+	                   plan_max_nr, plan_nr);
+}
+
+enum rle_pack_status rle_pack_plan(struct rle_transmitter *const transmitter,
+                                   const struct rle_burst_plan_ppdu plan[],
+                                   const size_t plan_nr,
+                                   const unsigned char *const label,
+                                   const size_t label_size,
+                                   unsigned char *const fpdus[],
+                                   size_t fpdus_current_pos[],
+                                   size_t fpdus_remaining_size[])
+{
+	enum rle_pack_status status = RLE_PACK_OK;
+	size_t i;
+
+	if ((label_size != 0 && label_size != 3 && label_size != 6) ||
+	    (label_size > 0 && label == NULL)) {
+		status = RLE_PACK_ERR_INVALID_LAB;
+		goto exit_label;
+	}
+	if ((plan == NULL && plan_nr > 0) || fpdus == NULL || fpdus_current_pos == NULL ||
+	    fpdus_remaining_size == NULL) {
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	for (i = 0; i < plan_nr; i++) {
+		const size_t burst = plan[i].burst;
+
+		status = plan_pack_ppdu(transmitter, &plan[i], label, label_size, fpdus[burst],
+		                        &fpdus_current_pos[burst], &fpdus_remaining_size[burst]);
+		if (status != RLE_PACK_OK) {
+			goto exit_label;
+		}
+	}
+
 exit_label:
 	return status;
 }
 
+enum rle_pack_status rle_pack_superframe(struct rle_transmitter *const transmitter,
+                                         const unsigned char *const label,
+                                         const size_t label_size,
+                                         unsigned char *const fpdus[],
+                                         const size_t fpdus_sizes[],
+                                         const size_t fpdus_nr,
+                                         struct rle_burst_plan_ppdu plan[],
+                                         const size_t plan_max_nr,
+                                         size_t *const padding_size)
+{
+	enum rle_pack_status status = RLE_PACK_OK;
+	size_t plan_nr = 0;
+	size_t next = 0;
+	size_t fpdu;
+
+	if ((label_size != 0 && label_size != 3 && label_size != 6) ||
+	    (label_size > 0 && label == NULL)) {
+		status = RLE_PACK_ERR_INVALID_LAB;
+		goto exit_label;
+	}
+	if (fpdus == NULL || fpdus_sizes == NULL || padding_size == NULL) {
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	*padding_size = 0;
+
+	/* every byte of room is worth filling, down to the smallest fragment */
+	if (plan_bursts(transmitter, fpdus_sizes, fpdus_nr, label_size, 1, plan, plan_max_nr,
+	                &plan_nr) != 0) {
+		status = RLE_PACK_ERR;
+		goto exit_label;
+	}
+
+	/* the plan is sorted by FPDU, so the FPDUs are filled and padded one after the other */
+	for (fpdu = 0; fpdu < fpdus_nr; fpdu++) {
+		size_t fpdu_current_pos = 0;
+		size_t fpdu_remaining_size = fpdus_sizes[fpdu];
+
+		if (fpdus[fpdu] == NULL) {
+			status = RLE_PACK_ERR;
+			goto exit_label;
+		}
+
+		for (; next < plan_nr && plan[next].burst == fpdu; next++) {
+			status = plan_pack_ppdu(transmitter, &plan[next], label, label_size, fpdus[fpdu],
+			                        &fpdu_current_pos, &fpdu_remaining_size);
+			if (status != RLE_PACK_OK) {
+				goto exit_label;
+			}
+		}
+
+		/* an FPDU without PPDU is still sent, with its label */
+		if (fpdu_current_pos == 0) {
+			status = rle_pack_init(label, label_size, fpdus[fpdu], &fpdu_current_pos,
+			                       &fpdu_remaining_size);
+			if (status != RLE_PACK_OK) {
+				goto exit_label;
+			}
+		}
+
+		rle_pad(fpdus[fpdu], fpdu_current_pos, fpdu_remaining_size);
+		(*padding_size) += fpdu_remaining_size;
+	}
+
+exit_label:
+	return status;
+}
+
+enum rle_header_size_status rle_estimate_overhead(const struct rle_config *const conf,
+                                                  const size_t sdu_length,
+                                                  const uint16_t protocol_type,
+                                                  const size_t burst_sizes[],
+                                                  const size_t bursts_nr,
+                                                  struct rle_overhead_estimate *const estimate)
+{
+	enum rle_header_size_status status;
+	struct plan_alpdu alpdu;
+	bool use_alpdu_crc;
+	size_t alpdu_sent;
+	size_t sdu_sent;
+	size_t burst;
+
+	if (estimate == NULL || (burst_sizes == NULL && bursts_nr > 0) ||
+	    sdu_length > RLE_MAX_PDU_SIZE) {
+		status = RLE_HEADER_SIZE_ERR;
+		goto error;
+	}
+
+	status = rle_get_alpdu_header_size(conf, protocol_type, &alpdu.hdr_len);
+	if (status != RLE_HEADER_SIZE_OK) {
+		goto error;
+	}
+
+	use_alpdu_crc = (conf->allow_alpdu_sequence_number ? false : !!conf->allow_alpdu_crc);
+
+	alpdu.frag_id = 0;
+	alpdu.started = false;
+	alpdu.remaining = alpdu.hdr_len + sdu_length;
+	alpdu.trailer_len = (use_alpdu_crc ? RLE_CRC_SIZE : RLE_SEQ_NO_FIELD_SIZE);
+	alpdu.crc_len = (use_alpdu_crc ? RLE_CRC_SIZE : 0);
+
+	memset(estimate, 0, sizeof(struct rle_overhead_estimate));
+
+	for (burst = 0; burst < bursts_nr && alpdu.remaining > 0; burst++) {
+		size_t room = burst_sizes[burst];
+		size_t ppdu_length = plan_fragment(&alpdu, room, 1);
+
+		if (ppdu_length > 0) {
+			estimate->bursts_nr++;
+		}
+		while (ppdu_length > 0) {
+			estimate->ppdus_nr++;
+			estimate->ppdus_bytes += ppdu_length;
+			room -= ppdu_length;
+			ppdu_length = plan_fragment(&alpdu, room, 1);
+		}
+	}
+
+	/* the ALPDU is the ALPDU header, the SDU, then the trailer once fragmented */
+	alpdu_sent = alpdu.hdr_len + sdu_length + (alpdu.started ? alpdu.trailer_len : 0) -
+	             alpdu.remaining;
+	sdu_sent = (alpdu_sent > alpdu.hdr_len ? alpdu_sent - alpdu.hdr_len : 0);
+	if (sdu_sent > sdu_length) {
+		sdu_sent = sdu_length;
+	}
+
+	estimate->overhead_bytes = estimate->ppdus_bytes - sdu_sent;
+	estimate->remaining = alpdu.remaining;
+
+error:
+	return status;
+}
+
 void rle_pad(unsigned char *const fpdu,
              const size_t fpdu_current_pos,
              const size_t fpdu_remaining_size)
@@ -155,3 +891,78 @@ void rle_pad(unsigned char *const fpdu,
 		memset(fpdu + fpdu_current_pos, 0, fpdu_remaining_size);
 	}
 }
+
+int rle_timing_is_enabled(void)
+{
+#ifdef RLE_TIMING
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+int rle_pack_timing_get(struct rle_timing_histogram *const histogram)
+{
+	int status = 1;
+
+	if (histogram == NULL) {
+		goto error;
+	}
+
+#ifdef RLE_TIMING
+	rle_timing_read(&pack_timing, histogram);
+	status = 0;
+#endif
+
+error:
+	return status;
+}
+
+void rle_pack_timing_reset(void)
+{
+#ifdef RLE_TIMING
+	memset(&pack_timing, 0, sizeof(pack_timing));
+#endif
+}
+
+int rle_copy_stats_is_enabled(void)
+{
+#ifdef RLE_COPY_STATS
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+int rle_size_stats_is_enabled(void)
+{
+#ifdef RLE_SIZE_STATS
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+int rle_pack_copy_stats_get(struct rle_copy_counters *const counters)
+{
+	int status = 1;
+
+	if (counters == NULL) {
+		goto error;
+	}
+
+#ifdef RLE_COPY_STATS
+	rle_copy_read(&pack_copy_stats, counters);
+	status = 0;
+#endif
+
+error:
+	return status;
+}
+
+void rle_pack_copy_stats_reset(void)
+{
+#ifdef RLE_COPY_STATS
+	memset(&pack_copy_stats, 0, sizeof(pack_copy_stats));
+#endif
+}
@@ -33,6 +33,7 @@
 #include "trailer.h"
 #include "crc.h"
 #include "rle_header_proto_type_field.h"
+#include "rle_trace.h"
 
 #ifndef __KERNEL__
 
@@ -55,46 +56,149 @@
 #define MODULE_ID RLE_MOD_ID_REASSEMBLY
 
 
-static bool reassembly_insert_vlan_ptype(const uint8_t *const sdu_frag,
-                                         const size_t sdu_frag_len,
-                                         struct rle_sdu *const reassembled_sdu)
-__attribute__((warn_unused_result, nonnull(1, 3)));
-
-
 /**
- * @brief Insert the suppressed VLAN protocol type in the given VLAN/IP SDU
+ * @brief Deduce the suppressed VLAN protocol type of the given VLAN/IP SDU
  *
  * This function helps handling the special case for VLAN with embedded IPv4/IPv6:
  * the protocol field of the VLAN header is suppressed by the RLE transmitter and
  * shall be rebuilt by the RLE receiver according to the first 4 bits of the IP
  * payload.
  *
+ * @param      receiver          The receiver, for its logs
+ * @param      sdu_frag          The combined SDU fragments extracted from PPDUs
+ * @param      sdu_frag_len      The length of the combined SDU fragments extracted from PPDUs
+ * @param[out] vlan_ptype        The VLAN protocol type to insert back
+ * @return                       true if the protocol type was deduced,
+ *                               false if frame is too short or malformed
+ */
+static bool reassembly_get_vlan_ptype(const struct rle_receiver *const receiver,
+                                      const uint8_t *const sdu_frag,
+                                      const size_t sdu_frag_len,
+                                      uint16_t *const vlan_ptype)
+__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+/**
+ * @brief Insert the suppressed VLAN protocol type in a copy of the given VLAN/IP SDU
+ *
+ * @param      receiver          The receiver, for its logs
  * @param      sdu_frag          The combined SDU fragments extracted from PPDUs
  * @param      sdu_frag_len      The length of the combined SDU fragments extracted from PPDUs
  * @param[out] reassembled_sdu   The reassembled SDU with the VLAN protocol type inserted
  * @return                       true if insertion was successful,
  *                               false if frame is too short or malformed
  */
-static bool reassembly_insert_vlan_ptype(const uint8_t *const sdu_frag,
+static bool reassembly_insert_vlan_ptype(const struct rle_receiver *const receiver,
+                                         const uint8_t *const sdu_frag,
                                          const size_t sdu_frag_len,
                                          struct rle_sdu *const reassembled_sdu)
+__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+/**
+ * @brief Insert the suppressed VLAN protocol type in place in the given VLAN/IP SDU
+ *
+ * The Ethernet header and the first part of the VLAN header are moved 2 bytes backwards, so
+ * the 2 bytes before the SDU shall be writable.
+ *
+ * @param      receiver          The receiver, for its logs
+ * @param      sdu_frag          The combined SDU fragments extracted from PPDUs
+ * @param      sdu_frag_len      The length of the combined SDU fragments extracted from PPDUs
+ * @param[out] reassembled_sdu   The reassembled SDU, pointing 2 bytes before the given one
+ * @return                       true if insertion was successful,
+ *                               false if frame is too short or malformed
+ */
+static bool reassembly_insert_vlan_ptype_in_place(const struct rle_receiver *const receiver,
+                                                  uint8_t *const sdu_frag,
+                                                  const size_t sdu_frag_len,
+                                                  struct rle_sdu *const reassembled_sdu)
+__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+/**
+ * @brief Copy a SDU fragment in its reassembly buffer, counting the copy
+ *
+ * @param      receiver          The receiver of the reassembly buffer
+ * @param      rasm_buf          The reassembly buffer, with the room for the fragment put
+ * @param      sdu_frag          The SDU fragment extracted from the PPDU
+ * @param      sdu_frag_len      The length of the SDU fragment
+ */
+static void reassembly_cpy_sdu_frag(struct rle_receiver *const receiver,
+                                    rle_rasm_buf_t *const rasm_buf,
+                                    const unsigned char sdu_frag[],
+                                    const size_t sdu_frag_len);
+
+
+/**
+ * @brief Start streaming a SDU announced by a PPDU START, see rle_receiver_set_stream()
+ *
+ * @param      receiver          The receiver streaming the SDU
+ * @param      frag_id           The fragment id of the SDU
+ * @param      ptype             The protocol type of the SDU, uncompressed
+ * @param      sdu_len           The size of the SDU
+ * @param      is_crc_used       Whether the ALPDU trailer is a CRC
+ */
+static void reassembly_stream_start(struct rle_receiver *const receiver,
+                                    const uint8_t frag_id,
+                                    const uint16_t ptype,
+                                    const size_t sdu_len,
+                                    const bool is_crc_used);
+
+/**
+ * @brief Give the bytes of a streamed SDU to the data callback, updating its CRC on the way
+ *
+ * @param      receiver          The receiver streaming the SDU
+ * @param      frag_id           The fragment id of the SDU
+ * @param      sdu_frag          The SDU fragment extracted from the PPDU
+ * @param      sdu_frag_len      The length of the SDU fragment, within the SDU size
+ */
+static void reassembly_stream_frag(struct rle_receiver *const receiver,
+                                   const uint8_t frag_id,
+                                   const unsigned char sdu_frag[],
+                                   const size_t sdu_frag_len);
+
+/**
+ * @brief End streaming a SDU with the last bytes of a PPDU END, and give its verdict
+ *
+ * @param      receiver          The receiver streaming the SDU
+ * @param      frag_id           The fragment id of the SDU
+ * @param      sdu_frag          The SDU fragment extracted from the PPDU
+ * @param      sdu_frag_len      The length of the SDU fragment
+ * @param      trailer           The ALPDU trailer, after the SDU fragment
+ * @param[out] lost_packets      The number of SDUs lost, given by the trailer
+ * @return                       C_OK if the SDU is valid, C_ERROR otherwise, the verdict given
+ *                               unless the SDU is not complete
+ */
+static int reassembly_stream_end(struct rle_receiver *const receiver,
+                                 const uint8_t frag_id,
+                                 const unsigned char sdu_frag[],
+                                 const size_t sdu_frag_len,
+                                 const rle_alpdu_trailer_t *const trailer,
+                                 size_t *const lost_packets);
+
+/*------------------------------------------------------------------------------------------------*/
+/*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static bool reassembly_get_vlan_ptype(const struct rle_receiver *const receiver,
+                                      const uint8_t *const sdu_frag,
+                                      const size_t sdu_frag_len,
+                                      uint16_t *const vlan_ptype)
 {
 	/* minimum SDU length:
 	 *    Ethernet header + VLAN header w/o protocol field + 1 byte of IP header */
 	const size_t comp_eth_vlan_len =
 		sizeof(struct ether_header) + sizeof(struct vlan_hdr) - sizeof(uint16_t);
 	const size_t sdu_min_len = comp_eth_vlan_len + 1;
-	uint16_t vlan_uncomp_ptype;
 
-	RLE_DEBUG("compressed protocol type 0x%02x requires to insert back the "
-	          "protocol type in the VLAN header with information from the IP "
-	          "payload", RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD);
+	RLE_DEBUG_TO(&receiver->log_sink,
+	             "compressed protocol type 0x%02x requires to insert back the protocol type "
+	             "in the VLAN header with information from the IP payload",
+	             RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD);
 
 	/* drop frames that are too short: the protocol type cannot be deduced from the VLAN payload */
 	if (sdu_frag_len < sdu_min_len) {
-		RLE_ERR("ALPDU fragment is too short to deduce the VLAN protocol type "
-		        "from the first IP byte: %zu bytes available, %zu bytes required "
-		        "at least\n", sdu_frag_len, sdu_min_len);
+		RLE_ERR_TO(&receiver->log_sink,
+		           "ALPDU fragment is too short to deduce the VLAN protocol type from the "
+		           "first IP byte: %zu bytes available, %zu bytes required at least\n",
+		           sdu_frag_len, sdu_min_len);
 		goto error;
 	}
 
@@ -110,25 +214,47 @@ static bool reassembly_insert_vlan_ptype(const uint8_t *const sdu_frag,
 
 		/* drop frames with unexpected protocol type in Ethernet frame: it should be VLAN */
 		if (eth_proto_type != RLE_PROTO_TYPE_VLAN_UNCOMP) {
-			RLE_ERR("failed to deduce VLAN protocol type from VLAN payload: unknown "
-			        "Ethernet protocol type 0x%04x instead of VLAN\n", eth_proto_type);
+			RLE_ERR_TO(&receiver->log_sink,
+			           "failed to deduce VLAN protocol type from VLAN payload: unknown "
+			           "Ethernet protocol type 0x%04x instead of VLAN\n", eth_proto_type);
 			goto error;
 		}
 
 		/* deduce VLAN protocol type from the first 4 bits of the VLAN payload */
 		switch (ip_version) {
 		case 4:
-			vlan_uncomp_ptype = RLE_PROTO_TYPE_IPV4_UNCOMP;
+			*vlan_ptype = RLE_PROTO_TYPE_IPV4_UNCOMP;
 			break;
 		case 6:
-			vlan_uncomp_ptype = RLE_PROTO_TYPE_IPV6_UNCOMP;
+			*vlan_ptype = RLE_PROTO_TYPE_IPV6_UNCOMP;
 			break;
 		default:
-			RLE_ERR("failed to deduce VLAN protocol type from VLAN payload: "
-			        "unknown IP version %u\n", ip_version);
+			RLE_ERR_TO(&receiver->log_sink,
+			           "failed to deduce VLAN protocol type from VLAN payload: "
+			           "unknown IP version %u\n", ip_version);
 			goto error;
 		}
-		RLE_DEBUG("IP version %u detected in VLAN payload", ip_version);
+		RLE_DEBUG_TO(&receiver->log_sink, "IP version %u detected in VLAN payload",
+		             ip_version);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+static bool reassembly_insert_vlan_ptype(const struct rle_receiver *const receiver,
+                                         const uint8_t *const sdu_frag,
+                                         const size_t sdu_frag_len,
+                                         struct rle_sdu *const reassembled_sdu)
+{
+	const size_t comp_eth_vlan_len =
+		sizeof(struct ether_header) + sizeof(struct vlan_hdr) - sizeof(uint16_t);
+	uint16_t vlan_uncomp_ptype;
+
+	if (!reassembly_get_vlan_ptype(receiver, sdu_frag, sdu_frag_len, &vlan_uncomp_ptype)) {
+		return false;
 	}
 
 	reassembled_sdu->size = sdu_frag_len + sizeof(uint16_t);
@@ -150,9 +276,143 @@ static bool reassembly_insert_vlan_ptype(const uint8_t *const sdu_frag,
 	       sdu_frag + comp_eth_vlan_len, sdu_frag_len - comp_eth_vlan_len);
 
 	return true;
+}
 
-error:
-	return false;
+static bool reassembly_insert_vlan_ptype_in_place(const struct rle_receiver *const receiver,
+                                                  uint8_t *const sdu_frag,
+                                                  const size_t sdu_frag_len,
+                                                  struct rle_sdu *const reassembled_sdu)
+{
+	const size_t comp_eth_vlan_len =
+		sizeof(struct ether_header) + sizeof(struct vlan_hdr) - sizeof(uint16_t);
+	uint8_t *const sdu = sdu_frag - sizeof(uint16_t);
+	uint16_t vlan_uncomp_ptype;
+
+	if (!reassembly_get_vlan_ptype(receiver, sdu_frag, sdu_frag_len, &vlan_uncomp_ptype)) {
+		return false;
+	}
+
+	/* move the Ethernet header and the first part of the VLAN header backwards, the VLAN
+	 * payload stays where it is */
+	memmove(sdu, sdu_frag, comp_eth_vlan_len);
+
+	/* insert the protocol type field in the VLAN header */
+	{
+		struct ether_header *const eth_hdr_new = (struct ether_header *)sdu;
+		struct vlan_hdr *const vlan_hdr_new = (struct vlan_hdr *)(eth_hdr_new + 1);
+		vlan_hdr_new->tpid = htons(vlan_uncomp_ptype);
+	}
+
+	reassembled_sdu->buffer = sdu;
+	reassembled_sdu->size = sdu_frag_len + sizeof(uint16_t);
+	reassembled_sdu->protocol_type = RLE_PROTO_TYPE_VLAN_UNCOMP;
+
+	return true;
+}
+
+static void reassembly_cpy_sdu_frag(struct rle_receiver *const receiver,
+                                    rle_rasm_buf_t *const rasm_buf,
+                                    const unsigned char sdu_frag[],
+                                    const size_t sdu_frag_len)
+{
+	rasm_buf_cpy_sdu_frag(rasm_buf, sdu_frag);
+
+#ifdef RLE_COPY_STATS
+	if (sdu_frag_len > 0) {
+		rle_copy_count(&receiver->copy_stats, RLE_COPY_RASM_FRAG, sdu_frag_len,
+		               rasm_buf->crc_on_the_fly ? sdu_frag_len : 0);
+	}
+#else
+	(void)receiver;
+	(void)sdu_frag_len;
+#endif
+}
+
+
+static void reassembly_stream_start(struct rle_receiver *const receiver,
+                                    const uint8_t frag_id,
+                                    const uint16_t ptype,
+                                    const size_t sdu_len,
+                                    const bool is_crc_used)
+{
+	struct rle_rcv_stream *const stream = &receiver->streams[frag_id];
+
+	stream->sdu_len = sdu_len;
+	stream->received = 0;
+	stream->protocol_type = ptype;
+	if (is_crc_used) {
+		stream->crc = compute_crc32_ptype(ptype);
+	}
+	receiver->stream_ctx |= (1 << frag_id);
+}
+
+static void reassembly_stream_frag(struct rle_receiver *const receiver,
+                                   const uint8_t frag_id,
+                                   const unsigned char sdu_frag[],
+                                   const size_t sdu_frag_len)
+{
+	struct rle_rcv_stream *const stream = &receiver->streams[frag_id];
+	const struct rle_stream_chunk chunk = {
+		.data = sdu_frag,
+		.length = sdu_frag_len,
+		.offset = stream->received,
+		.sdu_size = stream->sdu_len,
+		.protocol_type = stream->protocol_type,
+	};
+
+	assert(stream->received + sdu_frag_len <= stream->sdu_len);
+
+	if (rle_ctx_get_use_crc(&receiver->rle_ctx_man[frag_id]) && sdu_frag_len > 0) {
+		stream->crc = compute_crc(sdu_frag, sdu_frag_len, stream->crc);
+	}
+	stream->received += sdu_frag_len;
+	receiver->stream.data(receiver->stream.arg, frag_id, &chunk);
+}
+
+static int reassembly_stream_end(struct rle_receiver *const receiver,
+                                 const uint8_t frag_id,
+                                 const unsigned char sdu_frag[],
+                                 const size_t sdu_frag_len,
+                                 const rle_alpdu_trailer_t *const trailer,
+                                 size_t *const lost_packets)
+{
+	const struct rle_rcv_stream *const stream = &receiver->streams[frag_id];
+	struct rle_ctx_mngt *const rle_ctx = &receiver->rle_ctx_man[frag_id];
+	const bool is_crc_used = rle_ctx_get_use_crc(rle_ctx);
+	const struct rle_sdu sdu = {
+		.buffer = NULL,
+		.size = stream->sdu_len,
+		.protocol_type = stream->protocol_type,
+	};
+
+	if (stream->received + sdu_frag_len != stream->sdu_len) {
+		RLE_ERR_TO(&receiver->log_sink,
+		           "PPDU END with frag id %d ends a %zu-byte SDU after %zu bytes", frag_id,
+		           stream->sdu_len, stream->received + sdu_frag_len);
+		rle_rcv_count_error(receiver, stream->received + sdu_frag_len > stream->sdu_len ?
+		                    RLE_RCV_ERR_SDU_TOO_LONG : RLE_RCV_ERR_SDU_TOO_SHORT);
+		return C_ERROR;
+	}
+	reassembly_stream_frag(receiver, frag_id, sdu_frag, sdu_frag_len);
+
+	/* the bytes are already used by the consumer, the verdict tells it whether to keep them */
+	if (check_alpdu_trailer(trailer, &sdu, &stream->crc, rle_ctx,
+	                        &(receiver->is_ctx_seqnum_init[frag_id]), lost_packets) != 0) {
+		RLE_ERR_TO(&receiver->log_sink, "Wrong RLE trailer.");
+		rle_rcv_count_error(receiver, is_crc_used ? RLE_RCV_ERR_CRC : RLE_RCV_ERR_SEQNO);
+		rle_receiver_stream_end(receiver, frag_id, is_crc_used ? RLE_STREAM_ERR_CRC :
+		                        RLE_STREAM_ERR_SEQNO);
+		return C_ERROR;
+	}
+
+	/* update link status */
+	rle_ctx_incr_counter_bytes_ok(rle_ctx, sdu.size);
+	rle_ctx_incr_counter_ok(rle_ctx);
+	rle_size_ppdu(&rle_ctx->lk_status->size_stats);
+	rle_size_sdu_end(&rle_ctx->lk_status->size_stats, sdu.size);
+	rle_receiver_stream_end(receiver, frag_id, RLE_STREAM_OK);
+
+	return C_OK;
 }
 
 
@@ -163,7 +423,8 @@ error:
 int reassembly_comp_ppdu(struct rle_receiver *_this,
                          unsigned char *const ppdu,
                          const size_t ppdu_length,
-                         struct rle_sdu *const reassembled_sdu)
+                         struct rle_sdu *const reassembled_sdu,
+                         const bool zero_copy)
 {
 	int ret = C_ERROR;
 	unsigned char *alpdu_frag;
@@ -172,51 +433,25 @@ int reassembly_comp_ppdu(struct rle_receiver *_this,
 	size_t sdu_frag_len;
 	uint16_t ptype;
 	uint8_t comp_ptype;
+	alpdu_extract_sdu_frag_t extract;
 	rle_ppdu_hdr_comp_t *const header = (rle_ppdu_hdr_comp_t *)ppdu;
 
-#ifdef TIME_DEBUG
-	struct timeval tv_start = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_end = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_delta;
-	gettimeofday(&tv_start, NULL);
-#endif
-
-	RLE_DEBUG("handle PPDU COMP");
+	RLE_DEBUG_TO(&_this->log_sink, "handle PPDU COMP");
 
 	comp_ppdu_extract_alpdu_frag(ppdu, ppdu_length, &alpdu_frag, &alpdu_frag_len);
 
 	if (alpdu_frag_len == 0) {
-		RLE_WARN("warning: 0-byte ALPDU in Complete PPDU");
+		RLE_WARN_TO(&_this->log_sink, "warning: 0-byte ALPDU in Complete PPDU");
 	}
 
-	if (rle_comp_ppdu_hdr_get_is_suppressed(header)) {
-		/* protocol type is suppressed */
-		if (rle_comp_ppdu_hdr_get_is_signal(header)) {
-			/* ALPDU label type 3 means that the implicit protocol type is L2S */
-			ret = signal_alpdu_extract_sdu_frag(alpdu_frag, alpdu_frag_len,
-			                                    &ptype, &comp_ptype,
-			                                    &sdu_frag, &sdu_frag_len);
-		} else {
-			/* ALPDU label type 0, 1 or 2 mean that the implicit protocol type
-			 * is given by the configuration */
-			ret = suppr_alpdu_extract_sdu_frag(alpdu_frag, alpdu_frag_len,
-			                                   &ptype, &comp_ptype,
-			                                   &sdu_frag, &sdu_frag_len,
-			                                   &_this->conf);
-		}
-	} else if (_this->conf.use_compressed_ptype) {
-		/* protocol type is not suppressed, but compressed */
-		ret = comp_alpdu_extract_sdu_frag(alpdu_frag, alpdu_frag_len,
-		                                  &ptype, &comp_ptype,
-		                                  &sdu_frag, &sdu_frag_len, NULL);
-	} else {
-		/* protocol type is not suppressed nor compressed */
-		ret = uncomp_alpdu_extract_sdu_frag(alpdu_frag, alpdu_frag_len,
-		                                    &ptype, &comp_ptype,
-		                                    &sdu_frag, &sdu_frag_len);
-	}
+	/* the ALPDU header format is given by the label type and the proto type suppressed bit */
+	extract = _this->decoder.extractors[rle_rcv_alpdu_format(header->label_type,
+	                                                         header->proto_type_supp)];
+	ret = extract(alpdu_frag, alpdu_frag_len, &ptype, &comp_ptype, &sdu_frag, &sdu_frag_len,
+	              NULL, &_this->conf);
 
 	if (ret) {
+		rle_rcv_count_error(_this, RLE_RCV_ERR_ALPDU_HDR);
 		ret = C_ERROR;
 		goto out;
 	}
@@ -225,30 +460,50 @@ int reassembly_comp_ppdu(struct rle_receiver *_this,
 		/* SDU is complete */
 		reassembled_sdu->size = sdu_frag_len;
 		reassembled_sdu->protocol_type = ptype;
-		memcpy(reassembled_sdu->buffer, sdu_frag, sdu_frag_len);
+		if (zero_copy) {
+			/* the SDU is contiguous in the PPDU, so no need to copy it */
+			reassembled_sdu->buffer = (unsigned char *)sdu_frag;
+		} else {
+			memcpy(reassembled_sdu->buffer, sdu_frag, sdu_frag_len);
+			rle_copy_count(&_this->copy_stats, RLE_COPY_RASM_COMP, sdu_frag_len, 0);
+		}
 	} else {
 		assert(ptype == RLE_PROTO_TYPE_VLAN_UNCOMP);
 
 		/* special case for VLAN with embedded IPv4/IPv6: the protocol field of the VLAN
 		 * header is suppressed by the RLE transmitter and shall be rebuilt by the RLE
 		 * receiver according to the first 4 bits of the IP payload */
-		if (!reassembly_insert_vlan_ptype(sdu_frag, sdu_frag_len, reassembled_sdu)) {
-			RLE_ERR("failed to insert VLAN protocol type in Ethernet/VLAN/IP headers");
+		bool inserted;
+		if (zero_copy) {
+			/* rebuild the VLAN header in the FPDU, over the end of the PPDU header */
+			unsigned char *const sdu_in_ppdu = ppdu + (sdu_frag - ppdu);
+			inserted = reassembly_insert_vlan_ptype_in_place(_this, sdu_in_ppdu,
+			                                                 sdu_frag_len, reassembled_sdu);
+		} else {
+			inserted = reassembly_insert_vlan_ptype(_this, sdu_frag, sdu_frag_len,
+			                                        reassembled_sdu);
+		}
+		if (!inserted) {
+			RLE_ERR_TO(&_this->log_sink,
+			           "failed to insert VLAN protocol type in Ethernet/VLAN/IP "
+			           "headers");
+			rle_rcv_count_error(_this, RLE_RCV_ERR_VLAN);
 			ret = C_ERROR;
 			goto out;
 		}
+		/* in place, only the Ethernet header and the first part of the VLAN header move */
+		rle_copy_count(&_this->copy_stats, RLE_COPY_RASM_COMP,
+		               zero_copy ? sizeof(struct ether_header) + sizeof(struct vlan_hdr) -
+		               sizeof(uint16_t) : sdu_frag_len, 0);
 	}
 
+	rle_size_sdu_start(&_this->comp_size_stats);
+	rle_size_ppdu(&_this->comp_size_stats);
+	rle_size_sdu_end(&_this->comp_size_stats, reassembled_sdu->size);
+
 	ret = C_REASSEMBLY_OK;
 
 out:
-#ifdef TIME_DEBUG
-	gettimeofday(&tv_end, NULL);
-	tv_delta.tv_sec = tv_end.tv_sec - tv_start.tv_sec;
-	tv_delta.tv_usec = tv_end.tv_usec - tv_start.tv_usec;
-	RLE_DEBUG("duration [%04ld.%06ld].", tv_delta.tv_sec, tv_delta.tv_usec);
-#endif
-
 	return ret;
 }
 
@@ -273,30 +528,28 @@ int reassembly_start_ppdu(struct rle_receiver *_this,
 	size_t alpdu_hdr_len;
 	size_t alpdu_trailer_len;
 	int ret_extract;
-
-#ifdef TIME_DEBUG
-	struct timeval tv_start = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_end = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_delta;
-	gettimeofday(&tv_start, NULL);
-#endif
+	alpdu_extract_sdu_frag_t extract;
 
 	*index_ctx = rle_start_ppdu_hdr_get_frag_id((rle_ppdu_hdr_start_t *)ppdu);
-	RLE_DEBUG("START: fragment_id 0x%0x", *index_ctx);
-	RLE_DEBUG("handle PPDU START for context with ID %d", *index_ctx);
+	RLE_DEBUG_TO(&_this->log_sink, "START: fragment_id 0x%0x", *index_ctx);
+	RLE_DEBUG_TO(&_this->log_sink, "handle PPDU START for context with ID %d", *index_ctx);
 	assert((*index_ctx) >= 0 && (*index_ctx) <= RLE_MAX_FRAG_ID);
 
 	rle_ctx = &_this->rle_ctx_man[*index_ctx];
-	rle_ctx->current_counter = ppdu_length;
+	rle_ctx->lk_status->current_counter = ppdu_length;
 	rasm_buf = (rle_rasm_buf_t *)_this->rle_ctx_man[*index_ctx].buff;
 
 	rle_ctx_incr_counter_in(rle_ctx);
 	rle_ctx_incr_counter_bytes_in(rle_ctx, ppdu_length);
+	rle_size_sdu_start(&rle_ctx->lk_status->size_stats);
+	rle_size_ppdu(&rle_ctx->lk_status->size_stats);
 
 	if (is_context_free(_this, *index_ctx) == false) {
-		RLE_ERR("invalid Start on context not free, frag id [%d].", *index_ctx);
+		RLE_ERR_TO(&_this->log_sink,
+		           "invalid Start on context not free, frag id [%d].", *index_ctx);
 		/* Context is not free, whereas it must be. an error must have occured. */
 		/* Freeing context, updating stats, and restarting receiving. */
+		rle_rcv_count_error(_this, RLE_RCV_ERR_CTX_BUSY);
 		goto out;
 	}
 
@@ -308,72 +561,67 @@ int reassembly_start_ppdu(struct rle_receiver *_this,
 
 	sdu_total_len = alpdu_total_len;
 
-	if (rle_start_ppdu_hdr_get_is_suppressed(header)) {
-		/* protocol type is suppressed */
-		if (rle_start_ppdu_hdr_get_is_signal(header)) {
-			/* ALPDU label type 3 means that the implicit protocol type is L2S */
-			ret_extract =
-				signal_alpdu_extract_sdu_frag(alpdu_frag, alpdu_frag_len,
-				                              &ptype, &comp_ptype,
-				                              &sdu_frag, &sdu_frag_len);
-		} else {
-			ret_extract =
-				suppr_alpdu_extract_sdu_frag(alpdu_frag, alpdu_frag_len,
-				                             &ptype, &comp_ptype,
-				                             &sdu_frag, &sdu_frag_len,
-				                             &_this->conf);
-		}
-		alpdu_hdr_len = 0;
-	} else if (_this->conf.use_compressed_ptype) {
-		/* protocol type is not suppressed, but compressed */
-		ret_extract =
-			comp_alpdu_extract_sdu_frag(alpdu_frag, alpdu_frag_len,
-			                            &ptype, &comp_ptype,
-			                            &sdu_frag, &sdu_frag_len,
-			                            &alpdu_hdr_len);
-	} else {
-		/* protocol type is not suppressed nor compressed */
-		ret_extract =
-			uncomp_alpdu_extract_sdu_frag(alpdu_frag, alpdu_frag_len,
-			                              &ptype, &comp_ptype,
-			                              &sdu_frag, &sdu_frag_len);
-		alpdu_hdr_len = sizeof(rle_alpdu_hdr_uncomp_t);
-	}
+	/* the ALPDU header format is given by the label type and the proto type suppressed bit */
+	extract = _this->decoder.extractors[rle_rcv_alpdu_format(header->label_type,
+	                                                         header->proto_type_supp)];
+	ret_extract = extract(alpdu_frag, alpdu_frag_len, &ptype, &comp_ptype, &sdu_frag,
+	                      &sdu_frag_len, &alpdu_hdr_len, &_this->conf);
 	if (ret_extract) {
+		rle_rcv_count_error(_this, RLE_RCV_ERR_ALPDU_HDR);
 		goto out;
 	}
 
 	if (sdu_frag_len > sdu_total_len) {
-		RLE_ERR("PPDU START with frag id %d contains more SDU bytes than expected in total "
-		        "(%zu bytes in fragment, %zu bytes expected in total)", *index_ctx,
-		        sdu_frag_len, sdu_total_len);
+		RLE_ERR_TO(&_this->log_sink,
+		           "PPDU START with frag id %d contains more SDU bytes than expected in "
+		           "total (%zu bytes in fragment, %zu bytes expected in total)", *index_ctx,
+		           sdu_frag_len, sdu_total_len);
+		rle_rcv_count_error(_this, RLE_RCV_ERR_SDU_TOO_LONG);
 		goto out;
 	}
 	sdu_total_len -= alpdu_hdr_len;
 
 	if (is_crc_used) {
-		RLE_DEBUG("ALPDU trailer is CRC");
+		RLE_DEBUG_TO(&_this->log_sink, "ALPDU trailer is CRC");
 		alpdu_trailer_len = sizeof(rle_alpdu_crc_trailer_t);
 	} else {
-		RLE_DEBUG("ALPDU trailer is seqnum");
+		RLE_DEBUG_TO(&_this->log_sink, "ALPDU trailer is seqnum");
 		alpdu_trailer_len = sizeof(rle_alpdu_seqno_trailer_t);
 	}
 	if (alpdu_trailer_len > sdu_total_len) {
-		RLE_ERR("PPDU START with frag id %d contains too few bytes for the ALPDU trailer "
-		        "(at least %zu bytes needed, but only %zu bytes available", *index_ctx,
-		        alpdu_trailer_len, sdu_total_len);
+		RLE_ERR_TO(&_this->log_sink,
+		           "PPDU START with frag id %d contains too few bytes for the ALPDU "
+		           "trailer (at least %zu bytes needed, but only %zu bytes available",
+		           *index_ctx, alpdu_trailer_len, sdu_total_len);
+		rle_rcv_count_error(_this, RLE_RCV_ERR_SDU_TOO_SHORT);
 		goto out;
 	}
 	sdu_total_len -= alpdu_trailer_len;
 
 	rle_ctx_set_use_crc(rle_ctx, is_crc_used);
-	RLE_DEBUG("ALPDU trailer is %s",
-	          rle_ctx_get_use_crc(rle_ctx) ? "CRC" : "seqnum");
+	RLE_DEBUG_TO(&_this->log_sink, "ALPDU trailer is %s",
+	                                rle_ctx_get_use_crc(rle_ctx) ? "CRC" : "seqnum");
 
 	if (sdu_frag_len > sdu_total_len) {
-		RLE_ERR("PPDU START with frag id %d contains more SDU bytes than expected in total "
-		        "(%zu bytes in fragment, %zu bytes expected in total)", *index_ctx,
-		        sdu_frag_len, sdu_total_len);
+		RLE_ERR_TO(&_this->log_sink,
+		           "PPDU START with frag id %d contains more SDU bytes than expected in "
+		           "total (%zu bytes in fragment, %zu bytes expected in total)", *index_ctx,
+		           sdu_frag_len, sdu_total_len);
+		rle_rcv_count_error(_this, RLE_RCV_ERR_SDU_TOO_LONG);
+		goto out;
+	}
+	if (_this->stream.data != NULL && comp_ptype != RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD) {
+		/* the SDU bytes go to the consumer from the PPDUs, no reassembly storage is needed */
+		reassembly_stream_start(_this, *index_ctx, ptype, sdu_total_len, is_crc_used);
+		reassembly_stream_frag(_this, *index_ctx, sdu_frag, sdu_frag_len);
+		rle_trace(start_received, *index_ctx, ppdu_length, sdu_total_len);
+		ret = C_OK;
+		goto out;
+	}
+	if (rasm_buf_acquire_storage(rasm_buf) != 0) {
+		RLE_ERR_TO(&_this->log_sink,
+		           "no reassembly storage for the PPDU START with frag id %d", *index_ctx);
+		rle_rcv_count_error(_this, RLE_RCV_ERR_NO_STORAGE);
 		goto out;
 	}
 	rasm_buf_init(rasm_buf);
@@ -382,7 +630,13 @@ int reassembly_start_ppdu(struct rle_receiver *_this,
 	rasm_buf->sdu_info.protocol_type = ptype;
 	rasm_buf->comp_protocol_type = comp_ptype;
 	rasm_buf->sdu_info.size = sdu_total_len;
-	rasm_buf_cpy_sdu_frag(rasm_buf, sdu_frag);
+	if (is_crc_used && comp_ptype != RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD) {
+		/* CRC is updated on each fragment, END only has to compare it with the trailer. It is
+		 * computed at END for VLAN without protocol type, as the field is inserted back then */
+		rasm_buf_start_crc(rasm_buf, compute_crc32_ptype(ptype));
+	}
+	reassembly_cpy_sdu_frag(_this, rasm_buf, sdu_frag, sdu_frag_len);
+	rle_trace(start_received, *index_ctx, ppdu_length, sdu_total_len);
 
 	ret = C_OK;
 
@@ -391,17 +645,10 @@ out:
 	if (ret != C_OK) {
 		rle_ctx_incr_counter_dropped(rle_ctx);
 		rle_ctx_incr_counter_lost(rle_ctx, 1);
-		rle_ctx_incr_counter_bytes_dropped(rle_ctx, rle_ctx->current_counter);
+		rle_ctx_incr_counter_bytes_dropped(rle_ctx, rle_ctx->lk_status->current_counter);
 		rle_receiver_free_context(_this, *index_ctx);
 	}
 
-#ifdef TIME_DEBUG
-	gettimeofday(&tv_end, NULL);
-	tv_delta.tv_sec = tv_end.tv_sec - tv_start.tv_sec;
-	tv_delta.tv_usec = tv_end.tv_usec - tv_start.tv_usec;
-	RLE_DEBUG("duration [%04ld.%06ld].", tv_delta.tv_sec, tv_delta.tv_usec);
-#endif
-
 	return ret;
 }
 
@@ -418,55 +665,73 @@ int reassembly_cont_ppdu(struct rle_receiver *_this,
 	rle_rasm_buf_t *rasm_buf;
 	struct rle_ctx_mngt *rle_ctx;
 
-#ifdef TIME_DEBUG
-	struct timeval tv_start = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_end = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_delta;
-	gettimeofday(&tv_start, NULL);
-#endif
-
 	*index_ctx = rle_cont_end_ppdu_hdr_get_frag_id((rle_ppdu_hdr_cont_end_t *)ppdu);
-	RLE_DEBUG("CONT: fragment_id 0x%0x", *index_ctx);
-	RLE_DEBUG("handle PPDU CONT for context with ID %d", *index_ctx);
+	RLE_DEBUG_TO(&_this->log_sink, "CONT: fragment_id 0x%0x", *index_ctx);
+	RLE_DEBUG_TO(&_this->log_sink, "handle PPDU CONT for context with ID %d", *index_ctx);
 	assert((*index_ctx >= 0) && (*index_ctx <= RLE_MAX_FRAG_ID));
 
 	rle_ctx = &_this->rle_ctx_man[*index_ctx];
-	rle_ctx->current_counter += ppdu_length;
+	rle_ctx->lk_status->current_counter += ppdu_length;
 	rasm_buf = (rle_rasm_buf_t *)_this->rle_ctx_man[*index_ctx].buff;
 
 	rle_ctx_incr_counter_bytes_in(rle_ctx, ppdu_length);
+	rle_size_ppdu(&rle_ctx->lk_status->size_stats);
 
 	if (is_context_free(_this, *index_ctx) == true) {
-		RLE_ERR("invalid Cont on context free, frag id [%d].", *index_ctx);
+		RLE_ERR_TO(&_this->log_sink,
+		           "invalid Cont on context free, frag id [%d].", *index_ctx);
 		/* Context is free, whereas it must not. an error must have occured. */
 		/* Freeing context and updating stats. At least one packet is partialy lost.*/
+		rle_rcv_count_error(_this, RLE_RCV_ERR_CTX_FREE);
 		goto out;
 	}
 
-	RLE_DEBUG("ALPDU trailer is %s",
-	          rle_ctx_get_use_crc(rle_ctx) ? "CRC" : "seqnum");
+	RLE_DEBUG_TO(&_this->log_sink, "ALPDU trailer is %s",
+	                                rle_ctx_get_use_crc(rle_ctx) ? "CRC" : "seqnum");
 
 	cont_end_ppdu_extract_alpdu_frag(ppdu, ppdu_length, &alpdu_frag,
 	                                 &alpdu_frag_len);
 
 	if (alpdu_frag_len == 0) {
-		RLE_WARN("warning: 0-byte ALPDU in PPDU CONT");
+		RLE_WARN_TO(&_this->log_sink, "warning: 0-byte ALPDU in PPDU CONT");
 	}
 
 	sdu_frag = alpdu_frag;
 	sdu_frag_len = alpdu_frag_len;
 
+	if (is_context_streaming(_this, *index_ctx)) {
+		const struct rle_rcv_stream *const stream = &_this->streams[*index_ctx];
+
+		if (stream->received + sdu_frag_len > stream->sdu_len) {
+			RLE_ERR_TO(&_this->log_sink,
+			           "PPDU CONT with frag id %d contains more SDU bytes than expected in "
+			           "total (%zu bytes already received, %zu bytes in fragment, %zu bytes "
+			           "expected in total)", *index_ctx, stream->received, sdu_frag_len,
+			           stream->sdu_len);
+			rle_rcv_count_error(_this, RLE_RCV_ERR_SDU_TOO_LONG);
+			goto out;
+		}
+		reassembly_stream_frag(_this, *index_ctx, sdu_frag, sdu_frag_len);
+		rle_trace(cont_received, *index_ctx, ppdu_length, stream->received);
+		ret = C_OK;
+		goto out;
+	}
+
 	if (rasm_buf_get_reassembled_sdu_len(rasm_buf) + sdu_frag_len >
 	    rasm_buf_get_sdu_len(rasm_buf)) {
-		RLE_ERR("PPDU CONT with frag id %d contains more SDU bytes than expected in total "
-		        "(%zu bytes already received, %zu bytes in fragment, %zu bytes expected "
-		        "in total)", *index_ctx, rasm_buf_get_reassembled_sdu_len(rasm_buf),
-		        sdu_frag_len, rasm_buf_get_sdu_len(rasm_buf));
+		RLE_ERR_TO(&_this->log_sink,
+		           "PPDU CONT with frag id %d contains more SDU bytes than expected in "
+		           "total (%zu bytes already received, %zu bytes in fragment, %zu bytes "
+		           "expected in total)", *index_ctx,
+		           rasm_buf_get_reassembled_sdu_len(rasm_buf), sdu_frag_len,
+		           rasm_buf_get_sdu_len(rasm_buf));
+		rle_rcv_count_error(_this, RLE_RCV_ERR_SDU_TOO_LONG);
 		goto out;
 	}
 	rasm_buf_init_sdu_frag(rasm_buf);
 	rasm_buf_sdu_frag_put(rasm_buf, sdu_frag_len);
-	rasm_buf_cpy_sdu_frag(rasm_buf, sdu_frag);
+	reassembly_cpy_sdu_frag(_this, rasm_buf, sdu_frag, sdu_frag_len);
+	rle_trace(cont_received, *index_ctx, ppdu_length, rasm_buf_get_reassembled_sdu_len(rasm_buf));
 
 	ret = C_OK;
 
@@ -475,17 +740,10 @@ out:
 	if (ret != C_OK) {
 		rle_ctx_incr_counter_dropped(rle_ctx);
 		rle_ctx_incr_counter_lost(rle_ctx, 1);
-		rle_ctx_incr_counter_bytes_dropped(rle_ctx, rle_ctx->current_counter);
+		rle_ctx_incr_counter_bytes_dropped(rle_ctx, rle_ctx->lk_status->current_counter);
 		rle_receiver_free_context(_this, *index_ctx);
 	}
 
-#ifdef TIME_DEBUG
-	gettimeofday(&tv_end, NULL);
-	tv_delta.tv_sec = tv_end.tv_sec - tv_start.tv_sec;
-	tv_delta.tv_usec = tv_end.tv_usec - tv_start.tv_usec;
-	RLE_DEBUG("duration [%04ld.%06ld].", tv_delta.tv_sec, tv_delta.tv_usec);
-#endif
-
 	return ret;
 }
 
@@ -493,7 +751,8 @@ int reassembly_end_ppdu(struct rle_receiver *_this,
                         const unsigned char ppdu[],
                         const size_t ppdu_length,
                         int *const index_ctx,
-                        struct rle_sdu *const reassembled_sdu)
+                        struct rle_sdu *const reassembled_sdu,
+                        const bool zero_copy)
 {
 	int ret = C_ERROR;
 	const unsigned char *alpdu_frag;
@@ -505,32 +764,28 @@ int reassembly_end_ppdu(struct rle_receiver *_this,
 	const rle_alpdu_trailer_t *rle_trailer = NULL;
 	size_t rle_trailer_len;
 	size_t lost_packets = 0;
-
-#ifdef TIME_DEBUG
-	struct timeval tv_start = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_end = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_delta;
-	gettimeofday(&tv_start, NULL);
-#endif
+	struct rle_sdu sdu;
 
 	*index_ctx = rle_cont_end_ppdu_hdr_get_frag_id((rle_ppdu_hdr_cont_end_t *)ppdu);
-	RLE_DEBUG("END: fragment_id 0x%0x", *index_ctx);
-	RLE_DEBUG("handle PPDU END for context with ID %d", *index_ctx);
+	RLE_DEBUG_TO(&_this->log_sink, "END: fragment_id 0x%0x", *index_ctx);
+	RLE_DEBUG_TO(&_this->log_sink, "handle PPDU END for context with ID %d", *index_ctx);
 	assert((*index_ctx >= 0) && (*index_ctx <= RLE_MAX_FRAG_ID));
 
 	rle_ctx = &_this->rle_ctx_man[*index_ctx];
-	rle_ctx->current_counter += ppdu_length;
+	rle_ctx->lk_status->current_counter += ppdu_length;
 	rasm_buf = (rle_rasm_buf_t *)_this->rle_ctx_man[*index_ctx].buff;
 
 	rle_ctx_incr_counter_bytes_in(rle_ctx, ppdu_length);
 
 	if (is_context_free(_this, *index_ctx) == true) {
-		RLE_ERR("invalid End on context free, frag id [%d].", *index_ctx);
+		RLE_ERR_TO(&_this->log_sink,
+		           "invalid End on context free, frag id [%d].", *index_ctx);
 		/* Context is free, whereas it must not. an error must have occured. */
 		/* Freeing context and updating stats. At least one packet is partialy lost.*/
+		rle_rcv_count_error(_this, RLE_RCV_ERR_CTX_FREE);
 		rle_ctx_incr_counter_dropped(rle_ctx);
 		rle_ctx_incr_counter_lost(rle_ctx, 1);
-		rle_ctx_incr_counter_bytes_dropped(rle_ctx, rle_ctx->current_counter);
+		rle_ctx_incr_counter_bytes_dropped(rle_ctx, rle_ctx->lk_status->current_counter);
 		rle_receiver_free_context(_this, *index_ctx);
 
 		goto out;
@@ -539,96 +794,135 @@ int reassembly_end_ppdu(struct rle_receiver *_this,
 	cont_end_ppdu_extract_alpdu_frag(ppdu, ppdu_length, &alpdu_frag, &alpdu_frag_len);
 
 	if (rle_ctx_get_use_crc(rle_ctx)) {
-		RLE_DEBUG("ALPDU trailer is CRC");
+		RLE_DEBUG_TO(&_this->log_sink, "ALPDU trailer is CRC");
 		rle_trailer_len = sizeof(rle_alpdu_crc_trailer_t);
 	} else {
-		RLE_DEBUG("ALPDU trailer is seqnum");
+		RLE_DEBUG_TO(&_this->log_sink, "ALPDU trailer is seqnum");
 		rle_trailer_len = sizeof(rle_alpdu_seqno_trailer_t);
 	}
 	if (alpdu_frag_len < rle_trailer_len) {
-		RLE_ERR("PPDU END does not contain enough bytes for the trailer: %zu bytes "
-		        "available while at least %zu bytes required", alpdu_frag_len,
-		        rle_trailer_len);
+		RLE_ERR_TO(&_this->log_sink,
+		           "PPDU END does not contain enough bytes for the trailer: %zu bytes "
+		           "available while at least %zu bytes required", alpdu_frag_len,
+		           rle_trailer_len);
+		rle_rcv_count_error(_this, RLE_RCV_ERR_SDU_TOO_SHORT);
 		goto out;
 	}
 	sdu_frag = alpdu_frag;
 	sdu_frag_len = alpdu_frag_len - rle_trailer_len;
 	rle_trailer = (rle_alpdu_trailer_t *)(sdu_frag + sdu_frag_len);
 
+	if (is_context_streaming(_this, *index_ctx)) {
+		/* the SDU is already with the consumer, only its verdict is left */
+		ret = reassembly_stream_end(_this, *index_ctx, sdu_frag, sdu_frag_len, rle_trailer,
+		                            &lost_packets);
+		rle_trace(end_received, *index_ctx, ppdu_length, _this->streams[*index_ctx].received);
+		goto out;
+	}
+
 	assert(rasm_buf->sdu_info.size == rasm_buf_get_sdu_len(rasm_buf));
 
 	if (rasm_buf_get_reassembled_sdu_len(rasm_buf) + sdu_frag_len >
 	    rasm_buf_get_sdu_len(rasm_buf)) {
-		RLE_ERR("PPDU END with frag id %d contains more SDU bytes than expected in total "
-		        "(%zu bytes already received, %zu bytes in fragment, %zu bytes expected "
-		        "in total)", *index_ctx, rasm_buf_get_reassembled_sdu_len(rasm_buf),
-		        sdu_frag_len, rasm_buf_get_sdu_len(rasm_buf));
+		RLE_ERR_TO(&_this->log_sink,
+		           "PPDU END with frag id %d contains more SDU bytes than expected in "
+		           "total (%zu bytes already received, %zu bytes in fragment, %zu bytes "
+		           "expected in total)", *index_ctx,
+		           rasm_buf_get_reassembled_sdu_len(rasm_buf), sdu_frag_len,
+		           rasm_buf_get_sdu_len(rasm_buf));
+		rle_rcv_count_error(_this, RLE_RCV_ERR_SDU_TOO_LONG);
 		goto out;
 	}
 	rasm_buf_init_sdu_frag(rasm_buf);
 	rasm_buf_sdu_frag_put(rasm_buf, sdu_frag_len);
-	rasm_buf_cpy_sdu_frag(rasm_buf, sdu_frag);
+	reassembly_cpy_sdu_frag(_this, rasm_buf, sdu_frag, sdu_frag_len);
+	rle_trace(end_received, *index_ctx, ppdu_length, rasm_buf_get_reassembled_sdu_len(rasm_buf));
 
 	if (rasm_buf_get_sdu_len(rasm_buf) > rasm_buf_get_reassembled_sdu_len(rasm_buf)) {
-		RLE_ERR("END PPDU received but %zu bytes still missing (%zu-byte SDU expected, "
-		        "but only %zu bytes received)",
-		        rasm_buf_get_sdu_len(rasm_buf) - rasm_buf_get_reassembled_sdu_len(rasm_buf),
-		        rasm_buf_get_sdu_len(rasm_buf), rasm_buf_get_reassembled_sdu_len(rasm_buf));
+		RLE_ERR_TO(&_this->log_sink,
+		           "END PPDU received but %zu bytes still missing (%zu-byte SDU expected, "
+		           "but only %zu bytes received)",
+		           rasm_buf_get_sdu_len(rasm_buf) -
+		           rasm_buf_get_reassembled_sdu_len(rasm_buf),
+		           rasm_buf_get_sdu_len(rasm_buf),
+		           rasm_buf_get_reassembled_sdu_len(rasm_buf));
+		rle_rcv_count_error(_this, RLE_RCV_ERR_SDU_TOO_SHORT);
 		goto out;
 	}
 
 	if (rasm_buf->comp_protocol_type != RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD) {
 		/* SDU is complete */
-		reassembled_sdu->size = rasm_buf->sdu_info.size;
-		reassembled_sdu->protocol_type = rasm_buf->sdu_info.protocol_type;
-		memcpy(reassembled_sdu->buffer, rasm_buf->sdu_info.buffer, reassembled_sdu->size);
-		RLE_DEBUG("%zu-byte SDU with protocol 0x%04x is complete",
-		          reassembled_sdu->size, reassembled_sdu->protocol_type);
+		sdu = rasm_buf->sdu_info;
+		RLE_DEBUG_TO(&_this->log_sink, "%zu-byte SDU with protocol 0x%04x is complete",
+		                                sdu.size, sdu.protocol_type);
 	} else {
 		assert(rasm_buf->sdu_info.protocol_type == RLE_PROTO_TYPE_VLAN_UNCOMP);
 
-		RLE_DEBUG("%zu-byte SDU with protocol 0x%04x shall be modified to insert "
-		          "the Protocol Type field in the VLAN header",
-		          rasm_buf->sdu_info.size, rasm_buf->sdu_info.protocol_type);
+		RLE_DEBUG_TO(&_this->log_sink,
+		             "%zu-byte SDU with protocol 0x%04x shall be modified to insert "
+		             "the Protocol Type field in the VLAN header",
+		             rasm_buf->sdu_info.size, rasm_buf->sdu_info.protocol_type);
 
 		/* special case for VLAN with embedded IPv4/IPv6: the protocol field of the VLAN
 		 * header is suppressed by the RLE transmitter and shall be rebuilt by the RLE
-		 * receiver according to the first 4 bits of the IP payload */
-		if (!reassembly_insert_vlan_ptype(rasm_buf->sdu.start, rasm_buf->sdu_info.size,
-		                                  reassembled_sdu)) {
-			RLE_ERR("failed to insert VLAN protocol type in Ethernet/VLAN/IP headers");
+		 * receiver according to the first 4 bits of the IP payload, in the headroom of
+		 * the reassembly buffer so that the SDU is still copied only once */
+		if (!reassembly_insert_vlan_ptype_in_place(_this, rasm_buf->sdu.start,
+		                                           rasm_buf->sdu_info.size, &sdu)) {
+			RLE_ERR_TO(&_this->log_sink,
+			           "failed to insert VLAN protocol type in Ethernet/VLAN/IP "
+			           "headers");
+			rle_rcv_count_error(_this, RLE_RCV_ERR_VLAN);
 			goto out;
 		}
+		rle_copy_count(&_this->copy_stats, RLE_COPY_RASM_END,
+		               sizeof(struct ether_header) + sizeof(struct vlan_hdr) - sizeof(uint16_t),
+		               0);
 	}
 
-	if (check_alpdu_trailer(rle_trailer, reassembled_sdu, rle_ctx,
+#ifdef RLE_COPY_STATS
+	if (rle_ctx_get_use_crc(rle_ctx) && !rasm_buf->crc_on_the_fly) {
+		/* the CRC is computed on the reassembled SDU by check_alpdu_trailer() */
+		rle_copy_count(&_this->copy_stats, RLE_COPY_RASM_CRC, 0, sdu.size);
+	}
+#endif
+
+	if (check_alpdu_trailer(rle_trailer, &sdu,
+	                        rasm_buf->crc_on_the_fly ? &rasm_buf->crc : NULL, rle_ctx,
 	                        &(_this->is_ctx_seqnum_init[*index_ctx]), &lost_packets) != 0) {
-		RLE_ERR("Wrong RLE trailer.");
+		RLE_ERR_TO(&_this->log_sink, "Wrong RLE trailer.");
+		rle_rcv_count_error(_this, rle_ctx_get_use_crc(rle_ctx) ? RLE_RCV_ERR_CRC :
+		                    RLE_RCV_ERR_SEQNO);
 		goto out;
 	}
 
+	reassembled_sdu->size = sdu.size;
+	reassembled_sdu->protocol_type = sdu.protocol_type;
+	if (zero_copy && rle_receiver_deliver_context(_this, *index_ctx)) {
+		/* the reassembly storage is handed over, so no need to copy the SDU */
+		reassembled_sdu->buffer = sdu.buffer;
+	} else {
+		memcpy(reassembled_sdu->buffer, sdu.buffer, sdu.size);
+		rle_copy_count(&_this->copy_stats, RLE_COPY_RASM_END, sdu.size, 0);
+	}
+
 	/* update link status */
 	rle_ctx_incr_counter_bytes_ok(rle_ctx, reassembled_sdu->size);
 	rle_ctx_incr_counter_ok(rle_ctx);
+	rle_size_ppdu(&rle_ctx->lk_status->size_stats);
+	rle_size_sdu_end(&rle_ctx->lk_status->size_stats, reassembled_sdu->size);
 
 	ret = C_REASSEMBLY_OK;
 
 out:
 
-	if (ret != C_REASSEMBLY_OK) {
+	if (ret != C_REASSEMBLY_OK && ret != C_OK) {
 		rle_ctx_incr_counter_dropped(rle_ctx);
 		rle_ctx_incr_counter_lost(rle_ctx, lost_packets);
-		rle_ctx_incr_counter_bytes_dropped(rle_ctx, rle_ctx->current_counter);
+		rle_ctx_incr_counter_bytes_dropped(rle_ctx, rle_ctx->lk_status->current_counter);
 	}
 
 	rle_receiver_free_context(_this, *index_ctx);
 
-#ifdef TIME_DEBUG
-	gettimeofday(&tv_end, NULL);
-	tv_delta.tv_sec = tv_end.tv_sec - tv_start.tv_sec;
-	tv_delta.tv_usec = tv_end.tv_usec - tv_start.tv_usec;
-	RLE_DEBUG("duration [%04ld.%06ld].", tv_delta.tv_sec, tv_delta.tv_usec);
-#endif
-
 	return ret;
 }
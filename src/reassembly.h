@@ -84,13 +84,16 @@ int reassembly_reassemble_pdu(struct rle_ctx_mngt *rle_ctx,
  * @param[in]     ppdu             The PPDU containing ALPDU fragments to reassemble.
  * @param[in]     ppdu_length      The length of the PPDU.
  * @param[out]    reassembled_sdu  The reassembled SDU.
+ * @param[in]     zero_copy        Whether the SDU buffer may point to the SDU in the PPDU instead
+ *                                 of a copy of it.
  *
  * @ingroup RLE receiver
  */
 int reassembly_comp_ppdu(struct rle_receiver *_this,
                          unsigned char *const ppdu,
                          const size_t ppdu_length,
-                         struct rle_sdu *const reassembled_sdu);
+                         struct rle_sdu *const reassembled_sdu,
+                         const bool zero_copy);
 
 /**
  * @brief Start reassembly with start PPDU.
@@ -128,12 +131,14 @@ int reassembly_cont_ppdu(struct rle_receiver *_this, const unsigned char ppdu[],
  * @param[in]     ppdu             The PPDU containing ALPDU fragments to reassemble.
  * @param[in]     ppdu_length      The length of the PPDU.
  * @param[out]    reassembled_sdu  The reassembled SDU.
+ * @param[in]     zero_copy        Whether the SDU buffer may point to the reassembly storage
+ *                                 instead of a copy of it.
  *
  * @ingroup RLE receiver
  */
 int reassembly_end_ppdu(struct rle_receiver *_this, const unsigned char ppdu[],
                         const size_t ppdu_length, int *const index_ctx,
-                        struct rle_sdu *const reassembled_sdu);
+                        struct rle_sdu *const reassembled_sdu, const bool zero_copy);
 
 
 #endif /* __REASSEMBLY_H__ */
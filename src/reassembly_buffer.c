@@ -27,6 +27,18 @@
  */
 
 #include "reassembly_buffer.h"
+#include "crc.h"
+
+#ifndef __KERNEL__
+
+#include <string.h>
+
+#else
+
+#include <linux/string.h>
+#include <linux/spinlock.h>
+
+#endif
 
 
 /*------------------------------------------------------------------------------------------------*/
@@ -35,6 +47,34 @@
 
 #define MODULE_ID RLE_MOD_ID_REASSEMBLY_BUFFER
 
+#ifdef __KERNEL__
+/* the storages are taken in softirq context and given back by the receivers destroyed in process
+ * context, so the bottom halves are disabled while the pool is locked */
+static DEFINE_SPINLOCK(rasm_pool_lock);
+#define rasm_pool_lock()    spin_lock_bh(&rasm_pool_lock)
+#define rasm_pool_unlock()  spin_unlock_bh(&rasm_pool_lock)
+#else
+static bool rasm_pool_lock;
+#define rasm_pool_lock() \
+	while (__atomic_test_and_set(&rasm_pool_lock, __ATOMIC_ACQUIRE)) { }
+#define rasm_pool_unlock()  __atomic_clear(&rasm_pool_lock, __ATOMIC_RELEASE)
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*---------------------------------------- PRIVATE DATA ------------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Pool of reassembly buffer storages shared by all the receivers. The unused storages are linked
+ * through their first bytes.
+ */
+static struct {
+	unsigned char *free_list;  /**< The unused storages                       */
+	size_t free_nr;            /**< The number of unused storages             */
+	size_t users_nr;           /**< The number of receivers using the pool    */
+} rasm_pool = { NULL, 0, 0 };
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
@@ -52,8 +92,14 @@ void rasm_buf_cpy_sdu_frag(rle_rasm_buf_t *const rasm_buf, const unsigned char s
 	assert(rasm_buf_in_use(rasm_buf));
 
 	if (rasm_buf->sdu_frag.end != rasm_buf->sdu_frag.start) {
-		memcpy(rasm_buf->sdu_frag.start, sdu_frag,
-		       rasm_buf->sdu_frag.end - rasm_buf->sdu_frag.start);
+		const size_t sdu_frag_len = rasm_buf->sdu_frag.end - rasm_buf->sdu_frag.start;
+
+		if (rasm_buf->crc_on_the_fly) {
+			rasm_buf->crc = compute_crc_cpy(rasm_buf->sdu_frag.start, sdu_frag, sdu_frag_len,
+			                                rasm_buf->crc);
+		} else {
+			memcpy(rasm_buf->sdu_frag.start, sdu_frag, sdu_frag_len);
+		}
 	}
 }
 
@@ -68,3 +114,174 @@ size_t rasm_buf_get_reassembled_sdu_len(const rle_rasm_buf_t *const rasm_buf)
 	assert(rasm_buf->sdu_frag.end >= rasm_buf->sdu.start);
 	return (rasm_buf->sdu_frag.end - rasm_buf->sdu.start);
 }
+
+int rasm_buf_acquire_storage(rle_rasm_buf_t *const rasm_buf)
+{
+	unsigned char *storage;
+
+	if (rasm_buf->buffer != NULL) {
+		goto out;
+	}
+
+	if (rasm_buf->stash != NULL) {
+		/* a real-time receiver never allocates on its data path */
+		storage = rasm_stash_get(rasm_buf->stash);
+		if (storage == NULL) {
+			RLE_ERR("all the reserved reassembly buffer storages are in use");
+			return 1;
+		}
+		goto set_storage;
+	}
+
+	if (!rle_allocator_is_system(&rasm_buf->allocator)) {
+		storage = (unsigned char *)rle_alloc(&rasm_buf->allocator, RLE_R_BUFF_LEN);
+		if (storage == NULL) {
+			RLE_ERR("reassembly buffer storage not allocated");
+			return 1;
+		}
+		goto set_storage;
+	}
+
+	rasm_pool_lock();
+	storage = rasm_pool.free_list;
+	if (storage != NULL) {
+		memcpy(&rasm_pool.free_list, storage, sizeof(rasm_pool.free_list));
+		rasm_pool.free_nr--;
+	}
+	rasm_pool_unlock();
+
+	if (storage == NULL) {
+		/* on the data path, that may not sleep */
+		storage = (unsigned char *)rle_alloc(&rle_atomic_allocator, RLE_R_BUFF_LEN);
+		if (storage == NULL) {
+			RLE_ERR("reassembly buffer storage not allocated");
+			return 1;
+		}
+	}
+
+set_storage:
+	rasm_buf->buffer = storage;
+
+out:
+	return 0;
+}
+
+void rasm_buf_release_storage(rle_rasm_buf_t *const rasm_buf)
+{
+	unsigned char *const storage = rasm_buf_detach_storage(rasm_buf);
+
+	if (storage == NULL) {
+		return;
+	}
+
+	if (rasm_buf->stash != NULL) {
+		rasm_stash_put(rasm_buf->stash, storage);
+	} else {
+		rasm_buf_storage_put(storage, &rasm_buf->allocator);
+	}
+}
+
+unsigned char * rasm_buf_detach_storage(rle_rasm_buf_t *const rasm_buf)
+{
+	unsigned char *const storage = rasm_buf->buffer;
+
+	rasm_buf->buffer = NULL;
+	rasm_buf->sdu_info.buffer = NULL;
+	rasm_buf->sdu.start = rasm_buf->sdu.end = NULL;
+	rasm_buf->sdu_frag.start = rasm_buf->sdu_frag.end = NULL;
+
+	return storage;
+}
+
+void rasm_buf_storage_put(unsigned char *const storage,
+                          const struct rle_allocator *const allocator)
+{
+	bool is_pooled = false;
+
+	if (!rle_allocator_is_system(allocator)) {
+		rle_free(allocator, storage);
+		return;
+	}
+
+	rasm_pool_lock();
+	if (rasm_pool.users_nr > 0 && rasm_pool.free_nr < RLE_R_BUFF_POOL_MAX_FREE) {
+		memcpy(storage, &rasm_pool.free_list, sizeof(rasm_pool.free_list));
+		rasm_pool.free_list = storage;
+		rasm_pool.free_nr++;
+		is_pooled = true;
+	}
+	rasm_pool_unlock();
+
+	if (!is_pooled) {
+		rle_free(&rle_system_allocator, storage);
+	}
+}
+
+void rasm_stash_put(struct rle_rasm_stash *const stash, unsigned char *const storage)
+{
+	memcpy(storage, &stash->free_list, sizeof(stash->free_list));
+	stash->free_list = storage;
+	stash->free_nr++;
+}
+
+unsigned char * rasm_stash_get(struct rle_rasm_stash *const stash)
+{
+	unsigned char *const storage = stash->free_list;
+
+	if (storage != NULL) {
+		memcpy(&stash->free_list, storage, sizeof(stash->free_list));
+		stash->free_nr--;
+	}
+
+	return storage;
+}
+
+void rasm_buf_pool_get(void)
+{
+	rasm_pool_lock();
+	rasm_pool.users_nr++;
+	rasm_pool_unlock();
+}
+
+void rasm_buf_pool_fill(void)
+{
+	size_t missing_nr = 0;
+
+	rasm_pool_lock();
+	if (rasm_pool.users_nr > 0) {
+		missing_nr = RLE_R_BUFF_POOL_MAX_FREE - rasm_pool.free_nr;
+	}
+	rasm_pool_unlock();
+
+	for (; missing_nr > 0; missing_nr--) {
+		unsigned char *const storage =
+			(unsigned char *)rle_alloc(&rle_system_allocator, RLE_R_BUFF_LEN);
+
+		if (storage == NULL) {
+			break;
+		}
+		rasm_buf_storage_put(storage, &rle_system_allocator);
+	}
+}
+
+void rasm_buf_pool_put(void)
+{
+	unsigned char *free_list = NULL;
+
+	rasm_pool_lock();
+	assert(rasm_pool.users_nr > 0);
+	rasm_pool.users_nr--;
+	if (rasm_pool.users_nr == 0) {
+		free_list = rasm_pool.free_list;
+		rasm_pool.free_list = NULL;
+		rasm_pool.free_nr = 0;
+	}
+	rasm_pool_unlock();
+
+	while (free_list != NULL) {
+		unsigned char *const storage = free_list;
+
+		memcpy(&free_list, storage, sizeof(free_list));
+		rle_free(&rle_system_allocator, storage);
+	}
+}
@@ -32,9 +32,12 @@
 #include "rle.h"
 
 #include "constants.h"
+#include "rle_allocator.h"
 
 #ifndef __KERNEL__
 #       include <assert.h>
+#       include <stdbool.h>
+#       include <stdint.h>
 #endif
 
 
@@ -45,6 +48,12 @@
 
 /** Maximum size for a reassembly buffer. */
 #define RLE_R_BUFF_LEN ((2 << 12) - 1)
+
+/** Room kept before the SDU in a reassembly buffer, to insert back the VLAN protocol type. */
+#define RLE_R_BUFF_HEADROOM 2
+
+/** Maximum number of unused reassembly buffer storages kept in the pool shared by receivers. */
+#define RLE_R_BUFF_POOL_MAX_FREE 64
 #define MODULE_ID RLE_MOD_ID_REASSEMBLY_BUFFER
 
 
@@ -71,7 +80,8 @@ typedef struct reassembly_buffer_ptrs rasm_buf_ptrs_t;
 /**
  * Reassembly buffer.
  * Used to stock received SDU fragments it a full SDU.
- * The buffer itself is given by the library caller, by the decapsulation function.
+ * The storage of the buffer is only taken from a pool shared by all the receivers while a SDU is
+ * reassembled, i.e. from its START PPDU until the context is freed.
  *
  * Init:
  *
@@ -113,13 +123,27 @@ struct reassembly_buffer_ptrs {
 	unsigned char *end;   /** End pointer.               */
 };
 
+/**
+ * Reassembly buffer storages reserved by a real-time receiver for its own contexts. The unused
+ * storages are linked through their first bytes, as in the shared pool, without lock as a
+ * receiver decapsulates in one thread at a time.
+ */
+struct rle_rasm_stash {
+	unsigned char *free_list;  /**< The unused storages           */
+	size_t free_nr;            /**< The number of unused storages */
+};
+
 /** Reassembly buffer implementation. */
 struct rle_reassembly_buffer {
-	unsigned char *buffer;                /** Buffer. Given by the library caller.               */
+	unsigned char *buffer;                /** Buffer. NULL if no SDU is being reassembled.       */
 	struct rle_sdu sdu_info;              /** RLE SDU struct used without buffer to store infos. */
 	uint8_t comp_protocol_type;           /**< The compressed protocol type found in ALPDU */
+	bool crc_on_the_fly;                  /**< Whether crc is updated on each fragment copy  */
+	uint32_t crc;                         /**< CRC of the SDU fragments copied so far        */
 	rasm_buf_ptrs_t sdu;                    /** SDU after copying it.                              */
 	rasm_buf_ptrs_t sdu_frag;               /** Current SDU fragment.                              */
+	struct rle_allocator allocator;       /** Allocator of the buffer and its storages.          */
+	struct rle_rasm_stash *stash;         /** Storages of a real-time receiver, or NULL.        */
 };
 
 
@@ -187,11 +211,28 @@ void rasm_buf_sdu_frag_put(rle_rasm_buf_t *const rasm_buf, const size_t size);
 /**
  * @brief         Create a new reassembly buffer.
  *
+ * @param[in]     allocator                  The allocator of the buffer and its storages, kept to
+ *                                           release them.
+ *
  * @return        The reassembly buffer if OK, else NULL.
  *
  * @ingroup       RLE Reassembly buffer.
  */
-static inline rle_rasm_buf_t * rasm_buf_new(void);
+static inline rle_rasm_buf_t * rasm_buf_new(const struct rle_allocator *const allocator);
+
+/**
+ * @brief         Create a new reassembly buffer in caller memory.
+ *
+ * @param[in,out] mem                        The memory, at least sizeof(rle_rasm_buf_t) bytes long
+ *                                           and suitably aligned for any type.
+ * @param[in]     allocator                  The allocator of the storages of the buffer.
+ *
+ * @return        The reassembly buffer.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+static inline rle_rasm_buf_t * rasm_buf_init_in_place(void *const mem,
+                                                      const struct rle_allocator *const allocator);
 
 /**
  * @brief         Destroy a reassembly buffer.
@@ -205,14 +246,118 @@ static inline void rasm_buf_del(rle_rasm_buf_t **const rasm_buf);
 /**
  * @brief         Initialize (eventually reinitialize) a reassembly buffer.
  *
+ *                The reassembly buffer shall have a storage, see \ref rasm_buf_acquire_storage.
+ *
  * @param[in,out] rasm_buf                   The reassembly buffer to (re)initialize.
- * @param[in,out] sdu                      the SDU structure, containing the buffer that will be
- *                                         used to store the reassembled SDU.
  *
  * @ingroup       RLE Reassembly buffer.
  */
 static inline void rasm_buf_init(rle_rasm_buf_t *const rasm_buf);
 
+/**
+ * @brief         Give a storage to a reassembly buffer, taken from the pool shared by receivers.
+ *
+ *                Nothing is done if the reassembly buffer already has a storage. The pool only
+ *                holds storages of the allocator of the system, the other allocators are called
+ *                directly.
+ *
+ * @param[in,out] rasm_buf                   The reassembly buffer.
+ *
+ * @return        0 if OK, else 1.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+int rasm_buf_acquire_storage(rle_rasm_buf_t *const rasm_buf)
+__attribute__((warn_unused_result, nonnull(1)));
+
+/**
+ * @brief         Give the storage of a reassembly buffer back to the pool shared by receivers.
+ *
+ *                The reassembly buffer is not in use anymore. Nothing is done if the reassembly
+ *                buffer has no storage.
+ *
+ * @param[in,out] rasm_buf                   The reassembly buffer.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+void rasm_buf_release_storage(rle_rasm_buf_t *const rasm_buf)
+__attribute__((nonnull(1)));
+
+/**
+ * @brief         Take the storage of a reassembly buffer away, e.g. to hand its SDU over.
+ *
+ *                The reassembly buffer is not in use anymore and has no storage. The storage shall
+ *                be given back with \ref rasm_buf_storage_put.
+ *
+ * @param[in,out] rasm_buf                   The reassembly buffer.
+ *
+ * @return        The storage, NULL if the reassembly buffer has no storage.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+unsigned char * rasm_buf_detach_storage(rle_rasm_buf_t *const rasm_buf)
+__attribute__((nonnull(1)));
+
+/**
+ * @brief         Give a storage taken by \ref rasm_buf_detach_storage back to the pool shared by
+ *                receivers, or to its allocator.
+ *
+ * @param[in]     storage                    The storage.
+ * @param[in]     allocator                  The allocator of the reassembly buffer of the storage.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+void rasm_buf_storage_put(unsigned char *const storage,
+                          const struct rle_allocator *const allocator)
+__attribute__((nonnull(1, 2)));
+
+/**
+ * @brief         Give a reassembly buffer storage to the storages of a real-time receiver.
+ *
+ * @param[in,out] stash                      The storages of the receiver.
+ * @param[in]     storage                    The storage, unused.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+void rasm_stash_put(struct rle_rasm_stash *const stash, unsigned char *const storage)
+__attribute__((nonnull(1, 2)));
+
+/**
+ * @brief         Take a reassembly buffer storage from the storages of a real-time receiver.
+ *
+ * @param[in,out] stash                      The storages of the receiver.
+ *
+ * @return        The storage, NULL if all the storages are in use.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+unsigned char * rasm_stash_get(struct rle_rasm_stash *const stash)
+__attribute__((nonnull(1)));
+
+/**
+ * @brief         Register a user of the pool of reassembly buffer storages.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+void rasm_buf_pool_get(void);
+
+/**
+ * @brief         Fill the pool of reassembly buffer storages up to its max of unused storages, so
+ *                that the receivers seldom allocate storages on their data path. Shall be called
+ *                by a registered user, in a context that may sleep.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+void rasm_buf_pool_fill(void);
+
+/**
+ * @brief         Unregister a user of the pool of reassembly buffer storages. The unused storages
+ *                are freed when the last user is gone.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+void rasm_buf_pool_put(void);
+
 /**
  * @brief         Check if the reassembly buffer is in use.
  *
@@ -227,6 +372,9 @@ static inline int rasm_buf_in_use(const rle_rasm_buf_t *const rasm_buf);
 /**
  * @brief         Copy a fragment of SDU in a reassembly buffer.
  *
+ *                If enabled with \ref rasm_buf_start_crc, the CRC of the SDU is updated with the
+ *                fragment during the copy.
+ *
  * @param[in,out] rasm_buf  The reassembly buffer
  * @param[in]     sdu_frag  The SDU to copy
  *
@@ -235,6 +383,19 @@ static inline int rasm_buf_in_use(const rle_rasm_buf_t *const rasm_buf);
 void rasm_buf_cpy_sdu_frag(rle_rasm_buf_t *const rasm_buf,
                            const unsigned char sdu_frag[]);
 
+/**
+ * @brief         Start computing the CRC of the SDU on each fragment copy.
+ *
+ *                Must be called before the first fragment is copied.
+ *
+ * @param[in,out] rasm_buf                 The reassembly buffer.
+ * @param[in]     crc_init                 The CRC of the data preceding the SDU, i.e. its
+ *                                         protocol type.
+ *
+ * @ingroup       RLE Reassembly buffer.
+ */
+static inline void rasm_buf_start_crc(rle_rasm_buf_t *const rasm_buf, const uint32_t crc_init);
+
 /**
  * @brief         Get the length of the SDU in the reassembly buffer (reassembled or not).
  *
@@ -348,54 +509,75 @@ static inline void rasm_buf_init_sdu_frag(rle_rasm_buf_t *const rasm_buf)
 	rasm_buf_ptrs_set(&rasm_buf->sdu_frag, rasm_buf->sdu_frag.end);
 }
 
-static inline rle_rasm_buf_t * rasm_buf_new(void)
+static inline rle_rasm_buf_t * rasm_buf_new(const struct rle_allocator *const allocator)
 {
-	rle_rasm_buf_t *rasm_buf = (rle_rasm_buf_t *)MALLOC(sizeof(rle_rasm_buf_t));
+	void *const mem = rle_alloc(allocator, sizeof(rle_rasm_buf_t));
 
-	if (!rasm_buf) {
+	if (!mem) {
 		RLE_ERR("reassembly buffer not allocated.");
-		goto error;
+		return NULL;
 	}
 
-	rasm_buf->buffer = (unsigned char *)MALLOC(RLE_R_BUFF_LEN);
-	if (!rasm_buf->buffer) {
-		RLE_ERR("reassembly buffer not allocated (2)");
-		goto free_rasm_buf;
-	}
-	rasm_buf->sdu_info.buffer = rasm_buf->buffer;
+	return rasm_buf_init_in_place(mem, allocator);
+}
+
+static inline rle_rasm_buf_t * rasm_buf_init_in_place(void *const mem,
+                                                      const struct rle_allocator *const allocator)
+{
+	rle_rasm_buf_t *const rasm_buf = (rle_rasm_buf_t *)mem;
+
+	rasm_buf->allocator = *allocator;
+
+	/* the storage is only taken when a SDU is reassembled */
+	rasm_buf->stash = NULL;
+	rasm_buf->buffer = NULL;
+	rasm_buf->sdu_info.buffer = NULL;
+	rasm_buf->crc_on_the_fly = false;
+	rasm_buf->crc = 0;
 	rasm_buf->sdu.rasm_buf = rasm_buf;
+	rasm_buf->sdu.start = rasm_buf->sdu.end = NULL;
 	rasm_buf->sdu_frag.rasm_buf = rasm_buf;
+	rasm_buf->sdu_frag.start = rasm_buf->sdu_frag.end = NULL;
 
 	return rasm_buf;
-
-free_rasm_buf:
-	FREE(rasm_buf);
-error:
-	return NULL;
 }
 
 static inline void rasm_buf_del(rle_rasm_buf_t **const rasm_buf)
 {
+	struct rle_allocator allocator;
+
 	assert(rasm_buf != NULL);
 	assert((*rasm_buf) != NULL);
 
-	if ((*rasm_buf)->sdu_info.buffer) {
-		FREE((*rasm_buf)->sdu_info.buffer);
-		(*rasm_buf)->sdu_info.buffer = NULL;
-	}
+	rasm_buf_release_storage(*rasm_buf);
 
-	FREE(*rasm_buf);
+	/* the allocator is read before it is released with the buffer */
+	allocator = (*rasm_buf)->allocator;
+	rle_free(&allocator, *rasm_buf);
 	*rasm_buf = NULL;
 }
 
 static inline void rasm_buf_init(rle_rasm_buf_t *const rasm_buf)
 {
-	rasm_buf->buffer = rasm_buf->sdu_info.buffer;
+	assert(rasm_buf->buffer != NULL);
+
+	rasm_buf->sdu_info.buffer = rasm_buf->buffer + RLE_R_BUFF_HEADROOM;
 
 	memset(rasm_buf->buffer, '\0', RLE_R_BUFF_LEN);
 
-	rasm_buf_ptrs_set(&rasm_buf->sdu, rasm_buf->buffer);
-	rasm_buf_ptrs_set(&rasm_buf->sdu_frag, rasm_buf->buffer);
+	rasm_buf->crc_on_the_fly = false;
+	rasm_buf->crc = 0;
+
+	rasm_buf_ptrs_set(&rasm_buf->sdu, rasm_buf->buffer + RLE_R_BUFF_HEADROOM);
+	rasm_buf_ptrs_set(&rasm_buf->sdu_frag, rasm_buf->buffer + RLE_R_BUFF_HEADROOM);
+}
+
+static inline void rasm_buf_start_crc(rle_rasm_buf_t *const rasm_buf, const uint32_t crc_init)
+{
+	assert(rasm_buf->sdu_frag.start == rasm_buf->sdu.start);
+
+	rasm_buf->crc_on_the_fly = true;
+	rasm_buf->crc = crc_init;
 }
 
 static inline int rasm_buf_in_use(const rle_rasm_buf_t *const rasm_buf)
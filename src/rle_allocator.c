@@ -0,0 +1,204 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_allocator.c
+ * @brief  Definition of the allocators of the memory of the library
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include "rle_allocator.h"
+#include "constants.h"
+
+#ifndef __KERNEL__
+
+#include <stdlib.h>
+
+#else
+
+#include <linux/slab.h>
+
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PRIVATE FUNCTIONS --------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Allocate memory from the system.
+ *
+ * @param[in]     context                  Unused.
+ * @param[in]     size                     The size of the memory, in bytes.
+ *
+ * @return        The memory if OK, else NULL.
+ *
+ * @ingroup       RLE allocator
+ */
+static void * system_alloc(void *const context, const size_t size);
+
+/**
+ * @brief         Release memory to the system.
+ *
+ * @param[in]     context                  Unused.
+ * @param[in]     ptr                      The memory.
+ *
+ * @ingroup       RLE allocator
+ */
+static void system_free(void *const context, void *const ptr);
+
+#ifdef __KERNEL__
+
+/**
+ * @brief         Allocate memory from the system, without sleeping.
+ *
+ * @param[in]     context                  Unused.
+ * @param[in]     size                     The size of the memory, in bytes.
+ *
+ * @return        The memory if OK, else NULL.
+ *
+ * @ingroup       RLE allocator
+ */
+static void * atomic_alloc(void *const context, const size_t size);
+
+#endif
+
+/**
+ * @brief         Refuse to allocate memory, the memory of the caller being used up.
+ *
+ * @param[in]     context                  Unused.
+ * @param[in]     size                     Unused.
+ *
+ * @return        NULL.
+ *
+ * @ingroup       RLE allocator
+ */
+static void * caller_alloc(void *const context, const size_t size);
+
+/**
+ * @brief         Leave memory of the caller to the caller.
+ *
+ * @param[in]     context                  Unused.
+ * @param[in]     ptr                      Unused.
+ *
+ * @ingroup       RLE allocator
+ */
+static void caller_free(void *const context, void *const ptr);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*---------------------------------------- PRIVATE DATA ------------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+const struct rle_allocator rle_system_allocator = {
+	.alloc = system_alloc,
+	.free = system_free,
+	.context = NULL
+};
+
+#ifdef __KERNEL__
+const struct rle_allocator rle_atomic_allocator = {
+	.alloc = atomic_alloc,
+	.free = system_free,
+	.context = NULL
+};
+#else
+/* there is no atomic context in userspace, it is the allocator of the system */
+const struct rle_allocator rle_atomic_allocator = {
+	.alloc = system_alloc,
+	.free = system_free,
+	.context = NULL
+};
+#endif
+
+const struct rle_allocator rle_caller_allocator = {
+	.alloc = caller_alloc,
+	.free = caller_free,
+	.context = NULL
+};
+
+/** The allocator of the modules created without allocator, read at their creation */
+static struct rle_allocator lib_allocator = {
+	.alloc = system_alloc,
+	.free = system_free,
+	.context = NULL
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PRIVATE FUNCTIONS CODE ------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static void * system_alloc(void *const context __attribute__((unused)), const size_t size)
+{
+	return MALLOC(size);
+}
+
+static void system_free(void *const context __attribute__((unused)), void *const ptr)
+{
+	FREE(ptr);
+}
+
+#ifdef __KERNEL__
+static void * atomic_alloc(void *const context __attribute__((unused)), const size_t size)
+{
+	return MALLOC_ATOMIC(size);
+}
+#endif
+
+static void * caller_alloc(void *const context __attribute__((unused)),
+                           const size_t size __attribute__((unused)))
+{
+	return NULL;
+}
+
+static void caller_free(void *const context __attribute__((unused)),
+                        void *const ptr __attribute__((unused)))
+{
+	return;
+}
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+int rle_set_allocator(const struct rle_allocator *const allocator)
+{
+	if (allocator == NULL) {
+		lib_allocator = rle_system_allocator;
+		return 0;
+	}
+
+	if (allocator->alloc == NULL || allocator->free == NULL) {
+		return 1;
+	}
+
+	lib_allocator = *allocator;
+
+	return 0;
+}
+
+void rle_get_allocator(struct rle_allocator *const allocator)
+{
+	*allocator = lib_allocator;
+}
@@ -0,0 +1,135 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_allocator.h
+ * @brief  Definition of the allocators of the memory of the library
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#ifndef __RLE_ALLOCATOR_H__
+#define __RLE_ALLOCATOR_H__
+
+#ifndef __KERNEL__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#else
+
+#include <linux/stddef.h>
+#include <linux/types.h>
+
+#endif
+
+#include "rle.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** The allocator of the system, malloc() in userspace, kmalloc() in the kernel */
+extern const struct rle_allocator rle_system_allocator;
+
+/**
+ * The allocator of the system that never sleeps, kmalloc(GFP_ATOMIC) in the kernel, malloc() in
+ * userspace. Its memory is released to the allocator of the system.
+ */
+extern const struct rle_allocator rle_atomic_allocator;
+
+/** The allocator of memory given by the caller, that neither allocates nor releases anything */
+extern const struct rle_allocator rle_caller_allocator;
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Allocate memory with an allocator.
+ *
+ * @param[in]     allocator                The allocator.
+ * @param[in]     size                     The size of the memory, in bytes.
+ *
+ * @return        The memory if OK, else NULL.
+ *
+ * @ingroup       RLE allocator
+ */
+static inline void * rle_alloc(const struct rle_allocator *const allocator, const size_t size)
+{
+	return allocator->alloc(allocator->context, size);
+}
+
+/**
+ * @brief         Release memory given by an allocator.
+ *
+ *                The allocator shall not be stored in the released memory.
+ *
+ * @param[in]     allocator                The allocator that gave the memory.
+ * @param[in]     ptr                      The memory, may be NULL.
+ *
+ * @ingroup       RLE allocator
+ */
+static inline void rle_free(const struct rle_allocator *const allocator, void *const ptr)
+{
+	if (ptr != NULL) {
+		allocator->free(allocator->context, ptr);
+	}
+}
+
+/**
+ * @brief         Check whether an allocator is the allocator of the system.
+ *
+ *                The allocator of the system that never sleeps is the allocator of the system too,
+ *                their memory being released the same way.
+ *
+ * @param[in]     allocator                The allocator.
+ *
+ * @return        true if the allocator is the allocator of the system, else false.
+ *
+ * @ingroup       RLE allocator
+ */
+static inline bool rle_allocator_is_system(const struct rle_allocator *const allocator)
+{
+	return ((allocator->alloc == rle_system_allocator.alloc ||
+	         allocator->alloc == rle_atomic_allocator.alloc) &&
+	        allocator->free == rle_system_allocator.free);
+}
+
+
+/**
+ * @brief         Check whether an allocator is the allocator of memory given by the caller.
+ *
+ * @param[in]     allocator                The allocator.
+ *
+ * @return        true if the memory belongs to the caller, else false.
+ *
+ * @ingroup       RLE allocator
+ */
+static inline bool rle_allocator_is_caller(const struct rle_allocator *const allocator)
+{
+	return (allocator->alloc == rle_caller_allocator.alloc &&
+	        allocator->free == rle_caller_allocator.free);
+}
+
+#endif /* __RLE_ALLOCATOR_H__ */
@@ -115,82 +115,18 @@ bool rle_config_check(const struct rle_config *const conf)
 		         conf->type_0_alpdu_label_size, implicit_alpdu_label_size_max);
 		return false;
 	}
-
-	return true;
-}
-
-bool ptype_is_omissible(const uint16_t ptype,
-                        const struct rle_config *const rle_conf,
-                        const struct rle_frag_buf *const frag_buf)
-{
-	bool is_omissible;
-
-	if (rle_conf->allow_ptype_omission != 1) {
-		/* protocol omission is disabled in configuration */
-		RLE_DEBUG("protocol type is NOT omissible (disabled in config)");
-		is_omissible = false;
-	} else if (ptype == RLE_PROTO_TYPE_SIGNAL_UNCOMP) {
-		/* protocol omission is enabled in configuration, and protocol is signaling */
-		RLE_DEBUG("protocol type is omissible (signaling)");
-		is_omissible = true;
-	} else {
-		/* protocol omission is enabled in configuration, check the traffic payload */
-		const uint8_t default_ptype = rle_conf->implicit_protocol_type;
-
-		switch (default_ptype) {
-		case RLE_PROTO_TYPE_IP_COMP:
-		{
-			uint8_t ip_version;
-
-			/* protocol omission is possible if IPv4 or IPv6 is detected, and the first 4 bits
-			 * of the SDU contain a supported IP version so that the RLE receiver is able to infer
-			 * the IP version from them */
-			if (frag_buf->sdu_info.size < 1) {
-				RLE_DEBUG("protocol type is NOT omissible (too short IP packet)");
-				is_omissible = false;
-				break;
-			}
-
-			ip_version = (frag_buf->sdu.start[0] >> 4) & 0x0f;
-			if ((ptype == RLE_PROTO_TYPE_IPV4_UNCOMP && ip_version == 4) ||
-			    (ptype == RLE_PROTO_TYPE_IPV6_UNCOMP && ip_version == 6)) {
-				RLE_DEBUG("protocol type is omissible (IP)");
-				is_omissible = true;
-			} else {
-				RLE_DEBUG("protocol type is NOT omissible (unknown IP version)");
-				is_omissible = false;
-			}
-			break;
-		}
-		case RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD:
-		{
-			/* VLAN protocol type can be compressed in 2 different ways:
-			 *  - VLAN contains one IPv4 or IPv6 packet as payload,
-			 *  - VLAN contains something else as payload.
-			 */
-			const uint8_t compressed_ptype =
-				is_eth_vlan_ip_frame(frag_buf->sdu.start, frag_buf->sdu_info.size);
-			is_omissible =
-				(compressed_ptype == RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD);
-			RLE_DEBUG("protocol type is%s omissible", is_omissible ? "" : " NOT");
-			break;
-		}
-		default:
-			/* other normal cases */
-			if (ptype == rle_header_ptype_decompression(default_ptype)) {
-				RLE_DEBUG("protocol type is omissible (protocol type = 0x%04x, "
-				          "implicit protocol type = 0x%02x)", ptype, default_ptype);
-				is_omissible = true;
-			} else {
-				RLE_DEBUG("protocol type is NOT omissible (protocol type = 0x%04x, "
-				          "implicit protocol type = 0x%02x)", ptype, default_ptype);
-				is_omissible = false;
-			}
-			break;
-		}
+	if (conf->fragment_contexts_nr > RLE_MAX_FRAG_NUMBER) {
+		RLE_WARN("configuration parameter fragment_contexts_nr set to %u while only values "
+		         "[0 ; %u] allowed", conf->fragment_contexts_nr, RLE_MAX_FRAG_NUMBER);
+		return false;
+	}
+	if (conf->realtime != 0 && conf->realtime != 1) {
+		RLE_WARN("configuration parameter realtime set to %d while 0 or 1 expected",
+		         conf->realtime);
+		return false;
 	}
 
-	return is_omissible;
+	return true;
 }
 
 enum rle_header_size_status rle_get_header_size(const struct rle_config *const conf,
@@ -258,3 +194,26 @@ enum rle_header_size_status rle_get_header_size(const struct rle_config *const c
 error:
 	return status;
 }
+
+enum rle_header_size_status rle_get_alpdu_header_size(const struct rle_config *const conf,
+                                                      const uint16_t protocol_type,
+                                                      size_t *const alpdu_header_size)
+{
+	enum rle_header_size_status status = RLE_HEADER_SIZE_ERR;
+	struct rle_ptype_hdr hdr;
+
+	if (!rle_config_check(conf) || alpdu_header_size == NULL) {
+		goto error;
+	}
+
+	rle_ptype_hdr_classify(conf, protocol_type, &hdr);
+	if (rle_ptype_hdr_get_size(&hdr, alpdu_header_size)) {
+		status = RLE_HEADER_SIZE_OK;
+	} else {
+		/* VLAN frames and implicit IPv4/IPv6 depend on the payload */
+		status = RLE_HEADER_SIZE_ERR_NON_DETERMINISTIC;
+	}
+
+error:
+	return status;
+}
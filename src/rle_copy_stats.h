@@ -0,0 +1,166 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_copy_stats.h
+ * @brief  Counters of the octets copied and covered by a CRC on the data path
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#ifndef __RLE_COPY_STATS_H__
+#define __RLE_COPY_STATS_H__
+
+#ifndef __KERNEL__
+
+#include <stdint.h>
+#include <string.h>
+
+#else
+
+#include <linux/types.h>
+#include <linux/string.h>
+
+#endif
+
+#include "rle.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC CONSTANTS AND MACROS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef RLE_COPY_STATS
+
+/**
+ * Count a copy of a stage of a module. The counters have a single writer, they are updated with
+ * relaxed atomic stores so that a monitoring thread reads them untorn.
+ */
+#define rle_copy_count(copy_stats, stage, copied, crc) \
+	rle_copy_add(&(copy_stats)->stages[(stage)], (copied), (crc))
+
+#else
+
+/** Without the COPY_STATS option, nothing, the arguments are not even evaluated */
+#define rle_copy_count(copy_stats, stage, copied, crc) \
+	do { \
+	} while (0)
+
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef RLE_COPY_STATS
+
+/** The copies counters of the stages of a transmitter or a receiver */
+struct rle_copy_stats {
+	struct rle_copy_counters stages[RLE_COPY_STAGES_NR];
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Count a copy of a stage, written by a single thread.
+ *
+ * @param[in,out] counters                 The counters of the stage.
+ * @param[in]     copied                   The number of octets copied.
+ * @param[in]     crc                      The number of octets covered by a CRC.
+ *
+ * @ingroup       RLE copy statistics
+ */
+static inline void rle_copy_add(struct rle_copy_counters *const counters,
+                                const size_t copied,
+                                const size_t crc);
+
+/**
+ * @brief         Count a copy of a stage shared between threads.
+ *
+ * @param[in,out] counters                 The counters of the stage.
+ * @param[in]     copied                   The number of octets copied.
+ *
+ * @ingroup       RLE copy statistics
+ */
+static inline void rle_copy_add_shared(struct rle_copy_counters *const counters,
+                                       const size_t copied);
+
+/**
+ * @brief         Copy the counters of a stage updated by another thread.
+ *
+ * @param[in]     counters                 The counters of the stage.
+ * @param[out]    copy                     The copy of the counters.
+ *
+ * @ingroup       RLE copy statistics
+ */
+static inline void rle_copy_read(const struct rle_copy_counters *const counters,
+                                 struct rle_copy_counters *const copy);
+
+/**
+ * @brief         Reset the counters of all the stages of a module.
+ *
+ * @param[in,out] copy_stats               The counters.
+ *
+ * @ingroup       RLE copy statistics
+ */
+static inline void rle_copy_reset(struct rle_copy_stats *const copy_stats);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static inline void rle_copy_add(struct rle_copy_counters *const counters,
+                                const size_t copied,
+                                const size_t crc)
+{
+	__atomic_store_n(&counters->calls, counters->calls + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&counters->bytes_copied, counters->bytes_copied + copied, __ATOMIC_RELAXED);
+	__atomic_store_n(&counters->bytes_crc, counters->bytes_crc + crc, __ATOMIC_RELAXED);
+}
+
+static inline void rle_copy_add_shared(struct rle_copy_counters *const counters,
+                                       const size_t copied)
+{
+	__atomic_fetch_add(&counters->calls, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&counters->bytes_copied, copied, __ATOMIC_RELAXED);
+}
+
+static inline void rle_copy_read(const struct rle_copy_counters *const counters,
+                                 struct rle_copy_counters *const copy)
+{
+	copy->calls = __atomic_load_n(&counters->calls, __ATOMIC_RELAXED);
+	copy->bytes_copied = __atomic_load_n(&counters->bytes_copied, __ATOMIC_RELAXED);
+	copy->bytes_crc = __atomic_load_n(&counters->bytes_crc, __ATOMIC_RELAXED);
+}
+
+static inline void rle_copy_reset(struct rle_copy_stats *const copy_stats)
+{
+	memset(copy_stats, 0, sizeof(*copy_stats));
+}
+
+#endif /* RLE_COPY_STATS */
+
+#endif /* __RLE_COPY_STATS_H__ */
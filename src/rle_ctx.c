@@ -60,15 +60,6 @@
  */
 static void flush(struct rle_ctx_mngt *_this);
 
-/**
- *  @brief  Flush all data and pointer of a RLE context structure with fragmentation buffers.
- *
- *  @param[in,out]  _this  Pointer to the RLE context structure.
- *
- *  @ingroup RLE context
- */
-static void flush_ctxt_frag_buf(struct rle_ctx_mngt *_this);
-
 /**
  *  @brief  Flush all data and pointer of a RLE context structure with reassembly buffers.
  *
@@ -89,18 +80,7 @@ static void flush(struct rle_ctx_mngt *_this)
 	_this->next_seq_nb = 0xff;
 	_this->use_crc = false;
 	rle_ctx_reset_counters(_this);
-
-	return;
-}
-
-static void flush_ctxt_frag_buf(struct rle_ctx_mngt *_this)
-{
-	int ret;
-
-	flush(_this);
-
-	ret = rle_frag_buf_init((rle_frag_buf_t *)_this->buff);
-	assert(ret == 0); /* cannot fail since frag_buf is not NULL */
+	rle_size_sdu_start(&_this->lk_status->size_stats);
 
 	return;
 }
@@ -108,7 +88,7 @@ static void flush_ctxt_frag_buf(struct rle_ctx_mngt *_this)
 static void flush_ctxt_rasm_buf(struct rle_ctx_mngt *_this)
 {
 	flush(_this);
-	rasm_buf_init((rle_rasm_buf_t *)_this->buff);
+	rasm_buf_release_storage((rle_rasm_buf_t *)_this->buff);
 
 	return;
 }
@@ -120,35 +100,25 @@ static void flush_ctxt_rasm_buf(struct rle_ctx_mngt *_this)
 
 int rle_ctx_init_frag_buf(struct rle_ctx_mngt *_this)
 {
-	int status = C_ERROR;
-
 	assert(_this != NULL);
 
-	_this->buff = (void *)rle_frag_buf_new();
-
-	/* allocate enough memory space for the fragmentation */
-	if (!_this->buff) {
-		RLE_ERR("fragmentation buffer allocation failed.");
-		goto out;
-	}
+	/* the fragmentation buffer is only allocated when a SDU is encapsulated, sized for it */
+	_this->buff = NULL;
 
 	/* set to zero or invalid values all variables */
-	flush_ctxt_frag_buf(_this);
-
-	status = C_OK;
+	flush(_this);
 
-out:
-	return status;
+	return C_OK;
 }
 
-int rle_ctx_init_rasm_buf(struct rle_ctx_mngt *_this)
+int rle_ctx_init_rasm_buf(struct rle_ctx_mngt *_this, const struct rle_allocator *const allocator)
 {
 	int status = C_ERROR;
 
 	assert(_this != NULL);
 
-	/* allocate enough memory space for the reassembly */
-	_this->buff = (void *)rasm_buf_new();
+	/* allocate the reassembly buffer, its storage is only taken when a SDU is reassembled */
+	_this->buff = (void *)rasm_buf_new(allocator);
 	if (!_this->buff) {
 		RLE_ERR("reassembly buffer allocation failed.");
 		goto out;
@@ -163,14 +133,26 @@ out:
 	return status;
 }
 
+void rle_ctx_init_rasm_buf_in_place(struct rle_ctx_mngt *_this, void *const mem,
+                                    const struct rle_allocator *const allocator)
+{
+	assert(_this != NULL);
+
+	_this->buff = (void *)rasm_buf_init_in_place(mem, allocator);
+
+	/* set to zero or invalid values all variables */
+	flush_ctxt_rasm_buf(_this);
+}
+
 void rle_ctx_destroy_frag_buf(struct rle_ctx_mngt *_this)
 {
 	assert(_this != NULL);
-	assert(_this->buff != NULL);
 
 	flush(_this);
 
-	rle_frag_buf_del((rle_frag_buf_t **)&_this->buff);
+	if (_this->buff != NULL) {
+		rle_frag_buf_del((rle_frag_buf_t **)&_this->buff);
+	}
 }
 
 void rle_ctx_destroy_rasm_buf(struct rle_ctx_mngt *_this)
@@ -181,6 +163,15 @@ void rle_ctx_destroy_rasm_buf(struct rle_ctx_mngt *_this)
 	rasm_buf_del((rle_rasm_buf_t **)&_this->buff);
 }
 
+void rle_ctx_fini_rasm_buf(struct rle_ctx_mngt *_this)
+{
+	assert(_this != NULL);
+	assert(_this->buff != NULL);
+
+	rasm_buf_release_storage((rle_rasm_buf_t *)_this->buff);
+	_this->buff = NULL;
+}
+
 void rle_ctx_set_seq_nb(struct rle_ctx_mngt *_this, uint8_t val)
 {
 	_this->next_seq_nb = val;
@@ -206,6 +197,43 @@ bool rle_ctx_get_use_crc(const struct rle_ctx_mngt *const _this)
 	return _this->use_crc;
 }
 
+void rle_ctx_reset_counters(struct rle_ctx_mngt *const _this)
+{
+	rle_ctx_reset_counter_in(_this);
+	rle_ctx_reset_counter_ok(_this);
+	rle_ctx_reset_counter_dropped(_this);
+	rle_ctx_reset_counter_lost(_this);
+	rle_ctx_reset_counter_bytes_in(_this);
+	rle_ctx_reset_counter_bytes_ok(_this);
+	rle_ctx_reset_counter_bytes_dropped(_this);
+#ifdef RLE_SIZE_STATS
+	rle_size_reset(&_this->lk_status->size_stats);
+#endif
+}
+
+void rle_ctx_rebase_counters(struct rle_ctx_mngt *const _this,
+                             struct link_counters *const counters)
+{
+	struct link_counters *const base = &_this->lk_status->base;
+	const struct link_counters loaded = *counters;
+
+	counters->counter_in -= rle_ctx_counter_read(base->counter_in);
+	counters->counter_ok -= rle_ctx_counter_read(base->counter_ok);
+	counters->counter_dropped -= rle_ctx_counter_read(base->counter_dropped);
+	counters->counter_lost -= rle_ctx_counter_read(base->counter_lost);
+	counters->counter_bytes_in -= rle_ctx_counter_read(base->counter_bytes_in);
+	counters->counter_bytes_ok -= rle_ctx_counter_read(base->counter_bytes_ok);
+	counters->counter_bytes_dropped -= rle_ctx_counter_read(base->counter_bytes_dropped);
+
+	rle_ctx_counter_write(base->counter_in, loaded.counter_in);
+	rle_ctx_counter_write(base->counter_ok, loaded.counter_ok);
+	rle_ctx_counter_write(base->counter_dropped, loaded.counter_dropped);
+	rle_ctx_counter_write(base->counter_lost, loaded.counter_lost);
+	rle_ctx_counter_write(base->counter_bytes_in, loaded.counter_bytes_in);
+	rle_ctx_counter_write(base->counter_bytes_ok, loaded.counter_bytes_ok);
+	rle_ctx_counter_write(base->counter_bytes_dropped, loaded.counter_bytes_dropped);
+}
+
 size_t get_fragment_length(const unsigned char *const buffer)
 {
 	const rle_ppdu_hdr_t *const ppdu_hdr = (rle_ppdu_hdr_t *)buffer;
@@ -43,12 +43,46 @@
 
 #include "constants.h"
 #include "fragmentation_buffer.h"
+#include "rle_size_stats.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC CONSTANTS AND MACROS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * Relaxed atomic accesses to the link status counters, so that a monitoring thread may read them
+ * while the context is in use without tearing. Counters have a single writer, so increments need
+ * no atomic read-modify-write instruction. They are never written by the monitoring thread either:
+ * resetting a counter moves its base, the value it is read from, see struct link_counters.
+ */
+#define rle_ctx_counter_read(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+#define rle_ctx_counter_write(counter, val) __atomic_store_n(&(counter), (val), __ATOMIC_RELAXED)
+#define rle_ctx_counter_add(counter, val) \
+	rle_ctx_counter_write(counter, rle_ctx_counter_read(counter) + (val))
 
 
 /*------------------------------------------------------------------------------------------------*/
 /*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
 
+/**
+ * Values of the link status counters.
+ *
+ * The counters of a link status only grow, written by the data path. They are read from a base,
+ * their values at the last reset, written by the monitoring thread only: a reset never races with
+ * an increment, and no increment is lost between a read and a reset of the counters.
+ */
+struct link_counters {
+	uint64_t counter_in;             /**< SDUs received (partially received) or to transmit     */
+	uint64_t counter_ok;             /**< SDUs sent/received successfully                       */
+	uint64_t counter_dropped;        /**< SDUs dropped                                          */
+	uint64_t counter_lost;           /**< SDUs lost                                             */
+	uint64_t counter_bytes_in;       /**< Bytes received (partially received) or to transmit    */
+	uint64_t counter_bytes_ok;       /**< Bytes of the SDUs sent/received successfully          */
+	uint64_t counter_bytes_dropped;  /**< Bytes dropped                                         */
+};
+
 /** RLE link status counters */
 struct link_status {
 	/** Number of SDUs received (partially received) for transmission (reception) */
@@ -65,24 +99,33 @@ struct link_status {
 	uint64_t counter_bytes_ok;
 	/** Number of bytes dropped */
 	uint64_t counter_bytes_dropped;
+	/** Number of bytes of the SDU being received, dropped with it */
+	size_t current_counter;
+	/** The counters at their last reset, then written by the monitoring thread only */
+	struct link_counters base;
+#ifdef RLE_SIZE_STATS
+	/** SDUs sent/received successfully, by size and by number of PPDUs */
+	struct rle_size_stats size_stats;
+#endif
 };
 
-/** RLE context management structure */
+/**
+ * RLE context management structure, the state of a context read on each PPDU.
+ *
+ * The counters are kept apart, in an array of the transmitter or receiver, so that the
+ * contexts of a transmitter or receiver fit in three cache lines together (24 bytes each).
+ */
 struct rle_ctx_mngt {
+	/** Fragmentation/Reassembly buffer. */
+	void *buff;
+	/** Fragmentation context status, in the counters of the transmitter or receiver */
+	struct link_status *lk_status;
 	/** specify fragment id the structure belongs to */
 	uint8_t frag_id;
 	/** next sequence number for frag_id */
 	uint8_t next_seq_nb;
 	/** CRC32 trailer usage status */
 	bool use_crc;
-	/** Fragmentation/Reassembly buffer. */
-	void *buff;
-	/** Current octets counter. */
-	size_t current_counter;
-	/** Type of link TX or RX */
-	int lk_type;
-	/** Fragmentation context status */
-	struct link_status lk_status;
 };
 
 
@@ -93,6 +136,9 @@ struct rle_ctx_mngt {
 /**
  * @brief  Initialize RLE context structure with fragmentation buffers.
  *
+ * The fragmentation buffer itself is only allocated when the context is first used, see
+ * frag_buf_reserve().
+ *
  * @param[out]    _this  Pointer to the RLE context structure
  *
  * @return  C_ERROR  If initilization went wrong
@@ -105,14 +151,27 @@ int rle_ctx_init_frag_buf(struct rle_ctx_mngt *_this);
 /**
  * @brief  Initialize RLE context structure with reassembly buffers.
  *
- * @param[out]    _this  Pointer to the RLE context structure
+ * @param[out]    _this      Pointer to the RLE context structure
+ * @param[in]     allocator  The allocator of the reassembly buffer
  *
  * @return  C_ERROR  If initilization went wrong
  *          C_OK     Otherwise
  *
  * @ingroup RLE context
  */
-int rle_ctx_init_rasm_buf(struct rle_ctx_mngt *_this);
+int rle_ctx_init_rasm_buf(struct rle_ctx_mngt *_this, const struct rle_allocator *const allocator);
+
+/**
+ * @brief  Initialize RLE context structure with a reassembly buffer in caller memory.
+ *
+ * @param[out]    _this      Pointer to the RLE context structure
+ * @param[in,out] mem        The memory of the reassembly buffer
+ * @param[in]     allocator  The allocator of the storages of the reassembly buffer
+ *
+ * @ingroup RLE context
+ */
+void rle_ctx_init_rasm_buf_in_place(struct rle_ctx_mngt *_this, void *const mem,
+                                    const struct rle_allocator *const allocator);
 
 /**
  * @brief  Destroy RLE context with fragmentation buffers structure and free memory
@@ -132,6 +191,15 @@ void rle_ctx_destroy_frag_buf(struct rle_ctx_mngt *_this);
  */
 void rle_ctx_destroy_rasm_buf(struct rle_ctx_mngt *_this);
 
+/**
+ * @brief  Finalize RLE context with a reassembly buffer in caller memory, releasing its storage
+ *
+ * @param[out]   _this  Pointer to the RLE context structure
+ *
+ * @ingroup RLE context
+ */
+void rle_ctx_fini_rasm_buf(struct rle_ctx_mngt *_this);
+
 /**
  * @brief  Set sequence number
  *
@@ -267,7 +335,8 @@ uint16_t rle_ctx_get_proto_type(struct rle_ctx_mngt *const _this);
  */
 static inline void rle_ctx_set_counter_in(struct rle_ctx_mngt *const _this, const uint64_t val)
 {
-	_this->lk_status.counter_in = val;
+	rle_ctx_counter_write(_this->lk_status->base.counter_in,
+	                      rle_ctx_counter_read(_this->lk_status->counter_in) - val);
 
 	return;
 }
@@ -297,7 +366,7 @@ static inline void rle_ctx_reset_counter_in(struct rle_ctx_mngt *const _this)
  */
 static inline void rle_ctx_incr_counter_in(struct rle_ctx_mngt *const _this)
 {
-	_this->lk_status.counter_in++;
+	rle_ctx_counter_add(_this->lk_status->counter_in, 1);
 
 	return;
 }
@@ -314,7 +383,8 @@ static inline void rle_ctx_incr_counter_in(struct rle_ctx_mngt *const _this)
  */
 static inline uint64_t rle_ctx_get_counter_in(const struct rle_ctx_mngt *const _this)
 {
-	return _this->lk_status.counter_in;
+	return rle_ctx_counter_read(_this->lk_status->counter_in) -
+	       rle_ctx_counter_read(_this->lk_status->base.counter_in);
 }
 
 
@@ -328,7 +398,8 @@ static inline uint64_t rle_ctx_get_counter_in(const struct rle_ctx_mngt *const _
  */
 static inline void rle_ctx_set_counter_ok(struct rle_ctx_mngt *const _this, const uint64_t val)
 {
-	_this->lk_status.counter_ok = val;
+	rle_ctx_counter_write(_this->lk_status->base.counter_ok,
+	                      rle_ctx_counter_read(_this->lk_status->counter_ok) - val);
 
 	return;
 }
@@ -358,7 +429,7 @@ static inline void rle_ctx_reset_counter_ok(struct rle_ctx_mngt *const _this)
  */
 static inline void rle_ctx_incr_counter_ok(struct rle_ctx_mngt *const _this)
 {
-	_this->lk_status.counter_ok++;
+	rle_ctx_counter_add(_this->lk_status->counter_ok, 1);
 
 	return;
 }
@@ -375,7 +446,8 @@ static inline void rle_ctx_incr_counter_ok(struct rle_ctx_mngt *const _this)
  */
 static inline uint64_t rle_ctx_get_counter_ok(const struct rle_ctx_mngt *const _this)
 {
-	return _this->lk_status.counter_ok;
+	return rle_ctx_counter_read(_this->lk_status->counter_ok) -
+	       rle_ctx_counter_read(_this->lk_status->base.counter_ok);
 }
 
 
@@ -389,7 +461,8 @@ static inline uint64_t rle_ctx_get_counter_ok(const struct rle_ctx_mngt *const _
  */
 static inline void rle_ctx_set_counter_dropped(struct rle_ctx_mngt *const _this, const uint64_t val)
 {
-	_this->lk_status.counter_dropped = val;
+	rle_ctx_counter_write(_this->lk_status->base.counter_dropped,
+	                      rle_ctx_counter_read(_this->lk_status->counter_dropped) - val);
 
 	return;
 }
@@ -419,7 +492,7 @@ static inline void rle_ctx_reset_counter_dropped(struct rle_ctx_mngt *const _thi
  */
 static inline void rle_ctx_incr_counter_dropped(struct rle_ctx_mngt *const _this)
 {
-	_this->lk_status.counter_dropped++;
+	rle_ctx_counter_add(_this->lk_status->counter_dropped, 1);
 
 	return;
 }
@@ -436,7 +509,8 @@ static inline void rle_ctx_incr_counter_dropped(struct rle_ctx_mngt *const _this
  */
 static inline uint64_t rle_ctx_get_counter_dropped(const struct rle_ctx_mngt *const _this)
 {
-	return _this->lk_status.counter_dropped;
+	return rle_ctx_counter_read(_this->lk_status->counter_dropped) -
+	       rle_ctx_counter_read(_this->lk_status->base.counter_dropped);
 }
 
 
@@ -450,7 +524,8 @@ static inline uint64_t rle_ctx_get_counter_dropped(const struct rle_ctx_mngt *co
  */
 static inline void rle_ctx_set_counter_lost(struct rle_ctx_mngt *const _this, const uint64_t val)
 {
-	_this->lk_status.counter_lost = val;
+	rle_ctx_counter_write(_this->lk_status->base.counter_lost,
+	                      rle_ctx_counter_read(_this->lk_status->counter_lost) - val);
 
 	return;
 }
@@ -480,7 +555,7 @@ static inline void rle_ctx_reset_counter_lost(struct rle_ctx_mngt *const _this)
  */
 static inline void rle_ctx_incr_counter_lost(struct rle_ctx_mngt *const _this, const uint64_t val)
 {
-	_this->lk_status.counter_lost += val;
+	rle_ctx_counter_add(_this->lk_status->counter_lost, val);
 
 	return;
 }
@@ -497,7 +572,8 @@ static inline void rle_ctx_incr_counter_lost(struct rle_ctx_mngt *const _this, c
  */
 static inline uint64_t rle_ctx_get_counter_lost(const struct rle_ctx_mngt *const _this)
 {
-	return _this->lk_status.counter_lost;
+	return rle_ctx_counter_read(_this->lk_status->counter_lost) -
+	       rle_ctx_counter_read(_this->lk_status->base.counter_lost);
 }
 
 
@@ -512,7 +588,8 @@ static inline uint64_t rle_ctx_get_counter_lost(const struct rle_ctx_mngt *const
 static inline void rle_ctx_set_counter_bytes_in(struct rle_ctx_mngt *const _this,
                                                 const uint64_t val)
 {
-	_this->lk_status.counter_bytes_in = val;
+	rle_ctx_counter_write(_this->lk_status->base.counter_bytes_in,
+	                      rle_ctx_counter_read(_this->lk_status->counter_bytes_in) - val);
 
 	return;
 }
@@ -545,7 +622,7 @@ static inline void rle_ctx_reset_counter_bytes_in(struct rle_ctx_mngt *const _th
 static inline void rle_ctx_incr_counter_bytes_in(struct rle_ctx_mngt *const _this,
                                                  const uint64_t val)
 {
-	_this->lk_status.counter_bytes_in += val;
+	rle_ctx_counter_add(_this->lk_status->counter_bytes_in, val);
 
 	return;
 }
@@ -562,7 +639,8 @@ static inline void rle_ctx_incr_counter_bytes_in(struct rle_ctx_mngt *const _thi
  */
 static inline uint64_t rle_ctx_get_counter_bytes_in(const struct rle_ctx_mngt *const _this)
 {
-	return _this->lk_status.counter_bytes_in;
+	return rle_ctx_counter_read(_this->lk_status->counter_bytes_in) -
+	       rle_ctx_counter_read(_this->lk_status->base.counter_bytes_in);
 }
 
 
@@ -577,7 +655,8 @@ static inline uint64_t rle_ctx_get_counter_bytes_in(const struct rle_ctx_mngt *c
 static inline void rle_ctx_set_counter_bytes_ok(struct rle_ctx_mngt *const _this,
                                                 const uint64_t val)
 {
-	_this->lk_status.counter_bytes_ok = val;
+	rle_ctx_counter_write(_this->lk_status->base.counter_bytes_ok,
+	                      rle_ctx_counter_read(_this->lk_status->counter_bytes_ok) - val);
 
 	return;
 }
@@ -609,7 +688,7 @@ static inline void rle_ctx_reset_counter_bytes_ok(struct rle_ctx_mngt *const _th
 static inline void rle_ctx_incr_counter_bytes_ok(struct rle_ctx_mngt *const _this,
                                                  const uint64_t val)
 {
-	_this->lk_status.counter_bytes_ok += val;
+	rle_ctx_counter_add(_this->lk_status->counter_bytes_ok, val);
 
 	return;
 }
@@ -626,7 +705,8 @@ static inline void rle_ctx_incr_counter_bytes_ok(struct rle_ctx_mngt *const _thi
  */
 static inline uint64_t rle_ctx_get_counter_bytes_ok(const struct rle_ctx_mngt *const _this)
 {
-	return _this->lk_status.counter_bytes_ok;
+	return rle_ctx_counter_read(_this->lk_status->counter_bytes_ok) -
+	       rle_ctx_counter_read(_this->lk_status->base.counter_bytes_ok);
 }
 
 
@@ -641,7 +721,8 @@ static inline uint64_t rle_ctx_get_counter_bytes_ok(const struct rle_ctx_mngt *c
 static inline void rle_ctx_set_counter_bytes_dropped(struct rle_ctx_mngt *const _this,
                                                      const uint64_t val)
 {
-	_this->lk_status.counter_bytes_dropped = val;
+	rle_ctx_counter_write(_this->lk_status->base.counter_bytes_dropped,
+	                      rle_ctx_counter_read(_this->lk_status->counter_bytes_dropped) - val);
 
 	return;
 }
@@ -673,7 +754,7 @@ static inline void rle_ctx_reset_counter_bytes_dropped(struct rle_ctx_mngt *cons
 static inline void rle_ctx_incr_counter_bytes_dropped(struct rle_ctx_mngt *const _this,
                                                       const uint64_t val)
 {
-	_this->lk_status.counter_bytes_dropped += val;
+	rle_ctx_counter_add(_this->lk_status->counter_bytes_dropped, val);
 
 	return;
 }
@@ -691,7 +772,8 @@ static inline void rle_ctx_incr_counter_bytes_dropped(struct rle_ctx_mngt *const
 static inline uint64_t rle_ctx_get_counter_bytes_dropped(
 	const struct rle_ctx_mngt *const _this)
 {
-	return _this->lk_status.counter_bytes_dropped;
+	return rle_ctx_counter_read(_this->lk_status->counter_bytes_dropped) -
+	       rle_ctx_counter_read(_this->lk_status->base.counter_bytes_dropped);
 }
 
 
@@ -702,15 +784,61 @@ static inline uint64_t rle_ctx_get_counter_bytes_dropped(
  *
  * @ingroup RLE context
  */
-static inline void rle_ctx_reset_counters(struct rle_ctx_mngt *const _this)
+void rle_ctx_reset_counters(struct rle_ctx_mngt *const _this);
+
+/**
+ * @brief  Load the counters since the context initialization, not since their last reset
+ *
+ * @param[in]     _this     Pointer to the RLE context structure
+ * @param[out]    counters  The counters loaded
+ *
+ * @ingroup RLE context
+ */
+static inline void rle_ctx_load_counters(const struct rle_ctx_mngt *const _this,
+                                         struct link_counters *const counters)
+{
+	const struct link_status *const lk_status = _this->lk_status;
+
+	counters->counter_in = rle_ctx_counter_read(lk_status->counter_in);
+	counters->counter_ok = rle_ctx_counter_read(lk_status->counter_ok);
+	counters->counter_dropped = rle_ctx_counter_read(lk_status->counter_dropped);
+	counters->counter_lost = rle_ctx_counter_read(lk_status->counter_lost);
+	counters->counter_bytes_in = rle_ctx_counter_read(lk_status->counter_bytes_in);
+	counters->counter_bytes_ok = rle_ctx_counter_read(lk_status->counter_bytes_ok);
+	counters->counter_bytes_dropped = rle_ctx_counter_read(lk_status->counter_bytes_dropped);
+
+	return;
+}
+
+
+/**
+ * @brief  Reset the counters to values loaded with rle_ctx_load_counters(), and get their values
+ *         since their previous reset
+ *
+ *         The increments after the load are counted after the reset, none is lost.
+ *
+ * @param[in,out] _this     Pointer to the RLE context structure
+ * @param[in,out] counters  The counters loaded, their values since their previous reset on return
+ *
+ * @ingroup RLE context
+ */
+void rle_ctx_rebase_counters(struct rle_ctx_mngt *const _this,
+                             struct link_counters *const counters);
+
+
+/**
+ * @brief  Get the counters since their last reset, and reset them, in a single pass
+ *
+ * @param[in,out] _this     Pointer to the RLE context structure
+ * @param[out]    counters  The counters since their last reset
+ *
+ * @ingroup RLE context
+ */
+static inline void rle_ctx_fetch_reset_counters(struct rle_ctx_mngt *const _this,
+                                                struct link_counters *const counters)
 {
-	rle_ctx_reset_counter_in(_this);
-	rle_ctx_reset_counter_ok(_this);
-	rle_ctx_reset_counter_dropped(_this);
-	rle_ctx_reset_counter_lost(_this);
-	rle_ctx_reset_counter_bytes_in(_this);
-	rle_ctx_reset_counter_bytes_ok(_this);
-	rle_ctx_reset_counter_bytes_dropped(_this);
+	rle_ctx_load_counters(_this, counters);
+	rle_ctx_rebase_counters(_this, counters);
 
 	return;
 }
@@ -0,0 +1,359 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_decap_engine.c
+ * @brief  RLE decapsulation engine, running decapsulation jobs on worker threads
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include "rle_decap_engine.h"
+#include "constants.h"
+#include "rle.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#define MODULE_ID RLE_MOD_ID_DECAP_ENGINE
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Get the lane of a receiver.
+ *
+ * @param[in]     engine                  The engine.
+ * @param[in]     receiver                The receiver.
+ *
+ * @return        The lane, the same for all the jobs of the receiver.
+ */
+static size_t engine_lane(const struct rle_decap_engine *const engine,
+                          const struct rle_receiver *const receiver)
+{
+	/* Fibonacci hashing of the receiver address, whose low bits are alignment zeros */
+	const uint64_t hash = ((uint64_t)(uintptr_t)receiver >> 4) * 0x9e3779b97f4a7c15ULL;
+
+	return (size_t)((hash >> 32) % engine->lanes_nr);
+}
+
+/**
+ * @brief         Claim the next lane of a worker, by the worker itself or a thief.
+ *
+ * @param[in,out] worker                  The worker owning the lanes.
+ * @param[out]    lane                    The claimed lane.
+ *
+ * @return        true if a lane is claimed, false if all the lanes of the worker are claimed.
+ */
+static bool engine_claim_lane(struct rle_decap_worker *const worker, size_t *const lane)
+{
+	const size_t index = __atomic_fetch_add(&worker->next_lane, 1, __ATOMIC_RELAXED);
+	bool claimed = false;
+
+	if (index < RLE_DECAP_ENGINE_LANES_PER_WORKER) {
+		*lane = worker->id * RLE_DECAP_ENGINE_LANES_PER_WORKER + index;
+		claimed = true;
+	}
+
+	return claimed;
+}
+
+/**
+ * @brief         Run the jobs of a lane in order.
+ *
+ * @param[in,out] engine                  The engine.
+ * @param[in]     worker                  The index of the running worker.
+ * @param[in]     lane                    The lane.
+ */
+static void engine_run_lane(struct rle_decap_engine *const engine, const unsigned int worker,
+                            const size_t lane)
+{
+	size_t i;
+
+	for (i = engine->lanes_start[lane]; i < engine->lanes_start[lane + 1]; i++) {
+		struct rle_decap_job *const job = &engine->jobs[engine->order[i]];
+
+		job->sdus_nr = 0;
+		job->status = rle_decapsulate(job->receiver, job->fpdu, job->fpdu_length, job->sdus,
+		                              job->sdus_max_nr, &job->sdus_nr, job->payload_label,
+		                              job->payload_label_size);
+		if (engine->complete != NULL) {
+			engine->complete(engine->complete_arg, worker, job);
+		}
+	}
+}
+
+/**
+ * @brief         Thread of a worker, running its lanes then stealing the lanes of others for
+ *                each batch.
+ *
+ * @param[in,out] arg                     The worker.
+ *
+ * @return        NULL.
+ */
+static void * engine_worker(void *const arg)
+{
+	struct rle_decap_worker *const worker = (struct rle_decap_worker *)arg;
+	struct rle_decap_engine *const engine = worker->engine;
+	uint64_t batch_id = 0;
+
+	for (;;) {
+		unsigned int victim;
+		size_t lane;
+
+		pthread_mutex_lock(&engine->lock);
+		while (!engine->stop && engine->batch_id == batch_id) {
+			pthread_cond_wait(&engine->batch_start, &engine->lock);
+		}
+		if (engine->stop) {
+			pthread_mutex_unlock(&engine->lock);
+			break;
+		}
+		batch_id = engine->batch_id;
+		pthread_mutex_unlock(&engine->lock);
+
+		for (victim = 0; victim < engine->workers_nr; victim++) {
+			struct rle_decap_worker *const owner =
+				&engine->workers[(worker->id + victim) % engine->workers_nr];
+
+			while (engine_claim_lane(owner, &lane)) {
+				engine_run_lane(engine, worker->id, lane);
+			}
+		}
+
+		pthread_mutex_lock(&engine->lock);
+		engine->busy_workers_nr--;
+		if (engine->busy_workers_nr == 0) {
+			pthread_cond_signal(&engine->batch_done);
+		}
+		pthread_mutex_unlock(&engine->lock);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief         Stop and join the first workers of an engine.
+ *
+ * @param[in,out] engine                  The engine.
+ * @param[in]     started_nr              The number of started workers.
+ */
+static void engine_stop_workers(struct rle_decap_engine *const engine,
+                                const unsigned int started_nr)
+{
+	unsigned int i;
+
+	pthread_mutex_lock(&engine->lock);
+	engine->stop = true;
+	pthread_cond_broadcast(&engine->batch_start);
+	pthread_mutex_unlock(&engine->lock);
+
+	for (i = 0; i < started_nr; i++) {
+		pthread_join(engine->workers[i].thread, NULL);
+	}
+}
+
+/**
+ * @brief         Free the memory of an engine, its workers being stopped.
+ *
+ * @param[in,out] engine                  The engine.
+ */
+static void engine_free(struct rle_decap_engine *const engine)
+{
+	/* the allocator is read before it is released with the engine */
+	const struct rle_allocator allocator = engine->allocator;
+
+	rle_free(&allocator, engine->order);
+	rle_free(&allocator, engine->lanes_fill);
+	rle_free(&allocator, engine->lanes_start);
+	rle_free(&allocator, engine->workers);
+	rle_free(&allocator, engine);
+}
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+struct rle_decap_engine * rle_decap_engine_new(const unsigned int workers_nr,
+                                               const size_t jobs_max,
+                                               const rle_decap_complete_cb_t complete,
+                                               void *const complete_arg)
+{
+	struct rle_decap_engine *engine = NULL;
+	struct rle_allocator allocator;
+	unsigned int i;
+
+	if (workers_nr == 0 || workers_nr > RLE_DECAP_ENGINE_MAX_WORKERS) {
+		RLE_ERR("failed to create decapsulation engine: invalid number of workers %u",
+		        workers_nr);
+		goto error;
+	}
+
+	if (jobs_max == 0 || jobs_max > (SIZE_MAX / sizeof(size_t))) {
+		RLE_ERR("failed to create decapsulation engine: invalid number of jobs %zu", jobs_max);
+		goto error;
+	}
+
+	rle_get_allocator(&allocator);
+
+	engine = (struct rle_decap_engine *)rle_alloc(&allocator, sizeof(struct rle_decap_engine));
+	if (!engine) {
+		RLE_ERR("allocating decapsulation engine failed");
+		goto error;
+	}
+	memset(engine, 0, sizeof(struct rle_decap_engine));
+	engine->allocator = allocator;
+
+	engine->workers_nr = workers_nr;
+	engine->lanes_nr = workers_nr * RLE_DECAP_ENGINE_LANES_PER_WORKER;
+	engine->jobs_max = jobs_max;
+	engine->complete = complete;
+	engine->complete_arg = complete_arg;
+
+	engine->workers = (struct rle_decap_worker *)
+	                  rle_alloc(&allocator, workers_nr * sizeof(struct rle_decap_worker));
+	engine->lanes_start = (size_t *)rle_alloc(&allocator,
+	                                          (engine->lanes_nr + 1) * sizeof(size_t));
+	engine->lanes_fill = (size_t *)rle_alloc(&allocator, engine->lanes_nr * sizeof(size_t));
+	engine->order = (size_t *)rle_alloc(&allocator, jobs_max * sizeof(size_t));
+	if (!engine->workers || !engine->lanes_start || !engine->lanes_fill || !engine->order) {
+		RLE_ERR("allocating decapsulation engine for %u workers and %zu jobs failed",
+		        workers_nr, jobs_max);
+		goto free_engine;
+	}
+
+	if (pthread_mutex_init(&engine->lock, NULL) != 0) {
+		RLE_ERR("failed to initialize the lock of the decapsulation engine");
+		goto free_engine;
+	}
+	if (pthread_cond_init(&engine->batch_start, NULL) != 0) {
+		RLE_ERR("failed to initialize the batch start condition of the decapsulation engine");
+		goto destroy_lock;
+	}
+	if (pthread_cond_init(&engine->batch_done, NULL) != 0) {
+		RLE_ERR("failed to initialize the batch done condition of the decapsulation engine");
+		goto destroy_batch_start;
+	}
+
+	for (i = 0; i < workers_nr; i++) {
+		struct rle_decap_worker *const worker = &engine->workers[i];
+
+		worker->engine = engine;
+		worker->id = i;
+		worker->next_lane = RLE_DECAP_ENGINE_LANES_PER_WORKER;
+		if (pthread_create(&worker->thread, NULL, engine_worker, worker) != 0) {
+			RLE_ERR("failed to create worker %u of the decapsulation engine", i);
+			goto stop_workers;
+		}
+	}
+
+	return engine;
+
+stop_workers:
+	engine_stop_workers(engine, i);
+	pthread_cond_destroy(&engine->batch_done);
+destroy_batch_start:
+	pthread_cond_destroy(&engine->batch_start);
+destroy_lock:
+	pthread_mutex_destroy(&engine->lock);
+free_engine:
+	engine_free(engine);
+error:
+	return NULL;
+}
+
+void rle_decap_engine_destroy(struct rle_decap_engine **const engine)
+{
+	if (!engine || !*engine) {
+		/* Nothing to do. */
+		goto out;
+	}
+
+	engine_stop_workers(*engine, (*engine)->workers_nr);
+	pthread_cond_destroy(&(*engine)->batch_done);
+	pthread_cond_destroy(&(*engine)->batch_start);
+	pthread_mutex_destroy(&(*engine)->lock);
+	engine_free(*engine);
+	*engine = NULL;
+
+out:
+	return;
+}
+
+int rle_decap_engine_run(struct rle_decap_engine *const engine,
+                         struct rle_decap_job jobs[],
+                         const size_t jobs_nr)
+{
+	int status = 1;
+	size_t lane;
+	size_t i;
+
+	if (engine == NULL || (jobs == NULL && jobs_nr > 0)) {
+		goto out;
+	}
+
+	if (jobs_nr > engine->jobs_max) {
+		RLE_ERR("batch of %zu jobs, at most %zu expected", jobs_nr, engine->jobs_max);
+		goto out;
+	}
+
+	/* sort the jobs by lane, keeping the order of the jobs of each receiver */
+	memset(engine->lanes_start, 0, (engine->lanes_nr + 1) * sizeof(size_t));
+	for (i = 0; i < jobs_nr; i++) {
+		engine->lanes_start[engine_lane(engine, jobs[i].receiver) + 1]++;
+	}
+	for (lane = 0; lane < engine->lanes_nr; lane++) {
+		engine->lanes_start[lane + 1] += engine->lanes_start[lane];
+		engine->lanes_fill[lane] = engine->lanes_start[lane];
+	}
+	for (i = 0; i < jobs_nr; i++) {
+		engine->order[engine->lanes_fill[engine_lane(engine, jobs[i].receiver)]++] = i;
+	}
+
+	for (i = 0; i < engine->workers_nr; i++) {
+		engine->workers[i].next_lane = 0;
+	}
+	engine->jobs = jobs;
+
+	pthread_mutex_lock(&engine->lock);
+	engine->batch_id++;
+	engine->busy_workers_nr = engine->workers_nr;
+	pthread_cond_broadcast(&engine->batch_start);
+	while (engine->busy_workers_nr > 0) {
+		pthread_cond_wait(&engine->batch_done, &engine->lock);
+	}
+	pthread_mutex_unlock(&engine->lock);
+
+	engine->jobs = NULL;
+	status = 0;
+
+out:
+	return status;
+}
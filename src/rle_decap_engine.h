@@ -0,0 +1,95 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_decap_engine.h
+ * @brief  Definition of the RLE decapsulation engine, running decapsulation jobs on worker threads
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#ifndef __RLE_DECAP_ENGINE_H__
+#define __RLE_DECAP_ENGINE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "rle.h"
+#include "rle_allocator.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC CONSTANTS AND MACROS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** Number of lanes owned by each worker, lanes being the unit of work stealing */
+#define RLE_DECAP_ENGINE_LANES_PER_WORKER  8
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Worker of the decapsulation engine.
+ *
+ * @ingroup RLE receiver
+ */
+struct rle_decap_worker {
+	pthread_t thread;                /**< The worker thread                              */
+	struct rle_decap_engine *engine; /**< The engine of the worker                       */
+	unsigned int id;                 /**< The index of the worker                        */
+	size_t next_lane;                /**< Next lane of the worker to claim, atomic       */
+};
+
+/**
+ * @brief RLE decapsulation engine.
+ *
+ *        The jobs of a batch are sorted by lane, a receiver being hashed to a single lane so that
+ *        its jobs keep their order. Workers claim their own lanes first, then the remaining lanes
+ *        of the other workers.
+ *
+ * @ingroup RLE receiver
+ */
+struct rle_decap_engine {
+	struct rle_decap_worker *workers;  /**< The workers                                    */
+	unsigned int workers_nr;           /**< The number of workers                          */
+	size_t lanes_nr;                   /**< The number of lanes                            */
+	size_t jobs_max;                   /**< The max number of jobs per batch               */
+	size_t *lanes_start;               /**< Start of the lanes in the jobs order, per lane */
+	size_t *lanes_fill;                /**< Fill of the lanes while sorting jobs           */
+	size_t *order;                     /**< Indexes of the jobs of the batch, by lane      */
+	struct rle_decap_job *jobs;        /**< The jobs of the current batch                  */
+	rle_decap_complete_cb_t complete;  /**< The completion callback                        */
+	void *complete_arg;                /**< The argument of the completion callback        */
+	pthread_mutex_t lock;              /**< Lock of the batch state                        */
+	pthread_cond_t batch_start;        /**< Signaled when a batch starts or on stop        */
+	pthread_cond_t batch_done;         /**< Signaled when the last worker is done          */
+	uint64_t batch_id;                 /**< Identifier of the current batch                */
+	unsigned int busy_workers_nr;      /**< Number of workers running the current batch    */
+	bool stop;                         /**< Whether the workers shall stop                 */
+	struct rle_allocator allocator;    /**< The allocator of the engine                    */
+};
+
+
+#endif /* __RLE_DECAP_ENGINE_H__ */
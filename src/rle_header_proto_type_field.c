@@ -42,6 +42,15 @@
 
 #define RLE_PROTO_TYPE_IPV4_OR_IPV6 0
 
+/** First multiplier tried for the hash of the protocol type table, the golden ratio */
+#define RLE_PTYPE_TABLE_MULTIPLIER       0x9e3779b1U
+
+/** Max number of multipliers tried for the hash of the protocol type table */
+#define RLE_PTYPE_TABLE_MULTIPLIER_TRIES 1024
+
+/** Number of compressible protocol types */
+#define RLE_PROTO_TYPE_COMPRESSIBLE_NR   7
+
 /**
  * Lots of define to easily populate the array of protocol references, that allow to concatenate
  * initializing value for arrays. The concat initializer are based on the binary arithmetic and more
@@ -137,6 +146,54 @@ static const uint16_t rle_header_ptype_decomp[RLE_PROTO_TYPE_MAX_COMP_VALUE + 1]
 	RLE_PROTO_TYPE_ADJACENT_2BYTES_PTYPE
 };
 
+/* Compressible protocol types, the VLAN one may also be compressed depending on its payload */
+static const struct {
+	uint16_t uncomp;
+	uint8_t comp;
+} rle_header_ptype_comp[RLE_PROTO_TYPE_COMPRESSIBLE_NR] = {
+	{ RLE_PROTO_TYPE_SIGNAL_UNCOMP,           RLE_PROTO_TYPE_SIGNAL_COMP           },
+	{ RLE_PROTO_TYPE_VLAN_UNCOMP,             RLE_PROTO_TYPE_VLAN_COMP             },
+	{ RLE_PROTO_TYPE_VLAN_QINQ_UNCOMP,        RLE_PROTO_TYPE_VLAN_QINQ_COMP        },
+	{ RLE_PROTO_TYPE_VLAN_QINQ_LEGACY_UNCOMP, RLE_PROTO_TYPE_VLAN_QINQ_LEGACY_COMP },
+	{ RLE_PROTO_TYPE_IPV4_UNCOMP,             RLE_PROTO_TYPE_IPV4_COMP             },
+	{ RLE_PROTO_TYPE_IPV6_UNCOMP,             RLE_PROTO_TYPE_IPV6_COMP             },
+	{ RLE_PROTO_TYPE_ARP_UNCOMP,              RLE_PROTO_TYPE_ARP_COMP              },
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------- PRIVATE FUNCTIONS ----------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Check whether a protocol type is one of the keys of the protocol type table.
+ *
+ * @param[in]  keys     The keys.
+ * @param[in]  keys_nr  The number of keys.
+ * @param[in]  ptype    The protocol type.
+ *
+ * @return     true if the protocol type is a key, false otherwise.
+ */
+static bool ptype_is_key(const uint16_t keys[], const size_t keys_nr, const uint16_t ptype);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static bool ptype_is_key(const uint16_t keys[], const size_t keys_nr, const uint16_t ptype)
+{
+	size_t i;
+
+	for (i = 0; i < keys_nr; i++) {
+		if (keys[i] == ptype) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
@@ -223,3 +280,177 @@ uint8_t get_alpdu_label_type(const uint16_t protocol_type,
 
 	return alpdu_label_type;
 }
+
+void rle_ptype_hdr_classify(const struct rle_config *const conf, const uint16_t ptype,
+                            struct rle_ptype_hdr *const hdr)
+{
+	hdr->ptype = ptype;
+	hdr->omission = RLE_PTYPE_OMIT_NEVER;
+	hdr->vlan_wo_ptype = false;
+	hdr->comp_ptype = RLE_PROTO_TYPE_FALLBACK;
+
+	/* the protocol type is omitted if given ptype is equal to the default one and suppression is
+	 * active, or if given ptype is for signalling packet */
+	if (conf->allow_ptype_omission == 1) {
+		const uint8_t default_ptype = conf->implicit_protocol_type;
+
+		if (ptype == RLE_PROTO_TYPE_SIGNAL_UNCOMP) {
+			hdr->omission = RLE_PTYPE_OMIT_ALWAYS;
+		} else if (default_ptype == RLE_PROTO_TYPE_IP_COMP) {
+			/* the RLE receiver infers the IP version from the first 4 bits of the SDU */
+			if (ptype == RLE_PROTO_TYPE_IPV4_UNCOMP || ptype == RLE_PROTO_TYPE_IPV6_UNCOMP) {
+				hdr->omission = RLE_PTYPE_OMIT_IP_VERSION;
+			}
+		} else if (default_ptype == RLE_PROTO_TYPE_VLAN_COMP_WO_PTYPE_FIELD) {
+			/* the payload decides, the RLE receiver rebuilds the VLAN ptype field from the
+			 * IP payload */
+			hdr->omission = RLE_PTYPE_OMIT_VLAN_IP;
+			hdr->vlan_wo_ptype = (ptype == RLE_PROTO_TYPE_VLAN_UNCOMP);
+		} else if (ptype == rle_header_ptype_decompression(default_ptype)) {
+			hdr->omission = RLE_PTYPE_OMIT_ALWAYS;
+		}
+	}
+
+	if (!conf->use_compressed_ptype) {
+		hdr->form = RLE_ALPDU_HDR_UNCOMP;
+	} else if (ptype == RLE_PROTO_TYPE_VLAN_UNCOMP) {
+		/* VLAN protocol type can be compressed in 2 different ways:
+		 *  - VLAN contains one IPv4 or IPv6 packet as payload,
+		 *  - VLAN contains something else as payload.
+		 */
+		hdr->form = RLE_ALPDU_HDR_COMP_VLAN;
+	} else {
+		size_t i;
+
+		hdr->form = RLE_ALPDU_HDR_FALLBACK;
+		for (i = 0; i < RLE_PROTO_TYPE_COMPRESSIBLE_NR; i++) {
+			if (rle_header_ptype_comp[i].uncomp == ptype) {
+				hdr->form = RLE_ALPDU_HDR_COMP;
+				hdr->comp_ptype = rle_header_ptype_comp[i].comp;
+			}
+		}
+	}
+
+	/* the header templates, in network byte order; the COMP_VLAN form depends on the payload */
+	memset(hdr->alpdu_hdr, 0, sizeof(hdr->alpdu_hdr));
+	switch (hdr->form) {
+	case RLE_ALPDU_HDR_UNCOMP:
+		hdr->alpdu_hdr[0] = (uint8_t)(ptype >> 8);
+		hdr->alpdu_hdr[1] = (uint8_t)(ptype & 0xff);
+		hdr->alpdu_hdr_len = RLE_PROTO_TYPE_FIELD_SIZE_UNCOMP;
+		break;
+	case RLE_ALPDU_HDR_COMP:
+		hdr->alpdu_hdr[0] = hdr->comp_ptype;
+		hdr->alpdu_hdr_len = RLE_PROTO_TYPE_FIELD_SIZE_COMP;
+		break;
+	case RLE_ALPDU_HDR_FALLBACK:
+		hdr->alpdu_hdr[0] = RLE_PROTO_TYPE_FALLBACK;
+		hdr->alpdu_hdr[1] = (uint8_t)(ptype >> 8);
+		hdr->alpdu_hdr[2] = (uint8_t)(ptype & 0xff);
+		hdr->alpdu_hdr_len = RLE_ALPDU_HDR_MAX_SIZE;
+		break;
+	default:
+		hdr->alpdu_hdr_len = 0;
+		break;
+	}
+	hdr->ppdu_label[0] =
+		(uint8_t)((get_alpdu_label_type(ptype, false, conf->type_0_alpdu_label_size) << 1) |
+		          RLE_T_PROTO_TYPE_NO_SUPP);
+	hdr->ppdu_label[1] =
+		(uint8_t)((get_alpdu_label_type(ptype, true, conf->type_0_alpdu_label_size) << 1) |
+		          RLE_T_PROTO_TYPE_SUPP);
+}
+
+bool rle_ptype_hdr_get_size(const struct rle_ptype_hdr *const hdr, size_t *const size)
+{
+	bool is_known = true;
+
+	if (hdr->omission == RLE_PTYPE_OMIT_ALWAYS) {
+		*size = 0;
+	} else if (hdr->omission != RLE_PTYPE_OMIT_NEVER) {
+		is_known = false;
+	} else {
+		switch (hdr->form) {
+		case RLE_ALPDU_HDR_UNCOMP:
+			*size = RLE_PROTO_TYPE_FIELD_SIZE_UNCOMP;
+			break;
+		case RLE_ALPDU_HDR_COMP:
+			*size = RLE_PROTO_TYPE_FIELD_SIZE_COMP;
+			break;
+		case RLE_ALPDU_HDR_FALLBACK:
+			*size = RLE_PROTO_TYPE_FIELD_SIZE_COMP + RLE_PROTO_TYPE_FIELD_SIZE_UNCOMP;
+			break;
+		default:
+			is_known = false;
+			break;
+		}
+	}
+
+	return is_known;
+}
+
+bool rle_ptype_table_init(struct rle_ptype_table *const table,
+                          const struct rle_config *const conf)
+{
+	uint16_t keys[RLE_PROTO_TYPE_COMPRESSIBLE_NR + 1];
+	size_t keys_nr = 0;
+	uint32_t multiplier = RLE_PTYPE_TABLE_MULTIPLIER;
+	uint16_t other_ptype;
+	size_t tries;
+	size_t i;
+
+	/* the compressible protocol types and the implicit one are the only ones with a specific
+	 * ALPDU header, any other protocol type gets the header of a ptype that is none of them */
+	for (i = 0; i < RLE_PROTO_TYPE_COMPRESSIBLE_NR; i++) {
+		keys[keys_nr++] = rle_header_ptype_comp[i].uncomp;
+	}
+	if (conf->allow_ptype_omission == 1) {
+		const uint16_t implicit_ptype =
+			rle_header_ptype_decompression(conf->implicit_protocol_type);
+
+		if (!ptype_is_key(keys, keys_nr, implicit_ptype)) {
+			keys[keys_nr++] = implicit_ptype;
+		}
+	}
+	/* the default header is the one of the first protocol type that is not a key */
+	other_ptype = 0;
+	while (ptype_is_key(keys, keys_nr, other_ptype)) {
+		other_ptype++;
+	}
+	rle_ptype_hdr_classify(conf, other_ptype, &table->other);
+
+	/* odd multipliers are tried along a Weyl sequence, so that their high bits change at
+	 * each try */
+	for (tries = 0; tries < RLE_PTYPE_TABLE_MULTIPLIER_TRIES;
+	     tries++, multiplier += 2 * RLE_PTYPE_TABLE_MULTIPLIER) {
+		uint32_t used = 0;
+
+		for (i = 0; i < keys_nr; i++) {
+			const uint32_t bit = 1U << rle_ptype_table_slot(multiplier, keys[i]);
+
+			if (used & bit) {
+				break;
+			}
+			used |= bit;
+		}
+		if (i == keys_nr) {
+			break;
+		}
+	}
+	if (tries == RLE_PTYPE_TABLE_MULTIPLIER_TRIES) {
+		return false;
+	}
+
+	/* empty slots get the default header, so that a protocol type hashed to them gets the
+	 * default header whether its ptype matches or not */
+	table->multiplier = multiplier;
+	for (i = 0; i < RLE_PTYPE_TABLE_SLOTS; i++) {
+		table->slots[i] = table->other;
+	}
+	for (i = 0; i < keys_nr; i++) {
+		rle_ptype_hdr_classify(conf, keys[i],
+		                       &table->slots[rle_ptype_table_slot(multiplier, keys[i])]);
+	}
+
+	return true;
+}
@@ -29,11 +29,13 @@
 
 #ifndef __KERNEL__
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
 #else
 
+#include <linux/stddef.h>
 #include <linux/types.h>
 
 #endif
@@ -68,6 +70,62 @@
 /** Max protocol type compressed value */
 #define RLE_PROTO_TYPE_MAX_COMP_VALUE      0xff
 
+/** Size of the longest ALPDU header, the fallback one */
+#define RLE_ALPDU_HDR_MAX_SIZE \
+	(RLE_PROTO_TYPE_FIELD_SIZE_COMP + RLE_PROTO_TYPE_FIELD_SIZE_UNCOMP)
+
+/** Number of bits of the protocol type table hash */
+#define RLE_PTYPE_TABLE_BITS               5
+
+/** Number of slots of the protocol type table */
+#define RLE_PTYPE_TABLE_SLOTS              (1 << RLE_PTYPE_TABLE_BITS)
+
+/** Condition for the protocol type to be omitted from the ALPDU header */
+enum rle_ptype_omission {
+	RLE_PTYPE_OMIT_NEVER,       /**< Protocol type is never omitted                     */
+	RLE_PTYPE_OMIT_ALWAYS,      /**< Protocol type is always omitted                    */
+	RLE_PTYPE_OMIT_IP_VERSION,  /**< Omitted if the IP version matches the protocol type */
+	RLE_PTYPE_OMIT_VLAN_IP,     /**< Omitted if the VLAN frame carries IPv4 or IPv6     */
+};
+
+/** Form of the ALPDU header when the protocol type is not omitted */
+enum rle_alpdu_hdr_form {
+	RLE_ALPDU_HDR_UNCOMP,       /**< 2-byte uncompressed protocol type                 */
+	RLE_ALPDU_HDR_COMP,         /**< 1-byte compressed protocol type                   */
+	RLE_ALPDU_HDR_COMP_VLAN,    /**< 1-byte or fallback, depending on the VLAN payload */
+	RLE_ALPDU_HDR_FALLBACK,     /**< 3-byte compressed fallback protocol type          */
+};
+
+/** ALPDU header of a protocol type for a given configuration */
+struct rle_ptype_hdr {
+	uint16_t ptype;       /**< The uncompressed protocol type                       */
+	uint8_t omission;     /**< When the protocol type is omitted                    */
+	uint8_t form;         /**< The ALPDU header if the protocol type is not omitted */
+	uint8_t comp_ptype;   /**< The compressed protocol type of the COMP form        */
+	bool vlan_wo_ptype;   /**< Whether the VLAN ptype field is removed when omitted */
+	uint8_t alpdu_hdr[RLE_ALPDU_HDR_MAX_SIZE];  /**< The ALPDU header, but for COMP_VLAN */
+	uint8_t alpdu_hdr_len;                      /**< The length of the ALPDU header      */
+	uint8_t ppdu_label[2];  /**< The label type and suppressed bits of the COMPLETE/START
+	                         *   PPDU headers, with the protocol type sent or omitted    */
+};
+
+/**
+ * @brief Table of the ALPDU headers of protocol types, built once from the configuration.
+ *
+ *        The ALPDU header bytes and the label bits of the PPDU headers are built with the
+ *        table, so that the transmitter only copies them. The 2-byte uncompressed protocol type
+ *        of the default header is the one of the SDU, it is written over the template.
+ *
+ *        The protocol types with a specific header are stored in a perfect hash whose
+ *        multiplier is searched when the table is built. Any other protocol type gets the
+ *        default header.
+ */
+struct rle_ptype_table {
+	uint32_t multiplier;                               /**< Multiplier of the hash  */
+	struct rle_ptype_hdr slots[RLE_PTYPE_TABLE_SLOTS]; /**< Specific protocol types */
+	struct rle_ptype_hdr other;                        /**< Any other protocol type */
+};
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*-------------------------------------- PUBLIC FUNCTIONS ----------------------------------------*/
@@ -86,5 +144,114 @@ uint8_t get_alpdu_label_type(const uint16_t protocol_type,
                              const uint8_t type_0_alpdu_label_size)
 __attribute__((warn_unused_result));
 
+/**
+ * @brief Get the ALPDU header of a protocol type for a configuration.
+ *
+ * @param[in]  conf   The RLE configuration.
+ * @param[in]  ptype  The uncompressed protocol type.
+ * @param[out] hdr    The ALPDU header of the protocol type.
+ */
+void rle_ptype_hdr_classify(const struct rle_config *const conf, const uint16_t ptype,
+                            struct rle_ptype_hdr *const hdr);
+
+/**
+ * @brief Get the size of the ALPDU header of a protocol type, if known without the payload.
+ *
+ * @param[in]  hdr    The ALPDU header of the protocol type.
+ * @param[out] size   The size of the ALPDU header.
+ *
+ * @return     true if the size does not depend on the payload, false otherwise.
+ */
+bool rle_ptype_hdr_get_size(const struct rle_ptype_hdr *const hdr, size_t *const size)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief Build the table of the ALPDU headers of protocol types for a configuration.
+ *
+ * @param[out] table  The table.
+ * @param[in]  conf   The RLE configuration.
+ *
+ * @return     true if the table is built, false if no hash multiplier was found.
+ */
+bool rle_ptype_table_init(struct rle_ptype_table *const table,
+                          const struct rle_config *const conf)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief Get the slot of a protocol type in the table.
+ *
+ * @param[in]  multiplier  The multiplier of the hash.
+ * @param[in]  ptype       The uncompressed protocol type.
+ *
+ * @return     The slot of the protocol type.
+ */
+static inline size_t rle_ptype_table_slot(const uint32_t multiplier, const uint16_t ptype)
+{
+	return (size_t)(((uint32_t)ptype * multiplier) >> (32 - RLE_PTYPE_TABLE_BITS));
+}
+
+/**
+ * @brief Look up the ALPDU header of a protocol type in the table.
+ *
+ * @param[in]  table  The table.
+ * @param[in]  ptype  The uncompressed protocol type.
+ *
+ * @return     The ALPDU header of the protocol type.
+ */
+static inline const struct rle_ptype_hdr *
+rle_ptype_table_lookup(const struct rle_ptype_table *const table, const uint16_t ptype)
+{
+	const struct rle_ptype_hdr *const hdr =
+		&table->slots[rle_ptype_table_slot(table->multiplier, ptype)];
+
+	return (hdr->ptype == ptype) ? hdr : &table->other;
+}
+
+/**
+ * @brief Get the class of an uncompressed protocol type, counted to choose the implicit one.
+ *
+ * @param[in]  ptype  The uncompressed protocol type.
+ *
+ * @return     The class of the protocol type.
+ */
+static inline enum rle_ptype_class rle_ptype_get_class(const uint16_t ptype)
+{
+	enum rle_ptype_class ptype_class;
+
+	switch (ptype) {
+	case RLE_PROTO_TYPE_IPV4_UNCOMP:
+		ptype_class = RLE_PTYPE_CLASS_IPV4;
+		break;
+	case RLE_PROTO_TYPE_IPV6_UNCOMP:
+		ptype_class = RLE_PTYPE_CLASS_IPV6;
+		break;
+	case RLE_PROTO_TYPE_VLAN_UNCOMP:
+		ptype_class = RLE_PTYPE_CLASS_VLAN;
+		break;
+	case RLE_PROTO_TYPE_ARP_UNCOMP:
+		ptype_class = RLE_PTYPE_CLASS_ARP;
+		break;
+	default:
+		ptype_class = RLE_PTYPE_CLASS_OTHER;
+		break;
+	}
+
+	return ptype_class;
+}
+
+/**
+ * @brief Check whether a compressed protocol type may be chosen as the implicit one at runtime.
+ *
+ * @param[in]  comp_ptype  The compressed protocol type.
+ *
+ * @return     true if it is IP, IPv4, IPv6, VLAN or ARP, false otherwise.
+ */
+static inline bool rle_ptype_is_adaptive_implicit(const uint8_t comp_ptype)
+{
+	return (comp_ptype == RLE_PROTO_TYPE_IP_COMP || comp_ptype == RLE_PROTO_TYPE_IPV4_COMP ||
+	        comp_ptype == RLE_PROTO_TYPE_IPV6_COMP || comp_ptype == RLE_PROTO_TYPE_VLAN_COMP ||
+	        comp_ptype == RLE_PROTO_TYPE_ARP_COMP);
+}
+
 
 #endif /* __RLE_HEADER_PROTO_TYPE_FIELD_H__ */
@@ -28,16 +28,30 @@
 
 #include <rle.h>
 
+/* registered and read from any thread */
 static rle_trace_callback_t rle_trace_callback = NULL;
 
+/* all the levels are traced by default */
+int rle_log_level_max = RLE_LOG_LEVEL_DEBUG;
+
 void rle_set_trace_callback(rle_trace_callback_t callback)
 {
-	rle_trace_callback = callback;
+	__atomic_store_n(&rle_trace_callback, callback, __ATOMIC_RELEASE);
 }
 
 rle_trace_callback_t rle_get_trace_callback(void)
 {
-	return rle_trace_callback;
+	return __atomic_load_n(&rle_trace_callback, __ATOMIC_ACQUIRE);
+}
+
+void rle_set_log_level(const rle_log_level_t level)
+{
+	rle_log_level_max = level;
+}
+
+rle_log_level_t rle_get_log_level(void)
+{
+	return (rle_log_level_t)rle_log_level_max;
 }
 
 const rle_log_module_tuple_t * rle_get_log_modules_list(size_t *nb_modules)
@@ -60,7 +74,13 @@ const rle_log_module_tuple_t * rle_get_log_modules_list(size_t *nb_modules)
 		{ RLE_MOD_ID_CTX, "RLE_CTX" },
 		{ RLE_MOD_ID_RECEIVER, "RLE_RECEIVER" },
 		{ RLE_MOD_ID_TRANSMITTER, "RLE_TRANSMITTER" },
-		{ RLE_MOD_ID_TRAILER, "RLE_TRAILER" }
+		{ RLE_MOD_ID_TRAILER, "RLE_TRAILER" },
+		{ RLE_MOD_ID_RECEIVER_SET, "RLE_RECEIVER_SET" },
+		{ RLE_MOD_ID_DECAP_ENGINE, "RLE_DECAP_ENGINE" },
+		{ RLE_MOD_ID_SKB, "RLE_SKB" },
+		{ RLE_MOD_ID_DPDK, "RLE_DPDK" },
+		{ RLE_MOD_ID_TX_PIPE, "RLE_TX_PIPE" },
+		{ RLE_MOD_ID_SDU_POOL, "RLE_SDU_POOL" }
 	};
 
 	/* if the pointer passed as argument is not null,
@@ -32,7 +32,9 @@
 #include "rle_conf.h"
 #include "constants.h"
 #include "header.h"
+#include "rle_header_proto_type_field.h"
 #include "trailer.h"
+#include "rle_trace.h"
 
 #ifndef __KERNEL__
 
@@ -42,10 +44,6 @@
 
 #endif
 
-#ifdef TIME_DEBUG
-#include <sys/time.h>
-#endif
-
 /*------------------------------------------------------------------------------------------------*/
 /*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
@@ -70,6 +68,102 @@ static int get_receiver_context(const struct rle_receiver *const receiver,
                                 const uint8_t fragment_id,
                                 const struct rle_ctx_mngt **const ctx_man);
 
+/**
+ * @brief          Read the counters of a receiver context.
+ *
+ * @param[in]      ctx_man                  The context.
+ * @param[out]     stats                    The counters of the context.
+ */
+static void read_ctx_counters(const struct rle_ctx_mngt *const ctx_man,
+                              struct rle_receiver_stats *const stats);
+
+/**
+ * @brief          Start a snapshot of the counters of a receiver, waiting for the end of an
+ *                 ongoing update.
+ *
+ * @param[in]      receiver                 The receiver.
+ *
+ * @return         The sequence of the counters updates at the start of the snapshot.
+ */
+static uint32_t stats_snapshot_begin(const struct rle_receiver *const receiver);
+
+/**
+ * @brief          Check whether the counters were updated during a snapshot.
+ *
+ * @param[in]      receiver                 The receiver.
+ * @param[in]      seq                      The sequence at the start of the snapshot.
+ *
+ * @return         true if the snapshot is to be taken again, false if it is consistent.
+ */
+static bool stats_snapshot_retry(const struct rle_receiver *const receiver, const uint32_t seq);
+
+/**
+ * @brief          Handlers of the PPDU fragment types, see rle_receiver_deencap_data.
+ */
+static int handle_comp_ppdu(struct rle_receiver *_this, unsigned char ppdu[],
+                            const size_t ppdu_length, int *const index_ctx,
+                            struct rle_sdu *const potential_sdu, const bool zero_copy);
+static int handle_start_ppdu(struct rle_receiver *_this, unsigned char ppdu[],
+                             const size_t ppdu_length, int *const index_ctx,
+                             struct rle_sdu *const potential_sdu, const bool zero_copy);
+static int handle_cont_ppdu(struct rle_receiver *_this, unsigned char ppdu[],
+                            const size_t ppdu_length, int *const index_ctx,
+                            struct rle_sdu *const potential_sdu, const bool zero_copy);
+static int handle_end_ppdu(struct rle_receiver *_this, unsigned char ppdu[],
+                           const size_t ppdu_length, int *const index_ctx,
+                           struct rle_sdu *const potential_sdu, const bool zero_copy);
+
+/**
+ * @brief          Get the size of a part of the memory of a receiver initialized in place.
+ *
+ * @param[in]      size                     The size of the part.
+ *
+ * @return         The size rounded up to RLE_IN_PLACE_ALIGNMENT, so that all parts are aligned.
+ */
+static size_t get_in_place_size(const size_t size);
+
+/**
+ * @brief          Initialize a receiver in its memory, without reassembly contexts.
+ *
+ * @param[out]     receiver                 The receiver.
+ * @param[in]      conf                     The configuration of the receiver, valid.
+ * @param[in]      allocator                The allocator of the reassembly buffers.
+ */
+static void receiver_setup(struct rle_receiver *const receiver,
+                           const struct rle_config *const conf,
+                           const struct rle_allocator *const allocator);
+
+/**
+ * @brief          Reserve the reassembly storages of a real-time receiver and give them to its
+ *                 contexts, which then never take storages from the shared pool.
+ *
+ * @param[in,out]  receiver                 The receiver, with its reassembly contexts.
+ * @param[in,out]  mem                      The memory of the RLE_RCV_STORAGES_NR storages, NULL to
+ *                                          allocate them with the allocator of the receiver.
+ *
+ * @return         0 if OK, else 1.
+ */
+static int receiver_stash_reserve(struct rle_receiver *const receiver, unsigned char *mem);
+
+/**
+ * @brief          Release the reassembly storages reserved by a real-time receiver.
+ *
+ *                 All the storages shall be back, the contexts flushed and the delivered SDUs
+ *                 released.
+ *
+ * @param[in,out]  receiver                 The receiver.
+ */
+static void receiver_stash_release(struct rle_receiver *const receiver);
+
+/**
+ * @brief          Resolve the dispatch tables of the PPDU decoder for a configuration.
+ *
+ * @param[out]     decoder                  The decoder.
+ * @param[in]      conf                     The configuration of the receiver.
+ */
+static void decoder_init(struct rle_ppdu_decoder *const decoder,
+                         const struct rle_config *const conf);
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
@@ -96,14 +190,200 @@ error:
 	return status;
 }
 
+static void read_ctx_counters(const struct rle_ctx_mngt *const ctx_man,
+                              struct rle_receiver_stats *const stats)
+{
+	stats->sdus_received = rle_ctx_get_counter_in(ctx_man);
+	stats->sdus_reassembled = rle_ctx_get_counter_ok(ctx_man);
+	stats->sdus_dropped = rle_ctx_get_counter_dropped(ctx_man);
+	stats->sdus_lost = rle_ctx_get_counter_lost(ctx_man);
+	stats->bytes_received = rle_ctx_get_counter_bytes_in(ctx_man);
+	stats->bytes_reassembled = rle_ctx_get_counter_bytes_ok(ctx_man);
+	stats->bytes_dropped = rle_ctx_get_counter_bytes_dropped(ctx_man);
+}
+
+static uint32_t stats_snapshot_begin(const struct rle_receiver *const receiver)
+{
+	uint32_t seq;
+
+	do {
+		seq = __atomic_load_n(&receiver->stats_seq, __ATOMIC_ACQUIRE);
+	} while ((seq & 1) != 0);
+
+	return seq;
+}
+
+static bool stats_snapshot_retry(const struct rle_receiver *const receiver, const uint32_t seq)
+{
+	/* the counters are read before the sequence is checked again */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return (__atomic_load_n(&receiver->stats_seq, __ATOMIC_RELAXED) != seq);
+}
+
+static int handle_comp_ppdu(struct rle_receiver *_this, unsigned char ppdu[],
+                            const size_t ppdu_length, int *const index_ctx __attribute__((unused)),
+                            struct rle_sdu *const potential_sdu, const bool zero_copy)
+{
+	return reassembly_comp_ppdu(_this, ppdu, ppdu_length, potential_sdu, zero_copy);
+}
+
+static int handle_start_ppdu(struct rle_receiver *_this, unsigned char ppdu[],
+                             const size_t ppdu_length, int *const index_ctx,
+                             struct rle_sdu *const potential_sdu __attribute__((unused)),
+                             const bool zero_copy __attribute__((unused)))
+{
+	return reassembly_start_ppdu(_this, ppdu, ppdu_length, index_ctx);
+}
+
+static int handle_cont_ppdu(struct rle_receiver *_this, unsigned char ppdu[],
+                            const size_t ppdu_length, int *const index_ctx,
+                            struct rle_sdu *const potential_sdu __attribute__((unused)),
+                            const bool zero_copy __attribute__((unused)))
+{
+	return reassembly_cont_ppdu(_this, ppdu, ppdu_length, index_ctx);
+}
+
+static int handle_end_ppdu(struct rle_receiver *_this, unsigned char ppdu[],
+                           const size_t ppdu_length, int *const index_ctx,
+                           struct rle_sdu *const potential_sdu, const bool zero_copy)
+{
+	return reassembly_end_ppdu(_this, ppdu, ppdu_length, index_ctx, potential_sdu, zero_copy);
+}
+
+static void decoder_init(struct rle_ppdu_decoder *const decoder,
+                         const struct rle_config *const conf)
+{
+	uint8_t label_type;
+
+	decoder->handlers[rle_rcv_ppdu_type(1, 1)] = handle_comp_ppdu;
+	decoder->handlers[rle_rcv_ppdu_type(1, 0)] = handle_start_ppdu;
+	decoder->handlers[rle_rcv_ppdu_type(0, 0)] = handle_cont_ppdu;
+	decoder->handlers[rle_rcv_ppdu_type(0, 1)] = handle_end_ppdu;
+
+	for (label_type = 0; label_type <= RLE_LT_PROTO_SIGNAL; label_type++) {
+		alpdu_extract_sdu_frag_t suppressed;
+		alpdu_extract_sdu_frag_t not_suppressed;
+
+		if (label_type == RLE_LT_PROTO_SIGNAL) {
+			/* ALPDU label type 3 means that the implicit protocol type is L2S */
+			suppressed = signal_alpdu_extract_sdu_frag;
+		} else {
+			/* ALPDU label type 0, 1 or 2 mean that the implicit protocol type is given by
+			 * the configuration */
+			suppressed = suppr_alpdu_extract_sdu_frag;
+		}
+		if (conf->use_compressed_ptype) {
+			not_suppressed = comp_alpdu_extract_sdu_frag;
+		} else {
+			not_suppressed = uncomp_alpdu_extract_sdu_frag;
+		}
+
+		decoder->extractors[rle_rcv_alpdu_format(label_type, RLE_T_PROTO_TYPE_SUPP)] =
+			suppressed;
+		decoder->extractors[rle_rcv_alpdu_format(label_type, RLE_T_PROTO_TYPE_NO_SUPP)] =
+			not_suppressed;
+	}
+}
+
+
+static size_t get_in_place_size(const size_t size)
+{
+	return (size + RLE_IN_PLACE_ALIGNMENT - 1) & ~((size_t)RLE_IN_PLACE_ALIGNMENT - 1);
+}
+
+static void receiver_setup(struct rle_receiver *const receiver,
+                           const struct rle_config *const conf,
+                           const struct rle_allocator *const allocator)
+{
+	receiver->allocator = *allocator;
+
+	memcpy(&receiver->conf, conf, sizeof(struct rle_config));
+	decoder_init(&receiver->decoder, &receiver->conf);
+
+	memset(receiver->is_ctx_seqnum_init, 0, sizeof(receiver->is_ctx_seqnum_init));
+	receiver->free_ctx = 0;
+	receiver->padding_check = RLE_PADDING_CHECK_STRICT;
+	receiver->padding_sample = 0;
+	receiver->fpdu_validation = false;
+	receiver->padding_errors = 0;
+	memset(receiver->errors, 0, sizeof(receiver->errors));
+	receiver->stats_seq = 0;
+	receiver->delivered_nr = 0;
+	receiver->stash.free_list = NULL;
+	receiver->stash.free_nr = 0;
+	receiver->ctx_timeout = 0;
+	receiver->now = 0;
+	memset(receiver->ctx_deadline, 0, sizeof(receiver->ctx_deadline));
+	memset(receiver->ctx_wheel, 0, sizeof(receiver->ctx_wheel));
+	receiver->log_sink = NULL;
+	receiver->sdu_pool = NULL;
+	memset(&receiver->stream, 0, sizeof(receiver->stream));
+	receiver->stream_ctx = 0;
+	memset(receiver->streams, 0, sizeof(receiver->streams));
+#ifdef RLE_TIMING
+	rle_timing_reset(&receiver->timing);
+#endif
+#ifdef RLE_COPY_STATS
+	rle_copy_reset(&receiver->copy_stats);
+#endif
+#ifdef RLE_SIZE_STATS
+	rle_size_reset(&receiver->comp_size_stats);
+#endif
+}
+
+static int receiver_stash_reserve(struct rle_receiver *const receiver, unsigned char *mem)
+{
+	size_t i;
+
+	for (i = 0; i < RLE_RCV_STORAGES_NR; i++) {
+		unsigned char *storage = mem;
+
+		if (mem == NULL) {
+			storage = (unsigned char *)rle_alloc(&receiver->allocator, RLE_R_BUFF_LEN);
+			if (storage == NULL) {
+				RLE_ERR("failed to reserve the reassembly buffer storages");
+				receiver_stash_release(receiver);
+				return 1;
+			}
+		} else {
+			mem += get_in_place_size(RLE_R_BUFF_LEN);
+		}
+		rasm_stash_put(&receiver->stash, storage);
+	}
+
+	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
+		((rle_rasm_buf_t *)receiver->rle_ctx_man[i].buff)->stash = &receiver->stash;
+	}
+
+	return 0;
+}
+
+static void receiver_stash_release(struct rle_receiver *const receiver)
+{
+	unsigned char *storage;
+
+	while ((storage = rasm_stash_get(&receiver->stash)) != NULL) {
+		if (!receiver->in_place) {
+			rle_free(&receiver->allocator, storage);
+		}
+	}
+}
 
 /*------------------------------------------------------------------------------------------------*/
 /*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
 
 struct rle_receiver * rle_receiver_new(const struct rle_config *const conf)
+{
+	return rle_receiver_new_with_allocator(conf, NULL);
+}
+
+struct rle_receiver * rle_receiver_new_with_allocator(const struct rle_config *const conf,
+                                                      const struct rle_allocator *const allocator)
 {
 	struct rle_receiver *receiver = NULL;
+	struct rle_allocator rx_allocator;
 	size_t i;
 
 	if (!rle_config_check(conf)) {
@@ -111,27 +391,42 @@ struct rle_receiver * rle_receiver_new(const struct rle_config *const conf)
 		goto error;
 	}
 
-	receiver = (struct rle_receiver *)MALLOC(sizeof(struct rle_receiver));
+	if (allocator == NULL) {
+		rle_get_allocator(&rx_allocator);
+	} else if (allocator->alloc == NULL || allocator->free == NULL) {
+		RLE_ERR("failed to created RLE receiver: invalid allocator");
+		goto error;
+	} else {
+		rx_allocator = *allocator;
+	}
+
+	receiver = (struct rle_receiver *)rle_alloc(&rx_allocator, sizeof(struct rle_receiver));
 	if (!receiver) {
 		RLE_ERR("allocating receiver module failed");
 		goto error;
 	}
-
-	memcpy(&receiver->conf, conf, sizeof(struct rle_config));
+	receiver_setup(receiver, conf, &rx_allocator);
+	receiver->in_place = false;
 
 	memset(receiver->rle_ctx_man, 0, RLE_MAX_FRAG_NUMBER * sizeof(struct rle_ctx_mngt));
 	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
 		struct rle_ctx_mngt *const ctx_man = &receiver->rle_ctx_man[i];
-		if (rle_ctx_init_rasm_buf(ctx_man) != C_OK) {
+
+		ctx_man->lk_status = &receiver->ctx_status[i];
+		if (rle_ctx_init_rasm_buf(ctx_man, &receiver->allocator) != C_OK) {
 			RLE_ERR("failed to allocate memory for reassembly context with ID %zu", i);
 			goto free_ctxts;
 		}
 		ctx_man->frag_id = i;
 		rle_ctx_set_seq_nb(ctx_man, 0);
-		receiver->is_ctx_seqnum_init[i] = false;
 	}
 
-	receiver->free_ctx = 0;
+	if (receiver->conf.realtime && receiver_stash_reserve(receiver, NULL) != 0) {
+		goto free_ctxts;
+	}
+
+	/* reassembly storages are taken from the pool shared by receivers on START PPDUs */
+	rasm_buf_pool_get();
 
 	return receiver;
 
@@ -142,12 +437,125 @@ free_ctxts:
 			rle_ctx_destroy_rasm_buf(ctx_man);
 		}
 	}
-	FREE(receiver);
+	rle_free(&rx_allocator, receiver);
 error:
 	return NULL;
 }
 
-void rle_receiver_destroy(struct rle_receiver **const receiver)
+size_t rle_receiver_size(const struct rle_config *const conf)
+{
+	if (!rle_config_check(conf)) {
+		return 0;
+	}
+
+	return get_in_place_size(sizeof(struct rle_receiver)) +
+	       RLE_MAX_FRAG_NUMBER * get_in_place_size(sizeof(rle_rasm_buf_t)) +
+	       (conf->realtime ? RLE_RCV_STORAGES_NR * get_in_place_size(RLE_R_BUFF_LEN) : 0);
+}
+
+int rle_receiver_memory_footprint(const struct rle_receiver *const receiver,
+                                  struct rle_memory_footprint *const footprint)
+{
+	/* as many storages as contexts may be in use while others are handed over to the caller */
+	const size_t storages_max_nr = RLE_MAX_FRAG_NUMBER + RLE_RCV_DELIVERED_MAX;
+	size_t storages_nr;
+	int status = 1;
+	size_t i;
+
+	if (receiver == NULL || footprint == NULL) {
+		goto error;
+	}
+
+	memset(footprint, 0, sizeof(struct rle_memory_footprint));
+	if (!receiver->in_place) {
+		/* the receiver and its reassembly buffers belong to the caller otherwise */
+		footprint->bytes = sizeof(struct rle_receiver) +
+		                   RLE_MAX_FRAG_NUMBER * sizeof(rle_rasm_buf_t);
+		footprint->allocations = 1 + RLE_MAX_FRAG_NUMBER;
+	}
+
+	if (receiver->conf.realtime) {
+		/* all the storages are reserved, in use or not */
+		footprint->max_bytes = footprint->bytes + RLE_RCV_STORAGES_NR * RLE_R_BUFF_LEN;
+		footprint->bytes = footprint->max_bytes;
+		if (!receiver->in_place) {
+			footprint->allocations += RLE_RCV_STORAGES_NR;
+		}
+		goto out;
+	}
+
+	storages_nr = receiver->delivered_nr;
+	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
+		const rle_rasm_buf_t *const rasm_buf =
+			(const rle_rasm_buf_t *)receiver->rle_ctx_man[i].buff;
+
+		if (rasm_buf->buffer != NULL) {
+			storages_nr++;
+		}
+	}
+	footprint->max_bytes = footprint->bytes + storages_max_nr * RLE_R_BUFF_LEN;
+	footprint->bytes += storages_nr * RLE_R_BUFF_LEN;
+	footprint->allocations += storages_nr;
+
+out:
+	status = 0;
+
+error:
+	return status;
+}
+
+struct rle_receiver * rle_receiver_init_in_place(void *const mem, const size_t mem_size,
+                                                 const struct rle_config *const conf)
+{
+	struct rle_receiver *const receiver = (struct rle_receiver *)mem;
+	struct rle_allocator rx_allocator;
+	unsigned char *rasm_bufs_mem;
+	size_t i;
+
+	if (mem == NULL || ((uintptr_t)mem % RLE_IN_PLACE_ALIGNMENT) != 0) {
+		RLE_ERR("failed to created RLE receiver: memory not aligned on %u bytes",
+		        RLE_IN_PLACE_ALIGNMENT);
+		goto error;
+	}
+
+	if (rle_receiver_size(conf) == 0 || mem_size < rle_receiver_size(conf)) {
+		RLE_ERR("failed to created RLE receiver: invalid configuration or %zu-byte memory too "
+		        "small", mem_size);
+		goto error;
+	}
+
+	/* only the reassembly storages are allocated afterwards */
+	rle_get_allocator(&rx_allocator);
+	receiver_setup(receiver, conf, &rx_allocator);
+	receiver->in_place = true;
+
+	rasm_bufs_mem = (unsigned char *)mem + get_in_place_size(sizeof(struct rle_receiver));
+	memset(receiver->rle_ctx_man, 0, RLE_MAX_FRAG_NUMBER * sizeof(struct rle_ctx_mngt));
+	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
+		struct rle_ctx_mngt *const ctx_man = &receiver->rle_ctx_man[i];
+
+		ctx_man->lk_status = &receiver->ctx_status[i];
+		rle_ctx_init_rasm_buf_in_place(ctx_man, (void *)rasm_bufs_mem, &receiver->allocator);
+		ctx_man->frag_id = i;
+		rle_ctx_set_seq_nb(ctx_man, 0);
+		rasm_bufs_mem += get_in_place_size(sizeof(rle_rasm_buf_t));
+	}
+
+	/* the reserved storages follow the reassembly buffers */
+	if (receiver->conf.realtime) {
+		(void)receiver_stash_reserve(receiver, rasm_bufs_mem);
+	}
+
+	/* reassembly storages are taken from the pool shared by receivers on START PPDUs */
+	rasm_buf_pool_get();
+
+	return receiver;
+
+error:
+	return NULL;
+}
+
+void rle_receiver_fini(struct rle_receiver *const receiver)
 {
 	size_t i;
 
@@ -156,17 +564,52 @@ void rle_receiver_destroy(struct rle_receiver **const receiver)
 		goto out;
 	}
 
-	if (!*receiver) {
+	for (i = 0; i < RLE_MAX_FRAG_NUMBER; ++i) {
+		struct rle_ctx_mngt *const ctx_man = &receiver->rle_ctx_man[i];
+
+		/* the SDUs streamed will never end */
+		rle_receiver_stream_end(receiver, i, RLE_STREAM_LOST);
+		if (receiver->in_place) {
+			rle_ctx_fini_rasm_buf(ctx_man);
+		} else {
+			rle_ctx_destroy_rasm_buf(ctx_man);
+		}
+	}
+	rle_receiver_release_delivered(receiver);
+	receiver_stash_release(receiver);
+	rasm_buf_pool_put();
+	if (receiver->sdu_pool != NULL) {
+		/* the buffers still held keep the pool */
+		rle_sdu_pool_put(receiver->sdu_pool);
+		receiver->sdu_pool = NULL;
+	}
+
+out:
+
+	return;
+}
+
+void rle_receiver_destroy(struct rle_receiver **const receiver)
+{
+	struct rle_allocator allocator;
+
+	if (!receiver) {
 		/* Nothing to do. */
 		goto out;
 	}
 
-	for (i = 0; i < RLE_MAX_FRAG_NUMBER; ++i) {
-		struct rle_ctx_mngt *const ctx_man = &(*receiver)->rle_ctx_man[i];
-		rle_ctx_destroy_rasm_buf(ctx_man);
+	if (!*receiver) {
+		/* Nothing to do. */
+		goto out;
 	}
 
-	FREE(*receiver);
+	rle_receiver_fini(*receiver);
+
+	/* the allocator is read before it is released with the receiver */
+	allocator = (*receiver)->allocator;
+	if (!(*receiver)->in_place) {
+		rle_free(&allocator, *receiver);
+	}
 	*receiver = NULL;
 
 out:
@@ -178,18 +621,14 @@ int rle_receiver_deencap_data(struct rle_receiver *_this,
                               unsigned char ppdu[],
                               const size_t ppdu_length,
                               int *const index_ctx,
-                              struct rle_sdu *const potential_sdu)
+                              struct rle_sdu *const potential_sdu,
+                              const bool zero_copy)
 {
 	const size_t ppdu_base_hdr_len = 2;
+	const rle_ppdu_hdr_t *header;
+	rle_ppdu_handler_t handler;
+	size_t ppdu_type;
 	int ret = C_ERROR;
-	int frag_type = 0;
-
-#ifdef TIME_DEBUG
-	struct timeval tv_start = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_end = { .tv_sec = 0L, .tv_usec = 0L };
-	struct timeval tv_delta;
-	gettimeofday(&tv_start, NULL);
-#endif
 
 	assert(index_ctx != NULL);
 
@@ -201,41 +640,61 @@ int rle_receiver_deencap_data(struct rle_receiver *_this,
 	/* retrieve frag id if its a fragmented packet to append data to the * right frag id context
 	 * (SE bits)
 	 */
-	frag_type = rle_ppdu_get_fragment_type((const rle_ppdu_hdr_t *)ppdu);
-
-	switch (frag_type) {
-	case RLE_PDU_COMPLETE:
-		ret = reassembly_comp_ppdu(_this, ppdu, ppdu_length, potential_sdu);
-		break;
-	case RLE_PDU_START_FRAG:
-		ret = reassembly_start_ppdu(_this, ppdu, ppdu_length, index_ctx);
-		break;
-	case RLE_PDU_CONT_FRAG:
-		ret = reassembly_cont_ppdu(_this, ppdu, ppdu_length, index_ctx);
-		break;
-	case RLE_PDU_END_FRAG:
-		ret = reassembly_end_ppdu(_this, ppdu, ppdu_length, index_ctx, potential_sdu);
-		break;
-	default:
-		RLE_ERR("Unhandled fragment type '%i'.", frag_type);
-		assert(0);
-		break;
-	}
-
-#ifdef TIME_DEBUG
-	gettimeofday(&tv_end, NULL);
-	tv_delta.tv_sec = tv_end.tv_sec - tv_start.tv_sec;
-	tv_delta.tv_usec = tv_end.tv_usec - tv_start.tv_usec;
-	RLE_DEBUG("duration [%04ld.%06ld].", tv_delta.tv_sec, tv_delta.tv_usec);
-#endif
+	header = (const rle_ppdu_hdr_t *)ppdu;
+	ppdu_type = rle_rcv_ppdu_type(header->common.start_ind, header->common.end_ind);
+	handler = _this->decoder.handlers[ppdu_type];
+	rle_timing_run(&_this->timing, RLE_TIMING_RASM_CONT + ppdu_type,
+	               ret = handler(_this, ppdu, ppdu_length, index_ctx, potential_sdu, zero_copy));
 
 	return ret;
 }
 
 void rle_receiver_free_context(struct rle_receiver *_this, uint8_t fragment_id)
 {
-	/* set to idle this fragmentation context */
+	/* set to idle this fragmentation context, its reassembly storage goes back to the pool */
+	rle_trace(ctx_freed, fragment_id);
 	set_free_frag_ctx(_this, fragment_id);
+	rasm_buf_release_storage((rle_rasm_buf_t *)_this->rle_ctx_man[fragment_id].buff);
+
+	/* a SDU streamed without verdict yet is given up with its context */
+	rle_receiver_stream_end(_this, fragment_id, RLE_STREAM_LOST);
+}
+
+void rle_receiver_stream_end(struct rle_receiver *_this, uint8_t fragment_id,
+                             enum rle_stream_verdict verdict)
+{
+	if (!is_context_streaming(_this, fragment_id)) {
+		return;
+	}
+
+	/* cleared first, the verdict of a SDU is given once */
+	_this->stream_ctx &= ~(1 << fragment_id);
+	_this->stream.end(_this->stream.arg, fragment_id, verdict);
+}
+
+bool rle_receiver_deliver_context(struct rle_receiver *_this, uint8_t fragment_id)
+{
+	if (_this->delivered_nr == RLE_RCV_DELIVERED_MAX) {
+		return false;
+	}
+
+	_this->delivered[_this->delivered_nr++] =
+		rasm_buf_detach_storage((rle_rasm_buf_t *)_this->rle_ctx_man[fragment_id].buff);
+
+	return true;
+}
+
+void rle_receiver_release_delivered(struct rle_receiver *_this)
+{
+	while (_this->delivered_nr > 0) {
+		unsigned char *const storage = _this->delivered[--_this->delivered_nr];
+
+		if (_this->conf.realtime) {
+			rasm_stash_put(&_this->stash, storage);
+		} else {
+			rasm_buf_storage_put(storage, &_this->allocator);
+		}
+	}
 }
 
 size_t rle_receiver_stats_get_queue_size(const struct rle_receiver *const receiver,
@@ -248,7 +707,12 @@ size_t rle_receiver_stats_get_queue_size(const struct rle_receiver *const receiv
 		goto out;
 	}
 
-	stat = rasm_buf_get_reassembled_sdu_len((rle_rasm_buf_t *)ctx_man->buff);
+	if (is_context_streaming(receiver, fragment_id)) {
+		/* the bytes streamed are not held in the receiver, they are counted anyway */
+		stat = receiver->streams[fragment_id].received;
+	} else {
+		stat = rasm_buf_get_reassembled_sdu_len((rle_rasm_buf_t *)ctx_man->buff);
+	}
 
 out:
 
@@ -380,6 +844,7 @@ int rle_receiver_stats_get_counters(const struct rle_receiver *const receiver,
 {
 	int status = 1;
 	const struct rle_ctx_mngt *ctx_man = NULL;
+	uint32_t seq;
 
 	if (get_receiver_context(receiver, fragment_id, &ctx_man)) {
 		goto error;
@@ -389,13 +854,50 @@ int rle_receiver_stats_get_counters(const struct rle_receiver *const receiver,
 		goto error;
 	}
 
-	stats->sdus_received = rle_ctx_get_counter_in(ctx_man);
-	stats->sdus_reassembled = rle_ctx_get_counter_ok(ctx_man);
-	stats->sdus_dropped = rle_ctx_get_counter_dropped(ctx_man);
-	stats->sdus_lost = rle_ctx_get_counter_lost(ctx_man);
-	stats->bytes_received = rle_ctx_get_counter_bytes_in(ctx_man);
-	stats->bytes_reassembled = rle_ctx_get_counter_bytes_ok(ctx_man);
-	stats->bytes_dropped = rle_ctx_get_counter_bytes_dropped(ctx_man);
+	do {
+		seq = stats_snapshot_begin(receiver);
+		read_ctx_counters(ctx_man, stats);
+	} while (stats_snapshot_retry(receiver, seq));
+
+	status = 0;
+
+error:
+	return status;
+}
+
+int rle_receiver_stats_get_all_counters(const struct rle_receiver *const receiver,
+                                        struct rle_receiver_stats stats[RLE_MAX_FRAG_NUMBER],
+                                        struct rle_receiver_stats *const total)
+{
+	struct rle_receiver_stats ctx_stats[RLE_MAX_FRAG_NUMBER];
+	struct rle_receiver_stats *const dump = (stats != NULL ? stats : ctx_stats);
+	int status = 1;
+	uint32_t seq;
+	size_t i;
+
+	if (receiver == NULL || (stats == NULL && total == NULL)) {
+		goto error;
+	}
+
+	do {
+		seq = stats_snapshot_begin(receiver);
+		for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
+			read_ctx_counters(&receiver->rle_ctx_man[i], &dump[i]);
+		}
+	} while (stats_snapshot_retry(receiver, seq));
+
+	if (total != NULL) {
+		memset(total, 0, sizeof(struct rle_receiver_stats));
+		for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
+			total->sdus_received += dump[i].sdus_received;
+			total->sdus_reassembled += dump[i].sdus_reassembled;
+			total->sdus_dropped += dump[i].sdus_dropped;
+			total->sdus_lost += dump[i].sdus_lost;
+			total->bytes_received += dump[i].bytes_received;
+			total->bytes_reassembled += dump[i].bytes_reassembled;
+			total->bytes_dropped += dump[i].bytes_dropped;
+		}
+	}
 
 	status = 0;
 
@@ -408,13 +910,366 @@ void rle_receiver_stats_reset_counters(struct rle_receiver *const receiver,
 {
 	struct rle_ctx_mngt *ctx_man = NULL;
 
+#ifdef RLE_SIZE_STATS
+	if (receiver != NULL && fragment_id == RLE_SIZE_STATS_COMP_ID) {
+		rle_size_reset(&receiver->comp_size_stats);
+		goto error;
+	}
+#endif
+
 	if (get_receiver_context(receiver, fragment_id,
 	                         (const struct rle_ctx_mngt **)&ctx_man)) {
 		goto error;
 	}
 
+	stats_update_begin(receiver);
 	rle_ctx_reset_counters(ctx_man);
+	stats_update_end(receiver);
 
 error:
 	return;
 }
+
+int rle_receiver_stats_fetch_and_reset(struct rle_receiver *const receiver,
+                                       struct rle_receiver_stats stats[RLE_MAX_FRAG_NUMBER],
+                                       struct rle_receiver_stats *const total)
+{
+	struct link_counters counters[RLE_MAX_FRAG_NUMBER];
+	int status = 1;
+	uint32_t seq;
+	size_t i;
+
+	if (receiver == NULL || (stats == NULL && total == NULL)) {
+		goto error;
+	}
+
+	do {
+		seq = stats_snapshot_begin(receiver);
+		for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
+			rle_ctx_load_counters(&receiver->rle_ctx_man[i], &counters[i]);
+		}
+	} while (stats_snapshot_retry(receiver, seq));
+
+	if (total != NULL) {
+		memset(total, 0, sizeof(struct rle_receiver_stats));
+	}
+	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
+		/* the next dump starts from the consistent snapshot */
+		rle_ctx_rebase_counters(&receiver->rle_ctx_man[i], &counters[i]);
+
+		if (stats != NULL) {
+			stats[i].sdus_received = counters[i].counter_in;
+			stats[i].sdus_reassembled = counters[i].counter_ok;
+			stats[i].sdus_dropped = counters[i].counter_dropped;
+			stats[i].sdus_lost = counters[i].counter_lost;
+			stats[i].bytes_received = counters[i].counter_bytes_in;
+			stats[i].bytes_reassembled = counters[i].counter_bytes_ok;
+			stats[i].bytes_dropped = counters[i].counter_bytes_dropped;
+		}
+		if (total != NULL) {
+			total->sdus_received += counters[i].counter_in;
+			total->sdus_reassembled += counters[i].counter_ok;
+			total->sdus_dropped += counters[i].counter_dropped;
+			total->sdus_lost += counters[i].counter_lost;
+			total->bytes_received += counters[i].counter_bytes_in;
+			total->bytes_reassembled += counters[i].counter_bytes_ok;
+			total->bytes_dropped += counters[i].counter_bytes_dropped;
+		}
+	}
+
+	status = 0;
+
+error:
+	return status;
+}
+
+void rle_receiver_set_padding_check(struct rle_receiver *const receiver,
+                                    const enum rle_padding_check padding_check)
+{
+	if (receiver != NULL) {
+		receiver->padding_check = padding_check;
+	}
+}
+
+void rle_receiver_set_fpdu_validation(struct rle_receiver *const receiver, const int enabled)
+{
+	if (receiver != NULL) {
+		receiver->fpdu_validation = (enabled != 0);
+	}
+}
+
+uint64_t rle_receiver_stats_get_counter_padding_errors(const struct rle_receiver *const receiver)
+{
+	return (receiver == NULL ? 0 : rle_ctx_counter_read(receiver->padding_errors));
+}
+
+uint64_t rle_receiver_stats_get_counter_errors(const struct rle_receiver *const receiver,
+                                               const enum rle_rcv_error reason)
+{
+	if (receiver == NULL || (size_t)reason >= RLE_RCV_ERR_REASONS_NR) {
+		return 0;
+	}
+
+	return rle_ctx_counter_read(receiver->errors[reason]);
+}
+
+void rle_receiver_stats_reset_errors(struct rle_receiver *const receiver)
+{
+	size_t reason;
+
+	if (receiver == NULL) {
+		goto error;
+	}
+
+	stats_update_begin(receiver);
+	for (reason = 0; reason < RLE_RCV_ERR_REASONS_NR; reason++) {
+		rle_ctx_counter_write(receiver->errors[reason], 0);
+	}
+	stats_update_end(receiver);
+
+error:
+	return;
+}
+
+int rle_receiver_timing_get(const struct rle_receiver *const receiver,
+                            const enum rle_timing_stage stage,
+                            struct rle_timing_histogram *const histogram)
+{
+	int status = 1;
+
+	if (receiver == NULL || histogram == NULL || stage < RLE_TIMING_RASM_CONT ||
+	    stage >= RLE_TIMING_STAGES_NR) {
+		goto error;
+	}
+
+#ifdef RLE_TIMING
+	rle_timing_read(&receiver->timing.stages[stage], histogram);
+	status = 0;
+#endif
+
+error:
+	return status;
+}
+
+void rle_receiver_timing_reset(struct rle_receiver *const receiver)
+{
+#ifdef RLE_TIMING
+	if (receiver != NULL) {
+		rle_timing_reset(&receiver->timing);
+	}
+#else
+	(void)receiver;
+#endif
+}
+
+int rle_receiver_copy_stats_get(const struct rle_receiver *const receiver,
+                                const enum rle_copy_stage stage,
+                                struct rle_copy_counters *const counters)
+{
+	int status = 1;
+
+	if (receiver == NULL || counters == NULL || stage < RLE_COPY_RASM_FRAG ||
+	    stage >= RLE_COPY_STAGES_NR) {
+		goto error;
+	}
+
+#ifdef RLE_COPY_STATS
+	rle_copy_read(&receiver->copy_stats.stages[stage], counters);
+	status = 0;
+#endif
+
+error:
+	return status;
+}
+
+void rle_receiver_copy_stats_reset(struct rle_receiver *const receiver)
+{
+#ifdef RLE_COPY_STATS
+	if (receiver != NULL) {
+		rle_copy_reset(&receiver->copy_stats);
+	}
+#else
+	(void)receiver;
+#endif
+}
+
+int rle_receiver_stats_get_size_histogram(const struct rle_receiver *const receiver,
+                                          const uint8_t fragment_id,
+                                          struct rle_size_histogram *const histogram)
+{
+	int status = 1;
+#ifdef RLE_SIZE_STATS
+	const struct rle_ctx_mngt *ctx_man = NULL;
+#endif
+
+	if (receiver == NULL || histogram == NULL) {
+		goto error;
+	}
+
+#ifdef RLE_SIZE_STATS
+	if (fragment_id == RLE_SIZE_STATS_COMP_ID) {
+		rle_size_read(&receiver->comp_size_stats.histogram, histogram);
+		status = 0;
+		goto error;
+	}
+	if (get_receiver_context(receiver, fragment_id, &ctx_man)) {
+		goto error;
+	}
+	rle_size_read(&ctx_man->lk_status->size_stats.histogram, histogram);
+	status = 0;
+#else
+	(void)fragment_id;
+#endif
+
+error:
+	return status;
+}
+
+void rle_receiver_set_ctx_timeout(struct rle_receiver *const receiver, const uint64_t timeout)
+{
+	if (receiver != NULL) {
+		receiver->ctx_timeout = timeout;
+	}
+}
+
+int rle_receiver_set_log_sink(struct rle_receiver *const receiver,
+                              const struct rle_log_sink *const sink)
+{
+	if (receiver == NULL || (sink != NULL && sink->callback == NULL)) {
+		return 1;
+	}
+
+	/* the sink is complete before the receiver, on any thread, loads it */
+	__atomic_store_n(&receiver->log_sink, sink, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+int rle_receiver_set_sdu_pool(struct rle_receiver *const receiver,
+                              const size_t buffers_nr[RLE_SDU_POOL_CLASSES_NR])
+{
+	struct rle_sdu_pool *sdu_pool = NULL;
+
+	if (receiver == NULL) {
+		return 1;
+	}
+
+	if (buffers_nr != NULL) {
+		sdu_pool = rle_sdu_pool_new(buffers_nr, &receiver->allocator);
+		if (sdu_pool == NULL) {
+			RLE_ERR_TO(&receiver->log_sink, "SDU pool not created");
+			return 1;
+		}
+	}
+
+	if (receiver->sdu_pool != NULL) {
+		rle_sdu_pool_put(receiver->sdu_pool);
+	}
+	receiver->sdu_pool = sdu_pool;
+
+	return 0;
+}
+
+int rle_receiver_set_stream(struct rle_receiver *const receiver,
+                            const struct rle_stream_callbacks *const callbacks)
+{
+	if (receiver == NULL ||
+	    (callbacks != NULL && (callbacks->data == NULL || callbacks->end == NULL))) {
+		return 1;
+	}
+
+	/* the SDUs in progress are reassembled, or streamed, to their end */
+	if (receiver->free_ctx != 0) {
+		RLE_ERR_TO(&receiver->log_sink, "SDUs are being reassembled, streaming not changed");
+		return 1;
+	}
+
+	if (callbacks != NULL) {
+		receiver->stream = *callbacks;
+	} else {
+		memset(&receiver->stream, 0, sizeof(receiver->stream));
+	}
+
+	return 0;
+}
+
+int rle_receiver_set_implicit_ptype(struct rle_receiver *const receiver,
+                                    const uint8_t implicit_protocol_type)
+{
+	int status = 1;
+
+	if (receiver == NULL) {
+		goto error;
+	}
+	if (receiver->conf.allow_ptype_omission == 0) {
+		RLE_ERR_TO(&receiver->log_sink,
+		           "implicit protocol type not changed since its omission is not allowed");
+		goto error;
+	}
+	if (!rle_ptype_is_adaptive_implicit(implicit_protocol_type)) {
+		RLE_ERR_TO(&receiver->log_sink,
+		           "invalid implicit protocol type 0x%02x", implicit_protocol_type);
+		goto error;
+	}
+
+	/* read by suppr_alpdu_extract_sdu_frag() with a relaxed atomic load */
+	__atomic_store_n(&receiver->conf.implicit_protocol_type, implicit_protocol_type,
+	                 __ATOMIC_RELAXED);
+	RLE_DEBUG_TO(&receiver->log_sink,
+	             "implicit protocol type 0x%02x from now on", implicit_protocol_type);
+
+	status = 0;
+
+error:
+	return status;
+}
+
+size_t rle_receiver_tick(struct rle_receiver *const receiver, const uint64_t now)
+{
+	size_t expired_nr = 0;
+	uint64_t slots_nr;
+	uint64_t time;
+
+	if (receiver == NULL || now <= receiver->now) {
+		goto out;
+	}
+
+	stats_update_begin(receiver);
+
+	/* visit the slots of the elapsed times, each slot once at most */
+	slots_nr = now - receiver->now;
+	if (slots_nr > RLE_RCV_CTX_WHEEL_SLOTS) {
+		slots_nr = RLE_RCV_CTX_WHEEL_SLOTS;
+	}
+
+	for (time = receiver->now + 1; slots_nr > 0; time++, slots_nr--) {
+		const size_t slot = time & (RLE_RCV_CTX_WHEEL_SLOTS - 1);
+		uint8_t armed = receiver->ctx_wheel[slot];
+
+		while (armed != 0) {
+			const uint8_t frag_id = __builtin_ctz(armed);
+			struct rle_ctx_mngt *const rle_ctx = &receiver->rle_ctx_man[frag_id];
+
+			armed &= armed - 1;
+
+			/* contexts hashed in the slot may expire at a later turn of the wheel */
+			if (receiver->ctx_deadline[frag_id] > now) {
+				continue;
+			}
+
+			RLE_DEBUG_TO(&receiver->log_sink,
+			             "reassembly context with ID %u expired", frag_id);
+			rle_ctx_incr_counter_dropped(rle_ctx);
+			rle_ctx_incr_counter_lost(rle_ctx, 1);
+			rle_ctx_incr_counter_bytes_dropped(rle_ctx, rle_ctx->lk_status->current_counter);
+			rle_receiver_free_context(receiver, frag_id);
+			expired_nr++;
+		}
+	}
+
+	stats_update_end(receiver);
+	receiver->now = now;
+
+out:
+	return expired_nr;
+}
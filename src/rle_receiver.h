@@ -41,12 +41,84 @@
 
 #include "rle_ctx.h"
 #include "header.h"
+#include "rle_timing.h"
+#include "rle_copy_stats.h"
+#include "rle_sdu_pool.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC CONSTANTS AND MACROS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** Number of slots of the reassembly timer wheel, a power of 2 */
+#define RLE_RCV_CTX_WHEEL_SLOTS  64
+
+/** Number of PPDU fragment types, indexed by the start and end indicators */
+#define RLE_RCV_PPDU_TYPES  4
+
+/** Number of ALPDU header formats, indexed by the label type and the proto type suppressed bit */
+#define RLE_RCV_ALPDU_FORMATS  8
+
+/** Max number of reassembly storages handed over to the caller by one decapsulation */
+#define RLE_RCV_DELIVERED_MAX  RLE_MAX_FRAG_NUMBER
+
+/** Reassembly storages reserved by a real-time receiver, for its contexts and delivered SDUs */
+#define RLE_RCV_STORAGES_NR  (RLE_MAX_FRAG_NUMBER + RLE_RCV_DELIVERED_MAX)
+
+/** Index of the PPDU fragment type in the decoder table */
+#define rle_rcv_ppdu_type(start_ind, end_ind)  ((size_t)(((start_ind) << 1) | (end_ind)))
+
+/** Index of the ALPDU header format in the decoder table */
+#define rle_rcv_alpdu_format(label_type, proto_type_supp) \
+	((size_t)(((label_type) << 1) | (proto_type_supp)))
+
+/** Count a rejection by the receiver, single writer as the other receiver counters */
+#define rle_rcv_count_error(receiver, reason) \
+	rle_ctx_counter_add((receiver)->errors[(reason)], 1)
 
 
 /*------------------------------------------------------------------------------------------------*/
 /*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
 
+struct rle_receiver;
+
+/**
+ * @brief Handler of a PPDU fragment type, see rle_receiver_deencap_data for the parameters.
+ *
+ * @ingroup RLE receiver
+ */
+typedef int (*rle_ppdu_handler_t)(struct rle_receiver *_this,
+                                  unsigned char ppdu[],
+                                  const size_t ppdu_length,
+                                  int *const index_ctx,
+                                  struct rle_sdu *const potential_sdu,
+                                  const bool zero_copy);
+
+/**
+ * @brief Dispatch tables of the PPDU decoder, resolved once from the receiver configuration.
+ *
+ * @ingroup RLE receiver
+ */
+struct rle_ppdu_decoder {
+	/** Handlers of the PPDU, by fragment type */
+	rle_ppdu_handler_t handlers[RLE_RCV_PPDU_TYPES];
+	/** Extractors of the SDU fragment, by ALPDU header format */
+	alpdu_extract_sdu_frag_t extractors[RLE_RCV_ALPDU_FORMATS];
+};
+
+/**
+ * @brief SDU streamed by a reassembly context, see rle_receiver_set_stream().
+ *
+ * @ingroup RLE receiver
+ */
+struct rle_rcv_stream {
+	size_t sdu_len;          /**< The size of the SDU.                         */
+	size_t received;         /**< The SDU bytes given to the data callback.    */
+	uint32_t crc;            /**< The CRC of the bytes received, if used.      */
+	uint16_t protocol_type;  /**< The protocol type of the SDU.                */
+};
+
 /**
  * @brief RLE receiver module used for reassembly & deencapsulation.
  *        Provides a context structure for each fragment_id.
@@ -59,7 +131,57 @@ struct rle_receiver {
 	/** Whether seqnum is known yet */
 	bool is_ctx_seqnum_init[RLE_MAX_FRAG_NUMBER];
 	struct rle_config conf;  /**< RLE configuration */
+	struct rle_ppdu_decoder decoder; /**< PPDU decoder for the configuration */
 	uint8_t free_ctx;        /**< List of free contexts */
+	enum rle_padding_check padding_check; /**< Verification of the FPDU padding  */
+	uint32_t padding_sample;              /**< FPDUs handled, for sampled checks */
+	bool fpdu_validation;                 /**< Whether FPDUs are validated first */
+	uint64_t padding_errors;              /**< FPDUs with non-zero padding       */
+	uint64_t errors[RLE_RCV_ERR_REASONS_NR]; /**< Rejections, per reason      */
+	/** Reassembly timeout in caller time units, 0 if contexts never expire */
+	uint64_t ctx_timeout;
+	/** Time given by the last tick */
+	uint64_t now;
+	/** Expiration time of the reassembly contexts */
+	uint64_t ctx_deadline[RLE_MAX_FRAG_NUMBER];
+	/** Hashed timer wheel, the contexts armed per slot of expiration time, one bit per context */
+	uint8_t ctx_wheel[RLE_RCV_CTX_WHEEL_SLOTS];
+	/** Sequence of the counters updates, odd while counters are updated */
+	uint32_t stats_seq;
+	/** Reassembly storages holding SDUs handed over to the caller by the last decapsulation */
+	unsigned char *delivered[RLE_RCV_DELIVERED_MAX];
+	/** Number of reassembly storages handed over */
+	size_t delivered_nr;
+	/** Reassembly storages reserved in real-time mode, unused ones, empty otherwise */
+	struct rle_rasm_stash stash;
+	/** Allocator of the receiver and its reassembly buffers */
+	struct rle_allocator allocator;
+	/** Whether the receiver is in caller memory */
+	bool in_place;
+	/** Log sink, NULL for the log trace callback, loaded once per log */
+	const struct rle_log_sink *log_sink;
+	/** Pool of the SDU buffers of the pooled decapsulation, NULL if none */
+	struct rle_sdu_pool *sdu_pool;
+	/** Callbacks of the streamed SDUs, all NULL if the SDUs are reassembled */
+	struct rle_stream_callbacks stream;
+	/** Contexts streaming their SDU, verdict not given yet, one bit per context */
+	uint8_t stream_ctx;
+	/** SDUs streamed, per context */
+	struct rle_rcv_stream streams[RLE_MAX_FRAG_NUMBER];
+#ifdef RLE_TIMING
+	/** Durations of the stages */
+	struct rle_timing timing;
+#endif
+#ifdef RLE_COPY_STATS
+	/** Copies of the stages */
+	struct rle_copy_stats copy_stats;
+#endif
+#ifdef RLE_SIZE_STATS
+	/** SDUs of the COMPLETE PPDUs, which belong to no context */
+	struct rle_size_stats comp_size_stats;
+#endif
+	/** Counters of the reassembly contexts, apart from the contexts read on each PPDU */
+	struct link_status ctx_status[RLE_MAX_FRAG_NUMBER];
 };
 
 
@@ -75,6 +197,8 @@ struct rle_receiver {
  * @param[in]      ppdu        The PPDU to decapsulate.
  * @param[in]      ppdu_length The PPDU length.
  * @param[out]     index_ctx   The index of the context.
+ * @param[out]     potential_sdu The SDU, if completely reassembled.
+ * @param[in]      zero_copy   Whether the SDU of a COMPLETE PPDU may be left in the PPDU.
  *
  * @return C_ERROR         if error occured while reassembling SDU
  *         C_REASSEMBLY_OK if SDU is completely reassembled
@@ -86,7 +210,8 @@ int rle_receiver_deencap_data(struct rle_receiver *_this,
                               unsigned char ppdu[],
                               const size_t ppdu_length,
                               int *const index_ctx,
-                              struct rle_sdu *const potential_sdu);
+                              struct rle_sdu *const potential_sdu,
+                              const bool zero_copy);
 
 /**
  * @brief Set to idle the fragment context.
@@ -98,6 +223,41 @@ int rle_receiver_deencap_data(struct rle_receiver *_this,
  */
 void rle_receiver_free_context(struct rle_receiver *_this, uint8_t fragment_id);
 
+/**
+ * @brief Hand the reassembly storage of a context over to the caller, so that its SDU is not
+ *        copied. The storage goes back to the pool at the next decapsulation, the context is
+ *        freed as usual.
+ *
+ * @param[in,out] _this        The receiver module to use for deencapsulation.
+ * @param[in]     fragment_id  Fragmentation context whose SDU is reassembled.
+ *
+ * @return true if the storage is handed over, false if too many already are.
+ *
+ * @ingroup RLE receiver
+ */
+bool rle_receiver_deliver_context(struct rle_receiver *_this, uint8_t fragment_id);
+
+/**
+ * @brief Give the reassembly storages handed over to the caller back to the pool.
+ *
+ * @param[in,out] _this        The receiver module to use for deencapsulation.
+ *
+ * @ingroup RLE receiver
+ */
+void rle_receiver_release_delivered(struct rle_receiver *_this);
+
+/**
+ * @brief Give the verdict of the SDU streamed by a context, if it streams one.
+ *
+ * @param[in,out] _this        The receiver module to use for deencapsulation.
+ * @param[in]     fragment_id  Fragmentation context of the SDU.
+ * @param[in]     verdict      The verdict of the SDU.
+ *
+ * @ingroup RLE receiver
+ */
+void rle_receiver_stream_end(struct rle_receiver *_this, uint8_t fragment_id,
+                             enum rle_stream_verdict verdict);
+
 /**
  * @brief Set to non free the state to a given context knowing its fragment ID.
  *
@@ -128,6 +288,38 @@ static inline void set_free_frag_ctx(struct rle_receiver *const _this, const siz
  */
 static inline int is_context_free(struct rle_receiver *const _this, const size_t fragment_id);
 
+/**
+ * @brief Return whether a given context streams its SDU, knowing its fragment ID.
+ *
+ * @param[in]     _this        The receiver module to use for deencapsulation.
+ * @param[in]     fragment_id  Fragmentation context of the SDU.
+ *
+ * @ingroup RLE receiver
+ */
+static inline bool is_context_streaming(const struct rle_receiver *const _this,
+                                        const size_t fragment_id);
+
+/**
+ * @brief Start updating the counters of the receiver.
+ *
+ *        Counters snapshots taken by other threads until the end of the update are retried, so
+ *        that they see either none or all the updates.
+ *
+ * @param[in,out] _this        The receiver module.
+ *
+ * @ingroup RLE receiver
+ */
+static inline void stats_update_begin(struct rle_receiver *const _this);
+
+/**
+ * @brief End updating the counters of the receiver.
+ *
+ * @param[in,out] _this        The receiver module.
+ *
+ * @ingroup RLE receiver
+ */
+static inline void stats_update_end(struct rle_receiver *const _this);
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
@@ -136,12 +328,27 @@ static inline int is_context_free(struct rle_receiver *const _this, const size_t
 static inline void set_nonfree_frag_ctx(struct rle_receiver *const _this, const size_t fragment_id)
 {
 	rle_ctx_set_nonfree(&_this->free_ctx, fragment_id);
+
+	/* arm the expiration of the reassembly */
+	if (_this->ctx_timeout != 0) {
+		const uint64_t deadline = _this->now + _this->ctx_timeout;
+
+		_this->ctx_deadline[fragment_id] = deadline;
+		_this->ctx_wheel[deadline & (RLE_RCV_CTX_WHEEL_SLOTS - 1)] |= (1 << fragment_id);
+	}
+
 	return;
 }
 
 static inline void set_free_frag_ctx(struct rle_receiver *const _this, const size_t fragment_id)
 {
+	const uint64_t deadline = _this->ctx_deadline[fragment_id];
+
 	rle_ctx_set_free(&_this->free_ctx, fragment_id);
+
+	/* disarm the expiration, only this context uses its bit in the slot */
+	_this->ctx_wheel[deadline & (RLE_RCV_CTX_WHEEL_SLOTS - 1)] &= ~(1 << fragment_id);
+
 	return;
 }
 
@@ -150,5 +357,27 @@ static inline int is_context_free(struct rle_receiver *const _this, const size_t
 	return rle_ctx_is_free(_this->free_ctx, fragment_id);
 }
 
+static inline bool is_context_streaming(const struct rle_receiver *const _this,
+                                        const size_t fragment_id)
+{
+	return ((_this->stream_ctx >> fragment_id) & 1) != 0;
+}
+
+static inline void stats_update_begin(struct rle_receiver *const _this)
+{
+	const uint32_t seq = __atomic_load_n(&_this->stats_seq, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&_this->stats_seq, seq + 1, __ATOMIC_RELAXED);
+	/* the odd sequence is visible before any counter update */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void stats_update_end(struct rle_receiver *const _this)
+{
+	const uint32_t seq = __atomic_load_n(&_this->stats_seq, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&_this->stats_seq, seq + 1, __ATOMIC_RELEASE);
+}
+
 
 #endif /* __RLE_RECEIVER_H__ */
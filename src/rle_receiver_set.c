@@ -0,0 +1,495 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_receiver_set.c
+ * @brief  RLE receiver set, demultiplexing FPDUs to per-terminal receivers by payload label
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include "rle_receiver_set.h"
+#include "rle_conf.h"
+#include "constants.h"
+#include "rle.h"
+
+#ifndef __KERNEL__
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#else
+
+#include <linux/string.h>
+
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#define MODULE_ID RLE_MOD_ID_RECEIVER_SET
+
+/** Flag set in the key of used entries, payload labels are at most 48-bit long */
+#define RLE_RCV_SET_KEY_USED  (1ULL << 63)
+
+/** Minimal number of entries in the table */
+#define RLE_RCV_SET_MIN_ENTRIES  8
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Pack a payload label in a table key.
+ *
+ * @param[in]     label                   The payload label.
+ * @param[in]     label_size              The payload label size, 3 or 6.
+ *
+ * @return        The key, never 0.
+ */
+static uint64_t rcv_set_key(const unsigned char *const label, const size_t label_size)
+{
+	uint64_t key = 0;
+	size_t i;
+
+	for (i = 0; i < label_size; i++) {
+		key = (key << 8) | label[i];
+	}
+
+	return (key | RLE_RCV_SET_KEY_USED);
+}
+
+/**
+ * @brief         Get the home entry of a key in the table.
+ *
+ * @param[in]     set                     The receiver set.
+ * @param[in]     key                     The key.
+ *
+ * @return        The index of the first entry to probe for the key.
+ */
+static size_t rcv_set_home(const struct rle_receiver_set *const set, const uint64_t key)
+{
+	/* Fibonacci hashing, folded so that the low bits depend on every byte of the label */
+	uint64_t hash = key * 0x9e3779b97f4a7c15ULL;
+
+	hash ^= (hash >> 32);
+
+	return (size_t)(hash & set->entries_mask);
+}
+
+/**
+ * @brief         Find the entry of a key, or the empty entry where the key would be inserted.
+ *
+ * @param[in]     set                     The receiver set.
+ * @param[in]     key                     The key.
+ *
+ * @return        The index of the entry.
+ */
+static size_t rcv_set_probe(const struct rle_receiver_set *const set, const uint64_t key)
+{
+	size_t index = rcv_set_home(set, key);
+
+	/* the table has at least twice more entries than terminals, so there is an empty entry */
+	while (set->entries[index].key != 0 && set->entries[index].key != key) {
+		index = (index + 1) & set->entries_mask;
+	}
+
+	return index;
+}
+
+/**
+ * @brief         Remove the terminal of an entry, and destroy its receiver.
+ *
+ *                Entries are shifted back in place of the removed one so that no tombstone is
+ *                needed and probe sequences stay short.
+ *
+ * @param[in,out] set                     The receiver set.
+ * @param[in]     index                   The index of the entry to remove.
+ */
+static void rcv_set_remove(struct rle_receiver_set *const set, size_t index)
+{
+	size_t next = index;
+
+	assert(set->entries[index].key != 0);
+
+	rle_receiver_destroy(&set->entries[index].receiver);
+	set->terminals_nr--;
+
+	for (;;) {
+		size_t home;
+
+		next = (next + 1) & set->entries_mask;
+		if (set->entries[next].key == 0) {
+			break;
+		}
+
+		/* the next entry stays where it is if its home is cyclically in (index, next] */
+		home = rcv_set_home(set, set->entries[next].key);
+		if ((index <= next) ? (index < home && home <= next) : (index < home || home <= next)) {
+			continue;
+		}
+
+		set->entries[index] = set->entries[next];
+		index = next;
+	}
+
+	set->entries[index].key = 0;
+	set->entries[index].last_seen = 0;
+	set->entries[index].receiver = NULL;
+}
+
+/**
+ * @brief         Remove the least recently seen terminal to make room for a new one.
+ *
+ * @param[in,out] set                     The receiver set, full.
+ */
+static void rcv_set_evict_oldest(struct rle_receiver_set *const set)
+{
+	size_t oldest = 0;
+	uint64_t oldest_seen = set->tick + 1;
+	size_t i;
+
+	for (i = 0; i <= set->entries_mask; i++) {
+		if (set->entries[i].key != 0 && set->entries[i].last_seen < oldest_seen) {
+			oldest = i;
+			oldest_seen = set->entries[i].last_seen;
+		}
+	}
+
+	RLE_DEBUG("receiver set full, evict terminal not seen for %llu FPDUs",
+	          (unsigned long long)(set->tick - oldest_seen));
+	rcv_set_remove(set, oldest);
+}
+
+/**
+ * @brief         Get the receiver of a terminal, creating it if the terminal is new.
+ *
+ * @param[in,out] set                     The receiver set.
+ * @param[in]     key                     The key of the terminal.
+ *
+ * @return        The receiver, NULL if it cannot be created.
+ */
+static struct rle_receiver * rcv_set_get_or_create(struct rle_receiver_set *const set,
+                                                   const uint64_t key)
+{
+	struct rle_receiver *receiver = NULL;
+	size_t index = rcv_set_probe(set, key);
+
+	if (set->entries[index].key == 0) {
+		if (set->terminals_nr == set->terminals_max) {
+			rcv_set_evict_oldest(set);
+			/* the removal may have shifted entries, so look for the insertion place again */
+			index = rcv_set_probe(set, key);
+		}
+
+		receiver = rle_receiver_new_with_allocator(&set->conf, &set->allocator);
+		if (receiver == NULL) {
+			RLE_ERR("failed to create the receiver of a new terminal");
+			goto out;
+		}
+
+		set->entries[index].key = key;
+		set->entries[index].receiver = receiver;
+		set->terminals_nr++;
+	}
+
+	set->entries[index].last_seen = set->tick;
+	receiver = set->entries[index].receiver;
+
+out:
+	return receiver;
+}
+
+
+/**
+ * @brief         Dump the statistics of the active terminals, and reset them if requested.
+ *
+ *                The receivers are owned by the set, resetting their counters only moves the base
+ *                they are read from, so the set itself is left untouched.
+ *
+ * @param[in]     set                     The receiver set.
+ * @param[out]    terminals               The statistics of the terminals.
+ * @param[in]     terminals_max           The size of the terminals array.
+ * @param[in]     reset                   Whether the statistics dumped are reset.
+ *
+ * @return        The number of terminals dumped.
+ */
+static size_t rcv_set_stats_dump(const struct rle_receiver_set *const set,
+                                 struct rle_receiver_set_stats terminals[],
+                                 const size_t terminals_max, const bool reset)
+{
+	size_t terminals_nr = 0;
+	size_t i;
+
+	if (set == NULL || terminals == NULL) {
+		goto out;
+	}
+
+	for (i = 0; i <= set->entries_mask && terminals_nr < terminals_max; i++) {
+		const struct rle_receiver_set_entry *const entry = &set->entries[i];
+		struct rle_receiver_set_stats *const terminal = &terminals[terminals_nr];
+		size_t j;
+
+		if (entry->key == 0) {
+			continue;
+		}
+
+		/* unpack the payload label from the key */
+		memset(terminal->payload_label, 0, sizeof(terminal->payload_label));
+		for (j = 0; j < set->payload_label_size; j++) {
+			terminal->payload_label[j] =
+				(unsigned char)(entry->key >> (8 * (set->payload_label_size - 1 - j)));
+		}
+
+		if ((reset ? rle_receiver_stats_fetch_and_reset(entry->receiver, NULL, &terminal->stats) :
+		     rle_receiver_stats_get_all_counters(entry->receiver, NULL, &terminal->stats)) != 0) {
+			RLE_ERR("failed to get the statistics of a terminal");
+			continue;
+		}
+		terminals_nr++;
+	}
+
+out:
+	return terminals_nr;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+struct rle_receiver_set * rle_receiver_set_new(const struct rle_config *const conf,
+                                               const size_t payload_label_size,
+                                               const size_t terminals_max)
+{
+	return rle_receiver_set_new_with_allocator(conf, payload_label_size, terminals_max, NULL);
+}
+
+struct rle_receiver_set * rle_receiver_set_new_with_allocator(const struct rle_config *const conf,
+                                                              const size_t payload_label_size,
+                                                              const size_t terminals_max,
+                                                              const struct rle_allocator *const
+                                                              allocator_in)
+{
+	struct rle_receiver_set *set = NULL;
+	struct rle_allocator allocator;
+	size_t entries_nr = RLE_RCV_SET_MIN_ENTRIES;
+
+	if (!rle_config_check(conf)) {
+		RLE_ERR("failed to created RLE receiver set: invalid configuration");
+		goto error;
+	}
+
+	if (payload_label_size != 3 && payload_label_size != 6) {
+		RLE_ERR("failed to created RLE receiver set: payload label of %zu bytes, 3 or 6 "
+		        "expected", payload_label_size);
+		goto error;
+	}
+
+	if (terminals_max == 0 ||
+	    terminals_max > (SIZE_MAX / 4 / sizeof(struct rle_receiver_set_entry))) {
+		RLE_ERR("failed to created RLE receiver set: invalid number of terminals %zu",
+		        terminals_max);
+		goto error;
+	}
+
+	while (entries_nr < (2 * terminals_max)) {
+		entries_nr <<= 1;
+	}
+
+	if (allocator_in == NULL) {
+		rle_get_allocator(&allocator);
+	} else if (allocator_in->alloc == NULL || allocator_in->free == NULL) {
+		RLE_ERR("failed to created RLE receiver set: invalid allocator");
+		goto error;
+	} else {
+		allocator = *allocator_in;
+	}
+
+	set = (struct rle_receiver_set *)rle_alloc(&allocator, sizeof(struct rle_receiver_set));
+	if (!set) {
+		RLE_ERR("allocating receiver set failed");
+		goto error;
+	}
+	set->allocator = allocator;
+
+	set->entries = (struct rle_receiver_set_entry *)
+	               rle_alloc(&allocator, entries_nr * sizeof(struct rle_receiver_set_entry));
+	if (!set->entries) {
+		RLE_ERR("allocating table of %zu terminals failed", entries_nr);
+		goto free_set;
+	}
+	memset(set->entries, 0, entries_nr * sizeof(struct rle_receiver_set_entry));
+
+	memcpy(&set->conf, conf, sizeof(struct rle_config));
+	set->entries_mask = entries_nr - 1;
+	set->terminals_max = terminals_max;
+	set->terminals_nr = 0;
+	set->payload_label_size = payload_label_size;
+	set->tick = 0;
+
+	return set;
+
+free_set:
+	rle_free(&allocator, set);
+error:
+	return NULL;
+}
+
+void rle_receiver_set_destroy(struct rle_receiver_set **const set)
+{
+	struct rle_allocator allocator;
+	size_t i;
+
+	if (!set || !*set) {
+		/* Nothing to do. */
+		goto out;
+	}
+
+	for (i = 0; i <= (*set)->entries_mask; i++) {
+		if ((*set)->entries[i].key != 0) {
+			rle_receiver_destroy(&(*set)->entries[i].receiver);
+		}
+	}
+
+	/* the allocator is read before it is released with the set */
+	allocator = (*set)->allocator;
+	rle_free(&allocator, (*set)->entries);
+	rle_free(&allocator, *set);
+	*set = NULL;
+
+out:
+	return;
+}
+
+enum rle_decap_status rle_receiver_set_decapsulate(struct rle_receiver_set *const set,
+                                                   unsigned char *const fpdu,
+                                                   const size_t fpdu_length,
+                                                   struct rle_sdu sdus[],
+                                                   const size_t sdus_max_nr,
+                                                   size_t *const sdus_nr,
+                                                   unsigned char *const payload_label)
+{
+	enum rle_decap_status status = RLE_DECAP_ERR;
+	struct rle_receiver *receiver;
+
+	if (set == NULL) {
+		status = RLE_DECAP_ERR_NULL_RCVR;
+		goto out;
+	}
+
+	if (fpdu == NULL || fpdu_length < set->payload_label_size) {
+		status = RLE_DECAP_ERR_INV_FPDU;
+		goto out;
+	}
+
+	if (payload_label == NULL) {
+		status = RLE_DECAP_ERR_INV_PL;
+		goto out;
+	}
+
+	receiver = rle_receiver_set_get_receiver_of_fpdu(set, fpdu, fpdu_length);
+	if (receiver == NULL) {
+		goto out;
+	}
+
+	status = rle_decapsulate(receiver, fpdu, fpdu_length, sdus, sdus_max_nr, sdus_nr,
+	                         payload_label, set->payload_label_size);
+
+out:
+	return status;
+}
+
+struct rle_receiver * rle_receiver_set_get_receiver_of_fpdu(struct rle_receiver_set *const set,
+                                                            const unsigned char *const fpdu,
+                                                            const size_t fpdu_length)
+{
+	assert(fpdu_length >= set->payload_label_size);
+
+	set->tick++;
+
+	return rcv_set_get_or_create(set, rcv_set_key(fpdu, set->payload_label_size));
+}
+
+struct rle_receiver * rle_receiver_set_get_receiver(const struct rle_receiver_set *const set,
+                                                    const unsigned char *const payload_label)
+{
+	struct rle_receiver *receiver = NULL;
+
+	if (set != NULL && payload_label != NULL) {
+		const size_t index =
+			rcv_set_probe(set, rcv_set_key(payload_label, set->payload_label_size));
+
+		receiver = set->entries[index].receiver;
+	}
+
+	return receiver;
+}
+
+size_t rle_receiver_set_evict_idle(struct rle_receiver_set *const set, const uint64_t idle_fpdus)
+{
+	size_t evicted_nr = 0;
+	size_t i = 0;
+
+	if (set == NULL) {
+		goto out;
+	}
+
+	while (i <= set->entries_mask) {
+		const struct rle_receiver_set_entry *const entry = &set->entries[i];
+
+		if (entry->key != 0 && (set->tick - entry->last_seen) > idle_fpdus) {
+			/* the removal shifts a following entry in place, so check the same entry again */
+			rcv_set_remove(set, i);
+			evicted_nr++;
+		} else {
+			i++;
+		}
+	}
+
+	RLE_DEBUG("%zu idle terminals evicted, %zu remaining", evicted_nr, set->terminals_nr);
+
+out:
+	return evicted_nr;
+}
+
+size_t rle_receiver_set_get_terminals_nr(const struct rle_receiver_set *const set)
+{
+	return (set == NULL ? 0 : set->terminals_nr);
+}
+
+size_t rle_receiver_set_stats_dump(const struct rle_receiver_set *const set,
+                                   struct rle_receiver_set_stats terminals[],
+                                   const size_t terminals_max)
+{
+	return rcv_set_stats_dump(set, terminals, terminals_max, false);
+}
+
+size_t rle_receiver_set_stats_fetch_and_reset(struct rle_receiver_set *const set,
+                                              struct rle_receiver_set_stats terminals[],
+                                              const size_t terminals_max)
+{
+	return rcv_set_stats_dump(set, terminals, terminals_max, true);
+}
@@ -0,0 +1,108 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_receiver_set.h
+ * @brief  Definition of the RLE receiver set, demultiplexing FPDUs by payload label
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#ifndef __RLE_RECEIVER_SET_H__
+#define __RLE_RECEIVER_SET_H__
+
+#ifndef __KERNEL__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#else
+
+#include <linux/stddef.h>
+#include <linux/types.h>
+
+#endif
+
+#include "rle.h"
+#include "rle_allocator.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Entry of the receiver set table, one per active terminal.
+ *
+ * @ingroup RLE receiver
+ */
+struct rle_receiver_set_entry {
+	uint64_t key;                   /**< Packed payload label, 0 if the entry is empty */
+	uint64_t last_seen;             /**< Set tick of the last FPDU of the terminal     */
+	struct rle_receiver *receiver;  /**< Reassembly state of the terminal              */
+};
+
+/**
+ * @brief RLE receiver set, one receiver per terminal identified by its payload label.
+ *
+ *        Terminals are looked up in an open-addressing table with linear probing, sized at
+ *        least twice the maximum number of terminals, so that probe sequences stay short.
+ *
+ * @ingroup RLE receiver
+ */
+struct rle_receiver_set {
+	struct rle_receiver_set_entry *entries;  /**< The table of terminals            */
+	size_t entries_mask;                     /**< Number of table entries minus one */
+	size_t terminals_max;                    /**< Max number of active terminals    */
+	size_t terminals_nr;                     /**< Number of active terminals        */
+	size_t payload_label_size;               /**< Size of the payload label         */
+	uint64_t tick;                           /**< Number of FPDUs decapsulated      */
+	struct rle_config conf;                  /**< RLE configuration of terminals    */
+	struct rle_allocator allocator;          /**< Allocator of the set and terminals */
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Get the receiver of the terminal a FPDU comes from, created for a new terminal.
+ *
+ *                The FPDU is counted in the ticks of the set, so that the terminal is seen as
+ *                active. Meant for the entry points that decapsulate FPDUs of their own type, such
+ *                as the socket buffers of the kernel module.
+ *
+ * @param[in,out] set                     The receiver set.
+ * @param[in]     fpdu                    The FPDU, starting with the payload label.
+ * @param[in]     fpdu_length             The size of the FPDU, at least the payload label size.
+ *
+ * @return        The receiver of the terminal, NULL if it cannot be created.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_receiver * rle_receiver_set_get_receiver_of_fpdu(struct rle_receiver_set *const set,
+                                                            const unsigned char *const fpdu,
+                                                            const size_t fpdu_length)
+__attribute__((warn_unused_result, nonnull(1, 2)));
+
+
+#endif /* __RLE_RECEIVER_SET_H__ */
@@ -0,0 +1,216 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_sdu_pool.c
+ * @brief  RLE SDU pool, the size-classed SDU buffers of a receiver
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include "rle_sdu_pool.h"
+#include "rle_trace.h"
+#include "rle.h"
+
+#ifndef __KERNEL__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#else
+
+#include <linux/types.h>
+
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#define MODULE_ID RLE_MOD_ID_SDU_POOL
+
+/** Round a size up to whole cache lines, so that no two buffers share one */
+#define RLE_SDU_POOL_ALIGN(size) \
+	(((size) + RLE_CACHE_LINE_SIZE - 1) / RLE_CACHE_LINE_SIZE * RLE_CACHE_LINE_SIZE)
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*---------------------------------------- PRIVATE DATA ------------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** The size of the buffers of each class, increasing */
+static const size_t rle_sdu_pool_sizes[RLE_SDU_POOL_CLASSES_NR] = {
+	[RLE_SDU_POOL_SMALL] = RLE_SDU_POOL_SMALL_SIZE,
+	[RLE_SDU_POOL_MEDIUM] = RLE_SDU_POOL_MEDIUM_SIZE,
+	[RLE_SDU_POOL_JUMBO] = RLE_SDU_POOL_JUMBO_SIZE,
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------- PRIVATE FUNCTIONS ----------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Get the buffer of a SDU of a pool.
+ *
+ * @param[in]     sdu                      The SDU, in its buffer.
+ *
+ * @return        The buffer.
+ */
+static inline struct rle_sdu_pool_buf *rle_sdu_pool_buf_of(const unsigned char *const sdu);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static inline struct rle_sdu_pool_buf *rle_sdu_pool_buf_of(const unsigned char *const sdu)
+{
+	return (struct rle_sdu_pool_buf *)(void *)(uintptr_t)(sdu -
+	                                                     offsetof(struct rle_sdu_pool_buf, sdu));
+}
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+struct rle_sdu_pool *rle_sdu_pool_new(const size_t buffers_nr[RLE_SDU_POOL_CLASSES_NR],
+                                      const struct rle_allocator *const allocator)
+{
+	const size_t pool_size = RLE_SDU_POOL_ALIGN(sizeof(struct rle_sdu_pool));
+	struct rle_sdu_pool *pool = NULL;
+	size_t strides[RLE_SDU_POOL_CLASSES_NR];
+	size_t size = pool_size;
+	size_t total_nr = 0;
+	unsigned char *buffers;
+	size_t class;
+
+	for (class = 0; class < RLE_SDU_POOL_CLASSES_NR; class++) {
+		strides[class] = RLE_SDU_POOL_ALIGN(sizeof(struct rle_sdu_pool_buf) +
+		                                    rle_sdu_pool_sizes[class]);
+		if (buffers_nr[class] > (SIZE_MAX - size) / strides[class]) {
+			RLE_ERR("too many SDU buffers of %zu bytes", rle_sdu_pool_sizes[class]);
+			goto out;
+		}
+		size += buffers_nr[class] * strides[class];
+		total_nr += buffers_nr[class];
+	}
+	if (total_nr == 0) {
+		RLE_ERR("SDU pool without buffers");
+		goto out;
+	}
+
+	pool = rle_alloc(allocator, size);
+	if (pool == NULL) {
+		RLE_ERR("failed to allocate %zu bytes for the SDU pool", size);
+		goto out;
+	}
+	pool->allocator = *allocator;
+	pool->refs = 1;
+
+	/* the buffers of each class follow the ones of the smaller classes */
+	buffers = (unsigned char *)pool + pool_size;
+	for (class = 0; class < RLE_SDU_POOL_CLASSES_NR; class++) {
+		struct rle_sdu_pool_slab *const slab = &pool->slabs[class];
+		size_t buf_nr;
+
+		slab->size = rle_sdu_pool_sizes[class];
+		slab->free = NULL;
+		slab->released = NULL;
+		for (buf_nr = 0; buf_nr < buffers_nr[class]; buf_nr++) {
+			struct rle_sdu_pool_buf *const buf = (struct rle_sdu_pool_buf *)(void *)buffers;
+
+			buf->pool = pool;
+			buf->size_class = class;
+			buf->next = slab->free;
+			slab->free = buf;
+			buffers += strides[class];
+		}
+	}
+
+out:
+	return pool;
+}
+
+void rle_sdu_pool_put(struct rle_sdu_pool *const pool)
+{
+	if (__atomic_sub_fetch(&pool->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+		const struct rle_allocator allocator = pool->allocator;
+
+		rle_free(&allocator, pool);
+	}
+}
+
+unsigned char *rle_sdu_pool_take(struct rle_sdu_pool *const pool, const size_t sdu_size)
+{
+	size_t class;
+
+	for (class = 0; class < RLE_SDU_POOL_CLASSES_NR; class++) {
+		struct rle_sdu_pool_slab *const slab = &pool->slabs[class];
+		struct rle_sdu_pool_buf *buf;
+
+		if (slab->size < sdu_size) {
+			continue;
+		}
+		buf = slab->free;
+		if (buf == NULL) {
+			/* all the buffers released since the last time, at once */
+			buf = __atomic_exchange_n(&slab->released, NULL, __ATOMIC_ACQUIRE);
+			if (buf == NULL) {
+				/* none left, a larger one will do */
+				continue;
+			}
+		}
+		slab->free = buf->next;
+
+		/* the receiver holds a reference, the buffer one cannot be the first */
+		__atomic_add_fetch(&pool->refs, 1, __ATOMIC_RELAXED);
+
+		return buf->sdu;
+	}
+
+	return NULL;
+}
+
+void rle_sdu_buffer_release(unsigned char *const buffer)
+{
+	struct rle_sdu_pool_buf *const buf = rle_sdu_pool_buf_of(buffer);
+	struct rle_sdu_pool *const pool = buf->pool;
+	struct rle_sdu_pool_slab *const slab = &pool->slabs[buf->size_class];
+	struct rle_sdu_pool_buf *head = __atomic_load_n(&slab->released, __ATOMIC_RELAXED);
+
+	/* only pushed here and taken as a whole by the receiver, so the stack has no ABA issue */
+	do {
+		buf->next = head;
+	} while (!__atomic_compare_exchange_n(&slab->released, &head, buf, true,
+	                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	rle_sdu_pool_put(pool);
+}
+
+size_t rle_sdu_buffer_get_size(const unsigned char *const buffer)
+{
+	const struct rle_sdu_pool_buf *const buf = rle_sdu_pool_buf_of(buffer);
+
+	return rle_sdu_pool_sizes[buf->size_class];
+}
@@ -0,0 +1,142 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_sdu_pool.h
+ * @brief  Definition of the RLE SDU pool, the size-classed SDU buffers of a receiver
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#ifndef __RLE_SDU_POOL_H__
+#define __RLE_SDU_POOL_H__
+
+#ifndef __KERNEL__
+
+#include <stddef.h>
+
+#else
+
+#include <linux/stddef.h>
+
+#endif
+
+#include "rle.h"
+#include "constants.h"
+#include "rle_allocator.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+struct rle_sdu_pool;
+
+/**
+ * @brief Buffer of a SDU pool, the SDU follows its header.
+ *
+ * @ingroup RLE receiver
+ */
+struct rle_sdu_pool_buf {
+	struct rle_sdu_pool_buf *next;  /**< The next buffer of its free list     */
+	struct rle_sdu_pool *pool;      /**< The pool of the buffer               */
+	size_t size_class;              /**< The class of the buffer in its pool  */
+	size_t reserved;                /**< Padding, the SDU is 16-byte aligned  */
+	unsigned char sdu[];            /**< The SDU                              */
+};
+
+/**
+ * @brief Slab of a SDU pool, its buffers of one class.
+ *
+ *        The free buffers are on two lists: the free list, only used by the receiver, and the
+ *        released list, a lock-free stack the buffers are pushed on by any thread. When its free
+ *        list is empty, the receiver takes the whole released list at once with an exchange, so
+ *        that no buffer is ever popped concurrently.
+ *
+ * @ingroup RLE receiver
+ */
+struct rle_sdu_pool_slab {
+	struct rle_sdu_pool_buf *free;      /**< The free buffers of the receiver      */
+	size_t size;                        /**< The size of the buffers of the class  */
+	/** Padding, so that the released list shares no cache line with the free list */
+	unsigned char released_pad[RLE_CACHE_LINE_SIZE];
+	struct rle_sdu_pool_buf *released;  /**< The buffers released by any thread    */
+	/** Padding, so that the released list shares no cache line with the next slab */
+	unsigned char end_pad[RLE_CACHE_LINE_SIZE];
+};
+
+/**
+ * @brief SDU pool of a receiver, its slabs followed by all their buffers, in one allocation.
+ *
+ *        The pool is referenced by its receiver and by each buffer the caller holds: the last
+ *        of them to go releases it, so that the buffers outlive the receiver.
+ *
+ * @ingroup RLE receiver
+ */
+struct rle_sdu_pool {
+	struct rle_sdu_pool_slab slabs[RLE_SDU_POOL_CLASSES_NR];  /**< The buffers, by class     */
+	struct rle_allocator allocator;  /**< The allocator of the pool, a copy of the receiver's */
+	size_t refs;                     /**< The receiver and the buffers held by the caller     */
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Create a SDU pool, referenced by its receiver.
+ *
+ * @param[in]     buffers_nr               The number of buffers of each class.
+ * @param[in]     allocator                The allocator of the receiver.
+ *
+ * @return        The pool, NULL if it is empty or not allocated.
+ *
+ * @ingroup       RLE receiver
+ */
+struct rle_sdu_pool *rle_sdu_pool_new(const size_t buffers_nr[RLE_SDU_POOL_CLASSES_NR],
+                                      const struct rle_allocator *const allocator)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Drop a reference to a SDU pool, the pool is released with the last one.
+ *
+ * @param[in,out] pool                     The pool.
+ *
+ * @ingroup       RLE receiver
+ */
+void rle_sdu_pool_put(struct rle_sdu_pool *const pool);
+
+/**
+ * @brief         Take a buffer for a SDU from a pool, by the receiver of the pool only.
+ *
+ * @param[in,out] pool                     The pool.
+ * @param[in]     sdu_size                 The size of the SDU.
+ *
+ * @return        The buffer of the SDU, NULL if none is left large enough.
+ *
+ * @ingroup       RLE receiver
+ */
+unsigned char *rle_sdu_pool_take(struct rle_sdu_pool *const pool, const size_t sdu_size)
+__attribute__((warn_unused_result));
+
+
+#endif /* __RLE_SDU_POOL_H__ */
@@ -0,0 +1,191 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_size_stats.h
+ * @brief  Histograms of the SDU sizes and of the PPDUs per SDU of the contexts
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#ifndef __RLE_SIZE_STATS_H__
+#define __RLE_SIZE_STATS_H__
+
+#ifndef __KERNEL__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#else
+
+#include <linux/types.h>
+#include <linux/string.h>
+
+#endif
+
+#include "rle.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC CONSTANTS AND MACROS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef RLE_SIZE_STATS
+
+/** Start counting the PPDUs of a new SDU */
+#define rle_size_sdu_start(size_stats) \
+	((size_stats)->ppdus_nr = 0)
+
+/** Count a PPDU of the SDU in progress */
+#define rle_size_ppdu(size_stats) \
+	((size_stats)->ppdus_nr++)
+
+/**
+ * Count a SDU completed with its PPDUs. The histograms have a single writer, they are updated
+ * with relaxed atomic stores so that a monitoring thread reads them untorn.
+ */
+#define rle_size_sdu_end(size_stats, sdu_size) \
+	rle_size_add(&(size_stats)->histogram, (sdu_size), (size_stats)->ppdus_nr)
+
+#else
+
+/** Without the SIZE_STATS option, nothing, the arguments are not even evaluated */
+#define rle_size_sdu_start(size_stats) \
+	do { \
+	} while (0)
+#define rle_size_ppdu(size_stats) \
+	do { \
+	} while (0)
+#define rle_size_sdu_end(size_stats, sdu_size) \
+	do { \
+	} while (0)
+
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef RLE_SIZE_STATS
+
+/** The histograms of a context, and the PPDUs of its SDU in progress */
+struct rle_size_stats {
+	struct rle_size_histogram histogram;  /**< The SDUs completed.                 */
+	size_t ppdus_nr;                      /**< The PPDUs of the SDU in progress.   */
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Count a SDU in a histogram, written by a single thread.
+ *
+ * @param[in,out] histogram                The histogram.
+ * @param[in]     sdu_size                 The size of the SDU, in octets.
+ * @param[in]     ppdus_nr                 The number of PPDUs of the SDU, at least 1.
+ *
+ * @ingroup       RLE size statistics
+ */
+static inline void rle_size_add(struct rle_size_histogram *const histogram,
+                                const size_t sdu_size,
+                                const size_t ppdus_nr);
+
+/**
+ * @brief         Copy a histogram updated by another thread.
+ *
+ * @param[in]     histogram                The histogram.
+ * @param[out]    copy                     The copy of the histogram.
+ *
+ * @ingroup       RLE size statistics
+ */
+static inline void rle_size_read(const struct rle_size_histogram *const histogram,
+                                 struct rle_size_histogram *const copy);
+
+/**
+ * @brief         Reset the histogram of a context, not the SDU in progress.
+ *
+ * @param[in,out] size_stats               The histogram.
+ *
+ * @ingroup       RLE size statistics
+ */
+static inline void rle_size_reset(struct rle_size_stats *const size_stats);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static inline void rle_size_add(struct rle_size_histogram *const histogram,
+                                const size_t sdu_size,
+                                const size_t ppdus_nr)
+{
+	size_t size_bucket = 0;
+	size_t ppdus_bucket = (ppdus_nr > 0 ? ppdus_nr - 1 : 0);
+	uint64_t *bucket;
+
+	if (sdu_size >= 2) {
+		size_bucket = (size_t)(63 - __builtin_clzll((unsigned long long)sdu_size));
+	}
+	if (size_bucket >= RLE_SDU_SIZE_BUCKETS_NR) {
+		size_bucket = RLE_SDU_SIZE_BUCKETS_NR - 1;
+	}
+	if (ppdus_bucket >= RLE_PPDUS_BUCKETS_NR) {
+		ppdus_bucket = RLE_PPDUS_BUCKETS_NR - 1;
+	}
+
+	__atomic_store_n(&histogram->sdus, histogram->sdus + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&histogram->bytes, histogram->bytes + sdu_size, __ATOMIC_RELAXED);
+	__atomic_store_n(&histogram->ppdus, histogram->ppdus + ppdus_nr, __ATOMIC_RELAXED);
+	bucket = &histogram->sizes[size_bucket];
+	__atomic_store_n(bucket, *bucket + 1, __ATOMIC_RELAXED);
+	bucket = &histogram->fragments[ppdus_bucket];
+	__atomic_store_n(bucket, *bucket + 1, __ATOMIC_RELAXED);
+}
+
+static inline void rle_size_read(const struct rle_size_histogram *const histogram,
+                                 struct rle_size_histogram *const copy)
+{
+	size_t bucket;
+
+	copy->sdus = __atomic_load_n(&histogram->sdus, __ATOMIC_RELAXED);
+	copy->bytes = __atomic_load_n(&histogram->bytes, __ATOMIC_RELAXED);
+	copy->ppdus = __atomic_load_n(&histogram->ppdus, __ATOMIC_RELAXED);
+	for (bucket = 0; bucket < RLE_SDU_SIZE_BUCKETS_NR; bucket++) {
+		copy->sizes[bucket] = __atomic_load_n(&histogram->sizes[bucket], __ATOMIC_RELAXED);
+	}
+	for (bucket = 0; bucket < RLE_PPDUS_BUCKETS_NR; bucket++) {
+		copy->fragments[bucket] = __atomic_load_n(&histogram->fragments[bucket],
+		                                          __ATOMIC_RELAXED);
+	}
+}
+
+static inline void rle_size_reset(struct rle_size_stats *const size_stats)
+{
+	memset(&size_stats->histogram, 0, sizeof(size_stats->histogram));
+}
+
+#endif /* RLE_SIZE_STATS */
+
+#endif /* __RLE_SIZE_STATS_H__ */
@@ -0,0 +1,235 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_timing.h
+ * @brief  Timing of the encapsulation and decapsulation stages in log2 histograms
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#ifndef __RLE_TIMING_H__
+#define __RLE_TIMING_H__
+
+#ifndef __KERNEL__
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#else
+
+#include <linux/types.h>
+#include <linux/string.h>
+#include <linux/ktime.h>
+#include <linux/timekeeping.h>
+
+#endif
+
+#include "rle.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC CONSTANTS AND MACROS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef RLE_TIMING
+
+/**
+ * Time a statement in the histogram of a stage of a module. The histograms have a single writer,
+ * they are updated with relaxed atomic stores so that a monitoring thread reads them untorn.
+ */
+#define rle_timing_run(timing, stage, ...) \
+	do { \
+		const uint64_t rle_timing_start = rle_timing_now(); \
+		__VA_ARGS__; \
+		rle_timing_add(&(timing)->stages[(stage)], rle_timing_now() - rle_timing_start); \
+	} while (0)
+
+#else
+
+/** Without the TIMING_STATS option, the statement only */
+#define rle_timing_run(timing, stage, ...) \
+	do { \
+		__VA_ARGS__; \
+	} while (0)
+
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#ifdef RLE_TIMING
+
+/** The durations histograms of the stages of a transmitter or a receiver */
+struct rle_timing {
+	struct rle_timing_histogram stages[RLE_TIMING_STAGES_NR];
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Get the monotonic time.
+ *
+ * @return        The monotonic time, in ns.
+ *
+ * @ingroup       RLE timing
+ */
+static inline uint64_t rle_timing_now(void);
+
+/**
+ * @brief         Get the bucket of a duration.
+ *
+ * @param[in]     duration                 The duration, in ns.
+ *
+ * @return        The index of the log2 bucket of the duration.
+ *
+ * @ingroup       RLE timing
+ */
+static inline size_t rle_timing_bucket(const uint64_t duration);
+
+/**
+ * @brief         Add a duration to the histogram of a stage, written by a single thread.
+ *
+ * @param[in,out] histogram                The histogram.
+ * @param[in]     duration                 The duration, in ns.
+ *
+ * @ingroup       RLE timing
+ */
+static inline void rle_timing_add(struct rle_timing_histogram *const histogram,
+                                  const uint64_t duration);
+
+/**
+ * @brief         Add a duration to a histogram shared between threads.
+ *
+ * @param[in,out] histogram                The histogram.
+ * @param[in]     duration                 The duration, in ns.
+ *
+ * @ingroup       RLE timing
+ */
+static inline void rle_timing_add_shared(struct rle_timing_histogram *const histogram,
+                                         const uint64_t duration);
+
+/**
+ * @brief         Copy a histogram updated by another thread.
+ *
+ * @param[in]     histogram                The histogram.
+ * @param[out]    copy                     The copy of the histogram.
+ *
+ * @ingroup       RLE timing
+ */
+static inline void rle_timing_read(const struct rle_timing_histogram *const histogram,
+                                   struct rle_timing_histogram *const copy);
+
+/**
+ * @brief         Reset the histograms of all the stages of a module.
+ *
+ * @param[in,out] timing                   The histograms.
+ *
+ * @ingroup       RLE timing
+ */
+static inline void rle_timing_reset(struct rle_timing *const timing);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static inline uint64_t rle_timing_now(void)
+{
+#ifndef __KERNEL__
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#else
+	return ktime_get_ns();
+#endif
+}
+
+static inline size_t rle_timing_bucket(const uint64_t duration)
+{
+	size_t bucket;
+
+	if (duration < 2) {
+		return 0;
+	}
+
+	bucket = 63 - __builtin_clzll(duration);
+
+	return bucket < RLE_TIMING_BUCKETS_NR ? bucket : RLE_TIMING_BUCKETS_NR - 1;
+}
+
+static inline void rle_timing_add(struct rle_timing_histogram *const histogram,
+                                  const uint64_t duration)
+{
+	uint64_t *const bucket = &histogram->buckets[rle_timing_bucket(duration)];
+
+	__atomic_store_n(&histogram->count, histogram->count + 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&histogram->total_ns, histogram->total_ns + duration, __ATOMIC_RELAXED);
+	if (duration > histogram->max_ns) {
+		__atomic_store_n(&histogram->max_ns, duration, __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(bucket, *bucket + 1, __ATOMIC_RELAXED);
+}
+
+static inline void rle_timing_add_shared(struct rle_timing_histogram *const histogram,
+                                         const uint64_t duration)
+{
+	uint64_t max_ns = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+
+	__atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&histogram->total_ns, duration, __ATOMIC_RELAXED);
+	while (duration > max_ns &&
+	       !__atomic_compare_exchange_n(&histogram->max_ns, &max_ns, duration, true,
+	                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		/* another thread updated the max, retry against its value */
+	}
+	__atomic_fetch_add(&histogram->buckets[rle_timing_bucket(duration)], 1, __ATOMIC_RELAXED);
+}
+
+static inline void rle_timing_read(const struct rle_timing_histogram *const histogram,
+                                   struct rle_timing_histogram *const copy)
+{
+	size_t bucket;
+
+	copy->count = __atomic_load_n(&histogram->count, __ATOMIC_RELAXED);
+	copy->total_ns = __atomic_load_n(&histogram->total_ns, __ATOMIC_RELAXED);
+	copy->max_ns = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+	for (bucket = 0; bucket < RLE_TIMING_BUCKETS_NR; bucket++) {
+		copy->buckets[bucket] = __atomic_load_n(&histogram->buckets[bucket], __ATOMIC_RELAXED);
+	}
+}
+
+static inline void rle_timing_reset(struct rle_timing *const timing)
+{
+	memset(timing, 0, sizeof(*timing));
+}
+
+#endif /* RLE_TIMING */
+
+#endif /* __RLE_TIMING_H__ */
@@ -0,0 +1,91 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_trace.h
+ * @brief  Static tracepoints on the fragmentation and reassembly events
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * The events are USDT probes of the librle provider in userspace, built with the USDT option,
+ * and tracepoints of the librle system in the kernel module, built with RLE_TRACEPOINTS=y:
+ *
+ *  - sdu_enqueued(frag_id, sdu_len, protocol_type): a SDU is encapsulated in a context,
+ *  - ppdu_emitted(frag_id, ppdu_len, alpdu_remaining_len): a PPDU of a context is fragmented,
+ *    the last one of the ALPDU leaving 0 octet,
+ *  - start_received(frag_id, ppdu_len, sdu_total_len): a START PPDU is reassembled,
+ *  - cont_received(frag_id, ppdu_len, sdu_reassembled_len): a CONT PPDU is reassembled,
+ *  - end_received(frag_id, ppdu_len, sdu_reassembled_len): an END PPDU is reassembled,
+ *  - ctx_freed(frag_id): a reassembly context is freed, with or without its SDU,
+ *  - crc_mismatch(frag_id, sdu_len, crc_received, crc_expected): a reassembled SDU has a wrong CRC,
+ *  - seqnum_loss(frag_id, seq_nb_received, seq_nb_expected, lost_nr): SDUs are lost between two
+ *    sequence numbers.
+ *
+ * The frame lengths are in octets. Built without, the tracepoints cost nothing and their
+ * arguments are not even evaluated. Disabled, a USDT probe is a single nop.
+ *
+ * For example: bpftrace -e 'usdt:/usr/lib/librle.so:librle:seqnum_loss { @[arg0] = sum(arg3); }'
+ */
+
+#ifndef __RLE_TRACE_H__
+#define __RLE_TRACE_H__
+
+#ifndef __KERNEL__
+
+#ifdef RLE_USDT
+#include <sys/sdt.h>
+#endif
+
+#else
+
+#ifdef RLE_TRACEPOINTS
+#include "rle_trace_events.h"
+#endif
+
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC CONSTANTS AND MACROS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#if !defined(__KERNEL__) && defined(RLE_USDT)
+
+/** Fire the USDT probe of an event, see the list of the events above */
+#define rle_trace(event, ...) \
+	STAP_PROBEV(librle, event, __VA_ARGS__)
+
+#elif defined(__KERNEL__) && defined(RLE_TRACEPOINTS)
+
+/** Fire the kernel tracepoint of an event, see the list of the events above */
+#define rle_trace(event, ...) \
+	trace_librle_ ## event(__VA_ARGS__)
+
+#else
+
+/** Without tracepoints, nothing, the arguments are not even evaluated */
+#define rle_trace(event, ...) \
+	do { \
+	} while (0)
+
+#endif
+
+#endif /* __RLE_TRACE_H__ */
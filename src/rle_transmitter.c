@@ -33,6 +33,7 @@
 #include "encap.h"
 #include "fragmentation.h"
 #include "trailer.h"
+#include "crc.h"
 
 #ifndef __KERNEL__
 
@@ -42,154 +43,1065 @@
 
 #endif
 
-#ifdef TIME_DEBUG
-#include <sys/time.h>
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#define MODULE_ID RLE_MOD_ID_TRANSMITTER
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------- PRIVATE FUNCTIONS ----------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief          Check if a transmitter queue context is valid and extract it.
+ *
+ * @param[in]      transmitter              The transmitter with the context to extract.
+ * @param[in]      fragment_id              The fragment ID linked to the context to extract.
+ * @param[out]     ctx_man                  The extracted context.
+ *
+ * @return         0 if OK, else 1.
+ */
+static int get_transmitter_context(const struct rle_transmitter *const transmitter,
+                                   const uint8_t fragment_id,
+                                   const struct rle_ctx_mngt **const ctx_man);
+
+/**
+ * @brief          Set to idle a fragmentation context.
+ *
+ * @param[in,out]  _this                    The transmitter module.
+ * @param[in]      ctx_index                The fragmentation context.
+ */
+static void set_free_frag_ctx(struct rle_transmitter *const _this, const size_t ctx_index);
+
+/**
+ * @brief          Get the number of contexts of a transmitter.
+ *
+ * @param[in]      conf                     The configuration of the transmitter, valid.
+ *
+ * @return         The number of contexts.
+ */
+static size_t get_contexts_nr(const struct rle_config *const conf);
+
+/**
+ * @brief          Get the size of a part of the memory of a transmitter initialized in place.
+ *
+ * @param[in]      size                     The size of the part.
+ *
+ * @return         The size rounded up to RLE_IN_PLACE_ALIGNMENT, so that all parts are aligned.
+ */
+static size_t get_in_place_size(const size_t size);
+
+/**
+ * @brief          Get the size of the contexts of a transmitter, followed by their counters.
+ *
+ * @param[in]      contexts_nr              The number of contexts.
+ *
+ * @return         The size.
+ */
+static size_t get_contexts_size(const size_t contexts_nr);
+
+/**
+ * @brief          Get the counters of the contexts of a transmitter, after all its contexts.
+ *
+ * @param[in]      transmitter              The transmitter, its number of contexts set.
+ *
+ * @return         The counters, one per context.
+ */
+static struct link_status *get_contexts_status(struct rle_transmitter *const transmitter);
+
+/**
+ * @brief          Get the size of the transmitter and its contexts in memory initialized in place.
+ *
+ * @param[in]      contexts_nr              The number of contexts.
+ *
+ * @return         The size, rounded up to RLE_IN_PLACE_ALIGNMENT.
+ */
+static size_t get_in_place_head_size(const size_t contexts_nr);
+
+/**
+ * @brief          Initialize a transmitter in its memory, without fragmentation buffers.
+ *
+ * @param[out]     transmitter              The transmitter.
+ * @param[in]      conf                     The configuration of the transmitter, valid.
+ * @param[in]      contexts_nr              The number of contexts of the transmitter.
+ * @param[in]      allocator                The allocator of the memory taken afterwards.
+ *
+ * @return         true if OK, else false.
+ */
+static bool transmitter_setup(struct rle_transmitter *const transmitter,
+                              const struct rle_config *const conf,
+                              const size_t contexts_nr,
+                              const struct rle_allocator *const allocator);
+
+/**
+ * @brief          Free the buffers of the queue of a context.
+ *
+ * @param[in,out]  queue                    The queue, empty afterwards.
+ * @param[in]      allocator                The allocator of the transmitter.
+ */
+static void tx_queue_destroy(struct rle_tx_queue *const queue,
+                             const struct rle_allocator *const allocator);
+
+/**
+ * @brief          Pick the next context of a bitmap of contexts in round robin.
+ *
+ * @param[in]      frag_ids                 The bitmap of the candidate contexts, not empty.
+ * @param[in]      last_frag_id             The context picked last time.
+ *
+ * @return         The first context of the bitmap after the last one, cyclically.
+ */
+static uint8_t next_frag_id_after(const uint8_t frag_ids, const uint8_t last_frag_id);
+
+/**
+ * @brief          Pick the next context to serve in a traffic class.
+ *
+ * @param[in,out]  _this                    The transmitter module.
+ * @param[in]      traffic_class            The traffic class.
+ * @param[out]     fragment_id              The chosen context.
+ *
+ * @return         true if a context of the class has ALPDU data to fragment, else false.
+ */
+static bool pick_class_context(struct rle_transmitter *const _this,
+                               const uint8_t traffic_class,
+                               uint8_t *const fragment_id);
+
+/**
+ * @brief          Get the traffic class owning a context.
+ *
+ * @param[in]      _this                    The transmitter module.
+ * @param[in]      fragment_id              The context, valid.
+ *
+ * @return         The traffic class.
+ */
+static uint8_t get_context_class(const struct rle_transmitter *const _this,
+                                 const uint8_t fragment_id);
+
+/**
+ * @brief          Add octets and ALPDUs to a backlog, or remove them with their opposites.
+ *
+ * @param[in,out]  backlog                  The backlog.
+ * @param[in]      alpdu_bytes              The ALPDU octets added, modulo SIZE_MAX + 1.
+ * @param[in]      alpdus_nr                The ALPDUs added, modulo SIZE_MAX + 1.
+ */
+static void backlog_add(struct rle_tx_backlog *const backlog, const size_t alpdu_bytes,
+                        const size_t alpdus_nr);
+
+/**
+ * @brief          Add the memory taken by a fragmentation buffer to a footprint.
+ *
+ * @param[in,out]  footprint                The footprint, max_bytes left as is.
+ * @param[in]      frag_buf                 The fragmentation buffer, may be NULL.
+ */
+static void add_frag_buf_footprint(struct rle_memory_footprint *const footprint,
+                                   const rle_frag_buf_t *const frag_buf);
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+static int get_transmitter_context(const struct rle_transmitter *const transmitter,
+                                   const uint8_t fragment_id,
+                                   const struct rle_ctx_mngt **const ctx_man)
+{
+	int status = 1;
+
+	assert(ctx_man != NULL);
+
+	if (transmitter == NULL || fragment_id >= transmitter->contexts_nr) {
+		/* Out of bound */
+		goto error;
+	}
+
+	*ctx_man = &transmitter->rle_ctx_man[fragment_id];
+
+	status = 0;
+
+error:
+	return status;
+}
+
+static void set_free_frag_ctx(struct rle_transmitter *const _this, const size_t ctx_index)
+{
+	rle_ctx_set_free(&_this->free_ctx, ctx_index);
+}
+
+static uint8_t get_context_class(const struct rle_transmitter *const _this,
+                                 const uint8_t fragment_id)
+{
+	uint8_t tc;
+
+	/* each context belongs to exactly one class */
+	for (tc = 0; tc < RLE_TRAFFIC_CLASSES_NR - 1; tc++) {
+		if ((_this->classes[tc].frag_ids >> fragment_id) & 1) {
+			break;
+		}
+	}
+
+	return tc;
+}
+
+static void backlog_add(struct rle_tx_backlog *const backlog, const size_t alpdu_bytes,
+                        const size_t alpdus_nr)
+{
+	__atomic_store_n(&backlog->alpdu_bytes, backlog->alpdu_bytes + alpdu_bytes,
+	                 __ATOMIC_RELAXED);
+	__atomic_store_n(&backlog->alpdus_nr, backlog->alpdus_nr + alpdus_nr, __ATOMIC_RELAXED);
+}
+
+static uint8_t next_frag_id_after(const uint8_t frag_ids, const uint8_t last_frag_id)
+{
+	const unsigned int first = (last_frag_id + 1) % RLE_MAX_FRAG_NUMBER;
+	/* the bitmap twice in a row, so that the search wraps around */
+	const unsigned int candidates = ((unsigned int)frag_ids | ((unsigned int)frag_ids <<
+	                                 RLE_MAX_FRAG_NUMBER)) >> first;
+
+	assert(frag_ids != 0);
+
+	return (first + __builtin_ctz(candidates)) % RLE_MAX_FRAG_NUMBER;
+}
+
+static bool pick_class_context(struct rle_transmitter *const _this,
+                               const uint8_t traffic_class,
+                               uint8_t *const fragment_id)
+{
+	struct rle_tx_class *const tx_class = &_this->classes[traffic_class];
+	const uint8_t busy = _this->free_ctx & tx_class->frag_ids;
+
+	if (busy == 0) {
+		return false;
+	}
+
+	tx_class->last_frag_id = next_frag_id_after(busy, tx_class->last_frag_id);
+	*fragment_id = tx_class->last_frag_id;
+
+	return true;
+}
+
+static void tx_queue_destroy(struct rle_tx_queue *const queue,
+                             const struct rle_allocator *const allocator)
+{
+	size_t i;
+
+	if (queue->slots != NULL) {
+		for (i = 0; i < queue->depth; i++) {
+			if (queue->slots[i] != NULL) {
+				rle_frag_buf_del(&queue->slots[i]);
+			}
+		}
+		rle_free(allocator, queue->slots);
+	}
+	queue->slots = NULL;
+	queue->depth = 0;
+	queue->head = 0;
+	queue->nr = 0;
+}
+
+
+static void add_frag_buf_footprint(struct rle_memory_footprint *const footprint,
+                                   const rle_frag_buf_t *const frag_buf)
+{
+	struct rle_memory_footprint frag_buf_footprint;
+
+	if (rle_frag_buf_memory_footprint(frag_buf, &frag_buf_footprint) == 0) {
+		footprint->bytes += frag_buf_footprint.bytes;
+		footprint->allocations += frag_buf_footprint.allocations;
+	}
+}
+
+static size_t get_contexts_nr(const struct rle_config *const conf)
+{
+	return (conf->fragment_contexts_nr == 0 ? RLE_MAX_FRAG_NUMBER : conf->fragment_contexts_nr);
+}
+
+static size_t get_in_place_size(const size_t size)
+{
+	return (size + RLE_IN_PLACE_ALIGNMENT - 1) & ~((size_t)RLE_IN_PLACE_ALIGNMENT - 1);
+}
+
+static size_t get_contexts_size(const size_t contexts_nr)
+{
+	return contexts_nr * (sizeof(struct rle_ctx_mngt) + sizeof(struct link_status));
+}
+
+static struct link_status *get_contexts_status(struct rle_transmitter *const transmitter)
+{
+	return (struct link_status *)(void *)&transmitter->rle_ctx_man[transmitter->contexts_nr];
+}
+
+static size_t get_in_place_head_size(const size_t contexts_nr)
+{
+	return get_in_place_size(sizeof(struct rle_transmitter) + get_contexts_size(contexts_nr));
+}
+
+static bool transmitter_setup(struct rle_transmitter *const transmitter,
+                              const struct rle_config *const conf,
+                              const size_t contexts_nr,
+                              const struct rle_allocator *const allocator)
+{
+	size_t i;
+
+	transmitter->contexts_nr = (uint8_t)contexts_nr;
+	transmitter->allocator = *allocator;
+
+	/* initialize fragmentation contexts, without queues */
+	memset(transmitter->rle_ctx_man, 0, contexts_nr * sizeof(struct rle_ctx_mngt));
+	memset(transmitter->queues, 0, RLE_MAX_FRAG_NUMBER * sizeof(struct rle_tx_queue));
+	for (i = 0; i < contexts_nr; ++i) {
+		struct rle_ctx_mngt *const ctx_man = &transmitter->rle_ctx_man[i];
+
+		ctx_man->lk_status = &get_contexts_status(transmitter)[i];
+		if (rle_ctx_init_frag_buf(ctx_man) != C_OK) {
+			RLE_ERR("failed to initialize frag context with ID %zu", i);
+			return false;
+		}
+		ctx_man->frag_id = i;
+		rle_ctx_set_seq_nb(ctx_man, 0);
+	}
+
+	transmitter->free_ctx = 0;
+
+	/* all the contexts belong to the first traffic class by default */
+	memset(transmitter->classes, 0, RLE_TRAFFIC_CLASSES_NR * sizeof(struct rle_tx_class));
+	transmitter->classes[0].frag_ids = (uint8_t)((1U << contexts_nr) - 1);
+	for (i = 0; i < RLE_TRAFFIC_CLASSES_NR; i++) {
+		transmitter->classes[i].last_frag_id = RLE_MAX_FRAG_ID;
+	}
+	transmitter->wrr_class = 0;
+	transmitter->wrr_credit = 0;
+	memset(&transmitter->backlog, 0, sizeof(transmitter->backlog));
+	memset(transmitter->backlogs, 0, sizeof(transmitter->backlogs));
+	memset(transmitter->ptype_mix, 0, sizeof(transmitter->ptype_mix));
+	transmitter->log_sink = NULL;
+	memset(&transmitter->protection, 0, sizeof(transmitter->protection));
+	transmitter->protection_auto = false;
+	transmitter->pipe = NULL;
+#ifdef RLE_TIMING
+	rle_timing_reset(&transmitter->timing);
 #endif
+#ifdef RLE_COPY_STATS
+	rle_copy_reset(&transmitter->copy_stats);
+#endif
+
+	memcpy(&transmitter->conf, conf, sizeof(struct rle_config));
+
+	if (!rle_ptype_table_init(&transmitter->ptype_table, &transmitter->conf)) {
+		RLE_ERR("failed to build the protocol type table");
+		return false;
+	}
+	transmitter->push_ppdu_hdr = push_ppdu_hdr_select(&transmitter->conf);
+
+	return true;
+}
+
 
 /*------------------------------------------------------------------------------------------------*/
-/*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
 /*------------------------------------------------------------------------------------------------*/
 
-#define MODULE_ID RLE_MOD_ID_TRANSMITTER
+struct rle_transmitter * rle_transmitter_new(const struct rle_config *const conf)
+{
+	return rle_transmitter_new_with_allocator(conf, NULL);
+}
+
+struct rle_transmitter * rle_transmitter_new_with_allocator(const struct rle_config *const conf,
+                                                            const struct rle_allocator *const
+                                                            allocator)
+{
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_allocator tx_allocator;
+	size_t contexts_nr;
+
+	if (!rle_config_check(conf)) {
+		RLE_ERR("failed to created RLE transmitter: invalid configuration");
+		goto error;
+	}
+
+	if (allocator == NULL) {
+		rle_get_allocator(&tx_allocator);
+	} else if (allocator->alloc == NULL || allocator->free == NULL) {
+		RLE_ERR("failed to created RLE transmitter: invalid allocator");
+		goto error;
+	} else {
+		tx_allocator = *allocator;
+	}
+
+	contexts_nr = get_contexts_nr(conf);
+
+	transmitter = (struct rle_transmitter *)
+	              rle_alloc(&tx_allocator, sizeof(struct rle_transmitter) +
+	                        get_contexts_size(contexts_nr));
+	if (!transmitter) {
+		RLE_ERR("allocating transmitter module failed\n");
+		goto error;
+	}
+
+	if (!transmitter_setup(transmitter, conf, contexts_nr, &tx_allocator)) {
+		rle_free(&tx_allocator, transmitter);
+		goto error;
+	}
+	transmitter->in_place = false;
+
+	/* in real-time mode, the buffers of the contexts are sized for any SDU up front */
+	if (conf->realtime) {
+		size_t i;
+
+		for (i = 0; i < contexts_nr; i++) {
+			if (frag_buf_reserve((rle_frag_buf_t **)&transmitter->rle_ctx_man[i].buff,
+			                     RLE_MAX_PDU_SIZE, &transmitter->allocator)) {
+				RLE_ERR("failed to reserve the buffer of context with ID %zu", i);
+				rle_transmitter_destroy(&transmitter);
+				goto error;
+			}
+		}
+	}
+
+	return transmitter;
+
+error:
+	return NULL;
+}
+
+size_t rle_transmitter_size(const struct rle_config *const conf)
+{
+	size_t contexts_nr;
+
+	if (!rle_config_check(conf)) {
+		return 0;
+	}
+	contexts_nr = get_contexts_nr(conf);
+
+	return get_in_place_head_size(contexts_nr) +
+	       contexts_nr * get_in_place_size(frag_buf_get_size(RLE_MAX_PDU_SIZE));
+}
+
+int rle_transmitter_memory_footprint(const struct rle_transmitter *const transmitter,
+                                     struct rle_memory_footprint *const footprint)
+{
+	const size_t frag_buf_max_size = frag_buf_get_size(RLE_MAX_PDU_SIZE);
+	int status = 1;
+	size_t i;
+
+	if (transmitter == NULL || footprint == NULL) {
+		goto error;
+	}
+
+	memset(footprint, 0, sizeof(struct rle_memory_footprint));
+	if (!transmitter->in_place) {
+		/* the buffers of the contexts are in the memory of the caller otherwise */
+		footprint->bytes = sizeof(struct rle_transmitter) +
+		                   get_contexts_size(transmitter->contexts_nr);
+		footprint->allocations = 1;
+		footprint->max_bytes = footprint->bytes +
+		                       transmitter->contexts_nr * frag_buf_max_size;
+	}
+
+	for (i = 0; i < transmitter->contexts_nr; i++) {
+		const rle_frag_buf_t *const frag_buf =
+			(const rle_frag_buf_t *)transmitter->rle_ctx_man[i].buff;
+		const struct rle_tx_queue *const queue = &transmitter->queues[i];
+		size_t slot;
+
+		add_frag_buf_footprint(footprint, frag_buf);
+
+		if (queue->slots == NULL) {
+			continue;
+		}
+		footprint->bytes += queue->depth * sizeof(rle_frag_buf_t *);
+		footprint->allocations++;
+		footprint->max_bytes += queue->depth *
+		                        (sizeof(rle_frag_buf_t *) + frag_buf_max_size);
+		for (slot = 0; slot < queue->depth; slot++) {
+			add_frag_buf_footprint(footprint, queue->slots[slot]);
+		}
+	}
+
+	status = 0;
+
+error:
+	return status;
+}
+
+struct rle_transmitter * rle_transmitter_init_in_place(void *const mem, const size_t mem_size,
+                                                       const struct rle_config *const conf)
+{
+	struct rle_transmitter *const transmitter = (struct rle_transmitter *)mem;
+	struct rle_allocator tx_allocator;
+	unsigned char *frag_bufs_mem;
+	size_t contexts_nr;
+	size_t i;
+
+	if (mem == NULL || ((uintptr_t)mem % RLE_IN_PLACE_ALIGNMENT) != 0) {
+		RLE_ERR("failed to created RLE transmitter: memory not aligned on %u bytes",
+		        RLE_IN_PLACE_ALIGNMENT);
+		goto error;
+	}
+
+	if (rle_transmitter_size(conf) == 0 || mem_size < rle_transmitter_size(conf)) {
+		RLE_ERR("failed to created RLE transmitter: invalid configuration or %zu-byte memory "
+		        "too small", mem_size);
+		goto error;
+	}
+
+	/* only the queues are allocated afterwards */
+	rle_get_allocator(&tx_allocator);
+	contexts_nr = get_contexts_nr(conf);
+
+	if (!transmitter_setup(transmitter, conf, contexts_nr, &tx_allocator)) {
+		goto error;
+	}
+	transmitter->in_place = true;
+
+	/* the buffers hold the largest SDUs, so that they are never replaced by larger ones */
+	frag_bufs_mem = (unsigned char *)mem + get_in_place_head_size(contexts_nr);
+	for (i = 0; i < contexts_nr; i++) {
+		transmitter->rle_ctx_man[i].buff =
+			frag_buf_init_in_place((void *)frag_bufs_mem, RLE_MAX_PDU_SIZE,
+			                       &rle_caller_allocator);
+		frag_bufs_mem += get_in_place_size(frag_buf_get_size(RLE_MAX_PDU_SIZE));
+	}
+
+	return transmitter;
+
+error:
+	return NULL;
+}
+
+void rle_transmitter_fini(struct rle_transmitter *const transmitter)
+{
+	size_t i;
+
+	if (transmitter == NULL) {
+		goto exit_label;
+	}
+
+	for (i = 0; i < transmitter->contexts_nr; i++) {
+		struct rle_ctx_mngt *const ctx_man = &transmitter->rle_ctx_man[i];
+
+		rle_ctx_destroy_frag_buf(ctx_man);
+		tx_queue_destroy(&transmitter->queues[i], &transmitter->allocator);
+	}
+
+exit_label:
+
+	return;
+}
+
+void rle_transmitter_destroy(struct rle_transmitter **const transmitter)
+{
+	struct rle_allocator allocator;
+
+	if (!transmitter) {
+		goto exit_label;
+	}
+
+	if (!*transmitter) {
+		/* Transmitter already NULL, nothing to do. */
+		goto exit_label;
+	}
+
+	rle_transmitter_fini(*transmitter);
+
+	/* the allocator is read before it is released with the transmitter */
+	allocator = (*transmitter)->allocator;
+	if (!(*transmitter)->in_place) {
+		rle_free(&allocator, *transmitter);
+	}
+	*transmitter = NULL;
+
+exit_label:
+
+	return;
+}
+
+struct rle_frag_conf * rle_frag_conf_new(const struct rle_config *const conf)
+{
+	struct rle_frag_conf *frag_conf = NULL;
+	struct rle_allocator allocator;
+
+	if (!rle_config_check(conf)) {
+		RLE_ERR("failed to create RLE fragmentation configuration: invalid configuration");
+		goto error;
+	}
+
+	rle_get_allocator(&allocator);
+	frag_conf = (struct rle_frag_conf *)rle_alloc(&allocator, sizeof(struct rle_frag_conf));
+	if (!frag_conf) {
+		RLE_ERR("allocating fragmentation configuration failed\n");
+		goto error;
+	}
+	frag_conf->allocator = allocator;
+
+	/* the same resolution as for a transmitter, done once for all the threads */
+	memcpy(&frag_conf->conf, conf, sizeof(struct rle_config));
+	if (!rle_ptype_table_init(&frag_conf->ptype_table, &frag_conf->conf)) {
+		RLE_ERR("failed to build the protocol type table");
+		rle_free(&allocator, frag_conf);
+		goto error;
+	}
+	frag_conf->push_ppdu_hdr = push_ppdu_hdr_select(&frag_conf->conf);
+
+	return frag_conf;
+
+error:
+	return NULL;
+}
+
+void rle_frag_conf_destroy(struct rle_frag_conf **const frag_conf)
+{
+	struct rle_allocator allocator;
+
+	if (!frag_conf || !*frag_conf) {
+		/* Nothing to do. */
+		goto out;
+	}
+
+	allocator = (*frag_conf)->allocator;
+	rle_free(&allocator, *frag_conf);
+	*frag_conf = NULL;
+
+out:
+	return;
+}
+
+void rle_transmitter_free_context(struct rle_transmitter *const _this, const uint8_t fragment_id)
+{
+	struct rle_tx_queue *const queue = &_this->queues[fragment_id];
+	struct rle_ctx_mngt *const ctx_man = &_this->rle_ctx_man[fragment_id];
+	rle_frag_buf_t *next_frag_buf;
+
+	/* the next SDU of the context, if any, starts its PPDUs */
+	rle_size_sdu_start(&ctx_man->lk_status->size_stats);
+
+	if (queue->nr == 0) {
+		/* set to idle this fragmentation context */
+		set_free_frag_ctx(_this, fragment_id);
+		goto out;
+	}
+
+	/* the oldest queued SDU takes the context, the buffer of the previous one takes its place
+	 * in the ring */
+	next_frag_buf = queue->slots[queue->head];
+	queue->slots[queue->head] = (rle_frag_buf_t *)ctx_man->buff;
+	ctx_man->buff = next_frag_buf;
+	queue->head = (queue->head + 1) % queue->depth;
+	queue->nr--;
+	RLE_DEBUG_TO(&_this->log_sink,
+	             "next SDU of context with ID %u dequeued, %zu SDUs still queued", fragment_id,
+	             queue->nr);
+
+out:
+	return;
+}
+
+int rle_transmitter_set_traffic_class(struct rle_transmitter *const transmitter,
+                                      const uint8_t traffic_class,
+                                      const uint8_t frag_ids,
+                                      const uint8_t weight)
+{
+	int status = 1;
+	size_t i;
+
+	if (transmitter == NULL || traffic_class >= RLE_TRAFFIC_CLASSES_NR) {
+		goto error;
+	}
+
+	if ((frag_ids >> transmitter->contexts_nr) != 0) {
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "contexts 0x%02x given to traffic class %u while only %u contexts exist",
+		           frag_ids, traffic_class, transmitter->contexts_nr);
+		goto error;
+	}
+
+	/* classes never share a context, the ALPDUs of the contexts move with them */
+	for (i = 0; i < RLE_TRAFFIC_CLASSES_NR; i++) {
+		uint8_t moved_frag_ids = transmitter->classes[i].frag_ids & frag_ids;
+
+		if (i == traffic_class) {
+			continue;
+		}
+		for (; moved_frag_ids != 0; moved_frag_ids &= moved_frag_ids - 1) {
+			const struct rle_tx_backlog *const moved =
+				&transmitter->backlogs[__builtin_ctz(moved_frag_ids)];
+
+			backlog_add(&transmitter->classes[i].backlog, -moved->alpdu_bytes,
+			            -moved->alpdus_nr);
+			backlog_add(&transmitter->classes[traffic_class].backlog, moved->alpdu_bytes,
+			            moved->alpdus_nr);
+		}
+		transmitter->classes[i].frag_ids &= (uint8_t)~frag_ids;
+	}
+	transmitter->classes[traffic_class].frag_ids |= frag_ids;
+	transmitter->classes[traffic_class].weight = weight;
+	RLE_DEBUG_TO(&transmitter->log_sink,
+	             "traffic class %u: contexts 0x%02x, weight %u", traffic_class,
+	             transmitter->classes[traffic_class].frag_ids, weight);
+
+	status = 0;
+
+error:
+	return status;
+}
+
+int rle_transmitter_suggest_implicit_ptype(const struct rle_transmitter *const transmitter,
+                                           uint8_t *const implicit_protocol_type)
+{
+	/* the candidates, and the classes of the SDUs whose protocol type each one omits */
+	static const struct {
+		uint8_t comp_ptype;
+		uint8_t classes;
+	} candidates[] = {
+		{ RLE_PROTO_TYPE_IP_COMP,
+		  (1U << RLE_PTYPE_CLASS_IPV4) | (1U << RLE_PTYPE_CLASS_IPV6) },
+		{ RLE_PROTO_TYPE_IPV4_COMP, 1U << RLE_PTYPE_CLASS_IPV4 },
+		{ RLE_PROTO_TYPE_IPV6_COMP, 1U << RLE_PTYPE_CLASS_IPV6 },
+		{ RLE_PROTO_TYPE_VLAN_COMP, 1U << RLE_PTYPE_CLASS_VLAN },
+		{ RLE_PROTO_TYPE_ARP_COMP, 1U << RLE_PTYPE_CLASS_ARP },
+	};
+	const size_t candidates_nr = sizeof(candidates) / sizeof(candidates[0]);
+	uint64_t omitted[sizeof(candidates) / sizeof(candidates[0])];
+	uint64_t mix[RLE_PTYPE_CLASSES_NR];
+	uint64_t best_omitted = 0;
+	uint8_t best;
+	int status = 1;
+	size_t i;
+	size_t c;
+
+	if (implicit_protocol_type == NULL ||
+	    rle_transmitter_stats_get_ptype_mix(transmitter, mix) != 0) {
+		goto error;
+	}
+	if (transmitter->conf.allow_ptype_omission == 0) {
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "no implicit protocol type suggested since its omission is not allowed");
+		goto error;
+	}
+
+	best = transmitter->conf.implicit_protocol_type;
+	for (i = 0; i < candidates_nr; i++) {
+		omitted[i] = 0;
+		for (c = 0; c < RLE_PTYPE_CLASSES_NR; c++) {
+			if (candidates[i].classes & (1U << c)) {
+				omitted[i] += mix[c];
+			}
+		}
+		if (candidates[i].comp_ptype == best) {
+			best_omitted = omitted[i];
+		}
+	}
+
+	/* the current implicit protocol type is kept unless another one omits more */
+	for (i = 0; i < candidates_nr; i++) {
+		if (omitted[i] > best_omitted) {
+			best = candidates[i].comp_ptype;
+			best_omitted = omitted[i];
+		}
+	}
+
+	*implicit_protocol_type = best;
+	status = 0;
+
+error:
+	return status;
+}
+
+int rle_transmitter_set_log_sink(struct rle_transmitter *const transmitter,
+                                 const struct rle_log_sink *const sink)
+{
+	if (transmitter == NULL || (sink != NULL && sink->callback == NULL)) {
+		return 1;
+	}
+
+	/* the sink is complete before the transmitter, on any thread, loads it */
+	__atomic_store_n(&transmitter->log_sink, sink, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+int rle_transmitter_set_implicit_ptype(struct rle_transmitter *const transmitter,
+                                       const uint8_t implicit_protocol_type)
+{
+	struct rle_config conf;
+	size_t i;
+	int status = 1;
+
+	if (transmitter == NULL) {
+		goto error;
+	}
+	if (transmitter->conf.allow_ptype_omission == 0) {
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "implicit protocol type not changed since its omission is not allowed");
+		goto error;
+	}
+	for (i = 0; i < transmitter->contexts_nr; i++) {
+		if (!rle_ctx_is_free(transmitter->free_ctx, i)) {
+			RLE_ERR_TO(&transmitter->log_sink,
+			           "implicit protocol type not changed while context with ID %zu "
+			           "is in use", i);
+			goto error;
+		}
+	}
+	if (rle_tx_pipe_get_size(transmitter->pipe) != 0) {
+		/* the ALPDUs of the pipe are encapsulated with the previous implicit protocol type */
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "implicit protocol type not changed while %zu ALPDUs are in the pipe",
+		           rle_tx_pipe_get_size(transmitter->pipe));
+		goto error;
+	}
 
+	if (!rle_ptype_is_adaptive_implicit(implicit_protocol_type)) {
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "invalid implicit protocol type 0x%02x", implicit_protocol_type);
+		goto error;
+	}
+	memcpy(&conf, &transmitter->conf, sizeof(struct rle_config));
+	conf.implicit_protocol_type = implicit_protocol_type;
 
-/*------------------------------------------------------------------------------------------------*/
-/*------------------------------------- PRIVATE FUNCTIONS ----------------------------------------*/
-/*------------------------------------------------------------------------------------------------*/
+	/* the table is left untouched if it cannot be built */
+	{
+		struct rle_ptype_table ptype_table;
 
-/**
- * @brief          Check if a transmitter queue context is valid and extract it.
- *
- * @param[in]      transmitter              The transmitter with the context to extract.
- * @param[in]      fragment_id              The fragment ID linked to the context to extract.
- * @param[out]     ctx_man                  The extracted context.
- *
- * @return         0 if OK, else 1.
- */
-static int get_transmitter_context(const struct rle_transmitter *const transmitter,
-                                   const uint8_t fragment_id,
-                                   const struct rle_ctx_mngt **const ctx_man);
+		if (!rle_ptype_table_init(&ptype_table, &conf)) {
+			RLE_ERR_TO(&transmitter->log_sink,
+			           "failed to build the protocol type table");
+			goto error;
+		}
+		memcpy(&transmitter->ptype_table, &ptype_table, sizeof(struct rle_ptype_table));
+	}
+	transmitter->conf.implicit_protocol_type = implicit_protocol_type;
+	rle_transmitter_stats_reset_ptype_mix(transmitter);
+	RLE_DEBUG_TO(&transmitter->log_sink,
+	             "implicit protocol type 0x%02x from now on", implicit_protocol_type);
 
+	status = 0;
 
-/*------------------------------------------------------------------------------------------------*/
-/*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
-/*------------------------------------------------------------------------------------------------*/
+error:
+	return status;
+}
 
-static int get_transmitter_context(const struct rle_transmitter *const transmitter,
-                                   const uint8_t fragment_id,
-                                   const struct rle_ctx_mngt **const ctx_man)
+int rle_transmitter_set_protection_policy(struct rle_transmitter *const transmitter,
+                                          const struct rle_protection_policy *const policy)
 {
 	int status = 1;
 
-	assert(ctx_man != NULL);
+	if (transmitter == NULL) {
+		goto out;
+	}
 
-	if (transmitter == NULL || fragment_id >= RLE_MAX_FRAG_NUMBER) {
-		/* Out of bound */
-		goto error;
+	if (policy == NULL) {
+		transmitter->protection_auto = false;
+		transmitter->push_ppdu_hdr = push_ppdu_hdr_select(&transmitter->conf);
+		RLE_DEBUG_TO(&transmitter->log_sink, "ALPDU protection from the configuration");
+		status = 0;
+		goto out;
 	}
 
-	*ctx_man = &transmitter->rle_ctx_man[fragment_id];
+	if (transmitter->conf.allow_alpdu_crc == 0 ||
+	    transmitter->conf.allow_alpdu_sequence_number == 0) {
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "ALPDU protection not chosen per SDU since the CRC and the sequence number "
+		           "are not both allowed");
+		goto out;
+	}
+	if (policy->burst_size <= sizeof(rle_ppdu_hdr_start_t)) {
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "expected burst size of %zu bytes too small for any PPDU START",
+		           policy->burst_size);
+		goto out;
+	}
+
+	/* the SDUs already encapsulated keep the trailer chosen for them in their buffers */
+	memcpy(&transmitter->protection, policy, sizeof(struct rle_protection_policy));
+	transmitter->protection_auto = true;
+	transmitter->push_ppdu_hdr = push_ppdu_hdr_auto;
+	RLE_DEBUG_TO(&transmitter->log_sink,
+	             "ALPDU protection per SDU: bursts of %zu bytes, seqnum up to %zu PPDUs and "
+	             "%u ppm of SDU loss", policy->burst_size, policy->seqnum_ppdus_max,
+	             policy->sdu_loss_ppm_max);
 
 	status = 0;
 
-error:
+out:
 	return status;
 }
 
-static void set_free_frag_ctx(struct rle_transmitter *const _this, const size_t ctx_index)
+bool rle_transmitter_pick_free_context(const struct rle_transmitter *const _this,
+                                       const uint8_t traffic_class,
+                                       uint8_t *const fragment_id)
 {
-	rle_ctx_set_free(&_this->free_ctx, ctx_index);
-}
+	const uint8_t frag_ids = _this->classes[traffic_class].frag_ids;
+	const uint8_t free_frag_ids = (uint8_t)~_this->free_ctx & frag_ids;
+	uint8_t busy_frag_ids;
 
+	if (free_frag_ids != 0) {
+		*fragment_id = (uint8_t)__builtin_ctz(free_frag_ids);
+		return true;
+	}
 
-/*------------------------------------------------------------------------------------------------*/
-/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
-/*------------------------------------------------------------------------------------------------*/
+	/* all the contexts of the class are busy, look for room in their queues */
+	for (busy_frag_ids = frag_ids; busy_frag_ids != 0; busy_frag_ids &= busy_frag_ids - 1) {
+		const uint8_t frag_id = (uint8_t)__builtin_ctz(busy_frag_ids);
 
-struct rle_transmitter * rle_transmitter_new(const struct rle_config *const conf)
+		if (rle_transmitter_queue_tail(_this, frag_id) != NULL) {
+			*fragment_id = frag_id;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool rle_transmitter_pick_next_context(struct rle_transmitter *const _this,
+                                       uint8_t *const fragment_id)
 {
-	struct rle_transmitter *transmitter = NULL;
+	bool picked = false;
 	size_t i;
 
-	if (!rle_config_check(conf)) {
-		RLE_ERR("failed to created RLE transmitter: invalid configuration");
-		goto error;
+	if (_this->free_ctx == 0) {
+		goto out;
 	}
 
-	transmitter = (struct rle_transmitter *)MALLOC(sizeof(struct rle_transmitter));
-	if (!transmitter) {
-		RLE_ERR("allocating transmitter module failed\n");
-		goto error;
+	/* strict priority classes first, in class order */
+	for (i = 0; i < RLE_TRAFFIC_CLASSES_NR; i++) {
+		if (_this->classes[i].weight == 0 && pick_class_context(_this, i, fragment_id)) {
+			picked = true;
+			goto out;
+		}
 	}
 
-	/* initialize fragmentation contexts */
-	memset(transmitter->rle_ctx_man, 0, RLE_MAX_FRAG_NUMBER * sizeof(struct rle_ctx_mngt));
-	for (i = 0; i < RLE_MAX_FRAG_NUMBER; ++i) {
-		struct rle_ctx_mngt *const ctx_man = &transmitter->rle_ctx_man[i];
-		if (rle_ctx_init_frag_buf(ctx_man) != C_OK) {
-			RLE_ERR("failed to allocate memory for frag context with ID %zu", i);
-			goto free_ctxts;
+	/* then weighted round robin between the other classes, the class being served keeps the
+	 * link until its credit is spent or it has nothing to send */
+	for (i = 0; i <= RLE_TRAFFIC_CLASSES_NR; i++) {
+		const uint8_t tc = _this->wrr_class;
+
+		if (_this->classes[tc].weight != 0 && _this->wrr_credit == 0) {
+			_this->wrr_credit = _this->classes[tc].weight;
 		}
-		ctx_man->frag_id = i;
-		rle_ctx_set_seq_nb(ctx_man, 0);
+		if (_this->classes[tc].weight != 0 && pick_class_context(_this, tc, fragment_id)) {
+			_this->wrr_credit--;
+			if (_this->wrr_credit == 0) {
+				_this->wrr_class = (tc + 1) % RLE_TRAFFIC_CLASSES_NR;
+			}
+			picked = true;
+			goto out;
+		}
+		_this->wrr_class = (tc + 1) % RLE_TRAFFIC_CLASSES_NR;
+		_this->wrr_credit = 0;
 	}
 
-	transmitter->free_ctx = 0;
-
-	memcpy(&transmitter->conf, conf, sizeof(struct rle_config));
+out:
+	return picked;
+}
 
-	return transmitter;
+rle_frag_buf_t ** rle_transmitter_queue_tail(const struct rle_transmitter *const _this,
+                                             const uint8_t fragment_id)
+{
+	const struct rle_tx_queue *const queue = &_this->queues[fragment_id];
 
-free_ctxts:
-	for (i = 0; i < RLE_MAX_FRAG_NUMBER; ++i) {
-		struct rle_ctx_mngt *const ctx_man = &transmitter->rle_ctx_man[i];
-		if (ctx_man->buff != NULL) {
-			rle_ctx_destroy_frag_buf(ctx_man);
-		}
+	if (queue->nr == queue->depth) {
+		return NULL;
 	}
-	FREE(transmitter);
-error:
-	return NULL;
+
+	return &queue->slots[(queue->head + queue->nr) % queue->depth];
 }
 
-void rle_transmitter_destroy(struct rle_transmitter **const transmitter)
+void rle_transmitter_queue_push(struct rle_transmitter *const _this, const uint8_t fragment_id)
 {
-	size_t i;
+	struct rle_tx_queue *const queue = &_this->queues[fragment_id];
 
-	if (!transmitter) {
-		goto exit_label;
+	assert(queue->nr < queue->depth);
+	queue->nr++;
+}
+
+void rle_transmitter_backlog_update(struct rle_transmitter *const _this,
+                                    const uint8_t fragment_id,
+                                    const size_t old_len,
+                                    const size_t new_len)
+{
+	/* unsigned arithmetic wraps around, the sums are right once all the changes are added */
+	const size_t alpdu_bytes = new_len - old_len;
+	const size_t alpdus_nr = (size_t)(new_len != 0) - (size_t)(old_len != 0);
+
+	backlog_add(&_this->backlogs[fragment_id], alpdu_bytes, alpdus_nr);
+	backlog_add(&_this->classes[get_context_class(_this, fragment_id)].backlog, alpdu_bytes,
+	            alpdus_nr);
+	backlog_add(&_this->backlog, alpdu_bytes, alpdus_nr);
+}
+
+int rle_transmitter_set_queue_depth(struct rle_transmitter *const transmitter,
+                                    const uint8_t fragment_id,
+                                    const size_t depth)
+{
+	int status = 1;
+	struct rle_tx_queue *queue;
+	struct rle_tx_queue new_queue = { .slots = NULL, .depth = 0, .head = 0, .nr = 0 };
+
+	if (transmitter == NULL || fragment_id >= transmitter->contexts_nr) {
+		goto error;
 	}
+	queue = &transmitter->queues[fragment_id];
 
-	if (!*transmitter) {
-		/* Transmitter already NULL, nothing to do. */
-		goto exit_label;
+	if (queue->nr != 0) {
+		RLE_ERR_TO(&transmitter->log_sink,
+		           "queue of context with ID %u still holds %zu SDUs", fragment_id,
+		           queue->nr);
+		goto error;
 	}
 
-	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
-		struct rle_ctx_mngt *const ctx_man = &(*transmitter)->rle_ctx_man[i];
+	if (depth > 0) {
+		new_queue.slots = (rle_frag_buf_t **)rle_alloc(&transmitter->allocator,
+		                                               depth * sizeof(rle_frag_buf_t *));
+		if (new_queue.slots == NULL) {
+			RLE_ERR_TO(&transmitter->log_sink,
+			           "failed to allocate the queue of context with ID %u",
+			           fragment_id);
+			goto error;
+		}
+		/* the buffers of the ring are allocated when SDUs are queued, sized for them */
+		memset(new_queue.slots, 0, depth * sizeof(rle_frag_buf_t *));
+		new_queue.depth = depth;
+	}
 
-		rle_ctx_destroy_frag_buf(ctx_man);
+	/* in real-time mode, they are sized for any SDU up front */
+	if (transmitter->conf.realtime) {
+		size_t i;
+
+		for (i = 0; i < new_queue.depth; i++) {
+			if (frag_buf_reserve(&new_queue.slots[i], RLE_MAX_PDU_SIZE,
+			                     &transmitter->allocator)) {
+				RLE_ERR_TO(&transmitter->log_sink,
+				           "failed to reserve the queue of context with ID %u", fragment_id);
+				tx_queue_destroy(&new_queue, &transmitter->allocator);
+				goto error;
+			}
+		}
 	}
 
-	FREE(*transmitter);
-	*transmitter = NULL;
+	tx_queue_destroy(queue, &transmitter->allocator);
+	*queue = new_queue;
 
-exit_label:
+	status = 0;
 
-	return;
+error:
+	return status;
 }
 
-void rle_transmitter_free_context(struct rle_transmitter *const _this, const uint8_t fragment_id)
+size_t rle_transmitter_stats_get_queued_sdus(const struct rle_transmitter *const transmitter,
+                                             const uint8_t fragment_id)
 {
-	/* set to idle this fragmentation context */
-	set_free_frag_ctx(_this, fragment_id);
+	if (transmitter == NULL || fragment_id >= transmitter->contexts_nr) {
+		return 0;
+	}
+
+	return transmitter->queues[fragment_id].nr;
 }
 
 size_t rle_transmitter_stats_get_queue_size(const struct rle_transmitter *const transmitter,
                                             const uint8_t fragment_id)
 {
 	const struct rle_ctx_mngt *ctx_man = NULL;
-	const rle_frag_buf_t *frag_buf = NULL;
 	size_t stat;
 
 	if (get_transmitter_context(transmitter, fragment_id, &ctx_man)) {
@@ -197,17 +1109,52 @@ size_t rle_transmitter_stats_get_queue_size(const struct rle_transmitter *const
 		goto error;
 	}
 
-	if (rle_ctx_is_free(transmitter->free_ctx, fragment_id)) {
-		stat = 0;
-	} else {
-		frag_buf = (rle_frag_buf_t *)ctx_man->buff;
-		stat = frag_buf_get_remaining_alpdu_length(frag_buf);
-	}
+	/* the ALPDUs queued behind the current one are waiting too */
+	stat = __atomic_load_n(&transmitter->backlogs[fragment_id].alpdu_bytes, __ATOMIC_RELAXED);
 
 error:
 	return stat;
 }
 
+int rle_transmitter_stats_get_backlog(const struct rle_transmitter *const transmitter,
+                                      const uint8_t traffic_class,
+                                      const size_t burst_size,
+                                      struct rle_transmitter_backlog *const backlog)
+{
+	const struct rle_tx_backlog *tx_backlog;
+	size_t trailer_len;
+	uint64_t fragmented_nr;
+	int status = 1;
+
+	if (transmitter == NULL || traffic_class > RLE_TRAFFIC_CLASSES_NR ||
+	    burst_size <= sizeof(rle_ppdu_hdr_start_t) || backlog == NULL) {
+		goto error;
+	}
+
+	tx_backlog = (traffic_class == RLE_TRAFFIC_CLASSES_NR ? &transmitter->backlog :
+	              &transmitter->classes[traffic_class].backlog);
+	backlog->alpdu_bytes = __atomic_load_n(&tx_backlog->alpdu_bytes, __ATOMIC_RELAXED);
+	backlog->alpdus_nr = __atomic_load_n(&tx_backlog->alpdus_nr, __ATOMIC_RELAXED);
+
+	/* a PPDU per ALPDU, and one more per burst of payload, up to one per fragmented ALPDU */
+	backlog->ppdus_nr = backlog->alpdus_nr +
+	                    backlog->alpdu_bytes / (burst_size - sizeof(rle_ppdu_hdr_cont_end_t));
+	fragmented_nr = backlog->ppdus_nr - backlog->alpdus_nr;
+	if (fragmented_nr > backlog->alpdus_nr) {
+		fragmented_nr = backlog->alpdus_nr;
+	}
+	trailer_len = (transmitter->conf.allow_alpdu_crc ? RLE_CRC_SIZE : RLE_SEQ_NO_FIELD_SIZE);
+	backlog->ppdu_bytes = backlog->alpdu_bytes +
+	                      backlog->ppdus_nr * sizeof(rle_ppdu_hdr_cont_end_t) +
+	                      fragmented_nr * (sizeof(rle_ppdu_hdr_start_t) -
+	                                       sizeof(rle_ppdu_hdr_cont_end_t) + trailer_len);
+
+	status = 0;
+
+error:
+	return status;
+}
+
 uint64_t rle_transmitter_stats_get_counter_sdus_in(const struct rle_transmitter *const transmitter,
                                                    const uint8_t fragment_id)
 {
@@ -339,6 +1286,59 @@ error:
 	return status;
 }
 
+int rle_transmitter_stats_get_all_counters(const struct rle_transmitter *const transmitter,
+                                           struct rle_transmitter_stats stats[RLE_MAX_FRAG_NUMBER],
+                                           struct rle_transmitter_stats *const total)
+{
+	int status = 1;
+	size_t i;
+
+	if (transmitter == NULL || (stats == NULL && total == NULL)) {
+		goto error;
+	}
+
+	if (total != NULL) {
+		memset(total, 0, sizeof(struct rle_transmitter_stats));
+	}
+
+	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
+		const struct rle_ctx_mngt *const ctx_man = &transmitter->rle_ctx_man[i];
+		struct rle_transmitter_stats ctx_stats;
+
+		/* the contexts that do not exist have nothing to count */
+		if (i >= transmitter->contexts_nr) {
+			if (stats != NULL) {
+				memset(&stats[i], 0, sizeof(struct rle_transmitter_stats));
+			}
+			continue;
+		}
+
+		ctx_stats.sdus_in = rle_ctx_get_counter_in(ctx_man);
+		ctx_stats.sdus_sent = rle_ctx_get_counter_ok(ctx_man);
+		ctx_stats.sdus_dropped = rle_ctx_get_counter_dropped(ctx_man);
+		ctx_stats.bytes_in = rle_ctx_get_counter_bytes_in(ctx_man);
+		ctx_stats.bytes_sent = rle_ctx_get_counter_bytes_ok(ctx_man);
+		ctx_stats.bytes_dropped = rle_ctx_get_counter_bytes_dropped(ctx_man);
+
+		if (stats != NULL) {
+			stats[i] = ctx_stats;
+		}
+		if (total != NULL) {
+			total->sdus_in += ctx_stats.sdus_in;
+			total->sdus_sent += ctx_stats.sdus_sent;
+			total->sdus_dropped += ctx_stats.sdus_dropped;
+			total->bytes_in += ctx_stats.bytes_in;
+			total->bytes_sent += ctx_stats.bytes_sent;
+			total->bytes_dropped += ctx_stats.bytes_dropped;
+		}
+	}
+
+	status = 0;
+
+error:
+	return status;
+}
+
 void rle_transmitter_stats_reset_counters(struct rle_transmitter *const transmitter,
                                           const uint8_t fragment_id)
 {
@@ -355,3 +1355,171 @@ error:
 
 	return;
 }
+
+int rle_transmitter_stats_fetch_and_reset(struct rle_transmitter *const transmitter,
+                                          struct rle_transmitter_stats stats[RLE_MAX_FRAG_NUMBER],
+                                          struct rle_transmitter_stats *const total)
+{
+	int status = 1;
+	size_t i;
+
+	if (transmitter == NULL || (stats == NULL && total == NULL)) {
+		goto error;
+	}
+
+	if (total != NULL) {
+		memset(total, 0, sizeof(struct rle_transmitter_stats));
+	}
+
+	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
+		struct link_counters counters;
+
+		/* the contexts that do not exist have nothing to count */
+		if (i >= transmitter->contexts_nr) {
+			if (stats != NULL) {
+				memset(&stats[i], 0, sizeof(struct rle_transmitter_stats));
+			}
+			continue;
+		}
+
+		rle_ctx_fetch_reset_counters(&transmitter->rle_ctx_man[i], &counters);
+
+		if (stats != NULL) {
+			stats[i].sdus_in = counters.counter_in;
+			stats[i].sdus_sent = counters.counter_ok;
+			stats[i].sdus_dropped = counters.counter_dropped;
+			stats[i].bytes_in = counters.counter_bytes_in;
+			stats[i].bytes_sent = counters.counter_bytes_ok;
+			stats[i].bytes_dropped = counters.counter_bytes_dropped;
+		}
+		if (total != NULL) {
+			total->sdus_in += counters.counter_in;
+			total->sdus_sent += counters.counter_ok;
+			total->sdus_dropped += counters.counter_dropped;
+			total->bytes_in += counters.counter_bytes_in;
+			total->bytes_sent += counters.counter_bytes_ok;
+			total->bytes_dropped += counters.counter_bytes_dropped;
+		}
+	}
+
+	status = 0;
+
+error:
+	return status;
+}
+
+int rle_transmitter_stats_get_ptype_mix(const struct rle_transmitter *const transmitter,
+                                        uint64_t mix[RLE_PTYPE_CLASSES_NR])
+{
+	size_t i;
+	int status = 1;
+
+	if (transmitter == NULL || mix == NULL) {
+		goto error;
+	}
+
+	for (i = 0; i < RLE_PTYPE_CLASSES_NR; i++) {
+		mix[i] = __atomic_load_n(&transmitter->ptype_mix[i], __ATOMIC_RELAXED);
+	}
+
+	status = 0;
+
+error:
+	return status;
+}
+
+void rle_transmitter_stats_reset_ptype_mix(struct rle_transmitter *const transmitter)
+{
+	size_t i;
+
+	if (transmitter == NULL) {
+		goto error;
+	}
+
+	for (i = 0; i < RLE_PTYPE_CLASSES_NR; i++) {
+		__atomic_store_n(&transmitter->ptype_mix[i], 0, __ATOMIC_RELAXED);
+	}
+
+error:
+	return;
+}
+
+int rle_transmitter_timing_get(const struct rle_transmitter *const transmitter,
+                               const enum rle_timing_stage stage,
+                               struct rle_timing_histogram *const histogram)
+{
+	int status = 1;
+
+	if (transmitter == NULL || histogram == NULL || stage > RLE_TIMING_PPDU_HDR) {
+		goto error;
+	}
+
+#ifdef RLE_TIMING
+	rle_timing_read(&transmitter->timing.stages[stage], histogram);
+	status = 0;
+#endif
+
+error:
+	return status;
+}
+
+void rle_transmitter_timing_reset(struct rle_transmitter *const transmitter)
+{
+#ifdef RLE_TIMING
+	if (transmitter != NULL) {
+		rle_timing_reset(&transmitter->timing);
+	}
+#else
+	(void)transmitter;
+#endif
+}
+
+int rle_transmitter_copy_stats_get(const struct rle_transmitter *const transmitter,
+                                   const enum rle_copy_stage stage,
+                                   struct rle_copy_counters *const counters)
+{
+	int status = 1;
+
+	if (transmitter == NULL || counters == NULL || stage > RLE_COPY_PACK) {
+		goto error;
+	}
+
+#ifdef RLE_COPY_STATS
+	rle_copy_read(&transmitter->copy_stats.stages[stage], counters);
+	status = 0;
+#endif
+
+error:
+	return status;
+}
+
+void rle_transmitter_copy_stats_reset(struct rle_transmitter *const transmitter)
+{
+#ifdef RLE_COPY_STATS
+	if (transmitter != NULL) {
+		rle_copy_reset(&transmitter->copy_stats);
+	}
+#else
+	(void)transmitter;
+#endif
+}
+
+int rle_transmitter_stats_get_size_histogram(const struct rle_transmitter *const transmitter,
+                                             const uint8_t fragment_id,
+                                             struct rle_size_histogram *const histogram)
+{
+	int status = 1;
+	const struct rle_ctx_mngt *ctx_man = NULL;
+
+	if (histogram == NULL || get_transmitter_context(transmitter, fragment_id, &ctx_man)) {
+		goto error;
+	}
+
+#ifdef RLE_SIZE_STATS
+	rle_size_read(&ctx_man->lk_status->size_stats.histogram, histogram);
+	status = 0;
+#endif
+
+error:
+	return status;
+}
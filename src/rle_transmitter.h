@@ -41,6 +41,8 @@
 
 #include "rle_ctx.h"
 #include "header.h"
+#include "rle_timing.h"
+#include "rle_copy_stats.h"
 
 
 /*------------------------------------------------------------------------------------------------*/
@@ -62,6 +64,37 @@ struct transmitter_link_status {
 	uint64_t counter_bytes;
 };
 
+/**
+ * Bounded ring of the SDUs waiting for a busy context of the transmitter.
+ * Each SDU is encapsulated in its own fragmentation buffer, which is swapped with the buffer of
+ * the context when the current SDU is sent, so that queued SDUs are copied only once.
+ */
+struct rle_tx_queue {
+	rle_frag_buf_t **slots;  /**< The buffers of the ring, NULL if the context has no queue */
+	size_t depth;            /**< The number of buffers of the ring                         */
+	size_t head;             /**< The index of the oldest queued SDU                        */
+	size_t nr;               /**< The number of queued SDUs                                 */
+};
+
+/**
+ * ALPDUs waiting to be fragmented, updated on each SDU and PPDU so that it is read in one go.
+ * Single writer, updated with relaxed atomic stores so that a scheduler thread reads it untorn.
+ */
+struct rle_tx_backlog {
+	size_t alpdu_bytes;  /**< The ALPDU octets left to send                                 */
+	size_t alpdus_nr;    /**< The ALPDUs with octets left to send                           */
+};
+
+/**
+ * Traffic class of the transmitter, owning a subset of its contexts.
+ */
+struct rle_tx_class {
+	uint8_t frag_ids;      /**< Bitmap of the contexts reserved to the class               */
+	uint8_t weight;        /**< PPDUs served in a row in round robin, 0 for strict priority */
+	uint8_t last_frag_id;  /**< Last context served, for round robin within the class      */
+	struct rle_tx_backlog backlog;  /**< The ALPDUs of the contexts of the class           */
+};
+
 /**
  * RLE transmitter module used
  * for encapsulation & fragmentation.
@@ -71,12 +104,51 @@ struct transmitter_link_status {
  * structure.
  * A mutex is used for synchronize
  * access to free contexts.
+ * Only the contexts of the configuration
+ * are allocated, after the module.
  *
  */
 struct rle_transmitter {
-	struct rle_ctx_mngt rle_ctx_man[RLE_MAX_FRAG_NUMBER];
 	struct rle_config conf;
+	struct rle_ptype_table ptype_table;  /**< ALPDU headers of protocol types for the conf */
+	push_ppdu_hdr_t push_ppdu_hdr;       /**< PPDU headers specialized for the conf         */
+	struct rle_tx_queue queues[RLE_MAX_FRAG_NUMBER];  /**< The SDUs waiting for each context */
+	struct rle_tx_class classes[RLE_TRAFFIC_CLASSES_NR];  /**< The traffic classes           */
+	struct rle_tx_backlog backlog;  /**< The ALPDUs of all the contexts                        */
+	struct rle_tx_backlog backlogs[RLE_MAX_FRAG_NUMBER];  /**< The ALPDUs of each context    */
+	uint8_t wrr_class;   /**< The weighted class being served                                 */
+	uint8_t wrr_credit;  /**< The PPDUs the weighted class being served may still get         */
 	uint8_t free_ctx;
+	uint8_t contexts_nr;  /**< The number of contexts, see rle_config.fragment_contexts_nr */
+	struct rle_allocator allocator;  /**< The allocator of the transmitter and its buffers  */
+	bool in_place;        /**< Whether the transmitter is in caller memory                */
+	uint64_t ptype_mix[RLE_PTYPE_CLASSES_NR];  /**< The SDUs of each class since the epoch  */
+	const struct rle_log_sink *log_sink;  /**< The log sink, NULL for the log trace callback */
+	struct rle_protection_policy protection;  /**< The protection policy, if protection_auto */
+	bool protection_auto;  /**< Whether the protection is chosen per SDU                   */
+	struct rle_tx_pipe *pipe;  /**< The pipe of the encapsulation stage, NULL if none       */
+#ifdef RLE_TIMING
+	struct rle_timing timing;  /**< The durations of the stages                           */
+#endif
+#ifdef RLE_COPY_STATS
+	struct rle_copy_stats copy_stats;  /**< The copies of the stages                      */
+#endif
+	/** The contexts, one per fragment id, followed by their counters in the same memory */
+	struct rle_ctx_mngt rle_ctx_man[];
+};
+
+
+/**
+ * @brief RLE fragmentation configuration, the parts of a transmitter the contextless
+ *        fragmentation needs, never written once created.
+ *
+ * @ingroup RLE transmitter
+ */
+struct rle_frag_conf {
+	struct rle_config conf;              /**< The RLE configuration                         */
+	struct rle_ptype_table ptype_table;  /**< ALPDU headers of protocol types for the conf */
+	push_ppdu_hdr_t push_ppdu_hdr;       /**< PPDU headers specialized for the conf         */
+	struct rle_allocator allocator;      /**< The allocator of the configuration            */
 };
 
 
@@ -100,7 +172,7 @@ int rle_transmitter_encap_data(struct rle_transmitter *_this, const struct rle_s
                                uint8_t frag_id);
 
 /**
- * @brief Set to idle the fragment context
+ * @brief Set to idle the fragment context, or go on with the next SDU of its queue if any
  *
  * @param[in,out] _this        The transmitter module to use for deencapsulation
  * @param[in]     fragment_id  Fragmentation context to use to get the PDU
@@ -109,5 +181,79 @@ int rle_transmitter_encap_data(struct rle_transmitter *_this, const struct rle_s
  */
 void rle_transmitter_free_context(struct rle_transmitter *const _this, const uint8_t fragment_id);
 
+/**
+ * @brief Choose the context of the given traffic class for a new SDU
+ *
+ * The first free context of the class is chosen, else the first one whose queue is not full.
+ *
+ * @param[in]     _this          The transmitter module
+ * @param[in]     traffic_class  The traffic class, valid
+ * @param[out]    fragment_id    The chosen context
+ *
+ * @return  true if a context is available, else false
+ *
+ * @ingroup
+ */
+bool rle_transmitter_pick_free_context(const struct rle_transmitter *const _this,
+                                       const uint8_t traffic_class,
+                                       uint8_t *const fragment_id);
+
+/**
+ * @brief Choose the context to serve next with a PPDU
+ *
+ * @param[in,out] _this        The transmitter module
+ * @param[out]    fragment_id  The chosen context
+ *
+ * @return  true if a context has ALPDU data to fragment, else false
+ *
+ * @ingroup
+ */
+bool rle_transmitter_pick_next_context(struct rle_transmitter *const _this,
+                                       uint8_t *const fragment_id);
+
+/**
+ * @brief Get the slot of the fragmentation buffer of the next SDU to queue behind a busy context
+ *
+ * The SDU is only queued once rle_transmitter_queue_push() is called. The buffer of the slot may
+ * be NULL or too small, see frag_buf_reserve().
+ *
+ * @param[in]     _this        The transmitter module
+ * @param[in]     fragment_id  The busy fragmentation context
+ *
+ * @return  The slot of the fragmentation buffer, NULL if the context has no queue or if it is full
+ *
+ * @ingroup
+ */
+rle_frag_buf_t ** rle_transmitter_queue_tail(const struct rle_transmitter *const _this,
+                                             const uint8_t fragment_id);
+
+/**
+ * @brief Queue the SDU encapsulated in the buffer given by rle_transmitter_queue_tail()
+ *
+ * @param[in,out] _this        The transmitter module
+ * @param[in]     fragment_id  The busy fragmentation context
+ *
+ * @ingroup
+ */
+void rle_transmitter_queue_push(struct rle_transmitter *const _this, const uint8_t fragment_id);
+
+/**
+ * @brief Account for the change of the ALPDU octets left to send of a SDU of a context
+ *
+ * The backlogs of the context, of its traffic class and of the transmitter are updated. A SDU
+ * is counted as an ALPDU while it has octets left to send.
+ *
+ * @param[in,out] _this        The transmitter module
+ * @param[in]     fragment_id  The context of the SDU, or of the queue it waits in
+ * @param[in]     old_len      The ALPDU octets left before, 0 for a new SDU
+ * @param[in]     new_len      The ALPDU octets left now, 0 once sent or dropped
+ *
+ * @ingroup
+ */
+void rle_transmitter_backlog_update(struct rle_transmitter *const _this,
+                                    const uint8_t fragment_id,
+                                    const size_t old_len,
+                                    const size_t new_len);
+
 
 #endif /* __RLE_TRANSMITTER_H__ */
@@ -0,0 +1,257 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_tx_pipe.c
+ * @brief  RLE transmitter pipe, handing ALPDUs over from encapsulation to fragmentation
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include "rle_tx_pipe.h"
+#include "rle_transmitter.h"
+#include "rle_ctx.h"
+#include "rle_trace.h"
+#include "rle.h"
+
+#ifndef __KERNEL__
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#else
+
+#include <linux/string.h>
+
+#endif
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PRIVATE CONSTANTS AND MACROS ---------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+#define MODULE_ID RLE_MOD_ID_TX_PIPE
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*----------------------------------- PRIVATE FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Hand the ALPDU of a slot over to its context, or behind it in its queue.
+ *
+ *                The buffer of the slot is swapped with the buffer of the context, or of the queue
+ *                slot, so that the ALPDU is not copied. The buffer given back to the slot is the
+ *                one of the previous SDU of the context, if any.
+ *
+ * @param[in,out] transmitter             The transmitter module.
+ * @param[in,out] slot                    The slot of the ALPDU.
+ *
+ * @return        true if the ALPDU is handed over, false if the context is busy and its queue full.
+ */
+static bool tx_pipe_hand_over(struct rle_transmitter *const transmitter,
+                              struct rle_tx_pipe_slot *const slot)
+{
+	struct rle_ctx_mngt *const rle_ctx = &transmitter->rle_ctx_man[slot->frag_id];
+	rle_frag_buf_t *const frag_buf = slot->frag_buf;
+	rle_frag_buf_t **frag_buf_slot;
+	const bool queued = !rle_ctx_is_free(transmitter->free_ctx, slot->frag_id);
+
+	if (queued) {
+		frag_buf_slot = rle_transmitter_queue_tail(transmitter, slot->frag_id);
+		if (frag_buf_slot == NULL) {
+			return false;
+		}
+	} else {
+		frag_buf_slot = (rle_frag_buf_t **)&rle_ctx->buff;
+	}
+
+	slot->frag_buf = *frag_buf_slot;
+	*frag_buf_slot = frag_buf;
+
+	if (queued) {
+		rle_transmitter_queue_push(transmitter, slot->frag_id);
+	} else {
+		rle_ctx_set_nonfree(&transmitter->free_ctx, slot->frag_id);
+	}
+	rle_transmitter_backlog_update(transmitter, slot->frag_id, 0,
+	                               frag_buf_get_remaining_alpdu_length(frag_buf));
+
+	rle_ctx_incr_counter_in(rle_ctx);
+	rle_ctx_incr_counter_bytes_in(rle_ctx, frag_buf->sdu_info.size);
+	rle_trace(sdu_enqueued, slot->frag_id, frag_buf->sdu_info.size,
+	          frag_buf->sdu_info.protocol_type);
+
+	return true;
+}
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+struct rle_tx_pipe * rle_tx_pipe_new(struct rle_transmitter *const transmitter,
+                                     const size_t depth)
+{
+	struct rle_tx_pipe *pipe = NULL;
+
+	if (transmitter == NULL) {
+		RLE_ERR("failed to created RLE transmitter pipe: NULL transmitter");
+		goto error;
+	}
+
+	if (transmitter->pipe != NULL) {
+		RLE_ERR("failed to created RLE transmitter pipe: the transmitter already has one");
+		goto error;
+	}
+
+	if (depth < 2 || depth > RLE_TX_PIPE_MAX_DEPTH || (depth & (depth - 1)) != 0) {
+		RLE_ERR("failed to created RLE transmitter pipe: depth %zu is not a power of 2 from 2 "
+		        "to %u", depth, RLE_TX_PIPE_MAX_DEPTH);
+		goto error;
+	}
+
+	/* the buffers exchanged with the contexts are all allocated as the ones of the contexts */
+	pipe = (struct rle_tx_pipe *)rle_alloc(&transmitter->allocator, sizeof(struct rle_tx_pipe));
+	if (!pipe) {
+		RLE_ERR("allocating transmitter pipe failed");
+		goto error;
+	}
+	pipe->allocator = transmitter->allocator;
+
+	pipe->slots = (struct rle_tx_pipe_slot *)
+	              rle_alloc(&pipe->allocator, depth * sizeof(struct rle_tx_pipe_slot));
+	if (!pipe->slots) {
+		RLE_ERR("allocating ring of %zu ALPDUs failed", depth);
+		goto free_pipe;
+	}
+	memset(pipe->slots, 0, depth * sizeof(struct rle_tx_pipe_slot));
+
+	pipe->transmitter = transmitter;
+	pipe->slots_mask = depth - 1;
+	pipe->tail = 0;
+	pipe->head = 0;
+
+	/* in real-time mode, the buffers exchanged with the contexts are sized for any SDU up front */
+	if (transmitter->conf.realtime) {
+		size_t i;
+
+		for (i = 0; i < depth; i++) {
+			if (frag_buf_reserve(&pipe->slots[i].frag_buf, RLE_MAX_PDU_SIZE,
+			                     &pipe->allocator)) {
+				RLE_ERR("failed to reserve the buffers of the ring of %zu ALPDUs", depth);
+				rle_tx_pipe_destroy(&pipe);
+				goto error;
+			}
+		}
+	}
+
+	/* the transmitter refuses an epoch change while ALPDUs wait in its pipe */
+	transmitter->pipe = pipe;
+
+	return pipe;
+
+free_pipe:
+	rle_free(&transmitter->allocator, pipe);
+error:
+	return NULL;
+}
+
+void rle_tx_pipe_destroy(struct rle_tx_pipe **const pipe)
+{
+	struct rle_allocator allocator;
+	size_t i;
+
+	if (!pipe || !*pipe) {
+		/* Nothing to do. */
+		goto out;
+	}
+
+	/* the ALPDUs not handed over yet are dropped with their buffers */
+	for (i = 0; i <= (*pipe)->slots_mask; i++) {
+		if ((*pipe)->slots[i].frag_buf != NULL) {
+			rle_frag_buf_del(&(*pipe)->slots[i].frag_buf);
+		}
+	}
+
+	if ((*pipe)->transmitter->pipe == *pipe) {
+		(*pipe)->transmitter->pipe = NULL;
+	}
+
+	/* the allocator is read before it is released with the pipe */
+	allocator = (*pipe)->allocator;
+	rle_free(&allocator, (*pipe)->slots);
+	rle_free(&allocator, *pipe);
+	*pipe = NULL;
+
+out:
+	return;
+}
+
+size_t rle_tx_pipe_dispatch(struct rle_tx_pipe *const pipe)
+{
+	size_t dispatched_nr = 0;
+	size_t head;
+	size_t tail;
+
+	if (pipe == NULL) {
+		goto out;
+	}
+
+	/* the ALPDUs up to the tail are complete once the tail is seen */
+	head = pipe->head;
+	tail = __atomic_load_n(&pipe->tail, __ATOMIC_ACQUIRE);
+
+	/* the ALPDUs keep their order: the first one whose context cannot take it stops the others */
+	while (head != tail &&
+	       tx_pipe_hand_over(pipe->transmitter, &pipe->slots[head & pipe->slots_mask])) {
+		head++;
+		dispatched_nr++;
+	}
+
+	if (dispatched_nr > 0) {
+		/* the slots, and the buffers swapped in them, go back to the encapsulation stage */
+		__atomic_store_n(&pipe->head, head, __ATOMIC_RELEASE);
+		RLE_DEBUG_TO(&pipe->transmitter->log_sink,
+		             "%zu ALPDUs dispatched from the pipe, %zu still waiting",
+		             dispatched_nr, tail - head);
+	}
+
+out:
+	return dispatched_nr;
+}
+
+size_t rle_tx_pipe_get_size(const struct rle_tx_pipe *const pipe)
+{
+	size_t head;
+	size_t tail;
+
+	if (pipe == NULL) {
+		return 0;
+	}
+
+	/* either stage may ask, the head is loaded first so that it is never ahead of the tail */
+	head = __atomic_load_n(&pipe->head, __ATOMIC_ACQUIRE);
+	tail = __atomic_load_n(&pipe->tail, __ATOMIC_ACQUIRE);
+
+	return (tail - head);
+}
@@ -0,0 +1,89 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   rle_tx_pipe.h
+ * @brief  Definition of the RLE transmitter pipe, handing ALPDUs over from encapsulation to
+ *         fragmentation
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#ifndef __RLE_TX_PIPE_H__
+#define __RLE_TX_PIPE_H__
+
+#ifndef __KERNEL__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#else
+
+#include <linux/stddef.h>
+#include <linux/types.h>
+
+#endif
+
+#include "rle.h"
+#include "constants.h"
+#include "fragmentation_buffer.h"
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief Slot of the transmitter pipe, an ALPDU and the context it goes to.
+ *
+ * @ingroup RLE transmitter
+ */
+struct rle_tx_pipe_slot {
+	rle_frag_buf_t *frag_buf;  /**< The buffer of the ALPDU, NULL until first used */
+	uint8_t frag_id;           /**< The context the ALPDU goes to                  */
+};
+
+/**
+ * @brief RLE transmitter pipe, a single-producer single-consumer ring of ALPDUs.
+ *
+ *        The slots from head to tail belong to the fragmentation stage, the others to the
+ *        encapsulation stage. Each stage only writes its own index: the tail is stored with
+ *        release semantics once the ALPDU of its slot is complete, and loaded with acquire
+ *        semantics before the slot is read; the head likewise once the slot is given back. The
+ *        indexes run freely, their difference is the number of ALPDUs in the pipe.
+ *
+ * @ingroup RLE transmitter
+ */
+struct rle_tx_pipe {
+	struct rle_transmitter *transmitter;  /**< The transmitter of the contexts          */
+	struct rle_tx_pipe_slot *slots;       /**< The ring of ALPDUs                       */
+	size_t slots_mask;                    /**< The number of slots minus one            */
+	struct rle_allocator allocator;       /**< The allocator of the pipe                */
+	/** Padding, so that the tail shares no cache line with the read-mostly fields */
+	unsigned char tail_pad[RLE_CACHE_LINE_SIZE];
+	size_t tail;                          /**< The next slot to fill, by encapsulation  */
+	/** Padding, so that the indexes of the two stages share no cache line */
+	unsigned char head_pad[RLE_CACHE_LINE_SIZE];
+	size_t head;                          /**< The next slot to drain, by fragmentation */
+};
+
+
+#endif /* __RLE_TX_PIPE_H__ */
@@ -33,6 +33,7 @@
 #include "fragmentation_buffer.h"
 #include "rle_ctx.h"
 #include "rle_header_proto_type_field.h"
+#include "rle_trace.h"
 #include "header.h"
 #include "crc.h"
 
@@ -65,23 +66,29 @@ uint32_t compute_crc32(const struct rle_sdu *const sdu)
 	/* CRC must be computed on PDU data and the original two bytes protocol type field whatever it
 	 * is suppressed or compressed */
 	uint32_t crc32 = 0;
-	uint16_t field_value = 0;
 	size_t length = 0;
 
 	/* first compute protocol type CRC */
-	field_value = sdu->protocol_type;
-	crc32 = compute_crc((unsigned char *)&field_value, RLE_PROTO_TYPE_FIELD_SIZE_UNCOMP,
-	                    RLE_CRC_INIT);
+	crc32 = compute_crc32_ptype(sdu->protocol_type);
 
 	/* compute SDU CRC */
 	length = sdu->size;
 	crc32 = compute_crc((unsigned char *)sdu->buffer, length, crc32);
 
-	RLE_DEBUG("PDU length %zu & protocol type 0x%x CRC %x\n", length, field_value, crc32);
+	RLE_DEBUG("PDU length %zu & protocol type 0x%x CRC %x\n", length, sdu->protocol_type, crc32);
 
 	return crc32;
 }
 
+uint32_t compute_crc32_ptype(const uint16_t protocol_type)
+{
+	/* CRC is computed on the protocol type field as stored in memory */
+	const uint16_t field_value = protocol_type;
+
+	return compute_crc((const unsigned char *)&field_value, RLE_PROTO_TYPE_FIELD_SIZE_UNCOMP,
+	                   RLE_CRC_INIT);
+}
+
 
 /*------------------------------------------------------------------------------------------------*/
 /*------------------------------------- PUBLIC FUNCTIONS CODE-------------------------------------*/
@@ -94,27 +101,37 @@ int push_alpdu_trailer(struct rle_frag_buf *const frag_buf,
 	int status = 1;
 	const bool use_alpdu_crc =
 		(rle_conf->allow_alpdu_sequence_number ? 0 : rle_conf->allow_alpdu_crc);
-	size_t alpdu_trailer_len;
-
-	rle_alpdu_trailer_t *const trailer = (rle_alpdu_trailer_t *)frag_buf->alpdu.end;
 
 	if (use_alpdu_crc) {
-		alpdu_trailer_len = sizeof(rle_alpdu_crc_trailer_t);
-		trailer->crc_trailer.crc = frag_buf->crc;
+		push_alpdu_crc_trailer(frag_buf);
 	} else {
-		uint8_t seq_no = rle_ctx_get_seq_nb(rle_ctx);
-		alpdu_trailer_len = sizeof(rle_alpdu_seqno_trailer_t);
-		trailer->seqno_trailer.seq_no = seq_no;
-		rle_ctx_incr_seq_nb(rle_ctx);
+		push_alpdu_seqno_trailer(frag_buf, rle_ctx);
 	}
 
-	frag_buf_alpdu_put(frag_buf, alpdu_trailer_len);
-
 	return status;
 }
 
+void push_alpdu_crc_trailer(struct rle_frag_buf *const frag_buf)
+{
+	rle_alpdu_trailer_t *const trailer = (rle_alpdu_trailer_t *)frag_buf->alpdu.end;
+
+	trailer->crc_trailer.crc = frag_buf->crc;
+	frag_buf_alpdu_put(frag_buf, sizeof(rle_alpdu_crc_trailer_t));
+}
+
+void push_alpdu_seqno_trailer(struct rle_frag_buf *const frag_buf,
+                              struct rle_ctx_mngt *const rle_ctx)
+{
+	rle_alpdu_trailer_t *const trailer = (rle_alpdu_trailer_t *)frag_buf->alpdu.end;
+
+	trailer->seqno_trailer.seq_no = rle_ctx_get_seq_nb(rle_ctx);
+	rle_ctx_incr_seq_nb(rle_ctx);
+	frag_buf_alpdu_put(frag_buf, sizeof(rle_alpdu_seqno_trailer_t));
+}
+
 int check_alpdu_trailer(const rle_alpdu_trailer_t *const trailer,
                         const struct rle_sdu *const reassembled_sdu,
+                        const uint32_t *const sdu_crc,
                         struct rle_ctx_mngt *const rle_ctx,
                         bool *const is_ctx_seqnum_init,
                         size_t *const lost_packets)
@@ -125,7 +142,7 @@ int check_alpdu_trailer(const rle_alpdu_trailer_t *const trailer,
 	*lost_packets = 0;
 
 	if (use_alpdu_crc) {
-		const uint32_t expected_crc = compute_crc32(reassembled_sdu);
+		const uint32_t expected_crc = sdu_crc ? *sdu_crc : compute_crc32(reassembled_sdu);
 		RLE_DEBUG("check CRC for %zu-byte SDU of protocol 0x%02x: 0x%08x received, "
 		          "0x%08x expected", reassembled_sdu->size,
 		          reassembled_sdu->protocol_type, ntohl(trailer->crc_trailer.crc),
@@ -137,6 +154,8 @@ int check_alpdu_trailer(const rle_alpdu_trailer_t *const trailer,
 			        expected_crc);
 			status = 1;
 			*lost_packets = 1;
+			rle_trace(crc_mismatch, rle_ctx->frag_id, reassembled_sdu->size,
+			          ntohl(trailer->crc_trailer.crc), ntohl(expected_crc));
 		}
 	} else {
 		const uint8_t received_seq_no = trailer->seqno_trailer.seq_no;
@@ -159,6 +178,8 @@ int check_alpdu_trailer(const rle_alpdu_trailer_t *const trailer,
 					                RLE_MAX_SEQ_NO;
 					RLE_ERR("sequence number inconsistency: received %u, "
 					        "expected %u", received_seq_no, next_seq_no);
+					rle_trace(seqnum_loss, rle_ctx->frag_id, received_seq_no,
+					          next_seq_no, *lost_packets);
 				} else {
 					RLE_WARN("sequence number null, supposing relog: received "
 					         "%u, expected %u", received_seq_no, next_seq_no);
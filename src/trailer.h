@@ -84,12 +84,36 @@ int push_alpdu_trailer(struct rle_frag_buf *const frag_buf,
                        const struct rle_config *const rle_conf,
                        struct rle_ctx_mngt *const rle_ctx);
 
+/**
+ *  @brief         put a CRC ALPDU trailer into a fragmentation buffer.
+ *
+ *
+ *  @param[in,out] frag_buf               the fragmentation buffer in use, with its CRC computed.
+ *
+ *  @ingroup RLE trailer.
+ */
+void push_alpdu_crc_trailer(struct rle_frag_buf *const frag_buf);
+
+/**
+ *  @brief         put a sequence number ALPDU trailer into a fragmentation buffer.
+ *
+ *
+ *  @param[in,out] frag_buf               the fragmentation buffer in use.
+ *  @param[in,out] rle_ctx              the RLE context for seqno.
+ *
+ *  @ingroup RLE trailer.
+ */
+void push_alpdu_seqno_trailer(struct rle_frag_buf *const frag_buf,
+                              struct rle_ctx_mngt *const rle_ctx);
+
 /**
  *  @brief         check the ALPDU trailer with its SDU.
  *
  *
  *  @param[in]     trailer              the trailer to check.
  *  @param[in]     reassembled_sdu      the reassembly buffer containing the SDU.
+ *  @param[in]     sdu_crc              the CRC already computed while reassembling the SDU, NULL
+ *                                      to compute it on the reassembled SDU.
  *  @param[in,out] rle_ctx              the RLE context.
  *  @param[out]    lost_packets         number of lost packets.
  *
@@ -97,6 +121,7 @@ int push_alpdu_trailer(struct rle_frag_buf *const frag_buf,
  */
 int check_alpdu_trailer(const rle_alpdu_trailer_t *const trailer,
                         const struct rle_sdu *const reassembled_sdu,
+                        const uint32_t *const sdu_crc,
                         struct rle_ctx_mngt *const rle_ctx,
                         bool *const is_ctx_seqnum_init,
                         size_t *const lost_packets);
@@ -112,5 +137,18 @@ int check_alpdu_trailer(const rle_alpdu_trailer_t *const trailer,
 uint32_t compute_crc32(const struct rle_sdu *const sdu)
 __attribute__((warn_unused_result, nonnull(1)));
 
+/**
+ * @brief Compute the CRC of the protocol type of an SDU, first part of the CRC ALPDU trailer
+ *
+ * The CRC may then be continued on the SDU data with compute_crc() or compute_crc_cpy().
+ *
+ * @param protocol_type  the uncompressed protocol type of the SDU
+ * @return               the CRC32 of the protocol type field
+ *
+ * @ingroup RLE trailer.
+ */
+uint32_t compute_crc32_ptype(const uint16_t protocol_type)
+__attribute__((warn_unused_result));
+
 
 #endif /* __TRAILER_H__ */
@@ -0,0 +1,235 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   fpdu_capture.c
+ * @brief  Indexed capture of FPDUs, written and read through a memory mapping.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include "fpdu_capture.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*------------------------------------ PUBLIC FUNCTIONS CODE -------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+bool fpdu_capture_create(struct fpdu_capture_writer *const writer, const char *const filename,
+                         const size_t fpdu_len_max, const uint64_t records_max)
+{
+	const size_t record_size =
+		(sizeof(struct fpdu_capture_record) + fpdu_len_max + FPDU_CAPTURE_RECORD_ALIGN - 1) /
+		FPDU_CAPTURE_RECORD_ALIGN * FPDU_CAPTURE_RECORD_ALIGN;
+	void *map;
+
+	if (fpdu_len_max > UINT16_MAX) {
+		fprintf(stderr, "FPDUs of %zu bytes cannot be recorded, %u bytes at most\n",
+		        fpdu_len_max, UINT16_MAX);
+		goto error;
+	}
+
+	writer->fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (writer->fd < 0) {
+		perror("failed to create the capture");
+		goto error;
+	}
+
+	/* the whole file is sized once, so that appending never extends it */
+	writer->map_len = FPDU_CAPTURE_HDR_SIZE + (size_t)records_max * record_size;
+	if (ftruncate(writer->fd, (off_t)writer->map_len) != 0) {
+		perror("failed to size the capture");
+		goto close;
+	}
+	map = mmap(NULL, writer->map_len, PROT_READ | PROT_WRITE, MAP_SHARED, writer->fd, 0);
+	if (map == MAP_FAILED) {
+		perror("failed to map the capture");
+		goto close;
+	}
+	writer->map = map;
+	writer->hdr = map;
+
+	memset(writer->hdr, 0, FPDU_CAPTURE_HDR_SIZE);
+	memcpy(writer->hdr->magic, FPDU_CAPTURE_MAGIC, sizeof(writer->hdr->magic));
+	writer->hdr->version = FPDU_CAPTURE_VERSION;
+	writer->hdr->record_size = (uint32_t)record_size;
+	writer->hdr->records_max = records_max;
+
+	return true;
+
+close:
+	close(writer->fd);
+error:
+	return false;
+}
+
+bool fpdu_capture_append(struct fpdu_capture_writer *const writer,
+                         const unsigned char *const fpdu, const size_t fpdu_len,
+                         const uint8_t payload_label_size, const uint32_t carrier,
+                         const uint64_t timestamp)
+{
+	const uint64_t index = writer->hdr->records_nr;
+	struct fpdu_capture_record *record;
+
+	if (index >= writer->hdr->records_max ||
+	    fpdu_len > writer->hdr->record_size - sizeof(struct fpdu_capture_record)) {
+		return false;
+	}
+
+	record = (struct fpdu_capture_record *)(writer->map + FPDU_CAPTURE_HDR_SIZE +
+	                                        index * writer->hdr->record_size);
+	record->timestamp = timestamp;
+	record->carrier = carrier;
+	record->fpdu_len = (uint16_t)fpdu_len;
+	record->payload_label_size = payload_label_size;
+	record->reserved = 0;
+	memcpy(record->fpdu, fpdu, fpdu_len);
+
+	/* published once complete, for the readers of the same mapping */
+	__atomic_store_n(&writer->hdr->records_nr, index + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+bool fpdu_capture_finish(struct fpdu_capture_writer *const writer)
+{
+	const size_t used_len =
+		FPDU_CAPTURE_HDR_SIZE + (size_t)writer->hdr->records_nr * writer->hdr->record_size;
+	bool is_ok = true;
+
+	/* the capture is kept sized for the records written only */
+	writer->hdr->records_max = writer->hdr->records_nr;
+	if (munmap(writer->map, writer->map_len) != 0) {
+		perror("failed to unmap the capture");
+		is_ok = false;
+	}
+	if (ftruncate(writer->fd, (off_t)used_len) != 0) {
+		perror("failed to truncate the capture");
+		is_ok = false;
+	}
+	if (close(writer->fd) != 0) {
+		perror("failed to close the capture");
+		is_ok = false;
+	}
+	writer->map = NULL;
+	writer->hdr = NULL;
+	writer->fd = -1;
+
+	return is_ok;
+}
+
+bool fpdu_capture_open(struct fpdu_capture_reader *const reader, const char *const filename)
+{
+	const struct fpdu_capture_hdr *hdr;
+	struct stat file_stat;
+	void *map;
+
+	reader->fd = open(filename, O_RDONLY);
+	if (reader->fd < 0) {
+		perror("failed to open the capture");
+		goto error;
+	}
+	if (fstat(reader->fd, &file_stat) != 0) {
+		perror("failed to get the size of the capture");
+		goto close;
+	}
+	if ((size_t)file_stat.st_size < FPDU_CAPTURE_HDR_SIZE) {
+		fprintf(stderr, "%s is too short for a capture\n", filename);
+		goto close;
+	}
+
+	reader->map_len = (size_t)file_stat.st_size;
+	/* private, so that decapsulating in place never writes to the file, but alters the records
+	 * in the mapping */
+	map = mmap(NULL, reader->map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE, reader->fd, 0);
+	if (map == MAP_FAILED) {
+		perror("failed to map the capture");
+		goto close;
+	}
+	reader->map = map;
+	reader->hdr = map;
+	hdr = reader->hdr;
+
+	/* the records are read in order */
+	(void)madvise(reader->map, reader->map_len, MADV_SEQUENTIAL);
+
+	if (memcmp(hdr->magic, FPDU_CAPTURE_MAGIC, sizeof(hdr->magic)) != 0 ||
+	    hdr->version != FPDU_CAPTURE_VERSION) {
+		fprintf(stderr, "%s is not a capture of version %u\n", filename,
+		        FPDU_CAPTURE_VERSION);
+		goto unmap;
+	}
+	if (hdr->record_size < sizeof(struct fpdu_capture_record) ||
+	    hdr->record_size % FPDU_CAPTURE_RECORD_ALIGN != 0 ||
+	    hdr->records_nr > hdr->records_max ||
+	    hdr->records_max > (reader->map_len - FPDU_CAPTURE_HDR_SIZE) / hdr->record_size) {
+		fprintf(stderr, "%s is a truncated or malformed capture\n", filename);
+		goto unmap;
+	}
+
+	return true;
+
+unmap:
+	munmap(reader->map, reader->map_len);
+close:
+	close(reader->fd);
+error:
+	return false;
+}
+
+bool fpdu_capture_reload(struct fpdu_capture_reader *const reader)
+{
+	void *map;
+
+	/* the private pages written since the mapping go away with it, the file is unchanged */
+	if (munmap(reader->map, reader->map_len) != 0) {
+		perror("failed to unmap the capture");
+		return false;
+	}
+	map = mmap(NULL, reader->map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE, reader->fd, 0);
+	if (map == MAP_FAILED) {
+		perror("failed to map the capture again");
+		reader->map = NULL;
+		reader->hdr = NULL;
+		return false;
+	}
+	reader->map = map;
+	reader->hdr = map;
+	(void)madvise(reader->map, reader->map_len, MADV_SEQUENTIAL);
+
+	return true;
+}
+
+void fpdu_capture_close(struct fpdu_capture_reader *const reader)
+{
+	munmap(reader->map, reader->map_len);
+	close(reader->fd);
+	reader->map = NULL;
+	reader->hdr = NULL;
+	reader->fd = -1;
+}
@@ -0,0 +1,213 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   fpdu_capture.h
+ * @brief  Indexed capture of FPDUs, written and read through a memory mapping.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ *
+ *   A capture is a header followed by records of a fixed size, so that the record n is found at
+ *   FPDU_CAPTURE_HDR_SIZE + n * record_size without reading the previous ones. Each record is a
+ *   record header followed by the FPDU, padded up to the record size. The fields are in host
+ *   byte order, the captures are meant to be replayed on the architecture that recorded them.
+ */
+
+#ifndef __FPDU_CAPTURE_H__
+#define __FPDU_CAPTURE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC CONSTANTS AND MACROS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** The magic number at the start of a capture */
+#define FPDU_CAPTURE_MAGIC         "RLEFPDUS"
+
+/** The version of the capture format */
+#define FPDU_CAPTURE_VERSION       1
+
+/** The size of the capture header, the first record follows it */
+#define FPDU_CAPTURE_HDR_SIZE      64
+
+/** The alignment of the record size, a record never shares a cache line with the next one */
+#define FPDU_CAPTURE_RECORD_ALIGN  64
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------- PUBLIC STRUCTS AND TYPEDEFS ----------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/** The header of a capture */
+struct fpdu_capture_hdr {
+	char magic[8];          /**< FPDU_CAPTURE_MAGIC, not NUL-terminated           */
+	uint32_t version;       /**< FPDU_CAPTURE_VERSION                             */
+	uint32_t record_size;   /**< The size of each record, its header included     */
+	uint64_t records_nr;    /**< The number of records written                    */
+	uint64_t records_max;   /**< The number of records the capture is sized for   */
+	uint8_t reserved[32];   /**< Zeroes, up to FPDU_CAPTURE_HDR_SIZE              */
+};
+
+/** A record of a capture */
+struct fpdu_capture_record {
+	uint64_t timestamp;          /**< The reception time of the FPDU, in nanoseconds */
+	uint32_t carrier;            /**< The carrier the FPDU was received on           */
+	uint16_t fpdu_len;           /**< The length of the FPDU, in octets              */
+	uint8_t payload_label_size;  /**< The size of the payload label of the FPDU      */
+	uint8_t reserved;            /**< Zero                                           */
+	unsigned char fpdu[];        /**< The FPDU                                       */
+};
+
+/** A capture being written */
+struct fpdu_capture_writer {
+	int fd;                        /**< The file of the capture            */
+	unsigned char *map;            /**< The mapping of the whole file      */
+	size_t map_len;                /**< The length of the mapping          */
+	struct fpdu_capture_hdr *hdr;  /**< The header, at the start of the map */
+};
+
+/** A capture being read */
+struct fpdu_capture_reader {
+	int fd;                              /**< The file of the capture            */
+	unsigned char *map;                  /**< The mapping of the whole file      */
+	size_t map_len;                      /**< The length of the mapping          */
+	const struct fpdu_capture_hdr *hdr;  /**< The header, at the start of the map */
+};
+
+
+/*------------------------------------------------------------------------------------------------*/
+/*--------------------------------------- PUBLIC FUNCTIONS ---------------------------------------*/
+/*------------------------------------------------------------------------------------------------*/
+
+/**
+ * @brief         Create a capture sized for a number of records, and map it.
+ *
+ * @param[out]    writer                   The capture being written.
+ * @param[in]     filename                 The file of the capture, truncated if it exists.
+ * @param[in]     fpdu_len_max             The length of the longest FPDU to record.
+ * @param[in]     records_max              The number of FPDUs to record at most.
+ *
+ * @return        true if OK, else false.
+ */
+bool fpdu_capture_create(struct fpdu_capture_writer *const writer, const char *const filename,
+                         const size_t fpdu_len_max, const uint64_t records_max)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Append a FPDU to a capture, in its mapping, without system call.
+ *
+ *                The record is complete before the number of records is updated, so that a
+ *                reader mapping the same file never sees a partial record.
+ *
+ * @param[in,out] writer                   The capture being written.
+ * @param[in]     fpdu                     The FPDU.
+ * @param[in]     fpdu_len                 The length of the FPDU.
+ * @param[in]     payload_label_size       The size of the payload label of the FPDU.
+ * @param[in]     carrier                  The carrier the FPDU was received on.
+ * @param[in]     timestamp                The reception time of the FPDU, in nanoseconds.
+ *
+ * @return        true if OK, false if the capture is full or the FPDU too long.
+ */
+bool fpdu_capture_append(struct fpdu_capture_writer *const writer,
+                         const unsigned char *const fpdu, const size_t fpdu_len,
+                         const uint8_t payload_label_size, const uint32_t carrier,
+                         const uint64_t timestamp)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Unmap a capture being written, and truncate it to the records written.
+ *
+ * @param[in,out] writer                   The capture being written.
+ *
+ * @return        true if OK, else false.
+ */
+bool fpdu_capture_finish(struct fpdu_capture_writer *const writer)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Open and map a capture to read its records in place.
+ *
+ *                The mapping is private and writable: rle_decapsulate_zero_copy() may rebuild
+ *                SDUs inside the FPDUs, which only copies the pages it modifies, not the file.
+ *                The records it decapsulated are altered in the mapping though, and decapsulate
+ *                to other SDUs the next time: see fpdu_capture_reload() to read them again.
+ *
+ * @param[out]    reader                   The capture being read.
+ * @param[in]     filename                 The file of the capture.
+ *
+ * @return        true if OK, false if the file is not a valid capture.
+ */
+bool fpdu_capture_open(struct fpdu_capture_reader *const reader, const char *const filename)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Map a capture being read again, as it is in the file.
+ *
+ *                The records altered in the mapping, by rle_decapsulate_zero_copy() for instance,
+ *                are restored. The records previously got from the capture are no longer valid.
+ *
+ * @param[in,out] reader                   The capture being read.
+ *
+ * @return        true if OK, else false and the capture shall only be closed.
+ */
+bool fpdu_capture_reload(struct fpdu_capture_reader *const reader)
+__attribute__((warn_unused_result));
+
+/**
+ * @brief         Unmap and close a capture being read.
+ *
+ * @param[in,out] reader                   The capture being read.
+ */
+void fpdu_capture_close(struct fpdu_capture_reader *const reader);
+
+/**
+ * @brief         Get the number of records of a capture being read.
+ *
+ * @param[in]     reader                   The capture being read.
+ *
+ * @return        The number of records.
+ */
+static inline uint64_t fpdu_capture_records_nr(const struct fpdu_capture_reader *const reader)
+{
+	return __atomic_load_n(&reader->hdr->records_nr, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief         Get a record of a capture being read, in the mapping.
+ *
+ * @param[in]     reader                   The capture being read.
+ * @param[in]     index                    The index of the record, below the number of records.
+ *
+ * @return        The record.
+ */
+static inline struct fpdu_capture_record *
+fpdu_capture_record(const struct fpdu_capture_reader *const reader, const uint64_t index)
+{
+	return (struct fpdu_capture_record *)(reader->map + FPDU_CAPTURE_HDR_SIZE +
+	                                      index * reader->hdr->record_size);
+}
+
+
+#endif /* __FPDU_CAPTURE_H__ */
@@ -147,6 +147,136 @@ bool test_decap_wrong_crc(void);
  */
 bool test_decap_interlaced_reassembly(void);
 
+/**
+ * @brief Test the receiver set with more terminals than it can hold
+ *
+ * @return        true if all SDUs are reassembled and terminals evicted, else false
+ */
+bool test_decap_receiver_set(void);
+
+/**
+ * @brief Test the zero copy decapsulation of COMPLETE PPDUs
+ *
+ * @return        true if only the SDUs of COMPLETE PPDUs without VLAN protocol type rebuilt are
+ *                left in the FPDU, else false
+ */
+bool test_decap_zero_copy(void);
+
+/**
+ * @brief         Padding check test
+ *
+ *                Check that non-zero padding octets are counted at every position of the padding,
+ *                and that the sampled and disabled checks verify fewer FPDUs.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_padding_check(void);
+
+/**
+ * @brief         Reassembly context ageing test
+ *
+ *                Check that a context whose END PPDU is lost expires after its timeout, is counted
+ *                as lost, and can reassemble the next SDU.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_ctx_ageing(void);
+
+/**
+ * @brief         Parallel decapsulation engine test
+ *
+ *                Decapsulate the interleaved FPDUs of many terminals with several workers, and
+ *                check that the SDUs of every terminal are reassembled in order.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_engine(void);
+
+/**
+ * @brief         Callback decapsulation test
+ *
+ *                Check that complete, VLAN and reassembled SDUs are delivered in order, each in
+ *                a buffer asked with its length, and that the SDUs the allocator refuses are
+ *                dropped.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_callbacks(void);
+
+/**
+ * @brief         Resumable decapsulation test
+ *
+ *                Check that a FPDU with more SDUs than SDU buffers is paused and resumed until
+ *                all its SDUs are decapsulated.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_resume(void);
+
+/**
+ * @brief         Burst decapsulation test
+ *
+ *                Check that the SDUs of a burst of FPDUs are decapsulated in order in one SDUs
+ *                array, with a status per FPDU, and that a full SDUs array drops the next FPDUs.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_burst(void);
+
+/**
+ * @brief         Wrapped decapsulation test
+ *
+ *                Check that FPDUs wrapping around the end of a ring buffer at any offset are
+ *                decapsulated as if contiguous, and fully consumed.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_wrapped(void);
+
+/**
+ * @brief         Rejection counters test
+ *
+ *                Check that the FPDUs rejected by a receiver are counted once under their reason,
+ *                and that the counters are reset.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_errors(void);
+
+/**
+ * @brief         FPDU validation test
+ *
+ *                Check that a receiver validating the FPDUs drops the FPDUs cut in a PPDU, or
+ *                holding inconsistent fragments, before any PPDU is parsed, and still reassembles
+ *                the SDUs started in a previous FPDU.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_validation(void);
+
+/**
+ * @brief         FPDU index test
+ *
+ *                Check that the PPDUs of a FPDU are described from their headers, with their
+ *                protocol types, up to a full descriptions array or a cut PPDU, after the payload
+ *                label, and that invalid parameters are refused.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_index(void);
+
+/**
+ * @brief         Streaming test
+ *
+ *                Check that the fragmented SDUs are streamed in order to the callbacks and not
+ *                reassembled, with a verdict for a valid SDU, a wrong CRC or sequence number, and
+ *                a SDU given up by a START, an expired context or the receiver destruction, and
+ *                that the streaming is not changed with a SDU in progress.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_decap_stream(void);
+
 /**
  * @brief         All the Decapsulation tests
  *
@@ -63,6 +63,68 @@ bool test_encap_too_big(void);
  */
 bool test_encap_inv_config(void);
 
+/**
+ * @brief         Zero-copy encapsulation test.
+ *
+ *                Try to encapsulate a packet without enough headroom, which must fail, then with
+ *                enough headroom and tailroom. The PPDU returned by the fragmentation must be in
+ *                the SDU memory given by the caller.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_encap_zero_copy(void);
+
+/**
+ * @brief         Scatter-gather encapsulation test.
+ *
+ *                Encapsulate a VLAN/IPv4 packet given in segments cutting its Ethernet and VLAN
+ *                headers, and compare the PPDU with the one of the same packet given contiguous.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_encap_segments(void);
+
+/**
+ * @brief         Batch encapsulation test.
+ *
+ *                Encapsulate a batch of SDUs with some failing, check the status of each SDU and
+ *                compare the PPDUs with the ones of SDUs encapsulated one by one.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_encap_batch(void);
+
+/**
+ * @brief         SDU queue test.
+ *
+ *                Encapsulate more SDUs than a context holds, check that the queue accepts them up
+ *                to its depth, then that they are all sent in order.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_encap_queue(void);
+
+/**
+ * @brief         Transmitter pipe test.
+ *
+ *                Check that a pipe refuses SDUs once full and dispatches its ALPDUs to a context
+ *                and its queue, then that SDUs encapsulated on another thread through the pipe are
+ *                all sent in order.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_encap_pipe(void);
+
+/**
+ * @brief         Compact contexts test.
+ *
+ *                Create a transmitter with a single context, check that the other ones are refused,
+ *                then that SDUs of growing sizes, current and queued, are all sent.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_encap_compact_contexts(void);
+
 /**
  * @brief         All the Encapsulation tests
  *
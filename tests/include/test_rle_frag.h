@@ -52,6 +52,38 @@ bool test_frag_too_small(void);
  */
 bool test_frag_null_context(void);
 
+/**
+ * @brief         Fragmentation test with traffic classes.
+ *
+ *                Encapsulate SDUs in the contexts of their traffic class, then check that the
+ *                strict priority class is served first and the other ones in weighted round robin.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_frag_traffic_classes(void);
+
+/**
+ * @brief         Fragmentation test of the backlog.
+ *
+ *                Encapsulate SDUs in contexts of two traffic classes, one of them queued, then
+ *                check the backlogs of the classes and of the transmitter and their PPDU
+ *                estimates, while the PPDUs are sent and when a context changes class.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_frag_backlog(void);
+
+/**
+ * @brief         Fragmentation test of a whole ALPDU in a sequence of bursts.
+ *
+ *                Fragment an ALPDU in bursts in one call, then check that its PPDUs and counters
+ *                are the ones of one rle_fragment() call per burst, and that the fragmentation
+ *                stops before a burst too small for a PPDU.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_frag_bursts(void);
+
 /**
  * @brief         Fragmentation test with real-world configurations.
  *
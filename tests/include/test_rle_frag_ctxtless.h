@@ -83,5 +83,15 @@ bool test_frag_ctxtless_too_small(void);
  */
 bool test_frag_ctxtless_too_big(void);
 
+/**
+ * @brief         Batch fragmentation test with a fragmentation configuration
+ *
+ *                Check that the PPDUs of the batch are the ones of the contextless fragmentation
+ *                with a transmitter, and that the buffers in error do not stop the batch.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_frag_ctxtless_batch(void);
+
 
 #endif /* __TEST_RLE_FRAG_CTXTLESS_H__ */
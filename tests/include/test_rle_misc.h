@@ -50,6 +50,26 @@ bool test_request_rle_header_overhead_traffic(void);
  */
 bool test_request_rle_header_overhead_all(void);
 
+/**
+ * @brief         Requests ALPDU header sizes of protocol types.
+ *
+ *                Request the ALPDU header size of protocol types with different configurations,
+ *                and check that transmitters are created for every implicit protocol type.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_request_alpdu_header_size(void);
+
+/**
+ * @brief         Estimates the PPDUs of SDUs in bursts.
+ *
+ *                Compare the estimates of SDUs of several sizes in several burst sequences to the
+ *                PPDUs really built by the fragmentation.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_request_overhead_estimate(void);
+
 /**
  * @brief         Test the transmitter allocation
  *
@@ -102,6 +122,169 @@ bool test_rle_allocation_f_buff(void);
  */
 bool test_rle_destruction_f_buff(void);
 
+/**
+ * @brief         Test the CRC32 engine
+ *
+ *                Check the selected kernel against a one octet at a time computation, for all
+ *                SDU lengths and alignments.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_crc_implementation(void);
+
+/**
+ * @brief         Test the log level threshold
+ *
+ *                Check that the traces more verbose than the log level do not reach the log
+ *                callback.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_log_level(void);
+
+/**
+ * @brief         Test the allocators
+ *
+ *                Check that a transmitter and a receiver created with their own allocator release
+ *                with it all the memory they take, and that the library allocator is kept by the
+ *                fragmentation buffers.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_allocator(void);
+
+/**
+ * @brief         Test the in-place initialization
+ *
+ *                Check that a transmitter and a receiver are initialized in aligned caller memory
+ *                large enough only, and that an SDU is then sent without allocation.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_in_place(void);
+
+/**
+ * @brief         Test the timing histograms
+ *
+ *                Check that the stages of a fragmented SDU are each timed once per call, in the
+ *                histograms of their module, or that no histogram is given without timing.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_timing(void);
+
+/**
+ * @brief         Test the copies counters
+ *
+ *                Check the octets copied and covered by a CRC at each stage of a fragmented SDU,
+ *                or that no counter is given without the copy statistics.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_copy_stats(void);
+
+/**
+ * @brief         Test the SDU sizes histograms
+ *
+ *                Check the SDUs counted by size and by number of PPDUs in the contexts of the
+ *                transmitter and of the receiver, or that no histogram is given without the size
+ *                statistics.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_size_stats(void);
+
+/**
+ * @brief         Test the adaptive implicit protocol type
+ *
+ *                Check the protocol types of the SDUs counted by the transmitter, the implicit
+ *                protocol type suggested, that it is not changed with a context in use or ALPDUs
+ *                in the pipe, and that its protocol type is omitted once both ends changed it at an
+ *                epoch boundary.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_adaptive_ptype(void);
+
+/**
+ * @brief         Test the log sinks
+ *
+ *                Check that the logs of a receiver go to its log sink, with its context and level,
+ *                while another receiver still uses the log trace callback, the errors of the VLAN
+ *                protocol type rebuilding included, and that the callback is back once the sink is
+ *                removed.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_log_sink(void);
+
+/**
+ * @brief         Test the PPDU headers specialized for the ALPDU trailer
+ *
+ *                Check that the transmitter selects the PPDU headers of its ALPDU trailer, CRC or
+ *                sequence number, and that a SDU fragmented with them is received.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_ppdu_hdr_specialization(void);
+
+/**
+ * @brief         Test the ALPDU and PPDU header templates
+ *
+ *                Check the headers of COMPLETE PPDUs for protocol types with their own ALPDU
+ *                header and for protocol types sharing the default one, and that their SDUs are
+ *                received.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_header_templates(void);
+
+/**
+ * @brief         Test the SDU buffer pool of a receiver
+ *
+ *                Check that the SDUs are copied in the smallest class of buffers they fit in,
+ *                in a larger one once it is empty, that they are dropped once the pool is empty,
+ *                that a buffer released from another thread is reused, and that the buffers stay
+ *                valid once the receiver is destroyed.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_sdu_pool(void);
+
+/**
+ * @brief         Test the ALPDU protection chosen per SDU by a policy
+ *
+ *                Check that the SDUs expected in a COMPLETE PPDU or in few PPDUs are protected by
+ *                a sequence number, the ones expected in more PPDUs or likely to lose one on the
+ *                link by a CRC, that the receiver follows, and that the policy is refused if the
+ *                CRC and the sequence number are not both allowed.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_protection_policy(void);
+
+/**
+ * @brief         Test the statistics fetched and reset in a single pass
+ *
+ *                Check that the counters of a transmitter and a receiver are fetched once, reset
+ *                meanwhile, and that no SDU is lost when they are fetched and reset repeatedly
+ *                while another thread sends SDUs.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_stats_fetch_and_reset(void);
+
+/**
+ * @brief         Test the real-time mode
+ *
+ *                Check that a transmitter with a queue, a receiver and a receiver initialized in
+ *                place allocate nothing once created, from their first SDU of any size on, and
+ *                that they release all the buffers they reserved.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_rle_realtime(void);
+
 /* Further tests can be done here, especially to check fragmentation and reassembly buffers. */
 
 
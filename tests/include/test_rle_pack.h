@@ -59,4 +59,25 @@ bool test_pack_invalid_label(void);
  */
 bool test_pack_all(void);
 
+/**
+ * @brief         Fused fragmentation and packing test, compared to fragmentation then packing.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_pack_fragment(void);
+
+/**
+ * @brief         Burst planning test, SDUs placed whole when possible, else cut in large bursts.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_pack_plan(void);
+
+/**
+ * @brief         Superframe packing test, less padding than greedy packing.
+ *
+ * @return        true if OK, else false.
+ */
+bool test_pack_superframe(void);
+
 #endif /* __TEST_RLE_PACK_H__ */
@@ -0,0 +1,802 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   test_bench.c
+ * @brief  Microbenchmarks of the hot functions of the library, with regression thresholds.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+/* system includes */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <getopt.h>
+
+#include "rle.h"
+#include "crc.h"
+#include "header.h"
+#include "fragmentation_buffer.h"
+#include "rle_transmitter.h"
+#include "rle_ctx.h"
+
+/** The program version */
+#define TEST_VERSION  "RLE microbenchmarks application, version 0.0.1\n"
+
+/** Min and max burst sizes of the benchmarks. */
+#define MIN_BURST_SIZE 14
+#define MAX_BURST_SIZE 599
+
+/** Default number of warm-up runs, of samples, and least duration of a sample */
+#define DEFAULT_WARMUP_RUNS  1000
+#define DEFAULT_SAMPLES_NR   7
+#define DEFAULT_SAMPLE_NS    200000ULL
+
+/** Default slowdown, in percents, past which a kernel is regressed from the baseline */
+#define DEFAULT_THRESHOLD  10.0
+
+/** Max number of results of a baseline */
+#define MAX_BASELINE_NR  256
+
+/** SDU sizes of the benchmarks */
+static const size_t sdu_sizes[] = { 1, 64, 256, 1500, RLE_MAX_PDU_SIZE };
+
+/** Burst sizes of the benchmarks */
+static const size_t burst_sizes[] = { MIN_BURST_SIZE, 64, 150, 300, MAX_BURST_SIZE };
+
+/** State of a benchmark, prepared for a size */
+struct bench_state {
+	struct rle_transmitter *transmitter;  /**< The transmitter of the push kernels.          */
+	struct rle_frag_buf *frag_buf;        /**< The fragmentation buffer of the push kernels. */
+	unsigned char snapshot[sizeof(struct rle_frag_buf)];  /**< The bookkeeping restored.     */
+	uint8_t next_seq_nb;                  /**< The sequence number restored before each run. */
+	size_t size;                          /**< The SDU or burst size.                        */
+	unsigned char data[RLE_MAX_PDU_SIZE + MAX_BURST_SIZE];  /**< The input buffer.           */
+	unsigned char fpdu[MAX_BURST_SIZE];   /**< The output buffer.                            */
+	struct rle_config conf;               /**< The configuration of the extract kernels.     */
+};
+
+/** A kernel benchmarked over sizes */
+struct bench_kernel {
+	const char *name;                                        /**< The name of the kernel.  */
+	const char *param;                                       /**< "sdu" or "burst".        */
+	bool (*setup)(struct bench_state *const state);          /**< Prepare the state.       */
+	uint32_t (*run)(struct bench_state *const state);        /**< One run of the kernel.   */
+};
+
+/** A result of a baseline */
+struct bench_result {
+	char name[64];    /**< The name of the kernel.   */
+	size_t size;      /**< The SDU or burst size.    */
+	double ns;        /**< The duration of one run.  */
+};
+
+/** Keep the results of the runs alive */
+static volatile uint32_t bench_sink;
+
+/* prototypes of private functions */
+static void usage(void);
+static uint64_t now_ns(void);
+static int compare_double(const void *const a, const void *const b);
+static size_t load_baseline(const char *const filename, struct bench_result results[]);
+static double measure(const struct bench_kernel *const kernel, struct bench_state *const state,
+                      const size_t warmup_runs, const size_t samples_nr);
+static bool setup_data(struct bench_state *const state);
+static bool setup_frag_buf(struct bench_state *const state);
+static bool setup_alpdu(struct bench_state *const state);
+static bool setup_ppdu(struct bench_state *const state);
+static bool setup_comp_alpdu(struct bench_state *const state);
+static bool setup_uncomp_alpdu(struct bench_state *const state);
+static bool setup_suppr_alpdu(struct bench_state *const state);
+static uint32_t run_compute_crc(struct bench_state *const state);
+static uint32_t run_push_alpdu_hdr(struct bench_state *const state);
+static uint32_t run_push_ppdu_hdr(struct bench_state *const state);
+static uint32_t run_rle_pack(struct bench_state *const state);
+static uint32_t run_get_fragment_length(struct bench_state *const state);
+static uint32_t run_comp_alpdu_extract(struct bench_state *const state);
+static uint32_t run_uncomp_alpdu_extract(struct bench_state *const state);
+static uint32_t run_suppr_alpdu_extract(struct bench_state *const state);
+static uint32_t run_signal_alpdu_extract(struct bench_state *const state);
+
+/** The kernels benchmarked */
+static const struct bench_kernel bench_kernels[] = {
+	{ "compute_crc", "sdu", setup_data, run_compute_crc },
+	{ "push_alpdu_hdr", "sdu", setup_frag_buf, run_push_alpdu_hdr },
+	{ "push_ppdu_hdr", "burst", setup_alpdu, run_push_ppdu_hdr },
+	{ "rle_pack", "burst", setup_data, run_rle_pack },
+	{ "get_fragment_length", "burst", setup_ppdu, run_get_fragment_length },
+	{ "comp_alpdu_extract_sdu_frag", "sdu", setup_comp_alpdu, run_comp_alpdu_extract },
+	{ "uncomp_alpdu_extract_sdu_frag", "sdu", setup_uncomp_alpdu, run_uncomp_alpdu_extract },
+	{ "suppr_alpdu_extract_sdu_frag", "sdu", setup_suppr_alpdu, run_suppr_alpdu_extract },
+	{ "signal_alpdu_extract_sdu_frag", "sdu", setup_data, run_signal_alpdu_extract },
+};
+
+
+/**
+ * @brief Main function for the RLE microbenchmarks program
+ *
+ * @param[in] argc The number of program arguments
+ * @param[in] argv The program arguments
+ * @return         The unix return code:
+ *                 \li 0 in case of success,
+ *                 \li 1 in case of failure or of regression
+ */
+int main(int argc, char *argv[])
+{
+	static struct bench_state state;
+	static struct bench_result baseline[MAX_BASELINE_NR];
+	const char *output_filename = NULL;
+	const char *baseline_filename = NULL;
+	size_t warmup_runs = DEFAULT_WARMUP_RUNS;
+	size_t samples_nr = DEFAULT_SAMPLES_NR;
+	double threshold = DEFAULT_THRESHOLD;
+	size_t baseline_nr = 0;
+	size_t regressions_nr = 0;
+	FILE *output = stdout;
+	int status = EXIT_FAILURE;
+	size_t kernel_id;
+
+	while (1) {
+		int c;
+
+		static struct option long_options[] =
+		{
+			{ "output", required_argument, 0, 'o' },
+			{ "baseline", required_argument, 0, 'b' },
+			{ "threshold", required_argument, 0, 't' },
+			{ "warmup", required_argument, 0, 'w' },
+			{ "samples", required_argument, 0, 's' },
+			{ 0, 0, 0, 0 }
+		};
+
+		int option_index = 0;
+
+		c = getopt_long(argc, argv, "vho:b:t:w:s:", long_options, &option_index);
+
+		if (c == -1) {
+			break;
+		}
+
+		switch (c) {
+		case 'o': /* CSV output */
+			output_filename = optarg;
+			break;
+		case 'b': /* CSV baseline */
+			baseline_filename = optarg;
+			break;
+		case 't': /* Slowdown threshold */
+			threshold = strtod(optarg, NULL);
+			break;
+		case 'w': /* Warm-up runs */
+			warmup_runs = strtoul(optarg, NULL, 10);
+			break;
+		case 's': /* Samples */
+			samples_nr = strtoul(optarg, NULL, 10);
+			if (samples_nr == 0) {
+				printf("ERROR: at least one sample is required.\n");
+				goto error;
+			}
+			break;
+		case 'v': /* Version */
+			printf(TEST_VERSION);
+			status = EXIT_SUCCESS;
+			goto error;
+		case 'h': /* Help */
+			usage();
+			status = EXIT_SUCCESS;
+			goto error;
+		case '?':
+		default:
+			usage();
+			goto error;
+		}
+	}
+
+	if (baseline_filename != NULL) {
+		baseline_nr = load_baseline(baseline_filename, baseline);
+		if (baseline_nr == 0) {
+			printf("ERROR: no result in baseline %s.\n", baseline_filename);
+			goto error;
+		}
+	}
+
+	if (output_filename != NULL) {
+		output = fopen(output_filename, "w");
+		if (output == NULL) {
+			printf("ERROR: failed to open %s.\n", output_filename);
+			goto error;
+		}
+	}
+
+	state.transmitter = NULL;
+	state.frag_buf = rle_frag_buf_new();
+	if (state.frag_buf == NULL) {
+		printf("ERROR: fragmentation buffer not allocated.\n");
+		goto close_output;
+	}
+
+	fprintf(output, "kernel,param,size,ns_per_run\n");
+
+	for (kernel_id = 0; kernel_id < sizeof(bench_kernels) / sizeof(bench_kernels[0]);
+	     kernel_id++) {
+		const struct bench_kernel *const kernel = &bench_kernels[kernel_id];
+		const bool is_burst = (strcmp(kernel->param, "burst") == 0);
+		const size_t *const sizes = is_burst ? burst_sizes : sdu_sizes;
+		const size_t sizes_nr = is_burst ? sizeof(burst_sizes) / sizeof(burst_sizes[0]) :
+		                        sizeof(sdu_sizes) / sizeof(sdu_sizes[0]);
+		size_t size_id;
+
+		for (size_id = 0; size_id < sizes_nr; size_id++) {
+			double ns;
+			size_t i;
+
+			state.size = sizes[size_id];
+			if (!kernel->setup(&state)) {
+				printf("ERROR: %s not prepared for size %zu.\n", kernel->name, state.size);
+				goto free_state;
+			}
+
+			ns = measure(kernel, &state, warmup_runs, samples_nr);
+			fprintf(output, "%s,%s,%zu,%.2f\n", kernel->name, kernel->param, state.size, ns);
+
+			for (i = 0; i < baseline_nr; i++) {
+				double slowdown;
+
+				if (strcmp(baseline[i].name, kernel->name) != 0 ||
+				    baseline[i].size != state.size || baseline[i].ns <= 0) {
+					continue;
+				}
+				slowdown = (ns / baseline[i].ns - 1.0) * 100.0;
+				if (slowdown > threshold) {
+					printf("REGRESSION: %s size %zu: %.2f ns, baseline %.2f ns (+%.1f%%)\n",
+					       kernel->name, state.size, ns, baseline[i].ns, slowdown);
+					regressions_nr++;
+				}
+			}
+		}
+	}
+
+	if (baseline_nr > 0) {
+		printf("=== %zu regression(s) past %.1f%% from %s\n", regressions_nr, threshold,
+		       baseline_filename);
+	}
+	status = (regressions_nr == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+
+free_state:
+	if (state.transmitter != NULL) {
+		rle_transmitter_destroy(&state.transmitter);
+	}
+	rle_frag_buf_del(&state.frag_buf);
+close_output:
+	if (output != stdout) {
+		fclose(output);
+	}
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the microbenchmarks application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "RLE microbenchmarks tool: time the hot functions of the library in isolation.\n"
+	        "\n"
+	        "Each kernel is run over SDU sizes from 1 to %d octets or burst sizes from %d to %d\n"
+	        "octets. The results are written in CSV, and may be compared to a baseline in the\n"
+	        "same format.\n"
+	        "\n"
+	        "usage: test_bench [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                      Print version information and exit\n"
+	        "  -h                      Print this usage and exit\n"
+	        "  --output, -o FILE       Write the CSV results in FILE (default stdout)\n"
+	        "  --baseline, -b FILE     Compare the results to the CSV baseline FILE\n"
+	        "  --threshold, -t PCT     Fail past a slowdown of PCT %% (default %.0f)\n"
+	        "  --warmup, -w N          Warm-up runs of each kernel (default %d)\n"
+	        "  --samples, -s N         Samples of each kernel, median kept (default %d)\n",
+	        RLE_MAX_PDU_SIZE, MIN_BURST_SIZE, MAX_BURST_SIZE, DEFAULT_THRESHOLD,
+	        DEFAULT_WARMUP_RUNS, DEFAULT_SAMPLES_NR);
+
+	return;
+}
+
+
+/**
+ * @brief         Get the monotonic time.
+ *
+ * @return        The monotonic time in ns.
+ */
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * @brief         Compare two durations, for qsort().
+ *
+ * @param[in]     a  The first duration.
+ * @param[in]     b  The second duration.
+ *
+ * @return        -1, 0 or 1 if a is lower, equal or greater than b.
+ */
+static int compare_double(const void *const a, const void *const b)
+{
+	const double x = *(const double *)a;
+	const double y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief         Load a CSV baseline written by a previous run.
+ *
+ * @param[in]     filename  The CSV baseline.
+ * @param[out]    results   The results of the baseline, MAX_BASELINE_NR at most.
+ *
+ * @return        The number of results loaded.
+ */
+static size_t load_baseline(const char *const filename, struct bench_result results[])
+{
+	char line[256];
+	size_t results_nr = 0;
+	FILE *const baseline = fopen(filename, "r");
+
+	if (baseline == NULL) {
+		goto out;
+	}
+
+	while (results_nr < MAX_BASELINE_NR && fgets(line, sizeof(line), baseline) != NULL) {
+		struct bench_result *const result = &results[results_nr];
+
+		/* the header and the malformed lines are skipped */
+		if (sscanf(line, "%63[^,],%*[^,],%zu,%lf", result->name, &result->size,
+		           &result->ns) == 3) {
+			results_nr++;
+		}
+	}
+
+	fclose(baseline);
+out:
+	return results_nr;
+}
+
+
+/**
+ * @brief         Time a kernel prepared for a size.
+ *
+ *                The runs of a sample are doubled until the sample lasts DEFAULT_SAMPLE_NS, so
+ *                that the clock costs nothing per run. The median of the samples is kept.
+ *
+ * @param[in]     kernel       The kernel.
+ * @param[in,out] state        The state prepared for the kernel.
+ * @param[in]     warmup_runs  The number of warm-up runs.
+ * @param[in]     samples_nr   The number of samples.
+ *
+ * @return        The duration of one run, in ns.
+ */
+static double measure(const struct bench_kernel *const kernel, struct bench_state *const state,
+                      const size_t warmup_runs, const size_t samples_nr)
+{
+	double samples[samples_nr];
+	uint32_t sink = 0;
+	size_t runs_nr = 1;
+	size_t sample;
+	size_t run;
+
+	for (run = 0; run < warmup_runs; run++) {
+		sink += kernel->run(state);
+	}
+
+	/* calibration of the runs per sample */
+	while (1) {
+		const uint64_t start = now_ns();
+
+		for (run = 0; run < runs_nr; run++) {
+			sink += kernel->run(state);
+		}
+		if (now_ns() - start >= DEFAULT_SAMPLE_NS) {
+			break;
+		}
+		runs_nr *= 2;
+	}
+
+	for (sample = 0; sample < samples_nr; sample++) {
+		const uint64_t start = now_ns();
+
+		for (run = 0; run < runs_nr; run++) {
+			sink += kernel->run(state);
+		}
+		samples[sample] = (double)(now_ns() - start) / runs_nr;
+	}
+	bench_sink = sink;
+
+	qsort(samples, samples_nr, sizeof(double), compare_double);
+
+	return samples[samples_nr / 2];
+}
+
+
+/**
+ * @brief         Fill the input buffer with an IPv4-looking SDU.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        true if the state is prepared.
+ */
+static bool setup_data(struct bench_state *const state)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(state->data); i++) {
+		state->data[i] = (unsigned char)(i * 7);
+	}
+	state->data[0] = 0x45;
+
+	return true;
+}
+
+
+/**
+ * @brief         Copy a SDU in the fragmentation buffer, before its ALPDU header is pushed.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        true if the state is prepared.
+ */
+static bool setup_frag_buf(struct bench_state *const state)
+{
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_sdu sdu;
+
+	setup_data(state);
+
+	if (state->transmitter == NULL) {
+		state->transmitter = rle_transmitter_new(&conf);
+		if (state->transmitter == NULL) {
+			return false;
+		}
+	}
+
+	sdu.buffer = state->data;
+	sdu.size = state->size;
+	sdu.protocol_type = RLE_PROTO_TYPE_IPV4_UNCOMP;
+
+	if (rle_frag_buf_init(state->frag_buf) != 0 ||
+	    rle_frag_buf_cpy_sdu(state->frag_buf, &sdu) != 0) {
+		return false;
+	}
+	memcpy(state->snapshot, state->frag_buf, sizeof(struct rle_frag_buf));
+
+	return true;
+}
+
+
+/**
+ * @brief         Encapsulate the largest SDU in the fragmentation buffer, before its first PPDU
+ *                header is pushed.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        true if the state is prepared.
+ */
+static bool setup_alpdu(struct bench_state *const state)
+{
+	const size_t burst_size = state->size;
+
+	state->size = RLE_MAX_PDU_SIZE;
+	if (!setup_frag_buf(state)) {
+		return false;
+	}
+	state->size = burst_size;
+
+	push_alpdu_hdr(state->frag_buf, &state->transmitter->ptype_table);
+	memcpy(state->snapshot, state->frag_buf, sizeof(struct rle_frag_buf));
+	state->next_seq_nb = state->transmitter->rle_ctx_man[0].next_seq_nb;
+
+	return true;
+}
+
+
+/**
+ * @brief         Build a PPDU of the burst size in the input buffer.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        true if the state is prepared.
+ */
+static bool setup_ppdu(struct bench_state *const state)
+{
+	unsigned char *ppdu;
+	size_t ppdu_length;
+
+	if (!setup_alpdu(state)) {
+		return false;
+	}
+
+	frag_buf_ppdu_init(state->frag_buf);
+	if (!push_ppdu_hdr(state->frag_buf, &state->transmitter->conf, state->size,
+	                   &state->transmitter->rle_ctx_man[0])) {
+		return false;
+	}
+	ppdu = state->frag_buf->ppdu.start;
+	ppdu_length = frag_buf_get_current_ppdu_len(state->frag_buf);
+	memcpy(state->data, ppdu, ppdu_length);
+
+	return true;
+}
+
+
+/**
+ * @brief         Build an ALPDU with a compressed protocol type in the input buffer.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        true if the state is prepared.
+ */
+static bool setup_comp_alpdu(struct bench_state *const state)
+{
+	setup_data(state);
+	state->data[0] = RLE_PROTO_TYPE_IPV4_COMP;
+	state->data[1] = 0x45;
+
+	return true;
+}
+
+
+/**
+ * @brief         Build an ALPDU with an uncompressed protocol type in the input buffer.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        true if the state is prepared.
+ */
+static bool setup_uncomp_alpdu(struct bench_state *const state)
+{
+	setup_data(state);
+	state->data[0] = (RLE_PROTO_TYPE_IPV4_UNCOMP >> 8) & 0xff;
+	state->data[1] = RLE_PROTO_TYPE_IPV4_UNCOMP & 0xff;
+	state->data[2] = 0x45;
+
+	return true;
+}
+
+
+/**
+ * @brief         Build an ALPDU with an omitted protocol type, detected from the IP version.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        true if the state is prepared.
+ */
+static bool setup_suppr_alpdu(struct bench_state *const state)
+{
+	setup_data(state);
+	memset(&state->conf, 0, sizeof(state->conf));
+	state->conf.allow_ptype_omission = 1;
+	state->conf.implicit_protocol_type = RLE_PROTO_TYPE_IP_COMP;
+
+	return true;
+}
+
+
+/**
+ * @brief         CRC of a SDU.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        The CRC.
+ */
+static uint32_t run_compute_crc(struct bench_state *const state)
+{
+	return compute_crc(state->data, state->size, RLE_CRC_INIT);
+}
+
+
+/**
+ * @brief         Push of the ALPDU header of a SDU.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        The first octet of the ALPDU.
+ */
+static uint32_t run_push_alpdu_hdr(struct bench_state *const state)
+{
+	memcpy(state->frag_buf, state->snapshot, sizeof(struct rle_frag_buf));
+	push_alpdu_hdr(state->frag_buf, &state->transmitter->ptype_table);
+
+	return state->frag_buf->alpdu.start[0];
+}
+
+
+/**
+ * @brief         Push of the first PPDU header of an ALPDU in a burst.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        The length of the PPDU.
+ */
+static uint32_t run_push_ppdu_hdr(struct bench_state *const state)
+{
+	struct rle_ctx_mngt *const rle_ctx = &state->transmitter->rle_ctx_man[0];
+
+	memcpy(state->frag_buf, state->snapshot, sizeof(struct rle_frag_buf));
+	rle_ctx->next_seq_nb = state->next_seq_nb;
+	frag_buf_ppdu_init(state->frag_buf);
+	if (!push_ppdu_hdr(state->frag_buf, &state->transmitter->conf, state->size, rle_ctx)) {
+		return 0;
+	}
+
+	return frag_buf_get_current_ppdu_len(state->frag_buf);
+}
+
+
+/**
+ * @brief         Packing of a PPDU filling a burst.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        The position in the FPDU.
+ */
+static uint32_t run_rle_pack(struct bench_state *const state)
+{
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = state->size;
+
+	if (rle_pack(state->data, state->size, NULL, 0, state->fpdu, &fpdu_cur_pos,
+	             &fpdu_remain_size) != RLE_PACK_OK) {
+		return 0;
+	}
+
+	return fpdu_cur_pos;
+}
+
+
+/**
+ * @brief         Length of a PPDU from its header.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        The length of the PPDU.
+ */
+static uint32_t run_get_fragment_length(struct bench_state *const state)
+{
+	return get_fragment_length(state->data);
+}
+
+
+/**
+ * @brief         Extraction of a SDU from an ALPDU with a compressed protocol type.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        The length of the SDU.
+ */
+static uint32_t run_comp_alpdu_extract(struct bench_state *const state)
+{
+	const unsigned char *sdu_frag;
+	size_t sdu_frag_len = 0;
+	size_t alpdu_hdr_len;
+	uint8_t comp_ptype;
+	uint16_t ptype;
+
+	if (comp_alpdu_extract_sdu_frag(state->data, state->size + 1, &ptype, &comp_ptype,
+	                                &sdu_frag, &sdu_frag_len, &alpdu_hdr_len, &state->conf)) {
+		return 0;
+	}
+
+	return sdu_frag_len + ptype;
+}
+
+
+/**
+ * @brief         Extraction of a SDU from an ALPDU with an uncompressed protocol type.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        The length of the SDU.
+ */
+static uint32_t run_uncomp_alpdu_extract(struct bench_state *const state)
+{
+	const unsigned char *sdu_frag;
+	size_t sdu_frag_len = 0;
+	size_t alpdu_hdr_len;
+	uint8_t comp_ptype;
+	uint16_t ptype;
+
+	if (uncomp_alpdu_extract_sdu_frag(state->data, state->size + 2, &ptype, &comp_ptype,
+	                                  &sdu_frag, &sdu_frag_len, &alpdu_hdr_len, &state->conf)) {
+		return 0;
+	}
+
+	return sdu_frag_len + ptype;
+}
+
+
+/**
+ * @brief         Extraction of a SDU from an ALPDU with an omitted protocol type.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        The length of the SDU.
+ */
+static uint32_t run_suppr_alpdu_extract(struct bench_state *const state)
+{
+	const unsigned char *sdu_frag;
+	size_t sdu_frag_len = 0;
+	size_t alpdu_hdr_len;
+	uint8_t comp_ptype;
+	uint16_t ptype;
+
+	if (suppr_alpdu_extract_sdu_frag(state->data, state->size, &ptype, &comp_ptype, &sdu_frag,
+	                                 &sdu_frag_len, &alpdu_hdr_len, &state->conf)) {
+		return 0;
+	}
+
+	return sdu_frag_len + ptype;
+}
+
+
+/**
+ * @brief         Extraction of a signalling SDU from an ALPDU.
+ *
+ * @param[in,out] state  The state.
+ *
+ * @return        The length of the SDU.
+ */
+static uint32_t run_signal_alpdu_extract(struct bench_state *const state)
+{
+	const unsigned char *sdu_frag;
+	size_t sdu_frag_len = 0;
+	size_t alpdu_hdr_len;
+	uint8_t comp_ptype;
+	uint16_t ptype;
+
+	if (signal_alpdu_extract_sdu_frag(state->data, state->size, &ptype, &comp_ptype, &sdu_frag,
+	                                  &sdu_frag_len, &alpdu_hdr_len, &state->conf)) {
+		return 0;
+	}
+
+	return sdu_frag_len + ptype;
+}
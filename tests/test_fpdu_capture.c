@@ -0,0 +1,713 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   test_fpdu_capture.c
+ * @brief  Convert FPDU traces between PCAP and the indexed capture format, and replay captures.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+#include "rle.h"
+#include "fpdu_capture.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <pcap/pcap.h>
+#include <pcap.h>
+
+/** The program version */
+#define TEST_VERSION  "RLE FPDU capture test application, version 0.0.1\n"
+
+/** The device MTU */
+#define DEV_MTU  0xffffU
+
+/** The length (in bytes) of the Ethernet header */
+#define ETHER_HDR_LEN  14U
+
+/** Max number of SDUs per FPDU */
+#define MAX_SDUS_NB   100
+
+/** Max SDU len */
+#define MAX_SDU_LEN   4088
+
+/** Max Payload label */
+#define MAX_PAYLOAD_LABEL_LEN 6
+
+/** Default payload label */
+#define DEFAULT_PAYLOAD_LABEL_LEN 3
+
+/** The number of nanoseconds per second */
+#define NS_PER_S  1000000000ULL
+
+/** dummy Ethernet header value for PCAP dumping */
+static const unsigned char ether_header[ETHER_HDR_LEN] =
+	"\x11\x22\x33\x44\x55\x66\x66\x55\x44\x33\x22\x11\x08\x00";
+
+/** The configuration of the receiver of the replays, the one of test_perfs_fpdu */
+static const struct rle_config conf = {
+	.allow_ptype_omission = 1,
+	.use_compressed_ptype = 1,
+	.allow_alpdu_crc = 0,
+	.allow_alpdu_sequence_number = 1,
+	.use_explicit_payload_header_map = 0,
+	.implicit_protocol_type = 0x30,
+	.implicit_ppdu_label_size = 0,
+	.implicit_payload_label_size = 0,
+	.type_0_alpdu_label_size = 0,
+};
+
+/** The results of a replay */
+struct replay_stats {
+	uint64_t fpdus;        /**< The FPDUs decapsulated                  */
+	uint64_t fpdus_bytes;  /**< The bytes of the FPDUs                  */
+	uint64_t fpdus_err;    /**< The FPDUs not decapsulated successfully */
+	uint64_t sdus;         /**< The SDUs decapsulated                   */
+	uint64_t sdus_bytes;   /**< The bytes of the SDUs                   */
+	uint64_t sdus_hash;    /**< A hash of the sizes of the SDUs, in order */
+};
+
+/* prototypes of private functions */
+static void usage(void);
+static bool count_pcap_fpdus(const char *const pcap_filename, uint64_t *const fpdus_nr,
+                             size_t *const fpdu_len_max);
+static int convert_from_pcap(const char *const pcap_filename, const char *const capture_filename);
+static int convert_to_pcap(const char *const capture_filename, const char *const pcap_filename);
+static int replay(const char *const capture_filename);
+static int check(const char *const pcap_filename);
+static bool replay_pcap(const char *const pcap_filename, struct replay_stats *const stats);
+static bool replay_capture(const struct fpdu_capture_reader *const reader,
+                           struct replay_stats *const stats);
+static void decap(struct rle_receiver *const receiver, unsigned char *const fpdu,
+                  const size_t fpdu_len, const size_t label_size,
+                  struct replay_stats *const stats);
+
+/** Whether the application runs in verbose mode or not */
+static int is_verbose = 0;
+
+/** Whether to handle malformed FPDUs as fatal for test or not */
+static int ignore_malformed = 0;
+
+/** Whether to decapsulate without copying the SDUs */
+static int zero_copy = 0;
+
+/** The size of the payload label of the FPDUs converted from PCAP */
+static size_t payload_label_len = DEFAULT_PAYLOAD_LABEL_LEN;
+
+/** The carrier of the FPDUs converted from PCAP */
+static uint32_t carrier = 0;
+
+/** The number of times a capture is replayed */
+static size_t loops_nr = 1;
+
+/** Buffer preallocation */
+static unsigned char sdu_buffers[MAX_SDUS_NB][MAX_SDU_LEN];
+static struct rle_sdu sdus_out[MAX_SDUS_NB];
+static unsigned char payload_label[MAX_PAYLOAD_LABEL_LEN];
+
+#define TRACE(x ...) \
+	do { \
+		if (is_verbose) { \
+			printf(x); \
+		} \
+	} while (0)
+
+/**
+ * @brief Main function for the RLE test program
+ *
+ * @param[in] argc The number of program arguments
+ * @param[in] argv The program arguments
+ * @return         The unix return code:
+ *                 \li 0 in case of success,
+ *                 \li 1 in case of failure,
+ *                 \li 77 in case test is skipped
+ */
+int main(int argc, char *argv[])
+{
+	int status = EXIT_FAILURE;
+	const char *command;
+	int args_nr;
+
+	while (1) {
+		int c;
+
+		const char short_options[] = "vhp:c:l:";
+
+		const struct option long_options[] = {
+			{ "verbose", no_argument, &is_verbose, 1 },
+			{ "ignore_malformed", no_argument, &ignore_malformed, 1 },
+			{ "zero_copy", no_argument, &zero_copy, 1 },
+			{ "payload_label", required_argument, 0, 'p' },
+			{ "carrier", required_argument, 0, 'c' },
+			{ "loops", required_argument, 0, 'l' },
+			{ NULL, 0, NULL, 0 },
+		};
+
+		int option_index = 0;
+
+		c = getopt_long(argc, argv, short_options, long_options, &option_index);
+
+		if (c == -1) {
+			break;
+		}
+
+		switch (c) {
+		case 0:
+			/* the option set a flag */
+			break;
+
+		case 'p': /* Payload Label length */
+			payload_label_len = (size_t)atoi(optarg);
+			if (payload_label_len > MAX_PAYLOAD_LABEL_LEN) {
+				printf("ERROR: %zu Payload label length is too big. Maximum = %d "
+				       "octets\n", payload_label_len, MAX_PAYLOAD_LABEL_LEN);
+				goto error;
+			}
+			break;
+
+		case 'c': /* Carrier */
+			carrier = (uint32_t)strtoul(optarg, NULL, 0);
+			break;
+
+		case 'l': /* Replays */
+			loops_nr = (size_t)atoi(optarg);
+			if (loops_nr == 0) {
+				printf("ERROR: at least one replay expected\n");
+				goto error;
+			}
+			break;
+
+		case 'v': /* Version */
+			printf(TEST_VERSION);
+			status = EXIT_SUCCESS;
+			goto error;
+
+		case 'h': /* Help */
+			usage();
+			status = EXIT_SUCCESS;
+			goto error;
+
+		case '?':
+		default:
+			usage();
+			goto error;
+		}
+	}
+
+	if (optind >= argc) {
+		fprintf(stderr, "COMMAND is a mandatory parameter\n\n");
+		usage();
+		goto error;
+	}
+	command = argv[optind];
+	args_nr = argc - optind - 1;
+
+	if (!strcmp(command, "from-pcap") && args_nr == 2) {
+		status = convert_from_pcap(argv[optind + 1], argv[optind + 2]);
+	} else if (!strcmp(command, "to-pcap") && args_nr == 2) {
+		status = convert_to_pcap(argv[optind + 1], argv[optind + 2]);
+	} else if (!strcmp(command, "replay") && args_nr == 1) {
+		status = replay(argv[optind + 1]);
+	} else if (!strcmp(command, "check") && args_nr >= 1) {
+		int i;
+
+		status = EXIT_SUCCESS;
+		for (i = optind + 1; i < argc && status == EXIT_SUCCESS; i++) {
+			status = check(argv[i]);
+		}
+	} else {
+		usage();
+		goto error;
+	}
+
+	printf("=== exit test with code %d\n", status);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the capture test application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "\n"
+	        "RLE FPDU capture tool:  convert FPDU traces between PCAP and the indexed capture\n"
+	        "                        format, and replay the captures to a receiver at full\n"
+	        "                        speed straight from their memory mapping.\n"
+	        "\n"
+	        "usage: test_fpdu_capture [OPTIONS] COMMAND\n"
+	        "\n"
+	        "with COMMAND:\n"
+	        "  from-pcap PCAP CAPTURE       Convert the FPDUs of PCAP (with Ethernet linklayer)\n"
+	        "  to-pcap CAPTURE PCAP         Convert the FPDUs of CAPTURE, dropping the carriers\n"
+	        "                               and the payload label sizes\n"
+	        "  replay CAPTURE               Decapsulate the FPDUs of CAPTURE\n"
+	        "  check PCAP...                Convert each PCAP to a capture and back, and check\n"
+	        "                               that both decapsulate to the same SDUs\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                           Print version information and exit\n"
+	        "  -h                           Print this usage and exit\n"
+	        "  -p, --payload_label LEN      The payload label size of the FPDUs converted from\n"
+	        "                               PCAP (default: %d)\n"
+	        "  -c, --carrier ID             The carrier of the FPDUs converted from PCAP\n"
+	        "                               (default: 0)\n"
+	        "  -l, --loops NR               The number of replays of the capture (default: 1)\n"
+	        "  --zero_copy                  Replay without copying the SDUs\n"
+	        "  --ignore_malformed           Ignore malformed FPDUs in replays\n"
+	        "  --verbose                    Run the test in verbose mode\n",
+	        DEFAULT_PAYLOAD_LABEL_LEN);
+}
+
+
+/**
+ * @brief Count the FPDUs of a PCAP file and the length of the longest one.
+ *
+ * @param[in]  pcap_filename  The PCAP file.
+ * @param[out] fpdus_nr       The number of FPDUs.
+ * @param[out] fpdu_len_max   The length of the longest FPDU.
+ * @return     true if OK, else false.
+ */
+static bool count_pcap_fpdus(const char *const pcap_filename, uint64_t *const fpdus_nr,
+                             size_t *const fpdu_len_max)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct pcap_pkthdr header;
+	pcap_t *handle;
+
+	handle = pcap_open_offline(pcap_filename, errbuf);
+	if (handle == NULL) {
+		printf("failed to open the source pcap file: %s\n", errbuf);
+		return false;
+	}
+	if (pcap_datalink(handle) != DLT_EN10MB) {
+		printf("link layer type %d not supported in source dump (supported = %d)\n",
+		       pcap_datalink(handle), DLT_EN10MB);
+		pcap_close(handle);
+		return false;
+	}
+
+	*fpdus_nr = 0;
+	*fpdu_len_max = 0;
+	while (pcap_next(handle, &header) != NULL) {
+		if (header.len > ETHER_HDR_LEN && header.len == header.caplen) {
+			const size_t fpdu_len = header.len - ETHER_HDR_LEN;
+
+			(*fpdus_nr)++;
+			if (fpdu_len > *fpdu_len_max) {
+				*fpdu_len_max = fpdu_len;
+			}
+		}
+	}
+	pcap_close(handle);
+
+	return true;
+}
+
+/**
+ * @brief Convert the FPDUs of a PCAP file to a capture.
+ *
+ *        The PCAP file is read twice, once to size the capture, once to fill it.
+ *
+ * @param[in] pcap_filename     The PCAP file, with Ethernet linklayer.
+ * @param[in] capture_filename  The capture.
+ * @return    EXIT_SUCCESS if OK, else EXIT_FAILURE.
+ */
+static int convert_from_pcap(const char *const pcap_filename, const char *const capture_filename)
+{
+	struct fpdu_capture_writer writer;
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct pcap_pkthdr header;
+	const unsigned char *packet;
+	uint64_t fpdus_nr;
+	size_t fpdu_len_max;
+	uint64_t ignored_nr = 0;
+	pcap_t *handle;
+	int status = EXIT_FAILURE;
+
+	if (!count_pcap_fpdus(pcap_filename, &fpdus_nr, &fpdu_len_max)) {
+		goto error;
+	}
+	if (!fpdu_capture_create(&writer, capture_filename, fpdu_len_max, fpdus_nr)) {
+		goto error;
+	}
+
+	handle = pcap_open_offline(pcap_filename, errbuf);
+	if (handle == NULL) {
+		printf("failed to open the source pcap file: %s\n", errbuf);
+		goto finish;
+	}
+	while ((packet = pcap_next(handle, &header)) != NULL) {
+		const uint64_t timestamp =
+			(uint64_t)header.ts.tv_sec * NS_PER_S + (uint64_t)header.ts.tv_usec * 1000;
+
+		if (header.len <= ETHER_HDR_LEN || header.len != header.caplen) {
+			ignored_nr++;
+			continue;
+		}
+		if (!fpdu_capture_append(&writer, packet + ETHER_HDR_LEN, header.len - ETHER_HDR_LEN,
+		                         (uint8_t)payload_label_len, carrier, timestamp)) {
+			printf("failed to record the FPDU #%" PRIu64 "\n", writer.hdr->records_nr + 1);
+			goto close;
+		}
+	}
+
+	printf("=== %" PRIu64 " FPDUs converted, %" PRIu64 " truncated packets ignored, "
+	       "%u-byte records\n", writer.hdr->records_nr, ignored_nr, writer.hdr->record_size);
+	status = EXIT_SUCCESS;
+
+close:
+	pcap_close(handle);
+finish:
+	if (!fpdu_capture_finish(&writer)) {
+		status = EXIT_FAILURE;
+	}
+error:
+	return status;
+}
+
+/**
+ * @brief Convert the FPDUs of a capture to a PCAP file, behind a dummy Ethernet header.
+ *
+ * @param[in] capture_filename  The capture.
+ * @param[in] pcap_filename     The PCAP file.
+ * @return    EXIT_SUCCESS if OK, else EXIT_FAILURE.
+ */
+static int convert_to_pcap(const char *const capture_filename, const char *const pcap_filename)
+{
+	struct fpdu_capture_reader reader;
+	unsigned char frame[ETHER_HDR_LEN + UINT16_MAX];
+	pcap_dumper_t *dumpfile;
+	pcap_t *handle;
+	uint64_t i;
+	int status = EXIT_FAILURE;
+
+	if (!fpdu_capture_open(&reader, capture_filename)) {
+		goto error;
+	}
+
+	handle = pcap_open_dead(DLT_EN10MB, DEV_MTU);
+	if (handle == NULL) {
+		printf("failed to open a pcap handle\n");
+		goto close;
+	}
+	dumpfile = pcap_dump_open(handle, pcap_filename);
+	if (dumpfile == NULL) {
+		printf("failed to open the pcap dump: %s\n", pcap_geterr(handle));
+		goto close_pcap;
+	}
+
+	memcpy(frame, ether_header, ETHER_HDR_LEN);
+	for (i = 0; i < fpdu_capture_records_nr(&reader); i++) {
+		const struct fpdu_capture_record *const record = fpdu_capture_record(&reader, i);
+		struct pcap_pkthdr header;
+
+		if (record->fpdu_len > reader.hdr->record_size - sizeof(struct fpdu_capture_record)) {
+			printf("malformed record #%" PRIu64 "\n", i + 1);
+			goto close_dump;
+		}
+		header.ts.tv_sec = (time_t)(record->timestamp / NS_PER_S);
+		header.ts.tv_usec = (suseconds_t)(record->timestamp % NS_PER_S / 1000);
+		header.caplen = ETHER_HDR_LEN + record->fpdu_len;
+		header.len = header.caplen;
+		memcpy(frame + ETHER_HDR_LEN, record->fpdu, record->fpdu_len);
+		pcap_dump((unsigned char *)dumpfile, &header, frame);
+	}
+
+	printf("=== %" PRIu64 " FPDUs converted\n", fpdu_capture_records_nr(&reader));
+	status = EXIT_SUCCESS;
+
+close_dump:
+	pcap_dump_close(dumpfile);
+close_pcap:
+	pcap_close(handle);
+close:
+	fpdu_capture_close(&reader);
+error:
+	return status;
+}
+
+/**
+ * @brief Decapsulate a FPDU, counting it and its SDUs.
+ *
+ * @param[in,out] receiver    The receiver.
+ * @param[in,out] fpdu        The FPDU.
+ * @param[in]     fpdu_len    The length of the FPDU.
+ * @param[in]     label_size  The size of the payload label of the FPDU.
+ * @param[in,out] stats       The results of the replay.
+ */
+static void decap(struct rle_receiver *const receiver, unsigned char *const fpdu,
+                  const size_t fpdu_len, const size_t label_size,
+                  struct replay_stats *const stats)
+{
+	enum rle_decap_status ret;
+	size_t sdus_nr = 0;
+	size_t i;
+
+	for (i = 0; i < MAX_SDUS_NB; i++) {
+		sdus_out[i].buffer = sdu_buffers[i];
+		sdus_out[i].size = 0;
+		sdus_out[i].protocol_type = 0;
+	}
+
+	if (zero_copy) {
+		ret = rle_decapsulate_zero_copy(receiver, fpdu, fpdu_len, sdus_out, MAX_SDUS_NB,
+		                                &sdus_nr, payload_label, label_size);
+	} else {
+		ret = rle_decapsulate(receiver, fpdu, fpdu_len, sdus_out, MAX_SDUS_NB, &sdus_nr,
+		                      payload_label, label_size);
+	}
+
+	stats->fpdus++;
+	stats->fpdus_bytes += fpdu_len;
+	if (ret != RLE_DECAP_OK) {
+		TRACE("FPDU #%" PRIu64 " not decapsulated: error %d\n", stats->fpdus, ret);
+		stats->fpdus_err++;
+	}
+	for (i = 0; i < sdus_nr; i++) {
+		stats->sdus++;
+		stats->sdus_bytes += sdus_out[i].size;
+		stats->sdus_hash = stats->sdus_hash * 31 + sdus_out[i].size;
+	}
+}
+
+/**
+ * @brief Decapsulate the FPDUs of a capture in place, once.
+ *
+ * @param[in]     reader  The capture.
+ * @param[in,out] stats   The results of the replay.
+ * @return        true if OK, false if a record is malformed or the receiver not created.
+ */
+static bool replay_capture(const struct fpdu_capture_reader *const reader,
+                           struct replay_stats *const stats)
+{
+	const size_t fpdu_len_max = reader->hdr->record_size - sizeof(struct fpdu_capture_record);
+	const uint64_t records_nr = fpdu_capture_records_nr(reader);
+	struct rle_receiver *receiver;
+	bool is_ok = false;
+	uint64_t i;
+
+	receiver = rle_receiver_new(&conf);
+	if (receiver == NULL) {
+		printf("ERROR: receiver non initialized\n");
+		goto error;
+	}
+
+	for (i = 0; i < records_nr; i++) {
+		struct fpdu_capture_record *const record = fpdu_capture_record(reader, i);
+
+		if (record->fpdu_len > fpdu_len_max ||
+		    record->payload_label_size > MAX_PAYLOAD_LABEL_LEN) {
+			printf("malformed record #%" PRIu64 "\n", i + 1);
+			goto destroy;
+		}
+		decap(receiver, record->fpdu, record->fpdu_len, record->payload_label_size, stats);
+	}
+
+	is_ok = true;
+
+destroy:
+	rle_receiver_destroy(&receiver);
+error:
+	return is_ok;
+}
+
+/**
+ * @brief Decapsulate the FPDUs of a PCAP file, record by record, as the other tools do.
+ *
+ * @param[in]     pcap_filename  The PCAP file, with Ethernet linklayer.
+ * @param[in,out] stats          The results of the replay.
+ * @return        true if OK, else false.
+ */
+static bool replay_pcap(const char *const pcap_filename, struct replay_stats *const stats)
+{
+	unsigned char fpdu[UINT16_MAX];
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct pcap_pkthdr header;
+	const unsigned char *packet;
+	struct rle_receiver *receiver;
+	pcap_t *handle;
+	bool is_ok = false;
+
+	receiver = rle_receiver_new(&conf);
+	if (receiver == NULL) {
+		printf("ERROR: receiver non initialized\n");
+		goto error;
+	}
+	handle = pcap_open_offline(pcap_filename, errbuf);
+	if (handle == NULL) {
+		printf("failed to open the source pcap file: %s\n", errbuf);
+		goto destroy;
+	}
+
+	while ((packet = pcap_next(handle, &header)) != NULL) {
+		if (header.len <= ETHER_HDR_LEN || header.len != header.caplen) {
+			continue;
+		}
+		memcpy(fpdu, packet + ETHER_HDR_LEN, header.len - ETHER_HDR_LEN);
+		decap(receiver, fpdu, header.len - ETHER_HDR_LEN, payload_label_len, stats);
+	}
+	is_ok = true;
+
+	pcap_close(handle);
+destroy:
+	rle_receiver_destroy(&receiver);
+error:
+	return is_ok;
+}
+
+/**
+ * @brief Replay a capture at full speed, straight from its mapping.
+ *
+ * @param[in] capture_filename  The capture.
+ * @return    EXIT_SUCCESS if OK, else EXIT_FAILURE.
+ */
+static int replay(const char *const capture_filename)
+{
+	struct fpdu_capture_reader reader;
+	struct replay_stats stats;
+	struct timespec start;
+	struct timespec end;
+	double elapsed;
+	size_t loop;
+	int status = EXIT_FAILURE;
+
+	if (!fpdu_capture_open(&reader, capture_filename)) {
+		goto error;
+	}
+
+	printf("=== %" PRIu64 " FPDUs in %u-byte records, %zu replays%s\n",
+	       fpdu_capture_records_nr(&reader), reader.hdr->record_size, loops_nr,
+	       zero_copy ? " without copies" : "");
+
+	memset(&stats, 0, sizeof(stats));
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (loop = 0; loop < loops_nr; loop++) {
+		/* the zero-copy decapsulation rebuilds some SDUs inside the records, they are read
+		 * again from the file so that each replay decapsulates the same FPDUs */
+		if (zero_copy && loop > 0 && !fpdu_capture_reload(&reader)) {
+			goto close;
+		}
+		if (!replay_capture(&reader, &stats)) {
+			goto close;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	elapsed = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+
+	printf("===\tFPDUs:        %" PRIu64 " (%" PRIu64 " bytes, %" PRIu64 " in error)\n",
+	       stats.fpdus, stats.fpdus_bytes, stats.fpdus_err);
+	printf("===\tSDUs:         %" PRIu64 " (%" PRIu64 " bytes)\n", stats.sdus,
+	       stats.sdus_bytes);
+	printf("===\telapsed time: %.6f s\n", elapsed);
+	if (elapsed > 0) {
+		printf("===\trate:         %.0f FPDUs/s, %.1f Mbit/s of FPDUs\n",
+		       (double)stats.fpdus / elapsed, (double)stats.fpdus_bytes * 8 / elapsed / 1e6);
+	}
+
+	status = (stats.fpdus_err == 0 || ignore_malformed) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+close:
+	fpdu_capture_close(&reader);
+error:
+	return status;
+}
+
+/**
+ * @brief Convert a PCAP file to a capture and back, and check that the capture and both PCAP
+ *        files decapsulate to the same SDUs.
+ *
+ * @param[in] pcap_filename  The PCAP file, with Ethernet linklayer.
+ * @return    EXIT_SUCCESS if OK, else EXIT_FAILURE.
+ */
+static int check(const char *const pcap_filename)
+{
+	char capture_filename[] = "/tmp/rle_fpdu_capture_XXXXXX";
+	char pcap_copy_filename[] = "/tmp/rle_fpdu_capture_XXXXXX";
+	struct fpdu_capture_reader reader;
+	struct replay_stats pcap_stats;
+	struct replay_stats capture_stats;
+	struct replay_stats pcap_copy_stats;
+	int fd;
+	int status = EXIT_FAILURE;
+
+	printf("=== check %s\n", pcap_filename);
+
+	fd = mkstemp(capture_filename);
+	if (fd < 0) {
+		perror("failed to create a temporary capture");
+		goto error;
+	}
+	close(fd);
+	fd = mkstemp(pcap_copy_filename);
+	if (fd < 0) {
+		perror("failed to create a temporary pcap file");
+		goto unlink_capture;
+	}
+	close(fd);
+
+	if (convert_from_pcap(pcap_filename, capture_filename) != EXIT_SUCCESS ||
+	    convert_to_pcap(capture_filename, pcap_copy_filename) != EXIT_SUCCESS) {
+		goto unlink_all;
+	}
+
+	memset(&pcap_stats, 0, sizeof(pcap_stats));
+	memset(&capture_stats, 0, sizeof(capture_stats));
+	memset(&pcap_copy_stats, 0, sizeof(pcap_copy_stats));
+	if (!replay_pcap(pcap_filename, &pcap_stats) ||
+	    !replay_pcap(pcap_copy_filename, &pcap_copy_stats) ||
+	    !fpdu_capture_open(&reader, capture_filename)) {
+		goto unlink_all;
+	}
+	if (!replay_capture(&reader, &capture_stats)) {
+		fpdu_capture_close(&reader);
+		goto unlink_all;
+	}
+	fpdu_capture_close(&reader);
+
+	if (memcmp(&pcap_stats, &capture_stats, sizeof(pcap_stats)) != 0 ||
+	    memcmp(&pcap_stats, &pcap_copy_stats, sizeof(pcap_stats)) != 0) {
+		printf("ERROR: %" PRIu64 "/%" PRIu64 "/%" PRIu64 " FPDUs and %" PRIu64 "/%" PRIu64
+		       "/%" PRIu64 " SDUs from the PCAP file, the capture and back\n",
+		       pcap_stats.fpdus, capture_stats.fpdus, pcap_copy_stats.fpdus, pcap_stats.sdus,
+		       capture_stats.sdus, pcap_copy_stats.sdus);
+		goto unlink_all;
+	}
+	printf("===\t%" PRIu64 " FPDUs and %" PRIu64 " SDUs from the PCAP file, the capture and "
+	       "back\n", pcap_stats.fpdus, pcap_stats.sdus);
+
+	status = EXIT_SUCCESS;
+
+unlink_all:
+	unlink(pcap_copy_filename);
+unlink_capture:
+	unlink(capture_filename);
+error:
+	return status;
+}
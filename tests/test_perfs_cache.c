@@ -0,0 +1,393 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   test_perfs_cache.c
+ * @brief  Cache test of the fragmentation, round-robin over the contexts of a transmitter with
+ *         the data cache evicted between the rounds.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * Each round fragments one PPDU of each context of the transmitter, encapsulating a new SDU in
+ * the contexts left empty, after a buffer larger than the L1 data cache is written, so that the
+ * contexts are fetched again at each round as on a carrier serving many terminals. The rounds
+ * only are measured: their duration, and their L1 data cache and last level cache read misses
+ * when the host exposes the hardware cache counters to perf_event_open().
+ */
+
+/* system includes */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "rle.h"
+#include "constants.h"
+#include "fragmentation_buffer.h"
+#include "rle_ctx.h"
+
+/** The program version */
+#define TEST_VERSION  "RLE fragmentation cache test application, version 0.0.1\n"
+
+/** Min and max burst sizes of the test. */
+#define MIN_BURST_SIZE 14
+#define MAX_BURST_SIZE 2049
+
+/** Default number of rounds, SDU size and burst size */
+#define DEFAULT_ROUNDS_NR    100000
+#define DEFAULT_SDU_SIZE     1000
+#define DEFAULT_BURST_SIZE   150
+
+/** The size of the buffer written between the rounds, larger than the L1 data caches */
+#define EVICT_SIZE  (256 * 1024)
+
+/** The cache levels whose read misses are counted */
+enum cache_level {
+	CACHE_L1D,        /**< The L1 data cache.       */
+	CACHE_LL,         /**< The last level cache.    */
+	CACHE_LEVELS_NR,  /**< Number of cache levels.  */
+};
+
+/** The names of the cache levels */
+static const char *const cache_level_names[CACHE_LEVELS_NR] = {
+	"L1D", "LLC"
+};
+
+/** The perf_event_open() ids of the cache levels */
+static const uint64_t cache_level_ids[CACHE_LEVELS_NR] = {
+	PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_LL
+};
+
+/** The configuration of the transmitter */
+static const struct rle_config cache_conf = {
+	.allow_ptype_omission = 0,
+	.use_compressed_ptype = 1,
+	.allow_alpdu_crc = 0,
+	.allow_alpdu_sequence_number = 1,
+	.use_explicit_payload_header_map = 0,
+	.implicit_protocol_type = 0x00,
+	.implicit_ppdu_label_size = 0,
+	.implicit_payload_label_size = 0,
+	.type_0_alpdu_label_size = 0,
+};
+
+/* prototypes of private functions */
+static void usage(void);
+static uint64_t now_ns(void);
+static int open_cache_counter(const enum cache_level level);
+static void evict_cache(unsigned char evict[]);
+static bool cache_rounds(const size_t rounds_nr, const size_t sdu_size, const size_t burst_size);
+
+
+/**
+ * @brief  Main function of the fragmentation cache test application
+ *
+ * @param  argc  The number of arguments given to the program
+ * @param  argv  The table of arguments given to the program
+ * @return       0 in case of success, 1 otherwise
+ */
+int main(int argc, char *argv[])
+{
+	size_t rounds_nr = DEFAULT_ROUNDS_NR;
+	size_t sdu_size = DEFAULT_SDU_SIZE;
+	size_t burst_size = DEFAULT_BURST_SIZE;
+	int status = EXIT_FAILURE;
+
+	while (1) {
+		int c;
+
+		static struct option long_options[] =
+		{
+			{ "rounds", required_argument, 0, 'n' },
+			{ "sdu", required_argument, 0, 's' },
+			{ "burst", required_argument, 0, 'b' },
+			{ 0, 0, 0, 0 }
+		};
+
+		int option_index = 0;
+
+		c = getopt_long(argc, argv, "vhn:s:b:", long_options, &option_index);
+
+		if (c == -1) {
+			break;
+		}
+
+		switch (c) {
+		case 'n': /* Number of rounds */
+			rounds_nr = strtoul(optarg, NULL, 10);
+			if (rounds_nr == 0) {
+				printf("ERROR: at least one round is required.\n");
+				goto error;
+			}
+			break;
+		case 's': /* SDU size */
+			sdu_size = strtoul(optarg, NULL, 10);
+			if (sdu_size == 0 || sdu_size > RLE_MAX_PDU_SIZE) {
+				printf("ERROR: SDU size '%s', from 1 to %d.\n", optarg, RLE_MAX_PDU_SIZE);
+				goto error;
+			}
+			break;
+		case 'b': /* Burst size */
+			burst_size = strtoul(optarg, NULL, 10);
+			if (burst_size < MIN_BURST_SIZE || burst_size > MAX_BURST_SIZE) {
+				printf("ERROR: burst size '%s', from %d to %d.\n", optarg, MIN_BURST_SIZE,
+				       MAX_BURST_SIZE);
+				goto error;
+			}
+			break;
+		case 'v': /* Version */
+			printf(TEST_VERSION);
+			status = EXIT_SUCCESS;
+			goto error;
+		case 'h': /* Help */
+			usage();
+			status = EXIT_SUCCESS;
+			goto error;
+		case '?':
+		default:
+			usage();
+			goto error;
+		}
+	}
+
+	if (optind != argc) {
+		usage();
+		goto error;
+	}
+
+	printf("=== context %zu bytes, %d contexts on %zu cache lines, "
+	       "fragmentation buffer metadata %zu bytes\n", sizeof(struct rle_ctx_mngt),
+	       RLE_MAX_FRAG_NUMBER,
+	       (RLE_MAX_FRAG_NUMBER * sizeof(struct rle_ctx_mngt) + RLE_CACHE_LINE_SIZE - 1) /
+	       RLE_CACHE_LINE_SIZE, sizeof(struct rle_frag_buf));
+
+	if (cache_rounds(rounds_nr, sdu_size, burst_size)) {
+		status = EXIT_SUCCESS;
+	}
+
+	printf("=== exit test with code %d\n", status);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the fragmentation cache test application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "RLE fragmentation cache test tool: fragment one PPDU of each context in turn,\n"
+	        "with the data cache evicted between the rounds.\n"
+	        "\n"
+	        "Print the mean duration of a PPDU, and its L1 data cache and last level cache\n"
+	        "read misses when the hardware counters are available.\n"
+	        "\n"
+	        "usage: test_perfs_cache [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                      Print version information and exit\n"
+	        "  -h                      Print this usage and exit\n"
+	        "  --rounds, -n            Number of rounds (default %d)\n"
+	        "  --sdu, -s               SDU size, up to %d (default %d)\n"
+	        "  --burst, -b             Burst size, from %d to %d (default %d)\n",
+	        DEFAULT_ROUNDS_NR, RLE_MAX_PDU_SIZE, DEFAULT_SDU_SIZE, MIN_BURST_SIZE, MAX_BURST_SIZE,
+	        DEFAULT_BURST_SIZE);
+
+	return;
+}
+
+
+/**
+ * @brief         Get the monotonic time.
+ *
+ * @return        The monotonic time in ns.
+ */
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * @brief         Open a disabled counter of the read misses of a cache level, for this thread.
+ *
+ * @param[in]     level  The cache level.
+ *
+ * @return        The file descriptor of the counter, -1 if the host does not expose it.
+ */
+static int open_cache_counter(const enum cache_level level)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HW_CACHE;
+	attr.config = cache_level_ids[level] | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+	              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+
+/**
+ * @brief         Write a buffer larger than the L1 data cache, to evict the contexts from it.
+ *
+ * @param[in,out] evict  The buffer, of EVICT_SIZE bytes.
+ */
+static void evict_cache(unsigned char evict[])
+{
+	size_t it;
+
+	for (it = 0; it < EVICT_SIZE; it += RLE_CACHE_LINE_SIZE) {
+		evict[it]++;
+	}
+	/* the writes shall not be optimized out */
+	__asm__ __volatile__ ("" : : "r" (evict) : "memory");
+
+	return;
+}
+
+
+/**
+ * @brief         Fragment one PPDU of each context per round, and print the costs of a PPDU.
+ *
+ * @param[in]     rounds_nr   The number of rounds.
+ * @param[in]     sdu_size    The size of the SDUs.
+ * @param[in]     burst_size  The max size of the PPDUs.
+ *
+ * @return        true in case of success, false otherwise.
+ */
+static bool cache_rounds(const size_t rounds_nr, const size_t sdu_size, const size_t burst_size)
+{
+	struct rle_transmitter *transmitter;
+	unsigned char *sdu_buffer;
+	unsigned char *evict;
+	int counters[CACHE_LEVELS_NR];
+	uint64_t misses[CACHE_LEVELS_NR] = { 0 };
+	uint64_t duration_ns = 0;
+	size_t ppdus_nr = 0;
+	bool is_ok = false;
+	size_t round;
+	int level;
+
+	transmitter = rle_transmitter_new(&cache_conf);
+	sdu_buffer = calloc(1, sdu_size);
+	evict = calloc(1, EVICT_SIZE);
+	if (transmitter == NULL || sdu_buffer == NULL || evict == NULL) {
+		printf("ERROR: failed to allocate the transmitter and the buffers.\n");
+		goto free;
+	}
+	for (level = 0; level < CACHE_LEVELS_NR; level++) {
+		counters[level] = open_cache_counter((enum cache_level)level);
+	}
+
+	for (round = 0; round < rounds_nr; round++) {
+		uint64_t start_ns;
+		uint8_t frag_id;
+
+		evict_cache(evict);
+
+		for (level = 0; level < CACHE_LEVELS_NR; level++) {
+			if (counters[level] >= 0) {
+				ioctl(counters[level], PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+		start_ns = now_ns();
+
+		for (frag_id = 0; frag_id < RLE_MAX_FRAG_NUMBER; frag_id++) {
+			unsigned char *ppdu;
+			size_t ppdu_length;
+
+			if (rle_transmitter_stats_get_queue_size(transmitter, frag_id) == 0) {
+				const struct rle_sdu sdu = {
+					.buffer = sdu_buffer,
+					.size = sdu_size,
+					.protocol_type = 0x0800,
+				};
+
+				if (rle_encapsulate(transmitter, &sdu, frag_id) != RLE_ENCAP_OK) {
+					printf("ERROR: failed to encapsulate a SDU in the context %u.\n",
+					       frag_id);
+					goto close;
+				}
+			}
+			if (rle_fragment(transmitter, frag_id, burst_size, &ppdu, &ppdu_length) !=
+			    RLE_FRAG_OK) {
+				printf("ERROR: failed to fragment the context %u.\n", frag_id);
+				goto close;
+			}
+			ppdus_nr++;
+		}
+
+		duration_ns += now_ns() - start_ns;
+		for (level = 0; level < CACHE_LEVELS_NR; level++) {
+			if (counters[level] >= 0) {
+				ioctl(counters[level], PERF_EVENT_IOC_DISABLE, 0);
+			}
+		}
+	}
+
+	printf("=== %zu rounds of %d contexts, SDUs of %zu bytes, bursts of %zu bytes\n",
+	       rounds_nr, RLE_MAX_FRAG_NUMBER, sdu_size, burst_size);
+	printf("    %.1f ns per PPDU\n", (double)duration_ns / (double)ppdus_nr);
+	for (level = 0; level < CACHE_LEVELS_NR; level++) {
+		if (counters[level] < 0 ||
+		    read(counters[level], &misses[level], sizeof(misses[level])) !=
+		    sizeof(misses[level])) {
+			printf("    %s read misses: counter unavailable on this host\n",
+			       cache_level_names[level]);
+			continue;
+		}
+		printf("    %s read misses: %.2f per PPDU\n", cache_level_names[level],
+		       (double)misses[level] / (double)ppdus_nr);
+	}
+
+	is_ok = true;
+
+close:
+	for (level = 0; level < CACHE_LEVELS_NR; level++) {
+		if (counters[level] >= 0) {
+			close(counters[level]);
+		}
+	}
+free:
+	free(evict);
+	free(sdu_buffer);
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+
+	return is_ok;
+}
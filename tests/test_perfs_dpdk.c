@@ -0,0 +1,348 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   test_perfs_dpdk.c
+ * @brief  Throughput test of the DPDK adapter, on a loopback between a DPDK transmitter and a
+ *         DPDK receiver.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+/* system includes */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <getopt.h>
+
+/* DPDK includes */
+#include <rte_eal.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+#include "rle.h"
+#include "rle_dpdk.h"
+
+/** The program version */
+#define TEST_VERSION  "RLE DPDK performances test application, version 0.0.1\n"
+
+/** Number of mbufs of the mempool */
+#define MBUFS_NR  8191
+
+/** Size of the per-lcore cache of the mempool */
+#define MBUFS_CACHE_SIZE  256
+
+/** Size of the bursts of SDUs and FPDUs */
+#define BURST_SIZE  32
+
+/** Default number of SDUs, size of SDUs and size of FPDUs */
+#define DEFAULT_SDUS_NR  1000000
+#define DEFAULT_SDU_SIZE  1000
+#define DEFAULT_FPDU_SIZE  599
+
+/* prototypes of private functions */
+static void usage(void);
+static int test_loopback(struct rte_mempool *const pool, const size_t sdus_nr,
+                         const size_t sdu_size, const size_t fpdu_size);
+static uint16_t alloc_sdus(struct rte_mempool *const pool, struct rte_mbuf *sdus[],
+                           const uint16_t sdus_nr, const size_t sdu_size);
+static size_t receive_fpdus(struct rle_dpdk_rx *const rx, struct rte_mbuf *fpdus[],
+                            const uint16_t fpdus_nr, const size_t sdu_size);
+
+
+/**
+ * @brief Main function for the RLE DPDK test program
+ *
+ * @param[in] argc The number of program arguments, EAL arguments first
+ * @param[in] argv The program arguments, EAL arguments first
+ * @return         The unix return code:
+ *                 \li 0 in case of success,
+ *                 \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct rte_mempool *pool;
+	size_t sdus_nr = DEFAULT_SDUS_NR;
+	size_t sdu_size = DEFAULT_SDU_SIZE;
+	size_t fpdu_size = DEFAULT_FPDU_SIZE;
+	int status = EXIT_FAILURE;
+	int ret;
+
+	ret = rte_eal_init(argc, argv);
+	if (ret < 0) {
+		fprintf(stderr, "ERROR: EAL not initialized\n");
+		goto error;
+	}
+	argc -= ret;
+	argv += ret;
+
+	while (1) {
+		int c;
+
+		static struct option long_options[] =
+		{
+			{ "sdus", required_argument, 0, 'n' },
+			{ "sdu_size", required_argument, 0, 's' },
+			{ "fpdu_size", required_argument, 0, 'f' },
+			{ 0, 0, 0, 0 }
+		};
+
+		int option_index = 0;
+
+		c = getopt_long(argc, argv, "vhn:s:f:", long_options, &option_index);
+
+		if (c == -1) {
+			break;
+		}
+
+		switch (c) {
+		case 'n': /* Number of SDUs */
+			sdus_nr = strtoul(optarg, NULL, 10);
+			break;
+		case 's': /* Size of SDUs */
+			sdu_size = strtoul(optarg, NULL, 10);
+			if (sdu_size == 0 || sdu_size > RLE_MAX_PDU_SIZE) {
+				printf("ERROR: %zu-octet SDUs, from 1 to %d octets.\n", sdu_size,
+				       RLE_MAX_PDU_SIZE);
+				goto cleanup_eal;
+			}
+			break;
+		case 'f': /* Size of FPDUs */
+			fpdu_size = strtoul(optarg, NULL, 10);
+			break;
+		case 'v': /* Version */
+			printf(TEST_VERSION);
+			status = EXIT_SUCCESS;
+			goto cleanup_eal;
+		case 'h': /* Help */
+			usage();
+			status = EXIT_SUCCESS;
+			goto cleanup_eal;
+		case '?':
+		default:
+			usage();
+			goto cleanup_eal;
+		}
+	}
+
+	pool = rte_pktmbuf_pool_create("rle_perfs", MBUFS_NR, MBUFS_CACHE_SIZE, 0,
+	                               RTE_MBUF_DEFAULT_BUF_SIZE, rte_socket_id());
+	if (pool == NULL) {
+		fprintf(stderr, "ERROR: mempool not created\n");
+		goto cleanup_eal;
+	}
+
+	status = test_loopback(pool, sdus_nr, sdu_size, fpdu_size);
+
+	rte_mempool_free(pool);
+
+	printf("=== exit test with code %d\n", status);
+cleanup_eal:
+	rte_eal_cleanup();
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the DPDK performance test application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "RLE DPDK performances test tool: test the RLE DPDK adapter on a loopback.\n"
+	        "\n"
+	        "usage: test_perfs_dpdk [EAL OPTIONS] -- [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                      Print version information and exit\n"
+	        "  -h                      Print this usage and exit\n"
+	        "  --sdus, -n              Number of SDUs (default 1000000)\n"
+	        "  --sdu_size, -s          Size of the IPv4 SDUs (default 1000 octets)\n"
+	        "  --fpdu_size, -f         Size of the FPDUs (default 599 octets)\n");
+
+	return;
+}
+
+
+/**
+ * @brief         Allocate and fill a burst of IPv4 SDU mbufs.
+ *
+ * @param[in]     pool      The mempool of the SDUs.
+ * @param[out]    sdus      The SDU mbufs.
+ * @param[in]     sdus_nr   The number of SDUs to allocate.
+ * @param[in]     sdu_size  The size of the SDUs.
+ * @return                  The number of SDUs allocated.
+ */
+static uint16_t alloc_sdus(struct rte_mempool *const pool, struct rte_mbuf *sdus[],
+                           const uint16_t sdus_nr, const size_t sdu_size)
+{
+	uint16_t i;
+
+	if (rte_pktmbuf_alloc_bulk(pool, sdus, sdus_nr) != 0) {
+		return 0;
+	}
+
+	for (i = 0; i < sdus_nr; i++) {
+		unsigned char *const sdu = (unsigned char *)rte_pktmbuf_append(sdus[i], sdu_size);
+
+		if (sdu == NULL) {
+			rte_pktmbuf_free_bulk(&sdus[i], sdus_nr - i);
+			return i;
+		}
+		memset(sdu, i & 0xff, sdu_size);
+		sdu[0] = 0x45;
+	}
+
+	return sdus_nr;
+}
+
+
+/**
+ * @brief         Decapsulate a burst of FPDUs and free the SDUs received.
+ *
+ * @param[in,out] rx        The DPDK receiver.
+ * @param[in,out] fpdus     The FPDUs, consumed.
+ * @param[in]     fpdus_nr  The number of FPDUs.
+ * @param[in]     sdu_size  The size of the SDUs.
+ * @return                  The number of SDUs received with the right size.
+ */
+static size_t receive_fpdus(struct rle_dpdk_rx *const rx, struct rte_mbuf *fpdus[],
+                            const uint16_t fpdus_nr, const size_t sdu_size)
+{
+	/* a FPDU completes at most one SDU per context, plus its COMPLETE PPDUs */
+	struct rte_mbuf *sdus[BURST_SIZE * 4];
+	size_t received_nr = 0;
+	uint16_t sdus_nr;
+	uint16_t i;
+
+	sdus_nr = rle_dpdk_decap_burst(rx, fpdus, fpdus_nr, sdus, BURST_SIZE * 4);
+	for (i = 0; i < sdus_nr; i++) {
+		if (sdus[i]->pkt_len == sdu_size) {
+			received_nr++;
+		}
+	}
+	rte_pktmbuf_free_bulk(sdus, sdus_nr);
+
+	return received_nr;
+}
+
+
+/**
+ * @brief         Encapsulate, fragment, pack and decapsulate SDUs with the DPDK adapter.
+ *
+ * @param[in]     pool       The mempool of the SDUs and FPDUs.
+ * @param[in]     sdus_nr    The number of SDUs.
+ * @param[in]     sdu_size   The size of the SDUs.
+ * @param[in]     fpdu_size  The size of the FPDUs.
+ * @return                   0 in case of success, 1 otherwise.
+ */
+static int test_loopback(struct rte_mempool *const pool, const size_t sdus_nr,
+                         const size_t sdu_size, const size_t fpdu_size)
+{
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x30,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	uint16_t protocol_types[BURST_SIZE];
+	struct rte_mbuf *sdus[BURST_SIZE];
+	struct rte_mbuf *fpdus[BURST_SIZE];
+	struct rle_dpdk_tx *tx = NULL;
+	struct rle_dpdk_rx *rx = NULL;
+	size_t sent_nr = 0;
+	size_t received_nr = 0;
+	size_t fpdus_total_nr = 0;
+	uint64_t start;
+	double duration;
+	int status = 1;
+	uint16_t i;
+
+	for (i = 0; i < BURST_SIZE; i++) {
+		protocol_types[i] = RLE_PROTO_TYPE_IPV4_UNCOMP;
+	}
+
+	tx = rle_dpdk_tx_new(&conf, pool, NULL, 0, fpdu_size);
+	rx = rle_dpdk_rx_new(&conf, pool, 0);
+	if (tx == NULL || rx == NULL) {
+		fprintf(stderr, "ERROR: DPDK transmitter or receiver not created\n");
+		goto out;
+	}
+
+	start = rte_rdtsc();
+
+	while (sent_nr < sdus_nr) {
+		const uint16_t burst_nr = (sdus_nr - sent_nr) < BURST_SIZE ?
+		                          (uint16_t)(sdus_nr - sent_nr) : BURST_SIZE;
+		uint16_t allocated_nr;
+		uint16_t consumed_nr = 0;
+		uint16_t fpdus_nr;
+
+		allocated_nr = alloc_sdus(pool, sdus, burst_nr, sdu_size);
+		if (allocated_nr == 0) {
+			fprintf(stderr, "ERROR: SDUs not allocated\n");
+			goto out;
+		}
+
+		/* the SDUs wait for free contexts, freed by the FPDUs built */
+		while (consumed_nr < allocated_nr) {
+			consumed_nr += rle_dpdk_encap_burst(tx, &sdus[consumed_nr],
+			                                    &protocol_types[consumed_nr],
+			                                    allocated_nr - consumed_nr);
+
+			fpdus_nr = rle_dpdk_fpdu_burst(tx, fpdus, BURST_SIZE);
+			fpdus_total_nr += fpdus_nr;
+			received_nr += receive_fpdus(rx, fpdus, fpdus_nr, sdu_size);
+		}
+		sent_nr += allocated_nr;
+	}
+
+	/* flush the SDUs still being fragmented */
+	while ((i = rle_dpdk_fpdu_burst(tx, fpdus, BURST_SIZE)) > 0) {
+		fpdus_total_nr += i;
+		received_nr += receive_fpdus(rx, fpdus, i, sdu_size);
+	}
+
+	duration = (double)(rte_rdtsc() - start) / (double)rte_get_tsc_hz();
+
+	printf("%zu %zu-octet SDUs sent in %zu %zu-octet FPDUs, %zu received, %" PRIu64
+	       " dropped\n", sent_nr, sdu_size, fpdus_total_nr, fpdu_size, received_nr,
+	       rle_dpdk_rx_get_sdus_dropped(rx));
+	printf("%.3f s, %.3f Mpps, %.3f Gbps\n", duration, sent_nr / duration / 1e6,
+	       sent_nr * sdu_size * 8 / duration / 1e9);
+
+	status = (received_nr == sent_nr ? 0 : 1);
+
+out:
+	rle_dpdk_rx_destroy(&rx);
+	rle_dpdk_tx_destroy(&tx);
+	return status;
+}
@@ -0,0 +1,727 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   test_perfs_latency.c
+ * @brief  Loopback latency test, timestamping each SDU from its encapsulation to its
+ *         decapsulation, for sizes of FPDUs, bursts and SDUs.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * The SDUs are encapsulated back to back in the context 0, fragmented in bursts of at most the
+ * burst size, and packed in FPDUs sent to the receiver when full, so that the last fragment of
+ * a SDU waits in its FPDU for the fragments of the next ones. The latency of a SDU is split in:
+ *
+ *  - the library CPU time: its calls to rle_encapsulate(), rle_fragment() and rle_pack(), and
+ *    the calls to rle_decapsulate() of all the FPDUs carrying its fragments, charged in full
+ *    to each SDU of these FPDUs. The cost of reading the clock is measured and deducted,
+ *  - the serialization waits: the number of FPDUs from the one of its first fragment to the one
+ *    it is delivered in, in microseconds at the link rate if given.
+ */
+
+/* system includes */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+
+#include "rle.h"
+#include "test_rle_common.h"
+
+/** The program version */
+#define TEST_VERSION  "RLE loopback latency test application, version 0.0.1\n"
+
+/** Min and max burst sizes, and max FPDU size of the test. */
+#define MIN_BURST_SIZE 14
+#define MAX_BURST_SIZE 2049
+#define MAX_FPDU_SIZE  4096
+
+/** Max number of sizes of a list */
+#define MAX_SIZES_NR  16
+
+/** Default number of SDUs of each run */
+#define DEFAULT_SDUS_NR  10000
+
+/** Max number of SDUs decapsulated from one FPDU */
+#define MAX_SDUS_NB  (MAX_FPDU_SIZE / 2)
+
+/** The stages of the library timed for each SDU */
+enum latency_stage {
+	LATENCY_ENCAP,      /**< rle_encapsulate().  */
+	LATENCY_FRAG,       /**< rle_fragment().     */
+	LATENCY_PACK,       /**< rle_pack().         */
+	LATENCY_DECAP,      /**< rle_decapsulate().  */
+	LATENCY_STAGES_NR,  /**< Number of stages.   */
+};
+
+/** The names of the stages */
+static const char *const latency_stage_names[LATENCY_STAGES_NR] = {
+	"encap", "frag", "pack", "decap"
+};
+
+/** The configuration of the transmitter and of the receiver */
+static const struct rle_config latency_conf = {
+	.allow_ptype_omission = 0,
+	.use_compressed_ptype = 1,
+	.allow_alpdu_crc = 0,
+	.allow_alpdu_sequence_number = 1,
+	.use_explicit_payload_header_map = 0,
+	.implicit_protocol_type = 0x00,
+	.implicit_ppdu_label_size = 0,
+	.implicit_payload_label_size = 0,
+	.type_0_alpdu_label_size = 0,
+};
+
+/** A list of sizes given on the command line */
+struct latency_sizes {
+	size_t sizes[MAX_SIZES_NR];  /**< The sizes.           */
+	size_t sizes_nr;             /**< The number of sizes. */
+};
+
+/** The timestamps of a SDU in flight */
+struct latency_sdu {
+	uint64_t start_ns;                     /**< The time it is given to encapsulation.    */
+	uint64_t stages_ns[LATENCY_STAGES_NR]; /**< The CPU time of each stage.               */
+	uint64_t decap_mark_ns;                /**< The decapsulation time before its FPDUs.  */
+	size_t first_fpdu;                     /**< The index of the FPDU of its 1st fragment. */
+	bool packed;                           /**< Whether a fragment is packed.             */
+};
+
+/** The state of a run */
+struct latency_run {
+	struct rle_transmitter *transmitter;  /**< The transmitter.                             */
+	struct rle_receiver *receiver;        /**< The receiver.                                */
+	size_t fpdu_size;                     /**< The size of the FPDUs.                       */
+	size_t burst_size;                    /**< The max size of the PPDUs.                   */
+	unsigned char fpdu[MAX_FPDU_SIZE];    /**< The FPDU being packed.                       */
+	size_t fpdu_cur_pos;                  /**< The current position in the FPDU.            */
+	size_t fpdu_remain_size;              /**< The remaining size in the FPDU.              */
+	size_t fpdus_sent;                    /**< The number of FPDUs sent.                    */
+	uint64_t decap_total_ns;              /**< The total decapsulation time.                */
+	struct rle_sdu *sdus_out;             /**< The SDUs decapsulated from a FPDU.           */
+	size_t sdu_size;                      /**< The size of the SDUs.                        */
+	struct latency_sdu *sdus;             /**< The SDUs of the run.                         */
+	size_t sdus_delivered;                /**< The number of SDUs decapsulated.             */
+	uint64_t *wall_ns;                    /**< The latency of each SDU.                     */
+	uint64_t *cpu_ns;                     /**< The library CPU time of each SDU.            */
+	uint64_t *fpdus;                      /**< The FPDUs spanned by each SDU.               */
+	uint64_t stages_total_ns[LATENCY_STAGES_NR];  /**< The CPU time of the stages.          */
+	bool failed;                          /**< Whether the run failed.                      */
+};
+
+/** The cost of reading the clock, deducted from the durations */
+static uint64_t clock_overhead_ns;
+
+/* prototypes of private functions */
+static void usage(void);
+static bool parse_sizes(const char *const arg, const size_t min, const size_t max,
+                        struct latency_sizes *const sizes);
+static uint64_t now_ns(void);
+static uint64_t elapsed_ns(const uint64_t start_ns, const uint64_t end_ns);
+static void calibrate_clock(void);
+static int compare_u64(const void *const a, const void *const b);
+static uint64_t percentile(const uint64_t sorted[], const size_t nr, const double ratio);
+static void print_distribution(const char *const name, uint64_t values[], const size_t nr,
+                               const double scale);
+static void send_fpdu(struct latency_run *const run);
+static bool send_sdu(struct latency_run *const run, const struct rle_sdu *const sdu,
+                     const size_t sdu_index);
+static bool latency(struct latency_run *const run, const size_t sdus_nr, const bool flush,
+                    const double rate, const bool stats);
+
+
+/**
+ * @brief Main function for the RLE loopback latency test program
+ *
+ * @param[in] argc The number of program arguments
+ * @param[in] argv The program arguments
+ * @return         The unix return code:
+ *                 \li 0 in case of success,
+ *                 \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct latency_sizes fpdu_sizes = { { 150, 599, 1500 }, 3 };
+	struct latency_sizes burst_sizes = { { 64, 150, 599, 1500 }, 4 };
+	struct latency_sizes sdu_sizes = { { 64, 200, 1500 }, 3 };
+	struct latency_run *run = NULL;
+	unsigned char *sdu_buffers = NULL;
+	size_t sdus_nr = DEFAULT_SDUS_NR;
+	bool flush = false;
+	bool stats = false;
+	double rate = 0;
+	int status = EXIT_FAILURE;
+	size_t fpdu_it;
+	size_t burst_it;
+	size_t sdu_it;
+	size_t it;
+
+	while (1) {
+		int c;
+
+		static struct option long_options[] =
+		{
+			{ "sdus", required_argument, 0, 'n' },
+			{ "fpdu", required_argument, 0, 'f' },
+			{ "burst", required_argument, 0, 'b' },
+			{ "sdu", required_argument, 0, 's' },
+			{ "rate", required_argument, 0, 'r' },
+			{ "flush", no_argument, 0, 'F' },
+			{ "stats", no_argument, 0, 'S' },
+			{ 0, 0, 0, 0 }
+		};
+
+		int option_index = 0;
+
+		c = getopt_long(argc, argv, "vhn:f:b:s:r:", long_options, &option_index);
+
+		if (c == -1) {
+			break;
+		}
+
+		switch (c) {
+		case 'n': /* Number of SDUs of each run */
+			sdus_nr = strtoul(optarg, NULL, 10);
+			if (sdus_nr == 0) {
+				printf("ERROR: at least one SDU is required.\n");
+				goto error;
+			}
+			break;
+		case 'f': /* FPDU sizes */
+			if (!parse_sizes(optarg, MIN_BURST_SIZE, MAX_FPDU_SIZE, &fpdu_sizes)) {
+				goto error;
+			}
+			break;
+		case 'b': /* Burst sizes */
+			if (!parse_sizes(optarg, MIN_BURST_SIZE, MAX_BURST_SIZE, &burst_sizes)) {
+				goto error;
+			}
+			break;
+		case 's': /* SDU sizes */
+			if (!parse_sizes(optarg, 1, RLE_MAX_PDU_SIZE, &sdu_sizes)) {
+				goto error;
+			}
+			break;
+		case 'r': /* Link rate */
+			rate = strtod(optarg, NULL);
+			if (rate <= 0) {
+				printf("ERROR: link rate '%s', in Mbit/s.\n", optarg);
+				goto error;
+			}
+			break;
+		case 'F': /* One SDU per FPDU */
+			flush = true;
+			break;
+		case 'S': /* Statistics of the modules */
+			stats = true;
+			break;
+		case 'v': /* Version */
+			printf(TEST_VERSION);
+			status = EXIT_SUCCESS;
+			goto error;
+		case 'h': /* Help */
+			usage();
+			status = EXIT_SUCCESS;
+			goto error;
+		case '?':
+		default:
+			usage();
+			goto error;
+		}
+	}
+
+	if (optind != argc) {
+		usage();
+		goto error;
+	}
+
+	run = calloc(1, sizeof(*run));
+	sdu_buffers = malloc(MAX_SDUS_NB * RLE_MAX_PDU_SIZE);
+	if (run == NULL || sdu_buffers == NULL) {
+		printf("ERROR: failed to allocate the run.\n");
+		goto free_run;
+	}
+	run->sdus_out = calloc(MAX_SDUS_NB, sizeof(struct rle_sdu));
+	run->sdus = calloc(sdus_nr, sizeof(struct latency_sdu));
+	run->wall_ns = calloc(sdus_nr, sizeof(uint64_t));
+	run->cpu_ns = calloc(sdus_nr, sizeof(uint64_t));
+	run->fpdus = calloc(sdus_nr, sizeof(uint64_t));
+	if (run->sdus_out == NULL || run->sdus == NULL || run->wall_ns == NULL ||
+	    run->cpu_ns == NULL || run->fpdus == NULL) {
+		printf("ERROR: failed to allocate the timestamps.\n");
+		goto free_run;
+	}
+	for (it = 0; it < MAX_SDUS_NB; it++) {
+		run->sdus_out[it].buffer = sdu_buffers + it * RLE_MAX_PDU_SIZE;
+	}
+
+	calibrate_clock();
+	printf("=== %zu SDUs per run, %s, clock overhead %llu ns deducted\n", sdus_nr,
+	       flush ? "one SDU per FPDU" : "SDUs back to back", (unsigned long long)clock_overhead_ns);
+
+	for (fpdu_it = 0; fpdu_it < fpdu_sizes.sizes_nr; fpdu_it++) {
+		for (burst_it = 0; burst_it < burst_sizes.sizes_nr; burst_it++) {
+			/* a burst is at most a FPDU */
+			if (burst_sizes.sizes[burst_it] > fpdu_sizes.sizes[fpdu_it]) {
+				continue;
+			}
+			for (sdu_it = 0; sdu_it < sdu_sizes.sizes_nr; sdu_it++) {
+				run->fpdu_size = fpdu_sizes.sizes[fpdu_it];
+				run->burst_size = burst_sizes.sizes[burst_it];
+				run->sdu_size = sdu_sizes.sizes[sdu_it];
+				if (!latency(run, sdus_nr, flush, rate, stats)) {
+					goto free_run;
+				}
+			}
+		}
+	}
+
+	status = EXIT_SUCCESS;
+
+free_run:
+	if (run != NULL) {
+		free(run->sdus_out);
+		free(run->sdus);
+		free(run->wall_ns);
+		free(run->cpu_ns);
+		free(run->fpdus);
+		free(run);
+	}
+	free(sdu_buffers);
+	printf("=== exit test with code %d\n", status);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the loopback latency test application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "RLE loopback latency test tool: timestamp each SDU from rle_encapsulate() to\n"
+	        "rle_decapsulate(), fragmented in bursts packed in FPDUs.\n"
+	        "\n"
+	        "For each FPDU size, burst size up to the FPDU size, and SDU size, print the\n"
+	        "distributions of the latencies, of the library CPU times, and of the FPDUs\n"
+	        "spanned by the SDUs, with the mean CPU time of each stage.\n"
+	        "\n"
+	        "usage: test_perfs_latency [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                      Print version information and exit\n"
+	        "  -h                      Print this usage and exit\n"
+	        "  --sdus, -n              Number of SDUs of each run (default %d)\n"
+	        "  --fpdu, -f              Comma-separated FPDU sizes, up to %d (default 150,599,1500)\n"
+	        "  --burst, -b             Comma-separated burst sizes, from %d to %d\n"
+	        "                          (default 64,150,599,1500)\n"
+	        "  --sdu, -s               Comma-separated SDU sizes, up to %d (default 64,200,1500)\n"
+	        "  --rate, -r              Link rate in Mbit/s, to print the serialization waits in\n"
+	        "                          microseconds\n"
+	        "  --flush                 Send the FPDU after each SDU, as on an idle link\n"
+	        "  --stats                 Print the statistics of the modules after each run\n",
+	        DEFAULT_SDUS_NR, MAX_FPDU_SIZE, MIN_BURST_SIZE, MAX_BURST_SIZE, RLE_MAX_PDU_SIZE);
+
+	return;
+}
+
+
+/**
+ * @brief         Parse a comma-separated list of sizes.
+ *
+ * @param[in]     arg    The list.
+ * @param[in]     min    The min size.
+ * @param[in]     max    The max size.
+ * @param[out]    sizes  The sizes parsed.
+ *
+ * @return        true in case of success, false otherwise.
+ */
+static bool parse_sizes(const char *const arg, const size_t min, const size_t max,
+                        struct latency_sizes *const sizes)
+{
+	const char *cur = arg;
+
+	sizes->sizes_nr = 0;
+	while (*cur != '\0') {
+		char *end;
+		const size_t size = strtoul(cur, &end, 10);
+
+		if (end == cur || (*end != ',' && *end != '\0') || size < min || size > max) {
+			printf("ERROR: size list '%s', sizes from %zu to %zu.\n", arg, min, max);
+			return false;
+		}
+		if (sizes->sizes_nr == MAX_SIZES_NR) {
+			printf("ERROR: size list '%s', at most %d sizes.\n", arg, MAX_SIZES_NR);
+			return false;
+		}
+		sizes->sizes[sizes->sizes_nr++] = size;
+		cur = (*end == ',' ? end + 1 : end);
+	}
+
+	if (sizes->sizes_nr == 0) {
+		printf("ERROR: empty size list.\n");
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief         Get the monotonic time.
+ *
+ * @return        The monotonic time in ns.
+ */
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * @brief         Get the duration between two times, the clock overhead deducted.
+ *
+ * @param[in]     start_ns  The start time.
+ * @param[in]     end_ns    The end time.
+ *
+ * @return        The duration in ns, 0 if shorter than the clock overhead.
+ */
+static uint64_t elapsed_ns(const uint64_t start_ns, const uint64_t end_ns)
+{
+	const uint64_t duration = end_ns - start_ns;
+
+	return duration > clock_overhead_ns ? duration - clock_overhead_ns : 0;
+}
+
+
+/**
+ * @brief         Measure the cost of reading the clock, the least of many reads.
+ */
+static void calibrate_clock(void)
+{
+	size_t it;
+
+	clock_overhead_ns = UINT64_MAX;
+	for (it = 0; it < 10000; it++) {
+		const uint64_t start_ns = now_ns();
+		const uint64_t duration = now_ns() - start_ns;
+
+		if (duration < clock_overhead_ns) {
+			clock_overhead_ns = duration;
+		}
+	}
+
+	return;
+}
+
+
+/**
+ * @brief         Compare two unsigned integers, for qsort().
+ *
+ * @param[in]     a  The first integer.
+ * @param[in]     b  The second integer.
+ *
+ * @return        -1, 0 or 1 if a is lower, equal or greater than b.
+ */
+static int compare_u64(const void *const a, const void *const b)
+{
+	const uint64_t value_a = *(const uint64_t *)a;
+	const uint64_t value_b = *(const uint64_t *)b;
+
+	return (value_a > value_b) - (value_a < value_b);
+}
+
+
+/**
+ * @brief         Get a percentile of sorted values.
+ *
+ * @param[in]     sorted  The values, sorted.
+ * @param[in]     nr      The number of values, at least 1.
+ * @param[in]     ratio   The percentile, from 0 to 1.
+ *
+ * @return        The value of the percentile.
+ */
+static uint64_t percentile(const uint64_t sorted[], const size_t nr, const double ratio)
+{
+	size_t index = (size_t)(ratio * (double)nr);
+
+	return sorted[index < nr ? index : nr - 1];
+}
+
+
+/**
+ * @brief         Sort and print the distribution of values.
+ *
+ * @param[in]     name    The name of the values.
+ * @param[in,out] values  The values, sorted on return.
+ * @param[in]     nr      The number of values, at least 1.
+ * @param[in]     scale   The factor of the values printed.
+ */
+static void print_distribution(const char *const name, uint64_t values[], const size_t nr,
+                               const double scale)
+{
+	double mean = 0;
+	size_t it;
+
+	qsort(values, nr, sizeof(uint64_t), compare_u64);
+	for (it = 0; it < nr; it++) {
+		mean += (double)values[it];
+	}
+	mean /= (double)nr;
+
+	printf("  %-18s mean %10.1f  p50 %10.1f  p90 %10.1f  p99 %10.1f  p99.9 %10.1f  "
+	       "max %10.1f\n", name, mean * scale, (double)percentile(values, nr, 0.50) * scale,
+	       (double)percentile(values, nr, 0.90) * scale,
+	       (double)percentile(values, nr, 0.99) * scale,
+	       (double)percentile(values, nr, 0.999) * scale, (double)values[nr - 1] * scale);
+
+	return;
+}
+
+
+/**
+ * @brief         Pad and send the FPDU to the receiver, then reset it, timestamping the SDUs
+ *                delivered.
+ *
+ * @param[in,out] run  The run.
+ */
+static void send_fpdu(struct latency_run *const run)
+{
+	enum rle_decap_status ret_decap;
+	size_t sdus_nr = 0;
+	uint64_t start_ns;
+	uint64_t end_ns;
+	size_t it;
+
+	rle_pad(run->fpdu, run->fpdu_cur_pos, run->fpdu_remain_size);
+
+	start_ns = now_ns();
+	ret_decap = rle_decapsulate(run->receiver, run->fpdu, run->fpdu_size, run->sdus_out,
+	                            MAX_SDUS_NB, &sdus_nr, NULL, 0);
+	end_ns = now_ns();
+	run->decap_total_ns += elapsed_ns(start_ns, end_ns);
+	run->fpdus_sent++;
+	if (ret_decap != RLE_DECAP_OK) {
+		printf("ERROR: decapsulation failed (%d)\n", ret_decap);
+		run->failed = true;
+	}
+
+	/* the SDUs of the context 0 are delivered in order */
+	for (it = 0; it < sdus_nr; it++) {
+		struct latency_sdu *const sdu = &run->sdus[run->sdus_delivered];
+		uint64_t cpu_ns;
+		enum latency_stage stage;
+
+		if (run->sdus_out[it].size != run->sdu_size) {
+			printf("ERROR: SDU %zu of %zu octets decapsulated, %zu expected\n",
+			       run->sdus_delivered, run->sdus_out[it].size, run->sdu_size);
+			run->failed = true;
+		}
+
+		sdu->stages_ns[LATENCY_DECAP] = run->decap_total_ns - sdu->decap_mark_ns;
+		cpu_ns = 0;
+		for (stage = 0; stage < LATENCY_STAGES_NR; stage++) {
+			cpu_ns += sdu->stages_ns[stage];
+			run->stages_total_ns[stage] += sdu->stages_ns[stage];
+		}
+		run->wall_ns[run->sdus_delivered] = end_ns - sdu->start_ns;
+		run->cpu_ns[run->sdus_delivered] = cpu_ns;
+		run->fpdus[run->sdus_delivered] = run->fpdus_sent - sdu->first_fpdu;
+		run->sdus_delivered++;
+	}
+
+	run->fpdu_cur_pos = 0;
+	run->fpdu_remain_size = run->fpdu_size;
+
+	return;
+}
+
+
+/**
+ * @brief         Encapsulate, fragment and pack one SDU, sending the FPDUs filled.
+ *
+ * @param[in,out] run        The run.
+ * @param[in]     sdu        The SDU.
+ * @param[in]     sdu_index  The index of the SDU in the run.
+ *
+ * @return        true in case of success, false otherwise.
+ */
+static bool send_sdu(struct latency_run *const run, const struct rle_sdu *const sdu,
+                     const size_t sdu_index)
+{
+	struct latency_sdu *const timestamps = &run->sdus[sdu_index];
+	const uint8_t frag_id = 0;
+	enum rle_encap_status ret_encap;
+	uint64_t start_ns;
+
+	memset(timestamps, 0, sizeof(*timestamps));
+	timestamps->start_ns = now_ns();
+
+	start_ns = now_ns();
+	ret_encap = rle_encapsulate(run->transmitter, sdu, frag_id);
+	timestamps->stages_ns[LATENCY_ENCAP] = elapsed_ns(start_ns, now_ns());
+	if (ret_encap != RLE_ENCAP_OK) {
+		printf("ERROR: encapsulation failed (%d)\n", ret_encap);
+		return false;
+	}
+
+	while (rle_transmitter_stats_get_queue_size(run->transmitter, frag_id) != 0) {
+		enum rle_frag_status ret_frag;
+		enum rle_pack_status ret_pack;
+		unsigned char *ppdu;
+		size_t ppdu_length = 0;
+		size_t burst_size;
+
+		/* a burst fills the FPDU, or the FPDU is sent and a burst fills the next one */
+		burst_size = (run->fpdu_remain_size < run->burst_size ?
+		              run->fpdu_remain_size : run->burst_size);
+		start_ns = now_ns();
+		ret_frag = rle_fragment(run->transmitter, frag_id, burst_size, &ppdu, &ppdu_length);
+		timestamps->stages_ns[LATENCY_FRAG] += elapsed_ns(start_ns, now_ns());
+		if (ret_frag == RLE_FRAG_ERR_BURST_TOO_SMALL && run->fpdu_cur_pos != 0) {
+			send_fpdu(run);
+			start_ns = now_ns();
+			ret_frag = rle_fragment(run->transmitter, frag_id, run->burst_size, &ppdu,
+			                        &ppdu_length);
+			timestamps->stages_ns[LATENCY_FRAG] += elapsed_ns(start_ns, now_ns());
+		}
+		if (ret_frag != RLE_FRAG_OK) {
+			printf("ERROR: fragmentation failed (%d)\n", ret_frag);
+			return false;
+		}
+
+		/* the decapsulation of the FPDUs from this one on is charged to the SDU */
+		if (!timestamps->packed) {
+			timestamps->first_fpdu = run->fpdus_sent;
+			timestamps->decap_mark_ns = run->decap_total_ns;
+			timestamps->packed = true;
+		}
+
+		start_ns = now_ns();
+		ret_pack = rle_pack(ppdu, ppdu_length, NULL, 0, run->fpdu, &run->fpdu_cur_pos,
+		                    &run->fpdu_remain_size);
+		timestamps->stages_ns[LATENCY_PACK] += elapsed_ns(start_ns, now_ns());
+		if (ret_pack != RLE_PACK_OK) {
+			printf("ERROR: packing failed (%d)\n", ret_pack);
+			return false;
+		}
+		if (run->failed) {
+			return false;
+		}
+	}
+
+	return !run->failed;
+}
+
+
+/**
+ * @brief         Send SDUs through a new transmitter and receiver, and print their latencies.
+ *
+ * @param[in,out] run      The run, sized.
+ * @param[in]     sdus_nr  The number of SDUs.
+ * @param[in]     flush    Whether to send the FPDU after each SDU.
+ * @param[in]     rate     The link rate in Mbit/s, 0 if unknown.
+ * @param[in]     stats    Whether to print the statistics of the modules.
+ *
+ * @return        true in case of success, false otherwise.
+ */
+static bool latency(struct latency_run *const run, const size_t sdus_nr, const bool flush,
+                    const double rate, const bool stats)
+{
+	unsigned char sdu_buffer[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdu;
+	enum latency_stage stage;
+	bool success = false;
+	size_t it;
+
+	/* an IPv4 SDU */
+	memcpy(sdu_buffer, payload_initializer, run->sdu_size);
+	sdu_buffer[0] = 0x45;
+	sdu.buffer = sdu_buffer;
+	sdu.size = run->sdu_size;
+	sdu.protocol_type = 0x0800;
+
+	run->transmitter = rle_transmitter_new(&latency_conf);
+	run->receiver = rle_receiver_new(&latency_conf);
+	if (run->transmitter == NULL || run->receiver == NULL) {
+		printf("ERROR: failed to create the transmitter or the receiver.\n");
+		goto destroy;
+	}
+	run->fpdu_cur_pos = 0;
+	run->fpdu_remain_size = run->fpdu_size;
+	run->fpdus_sent = 0;
+	run->decap_total_ns = 0;
+	run->sdus_delivered = 0;
+	memset(run->stages_total_ns, 0, sizeof(run->stages_total_ns));
+	run->failed = false;
+
+	for (it = 0; it < sdus_nr; it++) {
+		if (!send_sdu(run, &sdu, it)) {
+			goto destroy;
+		}
+		if (flush) {
+			send_fpdu(run);
+		}
+	}
+	if (run->fpdu_cur_pos != 0) {
+		send_fpdu(run);
+	}
+	if (run->failed || run->sdus_delivered != sdus_nr) {
+		printf("ERROR: %zu SDUs decapsulated, %zu sent\n", run->sdus_delivered, sdus_nr);
+		goto destroy;
+	}
+
+	printf("=== FPDU %zu, burst %zu, SDU %zu: %zu FPDUs, %.2f FPDUs per SDU\n", run->fpdu_size,
+	       run->burst_size, run->sdu_size, run->fpdus_sent,
+	       (double)run->fpdus_sent / (double)sdus_nr);
+	print_distribution("latency (ns)", run->wall_ns, sdus_nr, 1.0);
+	print_distribution("library CPU (ns)", run->cpu_ns, sdus_nr, 1.0);
+	printf("  %-18s", "  per stage (ns)");
+	for (stage = 0; stage < LATENCY_STAGES_NR; stage++) {
+		printf(" %s %8.1f", latency_stage_names[stage],
+		       (double)run->stages_total_ns[stage] / (double)sdus_nr);
+	}
+	printf("\n");
+	print_distribution("FPDUs spanned", run->fpdus, sdus_nr, 1.0);
+	if (rate > 0) {
+		/* the FPDUs spanned, serialized at the link rate */
+		print_distribution("serialization (us)", run->fpdus, sdus_nr,
+		                   (double)run->fpdu_size * 8.0 / rate);
+	}
+	if (stats) {
+		print_transmitter_stats(run->transmitter);
+		print_receiver_stats(run->receiver);
+	}
+
+	success = true;
+
+destroy:
+	rle_transmitter_destroy(&run->transmitter);
+	rle_receiver_destroy(&run->receiver);
+	return success;
+}
@@ -0,0 +1,556 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   test_perfs_malformed.c
+ * @brief  Offline performances test of the decapsulation of malformed FPDUs, replaying the
+ *         fuzzing corpus loaded in memory at maximum rate.
+ *
+ *         The payload of every Ethernet frame of the pcap files is decapsulated as a FPDU with a
+ *         3-byte payload label, as test_non_regression_fpdu does. The frames of the SDU fuzzing
+ *         corpus are replayed the same way, their payloads being as malformed FPDUs as any.
+ *
+ *         The FPDUs are timed one by one. A FPDU is clean if no PPDU of it is rejected, else its
+ *         time is shared by the PPDUs it rejects, as counted by the receiver per reason. The
+ *         FPDUs refused by the checks of the API, before any PPDU is parsed, are counted apart.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+/* system includes */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <inttypes.h>
+#include <time.h>
+#include <pcap/pcap.h>
+#include <pcap.h>
+#include <getopt.h>
+
+#include "rle.h"
+
+/** The program version */
+#define TEST_VERSION  "RLE malformed FPDUs performances test application, version 0.0.1\n"
+
+/** The length (in bytes) of the Ethernet header */
+#define ETHER_HDR_LEN  14U
+
+/** The length (in bytes) of the payload label of the FPDUs */
+#define PAYLOAD_LABEL_LEN  3U
+
+/** Default number of replays of the pcap files */
+#define DEFAULT_ITERATIONS 1000
+
+/** Max number of SDUs decapsulated from one FPDU */
+#define MAX_SDUS_NB   100
+
+/** Configuration of the receiver of a run */
+struct bench_conf {
+	const char *name;        /**< The name of the configuration.  */
+	struct rle_config conf;  /**< The RLE configuration.          */
+};
+
+/** The configurations of the sweep, those of test_non_regression_fpdu */
+static const struct bench_conf bench_confs[] = {
+	{
+		.name = "uncomp",
+		.conf = {
+			.allow_ptype_omission = 0,
+			.use_compressed_ptype = 0,
+			.allow_alpdu_crc = 0,
+			.allow_alpdu_sequence_number = 1,
+			.use_explicit_payload_header_map = 0,
+			.implicit_protocol_type = 0x0d,
+			.implicit_ppdu_label_size = 0,
+			.implicit_payload_label_size = 0,
+			.type_0_alpdu_label_size = 0,
+		},
+	},
+	{
+		.name = "comp",
+		.conf = {
+			.allow_ptype_omission = 0,
+			.use_compressed_ptype = 1,
+			.allow_alpdu_crc = 0,
+			.allow_alpdu_sequence_number = 1,
+			.use_explicit_payload_header_map = 0,
+			.implicit_protocol_type = 0x00,
+			.implicit_ppdu_label_size = 0,
+			.implicit_payload_label_size = 0,
+			.type_0_alpdu_label_size = 0,
+		},
+	},
+	{
+		.name = "omission(ip)",
+		.conf = {
+			.allow_ptype_omission = 1,
+			.use_compressed_ptype = 0,
+			.allow_alpdu_crc = 0,
+			.allow_alpdu_sequence_number = 1,
+			.use_explicit_payload_header_map = 0,
+			.implicit_protocol_type = 0x30,
+			.implicit_ppdu_label_size = 0,
+			.implicit_payload_label_size = 0,
+			.type_0_alpdu_label_size = 0,
+		},
+	},
+};
+
+/** The names of the rejection reasons, as printed */
+static const char *const error_names[RLE_RCV_ERR_REASONS_NR] = {
+	[RLE_RCV_ERR_PPDU_LEN] = "PPDU length",
+	[RLE_RCV_ERR_ALPDU_HDR] = "ALPDU header",
+	[RLE_RCV_ERR_CTX_BUSY] = "context busy",
+	[RLE_RCV_ERR_CTX_FREE] = "context free",
+	[RLE_RCV_ERR_SDU_TOO_LONG] = "SDU too long",
+	[RLE_RCV_ERR_SDU_TOO_SHORT] = "SDU too short",
+	[RLE_RCV_ERR_NO_STORAGE] = "no storage",
+	[RLE_RCV_ERR_VLAN] = "VLAN",
+	[RLE_RCV_ERR_CRC] = "CRC",
+	[RLE_RCV_ERR_SEQNO] = "seqnum",
+	[RLE_RCV_ERR_NO_BUFFER] = "no SDU buffer",
+};
+
+/** The FPDUs of the pcap files, loaded in memory */
+struct bench_corpus {
+	unsigned char **fpdus;  /**< The FPDUs, link layer removed. */
+	size_t *lengths;        /**< The lengths of the FPDUs.      */
+	size_t fpdus_nr;        /**< The number of FPDUs.           */
+};
+
+/** The results of the replays of the corpus with a configuration */
+struct bench_result {
+	uint64_t clean_ns;                        /**< Time of the clean FPDUs.           */
+	uint64_t rejecting_ns;                    /**< Time of the FPDUs rejecting PPDUs. */
+	size_t clean_nr;                          /**< Number of clean FPDUs.             */
+	size_t refused_nr;                        /**< Number of FPDUs refused.           */
+	size_t sdus_nr;                           /**< Number of SDUs decapsulated.       */
+	uint64_t errors[RLE_RCV_ERR_REASONS_NR];  /**< Rejections, per reason.            */
+};
+
+/** Buffer preallocation */
+static unsigned char sdu_buffers[MAX_SDUS_NB][RLE_MAX_PDU_SIZE];
+static struct rle_sdu sdus_out[MAX_SDUS_NB];
+
+/** The last log message formatted, with the --log option */
+static char log_message[512];
+
+/* prototypes of private functions */
+static void usage(void);
+static void format_logs(const int module_id, const int level, const char *const file,
+                        const int line, const char *const func, const char *const message, ...)
+__attribute__((format(printf, 6, 7)));
+static int load_corpus(const char *const filename, struct bench_corpus *const corpus);
+static void free_corpus(struct bench_corpus *const corpus);
+static uint64_t now_ns(void);
+static uint64_t count_errors(const struct rle_receiver *const receiver);
+static int bench(const struct bench_corpus *const corpus, const struct bench_conf *const conf,
+                 const size_t iterations, const bool verbose);
+
+
+/**
+ * @brief Main function for the RLE malformed FPDUs performances test program
+ *
+ * @param[in] argc The number of program arguments
+ * @param[in] argv The program arguments
+ * @return         The unix return code:
+ *                 \li 0 in case of success,
+ *                 \li 1 in case of failure,
+ *                 \li 77 in case test is skipped
+ */
+int main(int argc, char *argv[])
+{
+	struct bench_corpus corpus = { NULL, NULL, 0 };
+	size_t iterations = DEFAULT_ITERATIONS;
+	bool verbose = false;
+	int status = EXIT_FAILURE;
+	size_t conf_id;
+	int file_id;
+
+	while (1) {
+		int c;
+
+		static struct option long_options[] =
+		{
+			{ "iterations", required_argument, 0, 'n' },
+			{ "log", no_argument, 0, 'l' },
+			{ "reasons", no_argument, 0, 'r' },
+			{ 0, 0, 0, 0 }
+		};
+
+		int option_index = 0;
+
+		c = getopt_long(argc, argv, "vhn:lr", long_options, &option_index);
+
+		if (c == -1) {
+			break;
+		}
+
+		switch (c) {
+		case 'n': /* Number of replays */
+			iterations = strtoul(optarg, NULL, 10);
+			if (iterations == 0) {
+				printf("ERROR: at least one iteration is required.\n");
+				goto error;
+			}
+			break;
+		case 'l': /* Format the log messages, as a logging application would */
+			rle_set_trace_callback(format_logs);
+			break;
+		case 'r': /* Print the rejections per reason */
+			verbose = true;
+			break;
+		case 'v': /* Version */
+			printf(TEST_VERSION);
+			status = EXIT_SUCCESS;
+			goto error;
+		case 'h': /* Help */
+			usage();
+			status = EXIT_SUCCESS;
+			goto error;
+		case '?':
+		default:
+			usage();
+			goto error;
+		}
+	}
+
+	if (optind >= argc) {
+		usage();
+		goto error;
+	}
+
+	for (file_id = optind; file_id < argc; file_id++) {
+		status = load_corpus(argv[file_id], &corpus);
+		if (status != 0) {
+			goto free_corpus;
+		}
+	}
+	status = EXIT_FAILURE;
+
+	if (corpus.fpdus_nr == 0) {
+		printf("ERROR: no FPDU in the pcap files.\n");
+		goto free_corpus;
+	}
+
+	printf("=== %d files, %zu FPDUs, %zu iterations, logs %s\n", argc - optind,
+	       corpus.fpdus_nr, iterations,
+	       rle_get_trace_callback() != NULL ? "formatted" : "not traced");
+	printf("%-14s %12s %10s %10s %12s %10s %10s\n", "config", "FPDUs/s", "clean ns",
+	       "rejected", "ns/rejected", "refused", "SDUs");
+
+	for (conf_id = 0; conf_id < sizeof(bench_confs) / sizeof(bench_confs[0]); conf_id++) {
+		if (bench(&corpus, &bench_confs[conf_id], iterations, verbose) != 0) {
+			goto free_corpus;
+		}
+	}
+
+	status = EXIT_SUCCESS;
+
+free_corpus:
+	free_corpus(&corpus);
+	printf("=== exit test with code %d\n", status);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the malformed FPDUs performance test application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "RLE malformed FPDUs performances test tool: replay the payloads of pcap files in\n"
+	        "memory as FPDUs through decapsulation, at maximum rate.\n"
+	        "\n"
+	        "For each configuration, print the FPDUs/s, the ns per clean FPDU, the PPDUs\n"
+	        "rejected and the ns per rejected PPDU, the FPDUs refused and the SDUs\n"
+	        "decapsulated.\n"
+	        "\n"
+	        "usage: test_perfs_malformed [OPTIONS] PCAP_FILE...\n"
+	        "\n"
+	        "with:\n"
+	        "  PCAP_FILE               The Ethernet pcap files to replay\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                      Print version information and exit\n"
+	        "  -h                      Print this usage and exit\n"
+	        "  --iterations, -n        Number of replays of the files (default %d)\n"
+	        "  --log, -l               Format the log messages, as a logging application would\n"
+	        "  --reasons, -r           Print the rejections per reason\n",
+	        DEFAULT_ITERATIONS);
+
+	return;
+}
+
+
+/**
+ * @brief         Format a log message in memory, without printing it.
+ *
+ * @param[in]     module_id  The module of the log.
+ * @param[in]     level      The level of the log.
+ * @param[in]     file       The file of the log.
+ * @param[in]     line       The line of the log.
+ * @param[in]     func       The function of the log.
+ * @param[in]     message    The format of the log message.
+ */
+static void format_logs(const int module_id __attribute__((unused)),
+                        const int level __attribute__((unused)),
+                        const char *const file __attribute__((unused)),
+                        const int line __attribute__((unused)),
+                        const char *const func __attribute__((unused)),
+                        const char *const message, ...)
+{
+	va_list args;
+
+	va_start(args, message);
+	vsnprintf(log_message, sizeof(log_message), message, args);
+	va_end(args);
+
+	return;
+}
+
+
+/**
+ * @brief         Load the FPDUs of a pcap file in memory, after those already loaded.
+ *
+ *                The files of the corpus that are not valid Ethernet pcap files are skipped.
+ *
+ * @param[in]     filename  The pcap file.
+ * @param[in,out] corpus    The FPDUs loaded.
+ *
+ * @return        0 in case of success, 1 in case of failure.
+ */
+static int load_corpus(const char *const filename, struct bench_corpus *const corpus)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct pcap_pkthdr header;
+	const unsigned char *packet;
+	pcap_t *handle;
+	int status = 1;
+
+	handle = pcap_open_offline(filename, errbuf);
+	if (handle == NULL) {
+		printf("skip %s: failed to open the pcap file\n", filename);
+		status = 0;
+		goto error;
+	}
+
+	/* link layer in the source dump must be Ethernet */
+	if (pcap_datalink(handle) != DLT_EN10MB) {
+		printf("skip %s: link layer type %d not supported (supported = %d)\n", filename,
+		       pcap_datalink(handle), DLT_EN10MB);
+		status = 0;
+		goto close_input;
+	}
+
+	while ((packet = pcap_next(handle, &header)) != NULL) {
+		size_t fpdu_length;
+		void *realloc_ret;
+
+		/* the truncated frames are skipped, as test_non_regression_fpdu does */
+		if (header.len <= ETHER_HDR_LEN || header.len != header.caplen) {
+			continue;
+		}
+		fpdu_length = header.len - ETHER_HDR_LEN;
+
+		realloc_ret = realloc(corpus->fpdus, (corpus->fpdus_nr + 1) * sizeof(unsigned char *));
+		if (realloc_ret == NULL) {
+			printf("failed to copy the FPDUs.\n");
+			goto close_input;
+		}
+		corpus->fpdus = realloc_ret;
+		realloc_ret = realloc(corpus->lengths, (corpus->fpdus_nr + 1) * sizeof(size_t));
+		if (realloc_ret == NULL) {
+			printf("failed to copy the FPDUs length.\n");
+			goto close_input;
+		}
+		corpus->lengths = realloc_ret;
+
+		corpus->fpdus[corpus->fpdus_nr] = malloc(fpdu_length);
+		if (corpus->fpdus[corpus->fpdus_nr] == NULL) {
+			printf("failed to copy a FPDU.\n");
+			goto close_input;
+		}
+		memcpy(corpus->fpdus[corpus->fpdus_nr], packet + ETHER_HDR_LEN, fpdu_length);
+		corpus->lengths[corpus->fpdus_nr] = fpdu_length;
+		corpus->fpdus_nr++;
+	}
+
+	status = 0;
+
+close_input:
+	pcap_close(handle);
+error:
+	return status;
+}
+
+
+/**
+ * @brief         Free the FPDUs loaded in memory.
+ *
+ * @param[in,out] corpus  The FPDUs loaded.
+ */
+static void free_corpus(struct bench_corpus *const corpus)
+{
+	size_t i;
+
+	for (i = 0; i < corpus->fpdus_nr; i++) {
+		free(corpus->fpdus[i]);
+	}
+	free(corpus->fpdus);
+	free(corpus->lengths);
+	corpus->fpdus = NULL;
+	corpus->lengths = NULL;
+	corpus->fpdus_nr = 0;
+
+	return;
+}
+
+
+/**
+ * @brief         Get the monotonic time.
+ *
+ * @return        The monotonic time in ns.
+ */
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * @brief         Count the rejections of a receiver, for all the reasons.
+ *
+ * @param[in]     receiver  The receiver.
+ *
+ * @return        The number of rejections.
+ */
+static uint64_t count_errors(const struct rle_receiver *const receiver)
+{
+	uint64_t errors = 0;
+	size_t reason;
+
+	for (reason = 0; reason < RLE_RCV_ERR_REASONS_NR; reason++) {
+		errors += rle_receiver_stats_get_counter_errors(receiver, reason);
+	}
+
+	return errors;
+}
+
+
+/**
+ * @brief         Replay the corpus with a configuration, and print the results.
+ *
+ *                The receiver is kept over the replays, so that the reassembly contexts left by
+ *                a FPDU are met by the next ones, as on a link.
+ *
+ * @param[in]     corpus      The FPDUs to replay.
+ * @param[in]     conf        The configuration of the receiver.
+ * @param[in]     iterations  The number of replays.
+ * @param[in]     verbose     Whether to print the rejections per reason.
+ *
+ * @return        0 in case of success, 1 otherwise.
+ */
+static int bench(const struct bench_corpus *const corpus, const struct bench_conf *const conf,
+                 const size_t iterations, const bool verbose)
+{
+	unsigned char payload_label[PAYLOAD_LABEL_LEN];
+	struct rle_receiver *receiver;
+	struct bench_result result;
+	uint64_t rejected = 0;
+	uint64_t start;
+	double duration;
+	int status = 1;
+	size_t it;
+
+	for (it = 0; it < MAX_SDUS_NB; it++) {
+		sdus_out[it].buffer = sdu_buffers[it];
+	}
+	memset(&result, 0, sizeof(result));
+
+	receiver = rle_receiver_new(&conf->conf);
+	if (receiver == NULL) {
+		printf("ERROR: receiver non initialized\n");
+		goto out;
+	}
+
+	start = now_ns();
+	for (it = 0; it < corpus->fpdus_nr * iterations; it++) {
+		const size_t fpdu_id = it % corpus->fpdus_nr;
+		const uint64_t errors_before = rejected;
+		enum rle_decap_status ret_decap;
+		uint64_t fpdu_start;
+		uint64_t fpdu_ns;
+		size_t sdus_nr = 0;
+
+		fpdu_start = now_ns();
+		ret_decap = rle_decapsulate(receiver, corpus->fpdus[fpdu_id], corpus->lengths[fpdu_id],
+		                            sdus_out, MAX_SDUS_NB, &sdus_nr, payload_label,
+		                            PAYLOAD_LABEL_LEN);
+		fpdu_ns = now_ns() - fpdu_start;
+
+		/* the counters are read out of the time of the FPDU */
+		rejected = count_errors(receiver);
+		result.sdus_nr += sdus_nr;
+		if (rejected != errors_before) {
+			result.rejecting_ns += fpdu_ns;
+		} else if (ret_decap == RLE_DECAP_ERR_INV_FPDU || ret_decap == RLE_DECAP_ERR_INV_PL) {
+			result.refused_nr++;
+		} else {
+			result.clean_ns += fpdu_ns;
+			result.clean_nr++;
+		}
+	}
+	duration = (double)(now_ns() - start) / 1e9;
+
+	for (it = 0; it < RLE_RCV_ERR_REASONS_NR; it++) {
+		result.errors[it] = rle_receiver_stats_get_counter_errors(receiver, it);
+	}
+
+	printf("%-14s %12.0f %10.1f %10" PRIu64 " %12.1f %10zu %10zu\n", conf->name,
+	       corpus->fpdus_nr * iterations / duration,
+	       result.clean_nr ? (double)result.clean_ns / result.clean_nr : 0.0, rejected,
+	       rejected ? (double)result.rejecting_ns / rejected : 0.0, result.refused_nr,
+	       result.sdus_nr);
+	if (verbose) {
+		for (it = 0; it < RLE_RCV_ERR_REASONS_NR; it++) {
+			if (result.errors[it] != 0) {
+				printf("    %-16s %12" PRIu64 "\n", error_names[it], result.errors[it]);
+			}
+		}
+	}
+
+	status = 0;
+
+out:
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	return status;
+}
@@ -0,0 +1,719 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   test_perfs_mt.c
+ * @brief  Multi-threaded performances test, each thread replaying a pcap file loaded in memory
+ *         through its own transmitter and receiver.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * The transmitters and receivers share no state, but for the library-wide pieces:
+ *
+ *  - the trace callback and the log level, only read by the logs, which are filtered at
+ *    compile time by RLE_LOG_NO_DEBUG or at run time before being formatted,
+ *  - the CRC table, read-only, so each core keeps its own copy in cache,
+ *  - the pool of reassembly storages of the receivers using the system allocator, behind a
+ *    spinlock taken at each START and END PPDU: the only lock of the data path. With the
+ *    "thread" allocator, the receivers allocate their storages themselves and skip the pool,
+ *    which tells the pool contention from the rest,
+ *  - with the TIMING_STATS or COPY_STATS options, the histogram and the counters of rle_pack(),
+ *    updated atomically by all the threads.
+ */
+
+/* system includes */
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pcap/pcap.h>
+#include <pcap.h>
+#include <getopt.h>
+
+#include "rle.h"
+
+/** The program version */
+#define TEST_VERSION  "RLE multi-threaded performances test application, version 0.0.1\n"
+
+/** The length (in bytes) of the Ethernet header */
+#define ETHER_HDR_LEN  14U
+
+/** Min, max and default burst sizes for fragmentation in the test. */
+#define MIN_BURST_SIZE 14
+#define MAX_BURST_SIZE 599
+#define DEFAULT_BURST_SIZE 100
+
+/** Default number of replays of the pcap file by each thread */
+#define DEFAULT_ITERATIONS 10
+
+/** Max number of SDUs decapsulated from one FPDU */
+#define MAX_SDUS_NB   (MAX_BURST_SIZE / 2)
+
+/** The configuration of the transmitters and of the receivers */
+static const struct rle_config bench_conf = {
+	.allow_ptype_omission = 0,
+	.use_compressed_ptype = 1,
+	.allow_alpdu_crc = 0,
+	.allow_alpdu_sequence_number = 1,
+	.use_explicit_payload_header_map = 0,
+	.implicit_protocol_type = 0x00,
+	.implicit_ppdu_label_size = 0,
+	.implicit_payload_label_size = 0,
+	.type_0_alpdu_label_size = 0,
+};
+
+/** The packets of the pcap file, loaded in memory and shared read-only by the threads */
+struct bench_trace {
+	unsigned char **packets;  /**< The packets, link layer included. */
+	size_t *lengths;          /**< The lengths of the packets.       */
+	size_t packets_nr;        /**< The number of packets.            */
+	size_t bytes_nr;          /**< The number of SDU octets.         */
+};
+
+/** The state of a thread, its FPDU, its transmitter and its receiver */
+struct bench_thread {
+	pthread_t thread;                      /**< The thread.                                */
+	size_t id;                             /**< The index of the thread, from 0.           */
+	const struct bench_trace *trace;       /**< The packets to replay.                     */
+	size_t iterations;                     /**< The number of replays.                     */
+	bool pinned;                           /**< Whether the thread is pinned on a CPU.     */
+	bool own_allocator;                    /**< Whether to skip the shared storage pool.   */
+	pthread_barrier_t *barrier;            /**< The barrier all the threads start on.      */
+	struct rle_transmitter *transmitter;   /**< The transmitter.                           */
+	struct rle_receiver *receiver;         /**< The receiver.                              */
+	unsigned char fpdu[MAX_BURST_SIZE];    /**< The FPDU being packed.                     */
+	size_t fpdu_size;                      /**< The size of the FPDUs.                     */
+	size_t fpdu_cur_pos;                   /**< The current position in the FPDU.          */
+	size_t fpdu_remain_size;               /**< The remaining size in the FPDU.            */
+	struct rle_sdu sdus_out[MAX_SDUS_NB];  /**< The SDUs decapsulated from a FPDU.         */
+	unsigned char *sdu_buffers;            /**< The buffers of the SDUs decapsulated.      */
+	size_t sdus_received;                  /**< The number of SDUs decapsulated.           */
+	double duration;                       /**< The duration of the replays, in s.         */
+	bool failed;                           /**< Whether the replays failed.                */
+};
+
+/* prototypes of private functions */
+static void usage(void);
+static int load_trace(const char *const filename, struct bench_trace *const trace);
+static void free_trace(struct bench_trace *const trace);
+static uint64_t now_ns(void);
+static void *thread_alloc(void *const context, const size_t size);
+static void thread_free(void *const context, void *const ptr);
+static void send_fpdu(struct bench_thread *const bench_thread);
+static bool encap(struct bench_thread *const bench_thread, const unsigned char *const packet,
+                  const size_t packet_length);
+static void *bench_thread_run(void *const arg);
+static int bench(const struct bench_trace *const trace, const size_t threads_nr,
+                 const size_t burst_size, const size_t iterations, const bool pinned,
+                 const bool own_allocator, double *const single_rate);
+
+
+/**
+ * @brief Main function for the RLE multi-threaded performances test program
+ *
+ * @param[in] argc The number of program arguments
+ * @param[in] argv The program arguments
+ * @return         The unix return code:
+ *                 \li 0 in case of success,
+ *                 \li 1 in case of failure,
+ *                 \li 77 in case test is skipped
+ */
+int main(int argc, char *argv[])
+{
+	struct bench_trace trace = { NULL, NULL, 0, 0 };
+	long cpus_nr = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t threads_max;
+	size_t iterations = DEFAULT_ITERATIONS;
+	size_t burst_size = DEFAULT_BURST_SIZE;
+	bool pinned = true;
+	bool own_allocator = false;
+	double single_rate = 0;
+	int status = EXIT_FAILURE;
+	size_t threads_nr;
+
+	threads_max = (cpus_nr > 0 ? (size_t)cpus_nr : 1);
+
+	while (1) {
+		int c;
+
+		static struct option long_options[] =
+		{
+			{ "threads", required_argument, 0, 't' },
+			{ "iterations", required_argument, 0, 'n' },
+			{ "burst", required_argument, 0, 'b' },
+			{ "allocator", required_argument, 0, 'a' },
+			{ "no-pin", no_argument, 0, 'p' },
+			{ 0, 0, 0, 0 }
+		};
+
+		int option_index = 0;
+
+		c = getopt_long(argc, argv, "vht:n:b:a:", long_options, &option_index);
+
+		if (c == -1) {
+			break;
+		}
+
+		switch (c) {
+		case 't': /* Max number of threads */
+			threads_max = strtoul(optarg, NULL, 10);
+			if (threads_max == 0) {
+				printf("ERROR: at least one thread is required.\n");
+				goto error;
+			}
+			break;
+		case 'n': /* Number of replays */
+			iterations = strtoul(optarg, NULL, 10);
+			if (iterations == 0) {
+				printf("ERROR: at least one iteration is required.\n");
+				goto error;
+			}
+			break;
+		case 'b': /* Burst size */
+			burst_size = strtoul(optarg, NULL, 10);
+			if (burst_size < MIN_BURST_SIZE || burst_size > MAX_BURST_SIZE) {
+				printf("ERROR: burst size %zu, from %d to %d octets.\n", burst_size,
+				       MIN_BURST_SIZE, MAX_BURST_SIZE);
+				goto error;
+			}
+			break;
+		case 'a': /* Allocator of the receivers */
+			if (strcmp(optarg, "system") == 0) {
+				own_allocator = false;
+			} else if (strcmp(optarg, "thread") == 0) {
+				own_allocator = true;
+			} else {
+				printf("ERROR: allocator '%s', 'system' or 'thread'.\n", optarg);
+				goto error;
+			}
+			break;
+		case 'p': /* No CPU pinning */
+			pinned = false;
+			break;
+		case 'v': /* Version */
+			printf(TEST_VERSION);
+			status = EXIT_SUCCESS;
+			goto error;
+		case 'h': /* Help */
+			usage();
+			status = EXIT_SUCCESS;
+			goto error;
+		case '?':
+		default:
+			usage();
+			goto error;
+		}
+	}
+
+	if (optind != argc - 1) {
+		usage();
+		goto error;
+	}
+
+	status = load_trace(argv[optind], &trace);
+	if (status != 0) {
+		goto error;
+	}
+	status = EXIT_FAILURE;
+
+	printf("=== %zu SDUs, %zu octets, %zu iterations per thread, %zu-octet bursts, "
+	       "%s allocator, %ld CPUs%s\n", trace.packets_nr, trace.bytes_nr, iterations,
+	       burst_size, own_allocator ? "thread" : "system", cpus_nr,
+	       pinned ? ", pinned" : "");
+
+	/* 1, 2, 4... threads, then the max if not a power of 2 */
+	for (threads_nr = 1; threads_nr <= threads_max;
+	     threads_nr = (threads_nr * 2 > threads_max && threads_nr != threads_max ?
+	                   threads_max : threads_nr * 2)) {
+		if (bench(&trace, threads_nr, burst_size, iterations, pinned, own_allocator,
+		          &single_rate) != 0) {
+			goto free_trace;
+		}
+		if (threads_nr == threads_max) {
+			break;
+		}
+	}
+
+	status = EXIT_SUCCESS;
+
+free_trace:
+	free_trace(&trace);
+	printf("=== exit test with code %d\n", status);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the multi-threaded performance test application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "RLE multi-threaded performances test tool: each thread replays a pcap file in\n"
+	        "memory through encapsulation, fragmentation, packing and decapsulation, with its\n"
+	        "own transmitter and receiver.\n"
+	        "\n"
+	        "For 1, 2, 4... threads, print the SDUs/s and Gbit/s of each thread, their sum,\n"
+	        "and the scaling efficiency against a single thread.\n"
+	        "\n"
+	        "usage: test_perfs_mt [OPTIONS] PCAP_FILE\n"
+	        "\n"
+	        "with:\n"
+	        "  PCAP_FILE               The Ethernet pcap file to replay\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                      Print version information and exit\n"
+	        "  -h                      Print this usage and exit\n"
+	        "  --threads, -t           Max number of threads (default the CPUs online)\n"
+	        "  --iterations, -n        Number of replays of the file per thread (default 10)\n"
+	        "  --burst, -b             Burst size, from %d to %d (default %d)\n"
+	        "  --allocator, -a         Allocator of the receivers: 'system', sharing the pool of\n"
+	        "                          reassembly storages, or 'thread' (default system)\n"
+	        "  --no-pin                Do not pin the threads on the CPUs\n",
+	        MIN_BURST_SIZE, MAX_BURST_SIZE, DEFAULT_BURST_SIZE);
+
+	return;
+}
+
+
+/**
+ * @brief         Load the packets of a pcap file in memory.
+ *
+ * @param[in]     filename  The pcap file.
+ * @param[out]    trace     The packets loaded.
+ *
+ * @return        0 in case of success, 1 in case of failure, 77 if the file is not supported.
+ */
+static int load_trace(const char *const filename, struct bench_trace *const trace)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct pcap_pkthdr header;
+	const unsigned char *packet;
+	pcap_t *handle;
+	int status = 1;
+
+	handle = pcap_open_offline(filename, errbuf);
+	if (handle == NULL) {
+		printf("failed to open the source pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	/* link layer in the source dump must be Ethernet */
+	if (pcap_datalink(handle) != DLT_EN10MB) {
+		printf("link layer type %d not supported in source dump (supported = %d)\n",
+		       pcap_datalink(handle), DLT_EN10MB);
+		status = 77;
+		goto close_input;
+	}
+
+	while ((packet = pcap_next(handle, &header)) != NULL) {
+		void *realloc_ret;
+
+		if (header.len <= ETHER_HDR_LEN || header.len != header.caplen ||
+		    header.len - ETHER_HDR_LEN > RLE_MAX_PDU_SIZE) {
+			printf("bad PCAP packet (len = %d, caplen = %d)\n", header.len,
+			       header.caplen);
+			goto close_input;
+		}
+
+		realloc_ret = realloc(trace->packets, (trace->packets_nr + 1) * sizeof(unsigned char *));
+		if (realloc_ret == NULL) {
+			printf("failed to copy the packets.\n");
+			goto close_input;
+		}
+		trace->packets = realloc_ret;
+		realloc_ret = realloc(trace->lengths, (trace->packets_nr + 1) * sizeof(size_t));
+		if (realloc_ret == NULL) {
+			printf("failed to copy the packets length.\n");
+			goto close_input;
+		}
+		trace->lengths = realloc_ret;
+
+		trace->packets[trace->packets_nr] = malloc(header.len);
+		if (trace->packets[trace->packets_nr] == NULL) {
+			printf("failed to copy a packet.\n");
+			goto close_input;
+		}
+		memcpy(trace->packets[trace->packets_nr], packet, header.len);
+		trace->lengths[trace->packets_nr] = header.len;
+		trace->bytes_nr += header.len - ETHER_HDR_LEN;
+		trace->packets_nr++;
+	}
+
+	if (trace->packets_nr == 0) {
+		printf("no packet in the source pcap file.\n");
+		goto close_input;
+	}
+
+	status = 0;
+
+close_input:
+	pcap_close(handle);
+error:
+	return status;
+}
+
+
+/**
+ * @brief         Free the packets of a pcap file loaded in memory.
+ *
+ * @param[in,out] trace  The packets loaded.
+ */
+static void free_trace(struct bench_trace *const trace)
+{
+	size_t i;
+
+	for (i = 0; i < trace->packets_nr; i++) {
+		free(trace->packets[i]);
+	}
+	free(trace->packets);
+	free(trace->lengths);
+	trace->packets = NULL;
+	trace->lengths = NULL;
+	trace->packets_nr = 0;
+
+	return;
+}
+
+
+/**
+ * @brief         Get the monotonic time.
+ *
+ * @return        The monotonic time in ns.
+ */
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * @brief         Allocate memory for the receiver of a thread, out of the shared storage pool.
+ *
+ * @param[in]     context  The thread, unused.
+ * @param[in]     size     The size to allocate.
+ *
+ * @return        The memory allocated, NULL on failure.
+ */
+static void *thread_alloc(void *const context, const size_t size)
+{
+	(void)context;
+
+	return malloc(size);
+}
+
+
+/**
+ * @brief         Release the memory of the receiver of a thread.
+ *
+ * @param[in]     context  The thread, unused.
+ * @param[in]     ptr      The memory to release.
+ */
+static void thread_free(void *const context, void *const ptr)
+{
+	(void)context;
+
+	free(ptr);
+}
+
+
+/**
+ * @brief         Pad and send the FPDU of a thread to its receiver, then reset it.
+ *
+ * @param[in,out] bench_thread  The thread.
+ */
+static void send_fpdu(struct bench_thread *const bench_thread)
+{
+	enum rle_decap_status ret_decap;
+	size_t sdus_nr = 0;
+
+	rle_pad(bench_thread->fpdu, bench_thread->fpdu_cur_pos, bench_thread->fpdu_remain_size);
+
+	ret_decap = rle_decapsulate(bench_thread->receiver, bench_thread->fpdu,
+	                            bench_thread->fpdu_size, bench_thread->sdus_out, MAX_SDUS_NB,
+	                            &sdus_nr, NULL, 0);
+	if (ret_decap != RLE_DECAP_OK) {
+		printf("ERROR: thread %zu: decapsulation failed (%d)\n", bench_thread->id, ret_decap);
+		bench_thread->failed = true;
+	}
+	bench_thread->sdus_received += sdus_nr;
+
+	bench_thread->fpdu_cur_pos = 0;
+	bench_thread->fpdu_remain_size = bench_thread->fpdu_size;
+
+	return;
+}
+
+
+/**
+ * @brief         Encapsulate, fragment and pack one SDU, sending the FPDUs filled.
+ *
+ * @param[in,out] bench_thread   The thread.
+ * @param[in]     packet         The packet to encapsulate, link layer included.
+ * @param[in]     packet_length  The length of the packet.
+ *
+ * @return        true in case of success, false otherwise.
+ */
+static bool encap(struct bench_thread *const bench_thread, const unsigned char *const packet,
+                  const size_t packet_length)
+{
+	const uint8_t frag_id = 0;
+	struct rle_sdu sdu;
+
+	sdu.buffer = (unsigned char *)packet + ETHER_HDR_LEN;
+	sdu.size = packet_length - ETHER_HDR_LEN;
+	sdu.protocol_type = ntohs(*(const uint16_t *)((const void *)(packet + ETHER_HDR_LEN - 2)));
+
+	if (rle_encapsulate(bench_thread->transmitter, &sdu, frag_id) != RLE_ENCAP_OK) {
+		printf("ERROR: thread %zu: encapsulation failed\n", bench_thread->id);
+		return false;
+	}
+
+	while (rle_transmitter_stats_get_queue_size(bench_thread->transmitter, frag_id) != 0) {
+		enum rle_frag_status ret_frag;
+		unsigned char *ppdu;
+		size_t ppdu_length = 0;
+
+		/* a PPDU fills the FPDU, or the FPDU is sent and a PPDU fills the next one */
+		ret_frag = rle_fragment(bench_thread->transmitter, frag_id,
+		                        bench_thread->fpdu_remain_size, &ppdu, &ppdu_length);
+		if (ret_frag == RLE_FRAG_ERR_BURST_TOO_SMALL) {
+			send_fpdu(bench_thread);
+			ret_frag = rle_fragment(bench_thread->transmitter, frag_id,
+			                        bench_thread->fpdu_remain_size, &ppdu, &ppdu_length);
+		}
+		if (ret_frag != RLE_FRAG_OK) {
+			printf("ERROR: thread %zu: fragmentation failed (%d)\n", bench_thread->id,
+			       ret_frag);
+			return false;
+		}
+
+		if (rle_pack(ppdu, ppdu_length, NULL, 0, bench_thread->fpdu,
+		             &bench_thread->fpdu_cur_pos, &bench_thread->fpdu_remain_size) !=
+		    RLE_PACK_OK) {
+			printf("ERROR: thread %zu: packing failed\n", bench_thread->id);
+			return false;
+		}
+
+		if (bench_thread->fpdu_remain_size == 0) {
+			send_fpdu(bench_thread);
+		}
+	}
+
+	return !bench_thread->failed;
+}
+
+
+/**
+ * @brief         Replay the trace in a thread, once all the threads are ready.
+ *
+ * @param[in,out] arg  The thread.
+ *
+ * @return        NULL.
+ */
+static void *bench_thread_run(void *const arg)
+{
+	struct bench_thread *const bench_thread = arg;
+	const struct bench_trace *const trace = bench_thread->trace;
+	const size_t sdus_nr = trace->packets_nr * bench_thread->iterations;
+	uint64_t start;
+	size_t it;
+
+	if (bench_thread->pinned) {
+		const long cpus_nr = sysconf(_SC_NPROCESSORS_ONLN);
+		cpu_set_t cpus;
+
+		CPU_ZERO(&cpus);
+		CPU_SET(bench_thread->id % (cpus_nr > 0 ? (size_t)cpus_nr : 1), &cpus);
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+			printf("WARNING: thread %zu not pinned\n", bench_thread->id);
+		}
+	}
+
+	/* the modules are created by their thread, so that their memory is local to its CPU */
+	bench_thread->transmitter = rle_transmitter_new(&bench_conf);
+	if (bench_thread->own_allocator) {
+		const struct rle_allocator allocator = {
+			.alloc = thread_alloc,
+			.free = thread_free,
+			.context = bench_thread,
+		};
+		bench_thread->receiver = rle_receiver_new_with_allocator(&bench_conf, &allocator);
+	} else {
+		bench_thread->receiver = rle_receiver_new(&bench_conf);
+	}
+	bench_thread->sdu_buffers = malloc(MAX_SDUS_NB * RLE_MAX_PDU_SIZE);
+	if (bench_thread->transmitter == NULL || bench_thread->receiver == NULL ||
+	    bench_thread->sdu_buffers == NULL) {
+		printf("ERROR: thread %zu: transmitter or receiver non initialized\n",
+		       bench_thread->id);
+		bench_thread->failed = true;
+	}
+	for (it = 0; !bench_thread->failed && it < MAX_SDUS_NB; it++) {
+		bench_thread->sdus_out[it].buffer = bench_thread->sdu_buffers + it * RLE_MAX_PDU_SIZE;
+	}
+
+	pthread_barrier_wait(bench_thread->barrier);
+	if (bench_thread->failed) {
+		goto out;
+	}
+
+	start = now_ns();
+	for (it = 0; it < sdus_nr; it++) {
+		const size_t packet_id = it % trace->packets_nr;
+
+		if (!encap(bench_thread, trace->packets[packet_id], trace->lengths[packet_id])) {
+			bench_thread->failed = true;
+			goto out;
+		}
+	}
+
+	/* Pad and send the last FPDU if exists. */
+	if (bench_thread->fpdu_cur_pos != 0) {
+		send_fpdu(bench_thread);
+	}
+	bench_thread->duration = (double)(now_ns() - start) / 1e9;
+
+	if (bench_thread->sdus_received != sdus_nr) {
+		printf("ERROR: thread %zu: %zu SDUs sent, %zu received\n", bench_thread->id, sdus_nr,
+		       bench_thread->sdus_received);
+		bench_thread->failed = true;
+	}
+
+out:
+	if (bench_thread->receiver != NULL) {
+		rle_receiver_destroy(&bench_thread->receiver);
+	}
+	if (bench_thread->transmitter != NULL) {
+		rle_transmitter_destroy(&bench_thread->transmitter);
+	}
+	free(bench_thread->sdu_buffers);
+	return NULL;
+}
+
+
+/**
+ * @brief         Replay the trace in parallel threads, and print the results.
+ *
+ * @param[in]     trace          The packets to replay.
+ * @param[in]     threads_nr     The number of threads.
+ * @param[in]     burst_size     The size of the FPDUs.
+ * @param[in]     iterations     The number of replays per thread.
+ * @param[in]     pinned         Whether to pin the threads on the CPUs.
+ * @param[in]     own_allocator  Whether the receivers skip the shared storage pool.
+ * @param[in,out] single_rate    The SDUs/s of a single thread, set by the run of 1 thread.
+ *
+ * @return        0 in case of success, 1 otherwise.
+ */
+static int bench(const struct bench_trace *const trace, const size_t threads_nr,
+                 const size_t burst_size, const size_t iterations, const bool pinned,
+                 const bool own_allocator, double *const single_rate)
+{
+	const size_t sdus_nr = trace->packets_nr * iterations;
+	struct bench_thread *bench_threads;
+	pthread_barrier_t barrier;
+	size_t started_nr = 0;
+	double aggregate_rate = 0;
+	double max_duration = 0;
+	int status = 1;
+	size_t id;
+
+	bench_threads = calloc(threads_nr, sizeof(struct bench_thread));
+	if (bench_threads == NULL) {
+		printf("ERROR: failed to allocate the threads.\n");
+		goto error;
+	}
+	if (pthread_barrier_init(&barrier, NULL, threads_nr) != 0) {
+		printf("ERROR: failed to initialize the barrier.\n");
+		goto free_threads;
+	}
+
+	for (id = 0; id < threads_nr; id++) {
+		struct bench_thread *const bench_thread = &bench_threads[id];
+
+		bench_thread->id = id;
+		bench_thread->trace = trace;
+		bench_thread->iterations = iterations;
+		bench_thread->pinned = pinned;
+		bench_thread->own_allocator = own_allocator;
+		bench_thread->barrier = &barrier;
+		bench_thread->fpdu_size = burst_size;
+		bench_thread->fpdu_remain_size = burst_size;
+		if (pthread_create(&bench_thread->thread, NULL, bench_thread_run, bench_thread) != 0) {
+			printf("ERROR: failed to create thread %zu.\n", id);
+			/* the started threads wait on the barrier forever, give up */
+			exit(EXIT_FAILURE);
+		}
+		started_nr++;
+	}
+	for (id = 0; id < started_nr; id++) {
+		pthread_join(bench_threads[id].thread, NULL);
+	}
+
+	printf("--- %zu thread(s)\n", threads_nr);
+	printf("%8s %14s %10s\n", "thread", "SDUs/s", "Gbit/s");
+	for (id = 0; id < threads_nr; id++) {
+		const struct bench_thread *const bench_thread = &bench_threads[id];
+
+		if (bench_thread->failed) {
+			goto destroy_barrier;
+		}
+		printf("%8zu %14.0f %10.3f\n", id, sdus_nr / bench_thread->duration,
+		       trace->bytes_nr * iterations * 8 / bench_thread->duration / 1e9);
+		aggregate_rate += sdus_nr / bench_thread->duration;
+		if (bench_thread->duration > max_duration) {
+			max_duration = bench_thread->duration;
+		}
+	}
+	if (threads_nr == 1) {
+		*single_rate = aggregate_rate;
+	}
+
+	/* the aggregate is the sum of the rates, the wall clock one waits for the slowest thread */
+	printf("%8s %14.0f %10.3f\n", "sum", aggregate_rate,
+	       aggregate_rate * trace->bytes_nr / trace->packets_nr * 8 / 1e9);
+	printf("%8s %14.0f %10.3f\n", "wall", sdus_nr * threads_nr / max_duration,
+	       trace->bytes_nr * iterations * threads_nr * 8 / max_duration / 1e9);
+	if (*single_rate > 0) {
+		printf("scaling efficiency: %.1f %%\n",
+		       100 * aggregate_rate / (threads_nr * (*single_rate)));
+	}
+
+	status = 0;
+
+destroy_barrier:
+	pthread_barrier_destroy(&barrier);
+free_threads:
+	free(bench_threads);
+error:
+	return status;
+}
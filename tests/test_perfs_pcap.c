@@ -0,0 +1,609 @@
+/*
+ * librle implements the Return Link Encapsulation (RLE) protocol
+ *
+ * Copyright (C) 2015-2016, Thales Alenia Space France - All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   test_perfs_pcap.c
+ * @brief  Offline performances test, replaying a pcap file loaded in memory through
+ *         encapsulation, fragmentation, packing and decapsulation.
+ * @author Henrick Deschamps
+ * @date   10/2026
+ * @copyright
+ *   Copyright (C) 2016, Thales Alenia Space France - All Rights Reserved
+ */
+
+/* system includes */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <arpa/inet.h>
+#include <time.h>
+#include <pcap/pcap.h>
+#include <pcap.h>
+#include <getopt.h>
+
+#include "rle.h"
+
+/** The program version */
+#define TEST_VERSION  "RLE pcap performances test application, version 0.0.1\n"
+
+/** The length (in bytes) of the Ethernet header */
+#define ETHER_HDR_LEN  14U
+
+/** Min, max and default burst sizes for fragmentation in the test. */
+#define MIN_BURST_SIZE 14
+#define MAX_BURST_SIZE 599
+
+/** Burst sizes of the sweep, from MIN_BURST_SIZE to MAX_BURST_SIZE */
+static const size_t burst_sizes[] = { MIN_BURST_SIZE, 50, 100, 200, 300, 450, MAX_BURST_SIZE };
+
+/** Default number of replays of the pcap file */
+#define DEFAULT_ITERATIONS 10
+
+/** Max number of SDUs decapsulated from one FPDU */
+#define MAX_SDUS_NB   (MAX_BURST_SIZE / 2)
+
+/** Configuration of the transmitter and of the receiver of a run */
+struct bench_conf {
+	const char *name;        /**< The name of the configuration.  */
+	struct rle_config conf;  /**< The RLE configuration.          */
+};
+
+/** The configurations of the sweep */
+static const struct bench_conf bench_confs[] = {
+	{
+		.name = "seqno,comp",
+		.conf = {
+			.allow_ptype_omission = 0,
+			.use_compressed_ptype = 1,
+			.allow_alpdu_crc = 0,
+			.allow_alpdu_sequence_number = 1,
+			.use_explicit_payload_header_map = 0,
+			.implicit_protocol_type = 0x00,
+			.implicit_ppdu_label_size = 0,
+			.implicit_payload_label_size = 0,
+			.type_0_alpdu_label_size = 0,
+		},
+	},
+	{
+		.name = "seqno,uncomp",
+		.conf = {
+			.allow_ptype_omission = 0,
+			.use_compressed_ptype = 0,
+			.allow_alpdu_crc = 0,
+			.allow_alpdu_sequence_number = 1,
+			.use_explicit_payload_header_map = 0,
+			.implicit_protocol_type = 0x00,
+			.implicit_ppdu_label_size = 0,
+			.implicit_payload_label_size = 0,
+			.type_0_alpdu_label_size = 0,
+		},
+	},
+	{
+		.name = "crc,comp",
+		.conf = {
+			.allow_ptype_omission = 0,
+			.use_compressed_ptype = 1,
+			.allow_alpdu_crc = 1,
+			.allow_alpdu_sequence_number = 0,
+			.use_explicit_payload_header_map = 0,
+			.implicit_protocol_type = 0x00,
+			.implicit_ppdu_label_size = 0,
+			.implicit_payload_label_size = 0,
+			.type_0_alpdu_label_size = 0,
+		},
+	},
+	{
+		.name = "seqno,omission(ip)",
+		.conf = {
+			.allow_ptype_omission = 1,
+			.use_compressed_ptype = 1,
+			.allow_alpdu_crc = 0,
+			.allow_alpdu_sequence_number = 1,
+			.use_explicit_payload_header_map = 0,
+			.implicit_protocol_type = RLE_PROTO_TYPE_IP_COMP,
+			.implicit_ppdu_label_size = 0,
+			.implicit_payload_label_size = 0,
+			.type_0_alpdu_label_size = 0,
+		},
+	},
+};
+
+/** The packets of the pcap file, loaded in memory */
+struct bench_trace {
+	unsigned char **packets;  /**< The packets, link layer included. */
+	size_t *lengths;          /**< The lengths of the packets.       */
+	size_t packets_nr;        /**< The number of packets.            */
+	size_t bytes_nr;          /**< The number of SDU octets.         */
+};
+
+/** The FPDU being packed, and the receiver decapsulating the sent FPDUs */
+struct bench_link {
+	struct rle_receiver *receiver;  /**< The receiver.                             */
+	unsigned char *fpdu;            /**< The FPDU being packed.                    */
+	size_t fpdu_size;               /**< The size of the FPDUs.                    */
+	size_t fpdu_cur_pos;            /**< The current position in the FPDU.         */
+	size_t fpdu_remain_size;        /**< The remaining size in the FPDU.           */
+	size_t sdus_received;           /**< The number of SDUs decapsulated.          */
+	bool failed;                    /**< Whether a decapsulation failed.           */
+};
+
+/** Buffer preallocation */
+static unsigned char sdu_buffers[MAX_SDUS_NB][RLE_MAX_PDU_SIZE];
+static struct rle_sdu sdus_out[MAX_SDUS_NB];
+
+/* prototypes of private functions */
+static void usage(void);
+static int load_trace(const char *const filename, struct bench_trace *const trace);
+static void free_trace(struct bench_trace *const trace);
+static uint64_t now_ns(void);
+static int compare_u64(const void *const a, const void *const b);
+static void send_fpdu(struct bench_link *const link);
+static bool encap(struct rle_transmitter *const transmitter, struct bench_link *const link,
+                  const unsigned char *const packet, const size_t packet_length);
+static int bench(const struct bench_trace *const trace, const struct bench_conf *const conf,
+                 const size_t burst_size, const size_t iterations, uint64_t *const latencies);
+
+
+/**
+ * @brief Main function for the RLE pcap performances test program
+ *
+ * @param[in] argc The number of program arguments
+ * @param[in] argv The program arguments
+ * @return         The unix return code:
+ *                 \li 0 in case of success,
+ *                 \li 1 in case of failure,
+ *                 \li 77 in case test is skipped
+ */
+int main(int argc, char *argv[])
+{
+	struct bench_trace trace = { NULL, NULL, 0, 0 };
+	size_t iterations = DEFAULT_ITERATIONS;
+	size_t burst_size = 0;
+	uint64_t *latencies = NULL;
+	int status = EXIT_FAILURE;
+	size_t conf_id;
+	size_t burst_id;
+
+	while (1) {
+		int c;
+
+		static struct option long_options[] =
+		{
+			{ "iterations", required_argument, 0, 'n' },
+			{ "burst", required_argument, 0, 'b' },
+			{ 0, 0, 0, 0 }
+		};
+
+		int option_index = 0;
+
+		c = getopt_long(argc, argv, "vhn:b:", long_options, &option_index);
+
+		if (c == -1) {
+			break;
+		}
+
+		switch (c) {
+		case 'n': /* Number of replays */
+			iterations = strtoul(optarg, NULL, 10);
+			if (iterations == 0) {
+				printf("ERROR: at least one iteration is required.\n");
+				goto error;
+			}
+			break;
+		case 'b': /* Only one burst size */
+			burst_size = strtoul(optarg, NULL, 10);
+			if (burst_size < MIN_BURST_SIZE || burst_size > MAX_BURST_SIZE) {
+				printf("ERROR: burst size %zu, from %d to %d octets.\n", burst_size,
+				       MIN_BURST_SIZE, MAX_BURST_SIZE);
+				goto error;
+			}
+			break;
+		case 'v': /* Version */
+			printf(TEST_VERSION);
+			status = EXIT_SUCCESS;
+			goto error;
+		case 'h': /* Help */
+			usage();
+			status = EXIT_SUCCESS;
+			goto error;
+		case '?':
+		default:
+			usage();
+			goto error;
+		}
+	}
+
+	if (optind != argc - 1) {
+		usage();
+		goto error;
+	}
+
+	status = load_trace(argv[optind], &trace);
+	if (status != 0) {
+		goto error;
+	}
+	status = EXIT_FAILURE;
+
+	latencies = malloc(trace.packets_nr * iterations * sizeof(uint64_t));
+	if (latencies == NULL) {
+		printf("ERROR: failed to allocate the latencies.\n");
+		goto free_trace;
+	}
+
+	printf("=== %zu SDUs, %zu octets, %zu iterations\n", trace.packets_nr, trace.bytes_nr,
+	       iterations);
+	printf("%-20s %6s %14s %10s %10s %10s %10s\n", "config", "burst", "SDUs/s", "Gbit/s",
+	       "p50 ns", "p99 ns", "p99.9 ns");
+
+	for (conf_id = 0; conf_id < sizeof(bench_confs) / sizeof(bench_confs[0]); conf_id++) {
+		for (burst_id = 0; burst_id < sizeof(burst_sizes) / sizeof(burst_sizes[0]);
+		     burst_id++) {
+			const size_t size = burst_size ? burst_size : burst_sizes[burst_id];
+
+			if (bench(&trace, &bench_confs[conf_id], size, iterations, latencies) != 0) {
+				goto free_latencies;
+			}
+			if (burst_size) {
+				break;
+			}
+		}
+	}
+
+	status = EXIT_SUCCESS;
+
+free_latencies:
+	free(latencies);
+free_trace:
+	free_trace(&trace);
+	printf("=== exit test with code %d\n", status);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the pcap performance test application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "RLE pcap performances test tool: replay a pcap file in memory through\n"
+	        "encapsulation, fragmentation, packing and decapsulation.\n"
+	        "\n"
+	        "For each configuration and burst size, print the SDUs/s, Gbit/s, and the\n"
+	        "p50/p99/p99.9 ns per SDU.\n"
+	        "\n"
+	        "usage: test_perfs_pcap [OPTIONS] PCAP_FILE\n"
+	        "\n"
+	        "with:\n"
+	        "  PCAP_FILE               The Ethernet pcap file to replay\n"
+	        "\n"
+	        "options:\n"
+	        "  -v                      Print version information and exit\n"
+	        "  -h                      Print this usage and exit\n"
+	        "  --iterations, -n        Number of replays of the file (default 10)\n"
+	        "  --burst, -b             Only one burst size, from %d to %d (default sweep)\n",
+	        MIN_BURST_SIZE, MAX_BURST_SIZE);
+
+	return;
+}
+
+
+/**
+ * @brief         Load the packets of a pcap file in memory.
+ *
+ * @param[in]     filename  The pcap file.
+ * @param[out]    trace     The packets loaded.
+ *
+ * @return        0 in case of success, 1 in case of failure, 77 if the file is not supported.
+ */
+static int load_trace(const char *const filename, struct bench_trace *const trace)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct pcap_pkthdr header;
+	const unsigned char *packet;
+	pcap_t *handle;
+	int status = 1;
+
+	handle = pcap_open_offline(filename, errbuf);
+	if (handle == NULL) {
+		printf("failed to open the source pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	/* link layer in the source dump must be Ethernet */
+	if (pcap_datalink(handle) != DLT_EN10MB) {
+		printf("link layer type %d not supported in source dump (supported = %d)\n",
+		       pcap_datalink(handle), DLT_EN10MB);
+		status = 77;
+		goto close_input;
+	}
+
+	while ((packet = pcap_next(handle, &header)) != NULL) {
+		void *realloc_ret;
+
+		if (header.len <= ETHER_HDR_LEN || header.len != header.caplen ||
+		    header.len - ETHER_HDR_LEN > RLE_MAX_PDU_SIZE) {
+			printf("bad PCAP packet (len = %d, caplen = %d)\n", header.len,
+			       header.caplen);
+			goto close_input;
+		}
+
+		realloc_ret = realloc(trace->packets, (trace->packets_nr + 1) * sizeof(unsigned char *));
+		if (realloc_ret == NULL) {
+			printf("failed to copy the packets.\n");
+			goto close_input;
+		}
+		trace->packets = realloc_ret;
+		realloc_ret = realloc(trace->lengths, (trace->packets_nr + 1) * sizeof(size_t));
+		if (realloc_ret == NULL) {
+			printf("failed to copy the packets length.\n");
+			goto close_input;
+		}
+		trace->lengths = realloc_ret;
+
+		trace->packets[trace->packets_nr] = malloc(header.len);
+		if (trace->packets[trace->packets_nr] == NULL) {
+			printf("failed to copy a packet.\n");
+			goto close_input;
+		}
+		memcpy(trace->packets[trace->packets_nr], packet, header.len);
+		trace->lengths[trace->packets_nr] = header.len;
+		trace->bytes_nr += header.len - ETHER_HDR_LEN;
+		trace->packets_nr++;
+	}
+
+	if (trace->packets_nr == 0) {
+		printf("no packet in the source pcap file.\n");
+		goto close_input;
+	}
+
+	status = 0;
+
+close_input:
+	pcap_close(handle);
+error:
+	return status;
+}
+
+
+/**
+ * @brief         Free the packets of a pcap file loaded in memory.
+ *
+ * @param[in,out] trace  The packets loaded.
+ */
+static void free_trace(struct bench_trace *const trace)
+{
+	size_t i;
+
+	for (i = 0; i < trace->packets_nr; i++) {
+		free(trace->packets[i]);
+	}
+	free(trace->packets);
+	free(trace->lengths);
+	trace->packets = NULL;
+	trace->lengths = NULL;
+	trace->packets_nr = 0;
+
+	return;
+}
+
+
+/**
+ * @brief         Get the monotonic time.
+ *
+ * @return        The monotonic time in ns.
+ */
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * @brief         Compare two latencies, for qsort().
+ *
+ * @param[in]     a  The first latency.
+ * @param[in]     b  The second latency.
+ *
+ * @return        -1, 0 or 1 if a is lower, equal or greater than b.
+ */
+static int compare_u64(const void *const a, const void *const b)
+{
+	const uint64_t x = *(const uint64_t *)a;
+	const uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief         Pad and send the FPDU to the receiver, then reset it for the next SDU to pack.
+ *
+ * @param[in,out] link  The FPDU and the receiver.
+ */
+static void send_fpdu(struct bench_link *const link)
+{
+	enum rle_decap_status ret_decap;
+	size_t sdus_nr = 0;
+
+	rle_pad(link->fpdu, link->fpdu_cur_pos, link->fpdu_remain_size);
+
+	ret_decap = rle_decapsulate(link->receiver, link->fpdu, link->fpdu_size, sdus_out,
+	                            MAX_SDUS_NB, &sdus_nr, NULL, 0);
+	if (ret_decap != RLE_DECAP_OK) {
+		printf("ERROR: decapsulation failed (%d)\n", ret_decap);
+		link->failed = true;
+	}
+	link->sdus_received += sdus_nr;
+
+	link->fpdu_cur_pos = 0;
+	link->fpdu_remain_size = link->fpdu_size;
+
+	return;
+}
+
+
+/**
+ * @brief         Encapsulate, fragment and pack one SDU, sending the FPDUs filled.
+ *
+ * @param[in,out] transmitter    The transmitter.
+ * @param[in,out] link           The FPDU and the receiver.
+ * @param[in]     packet         The packet to encapsulate, link layer included.
+ * @param[in]     packet_length  The length of the packet.
+ *
+ * @return        true in case of success, false otherwise.
+ */
+static bool encap(struct rle_transmitter *const transmitter, struct bench_link *const link,
+                  const unsigned char *const packet, const size_t packet_length)
+{
+	const uint8_t frag_id = 0;
+	struct rle_sdu sdu;
+
+	sdu.buffer = (unsigned char *)packet + ETHER_HDR_LEN;
+	sdu.size = packet_length - ETHER_HDR_LEN;
+	sdu.protocol_type = ntohs(*(const uint16_t *)((const void *)(packet + ETHER_HDR_LEN - 2)));
+
+	if (rle_encapsulate(transmitter, &sdu, frag_id) != RLE_ENCAP_OK) {
+		printf("ERROR: encapsulation failed\n");
+		return false;
+	}
+
+	while (rle_transmitter_stats_get_queue_size(transmitter, frag_id) != 0) {
+		enum rle_frag_status ret_frag;
+		unsigned char *ppdu;
+		size_t ppdu_length = 0;
+
+		/* a PPDU fills the FPDU, or the FPDU is sent and a PPDU fills the next one */
+		ret_frag = rle_fragment(transmitter, frag_id, link->fpdu_remain_size, &ppdu,
+		                        &ppdu_length);
+		if (ret_frag == RLE_FRAG_ERR_BURST_TOO_SMALL) {
+			send_fpdu(link);
+			ret_frag = rle_fragment(transmitter, frag_id, link->fpdu_remain_size, &ppdu,
+			                        &ppdu_length);
+		}
+		if (ret_frag != RLE_FRAG_OK) {
+			printf("ERROR: fragmentation failed (%d)\n", ret_frag);
+			return false;
+		}
+
+		if (rle_pack(ppdu, ppdu_length, NULL, 0, link->fpdu, &link->fpdu_cur_pos,
+		             &link->fpdu_remain_size) != RLE_PACK_OK) {
+			printf("ERROR: packing failed\n");
+			return false;
+		}
+
+		if (link->fpdu_remain_size == 0) {
+			send_fpdu(link);
+		}
+	}
+
+	return !link->failed;
+}
+
+
+/**
+ * @brief         Replay the trace with a configuration and a burst size, and print the results.
+ *
+ *                The latency of a SDU is the time of its encapsulation, fragmentation and packing,
+ *                and of the decapsulation of the FPDUs it completes.
+ *
+ * @param[in]     trace       The packets to replay.
+ * @param[in]     conf        The configuration of the transmitter and of the receiver.
+ * @param[in]     burst_size  The size of the FPDUs.
+ * @param[in]     iterations  The number of replays.
+ * @param[out]    latencies   The latencies of the SDUs, preallocated.
+ *
+ * @return        0 in case of success, 1 otherwise.
+ */
+static int bench(const struct bench_trace *const trace, const struct bench_conf *const conf,
+                 const size_t burst_size, const size_t iterations, uint64_t *const latencies)
+{
+	unsigned char fpdu[MAX_BURST_SIZE];
+	struct rle_transmitter *transmitter;
+	const size_t sdus_nr = trace->packets_nr * iterations;
+	struct bench_link link;
+	uint64_t start;
+	double duration;
+	int status = 1;
+	size_t it;
+
+	for (it = 0; it < MAX_SDUS_NB; it++) {
+		sdus_out[it].buffer = sdu_buffers[it];
+	}
+
+	memset(&link, 0, sizeof(link));
+	link.fpdu = fpdu;
+	link.fpdu_size = burst_size;
+	link.fpdu_remain_size = burst_size;
+
+	transmitter = rle_transmitter_new(&conf->conf);
+	link.receiver = rle_receiver_new(&conf->conf);
+	if (transmitter == NULL || link.receiver == NULL) {
+		printf("ERROR: transmitter or receiver non initialized\n");
+		goto out;
+	}
+
+	start = now_ns();
+	for (it = 0; it < sdus_nr; it++) {
+		const size_t packet_id = it % trace->packets_nr;
+		const uint64_t sdu_start = now_ns();
+
+		if (!encap(transmitter, &link, trace->packets[packet_id], trace->lengths[packet_id])) {
+			goto out;
+		}
+		latencies[it] = now_ns() - sdu_start;
+	}
+
+	/* Pad and send the last FPDU if exists. */
+	if (link.fpdu_cur_pos != 0) {
+		send_fpdu(&link);
+	}
+	duration = (double)(now_ns() - start) / 1e9;
+
+	if (link.failed || link.sdus_received != sdus_nr) {
+		printf("ERROR: %zu SDUs sent, %zu received\n", sdus_nr, link.sdus_received);
+		goto out;
+	}
+
+	qsort(latencies, sdus_nr, sizeof(uint64_t), compare_u64);
+
+	printf("%-20s %6zu %14.0f %10.3f %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+	       conf->name, burst_size, sdus_nr / duration,
+	       trace->bytes_nr * iterations * 8 / duration / 1e9,
+	       latencies[(sdus_nr - 1) / 2], latencies[(sdus_nr - 1) * 99 / 100],
+	       latencies[(sdus_nr - 1) * 999 / 1000]);
+
+	status = 0;
+
+out:
+	if (link.receiver != NULL) {
+		rle_receiver_destroy(&link.receiver);
+	}
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	return status;
+}
@@ -64,6 +64,12 @@ static bool encap_tests(void)
 	const struct test null_transmitter = { "Null transmitter", test_encap_null_transmitter };
 	const struct test too_big = { "Too big", test_encap_too_big };
 	const struct test inv_config = { "Invalid configuration", test_encap_inv_config };
+	const struct test zero_copy = { "Zero copy", test_encap_zero_copy };
+	const struct test segments = { "Scatter-gather", test_encap_segments };
+	const struct test batch = { "Batch", test_encap_batch };
+	const struct test queue = { "Queue", test_encap_queue };
+	const struct test pipe = { "Pipe", test_encap_pipe };
+	const struct test compact_contexts = { "Compact contexts", test_encap_compact_contexts };
 
 	const struct test *const encapsulation_tests[] =
 	{
@@ -71,6 +77,12 @@ static bool encap_tests(void)
 		&null_transmitter,
 		&too_big,
 		&inv_config,
+		&zero_copy,
+		&segments,
+		&batch,
+		&queue,
+		&pipe,
+		&compact_contexts,
 		NULL
 	};
 
@@ -110,6 +122,9 @@ static bool frag_tests(void)
 	const struct test too_small = { "Too small", test_frag_too_small };
 	const struct test null_context = { "Null context", test_frag_null_context };
 	const struct test real_world = { "Real-world", test_frag_real_world };
+	const struct test traffic_classes = { "Traffic classes", test_frag_traffic_classes };
+	const struct test backlog = { "Backlog", test_frag_backlog };
+	const struct test bursts = { "Bursts", test_frag_bursts };
 
 	const struct test *const fragmentation_tests[] =
 	{
@@ -118,6 +133,9 @@ static bool frag_tests(void)
 		&too_small,
 		&null_context,
 		&real_world,
+		&traffic_classes,
+		&backlog,
+		&bursts,
 		NULL
 	};
 
@@ -138,6 +156,7 @@ static bool frag_ctxtless_tests(void)
 	const struct test too_small = { "Fragmentation with length too small",
 		                        test_frag_ctxtless_too_small };
 	const struct test too_big = { "Fragmentation with length too big", test_frag_ctxtless_too_big };
+	const struct test batch = { "Batch fragmentation", test_frag_ctxtless_batch };
 
 	const struct test *const fragmentation_ctxtless_tests[] =
 	{
@@ -148,6 +167,7 @@ static bool frag_ctxtless_tests(void)
 		&no_len,
 		&too_small,
 		&too_big,
+		&batch,
 		NULL
 	};
 
@@ -162,6 +182,9 @@ static bool pack_tests(void)
 	const struct test fpdu_too_small = { "FPDU too small", test_pack_fpdu_too_small };
 	const struct test invalid_ppdu = { "Invalid PPDU", test_pack_invalid_ppdu };
 	const struct test invalid_label = { "Invalid label", test_pack_invalid_label };
+	const struct test fragment_pack = { "Fused fragmentation", test_pack_fragment };
+	const struct test plan = { "Burst plan", test_pack_plan };
+	const struct test superframe = { "Superframe", test_pack_superframe };
 
 	const struct test *const packing_tests[] =
 	{
@@ -169,6 +192,9 @@ static bool pack_tests(void)
 		&fpdu_too_small,
 		&invalid_ppdu,
 		&invalid_label,
+		&fragment_pack,
+		&plan,
+		&superframe,
 		NULL
 	};
 
@@ -194,6 +220,19 @@ static bool decap_tests(void)
 	const struct test wrong_crc = { "Wrong CRC", test_decap_wrong_crc };
 	const struct test interlaced_reassembly = { "Interlaced reassembly",
 		                                    test_decap_interlaced_reassembly };
+	const struct test receiver_set = { "Receiver set", test_decap_receiver_set };
+	const struct test zero_copy = { "Zero copy", test_decap_zero_copy };
+	const struct test padding_check = { "Padding check", test_decap_padding_check };
+	const struct test ctx_ageing = { "Context ageing", test_decap_ctx_ageing };
+	const struct test engine = { "Parallel engine", test_decap_engine };
+	const struct test callbacks = { "Callbacks", test_decap_callbacks };
+	const struct test resume = { "Resume", test_decap_resume };
+	const struct test burst = { "Burst", test_decap_burst };
+	const struct test wrapped = { "Wrapped", test_decap_wrapped };
+	const struct test errors = { "Rejection counters", test_decap_errors };
+	const struct test validation = { "FPDU validation", test_decap_validation };
+	const struct test fpdu_index = { "FPDU index", test_decap_index };
+	const struct test stream = { "Streaming", test_decap_stream };
 
 	const struct test *const decapsulation_tests[] =
 	{
@@ -211,6 +250,19 @@ static bool decap_tests(void)
 		&ppdu_2_bytes,
 		&wrong_crc,
 		&interlaced_reassembly,
+		&receiver_set,
+		&zero_copy,
+		&padding_check,
+		&ctx_ageing,
+		&engine,
+		&callbacks,
+		&resume,
+		&burst,
+		&wrapped,
+		&errors,
+		&validation,
+		&fpdu_index,
+		&stream,
 		NULL
 	};
 
@@ -225,6 +277,10 @@ static bool misc_tests(void)
 		                                   test_request_rle_header_overhead_all };
 	const struct test request_overhead_traffic = { "Request overhead Traffic",
 		                                       test_request_rle_header_overhead_traffic };
+	const struct test request_alpdu_header_size = { "Request ALPDU header size",
+		                                        test_request_alpdu_header_size };
+	const struct test request_overhead_estimate = { "Request overhead estimate",
+		                                        test_request_overhead_estimate };
 	const struct test allocation_transmitter = { "Transmitter allocation",
 		                                     test_rle_allocation_transmitter };
 	const struct test destruction_transmitter = { "Transmitter destruction",
@@ -241,11 +297,32 @@ static bool misc_tests(void)
 		                                   test_rle_api_robustness_transmitter };
 	const struct test api_robustness_recv = { "API robustness for receiver",
 		                                  test_rle_api_robustness_receiver };
+	const struct test crc_implementation = { "CRC32 implementation",
+		                                 test_rle_crc_implementation };
+	const struct test log_level = { "Log level", test_rle_log_level };
+	const struct test allocator = { "Allocator", test_rle_allocator };
+	const struct test in_place = { "In-place initialization", test_rle_in_place };
+	const struct test timing = { "Timing histograms", test_rle_timing };
+	const struct test copy_stats = { "Copies counters", test_rle_copy_stats };
+	const struct test size_stats = { "SDU sizes histograms", test_rle_size_stats };
+	const struct test adaptive_ptype = { "Adaptive implicit protocol type",
+	                                     test_rle_adaptive_ptype };
+	const struct test log_sink = { "Log sinks", test_rle_log_sink };
+	const struct test ppdu_hdr_specialization = { "PPDU headers specialization",
+	                                              test_rle_ppdu_hdr_specialization };
+	const struct test header_templates = { "Header templates", test_rle_header_templates };
+	const struct test sdu_pool = { "SDU buffer pool", test_rle_sdu_pool };
+	const struct test protection_policy = { "Protection policy", test_rle_protection_policy };
+	const struct test stats_fetch_and_reset = { "Statistics fetch and reset",
+	                                            test_rle_stats_fetch_and_reset };
+	const struct test realtime = { "Real-time mode", test_rle_realtime };
 
 	const struct test *const miscellaneous_tests[] =
 	{
 		&request_overhead_all,
 		&request_overhead_traffic,
+		&request_alpdu_header_size,
+		&request_overhead_estimate,
 		&allocation_transmitter,
 		&destruction_transmitter,
 		&allocation_receiver,
@@ -254,6 +331,21 @@ static bool misc_tests(void)
 		&destruction_f_buff,
 		&api_robustness_trans,
 		&api_robustness_recv,
+		&crc_implementation,
+		&log_level,
+		&allocator,
+		&in_place,
+		&timing,
+		&copy_stats,
+		&size_stats,
+		&adaptive_ptype,
+		&log_sink,
+		&ppdu_hdr_specialization,
+		&header_templates,
+		&sdu_pool,
+		&protection_policy,
+		&stats_fetch_and_reset,
+		&realtime,
 		NULL
 	};
 
@@ -575,6 +575,27 @@ bool test_rle_api_robustness_transmitter(void)
 		counter = rle_transmitter_stats_get_counters(rle_transmitter, 1, &stats);
 		assert(counter == 0);
 
+		printf("\t\trle_transmitter_stats_get_all_counters()\n");
+		{
+			struct rle_transmitter_stats all_stats[RLE_MAX_FRAG_NUMBER];
+			struct rle_transmitter_stats total;
+			size_t frag_id;
+
+			counter = rle_transmitter_stats_get_all_counters(NULL, all_stats, &total);
+			assert(counter == 1);
+			counter = rle_transmitter_stats_get_all_counters(rle_transmitter, NULL, NULL);
+			assert(counter == 1);
+			counter = rle_transmitter_stats_get_all_counters(rle_transmitter, all_stats,
+			                                                 &total);
+			assert(counter == 0);
+			assert(memcmp(&all_stats[1], &stats, sizeof(stats)) == 0);
+			for (frag_id = 0; frag_id < RLE_MAX_FRAG_NUMBER; frag_id++) {
+				total.sdus_in -= all_stats[frag_id].sdus_in;
+				total.bytes_in -= all_stats[frag_id].bytes_in;
+			}
+			assert(total.sdus_in == 0 && total.bytes_in == 0);
+		}
+
 		printf("\t\trle_transmitter_stats_reset_counters()\n");
 		rle_transmitter_stats_reset_counters(NULL, 0);
 		rle_transmitter_stats_reset_counters(rle_transmitter, RLE_MAX_FRAG_ID + 1);
@@ -1009,6 +1030,24 @@ bool test_rle_api_robustness_receiver(void)
 		counter = rle_receiver_stats_get_counters(rle_receiver, 1, &stats);
 		assert(counter == 0);
 
+		printf("\t\trle_receiver_stats_get_all_counters()\n");
+		{
+			struct rle_receiver_stats all_stats[RLE_MAX_FRAG_NUMBER];
+
+			struct rle_receiver_stats total;
+
+			counter = rle_receiver_stats_get_all_counters(NULL, all_stats, &total);
+			assert(counter == 1);
+			counter = rle_receiver_stats_get_all_counters(rle_receiver, NULL, NULL);
+			assert(counter == 1);
+			counter = rle_receiver_stats_get_all_counters(rle_receiver, all_stats, NULL);
+			assert(counter == 0);
+			assert(memcmp(&all_stats[1], &stats, sizeof(stats)) == 0);
+			counter = rle_receiver_stats_get_all_counters(rle_receiver, NULL, &total);
+			assert(counter == 0);
+			assert(total.sdus_received == 0);
+		}
+
 		printf("\t\trle_receiver_stats_reset_counters()\n");
 		rle_receiver_stats_reset_counters(NULL, 0);
 		rle_receiver_stats_reset_counters(rle_receiver, RLE_MAX_FRAG_ID + 1);
@@ -1074,6 +1113,32 @@ bool test_rle_api_robustness_receiver(void)
 				.size = sizeof(sdu_vlan_arp_data),
 				.protocol_type = RLE_PROTO_TYPE_SIGNAL_UNCOMP,
 			};
+			const unsigned char sdu_vlan_bad_ip_data[] = {
+				0x00, 0x01, 0x02, 0x03, 0x04, 0x05, /* destination MAC address */
+				0x00, 0x01, 0x02, 0x03, 0x04, 0x05, /* source MAC address */
+				0x81, 0x00,                         /* Ethertype VLAN */
+				0x00, 0xff,                         /* VLAN infos */
+				0x08, 0x00,                         /* Ethertype IPv4 */
+				0x60,                               /* fake start of IPv6 header */
+			};
+			const struct rle_sdu sdu_vlan_bad_ip = {
+				.buffer = (unsigned char *)sdu_vlan_bad_ip_data,
+				.size = sizeof(sdu_vlan_bad_ip_data),
+				.protocol_type = RLE_PROTO_TYPE_SIGNAL_UNCOMP,
+			};
+			const unsigned char sdu_not_vlan_data[] = {
+				0x00, 0x01, 0x02, 0x03, 0x04, 0x05, /* destination MAC address */
+				0x00, 0x01, 0x02, 0x03, 0x04, 0x05, /* source MAC address */
+				0x88, 0xa8,                         /* Ethertype QinQ */
+				0x00, 0xff,                         /* VLAN infos */
+				0x08, 0x00,                         /* Ethertype IPv4 */
+				0x45,                               /* fake start of IPv4 header */
+			};
+			const struct rle_sdu sdu_not_vlan = {
+				.buffer = (unsigned char *)sdu_not_vlan_data,
+				.size = sizeof(sdu_not_vlan_data),
+				.protocol_type = RLE_PROTO_TYPE_SIGNAL_UNCOMP,
+			};
 
 			uint8_t comp_protocol_type;
 			struct rle_frag_buf *buf;
@@ -1118,6 +1183,30 @@ bool test_rle_api_robustness_receiver(void)
 			       comp_protocol_type, RLE_PROTO_TYPE_VLAN_COMP);
 			assert(comp_protocol_type == RLE_PROTO_TYPE_VLAN_COMP);
 
+			/* the IP version shall match the VLAN protocol type */
+			ret = rle_frag_buf_init(buf);
+			assert(ret == 0);
+			ret = rle_frag_buf_cpy_sdu(buf, &sdu_vlan_bad_ip);
+			assert(ret == 0);
+			comp_protocol_type =
+				rle_header_ptype_compression(RLE_PROTO_TYPE_VLAN_UNCOMP, buf);
+			printf("\t\tprotocol type VLAN (0x%02x) with a wrong IP version is compressed "
+			       "as 0x%02x (0x%02x expected)\n", RLE_PROTO_TYPE_SIGNAL_UNCOMP,
+			       comp_protocol_type, RLE_PROTO_TYPE_VLAN_COMP);
+			assert(comp_protocol_type == RLE_PROTO_TYPE_VLAN_COMP);
+
+			/* a frame that is not Ethernet/VLAN is malformed */
+			ret = rle_frag_buf_init(buf);
+			assert(ret == 0);
+			ret = rle_frag_buf_cpy_sdu(buf, &sdu_not_vlan);
+			assert(ret == 0);
+			comp_protocol_type =
+				rle_header_ptype_compression(RLE_PROTO_TYPE_VLAN_UNCOMP, buf);
+			printf("\t\tprotocol type VLAN (0x%02x) without Ethernet/VLAN is compressed "
+			       "as 0x%02x (0x%02x expected)\n", RLE_PROTO_TYPE_SIGNAL_UNCOMP,
+			       comp_protocol_type, RLE_PROTO_TYPE_FALLBACK);
+			assert(comp_protocol_type == RLE_PROTO_TYPE_FALLBACK);
+
 			rle_frag_buf_del(&buf);
 		}
 	}
@@ -31,6 +31,7 @@
 #include "rle_transmitter.h"
 #include "rle_receiver.h"
 #include "fragmentation_buffer.h"
+#include "header.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -40,6 +41,22 @@
 #include <string.h>
 #include <assert.h>
 
+/**
+ * @brief         Completion callback of the decapsulation engine test, counting the completions.
+ *
+ * @param[in,out] arg                  The completions counter.
+ * @param[in]     worker               The worker that ran the job.
+ * @param[in]     job                  The completed job.
+ */
+static void count_completions(void *const arg, const unsigned int worker,
+                              struct rle_decap_job *const job);
+
+static void count_completions(void *const arg, const unsigned int worker __attribute__((unused)),
+                              struct rle_decap_job *const job __attribute__((unused)))
+{
+	__atomic_fetch_add((size_t *)arg, 1, __ATOMIC_RELAXED);
+}
+
 /**
  * @brief         Generic decapsulation test.
  *
@@ -2261,3 +2278,2187 @@ error:
 	printf("\n");
 	return is_success;
 }
+
+bool test_decap_receiver_set(void)
+{
+	bool is_success = false;
+	size_t i;
+
+	const size_t terminals_nr = 3;
+	const size_t label_size = 3;
+	const unsigned char labels[3][3] = {
+		{ 0x00, 0x00, 0x01 },
+		{ 0x00, 0x00, 0x02 },
+		{ 0x00, 0x01, 0x00 }
+	};
+	const size_t fpdu_length = 45;
+	const size_t fpdus_per_sdu = 3;
+	unsigned char fpdus[3][3][45];
+	/* FPDUs of terminals 0 and 1 interlaced, then the FPDUs of terminal 2 */
+	const size_t schedule[9][2] = {
+		{ 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 }, { 0, 2 }, { 1, 2 }, { 2, 0 }, { 2, 1 }, { 2, 2 }
+	};
+
+	const size_t sdu_length = 100;
+	unsigned char buffer_in[100];
+	unsigned char buffer_out[100];
+	struct rle_sdu sdu = {
+		.buffer = buffer_in,
+		.size = sdu_length,
+		.protocol_type = 0x0800
+	};
+	struct rle_sdu sdus[1];
+	size_t sdus_total_nr = 0;
+	unsigned char payload_label[3];
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_receiver_set *set = NULL;
+
+	PRINT_TEST("Receiver set");
+
+	memcpy(buffer_in, payload_initializer, sdu_length);
+	buffer_in[0] = 0x45; /* IPv4 */
+
+	/* each terminal sends the same SDU in 3 FPDUs */
+	for (i = 0; i < terminals_nr; i++) {
+		struct rle_transmitter *transmitter = rle_transmitter_new(&conf);
+		size_t fpdu_id;
+
+		assert(transmitter != NULL);
+
+		if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+			PRINT_ERROR("Encap does not return OK.");
+			rle_transmitter_destroy(&transmitter);
+			goto error;
+		}
+
+		for (fpdu_id = 0; fpdu_id < fpdus_per_sdu; fpdu_id++) {
+			size_t fpdu_cur_pos = 0;
+			size_t fpdu_remain_size = fpdu_length;
+			size_t used_size;
+
+			if (rle_fragment_pack(transmitter, 0, labels[i], label_size, fpdus[i][fpdu_id],
+			                      &fpdu_cur_pos, &fpdu_remain_size, &used_size) != RLE_PACK_OK) {
+				PRINT_ERROR("Fragment and pack does not return OK.");
+				rle_transmitter_destroy(&transmitter);
+				goto error;
+			}
+			rle_pad(fpdus[i][fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+		}
+
+		assert(rle_transmitter_stats_get_queue_size(transmitter, 0) == 0);
+		rle_transmitter_destroy(&transmitter);
+	}
+
+	if (rle_receiver_set_new(&conf, 0, 2) != NULL ||
+	    rle_receiver_set_new(&conf, label_size, 0) != NULL) {
+		PRINT_ERROR("Receiver set created with invalid parameters.");
+		goto error;
+	}
+
+	/* room for 2 terminals only */
+	set = rle_receiver_set_new(&conf, label_size, 2);
+	if (set == NULL) {
+		PRINT_ERROR("Error allocating receiver set.");
+		goto error;
+	}
+
+	for (i = 0; i < (terminals_nr * fpdus_per_sdu); i++) {
+		const size_t terminal = schedule[i][0];
+		size_t sdus_nr = 0;
+
+		sdus[0].buffer = buffer_out;
+		sdus[0].size = 0;
+		sdus[0].protocol_type = 0;
+
+		if (rle_receiver_set_decapsulate(set, fpdus[terminal][schedule[i][1]], fpdu_length, sdus,
+		                                 1, &sdus_nr, payload_label) != RLE_DECAP_OK) {
+			PRINT_ERROR("Decap does not return OK.");
+			goto free_set;
+		}
+
+		if (memcmp(payload_label, labels[terminal], label_size) != 0) {
+			PRINT_ERROR("Wrong payload label.");
+			goto free_set;
+		}
+
+		if (sdus_nr == 1) {
+			if (sdus[0].size != sdu_length || memcmp(buffer_out, buffer_in, sdu_length) != 0) {
+				PRINT_ERROR("SDU of terminal %zu wrongly reassembled.", terminal);
+				goto free_set;
+			}
+			sdus_total_nr++;
+		}
+
+		if (rle_receiver_set_get_terminals_nr(set) > 2) {
+			PRINT_ERROR("Too many active terminals.");
+			goto free_set;
+		}
+	}
+
+	if (sdus_total_nr != terminals_nr) {
+		PRINT_ERROR("%zu SDUs decapsulated while %zu SDUs encapsulated", sdus_total_nr,
+		            terminals_nr);
+		goto free_set;
+	}
+
+	/* terminal 0, the least recently seen, was evicted to make room for terminal 2 */
+	if (rle_receiver_set_get_receiver(set, labels[0]) != NULL ||
+	    rle_receiver_set_get_receiver(set, labels[1]) == NULL ||
+	    rle_receiver_set_get_receiver(set, labels[2]) == NULL) {
+		PRINT_ERROR("Wrong terminal evicted.");
+		goto free_set;
+	}
+
+	if (rle_receiver_stats_get_counter_sdus_reassembled(
+		    rle_receiver_set_get_receiver(set, labels[2]), 0) != 1) {
+		PRINT_ERROR("SDU not counted in the receiver of terminal 2.");
+		goto free_set;
+	}
+
+	/* statistics of terminals 1 and 2 are dumped at once */
+	{
+		struct rle_receiver_set_stats terminals[4];
+		size_t dumped_nr;
+
+		dumped_nr = rle_receiver_set_stats_dump(set, terminals, 4);
+		if (dumped_nr != 2 || rle_receiver_set_stats_dump(set, terminals, 1) != 1) {
+			PRINT_ERROR("%zu terminals dumped, 2 expected.", dumped_nr);
+			goto free_set;
+		}
+		dumped_nr = rle_receiver_set_stats_dump(set, terminals, 4);
+		for (i = 0; i < dumped_nr; i++) {
+			if ((memcmp(terminals[i].payload_label, labels[1], label_size) != 0 &&
+			     memcmp(terminals[i].payload_label, labels[2], label_size) != 0) ||
+			    terminals[i].stats.sdus_reassembled != 1 ||
+			    terminals[i].stats.bytes_reassembled != sdu_length) {
+				PRINT_ERROR("Wrong statistics dumped for terminal #%zu.", i);
+				goto free_set;
+			}
+		}
+	}
+
+	/* terminal 1 sent no FPDU for the last 3 FPDUs */
+	if (rle_receiver_set_evict_idle(set, 2) != 1 ||
+	    rle_receiver_set_get_terminals_nr(set) != 1 ||
+	    rle_receiver_set_get_receiver(set, labels[1]) != NULL) {
+		PRINT_ERROR("Idle terminal not evicted.");
+		goto free_set;
+	}
+
+	is_success = true;
+
+free_set:
+	rle_receiver_set_destroy(&set);
+error:
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+}
+
+bool test_decap_zero_copy(void)
+{
+	bool is_success = false;
+	size_t i;
+
+	const size_t fpdu_length = 500;
+	unsigned char fpdus[2][500];
+	size_t fpdu_id = 0;
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = fpdu_length;
+
+	unsigned char buffer_ipv4[100];
+	unsigned char buffer_vlan[100];
+	unsigned char buffer_long[600];
+	/* an IPv4 SDU and a VLAN/IPv4 SDU in COMPLETE PPDUs, then a SDU fragmented over 2 FPDUs */
+	const struct rle_sdu sdus_in[] = {
+		{ .buffer = buffer_ipv4, .size = sizeof(buffer_ipv4), .protocol_type = 0x0800 },
+		{ .buffer = buffer_vlan, .size = sizeof(buffer_vlan), .protocol_type = 0x8100 },
+		{ .buffer = buffer_long, .size = sizeof(buffer_long), .protocol_type = 0x0800 },
+	};
+	const size_t sdus_in_nr = 3;
+
+	unsigned char buffers_out[3][4096];
+	struct rle_sdu sdus[3];
+	size_t sdus_total_nr = 0;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_receiver *receiver = NULL;
+	struct rle_transmitter *transmitter = NULL;
+
+	PRINT_TEST("Zero copy decapsulation");
+
+	memcpy(buffer_ipv4, payload_initializer, sizeof(buffer_ipv4));
+	buffer_ipv4[0] = 0x45;
+	memcpy(buffer_vlan, payload_initializer, sizeof(buffer_vlan));
+	buffer_vlan[12] = 0x81;
+	buffer_vlan[13] = 0x00;
+	buffer_vlan[16] = 0x08;
+	buffer_vlan[17] = 0x00;
+	buffer_vlan[18] = 0x45;
+	memcpy(buffer_long, payload_initializer, sizeof(buffer_long));
+	buffer_long[0] = 0x45;
+
+	receiver = rle_receiver_new(&conf);
+	transmitter = rle_transmitter_new(&conf);
+	if (receiver == NULL || transmitter == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	for (i = 0; i < sdus_in_nr; i++) {
+		if (rle_encapsulate(transmitter, &sdus_in[i], i) != RLE_ENCAP_OK) {
+			PRINT_ERROR("Encap does not return OK.");
+			goto out;
+		}
+
+		while (rle_transmitter_stats_get_queue_size(transmitter, i) > 0) {
+			size_t used_size;
+
+			if (rle_fragment_pack(transmitter, i, NULL, 0, fpdus[fpdu_id], &fpdu_cur_pos,
+			                      &fpdu_remain_size, &used_size) != RLE_PACK_OK) {
+				PRINT_ERROR("Fragment and pack does not return OK.");
+				goto out;
+			}
+
+			if (rle_transmitter_stats_get_queue_size(transmitter, i) > 0) {
+				/* the SDU did not fit, go on in the next FPDU */
+				rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+				fpdu_id++;
+				assert(fpdu_id < 2);
+				fpdu_cur_pos = 0;
+				fpdu_remain_size = fpdu_length;
+			}
+		}
+	}
+	rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+
+	if (fpdu_id != 1) {
+		PRINT_ERROR("Last SDU not fragmented over 2 FPDUs.");
+		goto out;
+	}
+
+	for (fpdu_id = 0; fpdu_id < 2; fpdu_id++) {
+		size_t sdus_nr = 0;
+
+		for (i = 0; i < 3; i++) {
+			sdus[i].buffer = buffers_out[i];
+			sdus[i].size = 0;
+			sdus[i].protocol_type = 0;
+		}
+
+		if (rle_decapsulate_zero_copy(receiver, fpdus[fpdu_id], fpdu_length, sdus, 3,
+		                              &sdus_nr, NULL, 0) != RLE_DECAP_OK) {
+			PRINT_ERROR("Decap does not return OK.");
+			goto out;
+		}
+
+		for (i = 0; i < sdus_nr; i++) {
+			const struct rle_sdu *const sdu_in = &sdus_in[sdus_total_nr];
+			const bool in_fpdu = (sdus[i].buffer >= fpdus[fpdu_id] &&
+			                      sdus[i].buffer < (fpdus[fpdu_id] + fpdu_length));
+
+			if (sdus[i].size != sdu_in->size || sdus[i].protocol_type != sdu_in->protocol_type ||
+			    memcmp(sdus[i].buffer, sdu_in->buffer, sdu_in->size) != 0) {
+				PRINT_ERROR("SDU #%zu wrongly decapsulated.", sdus_total_nr + 1);
+				goto out;
+			}
+
+			/* the SDUs in COMPLETE PPDUs are left in the FPDU, the VLAN one rebuilt in
+			 * place, and the reassembled SDU is left in the reassembly storage */
+			if (in_fpdu != (sdus_total_nr < 2) || sdus[i].buffer == buffers_out[i]) {
+				PRINT_ERROR("SDU #%zu %s copied.", sdus_total_nr + 1, in_fpdu ? "not" : "wrongly");
+				goto out;
+			}
+
+			sdus_total_nr++;
+		}
+	}
+
+	if (sdus_total_nr != sdus_in_nr) {
+		PRINT_ERROR("%zu SDUs decapsulated while %zu SDUs encapsulated", sdus_total_nr,
+		            sdus_in_nr);
+		goto out;
+	}
+
+	is_success = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+}
+
+bool test_decap_padding_check(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	unsigned char fpdu[600];
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[1] = { { .buffer = buffer, .size = 0, .protocol_type = 0 } };
+	struct rle_receiver *receiver;
+	size_t sdus_nr;
+	size_t i;
+
+	PRINT_TEST("Padding check");
+
+	receiver = rle_receiver_new(&conf);
+	if (receiver == NULL) {
+		PRINT_ERROR("Error allocating receiver.");
+		goto out;
+	}
+
+	/* a valid padding-only FPDU, then non-zero octets at every position after the first PPDU
+	 * header bytes, whatever the alignment */
+	memset(fpdu, 0x00, sizeof(fpdu));
+	if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) !=
+	    RLE_DECAP_OK || rle_receiver_stats_get_counter_padding_errors(receiver) != 0) {
+		PRINT_ERROR("Zero padding shall be valid.");
+		goto destroy;
+	}
+
+	for (i = 2; i < sizeof(fpdu); i++) {
+		fpdu[i] = 0x5a;
+		if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) !=
+		    RLE_DECAP_OK) {
+			PRINT_ERROR("Invalid padding shall not fail decapsulation.");
+			goto destroy;
+		}
+		fpdu[i] = 0x00;
+		if (rle_receiver_stats_get_counter_padding_errors(receiver) != (i - 1)) {
+			PRINT_ERROR("Non-zero padding byte #%zu not detected.", i + 1);
+			goto destroy;
+		}
+	}
+
+	rle_receiver_set_padding_check(receiver, RLE_PADDING_CHECK_NONE);
+	fpdu[sizeof(fpdu) - 1] = 0x5a;
+	for (i = 0; i < RLE_PADDING_CHECK_SAMPLING; i++) {
+		if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) !=
+		    RLE_DECAP_OK) {
+			PRINT_ERROR("Decapsulation failed without padding check.");
+			goto destroy;
+		}
+	}
+	if (rle_receiver_stats_get_counter_padding_errors(receiver) != (sizeof(fpdu) - 2)) {
+		PRINT_ERROR("Padding verified while check is disabled.");
+		goto destroy;
+	}
+
+	rle_receiver_set_padding_check(receiver, RLE_PADDING_CHECK_SAMPLED);
+	for (i = 0; i < (2 * RLE_PADDING_CHECK_SAMPLING); i++) {
+		if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) !=
+		    RLE_DECAP_OK) {
+			PRINT_ERROR("Decapsulation failed with sampled padding check.");
+			goto destroy;
+		}
+	}
+	if (rle_receiver_stats_get_counter_padding_errors(receiver) != (sizeof(fpdu) - 2 + 2)) {
+		PRINT_ERROR("Sampled check shall verify one FPDU out of %d.",
+		            RLE_PADDING_CHECK_SAMPLING);
+		goto destroy;
+	}
+
+	output = true;
+
+destroy:
+	rle_receiver_destroy(&receiver);
+out:
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_decap_ctx_ageing(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	unsigned char sdu_buffer[300];
+	const struct rle_sdu sdu = {
+		.buffer = sdu_buffer, .size = sizeof(sdu_buffer), .protocol_type = 0x0800
+	};
+	unsigned char fpdu[100];
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[1] = { { .buffer = buffer, .size = 0, .protocol_type = 0 } };
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	const uint8_t frag_id = 3;
+	size_t sdus_nr = 0;
+	size_t round;
+
+	PRINT_TEST("Reassembly context ageing");
+
+	memcpy(sdu_buffer, payload_initializer, sizeof(sdu_buffer));
+
+	receiver = rle_receiver_new(&conf);
+	if (receiver == NULL) {
+		PRINT_ERROR("Error allocating receiver.");
+		goto out;
+	}
+	rle_receiver_set_ctx_timeout(receiver, 100);
+
+	/* the first SDU loses its CONT and END PPDUs, the second one is fully received */
+	for (round = 0; round < 2; round++) {
+		size_t fpdus_nr = 0;
+
+		transmitter = rle_transmitter_new(&conf);
+		if (transmitter == NULL) {
+			PRINT_ERROR("Error allocating transmitter.");
+			goto destroy;
+		}
+
+		if (rle_encapsulate(transmitter, &sdu, frag_id) != RLE_ENCAP_OK) {
+			PRINT_ERROR("Encap does not return OK.");
+			goto destroy;
+		}
+
+		while (rle_transmitter_stats_get_queue_size(transmitter, frag_id) > 0) {
+			size_t fpdu_cur_pos = 0;
+			size_t fpdu_remain_size = sizeof(fpdu);
+			size_t used_size;
+
+			if (rle_fragment_pack(transmitter, frag_id, NULL, 0, fpdu, &fpdu_cur_pos,
+			                      &fpdu_remain_size, &used_size) != RLE_PACK_OK) {
+				PRINT_ERROR("Fragment and pack does not return OK.");
+				goto destroy;
+			}
+			rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+
+			if (round == 0 && fpdus_nr > 0) {
+				continue;
+			}
+
+			if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) !=
+			    RLE_DECAP_OK) {
+				PRINT_ERROR("Decap does not return OK.");
+				goto destroy;
+			}
+			fpdus_nr++;
+		}
+
+		rle_transmitter_destroy(&transmitter);
+
+		if (round == 0) {
+			if (rle_receiver_tick(receiver, 99) != 0) {
+				PRINT_ERROR("Context expired before its timeout.");
+				goto destroy;
+			}
+			if (rle_receiver_tick(receiver, 1000) != 1) {
+				PRINT_ERROR("Context not expired after its timeout.");
+				goto destroy;
+			}
+			if (rle_receiver_stats_get_counter_sdus_lost(receiver, frag_id) != 1) {
+				PRINT_ERROR("Expired SDU not counted as lost.");
+				goto destroy;
+			}
+		}
+	}
+
+	if (sdus_nr != 1 || sdus[0].size != sdu.size || memcmp(sdus[0].buffer, sdu_buffer,
+	                                                        sdu.size) != 0) {
+		PRINT_ERROR("SDU not reassembled in the reclaimed context.");
+		goto destroy;
+	}
+
+	if (rle_receiver_tick(receiver, 100000) != 0) {
+		PRINT_ERROR("Free context expired.");
+		goto destroy;
+	}
+
+	output = true;
+
+destroy:
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receiver);
+out:
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_decap_engine(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+#define ENGINE_TEST_TERMINALS  16
+#define ENGINE_TEST_SDUS       3
+#define ENGINE_TEST_FPDUS      32
+	const size_t fpdu_length = 60;
+	static unsigned char fpdus[ENGINE_TEST_TERMINALS][ENGINE_TEST_FPDUS][60];
+	static unsigned char buffers[ENGINE_TEST_TERMINALS][ENGINE_TEST_FPDUS][RLE_MAX_PDU_SIZE];
+	static struct rle_sdu sdus[ENGINE_TEST_TERMINALS][ENGINE_TEST_FPDUS];
+	static struct rle_decap_job jobs[ENGINE_TEST_TERMINALS * ENGINE_TEST_FPDUS];
+	size_t fpdus_nr[ENGINE_TEST_TERMINALS];
+	size_t max_fpdus_nr = 0;
+	struct rle_receiver *receivers[ENGINE_TEST_TERMINALS] = { NULL };
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_decap_engine *engine = NULL;
+	unsigned char sdu_buffer[300];
+	size_t completions_nr = 0;
+	size_t jobs_nr = 0;
+	size_t first_job;
+	size_t t;
+	size_t f;
+
+	PRINT_TEST("Parallel decapsulation engine");
+
+	memcpy(sdu_buffer, payload_initializer, sizeof(sdu_buffer));
+
+	/* fragment the SDUs of each terminal, one PPDU per FPDU */
+	for (t = 0; t < ENGINE_TEST_TERMINALS; t++) {
+		size_t s;
+
+		receivers[t] = rle_receiver_new(&conf);
+		transmitter = rle_transmitter_new(&conf);
+		if (receivers[t] == NULL || transmitter == NULL) {
+			PRINT_ERROR("Error allocating transmitter or receiver.");
+			goto destroy;
+		}
+
+		fpdus_nr[t] = 0;
+		for (s = 0; s < ENGINE_TEST_SDUS; s++) {
+			const struct rle_sdu sdu = {
+				.buffer = sdu_buffer, .size = 100 + 10 * t + s, .protocol_type = 0x0800
+			};
+
+			if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+				PRINT_ERROR("Encap does not return OK.");
+				goto destroy;
+			}
+			while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+				unsigned char *const fpdu = fpdus[t][fpdus_nr[t]];
+				size_t fpdu_cur_pos = 0;
+				size_t fpdu_remain_size = fpdu_length;
+				size_t used_size;
+
+				assert(fpdus_nr[t] < ENGINE_TEST_FPDUS);
+				if (rle_fragment_pack(transmitter, 0, NULL, 0, fpdu, &fpdu_cur_pos,
+				                      &fpdu_remain_size, &used_size) != RLE_PACK_OK) {
+					PRINT_ERROR("Fragment and pack does not return OK.");
+					goto destroy;
+				}
+				rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+				fpdus_nr[t]++;
+			}
+		}
+		if (fpdus_nr[t] > max_fpdus_nr) {
+			max_fpdus_nr = fpdus_nr[t];
+		}
+		rle_transmitter_destroy(&transmitter);
+	}
+
+	/* interleave the FPDUs of the terminals, as received on the return link */
+	for (f = 0; f < max_fpdus_nr; f++) {
+		for (t = 0; t < ENGINE_TEST_TERMINALS; t++) {
+			if (f < fpdus_nr[t]) {
+				struct rle_decap_job *const job = &jobs[jobs_nr++];
+
+				sdus[t][f].buffer = buffers[t][f];
+				sdus[t][f].size = 0;
+				job->receiver = receivers[t];
+				job->fpdu = fpdus[t][f];
+				job->fpdu_length = fpdu_length;
+				job->sdus = &sdus[t][f];
+				job->sdus_max_nr = 1;
+				job->sdus_nr = 0;
+				job->payload_label = NULL;
+				job->payload_label_size = 0;
+			}
+		}
+	}
+
+	engine = rle_decap_engine_new(4, jobs_nr, count_completions, &completions_nr);
+	if (engine == NULL) {
+		PRINT_ERROR("Error allocating engine.");
+		goto destroy;
+	}
+
+	if (rle_decap_engine_run(engine, jobs, jobs_nr + 1) == 0) {
+		PRINT_ERROR("Batch bigger than the engine max shall be refused.");
+		goto destroy;
+	}
+
+	/* two batches, the SDUs of the terminals span both */
+	first_job = jobs_nr / 2;
+	if (rle_decap_engine_run(engine, jobs, first_job) != 0 ||
+	    rle_decap_engine_run(engine, &jobs[first_job], jobs_nr - first_job) != 0) {
+		PRINT_ERROR("Engine run failed.");
+		goto destroy;
+	}
+
+	if (completions_nr != jobs_nr) {
+		PRINT_ERROR("%zu completions for %zu jobs.", completions_nr, jobs_nr);
+		goto destroy;
+	}
+
+	for (t = 0; t < ENGINE_TEST_TERMINALS; t++) {
+		size_t sdus_nr = 0;
+
+		for (f = 0; f < fpdus_nr[t]; f++) {
+			if (sdus[t][f].size == 0) {
+				continue;
+			}
+			if (sdus[t][f].size != (100 + 10 * t + sdus_nr) ||
+			    memcmp(sdus[t][f].buffer, sdu_buffer, sdus[t][f].size) != 0) {
+				PRINT_ERROR("Terminal %zu: SDU %zu badly reassembled.", t, sdus_nr);
+				goto destroy;
+			}
+			sdus_nr++;
+		}
+		if (sdus_nr != ENGINE_TEST_SDUS) {
+			PRINT_ERROR("Terminal %zu: %zu SDUs reassembled, %d expected.", t, sdus_nr,
+			            ENGINE_TEST_SDUS);
+			goto destroy;
+		}
+	}
+	for (f = 0; f < jobs_nr; f++) {
+		if (jobs[f].status != RLE_DECAP_OK) {
+			PRINT_ERROR("Job %zu failed.", f);
+			goto destroy;
+		}
+	}
+
+	output = true;
+
+destroy:
+	rle_decap_engine_destroy(&engine);
+	rle_transmitter_destroy(&transmitter);
+	for (t = 0; t < ENGINE_TEST_TERMINALS; t++) {
+		rle_receiver_destroy(&receivers[t]);
+	}
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+#undef ENGINE_TEST_FPDUS
+#undef ENGINE_TEST_SDUS
+#undef ENGINE_TEST_TERMINALS
+}
+
+/** User buffers of the callback decapsulation test */
+struct decap_cb_pool {
+	unsigned char buffers[8][600];  /**< The SDU buffers                               */
+	size_t lengths[8];              /**< The lengths asked by the allocator callback   */
+	size_t alloc_nr;                /**< The number of buffers given                   */
+	size_t alloc_max;               /**< The number of buffers to give before refusing */
+	struct rle_sdu sdus[8];         /**< The delivered SDUs                            */
+	size_t deliver_nr;              /**< The number of SDUs delivered                  */
+};
+
+static unsigned char * decap_cb_alloc(void *const arg, const size_t sdu_length)
+{
+	struct decap_cb_pool *const pool = (struct decap_cb_pool *)arg;
+
+	if (pool->alloc_nr == pool->alloc_max || sdu_length > sizeof(pool->buffers[0])) {
+		return NULL;
+	}
+	pool->lengths[pool->alloc_nr] = sdu_length;
+
+	return pool->buffers[pool->alloc_nr++];
+}
+
+static void decap_cb_deliver(void *const arg, const struct rle_sdu *const sdu)
+{
+	struct decap_cb_pool *const pool = (struct decap_cb_pool *)arg;
+
+	pool->sdus[pool->deliver_nr++] = *sdu;
+}
+
+static void decap_cb_deliver_in_place(void *const arg, const struct rle_sdu *const sdu)
+{
+	struct decap_cb_pool *const pool = (struct decap_cb_pool *)arg;
+
+	/* the reassembled SDUs are only valid during the callback, keep a copy to check them */
+	if (sdu->size <= sizeof(pool->buffers[0])) {
+		memcpy(pool->buffers[pool->deliver_nr], sdu->buffer, sdu->size);
+	}
+	pool->sdus[pool->deliver_nr++] = *sdu;
+}
+
+bool test_decap_callbacks(void)
+{
+	bool is_success = false;
+	size_t i;
+
+	const size_t fpdu_length = 500;
+	unsigned char fpdus[2][500];
+	unsigned char fpdu_copy[500];
+	unsigned char fpdu_in_place[500];
+	size_t fpdu_id = 0;
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = fpdu_length;
+
+	unsigned char buffer_ipv4[100];
+	unsigned char buffer_vlan[100];
+	unsigned char buffer_long[600];
+	/* an IPv4 SDU and a VLAN/IPv4 SDU in COMPLETE PPDUs, then a SDU fragmented over 2 FPDUs */
+	const struct rle_sdu sdus_in[] = {
+		{ .buffer = buffer_ipv4, .size = sizeof(buffer_ipv4), .protocol_type = 0x0800 },
+		{ .buffer = buffer_vlan, .size = sizeof(buffer_vlan), .protocol_type = 0x8100 },
+		{ .buffer = buffer_long, .size = sizeof(buffer_long), .protocol_type = 0x0800 },
+	};
+	const size_t sdus_in_nr = 3;
+
+	static struct decap_cb_pool pool;
+	const struct rle_decap_callbacks callbacks = {
+		.alloc = decap_cb_alloc,
+		.deliver = decap_cb_deliver,
+		.arg = &pool,
+	};
+	const struct rle_decap_callbacks no_deliver = {
+		.alloc = decap_cb_alloc,
+		.deliver = NULL,
+		.arg = &pool,
+	};
+	const struct rle_decap_callbacks in_place = {
+		.alloc = NULL,
+		.deliver = decap_cb_deliver_in_place,
+		.arg = &pool,
+	};
+	size_t sdus_nr;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_receiver *receiver = NULL;
+	struct rle_transmitter *transmitter = NULL;
+
+	PRINT_TEST("Callback decapsulation");
+
+	memcpy(buffer_ipv4, payload_initializer, sizeof(buffer_ipv4));
+	buffer_ipv4[0] = 0x45;
+	memcpy(buffer_vlan, payload_initializer, sizeof(buffer_vlan));
+	buffer_vlan[12] = 0x81;
+	buffer_vlan[13] = 0x00;
+	buffer_vlan[16] = 0x08;
+	buffer_vlan[17] = 0x00;
+	buffer_vlan[18] = 0x45;
+	memcpy(buffer_long, payload_initializer, sizeof(buffer_long));
+	buffer_long[0] = 0x45;
+
+	receiver = rle_receiver_new(&conf);
+	transmitter = rle_transmitter_new(&conf);
+	if (receiver == NULL || transmitter == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	for (i = 0; i < sdus_in_nr; i++) {
+		if (rle_encapsulate(transmitter, &sdus_in[i], i) != RLE_ENCAP_OK) {
+			PRINT_ERROR("Encap does not return OK.");
+			goto out;
+		}
+
+		while (rle_transmitter_stats_get_queue_size(transmitter, i) > 0) {
+			size_t used_size;
+
+			if (rle_fragment_pack(transmitter, i, NULL, 0, fpdus[fpdu_id], &fpdu_cur_pos,
+			                      &fpdu_remain_size, &used_size) != RLE_PACK_OK) {
+				PRINT_ERROR("Fragment and pack does not return OK.");
+				goto out;
+			}
+
+			if (rle_transmitter_stats_get_queue_size(transmitter, i) > 0) {
+				/* the SDU did not fit, go on in the next FPDU */
+				rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+				fpdu_id++;
+				assert(fpdu_id < 2);
+				fpdu_cur_pos = 0;
+				fpdu_remain_size = fpdu_length;
+			}
+		}
+	}
+	rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+
+	/* the VLAN protocol type is rebuilt inside the FPDU, keep it for the second run */
+	memcpy(fpdu_copy, fpdus[0], fpdu_length);
+	memcpy(fpdu_in_place, fpdus[0], fpdu_length);
+
+	/* callbacks are mandatory */
+	if (rle_decapsulate_cb(receiver, fpdus[0], fpdu_length, NULL, &sdus_nr, NULL, 0) !=
+	    RLE_DECAP_ERR_INV_SDUS ||
+	    rle_decapsulate_cb(receiver, fpdus[0], fpdu_length, &no_deliver, &sdus_nr, NULL, 0) !=
+	    RLE_DECAP_ERR_INV_SDUS) {
+		PRINT_ERROR("Decap without callbacks does not return RLE_DECAP_ERR_INV_SDUS.");
+		goto out;
+	}
+
+	memset(&pool, 0, sizeof(pool));
+	pool.alloc_max = sdus_in_nr;
+	for (fpdu_id = 0; fpdu_id < 2; fpdu_id++) {
+		if (rle_decapsulate_cb(receiver, fpdus[fpdu_id], fpdu_length, &callbacks, &sdus_nr,
+		                       NULL, 0) != RLE_DECAP_OK) {
+			PRINT_ERROR("Decap does not return OK.");
+			goto out;
+		}
+		if (sdus_nr != (fpdu_id == 0 ? 2 : 1)) {
+			PRINT_ERROR("%zu SDUs delivered from FPDU #%zu.", sdus_nr, fpdu_id + 1);
+			goto out;
+		}
+	}
+
+	if (pool.deliver_nr != sdus_in_nr) {
+		PRINT_ERROR("%zu SDUs delivered while %zu SDUs encapsulated", pool.deliver_nr,
+		            sdus_in_nr);
+		goto out;
+	}
+	for (i = 0; i < sdus_in_nr; i++) {
+		/* every SDU is copied once in a buffer of the exact SDU size */
+		if (pool.lengths[i] != sdus_in[i].size || pool.sdus[i].buffer != pool.buffers[i] ||
+		    pool.sdus[i].size != sdus_in[i].size ||
+		    pool.sdus[i].protocol_type != sdus_in[i].protocol_type ||
+		    memcmp(pool.sdus[i].buffer, sdus_in[i].buffer, sdus_in[i].size) != 0) {
+			PRINT_ERROR("SDU #%zu wrongly delivered.", i + 1);
+			goto out;
+		}
+	}
+
+	/* the SDUs the allocator refuses are dropped, the other ones still delivered */
+	memset(&pool, 0, sizeof(pool));
+	pool.alloc_max = 1;
+	if (rle_decapsulate_cb(receiver, fpdu_copy, fpdu_length, &callbacks, &sdus_nr, NULL, 0) !=
+	    RLE_DECAP_ERR_SOME_DROP || sdus_nr != 1 || pool.deliver_nr != 1) {
+		PRINT_ERROR("Decap with a refused SDU does not return RLE_DECAP_ERR_SOME_DROP.");
+		goto out;
+	}
+
+	/* without allocator, the SDUs are delivered in the FPDU or in the reassembly storage */
+	rle_receiver_destroy(&receiver);
+	receiver = rle_receiver_new(&conf);
+	if (receiver == NULL) {
+		PRINT_ERROR("Error allocating receiver.");
+		goto out;
+	}
+	memset(&pool, 0, sizeof(pool));
+	if (rle_decapsulate_cb(receiver, fpdu_in_place, fpdu_length, &in_place, &sdus_nr, NULL,
+	                       0) != RLE_DECAP_OK || sdus_nr != 2 ||
+	    rle_decapsulate_cb(receiver, fpdus[1], fpdu_length, &in_place, &sdus_nr, NULL, 0) !=
+	    RLE_DECAP_OK || sdus_nr != 1) {
+		PRINT_ERROR("In-place decap does not return OK.");
+		goto out;
+	}
+	if (pool.deliver_nr != sdus_in_nr) {
+		PRINT_ERROR("%zu SDUs delivered in place while %zu SDUs encapsulated",
+		            pool.deliver_nr, sdus_in_nr);
+		goto out;
+	}
+	for (i = 0; i < sdus_in_nr; i++) {
+		const bool in_fpdu = pool.sdus[i].buffer >= fpdu_in_place &&
+		                     pool.sdus[i].buffer < fpdu_in_place + fpdu_length;
+
+		/* only the SDU fragmented over 2 FPDUs is reassembled out of the FPDU */
+		if (in_fpdu != (i < 2) || pool.sdus[i].size != sdus_in[i].size ||
+		    pool.sdus[i].protocol_type != sdus_in[i].protocol_type ||
+		    memcmp(pool.buffers[i], sdus_in[i].buffer, sdus_in[i].size) != 0) {
+			PRINT_ERROR("SDU #%zu wrongly delivered in place.", i + 1);
+			goto out;
+		}
+	}
+
+	is_success = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+}
+
+bool test_decap_resume(void)
+{
+	bool is_success = false;
+	size_t i;
+
+	const size_t fpdu_length = 500;
+	unsigned char fpdu[500];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = fpdu_length;
+	const unsigned char label[3] = { 0x01, 0x02, 0x03 };
+	unsigned char payload_label[3];
+
+	unsigned char buffers_in[5][60];
+	struct rle_sdu sdus_in[5];
+	const size_t sdus_in_nr = 5;
+
+	unsigned char buffers_out[2][RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[2];
+	size_t sdus_total_nr = 0;
+	struct rle_decap_cursor cursor;
+	enum rle_decap_status status;
+	size_t calls_nr = 0;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_receiver *receiver = NULL;
+	struct rle_transmitter *transmitter = NULL;
+
+	PRINT_TEST("Resumable decapsulation");
+
+	receiver = rle_receiver_new(&conf);
+	transmitter = rle_transmitter_new(&conf);
+	if (receiver == NULL || transmitter == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	/* 5 SDUs in COMPLETE PPDUs of a single FPDU */
+	for (i = 0; i < sdus_in_nr; i++) {
+		size_t used_size;
+
+		memcpy(buffers_in[i], payload_initializer, sizeof(buffers_in[i]));
+		buffers_in[i][0] = 0x45;
+		buffers_in[i][1] = (unsigned char)i;
+		sdus_in[i].buffer = buffers_in[i];
+		sdus_in[i].size = sizeof(buffers_in[i]) - i;
+		sdus_in[i].protocol_type = 0x0800;
+
+		if (rle_encapsulate(transmitter, &sdus_in[i], 0) != RLE_ENCAP_OK) {
+			PRINT_ERROR("Encap does not return OK.");
+			goto out;
+		}
+		if (rle_fragment_pack(transmitter, 0, label, sizeof(label), fpdu, &fpdu_cur_pos,
+		                      &fpdu_remain_size, &used_size) != RLE_PACK_OK ||
+		    rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+			PRINT_ERROR("Fragment and pack does not return OK.");
+			goto out;
+		}
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+
+	/* with 2 SDU buffers, the FPDU is paused twice then done */
+	rle_decap_cursor_init(&cursor, fpdu, fpdu_length);
+	do {
+		size_t sdus_nr = 0;
+
+		for (i = 0; i < 2; i++) {
+			sdus[i].buffer = buffers_out[i];
+		}
+		memset(payload_label, 0, sizeof(payload_label));
+
+		status = rle_decapsulate_resume(receiver, &cursor, sdus, 2, &sdus_nr, payload_label,
+		                                sizeof(payload_label));
+		calls_nr++;
+		if (status != (calls_nr < 3 ? RLE_DECAP_PAUSED : RLE_DECAP_OK)) {
+			PRINT_ERROR("Decap call #%zu returns %d.", calls_nr, status);
+			goto out;
+		}
+		if (memcmp(payload_label, calls_nr == 1 ? label : (const unsigned char *)"\0\0\0",
+		           sizeof(label)) != 0) {
+			PRINT_ERROR("Payload label wrongly given by call #%zu.", calls_nr);
+			goto out;
+		}
+
+		for (i = 0; i < sdus_nr; i++) {
+			const struct rle_sdu *const sdu_in = &sdus_in[sdus_total_nr];
+
+			if (sdus[i].size != sdu_in->size || sdus[i].protocol_type != sdu_in->protocol_type ||
+			    memcmp(sdus[i].buffer, sdu_in->buffer, sdu_in->size) != 0) {
+				PRINT_ERROR("SDU #%zu wrongly decapsulated.", sdus_total_nr + 1);
+				goto out;
+			}
+			sdus_total_nr++;
+		}
+	} while (status == RLE_DECAP_PAUSED);
+
+	if (sdus_total_nr != sdus_in_nr) {
+		PRINT_ERROR("%zu SDUs decapsulated while %zu SDUs encapsulated", sdus_total_nr,
+		            sdus_in_nr);
+		goto out;
+	}
+
+	is_success = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+}
+
+bool test_decap_burst(void)
+{
+	bool is_success = false;
+	size_t i;
+
+#define BURST_TEST_FPDUS  4
+	const size_t fpdu_length = 100;
+	unsigned char fpdus[BURST_TEST_FPDUS][100];
+	size_t fpdu_id = 0;
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = fpdu_length;
+	const unsigned char label[3] = { 0x0a, 0x0b, 0x0c };
+	unsigned char payload_labels[BURST_TEST_FPDUS + 1][3];
+	/* the FPDUs built, then an invalid one */
+	struct rle_decap_burst_fpdu burst[BURST_TEST_FPDUS + 1];
+	size_t burst_nr;
+
+	unsigned char buffers_in[4][150];
+	const size_t sizes_in[] = { 40, 40, 150, 30 };
+	struct rle_sdu sdus_in[4];
+	const size_t sdus_in_nr = 4;
+
+	static unsigned char buffers_out[4][RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[4];
+	size_t sdus_nr = 0;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_receiver *receiver = NULL;
+	struct rle_transmitter *transmitter = NULL;
+
+	PRINT_TEST("Burst decapsulation");
+
+	receiver = rle_receiver_new(&conf);
+	transmitter = rle_transmitter_new(&conf);
+	if (receiver == NULL || transmitter == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	/* 2 SDUs in the first FPDU, then a SDU fragmented over 2 FPDUs, followed by its END */
+	for (i = 0; i < sdus_in_nr; i++) {
+		memcpy(buffers_in[i], payload_initializer, sizes_in[i]);
+		buffers_in[i][0] = 0x45;
+		buffers_in[i][1] = (unsigned char)i;
+		sdus_in[i].buffer = buffers_in[i];
+		sdus_in[i].size = sizes_in[i];
+		sdus_in[i].protocol_type = 0x0800;
+
+		if (rle_encapsulate(transmitter, &sdus_in[i], 0) != RLE_ENCAP_OK) {
+			PRINT_ERROR("Encap does not return OK.");
+			goto out;
+		}
+
+		while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+			size_t used_size;
+			const enum rle_pack_status pack_status =
+				rle_fragment_pack(transmitter, 0, label, sizeof(label), fpdus[fpdu_id],
+				                  &fpdu_cur_pos, &fpdu_remain_size, &used_size);
+
+			if (pack_status != RLE_PACK_OK && pack_status != RLE_PACK_ERR_FPDU_TOO_SMALL) {
+				PRINT_ERROR("Fragment and pack does not return OK.");
+				goto out;
+			}
+
+			if (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+				/* the SDU did not fit, go on in the next FPDU */
+				rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+				fpdu_id++;
+				assert(fpdu_id < BURST_TEST_FPDUS);
+				fpdu_cur_pos = 0;
+				fpdu_remain_size = fpdu_length;
+			}
+		}
+	}
+	rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+	burst_nr = fpdu_id + 1;
+
+	for (i = 0; i <= burst_nr; i++) {
+		burst[i].fpdu = (i < burst_nr ? fpdus[i] : NULL);
+		burst[i].fpdu_length = fpdu_length;
+		burst[i].payload_label = payload_labels[i];
+		burst[i].payload_label_size = sizeof(label);
+	}
+	for (i = 0; i < sdus_in_nr; i++) {
+		sdus[i].buffer = buffers_out[i];
+	}
+
+	if (rle_decapsulate_burst(receiver, burst, burst_nr + 1, sdus, 4, &sdus_nr) != burst_nr) {
+		PRINT_ERROR("Not all the valid FPDUs of the burst decapsulated.");
+		goto out;
+	}
+	if (burst[burst_nr].status != RLE_DECAP_ERR_INV_FPDU) {
+		PRINT_ERROR("Invalid FPDU of the burst not detected.");
+		goto out;
+	}
+
+	if (sdus_nr != sdus_in_nr) {
+		PRINT_ERROR("%zu SDUs decapsulated while %zu SDUs encapsulated", sdus_nr, sdus_in_nr);
+		goto out;
+	}
+	for (i = 0; i < sdus_in_nr; i++) {
+		if (sdus[i].size != sdus_in[i].size || sdus[i].protocol_type != sdus_in[i].protocol_type ||
+		    memcmp(sdus[i].buffer, sdus_in[i].buffer, sdus_in[i].size) != 0) {
+			PRINT_ERROR("SDU #%zu wrongly decapsulated.", i + 1);
+			goto out;
+		}
+	}
+	for (i = 0; i < burst_nr; i++) {
+		if (memcmp(payload_labels[i], label, sizeof(label)) != 0 ||
+		    (i > 0 && burst[i].first_sdu != burst[i - 1].first_sdu + burst[i - 1].sdus_nr)) {
+			PRINT_ERROR("FPDU #%zu of the burst wrongly decapsulated.", i + 1);
+			goto out;
+		}
+	}
+
+	/* once the SDUs array is full, the next SDUs are dropped */
+	if (rle_decapsulate_burst(receiver, burst, burst_nr, sdus, 1, &sdus_nr) != 0 ||
+	    sdus_nr != 1) {
+		PRINT_ERROR("Full SDUs array does not drop the next SDUs of the burst.");
+		goto out;
+	}
+	for (i = 0; i < burst_nr; i++) {
+		if (burst[i].status != RLE_DECAP_ERR_SOME_DROP) {
+			PRINT_ERROR("FPDU #%zu of the burst not dropped.", i + 1);
+			goto out;
+		}
+	}
+
+	/* the checks common to the burst fail every FPDU */
+	if (rle_decapsulate_burst(NULL, burst, burst_nr, sdus, 4, &sdus_nr) != 0 ||
+	    burst[0].status != RLE_DECAP_ERR_NULL_RCVR ||
+	    rle_decapsulate_burst(receiver, burst, burst_nr, NULL, 4, &sdus_nr) != 0 ||
+	    burst[burst_nr - 1].status != RLE_DECAP_ERR_INV_SDUS) {
+		PRINT_ERROR("Invalid burst not detected.");
+		goto out;
+	}
+
+	is_success = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+#undef BURST_TEST_FPDUS
+}
+
+bool test_decap_wrapped(void)
+{
+	bool is_success = false;
+	size_t split;
+	size_t i;
+
+#define WRAPPED_TEST_FPDUS  2
+	const size_t fpdu_length = 200;
+	unsigned char fpdus[WRAPPED_TEST_FPDUS][200];
+	size_t fpdu_id = 0;
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = fpdu_length;
+	const unsigned char label[3] = { 0x0a, 0x0b, 0x0c };
+	unsigned char payload_label[3];
+	unsigned char ring[256];
+
+	unsigned char buffers_in[3][250];
+	const size_t sizes_in[] = { 40, 60, 250 };
+	struct rle_sdu sdus_in[3];
+	const size_t sdus_in_nr = 3;
+
+	static unsigned char buffers_out[3][RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[3];
+	size_t sdus_nr;
+	size_t consumed;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_receiver *receiver = NULL;
+	struct rle_transmitter *transmitter = NULL;
+
+	PRINT_TEST("Wrapped decapsulation");
+
+	receiver = rle_receiver_new(&conf);
+	transmitter = rle_transmitter_new(&conf);
+	if (receiver == NULL || transmitter == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	/* 2 complete SDUs and the START of the last one in the first FPDU, its END in the second */
+	for (i = 0; i < sdus_in_nr; i++) {
+		memcpy(buffers_in[i], payload_initializer, sizes_in[i]);
+		buffers_in[i][0] = 0x45;
+		buffers_in[i][1] = (unsigned char)i;
+		sdus_in[i].buffer = buffers_in[i];
+		sdus_in[i].size = sizes_in[i];
+		sdus_in[i].protocol_type = 0x0800;
+
+		if (rle_encapsulate(transmitter, &sdus_in[i], 0) != RLE_ENCAP_OK) {
+			PRINT_ERROR("Encap does not return OK.");
+			goto out;
+		}
+
+		while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+			size_t used_size;
+			const enum rle_pack_status pack_status =
+				rle_fragment_pack(transmitter, 0, label, sizeof(label), fpdus[fpdu_id],
+				                  &fpdu_cur_pos, &fpdu_remain_size, &used_size);
+
+			if (pack_status != RLE_PACK_OK && pack_status != RLE_PACK_ERR_FPDU_TOO_SMALL) {
+				PRINT_ERROR("Fragment and pack does not return OK.");
+				goto out;
+			}
+
+			if (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+				/* the SDU did not fit, go on in the next FPDU */
+				rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+				fpdu_id++;
+				assert(fpdu_id < WRAPPED_TEST_FPDUS);
+				fpdu_cur_pos = 0;
+				fpdu_remain_size = fpdu_length;
+			}
+		}
+	}
+	rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+	assert(fpdu_id == WRAPPED_TEST_FPDUS - 1);
+
+	for (i = 0; i < sdus_in_nr; i++) {
+		sdus[i].buffer = buffers_out[i];
+	}
+
+	/* every FPDU wraps at every offset: in the label, the PPDU headers and payloads, the padding */
+	for (split = 0; split <= fpdu_length; split++) {
+		sdus_nr = 0;
+		for (i = 0; i < WRAPPED_TEST_FPDUS; i++) {
+			size_t fpdu_sdus_nr = 0;
+
+			memcpy(ring + sizeof(ring) - split, fpdus[i], split);
+			memcpy(ring, fpdus[i] + split, fpdu_length - split);
+
+			if (rle_decapsulate_wrapped(receiver, ring + sizeof(ring) - split, split, ring,
+			                            fpdu_length - split, fpdu_length, &sdus[sdus_nr],
+			                            sdus_in_nr - sdus_nr, &fpdu_sdus_nr, payload_label,
+			                            sizeof(payload_label), &consumed) != RLE_DECAP_OK) {
+				PRINT_ERROR("FPDU #%zu wrapped after %zu bytes not decapsulated.", i + 1,
+				            split);
+				goto out;
+			}
+			if (consumed != fpdu_length ||
+			    memcmp(payload_label, label, sizeof(label)) != 0) {
+				PRINT_ERROR("FPDU #%zu wrapped after %zu bytes wrongly consumed.", i + 1,
+				            split);
+				goto out;
+			}
+			sdus_nr += fpdu_sdus_nr;
+		}
+
+		if (sdus_nr != sdus_in_nr) {
+			PRINT_ERROR("%zu SDUs decapsulated while %zu SDUs encapsulated, wrapped after "
+			            "%zu bytes", sdus_nr, sdus_in_nr, split);
+			goto out;
+		}
+		for (i = 0; i < sdus_in_nr; i++) {
+			if (sdus[i].size != sdus_in[i].size ||
+			    sdus[i].protocol_type != sdus_in[i].protocol_type ||
+			    memcmp(sdus[i].buffer, sdus_in[i].buffer, sdus_in[i].size) != 0) {
+				PRINT_ERROR("SDU #%zu wrongly decapsulated, wrapped after %zu bytes.",
+				            i + 1, split);
+				goto out;
+			}
+		}
+	}
+
+	/* a second segment shorter than the rest of the FPDU is not consumed */
+	if (rle_decapsulate_wrapped(receiver, ring, 10, ring + 10, fpdu_length - 11, fpdu_length,
+	                            sdus, sdus_in_nr, &sdus_nr, payload_label,
+	                            sizeof(payload_label), &consumed) != RLE_DECAP_ERR_INV_FPDU ||
+	    consumed != 0) {
+		PRINT_ERROR("Truncated wrapped FPDU not detected.");
+		goto out;
+	}
+
+	is_success = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+#undef WRAPPED_TEST_FPDUS
+}
+
+bool test_decap_errors(void)
+{
+	bool is_success = false;
+	size_t i;
+
+#define ERRORS_TEST_FPDUS  3
+	const size_t fpdu_length = 100;
+	/* a SDU fragmented over the 2 first FPDUs, then 2 complete SDUs in the last one */
+	unsigned char fpdus[ERRORS_TEST_FPDUS][100];
+	unsigned char wrong_crc[100];
+	size_t fpdu_id = 0;
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = fpdu_length;
+
+	unsigned char buffers_in[3][150];
+	const size_t sizes_in[] = { 150, 30, 30 };
+	struct rle_sdu sdus_in[3];
+	const size_t sdus_in_nr = 3;
+
+	static unsigned char buffers_out[2][RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[2];
+	size_t sdus_nr = 0;
+
+	/* the FPDUs decapsulated in turn, with their rejections */
+	struct {
+		unsigned char *fpdu;
+		size_t fpdu_length;
+		size_t sdus_max_nr;
+		enum rle_rcv_error reason;
+	} steps[] = {
+		{ fpdus[1], fpdu_length, 2, RLE_RCV_ERR_CTX_FREE },
+		{ fpdus[0], fpdu_length, 2, RLE_RCV_ERR_REASONS_NR },
+		{ fpdus[0], fpdu_length, 2, RLE_RCV_ERR_CTX_BUSY },
+		{ fpdus[0], fpdu_length, 2, RLE_RCV_ERR_REASONS_NR },
+		{ wrong_crc, fpdu_length, 2, RLE_RCV_ERR_CRC },
+		{ fpdus[0], 10, 2, RLE_RCV_ERR_PPDU_LEN },
+		{ fpdus[2], fpdu_length, 1, RLE_RCV_ERR_NO_BUFFER },
+	};
+	const size_t steps_nr = sizeof(steps) / sizeof(steps[0]);
+	uint64_t expected[RLE_RCV_ERR_REASONS_NR] = { 0 };
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_receiver *receiver = NULL;
+	struct rle_transmitter *transmitter = NULL;
+
+	PRINT_TEST("Rejection counters");
+
+	receiver = rle_receiver_new(&conf);
+	transmitter = rle_transmitter_new(&conf);
+	if (receiver == NULL || transmitter == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	for (i = 0; i < sdus_in_nr; i++) {
+		memcpy(buffers_in[i], payload_initializer, sizes_in[i]);
+		buffers_in[i][0] = 0x45;
+		sdus_in[i].buffer = buffers_in[i];
+		sdus_in[i].size = sizes_in[i];
+		sdus_in[i].protocol_type = 0x0800;
+
+		if (rle_encapsulate(transmitter, &sdus_in[i], 0) != RLE_ENCAP_OK) {
+			PRINT_ERROR("Encap does not return OK.");
+			goto out;
+		}
+
+		while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+			unsigned char *ppdu;
+			size_t ppdu_length;
+
+			if (rle_fragment(transmitter, 0, fpdu_remain_size, &ppdu, &ppdu_length) !=
+			    RLE_FRAG_OK ||
+			    rle_pack(ppdu, ppdu_length, NULL, 0, fpdus[fpdu_id], &fpdu_cur_pos,
+			             &fpdu_remain_size) != RLE_PACK_OK) {
+				PRINT_ERROR("Frag or pack does not return OK.");
+				goto out;
+			}
+
+			if (i == 0) {
+				/* the START fills the first FPDU, the END is alone in the second */
+				rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+				if (fpdu_id == 1) {
+					memcpy(wrong_crc, fpdus[1], fpdu_length);
+					assert(fpdu_cur_pos >= 4);
+					wrong_crc[fpdu_cur_pos - 1] = ~(wrong_crc[fpdu_cur_pos - 1]);
+				}
+				fpdu_id++;
+				assert(fpdu_id < ERRORS_TEST_FPDUS);
+				fpdu_cur_pos = 0;
+				fpdu_remain_size = fpdu_length;
+			}
+		}
+	}
+	rle_pad(fpdus[fpdu_id], fpdu_cur_pos, fpdu_remain_size);
+	assert(fpdu_id == 2);
+
+	for (i = 0; i < 2; i++) {
+		sdus[i].buffer = buffers_out[i];
+	}
+
+	for (i = 0; i < steps_nr; i++) {
+		const enum rle_decap_status status =
+			rle_decapsulate(receiver, steps[i].fpdu, steps[i].fpdu_length, sdus,
+			                steps[i].sdus_max_nr, &sdus_nr, NULL, 0);
+		size_t reason;
+
+		if (steps[i].reason != RLE_RCV_ERR_REASONS_NR) {
+			expected[steps[i].reason]++;
+		} else if (status != RLE_DECAP_OK) {
+			PRINT_ERROR("FPDU #%zu not decapsulated.", i + 1);
+			goto out;
+		}
+		for (reason = 0; reason < RLE_RCV_ERR_REASONS_NR; reason++) {
+			const uint64_t errors = rle_receiver_stats_get_counter_errors(receiver, reason);
+
+			if (errors != expected[reason]) {
+				PRINT_ERROR("FPDU #%zu: %" PRIu64 " rejections for reason %zu while %"
+				            PRIu64 " expected", i + 1, errors, reason, expected[reason]);
+				goto out;
+			}
+		}
+	}
+
+	if (rle_receiver_stats_get_counter_errors(receiver, RLE_RCV_ERR_REASONS_NR) != 0 ||
+	    rle_receiver_stats_get_counter_errors(NULL, RLE_RCV_ERR_CRC) != 0) {
+		PRINT_ERROR("Invalid rejection counter request not refused.");
+		goto out;
+	}
+
+	rle_receiver_stats_reset_errors(NULL);
+	rle_receiver_stats_reset_errors(receiver);
+	for (i = 0; i < RLE_RCV_ERR_REASONS_NR; i++) {
+		if (rle_receiver_stats_get_counter_errors(receiver, i) != 0) {
+			PRINT_ERROR("Rejection counters not reset.");
+			goto out;
+		}
+	}
+
+	is_success = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+#undef ERRORS_TEST_FPDUS
+}
+
+bool test_decap_validation(void)
+{
+	bool is_success = false;
+	size_t i;
+
+#define VALIDATION_FPDU_LEN  300
+	/* the FPDU holds the START of a SDU, a COMPLETE PPDU, then the END of the first SDU */
+	unsigned char fpdu[VALIDATION_FPDU_LEN];
+	unsigned char fpdu_bad[VALIDATION_FPDU_LEN];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	size_t ppdu_pos[3];
+	size_t ppdu_len[3];
+
+	unsigned char buffers_in[2][100];
+	const size_t sizes_in[] = { 100, 40 };
+	struct rle_sdu sdus_in[2];
+
+	static unsigned char buffers_out[2][RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[2];
+	size_t sdus_nr = 0;
+	size_t consumed;
+	enum rle_decap_status status;
+	rle_ppdu_hdr_start_t *start_hdr;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_receiver *receiver = NULL;
+	struct rle_transmitter *transmitter = NULL;
+
+	PRINT_TEST("FPDU validation");
+
+	receiver = rle_receiver_new(&conf);
+	transmitter = rle_transmitter_new(&conf);
+	if (receiver == NULL || transmitter == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	for (i = 0; i < 2; i++) {
+		memcpy(buffers_in[i], payload_initializer, sizes_in[i]);
+		buffers_in[i][0] = 0x45;
+		sdus_in[i].buffer = buffers_in[i];
+		sdus_in[i].size = sizes_in[i];
+		sdus_in[i].protocol_type = 0x0800;
+		sdus[i].buffer = buffers_out[i];
+	}
+
+	/* the first SDU on fragment id 0 in 2 PPDUs, the second one on fragment id 1 between them */
+	if (rle_encapsulate(transmitter, &sdus_in[0], 0) != RLE_ENCAP_OK ||
+	    rle_encapsulate(transmitter, &sdus_in[1], 1) != RLE_ENCAP_OK) {
+		PRINT_ERROR("Encap does not return OK.");
+		goto out;
+	}
+	for (i = 0; i < 3; i++) {
+		const uint8_t frag_id = (i == 1 ? 1 : 0);
+		unsigned char *ppdu;
+
+		ppdu_pos[i] = fpdu_cur_pos;
+		if (rle_fragment(transmitter, frag_id, (i == 0 ? 60 : fpdu_remain_size), &ppdu,
+		                 &ppdu_len[i]) != RLE_FRAG_OK ||
+		    rle_pack(ppdu, ppdu_len[i], NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+		    RLE_PACK_OK) {
+			PRINT_ERROR("Frag or pack does not return OK.");
+			goto out;
+		}
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+	assert(fpdu_cur_pos + ppdu_len[2] <= sizeof(fpdu));
+
+	rle_receiver_set_fpdu_validation(receiver, 1);
+
+	/* a well-formed FPDU is decapsulated */
+	status = rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus, 2, &sdus_nr, NULL, 0);
+	if (status != RLE_DECAP_OK || sdus_nr != 2) {
+		PRINT_ERROR("Well-formed FPDU not decapsulated.");
+		goto out;
+	}
+
+	/* a FPDU cut in its last PPDU is dropped before its START is copied */
+	status = rle_decapsulate(receiver, fpdu, ppdu_pos[2] + 5, sdus, 2, &sdus_nr, NULL, 0);
+	if (status == RLE_DECAP_OK || sdus_nr != 0 ||
+	    rle_receiver_stats_get_counter_errors(receiver, RLE_RCV_ERR_PPDU_LEN) != 1 ||
+	    rle_receiver_stats_get_counter_sdus_received(receiver, 0) != 1 ||
+	    rle_receiver_stats_get_queue_size(receiver, 0) != 0) {
+		PRINT_ERROR("Cut FPDU not dropped before its parsing.");
+		goto out;
+	}
+
+	/* a START giving more ALPDU bytes than its fragments carry */
+	memcpy(fpdu_bad, fpdu, sizeof(fpdu));
+	start_hdr = (rle_ppdu_hdr_start_t *)&fpdu_bad[ppdu_pos[0]];
+	rle_ppdu_hdr_start_set_total_len(start_hdr, rle_ppdu_hdr_start_get_total_len(start_hdr) + 1);
+	status = rle_decapsulate(receiver, fpdu_bad, sizeof(fpdu), sdus, 2, &sdus_nr, NULL, 0);
+	if (status == RLE_DECAP_OK || sdus_nr != 0 ||
+	    rle_receiver_stats_get_counter_errors(receiver, RLE_RCV_ERR_SDU_TOO_SHORT) != 1) {
+		PRINT_ERROR("FPDU with a wrong ALPDU length not dropped.");
+		goto out;
+	}
+
+	/* a START in place of the END, then an END after the END */
+	memcpy(fpdu_bad, fpdu, sizeof(fpdu));
+	memcpy(&fpdu_bad[ppdu_pos[2]], &fpdu[ppdu_pos[0]], ppdu_len[0]);
+	status = rle_decapsulate(receiver, fpdu_bad, sizeof(fpdu), sdus, 2, &sdus_nr, NULL, 0);
+	if (status == RLE_DECAP_OK || sdus_nr != 0 ||
+	    rle_receiver_stats_get_counter_errors(receiver, RLE_RCV_ERR_CTX_BUSY) != 1) {
+		PRINT_ERROR("FPDU with 2 START PPDUs not dropped.");
+		goto out;
+	}
+	memcpy(fpdu_bad, fpdu, sizeof(fpdu));
+	memcpy(&fpdu_bad[fpdu_cur_pos], &fpdu[ppdu_pos[2]], ppdu_len[2]);
+	status = rle_decapsulate(receiver, fpdu_bad, sizeof(fpdu), sdus, 2, &sdus_nr, NULL, 0);
+	if (status == RLE_DECAP_OK || sdus_nr != 0 ||
+	    rle_receiver_stats_get_counter_errors(receiver, RLE_RCV_ERR_CTX_FREE) != 1 ||
+	    rle_receiver_stats_get_counter_sdus_received(receiver, 0) != 1) {
+		PRINT_ERROR("FPDU with 2 END PPDUs not dropped.");
+		goto out;
+	}
+
+	/* the same FPDU wrapped in the header of its first END, then the well-formed one */
+	status = rle_decapsulate_wrapped(receiver, fpdu_bad, ppdu_pos[2] + 1,
+	                                 fpdu_bad + ppdu_pos[2] + 1, sizeof(fpdu) - ppdu_pos[2] - 1,
+	                                 sizeof(fpdu), sdus, 2, &sdus_nr, NULL, 0, &consumed);
+	if (status == RLE_DECAP_OK || sdus_nr != 0 ||
+	    rle_receiver_stats_get_counter_errors(receiver, RLE_RCV_ERR_CTX_FREE) != 2 ||
+	    rle_receiver_stats_get_counter_sdus_received(receiver, 0) != 1) {
+		PRINT_ERROR("Wrapped FPDU with 2 END PPDUs not dropped.");
+		goto out;
+	}
+	status = rle_decapsulate_wrapped(receiver, fpdu, ppdu_pos[1] + 1, fpdu + ppdu_pos[1] + 1,
+	                                 sizeof(fpdu) - ppdu_pos[1] - 1, sizeof(fpdu), sdus, 2,
+	                                 &sdus_nr, NULL, 0, &consumed);
+	if (status != RLE_DECAP_OK || sdus_nr != 2 ||
+	    rle_receiver_stats_get_counter_sdus_received(receiver, 0) != 2) {
+		PRINT_ERROR("Well-formed wrapped FPDU not decapsulated.");
+		goto out;
+	}
+
+	/* the fragments of a SDU started in a previous FPDU are left to the reassembly */
+	memset(fpdu_bad, 0, sizeof(fpdu));
+	memcpy(fpdu_bad, &fpdu[ppdu_pos[0]], ppdu_len[0]);
+	status = rle_decapsulate(receiver, fpdu_bad, sizeof(fpdu), sdus, 2, &sdus_nr, NULL, 0);
+	if (status != RLE_DECAP_OK || sdus_nr != 0) {
+		PRINT_ERROR("FPDU with a START only not decapsulated.");
+		goto out;
+	}
+	memset(fpdu_bad, 0, sizeof(fpdu));
+	memcpy(fpdu_bad, &fpdu[ppdu_pos[1]], ppdu_len[1] + ppdu_len[2]);
+	status = rle_decapsulate(receiver, fpdu_bad, sizeof(fpdu), sdus, 2, &sdus_nr, NULL, 0);
+	if (status != RLE_DECAP_OK || sdus_nr != 2 || sdus[1].size != sizes_in[0]) {
+		PRINT_ERROR("FPDU ending a SDU of the previous one not decapsulated.");
+		goto out;
+	}
+
+	/* without validation, the PPDUs before the cut are parsed */
+	rle_receiver_set_fpdu_validation(receiver, 0);
+	status = rle_decapsulate(receiver, fpdu, ppdu_pos[2] + 5, sdus, 2, &sdus_nr, NULL, 0);
+	if (status == RLE_DECAP_OK || sdus_nr != 1 ||
+	    rle_receiver_stats_get_queue_size(receiver, 0) == 0) {
+		PRINT_ERROR("Cut FPDU not parsed up to the cut without validation.");
+		goto out;
+	}
+
+	is_success = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+#undef VALIDATION_FPDU_LEN
+}
+
+bool test_decap_index(void)
+{
+	bool is_success = false;
+	size_t i;
+
+#define INDEX_FPDU_LEN  300
+	/* the FPDU holds the START of a SDU, a COMPLETE PPDU, then the END of the first SDU */
+	unsigned char fpdu[INDEX_FPDU_LEN];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	size_t ppdu_pos[3];
+	size_t ppdu_len[3];
+	const enum rle_ppdu_type types[] = {
+		RLE_PPDU_TYPE_START, RLE_PPDU_TYPE_COMPLETE, RLE_PPDU_TYPE_END
+	};
+	const uint8_t frag_ids[] = { 2, 0, 2 };
+	const uint16_t ptypes[] = { 0x0800, 0x86dd, 0 };
+
+	unsigned char buffers_in[2][100];
+	const size_t sizes_in[] = { 100, 40 };
+	struct rle_sdu sdus_in[2];
+
+	struct rle_ppdu_index ppdus[4];
+	size_t ppdus_nr = 0;
+	enum rle_decap_status status;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	const struct rle_config inv_conf = { .implicit_protocol_type = 0x31 };
+	struct rle_transmitter *transmitter = NULL;
+
+	PRINT_TEST("FPDU index");
+
+	transmitter = rle_transmitter_new(&conf);
+	if (transmitter == NULL) {
+		PRINT_ERROR("Error allocating transmitter.");
+		goto out;
+	}
+
+	for (i = 0; i < 2; i++) {
+		memcpy(buffers_in[i], payload_initializer, sizes_in[i]);
+		buffers_in[i][0] = (i == 0 ? 0x45 : 0x60);
+		sdus_in[i].buffer = buffers_in[i];
+		sdus_in[i].size = sizes_in[i];
+		sdus_in[i].protocol_type = ptypes[i];
+	}
+
+	/* the first SDU on fragment id 2 in 2 PPDUs, the second one on fragment id 1 between them */
+	if (rle_encapsulate(transmitter, &sdus_in[0], 2) != RLE_ENCAP_OK ||
+	    rle_encapsulate(transmitter, &sdus_in[1], 1) != RLE_ENCAP_OK) {
+		PRINT_ERROR("Encap does not return OK.");
+		goto out;
+	}
+	for (i = 0; i < 3; i++) {
+		const uint8_t frag_id = (i == 1 ? 1 : 2);
+		unsigned char *ppdu;
+
+		ppdu_pos[i] = fpdu_cur_pos;
+		if (rle_fragment(transmitter, frag_id, (i == 0 ? 60 : fpdu_remain_size), &ppdu,
+		                 &ppdu_len[i]) != RLE_FRAG_OK ||
+		    rle_pack(ppdu, ppdu_len[i], NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+		    RLE_PACK_OK) {
+			PRINT_ERROR("Frag or pack does not return OK.");
+			goto out;
+		}
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+
+	/* the PPDUs are described from their headers */
+	status = rle_fpdu_index(&conf, fpdu, sizeof(fpdu), 0, ppdus, 4, &ppdus_nr);
+	if (status != RLE_DECAP_OK || ppdus_nr != 3) {
+		PRINT_ERROR("FPDU not indexed, status %d, %zu PPDUs.", status, ppdus_nr);
+		goto out;
+	}
+	for (i = 0; i < 3; i++) {
+		if (ppdus[i].offset != ppdu_pos[i] || ppdus[i].ppdu_length != ppdu_len[i] ||
+		    ppdus[i].type != types[i] || ppdus[i].frag_id != frag_ids[i] ||
+		    ppdus[i].protocol_type != ptypes[i]) {
+			PRINT_ERROR("Wrong description of PPDU #%zu.", i);
+			goto out;
+		}
+	}
+	/* the ALPDU of the START is carried by the START and the END */
+	if (ppdus[0].alpdu_total_len != (ppdu_len[0] - 4 + ppdu_len[2] - 2) ||
+	    ppdus[1].alpdu_total_len != 0 || ppdus[2].alpdu_total_len != 0) {
+		PRINT_ERROR("Wrong ALPDU length %zu.", ppdus[0].alpdu_total_len);
+		goto out;
+	}
+
+	/* the descriptions array is filled up */
+	status = rle_fpdu_index(&conf, fpdu, sizeof(fpdu), 0, ppdus, 2, &ppdus_nr);
+	if (status != RLE_DECAP_ERR_SOME_DROP || ppdus_nr != 2) {
+		PRINT_ERROR("Full descriptions array not reported.");
+		goto out;
+	}
+
+	/* a FPDU cut in its last PPDU is described up to the cut */
+	status = rle_fpdu_index(&conf, fpdu, ppdu_pos[2] + 5, 0, ppdus, 4, &ppdus_nr);
+	if (status != RLE_DECAP_ERR_INV_FPDU || ppdus_nr != 2) {
+		PRINT_ERROR("Cut FPDU not reported.");
+		goto out;
+	}
+
+	/* the PPDUs are described whatever the FPDUs before, and after the payload label */
+	status = rle_fpdu_index(&conf, fpdu + ppdu_pos[1], sizeof(fpdu) - ppdu_pos[1], 0, ppdus, 4,
+	                        &ppdus_nr);
+	if (status != RLE_DECAP_OK || ppdus_nr != 2 || ppdus[0].offset != 0 ||
+	    ppdus[1].type != RLE_PPDU_TYPE_END) {
+		PRINT_ERROR("FPDU starting with a COMPLETE PPDU not indexed.");
+		goto out;
+	}
+	status = rle_fpdu_index(&conf, fpdu, sizeof(fpdu), ppdu_pos[1], ppdus, 4, &ppdus_nr);
+	if (status != RLE_DECAP_OK || ppdus_nr != 2 || ppdus[0].offset != ppdu_pos[1]) {
+		PRINT_ERROR("Payload label not skipped.");
+		goto out;
+	}
+
+	if (rle_fpdu_index(&conf, fpdu, sizeof(fpdu), 0, NULL, 4, &ppdus_nr) !=
+	    RLE_DECAP_ERR_INV_SDUS ||
+	    rle_fpdu_index(&conf, fpdu, sizeof(fpdu), 0, ppdus, 0, &ppdus_nr) !=
+	    RLE_DECAP_ERR_INV_SDUS ||
+	    rle_fpdu_index(&conf, fpdu, sizeof(fpdu), 0, ppdus, 4, NULL) !=
+	    RLE_DECAP_ERR_INV_SDUS ||
+	    rle_fpdu_index(&inv_conf, fpdu, sizeof(fpdu), 0, ppdus, 4, &ppdus_nr) !=
+	    RLE_DECAP_ERR ||
+	    rle_fpdu_index(&conf, NULL, sizeof(fpdu), 0, ppdus, 4, &ppdus_nr) !=
+	    RLE_DECAP_ERR_INV_FPDU ||
+	    rle_fpdu_index(&conf, fpdu, 2, 3, ppdus, 4, &ppdus_nr) != RLE_DECAP_ERR_INV_FPDU ||
+	    ppdus_nr != 0) {
+		PRINT_ERROR("Invalid parameters accepted.");
+		goto out;
+	}
+
+	is_success = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+#undef INDEX_FPDU_LEN
+}
+
+/** Consumer of the streamed SDUs of the streaming test */
+struct decap_stream_sink {
+	unsigned char sdu[600];                 /**< The bytes of the SDU in progress          */
+	size_t received;                        /**< The bytes of the SDU in progress received */
+	size_t sdu_size;                        /**< The size given with the bytes             */
+	uint16_t protocol_type;                 /**< The protocol type given with the bytes    */
+	size_t chunks_nr;                       /**< The chunks received                       */
+	bool is_out_of_order;                   /**< Whether a chunk was not in order          */
+	enum rle_stream_verdict verdicts[8];    /**< The verdicts received                     */
+	size_t verdicts_nr;                     /**< The number of verdicts received           */
+};
+
+static void decap_stream_data(void *const arg, const uint8_t frag_id __attribute__((unused)),
+                              const struct rle_stream_chunk *const chunk)
+{
+	struct decap_stream_sink *const sink = (struct decap_stream_sink *)arg;
+
+	if (chunk->offset != sink->received ||
+	    chunk->offset + chunk->length > sizeof(sink->sdu)) {
+		sink->is_out_of_order = true;
+		return;
+	}
+	memcpy(sink->sdu + chunk->offset, chunk->data, chunk->length);
+	sink->received += chunk->length;
+	sink->sdu_size = chunk->sdu_size;
+	sink->protocol_type = chunk->protocol_type;
+	sink->chunks_nr++;
+}
+
+static void decap_stream_end(void *const arg, const uint8_t frag_id __attribute__((unused)),
+                             const enum rle_stream_verdict verdict)
+{
+	struct decap_stream_sink *const sink = (struct decap_stream_sink *)arg;
+
+	if (sink->verdicts_nr < 8) {
+		sink->verdicts[sink->verdicts_nr] = verdict;
+	}
+	sink->verdicts_nr++;
+	/* the next SDU starts from its first byte */
+	sink->received = 0;
+}
+
+/**
+ * @brief         Encapsulate a SDU, and decapsulate its first PPDUs, one FPDU each.
+ *
+ * @param[in,out] transmitter              The transmitter of the SDU.
+ * @param[in,out] receiver                 The receiver of the SDU.
+ * @param[in]     sdu                      The SDU.
+ * @param[in]     frag_id                  The fragment id of the SDU.
+ * @param[in]     ppdus_max_nr             The number of PPDUs decapsulated, the others dropped.
+ * @param[in]     corrupt                  Whether the first SDU byte of the PPDU END is altered.
+ * @param[out]    sdus_nr                  The number of SDUs decapsulated in the sdus array.
+ * @param[out]    status                   The status of the last decapsulation.
+ *
+ * @return        true if OK, else false.
+ */
+static bool decap_stream_sdu(struct rle_transmitter *const transmitter,
+                             struct rle_receiver *const receiver,
+                             const struct rle_sdu *const sdu, const uint8_t frag_id,
+                             const size_t ppdus_max_nr, const bool corrupt,
+                             size_t *const sdus_nr, enum rle_decap_status *const status)
+{
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[1] = { { .buffer = buffer, .size = 0, .protocol_type = 0 } };
+	size_t ppdus_nr = 0;
+
+	*sdus_nr = 0;
+	*status = RLE_DECAP_OK;
+	if (rle_encapsulate(transmitter, sdu, frag_id) != RLE_ENCAP_OK) {
+		PRINT_ERROR("Encap does not return OK.");
+		return false;
+	}
+	while (rle_transmitter_stats_get_queue_size(transmitter, frag_id) != 0) {
+		unsigned char fpdu[80];
+		size_t fpdu_cur_pos = 0;
+		size_t fpdu_remain_size = sizeof(fpdu);
+		unsigned char *ppdu;
+		size_t ppdu_length;
+		size_t fpdu_sdus_nr = 0;
+
+		if (rle_fragment(transmitter, frag_id, 60, &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+		    rle_pack(ppdu, ppdu_length, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+		    RLE_PACK_OK) {
+			PRINT_ERROR("Frag or pack does not return OK.");
+			return false;
+		}
+		rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+		if (corrupt && rle_transmitter_stats_get_queue_size(transmitter, frag_id) == 0) {
+			/* the first SDU byte after the 2-byte header of the PPDU END */
+			fpdu[2] ^= 0xff;
+		}
+		if (ppdus_nr++ >= ppdus_max_nr) {
+			continue;
+		}
+		*status = rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus, 1, &fpdu_sdus_nr, NULL,
+		                          0);
+		*sdus_nr += fpdu_sdus_nr;
+	}
+
+	return true;
+}
+
+bool test_decap_stream(void)
+{
+	bool is_success = false;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	const struct rle_config seqno_conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	unsigned char sdu_buffer[200];
+	const struct rle_sdu sdu = {
+		.buffer = sdu_buffer, .size = sizeof(sdu_buffer), .protocol_type = 0x0800
+	};
+	const struct rle_sdu comp_sdu = {
+		.buffer = sdu_buffer, .size = 40, .protocol_type = 0x0800
+	};
+	struct decap_stream_sink sink;
+	const struct rle_stream_callbacks callbacks = {
+		.data = decap_stream_data, .end = decap_stream_end, .arg = &sink
+	};
+	const struct rle_stream_callbacks inv_callbacks = {
+		.data = decap_stream_data, .end = NULL, .arg = &sink
+	};
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	const uint8_t frag_id = 3;
+	size_t sdus_nr = 0;
+	enum rle_decap_status status;
+
+	PRINT_TEST("Streaming");
+
+	memcpy(sdu_buffer, payload_initializer, sizeof(sdu_buffer));
+	sdu_buffer[0] = 0x45;
+	memset(&sink, 0, sizeof(sink));
+
+	transmitter = rle_transmitter_new(&conf);
+	receiver = rle_receiver_new(&conf);
+	if (transmitter == NULL || receiver == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	if (rle_receiver_set_stream(NULL, &callbacks) == 0 ||
+	    rle_receiver_set_stream(receiver, &inv_callbacks) == 0 ||
+	    rle_receiver_set_stream(receiver, &callbacks) != 0) {
+		PRINT_ERROR("Invalid streaming callbacks accepted, or valid ones refused.");
+		goto out;
+	}
+
+	/* the SDU is given in order, PPDU per PPDU, and not reassembled */
+	if (!decap_stream_sdu(transmitter, receiver, &sdu, frag_id, SIZE_MAX, false, &sdus_nr,
+	                      &status)) {
+		goto out;
+	}
+	if (status != RLE_DECAP_OK || sdus_nr != 0 || sink.is_out_of_order ||
+	    sink.chunks_nr < 3 || sink.verdicts_nr != 1 || sink.verdicts[0] != RLE_STREAM_OK ||
+	    sink.sdu_size != sdu.size || sink.protocol_type != sdu.protocol_type ||
+	    memcmp(sink.sdu, sdu.buffer, sdu.size) != 0) {
+		PRINT_ERROR("SDU not streamed, %zu SDUs, %zu chunks, %zu verdicts.", sdus_nr,
+		            sink.chunks_nr, sink.verdicts_nr);
+		goto out;
+	}
+
+	/* the SDUs of the PPDUs COMPLETE are still decapsulated in the SDUs array */
+	if (!decap_stream_sdu(transmitter, receiver, &comp_sdu, frag_id, SIZE_MAX, false, &sdus_nr,
+	                      &status)) {
+		goto out;
+	}
+	if (status != RLE_DECAP_OK || sdus_nr != 1 || sink.verdicts_nr != 1) {
+		PRINT_ERROR("SDU of PPDU COMPLETE not decapsulated.");
+		goto out;
+	}
+
+	/* the CRC is checked on the bytes streamed */
+	if (!decap_stream_sdu(transmitter, receiver, &sdu, frag_id, SIZE_MAX, true, &sdus_nr,
+	                      &status)) {
+		goto out;
+	}
+	if (status != RLE_DECAP_ERR || sdus_nr != 0 || sink.verdicts_nr != 2 ||
+	    sink.verdicts[1] != RLE_STREAM_ERR_CRC) {
+		PRINT_ERROR("Wrong CRC not given as verdict.");
+		goto out;
+	}
+
+	/* the streaming is not changed with a SDU in progress, given up by a START on its context */
+	if (!decap_stream_sdu(transmitter, receiver, &sdu, frag_id, 1, false, &sdus_nr, &status)) {
+		goto out;
+	}
+	if (status != RLE_DECAP_OK || sink.verdicts_nr != 2 ||
+	    rle_receiver_stats_get_queue_size(receiver, frag_id) == 0 ||
+	    rle_receiver_set_stream(receiver, NULL) == 0) {
+		PRINT_ERROR("Streaming changed with a SDU in progress.");
+		goto out;
+	}
+	if (!decap_stream_sdu(transmitter, receiver, &sdu, frag_id, 1, false, &sdus_nr, &status)) {
+		goto out;
+	}
+	if (status != RLE_DECAP_ERR || sink.verdicts_nr != 3 ||
+	    sink.verdicts[2] != RLE_STREAM_LOST) {
+		PRINT_ERROR("SDU given up by a START not lost.");
+		goto out;
+	}
+
+	/* a SDU in progress on an expired context is lost */
+	rle_receiver_set_ctx_timeout(receiver, 10);
+	if (!decap_stream_sdu(transmitter, receiver, &sdu, frag_id, 1, false, &sdus_nr, &status)) {
+		goto out;
+	}
+	if (rle_receiver_tick(receiver, 20) != 1 || sink.verdicts_nr != 4 ||
+	    sink.verdicts[3] != RLE_STREAM_LOST) {
+		PRINT_ERROR("SDU of an expired context not lost.");
+		goto out;
+	}
+	rle_receiver_set_ctx_timeout(receiver, 0);
+
+	/* a SDU in progress is lost with its receiver */
+	if (!decap_stream_sdu(transmitter, receiver, &sdu, frag_id, 1, false, &sdus_nr, &status)) {
+		goto out;
+	}
+	rle_receiver_destroy(&receiver);
+	rle_transmitter_destroy(&transmitter);
+	if (sink.verdicts_nr != 5 || sink.verdicts[4] != RLE_STREAM_LOST) {
+		PRINT_ERROR("SDU of a destroyed receiver not lost.");
+		goto out;
+	}
+
+	/* the sequence number is checked at the END, a SDU missing on the context */
+	transmitter = rle_transmitter_new(&seqno_conf);
+	receiver = rle_receiver_new(&seqno_conf);
+	if (transmitter == NULL || receiver == NULL ||
+	    rle_receiver_set_stream(receiver, &callbacks) != 0) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+	if (!decap_stream_sdu(transmitter, receiver, &sdu, frag_id, SIZE_MAX, false, &sdus_nr,
+	                      &status) ||
+	    !decap_stream_sdu(transmitter, receiver, &sdu, frag_id, 0, false, &sdus_nr, &status) ||
+	    !decap_stream_sdu(transmitter, receiver, &sdu, frag_id, SIZE_MAX, false, &sdus_nr,
+	                      &status)) {
+		goto out;
+	}
+	if (status != RLE_DECAP_ERR || sink.verdicts_nr != 7 ||
+	    sink.verdicts[5] != RLE_STREAM_OK || sink.verdicts[6] != RLE_STREAM_ERR_SEQNO) {
+		PRINT_ERROR("Wrong sequence number not given as verdict.");
+		goto out;
+	}
+
+	is_success = true;
+
+out:
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	PRINT_TEST_STATUS(is_success);
+	printf("\n");
+	return is_success;
+}
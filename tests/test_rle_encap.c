@@ -39,6 +39,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
 #include <net/ethernet.h>
 
 /**
@@ -537,6 +538,740 @@ bool test_encap_inv_config(void)
 	return output;
 }
 
+bool test_encap_zero_copy(void)
+{
+	PRINT_TEST("Test zero-copy encapsulation. ");
+	bool output = false;
+	const size_t sdu_length = 100;
+	const uint8_t frag_id = 0; /* Arbitrarly */
+	unsigned char memory[RLE_ENCAP_HEADROOM + 100 + RLE_ENCAP_TAILROOM];
+	enum rle_encap_status ret_encap;
+	enum rle_frag_status ret_frag;
+	unsigned char *ppdu = NULL;
+	size_t ppdu_length = 0;
+	struct rle_sdu sdu = {
+		.buffer = memory + RLE_ENCAP_HEADROOM,
+		.size = sdu_length,
+		.protocol_type = 0x0800
+	};
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_transmitter *transmitter;
+
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+
+	memcpy(sdu.buffer, payload_initializer, sdu_length);
+
+	ret_encap = rle_encapsulate_zero_copy(transmitter, &sdu, RLE_ENCAP_HEADROOM - 1,
+	                                      RLE_ENCAP_TAILROOM, frag_id);
+	if (ret_encap != RLE_ENCAP_ERR_NO_ROOM) {
+		PRINT_ERROR("packet encapsulated without enough headroom.");
+		goto exit_label;
+	}
+
+	ret_encap = rle_encapsulate_zero_copy(transmitter, &sdu, RLE_ENCAP_HEADROOM,
+	                                      RLE_ENCAP_TAILROOM, frag_id);
+	if (ret_encap != RLE_ENCAP_OK) {
+		PRINT_ERROR("packet not encapsulated with enough headroom and tailroom.");
+		goto exit_label;
+	}
+
+	/* ALPDU header for an uncompressed protocol type, trailer is pushed on fragmentation */
+	if (rle_transmitter_stats_get_queue_size(transmitter, frag_id) != sdu_length + 2) {
+		PRINT_ERROR("wrong ALPDU length %zu.",
+		            rle_transmitter_stats_get_queue_size(transmitter, frag_id));
+		goto exit_label;
+	}
+
+	/* Fragment in two PPDUs, the first one must point in the caller's memory */
+	ret_frag = rle_fragment(transmitter, frag_id, 60, &ppdu, &ppdu_length);
+	if (ret_frag != RLE_FRAG_OK) {
+		PRINT_ERROR("zero-copy ALPDU not fragmented.");
+		goto exit_label;
+	}
+	if (ppdu < memory || ppdu + ppdu_length > memory + sizeof(memory)) {
+		PRINT_ERROR("PPDU not in the caller's memory.");
+		goto exit_label;
+	}
+	if (memcmp(ppdu + 4 + 2, payload_initializer, ppdu_length - 4 - 2) != 0) {
+		PRINT_ERROR("PPDU does not contain the SDU.");
+		goto exit_label;
+	}
+
+	output = true;
+
+exit_label:
+
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
+bool test_encap_segments(void)
+{
+	PRINT_TEST("Test scatter-gather encapsulation. ");
+	bool output = false;
+	const size_t sdu_length = 100;
+	const uint8_t frag_id = 1; /* Arbitrarly */
+	unsigned char buffer[100];
+	unsigned char ppdu_ref[200];
+	unsigned char *ppdu = NULL;
+	size_t ppdu_ref_length = 0;
+	size_t ppdu_length = 0;
+	struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sdu_length,
+		.protocol_type = RLE_PROTO_TYPE_VLAN_UNCOMP
+	};
+	/* Segments cut the Ethernet header and the VLAN header */
+	const struct rle_sdu_segment segments[] = {
+		{ .buffer = buffer, .size = 7 },
+		{ .buffer = buffer + 7, .size = 9 },
+		{ .buffer = buffer + 16, .size = 0 },
+		{ .buffer = buffer + 16, .size = 84 },
+	};
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_transmitter *transmitter;
+
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+
+	/* Ethernet/VLAN/IPv4 frame, so that the VLAN protocol type is suppressed */
+	memcpy(buffer, payload_initializer, sdu_length);
+	buffer[12] = 0x81;
+	buffer[13] = 0x00;
+	buffer[16] = 0x08;
+	buffer[17] = 0x00;
+	buffer[18] = 0x45;
+
+	if (rle_encapsulate(transmitter, &sdu, frag_id) != RLE_ENCAP_OK ||
+	    rle_fragment(transmitter, frag_id, 60, &ppdu, &ppdu_length) != RLE_FRAG_OK) {
+		PRINT_ERROR("contiguous packet not encapsulated.");
+		goto exit_label;
+	}
+	memcpy(ppdu_ref, ppdu, ppdu_length);
+	ppdu_ref_length = ppdu_length;
+	rle_transmitter_destroy(&transmitter);
+
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+
+	if (rle_encapsulate_segments(transmitter, segments, 4, sdu.protocol_type,
+	                             frag_id) != RLE_ENCAP_OK ||
+	    rle_fragment(transmitter, frag_id, 60, &ppdu, &ppdu_length) != RLE_FRAG_OK) {
+		PRINT_ERROR("packet in segments not encapsulated.");
+		goto exit_label;
+	}
+
+	if (!compare_packets(ppdu_ref, ppdu_ref_length, ppdu, ppdu_length)) {
+		PRINT_ERROR("PPDUs differ for contiguous packet and packet in segments.");
+		goto exit_label;
+	}
+
+	if (rle_transmitter_stats_get_counter_bytes_in(transmitter, frag_id) != sdu_length) {
+		PRINT_ERROR("packet in segments not counted.");
+		goto exit_label;
+	}
+
+	output = true;
+
+exit_label:
+
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
+bool test_encap_batch(void)
+{
+	PRINT_TEST("Test batch encapsulation. ");
+	bool output = false;
+	unsigned char buffer[RLE_MAX_PDU_SIZE + 1];
+	/* SDUs 0 and 1 fit in free contexts, SDU 2 targets a busy context, SDU 3 is too big */
+	const struct rle_sdu sdus[] = {
+		{ .buffer = buffer, .size = 40, .protocol_type = 0x0800 },
+		{ .buffer = buffer + 1, .size = 60, .protocol_type = 0x86dd },
+		{ .buffer = buffer + 2, .size = 80, .protocol_type = 0x0800 },
+		{ .buffer = buffer, .size = RLE_MAX_PDU_SIZE + 1, .protocol_type = 0x0800 },
+	};
+	const uint8_t frag_ids[] = { 3, 5, 3, 6 };
+	const enum rle_encap_status expected_statuses[] = {
+		RLE_ENCAP_OK,
+		RLE_ENCAP_OK,
+		RLE_ENCAP_ERR,
+		RLE_ENCAP_ERR_SDU_TOO_BIG
+	};
+	const size_t sdus_nr = 4;
+	enum rle_encap_status statuses[4];
+	size_t i;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_transmitter *transmitter_ref = NULL;
+
+	memset(buffer, 0, sizeof(buffer));
+	memcpy(buffer, payload_initializer, 100);
+
+	if (rle_encapsulate_batch(NULL, sdus, frag_ids, sdus_nr, statuses) != 0 ||
+	    statuses[0] != RLE_ENCAP_ERR_NULL_TRMT || statuses[3] != RLE_ENCAP_ERR_NULL_TRMT) {
+		PRINT_ERROR("null transmitter not raised for each SDU.");
+		goto exit_label;
+	}
+
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+	transmitter_ref = rle_transmitter_new(&conf);
+	assert(transmitter_ref != NULL);
+
+	if (rle_encapsulate_batch(transmitter, sdus, frag_ids, sdus_nr, statuses) != 2) {
+		PRINT_ERROR("unexpected number of SDUs encapsulated.");
+		goto exit_label;
+	}
+
+	for (i = 0; i < sdus_nr; i++) {
+		if (statuses[i] != expected_statuses[i]) {
+			PRINT_ERROR("SDU %zu: status %d, expected %d.", i, statuses[i],
+			            expected_statuses[i]);
+			goto exit_label;
+		}
+	}
+
+	/* the batch shall build the same ALPDUs as one call per SDU */
+	for (i = 0; i < 2; i++) {
+		unsigned char ppdu_ref[200];
+		size_t ppdu_ref_length;
+		unsigned char *ppdu = NULL;
+		size_t ppdu_length = 0;
+
+		if (rle_encapsulate(transmitter_ref, &sdus[i], frag_ids[i]) != RLE_ENCAP_OK ||
+		    rle_fragment(transmitter_ref, frag_ids[i], 200, &ppdu, &ppdu_length) != RLE_FRAG_OK) {
+			PRINT_ERROR("reference SDU %zu not encapsulated.", i);
+			goto exit_label;
+		}
+		memcpy(ppdu_ref, ppdu, ppdu_length);
+		ppdu_ref_length = ppdu_length;
+
+		if (rle_fragment(transmitter, frag_ids[i], 200, &ppdu, &ppdu_length) != RLE_FRAG_OK) {
+			PRINT_ERROR("SDU %zu of the batch not fragmented.", i);
+			goto exit_label;
+		}
+
+		if (!compare_packets(ppdu_ref, ppdu_ref_length, ppdu, ppdu_length)) {
+			PRINT_ERROR("PPDUs differ for SDU %zu.", i);
+			goto exit_label;
+		}
+	}
+
+	if (rle_transmitter_stats_get_counter_sdus_in(transmitter, frag_ids[0]) != 1 ||
+	    rle_transmitter_stats_get_counter_bytes_in(transmitter, frag_ids[1]) != sdus[1].size) {
+		PRINT_ERROR("batch not counted.");
+		goto exit_label;
+	}
+
+	output = true;
+
+exit_label:
+
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (transmitter_ref != NULL) {
+		rle_transmitter_destroy(&transmitter_ref);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
+bool test_encap_queue(void)
+{
+	PRINT_TEST("Test SDU queue of a context. ");
+	bool output = false;
+	unsigned char buffers[4][100];
+	struct rle_sdu sdus[4];
+	const size_t sdus_nr = 4;
+	const uint8_t frag_id = 2;
+	const size_t depth = 2;
+	unsigned char fpdu[1000];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	struct rle_sdu sdus_out[4];
+	unsigned char buffers_out[4][RLE_MAX_PDU_SIZE];
+	size_t sdus_out_nr = 0;
+	size_t i;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+
+	for (i = 0; i < sdus_nr; i++) {
+		memcpy(buffers[i], payload_initializer, sizeof(buffers[i]));
+		buffers[i][0] = 0x45;
+		buffers[i][1] = (unsigned char)i;
+		sdus[i].buffer = buffers[i];
+		sdus[i].size = sizeof(buffers[i]) - 10 * i;
+		sdus[i].protocol_type = 0x0800;
+		sdus_out[i].buffer = buffers_out[i];
+	}
+
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+	receiver = rle_receiver_new(&conf);
+	assert(receiver != NULL);
+
+	if (rle_transmitter_set_queue_depth(NULL, frag_id, depth) != 1 ||
+	    rle_transmitter_set_queue_depth(transmitter, RLE_MAX_FRAG_NUMBER, depth) != 1 ||
+	    rle_transmitter_set_queue_depth(transmitter, frag_id, depth) != 0) {
+		PRINT_ERROR("queue depth wrongly set.");
+		goto exit_label;
+	}
+
+	/* the current SDU and the 2 queued ones are accepted, not the next one */
+	for (i = 0; i < sdus_nr; i++) {
+		const enum rle_encap_status expected = (i <= depth ? RLE_ENCAP_OK : RLE_ENCAP_ERR);
+
+		if (rle_encapsulate(transmitter, &sdus[i], frag_id) != expected) {
+			PRINT_ERROR("SDU %zu: unexpected encapsulation status.", i);
+			goto exit_label;
+		}
+	}
+	if (rle_transmitter_stats_get_queued_sdus(transmitter, frag_id) != depth ||
+	    rle_transmitter_stats_get_queue_size(transmitter, frag_id) <
+	    sdus[0].size + sdus[1].size + sdus[2].size) {
+		PRINT_ERROR("queued SDUs not counted.");
+		goto exit_label;
+	}
+	if (rle_transmitter_set_queue_depth(transmitter, frag_id, 0) != 1) {
+		PRINT_ERROR("queue depth changed while SDUs are queued.");
+		goto exit_label;
+	}
+
+	/* all the accepted SDUs are sent in order, without encapsulating them again */
+	while (rle_transmitter_stats_get_queue_size(transmitter, frag_id) > 0) {
+		size_t used_size;
+
+		if (rle_fragment_pack(transmitter, frag_id, NULL, 0, fpdu, &fpdu_cur_pos,
+		                      &fpdu_remain_size, &used_size) != RLE_PACK_OK) {
+			PRINT_ERROR("fragment and pack does not return OK.");
+			goto exit_label;
+		}
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+
+	if (rle_transmitter_stats_get_queued_sdus(transmitter, frag_id) != 0 ||
+	    rle_transmitter_stats_get_counter_sdus_sent(transmitter, frag_id) != depth + 1) {
+		PRINT_ERROR("queued SDUs not sent.");
+		goto exit_label;
+	}
+
+	if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus_out, 4, &sdus_out_nr, NULL, 0) !=
+	    RLE_DECAP_OK || sdus_out_nr != depth + 1) {
+		PRINT_ERROR("queued SDUs not decapsulated.");
+		goto exit_label;
+	}
+	for (i = 0; i < sdus_out_nr; i++) {
+		if (sdus_out[i].size != sdus[i].size ||
+		    memcmp(sdus_out[i].buffer, sdus[i].buffer, sdus[i].size) != 0) {
+			PRINT_ERROR("SDU %zu wrongly sent.", i);
+			goto exit_label;
+		}
+	}
+
+	/* once drained, the context is free again and its queue can be removed */
+	if (rle_encapsulate(transmitter, &sdus[3], frag_id) != RLE_ENCAP_OK) {
+		PRINT_ERROR("context not freed once its queue is drained.");
+		goto exit_label;
+	}
+	if (rle_transmitter_set_queue_depth(transmitter, frag_id, 0) != 0) {
+		PRINT_ERROR("queue not removed.");
+		goto exit_label;
+	}
+
+	output = true;
+
+exit_label:
+
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
+/** The number of SDUs sent through the transmitter pipe by the pipe test */
+#define PIPE_TEST_SDUS_NR  300
+
+/** The encapsulation stage of the pipe test */
+struct pipe_test_producer {
+	struct rle_tx_pipe *pipe;         /**< The pipe to the fragmentation stage     */
+	const struct rle_sdu *sdus;       /**< The SDUs to encapsulate                 */
+	size_t sdus_nr;                   /**< The number of SDUs                      */
+	bool is_success;                  /**< Whether all the SDUs were encapsulated  */
+};
+
+/**
+ * @brief         Encapsulate the SDUs of the pipe test in the pipe, waiting when it is full.
+ *
+ * @param[in,out] arg                      The encapsulation stage.
+ *
+ * @return        NULL.
+ */
+static void * pipe_test_produce(void *arg)
+{
+	struct pipe_test_producer *const producer = arg;
+	size_t i;
+
+	producer->is_success = true;
+	for (i = 0; i < producer->sdus_nr; i++) {
+		enum rle_encap_status status;
+
+		do {
+			status = rle_tx_pipe_encapsulate(producer->pipe, &producer->sdus[i], 0);
+		} while (status == RLE_ENCAP_ERR_PIPE_FULL);
+
+		if (status != RLE_ENCAP_OK) {
+			producer->is_success = false;
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+bool test_encap_pipe(void)
+{
+	PRINT_TEST("Test transmitter pipe. ");
+	bool output = false;
+	static unsigned char buffers[PIPE_TEST_SDUS_NR][700];
+	static struct rle_sdu sdus[PIPE_TEST_SDUS_NR];
+	struct pipe_test_producer producer;
+	pthread_t producer_thread;
+	bool producer_started = false;
+	unsigned char fpdu[1000];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	struct rle_sdu sdus_out[PIPE_TEST_SDUS_NR];
+	static unsigned char buffers_out[PIPE_TEST_SDUS_NR][RLE_MAX_PDU_SIZE];
+	size_t sdus_out_nr = 0;
+	size_t i;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	struct rle_tx_pipe *pipe = NULL;
+
+	for (i = 0; i < PIPE_TEST_SDUS_NR; i++) {
+		memcpy(buffers[i], payload_initializer, sizeof(buffers[i]));
+		buffers[i][0] = 0x45;
+		buffers[i][1] = (unsigned char)i;
+		sdus[i].buffer = buffers[i];
+		sdus[i].size = 20 + (i * 37) % (sizeof(buffers[i]) - 20);
+		sdus[i].protocol_type = 0x0800;
+		sdus_out[i].buffer = buffers_out[i];
+	}
+
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+	receiver = rle_receiver_new(&conf);
+	assert(receiver != NULL);
+
+	if (rle_tx_pipe_new(NULL, 4) != NULL || rle_tx_pipe_new(transmitter, 3) != NULL ||
+	    rle_tx_pipe_new(transmitter, RLE_TX_PIPE_MAX_DEPTH * 2) != NULL) {
+		PRINT_ERROR("invalid pipe created.");
+		goto exit_label;
+	}
+	pipe = rle_tx_pipe_new(transmitter, 4);
+	if (pipe == NULL || rle_transmitter_set_queue_depth(transmitter, 0, 2) != 0) {
+		PRINT_ERROR("pipe not created.");
+		goto exit_label;
+	}
+
+	/* the pipe holds its depth of ALPDUs, then refuses the next SDU without dropping it */
+	for (i = 0; i < 4; i++) {
+		if (rle_tx_pipe_encapsulate(pipe, &sdus[i], 0) != RLE_ENCAP_OK) {
+			PRINT_ERROR("SDU %zu not encapsulated in the pipe.", i);
+			goto exit_label;
+		}
+	}
+	if (rle_tx_pipe_encapsulate(pipe, &sdus[4], 0) != RLE_ENCAP_ERR_PIPE_FULL ||
+	    rle_tx_pipe_encapsulate(pipe, &sdus[4], RLE_MAX_FRAG_NUMBER) != RLE_ENCAP_ERR ||
+	    rle_tx_pipe_get_size(pipe) != 4) {
+		PRINT_ERROR("full pipe not detected.");
+		goto exit_label;
+	}
+
+	/* the context and its queue take 3 ALPDUs, the last one waits in the pipe */
+	if (rle_tx_pipe_dispatch(pipe) != 3 || rle_tx_pipe_get_size(pipe) != 1 ||
+	    rle_transmitter_stats_get_queued_sdus(transmitter, 0) != 2) {
+		PRINT_ERROR("ALPDUs wrongly dispatched.");
+		goto exit_label;
+	}
+
+	/* the rest of the SDUs are encapsulated on another thread while the ALPDUs are sent */
+	producer.pipe = pipe;
+	producer.sdus = &sdus[4];
+	producer.sdus_nr = PIPE_TEST_SDUS_NR - 4;
+	producer.is_success = false;
+	if (pthread_create(&producer_thread, NULL, pipe_test_produce, &producer) != 0) {
+		PRINT_ERROR("encapsulation stage not started.");
+		goto exit_label;
+	}
+	producer_started = true;
+
+	while (sdus_out_nr < PIPE_TEST_SDUS_NR) {
+		size_t used_size;
+		size_t fpdu_sdus_nr = 0;
+
+		(void)rle_tx_pipe_dispatch(pipe);
+
+		if (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+			const enum rle_pack_status pack_status =
+				rle_fragment_pack(transmitter, 0, NULL, 0, fpdu, &fpdu_cur_pos,
+				                  &fpdu_remain_size, &used_size);
+
+			if (pack_status == RLE_PACK_OK) {
+				continue;
+			}
+			if (pack_status != RLE_PACK_ERR_FPDU_TOO_SMALL) {
+				PRINT_ERROR("fragment and pack does not return OK.");
+				goto exit_label;
+			}
+		} else if (fpdu_cur_pos == 0) {
+			continue;
+		}
+
+		/* the FPDU is sent once full, or once there is nothing to send */
+		rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+		if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), &sdus_out[sdus_out_nr],
+		                    PIPE_TEST_SDUS_NR - sdus_out_nr, &fpdu_sdus_nr, NULL, 0) !=
+		    RLE_DECAP_OK) {
+			PRINT_ERROR("FPDU not decapsulated.");
+			goto exit_label;
+		}
+		sdus_out_nr += fpdu_sdus_nr;
+		fpdu_cur_pos = 0;
+		fpdu_remain_size = sizeof(fpdu);
+	}
+
+	pthread_join(producer_thread, NULL);
+	producer_started = false;
+	if (!producer.is_success || rle_tx_pipe_get_size(pipe) != 0 ||
+	    rle_transmitter_stats_get_counter_sdus_in(transmitter, 0) != PIPE_TEST_SDUS_NR) {
+		PRINT_ERROR("SDUs not all encapsulated through the pipe.");
+		goto exit_label;
+	}
+	for (i = 0; i < PIPE_TEST_SDUS_NR; i++) {
+		if (sdus_out[i].size != sdus[i].size ||
+		    memcmp(sdus_out[i].buffer, sdus[i].buffer, sdus[i].size) != 0) {
+			PRINT_ERROR("SDU %zu wrongly sent.", i);
+			goto exit_label;
+		}
+	}
+
+	output = true;
+
+exit_label:
+
+	if (producer_started) {
+		pthread_join(producer_thread, NULL);
+	}
+	if (pipe != NULL) {
+		rle_tx_pipe_destroy(&pipe);
+	}
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
+bool test_encap_compact_contexts(void)
+{
+	PRINT_TEST("Test compact contexts. ");
+	bool output = false;
+	unsigned char buffers[3][1500];
+	struct rle_sdu sdus[3];
+	const size_t sdus_sizes[3] = { 40, 1500, 600 };
+	const size_t sdus_nr = 3;
+	const uint8_t frag_id = 0;
+	unsigned char fpdu[4000];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	struct rle_sdu sdus_out[3];
+	unsigned char buffers_out[3][RLE_MAX_PDU_SIZE];
+	size_t sdus_out_nr = 0;
+	size_t i;
+
+	struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+		.fragment_contexts_nr = RLE_MAX_FRAG_NUMBER + 1,
+	};
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+
+	for (i = 0; i < sdus_nr; i++) {
+		memcpy(buffers[i], payload_initializer, sizeof(buffers[i]));
+		buffers[i][0] = 0x45;
+		buffers[i][1] = (unsigned char)i;
+		sdus[i].buffer = buffers[i];
+		sdus[i].size = sdus_sizes[i];
+		sdus[i].protocol_type = 0x0800;
+		sdus_out[i].buffer = buffers_out[i];
+	}
+
+	transmitter = rle_transmitter_new(&conf);
+	if (transmitter != NULL) {
+		PRINT_ERROR("transmitter created with more contexts than the protocol allows.");
+		goto exit_label;
+	}
+
+	conf.fragment_contexts_nr = 1;
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+	receiver = rle_receiver_new(&conf);
+	assert(receiver != NULL);
+
+	if (rle_encapsulate(transmitter, &sdus[0], frag_id + 1) != RLE_ENCAP_ERR ||
+	    rle_transmitter_set_queue_depth(transmitter, frag_id + 1, 1) != 1 ||
+	    rle_transmitter_set_traffic_class(transmitter, 0, 0x03, 1) != 1) {
+		PRINT_ERROR("context that does not exist accepted.");
+		goto exit_label;
+	}
+
+	/* a small SDU, then a larger one that does not fit in the buffer of the first */
+	for (i = 0; i < 2; i++) {
+		size_t used_size;
+
+		if (rle_encapsulate(transmitter, &sdus[i], frag_id) != RLE_ENCAP_OK ||
+		    rle_fragment_pack(transmitter, frag_id, NULL, 0, fpdu, &fpdu_cur_pos,
+		                      &fpdu_remain_size, &used_size) != RLE_PACK_OK) {
+			PRINT_ERROR("SDU %zu not sent.", i);
+			goto exit_label;
+		}
+	}
+
+	/* the SDU queued behind a busy context gets its own buffer too */
+	if (rle_transmitter_set_queue_depth(transmitter, frag_id, 1) != 0 ||
+	    rle_encapsulate(transmitter, &sdus[0], frag_id) != RLE_ENCAP_OK ||
+	    rle_encapsulate(transmitter, &sdus[2], frag_id) != RLE_ENCAP_OK) {
+		PRINT_ERROR("SDU not queued.");
+		goto exit_label;
+	}
+	rle_transmitter_destroy(&transmitter);
+	if (transmitter != NULL) {
+		PRINT_ERROR("transmitter with a queued SDU not destroyed.");
+		goto exit_label;
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+
+	if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus_out, sdus_nr, &sdus_out_nr, NULL,
+	                    0) != RLE_DECAP_OK || sdus_out_nr != 2) {
+		PRINT_ERROR("SDUs not decapsulated.");
+		goto exit_label;
+	}
+	for (i = 0; i < sdus_out_nr; i++) {
+		if (sdus_out[i].size != sdus[i].size ||
+		    memcmp(sdus_out[i].buffer, sdus[i].buffer, sdus[i].size) != 0) {
+			PRINT_ERROR("SDU %zu wrongly sent.", i);
+			goto exit_label;
+		}
+	}
+
+	output = true;
+
+exit_label:
+
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
 bool test_encap_all(void)
 {
 	PRINT_TEST("Test the general cases of encapsulation.");
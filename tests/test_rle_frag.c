@@ -457,6 +457,361 @@ exit_label:
 	return output;
 }
 
+bool test_frag_traffic_classes(void)
+{
+	PRINT_TEST("Traffic classes");
+	bool output = false;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	unsigned char buffer[100];
+	const struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = 0x0800
+	};
+	/* the voice class 0 in strict priority, then 2 weighted classes */
+	const uint8_t classes[] = { 1, 1, 1, 2, 0 };
+	const uint8_t expected_frag_ids[] = { 1, 2, 3, 4, 0 };
+	/* after the voice SDU, the weighted classes share the link 2 PPDUs to 1 */
+	const uint8_t expected_wrr_frag_ids[] = { 1, 2, 4, 3, 1, 4 };
+	const size_t burst_size = 30;
+	size_t ppdus_nr = 0;
+	size_t voice_ppdus_nr = 0;
+	bool voice_done = false;
+	enum rle_frag_status status;
+	unsigned char *ppdu;
+	size_t ppdu_length;
+	uint8_t frag_id;
+	size_t i;
+
+	struct rle_transmitter *transmitter = NULL;
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+
+	if (rle_transmitter_set_traffic_class(transmitter, RLE_TRAFFIC_CLASSES_NR, 0x01, 0) != 1 ||
+	    rle_transmitter_set_traffic_class(transmitter, 1, 0x0e, 2) != 0 ||
+	    rle_transmitter_set_traffic_class(transmitter, 2, 0xf0, 1) != 0) {
+		PRINT_ERROR("traffic classes wrongly set.");
+		goto exit_label;
+	}
+
+	/* the first free context of the class is chosen */
+	for (i = 0; i < sizeof(classes); i++) {
+		if (rle_encapsulate_auto(transmitter, &sdu, classes[i], &frag_id) != RLE_ENCAP_OK ||
+		    frag_id != expected_frag_ids[i]) {
+			PRINT_ERROR("SDU %zu not encapsulated in context %u.", i, expected_frag_ids[i]);
+			goto exit_label;
+		}
+	}
+	if (rle_encapsulate_auto(transmitter, &sdu, 1, &frag_id) != RLE_ENCAP_ERR ||
+	    rle_encapsulate_auto(transmitter, &sdu, RLE_TRAFFIC_CLASSES_NR, &frag_id) != RLE_ENCAP_ERR) {
+		PRINT_ERROR("SDU encapsulated in a full or unknown class.");
+		goto exit_label;
+	}
+
+	/* the voice SDU is sent first, then the other ones in weighted round robin */
+	while ((status = rle_fragment_next(transmitter, burst_size, &ppdu, &ppdu_length,
+	                                   &frag_id)) == RLE_FRAG_OK) {
+		if (frag_id == 0) {
+			if (voice_done) {
+				PRINT_ERROR("voice PPDU sent after other ones.");
+				goto exit_label;
+			}
+			voice_ppdus_nr++;
+		} else {
+			voice_done = true;
+			if ((ppdus_nr - voice_ppdus_nr) < sizeof(expected_wrr_frag_ids) &&
+			    frag_id != expected_wrr_frag_ids[ppdus_nr - voice_ppdus_nr]) {
+				PRINT_ERROR("PPDU %zu from context %u instead of %u.", ppdus_nr, frag_id,
+				            expected_wrr_frag_ids[ppdus_nr - voice_ppdus_nr]);
+				goto exit_label;
+			}
+		}
+		ppdus_nr++;
+	}
+
+	if (status != RLE_FRAG_ERR_CONTEXT_IS_NULL || voice_ppdus_nr == 0) {
+		PRINT_ERROR("not all the SDUs sent.");
+		goto exit_label;
+	}
+	for (i = 0; i < sizeof(classes); i++) {
+		if (rle_transmitter_stats_get_counter_sdus_sent(transmitter, expected_frag_ids[i]) != 1) {
+			PRINT_ERROR("SDU %zu not sent.", i);
+			goto exit_label;
+		}
+	}
+
+	output = true;
+
+exit_label:
+
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
+bool test_frag_backlog(void)
+{
+	PRINT_TEST("Backlog");
+	bool output = false;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	unsigned char buffer[200];
+	/* the SDUs and their contexts, their ALPDUs have a 2-byte header */
+	const size_t sdu_sizes[] = { 100, 200, 50 };
+	const uint8_t frag_ids[] = { 0, 0, 1 };
+	struct rle_transmitter_backlog backlog;
+	struct rle_transmitter_backlog class_backlog;
+	unsigned char *ppdu;
+	size_t ppdu_length;
+	size_t i;
+
+	struct rle_transmitter *transmitter = NULL;
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+
+	if (rle_transmitter_set_queue_depth(transmitter, 0, 1) != 0 ||
+	    rle_transmitter_set_traffic_class(transmitter, 1, 0x02, 0) != 0) {
+		PRINT_ERROR("queue or traffic class wrongly set.");
+		goto exit_label;
+	}
+	for (i = 0; i < sizeof(frag_ids); i++) {
+		const struct rle_sdu sdu = {
+			.buffer = buffer,
+			.size = sdu_sizes[i],
+			.protocol_type = 0x0800
+		};
+
+		if (rle_encapsulate(transmitter, &sdu, frag_ids[i]) != RLE_ENCAP_OK) {
+			PRINT_ERROR("SDU %zu not encapsulated.", i);
+			goto exit_label;
+		}
+	}
+
+	/* the queued SDU is counted, and the PPDUs estimated for both burst sizes */
+	if (rle_transmitter_stats_get_backlog(transmitter, RLE_TRAFFIC_CLASSES_NR, 1000,
+	                                      &backlog) != 0 ||
+	    backlog.alpdu_bytes != 356 || backlog.alpdus_nr != 3 || backlog.ppdus_nr != 3 ||
+	    backlog.ppdu_bytes != 362) {
+		PRINT_ERROR("wrong backlog of the transmitter in 1000-byte bursts.");
+		goto exit_label;
+	}
+	if (rle_transmitter_stats_get_backlog(transmitter, RLE_TRAFFIC_CLASSES_NR, 60,
+	                                      &backlog) != 0 ||
+	    backlog.ppdus_nr != 9 || backlog.ppdu_bytes != 383) {
+		PRINT_ERROR("wrong backlog of the transmitter in 60-byte bursts.");
+		goto exit_label;
+	}
+	if (rle_transmitter_stats_get_backlog(transmitter, 0, 1000, &class_backlog) != 0 ||
+	    class_backlog.alpdu_bytes != 304 || class_backlog.alpdus_nr != 2 ||
+	    rle_transmitter_stats_get_backlog(transmitter, 1, 1000, &class_backlog) != 0 ||
+	    class_backlog.alpdu_bytes != 52 || class_backlog.alpdus_nr != 1) {
+		PRINT_ERROR("wrong backlog of the traffic classes.");
+		goto exit_label;
+	}
+
+	/* the backlog follows the PPDUs of the context, its trailer included once fragmented */
+	while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+		if (rle_fragment(transmitter, 0, 60, &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+		    rle_transmitter_stats_get_backlog(transmitter, 0, 60, &class_backlog) != 0 ||
+		    class_backlog.alpdu_bytes != rle_transmitter_stats_get_queue_size(transmitter, 0)) {
+			PRINT_ERROR("backlog of the class not following the context.");
+			goto exit_label;
+		}
+	}
+	if (class_backlog.alpdus_nr != 0) {
+		PRINT_ERROR("ALPDUs left in the backlog of the class.");
+		goto exit_label;
+	}
+
+	/* the ALPDUs of a context move with it to another class */
+	if (rle_transmitter_set_traffic_class(transmitter, 2, 0x02, 0) != 0 ||
+	    rle_transmitter_stats_get_backlog(transmitter, 1, 1000, &class_backlog) != 0 ||
+	    class_backlog.alpdu_bytes != 0 || class_backlog.alpdus_nr != 0 ||
+	    rle_transmitter_stats_get_backlog(transmitter, 2, 1000, &class_backlog) != 0 ||
+	    class_backlog.alpdu_bytes != 52 || class_backlog.alpdus_nr != 1) {
+		PRINT_ERROR("backlog not moved with its context.");
+		goto exit_label;
+	}
+	if (rle_fragment(transmitter, 1, 1000, &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+	    rle_transmitter_stats_get_backlog(transmitter, RLE_TRAFFIC_CLASSES_NR, 1000,
+	                                      &backlog) != 0 ||
+	    backlog.alpdu_bytes != 0 || backlog.alpdus_nr != 0 || backlog.ppdu_bytes != 0) {
+		PRINT_ERROR("backlog of the transmitter not empty once all the SDUs are sent.");
+		goto exit_label;
+	}
+
+	/* the invalid requests are refused */
+	if (rle_transmitter_stats_get_backlog(NULL, 0, 1000, &backlog) != 1 ||
+	    rle_transmitter_stats_get_backlog(transmitter, RLE_TRAFFIC_CLASSES_NR + 1, 1000,
+	                                      &backlog) != 1 ||
+	    rle_transmitter_stats_get_backlog(transmitter, 0, 4, &backlog) != 1 ||
+	    rle_transmitter_stats_get_backlog(transmitter, 0, 1000, NULL) != 1) {
+		PRINT_ERROR("invalid backlog request accepted.");
+		goto exit_label;
+	}
+
+	output = true;
+
+exit_label:
+
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
+bool test_frag_bursts(void)
+{
+	PRINT_TEST("Bursts");
+	bool output = false;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	unsigned char buffer[500];
+	const struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = 0x0800
+	};
+	/* a START, 2 CONT and an END, the last burst being larger than needed */
+	const size_t burst_sizes[] = { 100, 150, 150, 200 };
+	const size_t too_small_sizes[] = { 100, 2, 150 };
+	unsigned char burst_buffers[4][200];
+	unsigned char *const bursts[] = {
+		burst_buffers[0], burst_buffers[1], burst_buffers[2], burst_buffers[3]
+	};
+	struct rle_ppdu_desc ppdus[4];
+	size_t ppdus_nr;
+	size_t i;
+
+	struct rle_transmitter *reference = NULL;
+	struct rle_transmitter *transmitter = NULL;
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+
+	reference = rle_transmitter_new(&conf);
+	transmitter = rle_transmitter_new(&conf);
+	assert(reference != NULL && transmitter != NULL);
+
+	if (rle_encapsulate(reference, &sdu, 0) != RLE_ENCAP_OK ||
+	    rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+		PRINT_ERROR("SDU not encapsulated.");
+		goto exit_label;
+	}
+
+	if (rle_fragment_bursts(transmitter, 0, burst_sizes, bursts, 4, ppdus, &ppdus_nr) !=
+	    RLE_FRAG_OK || ppdus_nr != 4 ||
+	    rle_transmitter_stats_get_queue_size(transmitter, 0) != 0) {
+		PRINT_ERROR("ALPDU not fragmented in the bursts.");
+		goto exit_label;
+	}
+
+	/* the same PPDUs as one rle_fragment() call per burst */
+	for (i = 0; i < ppdus_nr; i++) {
+		unsigned char *ppdu;
+		size_t ppdu_length;
+
+		if (rle_fragment(reference, 0, burst_sizes[i], &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+		    ppdus[i].status != RLE_FRAG_OK || ppdus[i].ppdu != bursts[i] ||
+		    ppdus[i].ppdu_length != ppdu_length ||
+		    memcmp(ppdus[i].ppdu, ppdu, ppdu_length) != 0) {
+			PRINT_ERROR("PPDU %zu not the one of rle_fragment().", i);
+			goto exit_label;
+		}
+	}
+	if (rle_transmitter_stats_get_counter_sdus_sent(transmitter, 0) !=
+	    rle_transmitter_stats_get_counter_sdus_sent(reference, 0) ||
+	    rle_transmitter_stats_get_counter_bytes_sent(transmitter, 0) !=
+	    rle_transmitter_stats_get_counter_bytes_sent(reference, 0)) {
+		PRINT_ERROR("counters not the ones of rle_fragment().");
+		goto exit_label;
+	}
+
+	/* the fragmentation stops before a burst too small, the ALPDU left is sent later */
+	if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+		PRINT_ERROR("SDU not encapsulated again.");
+		goto exit_label;
+	}
+	if (rle_fragment_bursts(transmitter, 0, too_small_sizes, bursts, 3, ppdus, &ppdus_nr) !=
+	    RLE_FRAG_ERR_BURST_TOO_SMALL || ppdus_nr != 1 ||
+	    rle_transmitter_stats_get_queue_size(transmitter, 0) == 0) {
+		PRINT_ERROR("burst too small not reported.");
+		goto exit_label;
+	}
+	if (rle_fragment_bursts(transmitter, 0, &burst_sizes[1], bursts, 3, ppdus, &ppdus_nr) !=
+	    RLE_FRAG_OK || ppdus_nr != 3 ||
+	    rle_transmitter_stats_get_queue_size(transmitter, 0) != 0 ||
+	    rle_transmitter_stats_get_counter_sdus_sent(transmitter, 0) != 2) {
+		PRINT_ERROR("ALPDU left not fragmented in the next bursts.");
+		goto exit_label;
+	}
+
+	/* the invalid requests are refused */
+	if (rle_fragment_bursts(NULL, 0, burst_sizes, bursts, 4, ppdus, &ppdus_nr) !=
+	    RLE_FRAG_ERR_NULL_TRMT ||
+	    rle_fragment_bursts(transmitter, 0, burst_sizes, bursts, 4, ppdus, &ppdus_nr) !=
+	    RLE_FRAG_ERR_CONTEXT_IS_NULL ||
+	    rle_fragment_bursts(transmitter, 0, NULL, bursts, 4, ppdus, &ppdus_nr) != RLE_FRAG_ERR) {
+		PRINT_ERROR("invalid fragmentation request accepted.");
+		goto exit_label;
+	}
+
+	output = true;
+
+exit_label:
+
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (reference != NULL) {
+		rle_transmitter_destroy(&reference);
+	}
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
 bool test_frag_real_world(void)
 {
 	PRINT_TEST("Fragmentation with realistic values and Configuration.");
@@ -546,3 +546,129 @@ out:
 	printf("\n");
 	return output;
 }
+
+bool test_frag_ctxtless_batch(void)
+{
+	bool output = false;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	/* the SDU of each buffer, 0 for a NULL buffer, and the status expected */
+	const struct {
+		size_t sdu_len;
+		enum rle_frag_status status;
+	} cases[] = {
+		{ 100, RLE_FRAG_OK },
+		{ 0, RLE_FRAG_ERR_NULL_F_BUFF },
+		{ 300, RLE_FRAG_ERR_BURST_TOO_SMALL },
+		{ 40, RLE_FRAG_OK },
+	};
+	const size_t cases_nr = sizeof(cases) / sizeof(cases[0]);
+	const size_t burst_size = 200;
+	struct rle_frag_buf *f_buffs[sizeof(cases) / sizeof(cases[0])] = { NULL };
+	struct rle_ppdu_desc ppdus[sizeof(cases) / sizeof(cases[0])];
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_frag_buf *f_buff_ref = NULL;
+	struct rle_frag_conf *frag_conf;
+	size_t ppdus_nr;
+	size_t i;
+
+	PRINT_TEST("Batch fragmentation with a fragmentation configuration.");
+
+	frag_conf = rle_frag_conf_new(&conf);
+	transmitter = rle_transmitter_new(&conf);
+	f_buff_ref = rle_frag_buf_new();
+	if (!frag_conf || !transmitter || !f_buff_ref) {
+		PRINT_ERROR("Fragmentation configuration, transmitter or buffer not created.");
+		goto out;
+	}
+
+	for (i = 0; i < cases_nr; i++) {
+		const struct rle_sdu sdu = {
+			.buffer = (unsigned char *)payload_initializer,
+			.size = cases[i].sdu_len,
+			.protocol_type = 0x1234,
+		};
+
+		if (cases[i].sdu_len == 0) {
+			continue;
+		}
+		f_buffs[i] = rle_frag_buf_new();
+		if (!f_buffs[i] || rle_frag_buf_init(f_buffs[i]) != 0 ||
+		    rle_frag_buf_cpy_sdu(f_buffs[i], &sdu) != 0) {
+			PRINT_ERROR("Unable to copy SDU in fragmentation buffer.");
+			goto out;
+		}
+	}
+
+	ppdus_nr = rle_frag_contextless_batch(frag_conf, f_buffs, cases_nr, burst_size, ppdus);
+	if (ppdus_nr != 2) {
+		PRINT_ERROR("%zu PPDUs built, expected 2.", ppdus_nr);
+		goto out;
+	}
+
+	for (i = 0; i < cases_nr; i++) {
+		unsigned char *ppdu;
+		size_t ppdu_len = burst_size;
+
+		if (ppdus[i].status != cases[i].status) {
+			PRINT_ERROR("Buffer %zu: status %d, expected %d.", i, ppdus[i].status,
+			            cases[i].status);
+			goto out;
+		}
+		if (cases[i].status != RLE_FRAG_OK) {
+			continue;
+		}
+
+		/* the same PPDU as with the transmitter, for the protocol type of quick_encapsulation() */
+		if (quick_encapsulation(transmitter, f_buff_ref, &cases[i].sdu_len) != true ||
+		    rle_frag_contextless(transmitter, f_buff_ref, &ppdu, &ppdu_len) != RLE_FRAG_OK) {
+			PRINT_ERROR("Unable to fragment the reference PPDU.");
+			goto out;
+		}
+		if (ppdus[i].ppdu_length != ppdu_len ||
+		    memcmp(ppdus[i].ppdu, ppdu, ppdu_len) != 0) {
+			PRINT_ERROR("Buffer %zu: %zu-byte PPDU differs from the %zu-byte reference.", i,
+			            ppdus[i].ppdu_length, ppdu_len);
+			goto out;
+		}
+	}
+
+	if (rle_frag_contextless_batch(NULL, f_buffs, cases_nr, burst_size, ppdus) != 0) {
+		PRINT_ERROR("PPDUs built without fragmentation configuration.");
+		goto out;
+	}
+
+	output = true;
+
+out:
+
+	for (i = 0; i < cases_nr; i++) {
+		if (f_buffs[i]) {
+			rle_frag_buf_del(&f_buffs[i]);
+		}
+	}
+
+	if (f_buff_ref) {
+		rle_frag_buf_del(&f_buff_ref);
+	}
+
+	if (transmitter) {
+		rle_transmitter_destroy(&transmitter);
+	}
+
+	rle_frag_conf_destroy(&frag_conf);
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
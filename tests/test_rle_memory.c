@@ -32,6 +32,7 @@
 #include <setjmp.h> /* required by cmocka header file */
 #include <cmocka.h>
 #include <stdio.h>
+#include <stdbool.h>
 
 void * __real_malloc(size_t size);
 void * __wrap_malloc(size_t size);
@@ -39,6 +40,35 @@ void * __wrap_malloc(size_t size);
 void test_rle_memory_frag_buf_new(void **state);
 void test_rle_memory_transmitter_new(void **state);
 void test_rle_memory_receiver_new(void **state);
+void test_rle_memory_footprint(void **state);
+void test_rle_memory_steady_state(void **state);
+void test_rle_memory_realtime(void **state);
+
+/** Whether the wrapped malloc() counts the allocations instead of following the mocks */
+static bool malloc_counting = false;
+/** The number of allocations counted */
+static size_t malloc_calls = 0;
+/** The number of bytes allocated counted */
+static size_t malloc_bytes = 0;
+
+/** The configuration of the modules of the tests */
+static const struct rle_config memory_conf = {
+	.allow_ptype_omission = 0,
+	.use_compressed_ptype = 0,
+	.allow_alpdu_crc = 0,
+	.allow_alpdu_sequence_number = 1,
+	.use_explicit_payload_header_map = 0,
+	.implicit_protocol_type = 0x00,
+	.implicit_ppdu_label_size = 0,
+	.implicit_payload_label_size = 0,
+	.type_0_alpdu_label_size = 0,
+};
+
+static void malloc_count_start(void);
+static void malloc_count_stop(void);
+static bool round_trip(struct rle_transmitter *const transmitter,
+                       struct rle_receiver *const receiver,
+                       const struct rle_sdu *const sdu);
 
 
 int main(void)
@@ -50,6 +80,9 @@ int main(void)
 		cmocka_unit_test(test_rle_memory_frag_buf_new),
 		cmocka_unit_test(test_rle_memory_transmitter_new),
 		cmocka_unit_test(test_rle_memory_receiver_new),
+		cmocka_unit_test(test_rle_memory_footprint),
+		cmocka_unit_test(test_rle_memory_steady_state),
+		cmocka_unit_test(test_rle_memory_realtime),
 	};
 	test_status = cmocka_run_group_tests(tests, NULL, NULL);
 #else
@@ -57,6 +90,9 @@ int main(void)
 		unit_test(test_rle_memory_frag_buf_new),
 		unit_test(test_rle_memory_transmitter_new),
 		unit_test(test_rle_memory_receiver_new),
+		unit_test(test_rle_memory_footprint),
+		unit_test(test_rle_memory_steady_state),
+		unit_test(test_rle_memory_realtime),
 	};
 	test_status = run_tests(tests);
 #endif
@@ -86,25 +122,26 @@ void test_rle_memory_transmitter_new(void **state __attribute__((unused)))
 		.implicit_payload_label_size = 0,
 		.type_0_alpdu_label_size = 0,
 	};
+	unsigned char buffer[100] = { 0x45 };
+	const struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = 0x0800
+	};
 	struct rle_transmitter *transmitter;
-	size_t i;
 
 	/* transmitter failure */
 	will_return(__wrap_malloc, 0);
 	transmitter = rle_transmitter_new(&conf);
 	assert_true(transmitter == NULL);
 
-	/* context failure */
-	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
-		size_t j;
-		will_return(__wrap_malloc, 1);
-		for (j = 0; j < i; j++) {
-			will_return(__wrap_malloc, 1);
-		}
-		will_return(__wrap_malloc, 0);
-		transmitter = rle_transmitter_new(&conf);
-		assert_true(transmitter == NULL);
-	}
+	/* fragmentation buffer failure, buffers are only allocated on encapsulation */
+	will_return(__wrap_malloc, 1);
+	transmitter = rle_transmitter_new(&conf);
+	assert_true(transmitter != NULL);
+	will_return(__wrap_malloc, 0);
+	assert_true(rle_encapsulate(transmitter, &sdu, 0) == RLE_ENCAP_ERR);
+	rle_transmitter_destroy(&transmitter);
 }
 
 
@@ -129,8 +166,8 @@ void test_rle_memory_receiver_new(void **state __attribute__((unused)))
 	receiver = rle_receiver_new(&conf);
 	assert_true(receiver == NULL);
 
-	/* context failure */
-	for (i = 0; i < RLE_MAX_FRAG_NUMBER * 2; i++) {
+	/* context failure, reassembly storages are only allocated on START PPDUs */
+	for (i = 0; i < RLE_MAX_FRAG_NUMBER; i++) {
 		size_t j;
 		will_return(__wrap_malloc, 1);
 		for (j = 0; j < i; j++) {
@@ -143,13 +180,240 @@ void test_rle_memory_receiver_new(void **state __attribute__((unused)))
 }
 
 
+void test_rle_memory_footprint(void **state __attribute__((unused)))
+{
+	unsigned char buffer[1000] = { 0x45 };
+	const struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = 0x0800
+	};
+	struct rle_memory_footprint footprint;
+	struct rle_memory_footprint created;
+	struct rle_transmitter *transmitter;
+	struct rle_receiver *receiver;
+	struct rle_frag_buf *frag_buf;
+
+	/* the footprint of a new module is what its creation allocated */
+	malloc_count_start();
+	frag_buf = rle_frag_buf_new();
+	malloc_count_stop();
+	assert_true(frag_buf != NULL);
+	assert_int_equal(rle_frag_buf_memory_footprint(frag_buf, &footprint), 0);
+	assert_int_equal(footprint.bytes, malloc_bytes);
+	assert_int_equal(footprint.allocations, malloc_calls);
+	assert_int_equal(footprint.max_bytes, footprint.bytes);
+	print_message("rle_frag_buf_new(): %zu bytes in %zu allocations\n", footprint.bytes,
+	              footprint.allocations);
+	rle_frag_buf_del(&frag_buf);
+
+	malloc_count_start();
+	transmitter = rle_transmitter_new(&memory_conf);
+	malloc_count_stop();
+	assert_true(transmitter != NULL);
+	assert_int_equal(rle_transmitter_memory_footprint(transmitter, &created), 0);
+	assert_int_equal(created.bytes, malloc_bytes);
+	assert_int_equal(created.allocations, malloc_calls);
+	print_message("rle_transmitter_new(): %zu bytes in %zu allocations, up to %zu bytes\n",
+	              created.bytes, created.allocations, created.max_bytes);
+
+	malloc_count_start();
+	receiver = rle_receiver_new(&memory_conf);
+	malloc_count_stop();
+	assert_true(receiver != NULL);
+	assert_int_equal(rle_receiver_memory_footprint(receiver, &footprint), 0);
+	assert_int_equal(footprint.bytes, malloc_bytes);
+	assert_int_equal(footprint.allocations, malloc_calls);
+	print_message("rle_receiver_new(): %zu bytes in %zu allocations, up to %zu bytes\n",
+	              footprint.bytes, footprint.allocations, footprint.max_bytes);
+
+	/* the buffer of the context is allocated on encapsulation, and kept */
+	malloc_count_start();
+	assert_true(rle_encapsulate(transmitter, &sdu, 0) == RLE_ENCAP_OK);
+	malloc_count_stop();
+	assert_int_equal(rle_transmitter_memory_footprint(transmitter, &footprint), 0);
+	assert_int_equal(footprint.bytes - created.bytes, malloc_bytes);
+	assert_int_equal(footprint.allocations - created.allocations, malloc_calls);
+	assert_true(footprint.bytes <= footprint.max_bytes);
+	assert_int_equal(footprint.max_bytes, created.max_bytes);
+
+	/* the queues count with their buffers */
+	malloc_count_start();
+	assert_int_equal(rle_transmitter_set_queue_depth(transmitter, 1, 4), 0);
+	malloc_count_stop();
+	assert_int_equal(rle_transmitter_memory_footprint(transmitter, &created), 0);
+	assert_int_equal(created.bytes - footprint.bytes, malloc_bytes);
+	assert_int_equal(created.allocations - footprint.allocations, malloc_calls);
+	assert_true(created.max_bytes > footprint.max_bytes);
+
+	/* the invalid requests are refused */
+	assert_int_equal(rle_transmitter_memory_footprint(NULL, &footprint), 1);
+	assert_int_equal(rle_transmitter_memory_footprint(transmitter, NULL), 1);
+	assert_int_equal(rle_receiver_memory_footprint(NULL, &footprint), 1);
+	assert_int_equal(rle_receiver_memory_footprint(receiver, NULL), 1);
+	assert_int_equal(rle_frag_buf_memory_footprint(NULL, &footprint), 1);
+
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receiver);
+}
+
+void test_rle_memory_steady_state(void **state __attribute__((unused)))
+{
+	unsigned char buffer[1000] = { 0x45 };
+	const struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = 0x0800
+	};
+	struct rle_transmitter *transmitter;
+	struct rle_receiver *receiver;
+	size_t i;
+
+	malloc_count_start();
+	transmitter = rle_transmitter_new(&memory_conf);
+	receiver = rle_receiver_new(&memory_conf);
+	malloc_count_stop();
+	assert_true(transmitter != NULL && receiver != NULL);
+
+	/* the first SDU allocates the buffer of the context and the reassembly storage */
+	malloc_count_start();
+	assert_true(round_trip(transmitter, receiver, &sdu));
+	malloc_count_stop();
+	print_message("first %zu-byte SDU: %zu bytes in %zu allocations\n", sdu.size,
+	              malloc_bytes, malloc_calls);
+
+	/* then the buffer is kept and the storage recycled */
+	malloc_count_start();
+	for (i = 0; i < 100; i++) {
+		assert_true(round_trip(transmitter, receiver, &sdu));
+	}
+	malloc_count_stop();
+	assert_int_equal(malloc_calls, 0);
+
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receiver);
+}
+
+void test_rle_memory_realtime(void **state __attribute__((unused)))
+{
+	static unsigned char buffer[RLE_MAX_PDU_SIZE] = { 0x45 };
+	const size_t sdu_sizes[] = { 1, 100, 1000, 3000, RLE_MAX_PDU_SIZE };
+	struct rle_config conf = memory_conf;
+	struct rle_transmitter *transmitter;
+	struct rle_receiver *receiver;
+	size_t i;
+	size_t j;
+
+	conf.realtime = 1;
+	malloc_count_start();
+	transmitter = rle_transmitter_new(&conf);
+	receiver = rle_receiver_new(&conf);
+	malloc_count_stop();
+	assert_true(transmitter != NULL && receiver != NULL);
+
+	/* everything is reserved up front, even the first SDU of each size allocates nothing:
+	 * counting restarts from zero, so that only the data path is checked */
+	malloc_count_start();
+	for (i = 0; i < 10; i++) {
+		for (j = 0; j < sizeof(sdu_sizes) / sizeof(sdu_sizes[0]); j++) {
+			const struct rle_sdu sdu = {
+				.buffer = buffer,
+				.size = sdu_sizes[j],
+				.protocol_type = 0x0800
+			};
+
+			assert_true(round_trip(transmitter, receiver, &sdu));
+		}
+	}
+	malloc_count_stop();
+	assert_int_equal(malloc_calls, 0);
+
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receiver);
+}
+
+/*---------------------------------------------------------------------------*/
+/*--------------------------   PRIVATE FUNCTIONS  ---------------------------*/
+/*---------------------------------------------------------------------------*/
+
+/**
+ * @brief Count the allocations, instead of following the mocks
+ */
+static void malloc_count_start(void)
+{
+	malloc_counting = true;
+	malloc_calls = 0;
+	malloc_bytes = 0;
+}
+
+/**
+ * @brief Follow the mocks again, the allocations counted are kept
+ */
+static void malloc_count_stop(void)
+{
+	malloc_counting = false;
+}
+
+/**
+ * @brief Send a SDU through encapsulation, fragmentation, packing and decapsulation
+ *
+ * @param transmitter  The transmitter
+ * @param receiver     The receiver
+ * @param sdu          The SDU, fragmented in 2 FPDUs if it is more than 600-byte long
+ * @return             true if the SDU is decapsulated, else false
+ */
+static bool round_trip(struct rle_transmitter *const transmitter,
+                       struct rle_receiver *const receiver,
+                       const struct rle_sdu *const sdu)
+{
+	static unsigned char buffer_out[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdu_out = { .buffer = buffer_out, .size = 0, .protocol_type = 0 };
+	unsigned char fpdu[600];
+	size_t sdus_total = 0;
+
+	if (rle_encapsulate(transmitter, sdu, 0) != RLE_ENCAP_OK) {
+		return false;
+	}
+
+	while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+		size_t fpdu_cur_pos = 0;
+		size_t fpdu_remain_size = sizeof(fpdu);
+		size_t sdus_nr = 0;
+		unsigned char *ppdu;
+		size_t ppdu_length;
+
+		if (rle_fragment(transmitter, 0, fpdu_remain_size, &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+		    rle_pack(ppdu, ppdu_length, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+		    RLE_PACK_OK) {
+			return false;
+		}
+		rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+		if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), &sdu_out, 1, &sdus_nr, NULL, 0) !=
+		    RLE_DECAP_OK) {
+			return false;
+		}
+		sdus_total += sdus_nr;
+	}
+
+	return (sdus_total == 1 && sdu_out.size == sdu->size);
+}
+
+
 /*---------------------------------------------------------------------------*/
 /*--------------------------   WRAPPED FUNCTIONS  ---------------------------*/
 /*---------------------------------------------------------------------------*/
 
 void * __wrap_malloc(size_t size)
 {
-	void *ptr = mock_ptr_type(void *);
+	void *ptr;
+
+	if (malloc_counting) {
+		malloc_calls++;
+		malloc_bytes += size;
+		return __real_malloc(size);
+	}
+
+	ptr = mock_ptr_type(void *);
 
 	if (ptr != NULL) {
 		return __real_malloc(size);
@@ -29,6 +29,8 @@
 #include "test_rle_misc.h"
 
 #include "rle.h"
+#include "crc.h"
+#include "rle_transmitter.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -37,6 +39,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <netinet/in.h>
+#include <pthread.h>
 
 /** Test configuration structure */
 struct test_request {
@@ -70,6 +73,305 @@ static bool test_request_rle_header_overhead(const enum rle_fpdu_types fpdu_type
                                              const size_t expected_size,
                                              const struct rle_config *const conf);
 
+/**
+ * @brief         Log callback counting the traces per log level.
+ *
+ * @param[in]     module_id                The RLE module.
+ * @param[in]     level                    The log level.
+ * @param[in]     file                     The source file.
+ * @param[in]     line                     The source line.
+ * @param[in]     func                     The function.
+ * @param[in]     message                  The message format.
+ */
+static void count_logs(const int module_id, const int level, const char *const file,
+                       const int line, const char *const func, const char *const message,
+                       ...);
+
+/** Number of traces per log level counted by count_logs() */
+static size_t logs_nr[RLE_LOG_LEVEL_DEBUG + 1];
+
+/**
+ * @brief         Log sink callback counting the logs per log level in its context.
+ *
+ * @param[in,out] context                  The counters, RLE_LOG_LEVEL_DEBUG + 1 of them.
+ * @param[in]     module_id                The RLE module.
+ * @param[in]     level                    The log level.
+ * @param[in]     file                     The source file.
+ * @param[in]     line                     The source line.
+ * @param[in]     func                     The function.
+ * @param[in]     message                  The message format.
+ */
+static void count_sink_logs(void *const context, const int module_id, const int level,
+                            const char *const file, const int line, const char *const func,
+                            const char *const message, ...);
+
+/** Allocations and releases counted by count_alloc() and count_free() */
+struct alloc_counters {
+	size_t allocs_nr;  /**< The number of allocations */
+	size_t frees_nr;   /**< The number of releases    */
+};
+
+/**
+ * @brief         Allocator callback counting the allocations.
+ *
+ * @param[in,out] context                  The counters.
+ * @param[in]     size                     The size of the memory, in bytes.
+ *
+ * @return        The memory if OK, else NULL.
+ */
+static void * count_alloc(void *const context, const size_t size);
+
+/**
+ * @brief         Release callback counting the releases.
+ *
+ * @param[in,out] context                  The counters.
+ * @param[in]     ptr                      The memory.
+ */
+static void count_free(void *const context, void *const ptr);
+
+/**
+ * @brief         Send a SDU in a single COMPLETE PPDU from a transmitter to a receiver.
+ *
+ * @param[in,out] transmitter              The transmitter module.
+ * @param[in,out] receiver                 The receiver module.
+ * @param[in]     sdu                      The SDU to send.
+ * @param[out]    ppdu_length              The length of the PPDU.
+ * @param[out]    sdu_out                  The SDU received, with its buffer.
+ *
+ * @return        true if the SDU is received, else false.
+ */
+static bool send_complete_sdu(struct rle_transmitter *const transmitter,
+                              struct rle_receiver *const receiver,
+                              const struct rle_sdu *const sdu, size_t *const ppdu_length,
+                              struct rle_sdu *const sdu_out);
+
+/**
+ * @brief         Send a SDU in a single COMPLETE PPDU from a transmitter to a receiver, received
+ *                in a buffer of the SDU pool of the receiver.
+ *
+ * @param[in,out] transmitter              The transmitter module.
+ * @param[in,out] receiver                 The receiver module, with a SDU pool.
+ * @param[in]     sdu                      The SDU to send.
+ * @param[out]    sdu_out                  The SDU received, in its pool buffer.
+ * @param[out]    sdus_nr                  The number of SDUs received, 0 or 1.
+ *
+ * @return        The decapsulation status, RLE_DECAP_ERR if the SDU is not sent.
+ */
+static enum rle_decap_status send_pooled_sdu(struct rle_transmitter *const transmitter,
+                                             struct rle_receiver *const receiver,
+                                             const struct rle_sdu *const sdu,
+                                             struct rle_sdu *const sdu_out,
+                                             size_t *const sdus_nr);
+
+/**
+ * @brief         Send a SDU from a transmitter to a receiver in PPDUs of at most 60 bytes, one per
+ *                FPDU, and get the ALPDU trailer told by its START PPDU, if any.
+ *
+ * @param[in,out] transmitter              The transmitter module.
+ * @param[in,out] receiver                 The receiver module.
+ * @param[in]     sdu                      The SDU to send.
+ * @param[out]    sdu_out                  The SDU received, with its buffer.
+ * @param[out]    ppdus_nr                 The number of PPDUs of the SDU.
+ * @param[out]    use_crc                  Whether the START PPDU tells a CRC trailer.
+ *
+ * @return        true if the SDU is received, else false.
+ */
+static bool send_fragmented_sdu(struct rle_transmitter *const transmitter,
+                                struct rle_receiver *const receiver,
+                                const struct rle_sdu *const sdu, struct rle_sdu *const sdu_out,
+                                size_t *const ppdus_nr, bool *const use_crc);
+
+/**
+ * @brief         Thread releasing a SDU buffer to its pool.
+ *
+ * @param[in]     buffer                   The buffer of the SDU.
+ *
+ * @return        NULL.
+ */
+static void * release_sdu_thread(void *const buffer);
+
+/** The SDUs sent by a thread while the counters are fetched and reset by another */
+struct sdus_thread {
+	struct rle_transmitter *transmitter;  /**< The transmitter, used by the thread only */
+	size_t sdus_nr;                       /**< The number of SDUs to send               */
+	size_t sdus_sent;                     /**< The number of SDUs sent                  */
+	bool done;                            /**< Whether the thread is done               */
+};
+
+/**
+ * @brief         Thread sending complete SDUs.
+ *
+ * @param[in,out] context                  The SDUs to send, @see struct sdus_thread.
+ *
+ * @return        NULL.
+ */
+static void * send_sdus_thread(void *const context);
+
+static void count_logs(const int module_id __attribute__((unused)), const int level,
+                       const char *const file __attribute__((unused)),
+                       const int line __attribute__((unused)),
+                       const char *const func __attribute__((unused)),
+                       const char *const message __attribute__((unused)),
+                       ...)
+{
+	if (level >= RLE_LOG_LEVEL_CRI && level <= RLE_LOG_LEVEL_DEBUG) {
+		logs_nr[level]++;
+	}
+}
+
+static void count_sink_logs(void *const context, const int module_id __attribute__((unused)),
+                            const int level, const char *const file __attribute__((unused)),
+                            const int line __attribute__((unused)),
+                            const char *const func __attribute__((unused)),
+                            const char *const message __attribute__((unused)),
+                            ...)
+{
+	size_t *const sink_logs_nr = (size_t *)context;
+
+	if (level >= RLE_LOG_LEVEL_CRI && level <= RLE_LOG_LEVEL_DEBUG) {
+		sink_logs_nr[level]++;
+	}
+}
+
+static void * count_alloc(void *const context, const size_t size)
+{
+	struct alloc_counters *const counters = (struct alloc_counters *)context;
+
+	counters->allocs_nr++;
+
+	return malloc(size);
+}
+
+static void count_free(void *const context, void *const ptr)
+{
+	struct alloc_counters *const counters = (struct alloc_counters *)context;
+
+	counters->frees_nr++;
+	free(ptr);
+}
+
+static bool send_complete_sdu(struct rle_transmitter *const transmitter,
+                              struct rle_receiver *const receiver,
+                              const struct rle_sdu *const sdu, size_t *const ppdu_length,
+                              struct rle_sdu *const sdu_out)
+{
+	unsigned char fpdu[1000];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	size_t sdus_nr = 0;
+	unsigned char *ppdu;
+
+	if (rle_encapsulate(transmitter, sdu, 0) != RLE_ENCAP_OK ||
+	    rle_fragment(transmitter, 0, sizeof(fpdu), &ppdu, ppdu_length) != RLE_FRAG_OK ||
+	    rle_pack(ppdu, *ppdu_length, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+	    RLE_PACK_OK) {
+		return false;
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+
+	return (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdu_out, 1, &sdus_nr, NULL, 0) ==
+	        RLE_DECAP_OK && sdus_nr == 1);
+}
+
+static enum rle_decap_status send_pooled_sdu(struct rle_transmitter *const transmitter,
+                                             struct rle_receiver *const receiver,
+                                             const struct rle_sdu *const sdu,
+                                             struct rle_sdu *const sdu_out,
+                                             size_t *const sdus_nr)
+{
+	unsigned char fpdu[RLE_MAX_PPDU_PL_SIZE + 2];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	size_t ppdu_length;
+	unsigned char *ppdu;
+
+	*sdus_nr = 0;
+	if (rle_encapsulate(transmitter, sdu, 0) != RLE_ENCAP_OK ||
+	    rle_fragment(transmitter, 0, sizeof(fpdu), &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+	    rle_pack(ppdu, ppdu_length, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+	    RLE_PACK_OK) {
+		return RLE_DECAP_ERR;
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+
+	return rle_decapsulate_pooled(receiver, fpdu, sizeof(fpdu), sdu_out, 1, sdus_nr, NULL, 0);
+}
+
+static bool send_fragmented_sdu(struct rle_transmitter *const transmitter,
+                                struct rle_receiver *const receiver,
+                                const struct rle_sdu *const sdu, struct rle_sdu *const sdu_out,
+                                size_t *const ppdus_nr, bool *const use_crc)
+{
+	size_t sdus_nr = 0;
+
+	*ppdus_nr = 0;
+	*use_crc = false;
+	if (rle_encapsulate(transmitter, sdu, 0) != RLE_ENCAP_OK) {
+		return false;
+	}
+	while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+		unsigned char fpdu[60];
+		size_t fpdu_cur_pos = 0;
+		size_t fpdu_remain_size = sizeof(fpdu);
+		unsigned char *ppdu;
+		size_t ppdu_length;
+
+		if (rle_fragment(transmitter, 0, sizeof(fpdu), &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+		    rle_pack(ppdu, ppdu_length, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+		    RLE_PACK_OK) {
+			return false;
+		}
+		if (*ppdus_nr == 0 &&
+		    rle_ppdu_get_fragment_type((const rle_ppdu_hdr_t *)ppdu) == RLE_PDU_START_FRAG) {
+			*use_crc = rle_start_ppdu_hdr_get_use_crc((const rle_ppdu_hdr_start_t *)ppdu);
+		}
+		rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+		if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdu_out, 1, &sdus_nr, NULL, 0) !=
+		    RLE_DECAP_OK) {
+			return false;
+		}
+		(*ppdus_nr)++;
+	}
+
+	return (sdus_nr == 1 && sdu_out->size == sdu->size &&
+	        memcmp(sdu_out->buffer, sdu->buffer, sdu->size) == 0);
+}
+
+static void * release_sdu_thread(void *const buffer)
+{
+	rle_sdu_buffer_release(buffer);
+
+	return NULL;
+}
+
+static void * send_sdus_thread(void *const context)
+{
+	struct sdus_thread *const sdus = (struct sdus_thread *)context;
+	unsigned char sdu_buffer[100];
+	const struct rle_sdu sdu = {
+		.buffer = sdu_buffer,
+		.size = sizeof(sdu_buffer),
+		.protocol_type = RLE_PROTO_TYPE_IPV4_UNCOMP,
+	};
+	size_t i;
+
+	memcpy(sdu_buffer, payload_initializer, sizeof(sdu_buffer));
+	for (i = 0; i < sdus->sdus_nr; i++) {
+		unsigned char *ppdu;
+		size_t ppdu_length;
+
+		if (rle_encapsulate(sdus->transmitter, &sdu, 0) != RLE_ENCAP_OK ||
+		    rle_fragment(sdus->transmitter, 0, RLE_MAX_PPDU_PL_SIZE + 2, &ppdu, &ppdu_length) !=
+		    RLE_FRAG_OK) {
+			break;
+		}
+		sdus->sdus_sent++;
+	}
+	__atomic_store_n(&sdus->done, true, __ATOMIC_RELEASE);
+
+	return NULL;
+}
+
 static char * get_fpdu_type(const enum rle_fpdu_types fpdu_type)
 {
 	switch (fpdu_type) {
@@ -258,6 +560,224 @@ bool test_request_rle_header_overhead_all(void)
 	return output;
 }
 
+bool test_request_alpdu_header_size(void)
+{
+	PRINT_TEST("Request ALPDU header size of protocol types.\n");
+	bool output = true;
+	struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x0d,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	const struct {
+		uint8_t allow_ptype_omission;
+		uint8_t use_compressed_ptype;
+		uint8_t implicit_protocol_type;
+		uint16_t protocol_type;
+		enum rle_header_size_status status;
+		size_t size;
+	} requests[] = {
+		{ 0, 0, 0x0d, RLE_PROTO_TYPE_IPV4_UNCOMP, RLE_HEADER_SIZE_OK, 2 },
+		{ 0, 0, 0x0d, RLE_PROTO_TYPE_VLAN_UNCOMP, RLE_HEADER_SIZE_OK, 2 },
+		{ 0, 1, 0x0d, RLE_PROTO_TYPE_IPV4_UNCOMP, RLE_HEADER_SIZE_OK, 1 },
+		{ 0, 1, 0x0d, RLE_PROTO_TYPE_ARP_UNCOMP, RLE_HEADER_SIZE_OK, 1 },
+		{ 0, 1, 0x0d, 0x1234, RLE_HEADER_SIZE_OK, 3 },
+		{ 0, 1, 0x0d, RLE_PROTO_TYPE_VLAN_UNCOMP, RLE_HEADER_SIZE_ERR_NON_DETERMINISTIC, 0 },
+		{ 1, 1, 0x0d, RLE_PROTO_TYPE_IPV4_UNCOMP, RLE_HEADER_SIZE_OK, 0 },
+		{ 1, 1, 0x0d, RLE_PROTO_TYPE_IPV6_UNCOMP, RLE_HEADER_SIZE_OK, 1 },
+		{ 1, 0, 0x0d, RLE_PROTO_TYPE_SIGNAL_UNCOMP, RLE_HEADER_SIZE_OK, 0 },
+		{ 1, 0, 0x30, RLE_PROTO_TYPE_IPV6_UNCOMP, RLE_HEADER_SIZE_ERR_NON_DETERMINISTIC, 0 },
+		{ 1, 0, 0x30, RLE_PROTO_TYPE_ARP_UNCOMP, RLE_HEADER_SIZE_OK, 2 },
+		{ 1, 1, 0x31, RLE_PROTO_TYPE_VLAN_UNCOMP, RLE_HEADER_SIZE_ERR_NON_DETERMINISTIC, 0 },
+	};
+	const size_t requests_nr = sizeof(requests) / sizeof(requests[0]);
+	enum rle_header_size_status status;
+	size_t size;
+	size_t i;
+
+	for (i = 0; i < requests_nr; i++) {
+		conf.allow_ptype_omission = requests[i].allow_ptype_omission;
+		conf.use_compressed_ptype = requests[i].use_compressed_ptype;
+		conf.implicit_protocol_type = requests[i].implicit_protocol_type;
+		size = 0;
+		status = rle_get_alpdu_header_size(&conf, requests[i].protocol_type, &size);
+		if (status != requests[i].status ||
+		    (status == RLE_HEADER_SIZE_OK && size != requests[i].size)) {
+			PRINT_ERROR("request %zu: status %d and size %zu, %d and %zu expected", i,
+			            status, size, requests[i].status, requests[i].size);
+			output = false;
+		}
+	}
+
+	if (rle_get_alpdu_header_size(NULL, RLE_PROTO_TYPE_IPV4_UNCOMP, &size) !=
+	    RLE_HEADER_SIZE_ERR ||
+	    rle_get_alpdu_header_size(&conf, RLE_PROTO_TYPE_IPV4_UNCOMP, NULL) !=
+	    RLE_HEADER_SIZE_ERR) {
+		PRINT_ERROR("NULL arguments accepted");
+		output = false;
+	}
+
+	/* the protocol type table depends on the implicit protocol type */
+	conf.allow_ptype_omission = 1;
+	for (i = 0; i <= 0xff; i++) {
+		struct rle_transmitter *transmitter;
+
+		conf.implicit_protocol_type = i;
+		transmitter = rle_transmitter_new(&conf);
+		if (!transmitter) {
+			PRINT_ERROR("transmitter not created with implicit protocol type 0x%02zx", i);
+			output = false;
+			continue;
+		}
+		rle_transmitter_destroy(&transmitter);
+	}
+
+	PRINT_TEST_STATUS(output);
+	return output;
+}
+
+bool test_request_overhead_estimate(void)
+{
+	PRINT_TEST("Estimate PPDUs of SDUs in bursts, compared to real fragmentation.\n");
+	bool output = true;
+	struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	const size_t sdu_lengths[] = { 1, 20, 100, 600, 2100, RLE_MAX_PDU_SIZE };
+	const size_t sdu_lengths_nr = sizeof(sdu_lengths) / sizeof(sdu_lengths[0]);
+	const struct {
+		size_t sizes[5];
+		size_t nr;
+	} bursts[] = {
+		{ { 5000 }, 1 },
+		{ { 50, 50, 50, 50, 50 }, 5 },
+		{ { 7, 200, 3, 1000, 6 }, 5 },
+		{ { 2, 30, 2500, 400, 9 }, 5 },
+		{ { 100, 100 }, 2 },
+	};
+	const size_t bursts_nr = sizeof(bursts) / sizeof(bursts[0]);
+	static unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_overhead_estimate estimate;
+	size_t seqnum;
+	size_t i;
+	size_t j;
+
+	for (seqnum = 0; seqnum < 2; seqnum++) {
+		conf.allow_alpdu_crc = !seqnum;
+		conf.allow_alpdu_sequence_number = seqnum;
+
+		for (i = 0; i < sdu_lengths_nr; i++) {
+			for (j = 0; j < bursts_nr; j++) {
+				const struct rle_sdu sdu = {
+					.buffer = buffer,
+					.size = sdu_lengths[i],
+					.protocol_type = RLE_PROTO_TYPE_IPV4_UNCOMP
+				};
+				struct rle_transmitter *transmitter;
+				size_t ppdus_nr = 0;
+				size_t ppdus_bytes = 0;
+				size_t used_bursts_nr = 0;
+				size_t burst;
+
+				if (rle_estimate_overhead(&conf, sdu.size, sdu.protocol_type,
+				                          bursts[j].sizes, bursts[j].nr, &estimate) !=
+				    RLE_HEADER_SIZE_OK) {
+					PRINT_ERROR("SDU %zu, bursts %zu: not estimated", i, j);
+					output = false;
+					continue;
+				}
+
+				transmitter = rle_transmitter_new(&conf);
+				if (transmitter == NULL) {
+					PRINT_ERROR("transmitter not created");
+					output = false;
+					continue;
+				}
+				if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+					PRINT_ERROR("SDU %zu not encapsulated", i);
+					output = false;
+					rle_transmitter_destroy(&transmitter);
+					continue;
+				}
+
+				/* fragment as much as possible in each burst in turn */
+				for (burst = 0; burst < bursts[j].nr; burst++) {
+					size_t room = bursts[j].sizes[burst];
+					bool used = false;
+
+					while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+						const size_t max_room = RLE_MAX_PPDU_PL_SIZE + 2;
+						unsigned char *ppdu;
+						size_t ppdu_length;
+
+						if (rle_fragment(transmitter, 0, (room > max_room ? max_room : room),
+						                 &ppdu, &ppdu_length) != RLE_FRAG_OK) {
+							break;
+						}
+						ppdus_nr++;
+						ppdus_bytes += ppdu_length;
+						room -= ppdu_length;
+						used = true;
+					}
+					if (used) {
+						used_bursts_nr++;
+					}
+				}
+
+				if (estimate.ppdus_nr != ppdus_nr || estimate.ppdus_bytes != ppdus_bytes ||
+				    estimate.bursts_nr != used_bursts_nr ||
+				    estimate.remaining !=
+				    rle_transmitter_stats_get_queue_size(transmitter, 0) ||
+				    (estimate.remaining == 0 &&
+				     estimate.overhead_bytes != ppdus_bytes - sdu.size)) {
+					PRINT_ERROR("SDU %zu, bursts %zu, seqnum %zu: estimated %zu PPDUs %zu "
+					            "bytes in %zu bursts, %zu left, fragmented %zu PPDUs %zu bytes "
+					            "in %zu bursts", i, j, seqnum, estimate.ppdus_nr,
+					            estimate.ppdus_bytes, estimate.bursts_nr, estimate.remaining,
+					            ppdus_nr, ppdus_bytes, used_bursts_nr);
+					output = false;
+				}
+
+				rle_transmitter_destroy(&transmitter);
+			}
+		}
+	}
+
+	/* the ALPDU header of VLAN frames depends on the payload when compressed */
+	if (rle_estimate_overhead(&conf, 100, RLE_PROTO_TYPE_VLAN_UNCOMP, bursts[0].sizes,
+	                          bursts[0].nr, &estimate) != RLE_HEADER_SIZE_ERR_NON_DETERMINISTIC) {
+		PRINT_ERROR("non deterministic ALPDU header not raised");
+		output = false;
+	}
+
+	if (rle_estimate_overhead(NULL, 100, RLE_PROTO_TYPE_IPV4_UNCOMP, bursts[0].sizes,
+	                          bursts[0].nr, &estimate) != RLE_HEADER_SIZE_ERR ||
+	    rle_estimate_overhead(&conf, 100, RLE_PROTO_TYPE_IPV4_UNCOMP, bursts[0].sizes,
+	                          bursts[0].nr, NULL) != RLE_HEADER_SIZE_ERR ||
+	    rle_estimate_overhead(&conf, RLE_MAX_PDU_SIZE + 1, RLE_PROTO_TYPE_IPV4_UNCOMP,
+	                          bursts[0].sizes, bursts[0].nr, &estimate) != RLE_HEADER_SIZE_ERR) {
+		PRINT_ERROR("invalid arguments accepted");
+		output = false;
+	}
+
+	PRINT_TEST_STATUS(output);
+	return output;
+}
+
 bool test_rle_allocation_transmitter(void)
 {
 	bool output = false;
@@ -532,3 +1052,1941 @@ out:
 
 	return output;
 }
+
+bool test_rle_crc_implementation(void)
+{
+	bool output = false;
+	const unsigned char check[] = "123456789";
+	unsigned char data[RLE_MAX_PDU_SIZE + 8];
+	const enum rle_crc_impl impl = rle_crc_get_implementation();
+	size_t offset;
+	size_t length;
+	size_t i;
+
+	PRINT_TEST("RLE CRC32 implementation %d.\n", impl);
+
+	if (impl != RLE_CRC_IMPL_SLICE_BY_8 && impl != RLE_CRC_IMPL_PCLMUL) {
+		PRINT_ERROR("Unknown CRC32 implementation %d.", impl);
+		goto out;
+	}
+
+	if (compute_crc(check, sizeof(check) - 1, RLE_CRC_INIT) != 0x0376e6e7) {
+		PRINT_ERROR("Wrong CRC32 for check string.");
+		goto out;
+	}
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = (unsigned char)(i * 7 + (i >> 8));
+	}
+
+	/* Compare with a computation one octet at a time, on all alignments */
+	for (offset = 0; offset < 8; offset++) {
+		for (length = 0; length <= RLE_MAX_PDU_SIZE; length += (length < 256) ? 1 : 61) {
+			uint32_t expected = RLE_CRC_INIT;
+			uint32_t crc;
+
+			for (i = 0; i < length; i++) {
+				expected = compute_crc(data + offset + i, 1, expected);
+			}
+			crc = compute_crc(data + offset, length, RLE_CRC_INIT);
+
+			if (crc != expected) {
+				PRINT_ERROR("CRC32 mismatch for %zu octets at offset %zu: 0x%08x instead of "
+				            "0x%08x.", length, offset, crc, expected);
+				goto out;
+			}
+		}
+	}
+
+	output = true;
+
+out:
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_log_level(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	/* a COMPLETE PPDU longer than the FPDU, an error is traced */
+	unsigned char fpdu[10] = { 0xc7, 0xff };
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[1] = { { .buffer = buffer, .size = 0, .protocol_type = 0 } };
+	const rle_trace_callback_t old_callback = rle_get_trace_callback();
+	const rle_log_level_t old_level = rle_get_log_level();
+	struct rle_receiver *receiver;
+	size_t sdus_nr;
+
+	PRINT_TEST("RLE log level.\n");
+
+	receiver = rle_receiver_new(&conf);
+	if (receiver == NULL) {
+		PRINT_ERROR("Error allocating receiver.");
+		goto out;
+	}
+
+	rle_set_trace_callback(count_logs);
+
+	if (rle_get_log_level() != RLE_LOG_LEVEL_DEBUG) {
+		PRINT_ERROR("All levels shall be traced by default.");
+		goto restore;
+	}
+
+	rle_set_log_level(RLE_LOG_LEVEL_WARNING);
+	if (rle_get_log_level() != RLE_LOG_LEVEL_WARNING) {
+		PRINT_ERROR("Log level not set.");
+		goto restore;
+	}
+
+	memset(logs_nr, 0, sizeof(logs_nr));
+	if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) ==
+	    RLE_DECAP_OK) {
+		PRINT_ERROR("Invalid FPDU decapsulated.");
+		goto restore;
+	}
+	if (logs_nr[RLE_LOG_LEVEL_ERROR] == 0 || logs_nr[RLE_LOG_LEVEL_DEBUG] != 0) {
+		PRINT_ERROR("%zu errors and %zu debug traces with warning level.",
+		            logs_nr[RLE_LOG_LEVEL_ERROR], logs_nr[RLE_LOG_LEVEL_DEBUG]);
+		goto restore;
+	}
+
+	rle_set_log_level(RLE_LOG_LEVEL_CRI);
+
+	memset(logs_nr, 0, sizeof(logs_nr));
+	if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) ==
+	    RLE_DECAP_OK) {
+		PRINT_ERROR("Invalid FPDU decapsulated.");
+		goto restore;
+	}
+	if (logs_nr[RLE_LOG_LEVEL_ERROR] != 0) {
+		PRINT_ERROR("%zu errors traced with critical level.", logs_nr[RLE_LOG_LEVEL_ERROR]);
+		goto restore;
+	}
+
+	output = true;
+
+restore:
+	rle_set_log_level(old_level);
+	rle_set_trace_callback(old_callback);
+	rle_receiver_destroy(&receiver);
+out:
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_allocator(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct alloc_counters tx_counters = { 0, 0 };
+	struct alloc_counters rx_counters = { 0, 0 };
+	struct alloc_counters lib_counters = { 0, 0 };
+	struct alloc_counters set_counters = { 0, 0 };
+	const struct rle_allocator tx_allocator = { count_alloc, count_free, &tx_counters };
+	const struct rle_allocator rx_allocator = { count_alloc, count_free, &rx_counters };
+	const struct rle_allocator lib_allocator = { count_alloc, count_free, &lib_counters };
+	const struct rle_allocator set_allocator = { count_alloc, count_free, &set_counters };
+	const struct rle_allocator no_free = { count_alloc, NULL, &lib_counters };
+	/* fragmented, so that the receiver takes a reassembly storage */
+	unsigned char buffer[3000];
+	const struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = 0x0800
+	};
+	unsigned char buffer_out[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus_out[1] = { { .buffer = buffer_out, .size = 0, .protocol_type = 0 } };
+	unsigned char fpdu[4000];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	struct rle_receiver_set *set = NULL;
+	struct rle_frag_buf *f = NULL;
+	struct rle_allocator allocator;
+	size_t sdus_nr = 0;
+
+	PRINT_TEST("RLE allocator.\n");
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+	buffer[0] = 0x45;
+
+	if (rle_set_allocator(&no_free) != 1 ||
+	    rle_transmitter_new_with_allocator(&conf, &no_free) != NULL ||
+	    rle_receiver_new_with_allocator(&conf, &no_free) != NULL ||
+	    rle_receiver_set_new_with_allocator(&conf, 3, 1, &no_free) != NULL) {
+		PRINT_ERROR("Allocator without release callback accepted.");
+		goto out;
+	}
+
+	transmitter = rle_transmitter_new_with_allocator(&conf, &tx_allocator);
+	receiver = rle_receiver_new_with_allocator(&conf, &rx_allocator);
+	if (transmitter == NULL || receiver == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+		PRINT_ERROR("SDU not encapsulated.");
+		goto out;
+	}
+	while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+		size_t used_size;
+
+		if (rle_fragment_pack(transmitter, 0, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size,
+		                      &used_size) != RLE_PACK_OK) {
+			PRINT_ERROR("SDU not fragmented.");
+			goto out;
+		}
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+	if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus_out, 1, &sdus_nr, NULL, 0) !=
+	    RLE_DECAP_OK || sdus_nr != 1 || sdus_out[0].size != sdu.size ||
+	    memcmp(sdus_out[0].buffer, sdu.buffer, sdu.size) != 0) {
+		PRINT_ERROR("SDU not decapsulated.");
+		goto out;
+	}
+
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receiver);
+
+	/* the transmitter and its buffer, the receiver, its 8 contexts and 1 storage */
+	if (tx_counters.allocs_nr < 2 || tx_counters.frees_nr != tx_counters.allocs_nr ||
+	    rx_counters.allocs_nr < 10 || rx_counters.frees_nr != rx_counters.allocs_nr) {
+		PRINT_ERROR("%zu/%zu transmitter and %zu/%zu receiver allocations released.",
+		            tx_counters.frees_nr, tx_counters.allocs_nr, rx_counters.frees_nr,
+		            rx_counters.allocs_nr);
+		goto out;
+	}
+
+	/* the receiver set and its table */
+	set = rle_receiver_set_new_with_allocator(&conf, 3, 1, &set_allocator);
+	if (set == NULL) {
+		PRINT_ERROR("Error allocating receiver set.");
+		goto out;
+	}
+	rle_receiver_set_destroy(&set);
+	if (set_counters.allocs_nr != 2 || set_counters.frees_nr != set_counters.allocs_nr) {
+		PRINT_ERROR("%zu/%zu receiver set allocations released.", set_counters.frees_nr,
+		            set_counters.allocs_nr);
+		goto out;
+	}
+
+	/* the library allocator is used without allocator, and kept by the modules */
+	if (rle_set_allocator(&lib_allocator) != 0) {
+		PRINT_ERROR("Library allocator not set.");
+		goto out;
+	}
+	rle_get_allocator(&allocator);
+	f = rle_frag_buf_new();
+	if (rle_set_allocator(NULL) != 0 || f == NULL || allocator.context != &lib_counters) {
+		PRINT_ERROR("Library allocator not used.");
+		goto out;
+	}
+	rle_frag_buf_del(&f);
+	if (lib_counters.allocs_nr != 1 || lib_counters.frees_nr != 1) {
+		PRINT_ERROR("Fragmentation buffer not released with its allocator.");
+		goto out;
+	}
+
+	output = true;
+
+out:
+	rle_frag_buf_del(&f);
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receiver);
+	if (rle_set_allocator(NULL) != 0) {
+		output = false;
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_in_place(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+		.fragment_contexts_nr = 2,
+	};
+	const struct rle_config inv_conf = { .implicit_protocol_type = 0x31 };
+	struct alloc_counters lib_counters = { 0, 0 };
+	const struct rle_allocator lib_allocator = { count_alloc, count_free, &lib_counters };
+	/* fragmented, so that the receiver takes a reassembly storage */
+	unsigned char buffer[3000];
+	const struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = 0x0800
+	};
+	unsigned char buffer_out[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus_out[1] = { { .buffer = buffer_out, .size = 0, .protocol_type = 0 } };
+	unsigned char fpdu[4000];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	const size_t tx_size = rle_transmitter_size(&conf);
+	const size_t rx_size = rle_receiver_size(&conf);
+	unsigned char *tx_mem = NULL;
+	unsigned char *rx_mem = NULL;
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	size_t sdus_nr = 0;
+
+	PRINT_TEST("RLE in-place initialization.\n");
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+	buffer[0] = 0x45;
+
+	if (tx_size == 0 || rx_size == 0 || rle_transmitter_size(&inv_conf) != 0 ||
+	    rle_receiver_size(&inv_conf) != 0) {
+		PRINT_ERROR("Wrong in-place sizes.");
+		goto out;
+	}
+
+	tx_mem = (unsigned char *)aligned_alloc(RLE_IN_PLACE_ALIGNMENT,
+	                                        tx_size + RLE_IN_PLACE_ALIGNMENT);
+	rx_mem = (unsigned char *)aligned_alloc(RLE_IN_PLACE_ALIGNMENT,
+	                                        rx_size + RLE_IN_PLACE_ALIGNMENT);
+	if (tx_mem == NULL || rx_mem == NULL) {
+		PRINT_ERROR("Error allocating memory.");
+		goto out;
+	}
+
+	if (rle_transmitter_init_in_place(tx_mem + 1, tx_size, &conf) != NULL ||
+	    rle_transmitter_init_in_place(tx_mem, tx_size - 1, &conf) != NULL ||
+	    rle_receiver_init_in_place(rx_mem + 1, rx_size, &conf) != NULL ||
+	    rle_receiver_init_in_place(rx_mem, rx_size - 1, &conf) != NULL) {
+		PRINT_ERROR("Misaligned or too small memory accepted.");
+		goto out;
+	}
+
+	/* the memory taken afterwards is counted */
+	if (rle_set_allocator(&lib_allocator) != 0) {
+		PRINT_ERROR("Library allocator not set.");
+		goto out;
+	}
+	transmitter = rle_transmitter_init_in_place(tx_mem, tx_size, &conf);
+	receiver = rle_receiver_init_in_place(rx_mem, rx_size, &conf);
+	if ((void *)transmitter != (void *)tx_mem || (void *)receiver != (void *)rx_mem ||
+	    lib_counters.allocs_nr != 0) {
+		PRINT_ERROR("Transmitter or receiver not initialized in place.");
+		goto out;
+	}
+
+	if (rle_encapsulate(transmitter, &sdu, 1) != RLE_ENCAP_OK ||
+	    rle_encapsulate(transmitter, &sdu, 2) == RLE_ENCAP_OK) {
+		PRINT_ERROR("Wrong encapsulation in place.");
+		goto out;
+	}
+	while (rle_transmitter_stats_get_queue_size(transmitter, 1) > 0) {
+		size_t used_size;
+
+		if (rle_fragment_pack(transmitter, 1, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size,
+		                      &used_size) != RLE_PACK_OK) {
+			PRINT_ERROR("SDU not fragmented.");
+			goto out;
+		}
+	}
+	if (lib_counters.allocs_nr != 0) {
+		PRINT_ERROR("%zu allocations on encapsulation in place.", lib_counters.allocs_nr);
+		goto out;
+	}
+
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+	if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus_out, 1, &sdus_nr, NULL, 0) !=
+	    RLE_DECAP_OK || sdus_nr != 1 || sdus_out[0].size != sdu.size ||
+	    memcmp(sdus_out[0].buffer, sdu.buffer, sdu.size) != 0) {
+		PRINT_ERROR("SDU not decapsulated in place.");
+		goto out;
+	}
+
+	/* the reassembly storage is the only memory taken, and released */
+	rle_transmitter_fini(transmitter);
+	transmitter = NULL;
+	rle_receiver_destroy(&receiver);
+	if (lib_counters.allocs_nr != 1 || lib_counters.frees_nr != 1) {
+		PRINT_ERROR("%zu/%zu allocations released.", lib_counters.frees_nr,
+		            lib_counters.allocs_nr);
+		goto out;
+	}
+
+	output = true;
+
+out:
+	rle_transmitter_fini(transmitter);
+	rle_receiver_fini(receiver);
+	if (rle_set_allocator(NULL) != 0) {
+		output = false;
+	}
+	free(tx_mem);
+	free(rx_mem);
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_timing(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	/* fragmented, so that START and END PPDUs are reassembled */
+	unsigned char buffer[1500];
+	const struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = 0x0800
+	};
+	unsigned char buffer_out[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus_out[1] = { { .buffer = buffer_out, .size = 0, .protocol_type = 0 } };
+	unsigned char fpdu[2000];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	struct rle_timing_histogram histogram;
+	size_t ppdus_nr = 0;
+	size_t sdus_nr = 0;
+	size_t stage;
+
+	PRINT_TEST("RLE timing histograms.\n");
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+	buffer[0] = 0x45;
+
+	transmitter = rle_transmitter_new(&conf);
+	receiver = rle_receiver_new(&conf);
+	if (transmitter == NULL || receiver == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+	rle_pack_timing_reset();
+
+	if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+		PRINT_ERROR("SDU not encapsulated.");
+		goto out;
+	}
+	while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+		unsigned char *ppdu;
+		size_t ppdu_length;
+
+		if (rle_fragment(transmitter, 0, 1000, &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+		    rle_pack(ppdu, ppdu_length, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+		    RLE_PACK_OK) {
+			PRINT_ERROR("SDU not fragmented.");
+			goto out;
+		}
+		ppdus_nr++;
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+	if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus_out, 1, &sdus_nr, NULL, 0) !=
+	    RLE_DECAP_OK || sdus_nr != 1 || ppdus_nr != 2) {
+		PRINT_ERROR("SDU not decapsulated.");
+		goto out;
+	}
+
+	/* the stages of the other module are refused */
+	if (rle_transmitter_timing_get(transmitter, RLE_TIMING_RASM_COMP, &histogram) != 1 ||
+	    rle_receiver_timing_get(receiver, RLE_TIMING_PACK, &histogram) != 1 ||
+	    rle_transmitter_timing_get(NULL, RLE_TIMING_CRC, &histogram) != 1 ||
+	    rle_receiver_timing_get(receiver, RLE_TIMING_RASM_END, NULL) != 1) {
+		PRINT_ERROR("Invalid timing request accepted.");
+		goto out;
+	}
+
+	if (!rle_timing_is_enabled()) {
+		/* built without timing, no histogram is available */
+		if (rle_transmitter_timing_get(transmitter, RLE_TIMING_ALPDU_HDR, &histogram) != 1 ||
+		    rle_receiver_timing_get(receiver, RLE_TIMING_RASM_END, &histogram) != 1 ||
+		    rle_pack_timing_get(&histogram) != 1) {
+			PRINT_ERROR("Histogram available without timing.");
+			goto out;
+		}
+		output = true;
+		goto out;
+	}
+
+	for (stage = 0; stage < RLE_TIMING_STAGES_NR; stage++) {
+		/* the SDU is copied once, then fragmented in one START and one END PPDU */
+		const uint64_t expected_counts[RLE_TIMING_STAGES_NR] = { 1, 0, 1, 2, 2, 0, 1, 1, 0 };
+		uint64_t buckets_sum = 0;
+		size_t bucket;
+		int ret;
+
+		if (stage == RLE_TIMING_PACK) {
+			ret = rle_pack_timing_get(&histogram);
+		} else if (stage < RLE_TIMING_PACK) {
+			ret = rle_transmitter_timing_get(transmitter, stage, &histogram);
+		} else {
+			ret = rle_receiver_timing_get(receiver, stage, &histogram);
+		}
+		for (bucket = 0; bucket < RLE_TIMING_BUCKETS_NR; bucket++) {
+			buckets_sum += histogram.buckets[bucket];
+		}
+		if (ret != 0 || histogram.count != expected_counts[stage] ||
+		    buckets_sum != histogram.count || histogram.max_ns > histogram.total_ns) {
+			PRINT_ERROR("Wrong histogram of stage %zu.", stage);
+			goto out;
+		}
+	}
+
+	rle_transmitter_timing_reset(transmitter);
+	rle_receiver_timing_reset(receiver);
+	if (rle_transmitter_timing_get(transmitter, RLE_TIMING_PPDU_HDR, &histogram) != 0 ||
+	    histogram.count != 0 ||
+	    rle_receiver_timing_get(receiver, RLE_TIMING_RASM_START, &histogram) != 0 ||
+	    histogram.count != 0) {
+		PRINT_ERROR("Histograms not reset.");
+		goto out;
+	}
+
+	output = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_copy_stats(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	/* fragmented, so that START and END PPDUs are reassembled */
+	unsigned char buffer[1500];
+	const struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = 0x0800
+	};
+	unsigned char buffer_out[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus_out[1] = { { .buffer = buffer_out, .size = 0, .protocol_type = 0 } };
+	unsigned char fpdu[2000];
+	size_t fpdu_cur_pos = 0;
+	size_t fpdu_remain_size = sizeof(fpdu);
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	struct rle_copy_counters counters;
+	size_t ppdus_nr = 0;
+	size_t sdus_nr = 0;
+	size_t stage;
+
+	PRINT_TEST("RLE copies counters.\n");
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+	buffer[0] = 0x45;
+
+	transmitter = rle_transmitter_new(&conf);
+	receiver = rle_receiver_new(&conf);
+	if (transmitter == NULL || receiver == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+	rle_pack_copy_stats_reset();
+
+	if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+		PRINT_ERROR("SDU not encapsulated.");
+		goto out;
+	}
+	while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+		unsigned char *ppdu;
+		size_t ppdu_length;
+
+		if (rle_fragment(transmitter, 0, 1000, &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+		    rle_pack(ppdu, ppdu_length, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+		    RLE_PACK_OK) {
+			PRINT_ERROR("SDU not fragmented.");
+			goto out;
+		}
+		ppdus_nr++;
+	}
+	rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+	if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus_out, 1, &sdus_nr, NULL, 0) !=
+	    RLE_DECAP_OK || sdus_nr != 1 || ppdus_nr != 2) {
+		PRINT_ERROR("SDU not decapsulated.");
+		goto out;
+	}
+
+	/* the stages of the other module are refused */
+	if (rle_transmitter_copy_stats_get(transmitter, RLE_COPY_RASM_FRAG, &counters) != 1 ||
+	    rle_receiver_copy_stats_get(receiver, RLE_COPY_PACK, &counters) != 1 ||
+	    rle_transmitter_copy_stats_get(NULL, RLE_COPY_SDU, &counters) != 1 ||
+	    rle_receiver_copy_stats_get(receiver, RLE_COPY_RASM_END, NULL) != 1) {
+		PRINT_ERROR("Invalid copies request accepted.");
+		goto out;
+	}
+
+	if (!rle_copy_stats_is_enabled()) {
+		/* built without the copy statistics, no counter is available */
+		if (rle_transmitter_copy_stats_get(transmitter, RLE_COPY_SDU, &counters) != 1 ||
+		    rle_receiver_copy_stats_get(receiver, RLE_COPY_RASM_END, &counters) != 1 ||
+		    rle_pack_copy_stats_get(&counters) != 1) {
+			PRINT_ERROR("Counters available without the copy statistics.");
+			goto out;
+		}
+		output = true;
+		goto out;
+	}
+
+	for (stage = 0; stage < RLE_COPY_STAGES_NR; stage++) {
+		/* the SDU is copied with its CRC once at each side, the PPDUs are packed with
+		 * rle_pack(), and the reassembled SDU is copied out of its buffer */
+		const struct rle_copy_counters expected[RLE_COPY_STAGES_NR] = {
+			[RLE_COPY_SDU] = { 1, sizeof(buffer), sizeof(buffer) },
+			[RLE_COPY_PACK] = { 2, fpdu_cur_pos, 0 },
+			[RLE_COPY_RASM_FRAG] = { 2, sizeof(buffer), sizeof(buffer) },
+			[RLE_COPY_RASM_END] = { 1, sizeof(buffer), 0 },
+		};
+		int ret;
+
+		if (stage == RLE_COPY_PACK) {
+			/* rle_fragment_pack() is not used, the transmitter did not pack */
+			ret = rle_transmitter_copy_stats_get(transmitter, stage, &counters);
+			if (ret != 0 || counters.calls != 0) {
+				PRINT_ERROR("Wrong counters of the packing of the transmitter.");
+				goto out;
+			}
+			ret = rle_pack_copy_stats_get(&counters);
+		} else if (stage < RLE_COPY_PACK) {
+			ret = rle_transmitter_copy_stats_get(transmitter, stage, &counters);
+		} else {
+			ret = rle_receiver_copy_stats_get(receiver, stage, &counters);
+		}
+		if (ret != 0 || counters.calls != expected[stage].calls ||
+		    counters.bytes_copied != expected[stage].bytes_copied ||
+		    counters.bytes_crc != expected[stage].bytes_crc) {
+			PRINT_ERROR("Wrong counters of stage %zu.", stage);
+			goto out;
+		}
+	}
+
+	rle_transmitter_copy_stats_reset(transmitter);
+	rle_receiver_copy_stats_reset(receiver);
+	rle_pack_copy_stats_reset();
+	if (rle_transmitter_copy_stats_get(transmitter, RLE_COPY_SDU, &counters) != 0 ||
+	    counters.calls != 0 ||
+	    rle_receiver_copy_stats_get(receiver, RLE_COPY_RASM_FRAG, &counters) != 0 ||
+	    counters.calls != 0 || rle_pack_copy_stats_get(&counters) != 0 || counters.calls != 0) {
+		PRINT_ERROR("Counters not reset.");
+		goto out;
+	}
+
+	output = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_size_stats(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	/* a SDU in 2 PPDUs, a SDU in a COMPLETE PPDU, and a SDU in more PPDUs */
+	const struct {
+		size_t sdu_size;
+		size_t burst_size;
+	} sends[] = { { 1500, 1000 }, { 100, 1000 }, { 1500, 400 } };
+	size_t sends_ppdus[sizeof(sends) / sizeof(sends[0])];
+	unsigned char buffer[1500];
+	unsigned char buffer_out[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus_out[1] = { { .buffer = buffer_out, .size = 0, .protocol_type = 0 } };
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	struct rle_size_histogram histogram;
+	size_t send;
+
+	PRINT_TEST("RLE SDU sizes histograms.\n");
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+	buffer[0] = 0x45;
+
+	transmitter = rle_transmitter_new(&conf);
+	receiver = rle_receiver_new(&conf);
+	if (transmitter == NULL || receiver == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	for (send = 0; send < sizeof(sends) / sizeof(sends[0]); send++) {
+		const struct rle_sdu sdu = {
+			.buffer = buffer,
+			.size = sends[send].sdu_size,
+			.protocol_type = 0x0800
+		};
+
+		if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+			PRINT_ERROR("SDU not encapsulated.");
+			goto out;
+		}
+		sends_ppdus[send] = 0;
+		while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+			unsigned char fpdu[1000];
+			size_t fpdu_cur_pos = 0;
+			size_t fpdu_remain_size = sizeof(fpdu);
+			size_t sdus_nr = 0;
+			unsigned char *ppdu;
+			size_t ppdu_length;
+
+			/* one PPDU per FPDU */
+			if (rle_fragment(transmitter, 0, sends[send].burst_size, &ppdu, &ppdu_length) !=
+			    RLE_FRAG_OK ||
+			    rle_pack(ppdu, ppdu_length, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+			    RLE_PACK_OK) {
+				PRINT_ERROR("SDU not fragmented.");
+				goto out;
+			}
+			rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+			if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus_out, 1, &sdus_nr, NULL,
+			                    0) != RLE_DECAP_OK) {
+				PRINT_ERROR("SDU not decapsulated.");
+				goto out;
+			}
+			sends_ppdus[send]++;
+		}
+	}
+	if (sends_ppdus[0] != 2 || sends_ppdus[1] != 1 || sends_ppdus[2] <= 2) {
+		PRINT_ERROR("Wrong fragmentation of the SDUs.");
+		goto out;
+	}
+
+	/* the invalid requests are refused */
+	if (rle_transmitter_stats_get_size_histogram(NULL, 0, &histogram) != 1 ||
+	    rle_transmitter_stats_get_size_histogram(transmitter, RLE_MAX_FRAG_NUMBER,
+	                                             &histogram) != 1 ||
+	    rle_receiver_stats_get_size_histogram(receiver, 0, NULL) != 1 ||
+	    rle_receiver_stats_get_size_histogram(receiver, RLE_SIZE_STATS_COMP_ID + 1,
+	                                          &histogram) != 1) {
+		PRINT_ERROR("Invalid histogram request accepted.");
+		goto out;
+	}
+
+	if (!rle_size_stats_is_enabled()) {
+		/* built without the size statistics, no histogram is available */
+		if (rle_transmitter_stats_get_size_histogram(transmitter, 0, &histogram) != 1 ||
+		    rle_receiver_stats_get_size_histogram(receiver, 0, &histogram) != 1 ||
+		    rle_receiver_stats_get_size_histogram(receiver, RLE_SIZE_STATS_COMP_ID,
+		                                          &histogram) != 1) {
+			PRINT_ERROR("Histograms available without the size statistics.");
+			goto out;
+		}
+		output = true;
+		goto out;
+	}
+
+	/* the transmitter counts the 3 SDUs in their context */
+	if (rle_transmitter_stats_get_size_histogram(transmitter, 0, &histogram) != 0 ||
+	    histogram.sdus != 3 || histogram.bytes != 3100 ||
+	    histogram.ppdus != 3 + sends_ppdus[2] || histogram.sizes[6] != 1 ||
+	    histogram.sizes[10] != 2 || histogram.fragments[0] != 1 ||
+	    histogram.fragments[1] != 1 || histogram.fragments[sends_ppdus[2] - 1] != 1) {
+		PRINT_ERROR("Wrong histograms of the transmitter.");
+		goto out;
+	}
+
+	/* the receiver counts the fragmented SDUs in their context, the other one apart */
+	if (rle_receiver_stats_get_size_histogram(receiver, 0, &histogram) != 0 ||
+	    histogram.sdus != 2 || histogram.bytes != 3000 ||
+	    histogram.ppdus != 2 + sends_ppdus[2] || histogram.sizes[10] != 2 ||
+	    histogram.fragments[1] != 1 || histogram.fragments[sends_ppdus[2] - 1] != 1) {
+		PRINT_ERROR("Wrong histograms of the receiver context.");
+		goto out;
+	}
+	if (rle_receiver_stats_get_size_histogram(receiver, RLE_SIZE_STATS_COMP_ID,
+	                                          &histogram) != 0 ||
+	    histogram.sdus != 1 || histogram.bytes != 100 || histogram.ppdus != 1 ||
+	    histogram.sizes[6] != 1 || histogram.fragments[0] != 1) {
+		PRINT_ERROR("Wrong histograms of the COMPLETE PPDUs.");
+		goto out;
+	}
+
+	/* the histograms are reset with the counters */
+	rle_transmitter_stats_reset_counters(transmitter, 0);
+	rle_receiver_stats_reset_counters(receiver, 0);
+	rle_receiver_stats_reset_counters(receiver, RLE_SIZE_STATS_COMP_ID);
+	if (rle_transmitter_stats_get_size_histogram(transmitter, 0, &histogram) != 0 ||
+	    histogram.sdus != 0 ||
+	    rle_receiver_stats_get_size_histogram(receiver, 0, &histogram) != 0 ||
+	    histogram.sdus != 0 ||
+	    rle_receiver_stats_get_size_histogram(receiver, RLE_SIZE_STATS_COMP_ID,
+	                                          &histogram) != 0 ||
+	    histogram.sdus != 0) {
+		PRINT_ERROR("Histograms not reset.");
+		goto out;
+	}
+
+	output = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_adaptive_ptype(void)
+{
+	bool output = false;
+	struct rle_config conf = {
+		.allow_ptype_omission = 1,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = RLE_PROTO_TYPE_IPV4_COMP,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	unsigned char buffer[100];
+	unsigned char buffer_out[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdu_out = { .buffer = buffer_out, .size = 0, .protocol_type = 0 };
+	const struct rle_sdu arp_sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = RLE_PROTO_TYPE_ARP_UNCOMP
+	};
+	const struct rle_sdu ipv4_sdu = {
+		.buffer = buffer,
+		.size = sizeof(buffer),
+		.protocol_type = RLE_PROTO_TYPE_IPV4_UNCOMP
+	};
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	struct rle_receiver *receiver_wo_omission = NULL;
+	struct rle_tx_pipe *pipe = NULL;
+	uint64_t mix[RLE_PTYPE_CLASSES_NR];
+	size_t arp_ppdu_length = 0;
+	size_t ppdu_length = 0;
+	uint8_t implicit_ptype = 0;
+	unsigned char *ppdu;
+	size_t i;
+
+	PRINT_TEST("RLE adaptive implicit protocol type.\n");
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+	buffer[0] = 0x45;
+
+	transmitter = rle_transmitter_new(&conf);
+	receiver = rle_receiver_new(&conf);
+	conf.allow_ptype_omission = 0;
+	receiver_wo_omission = rle_receiver_new(&conf);
+	if (transmitter == NULL || receiver == NULL || receiver_wo_omission == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	/* ARP is the dominant protocol type, IPv4 the implicit one */
+	for (i = 0; i < 3; i++) {
+		if (!send_complete_sdu(transmitter, receiver, &arp_sdu, &arp_ppdu_length,
+		                       &sdu_out)) {
+			PRINT_ERROR("ARP SDU not sent.");
+			goto out;
+		}
+	}
+	if (!send_complete_sdu(transmitter, receiver, &ipv4_sdu, &ppdu_length, &sdu_out)) {
+		PRINT_ERROR("IPv4 SDU not sent.");
+		goto out;
+	}
+	if (rle_transmitter_stats_get_ptype_mix(transmitter, mix) != 0 ||
+	    mix[RLE_PTYPE_CLASS_IPV4] != 1 || mix[RLE_PTYPE_CLASS_ARP] != 3 ||
+	    mix[RLE_PTYPE_CLASS_IPV6] != 0 || mix[RLE_PTYPE_CLASS_VLAN] != 0 ||
+	    mix[RLE_PTYPE_CLASS_OTHER] != 0) {
+		PRINT_ERROR("Wrong protocol types mix.");
+		goto out;
+	}
+	if (rle_transmitter_suggest_implicit_ptype(transmitter, &implicit_ptype) != 0 ||
+	    implicit_ptype != RLE_PROTO_TYPE_ARP_COMP) {
+		PRINT_ERROR("ARP not suggested as implicit protocol type.");
+		goto out;
+	}
+
+	/* the implicit protocol type is not changed while a SDU is being fragmented */
+	if (rle_encapsulate(transmitter, &arp_sdu, 0) != RLE_ENCAP_OK ||
+	    rle_transmitter_set_implicit_ptype(transmitter, RLE_PROTO_TYPE_ARP_COMP) != 1 ||
+	    rle_fragment(transmitter, 0, 1000, &ppdu, &ppdu_length) != RLE_FRAG_OK) {
+		PRINT_ERROR("Implicit protocol type changed with a context in use.");
+		goto out;
+	}
+
+	/* nor while a SDU encapsulated with it waits in the pipe, a second pipe is refused */
+	pipe = rle_tx_pipe_new(transmitter, 2);
+	if (pipe == NULL || rle_tx_pipe_new(transmitter, 2) != NULL ||
+	    rle_tx_pipe_encapsulate(pipe, &arp_sdu, 0) != RLE_ENCAP_OK ||
+	    rle_transmitter_set_implicit_ptype(transmitter, RLE_PROTO_TYPE_ARP_COMP) != 1 ||
+	    rle_tx_pipe_dispatch(pipe) != 1 ||
+	    rle_fragment(transmitter, 0, 1000, &ppdu, &ppdu_length) != RLE_FRAG_OK) {
+		PRINT_ERROR("Implicit protocol type changed with ALPDUs in the pipe.");
+		goto out;
+	}
+
+	/* both ends change the implicit protocol type at the epoch boundary */
+	if (rle_transmitter_set_implicit_ptype(transmitter, RLE_PROTO_TYPE_ARP_COMP) != 0 ||
+	    rle_receiver_set_implicit_ptype(receiver, RLE_PROTO_TYPE_ARP_COMP) != 0) {
+		PRINT_ERROR("Implicit protocol type not changed.");
+		goto out;
+	}
+	if (rle_transmitter_stats_get_ptype_mix(transmitter, mix) != 0 ||
+	    mix[RLE_PTYPE_CLASS_ARP] != 0) {
+		PRINT_ERROR("Protocol types mix not reset at the epoch.");
+		goto out;
+	}
+
+	/* the ARP protocol type is now omitted, and restored by the receiver */
+	if (!send_complete_sdu(transmitter, receiver, &arp_sdu, &ppdu_length, &sdu_out) ||
+	    ppdu_length + 1 != arp_ppdu_length ||
+	    sdu_out.protocol_type != RLE_PROTO_TYPE_ARP_UNCOMP || sdu_out.size != sizeof(buffer) ||
+	    memcmp(sdu_out.buffer, buffer, sizeof(buffer)) != 0) {
+		PRINT_ERROR("ARP protocol type not omitted.");
+		goto out;
+	}
+	if (!send_complete_sdu(transmitter, receiver, &ipv4_sdu, &ppdu_length, &sdu_out) ||
+	    sdu_out.protocol_type != RLE_PROTO_TYPE_IPV4_UNCOMP) {
+		PRINT_ERROR("IPv4 SDU not sent with ARP implicit.");
+		goto out;
+	}
+	if (rle_transmitter_suggest_implicit_ptype(transmitter, &implicit_ptype) != 0 ||
+	    implicit_ptype != RLE_PROTO_TYPE_ARP_COMP) {
+		PRINT_ERROR("Current implicit protocol type not kept on a tie.");
+		goto out;
+	}
+
+	/* the invalid requests are refused */
+	if (rle_transmitter_set_implicit_ptype(transmitter, RLE_PROTO_TYPE_SIGNAL_COMP) != 1 ||
+	    rle_transmitter_set_implicit_ptype(NULL, RLE_PROTO_TYPE_IPV4_COMP) != 1 ||
+	    rle_receiver_set_implicit_ptype(receiver, RLE_PROTO_TYPE_SIGNAL_COMP) != 1 ||
+	    rle_receiver_set_implicit_ptype(NULL, RLE_PROTO_TYPE_IPV4_COMP) != 1 ||
+	    rle_receiver_set_implicit_ptype(receiver_wo_omission, RLE_PROTO_TYPE_IPV4_COMP) != 1 ||
+	    rle_transmitter_suggest_implicit_ptype(transmitter, NULL) != 1 ||
+	    rle_transmitter_suggest_implicit_ptype(NULL, &implicit_ptype) != 1 ||
+	    rle_transmitter_stats_get_ptype_mix(NULL, mix) != 1) {
+		PRINT_ERROR("Invalid implicit protocol type request accepted.");
+		goto out;
+	}
+
+	output = true;
+
+out:
+	rle_tx_pipe_destroy(&pipe);
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	if (receiver_wo_omission != NULL) {
+		rle_receiver_destroy(&receiver_wo_omission);
+	}
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_log_sink(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	/* the implicit protocol type is VLAN without its protocol type field */
+	const struct rle_config vlan_conf = {
+		.allow_ptype_omission = 1,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x31,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	/* a COMPLETE PPDU longer than the FPDU, an error is traced */
+	unsigned char fpdu[10] = { 0xc7, 0xff };
+	/* a COMPLETE PPDU with a 5-byte VLAN SDU, too short to rebuild its VLAN header */
+	unsigned char vlan_fpdu[10] = { 0xc0, 0x29, 0x01, 0x02, 0x03, 0x04, 0x05 };
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[1] = { { .buffer = buffer, .size = 0, .protocol_type = 0 } };
+	const rle_trace_callback_t old_callback = rle_get_trace_callback();
+	const rle_log_level_t old_level = rle_get_log_level();
+	size_t sink_logs_nr[RLE_LOG_LEVEL_DEBUG + 1];
+	struct rle_log_sink sink = {
+		.callback = count_sink_logs,
+		.context = sink_logs_nr,
+		.level = RLE_LOG_LEVEL_DEBUG,
+	};
+	const struct rle_log_sink no_callback = { .callback = NULL, .context = NULL };
+	struct rle_receiver *receivers[2] = { NULL, NULL };
+	struct rle_receiver *vlan_receiver = NULL;
+	size_t sdus_nr;
+	size_t i;
+
+	PRINT_TEST("RLE log sinks.\n");
+
+	for (i = 0; i < 2; i++) {
+		receivers[i] = rle_receiver_new(&conf);
+		if (receivers[i] == NULL) {
+			PRINT_ERROR("Error allocating receiver.");
+			goto destroy;
+		}
+	}
+	vlan_receiver = rle_receiver_new(&vlan_conf);
+	if (vlan_receiver == NULL) {
+		PRINT_ERROR("Error allocating receiver.");
+		goto destroy;
+	}
+
+	rle_set_trace_callback(count_logs);
+	rle_set_log_level(RLE_LOG_LEVEL_DEBUG);
+
+	if (rle_receiver_set_log_sink(NULL, &sink) == 0 ||
+	    rle_receiver_set_log_sink(receivers[0], &no_callback) == 0 ||
+	    rle_transmitter_set_log_sink(NULL, &sink) == 0) {
+		PRINT_ERROR("Invalid log sink set.");
+		goto restore;
+	}
+	if (rle_receiver_set_log_sink(receivers[0], &sink) != 0) {
+		PRINT_ERROR("Log sink not set.");
+		goto restore;
+	}
+
+	/* the logs of the first receiver go to its sink only, the second one still uses the global
+	 * callback */
+	for (i = 0; i < 2; i++) {
+		memset(logs_nr, 0, sizeof(logs_nr));
+		memset(sink_logs_nr, 0, sizeof(sink_logs_nr));
+		if (rle_decapsulate(receivers[i], fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) ==
+		    RLE_DECAP_OK) {
+			PRINT_ERROR("Invalid FPDU decapsulated.");
+			goto restore;
+		}
+		if ((i == 0 && (sink_logs_nr[RLE_LOG_LEVEL_ERROR] == 0 ||
+		                logs_nr[RLE_LOG_LEVEL_ERROR] != 0)) ||
+		    (i == 1 && (sink_logs_nr[RLE_LOG_LEVEL_ERROR] != 0 ||
+		                logs_nr[RLE_LOG_LEVEL_ERROR] == 0))) {
+			PRINT_ERROR("Receiver %zu: %zu errors in the sink, %zu in the callback.", i,
+			            sink_logs_nr[RLE_LOG_LEVEL_ERROR], logs_nr[RLE_LOG_LEVEL_ERROR]);
+			goto restore;
+		}
+	}
+
+	/* the rebuilding of the suppressed VLAN protocol type logs to the sink too */
+	if (rle_receiver_set_log_sink(vlan_receiver, &sink) != 0) {
+		PRINT_ERROR("Log sink not set.");
+		goto restore;
+	}
+	memset(logs_nr, 0, sizeof(logs_nr));
+	memset(sink_logs_nr, 0, sizeof(sink_logs_nr));
+	if (rle_decapsulate(vlan_receiver, vlan_fpdu, sizeof(vlan_fpdu), sdus, 1, &sdus_nr, NULL,
+	                    0) == RLE_DECAP_OK ||
+	    rle_receiver_stats_get_counter_errors(vlan_receiver, RLE_RCV_ERR_VLAN) != 1) {
+		PRINT_ERROR("Too short VLAN SDU decapsulated.");
+		goto restore;
+	}
+	if (sink_logs_nr[RLE_LOG_LEVEL_ERROR] == 0 || logs_nr[RLE_LOG_LEVEL_ERROR] != 0) {
+		PRINT_ERROR("VLAN SDU: %zu errors in the sink, %zu in the callback.",
+		            sink_logs_nr[RLE_LOG_LEVEL_ERROR], logs_nr[RLE_LOG_LEVEL_ERROR]);
+		goto restore;
+	}
+
+	/* the level of the sink filters its logs, whatever the global level */
+	sink.level = RLE_LOG_LEVEL_CRI;
+	memset(logs_nr, 0, sizeof(logs_nr));
+	memset(sink_logs_nr, 0, sizeof(sink_logs_nr));
+	if (rle_decapsulate(receivers[0], fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) ==
+	    RLE_DECAP_OK) {
+		PRINT_ERROR("Invalid FPDU decapsulated.");
+		goto restore;
+	}
+	if (sink_logs_nr[RLE_LOG_LEVEL_ERROR] != 0 || logs_nr[RLE_LOG_LEVEL_ERROR] != 0) {
+		PRINT_ERROR("%zu errors in the sink, %zu in the callback with critical level.",
+		            sink_logs_nr[RLE_LOG_LEVEL_ERROR], logs_nr[RLE_LOG_LEVEL_ERROR]);
+		goto restore;
+	}
+
+	/* without sink, the global callback is back */
+	if (rle_receiver_set_log_sink(receivers[0], NULL) != 0) {
+		PRINT_ERROR("Log sink not removed.");
+		goto restore;
+	}
+	memset(logs_nr, 0, sizeof(logs_nr));
+	if (rle_decapsulate(receivers[0], fpdu, sizeof(fpdu), sdus, 1, &sdus_nr, NULL, 0) ==
+	    RLE_DECAP_OK) {
+		PRINT_ERROR("Invalid FPDU decapsulated.");
+		goto restore;
+	}
+	if (logs_nr[RLE_LOG_LEVEL_ERROR] == 0) {
+		PRINT_ERROR("No error traced without log sink.");
+		goto restore;
+	}
+
+	output = true;
+
+restore:
+	rle_set_log_level(old_level);
+	rle_set_trace_callback(old_callback);
+destroy:
+	for (i = 0; i < 2; i++) {
+		if (receivers[i] != NULL) {
+			rle_receiver_destroy(&receivers[i]);
+		}
+	}
+	if (vlan_receiver != NULL) {
+		rle_receiver_destroy(&vlan_receiver);
+	}
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_ppdu_hdr_specialization(void)
+{
+	bool output = false;
+	struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	const push_ppdu_hdr_t expected[] = { push_ppdu_hdr_crc, push_ppdu_hdr_seqnum };
+	unsigned char sdu_buffer[200];
+	const struct rle_sdu sdu = {
+		.buffer = sdu_buffer,
+		.size = sizeof(sdu_buffer),
+		.protocol_type = RLE_PROTO_TYPE_IPV4_UNCOMP,
+	};
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	size_t trailer;
+
+	PRINT_TEST("PPDU headers specialized for the ALPDU trailer.\n");
+
+	memset(sdu_buffer, 0x42, sizeof(sdu_buffer));
+
+	for (trailer = 0; trailer < 2; trailer++) {
+		struct rle_sdu sdu_out = { .buffer = buffer, .size = 0, .protocol_type = 0 };
+		size_t ppdus_nr = 0;
+
+		/* the sequence number is used when both trailers are allowed */
+		conf.allow_alpdu_sequence_number = (trailer == 1);
+
+		transmitter = rle_transmitter_new(&conf);
+		receiver = rle_receiver_new(&conf);
+		if (transmitter == NULL || receiver == NULL) {
+			PRINT_ERROR("Error allocating transmitter or receiver.");
+			goto destroy;
+		}
+		if (transmitter->push_ppdu_hdr != expected[trailer]) {
+			PRINT_ERROR("Wrong PPDU header specialization for trailer %zu.", trailer);
+			goto destroy;
+		}
+
+		if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+			PRINT_ERROR("SDU not encapsulated.");
+			goto destroy;
+		}
+
+		/* one FPDU per PPDU, so that the SDU goes through START, CONT and END PPDUs */
+		while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+			unsigned char fpdu[60];
+			size_t fpdu_cur_pos = 0;
+			size_t fpdu_remain_size = sizeof(fpdu);
+			unsigned char *ppdu;
+			size_t ppdu_length;
+			size_t sdus_nr = 0;
+
+			if (rle_fragment(transmitter, 0, sizeof(fpdu), &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+			    rle_pack(ppdu, ppdu_length, NULL, 0, fpdu, &fpdu_cur_pos, &fpdu_remain_size) !=
+			    RLE_PACK_OK) {
+				PRINT_ERROR("PPDU %zu not fragmented or packed.", ppdus_nr);
+				goto destroy;
+			}
+			rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+			if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), &sdu_out, 1, &sdus_nr, NULL, 0) !=
+			    RLE_DECAP_OK) {
+				PRINT_ERROR("FPDU %zu not decapsulated.", ppdus_nr);
+				goto destroy;
+			}
+			ppdus_nr++;
+		}
+
+		if (ppdus_nr < 3 || sdu_out.size != sdu.size ||
+		    memcmp(sdu_out.buffer, sdu.buffer, sdu.size) != 0) {
+			PRINT_ERROR("%zu-byte SDU received from %zu PPDUs, %zu bytes sent.",
+			            sdu_out.size, ppdus_nr, sdu.size);
+			goto destroy;
+		}
+
+		rle_transmitter_destroy(&transmitter);
+		rle_receiver_destroy(&receiver);
+	}
+
+	output = true;
+
+destroy:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_header_templates(void)
+{
+	bool output = false;
+	struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	/* the protocol types with their own header, and one sharing the default header */
+	const struct {
+		uint8_t use_compressed_ptype;
+		uint16_t protocol_type;
+		size_t alpdu_hdr_len;
+		unsigned char alpdu_hdr[3];
+	} cases[] = {
+		{ 0, RLE_PROTO_TYPE_IPV4_UNCOMP, 2, { 0x08, 0x00 } },
+		{ 0, 0x1234, 2, { 0x12, 0x34 } },
+		{ 1, RLE_PROTO_TYPE_IPV4_UNCOMP, 1, { 0x0d } },
+		{ 1, RLE_PROTO_TYPE_ARP_UNCOMP, 1, { 0x0e } },
+		{ 1, 0x1234, 3, { 0xff, 0x12, 0x34 } },
+		{ 1, 0x4321, 3, { 0xff, 0x43, 0x21 } },
+	};
+	unsigned char sdu_buffer[100];
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	size_t i;
+
+	PRINT_TEST("ALPDU and PPDU headers from the templates.\n");
+
+	memset(sdu_buffer, 0x45, sizeof(sdu_buffer));
+
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		const struct rle_sdu sdu = {
+			.buffer = sdu_buffer,
+			.size = sizeof(sdu_buffer),
+			.protocol_type = cases[i].protocol_type,
+		};
+		struct rle_sdu sdu_out = { .buffer = buffer, .size = 0, .protocol_type = 0 };
+		struct rle_transmitter *transmitter;
+		struct rle_receiver *receiver;
+		unsigned char *ppdu;
+		size_t ppdu_length;
+		bool is_ok = false;
+
+		conf.use_compressed_ptype = cases[i].use_compressed_ptype;
+		transmitter = rle_transmitter_new(&conf);
+		receiver = rle_receiver_new(&conf);
+		if (transmitter == NULL || receiver == NULL) {
+			PRINT_ERROR("Error allocating transmitter or receiver.");
+			goto destroy;
+		}
+
+		if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK ||
+		    rle_fragment(transmitter, 0, 1000, &ppdu, &ppdu_length) != RLE_FRAG_OK) {
+			PRINT_ERROR("Case %zu: SDU not encapsulated or fragmented.", i);
+			goto destroy;
+		}
+		/* COMPLETE PPDU of the ALPDU, with the protocol type sent */
+		if (ppdu_length != 2 + cases[i].alpdu_hdr_len + sdu.size ||
+		    ppdu[0] != (0xc0 | ((ppdu_length - 2) >> 5)) ||
+		    ppdu[1] != (((ppdu_length - 2) & 0x1f) << 3) ||
+		    memcmp(ppdu + 2, cases[i].alpdu_hdr, cases[i].alpdu_hdr_len) != 0) {
+			PRINT_ERROR("Case %zu: wrong %zu-byte PPDU header 0x%02x%02x or ALPDU header.",
+			            i, ppdu_length, ppdu[0], ppdu[1]);
+			goto destroy;
+		}
+
+		if (!send_complete_sdu(transmitter, receiver, &sdu, &ppdu_length, &sdu_out) ||
+		    sdu_out.protocol_type != sdu.protocol_type || sdu_out.size != sdu.size) {
+			PRINT_ERROR("Case %zu: SDU of protocol type 0x%04x not received.", i,
+			            sdu.protocol_type);
+			goto destroy;
+		}
+		is_ok = true;
+
+destroy:
+		if (transmitter != NULL) {
+			rle_transmitter_destroy(&transmitter);
+		}
+		if (receiver != NULL) {
+			rle_receiver_destroy(&receiver);
+		}
+		if (!is_ok) {
+			goto out;
+		}
+	}
+
+	output = true;
+
+out:
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_sdu_pool(void)
+{
+	bool output = false;
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	const size_t buffers_nr[RLE_SDU_POOL_CLASSES_NR] = { 2, 1, 1 };
+	const size_t no_buffers_nr[RLE_SDU_POOL_CLASSES_NR] = { 0, 0, 0 };
+	/* the SDUs in turn, and the buffer each of them is expected in */
+	const struct {
+		size_t sdu_size;
+		size_t buffer_size;
+	} cases[] = {
+		{ 100, RLE_SDU_POOL_SMALL_SIZE },
+		{ 40, RLE_SDU_POOL_SMALL_SIZE },
+		{ 100, RLE_SDU_POOL_MEDIUM_SIZE },
+		{ 1000, RLE_SDU_POOL_JUMBO_SIZE },
+	};
+	unsigned char *buffers[sizeof(cases) / sizeof(cases[0])] = { NULL };
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	unsigned char sdu_buffer[1000];
+	struct rle_sdu sdu = {
+		.buffer = sdu_buffer,
+		.size = 0,
+		.protocol_type = RLE_PROTO_TYPE_IPV4_UNCOMP,
+	};
+	struct rle_sdu sdu_out;
+	size_t sdus_nr;
+	pthread_t thread;
+	size_t i;
+
+	PRINT_TEST("SDU buffers taken from the pool of the receiver.\n");
+
+	for (i = 0; i < sizeof(sdu_buffer); i++) {
+		sdu_buffer[i] = (unsigned char)i;
+	}
+
+	transmitter = rle_transmitter_new(&conf);
+	receiver = rle_receiver_new(&conf);
+	if (transmitter == NULL || receiver == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	sdu.size = 100;
+	if (send_pooled_sdu(transmitter, receiver, &sdu, &sdu_out, &sdus_nr) !=
+	    RLE_DECAP_ERR_INV_SDUS) {
+		PRINT_ERROR("SDU received in the pool of a receiver without pool.");
+		goto out;
+	}
+	if (rle_receiver_set_sdu_pool(receiver, no_buffers_nr) == 0 ||
+	    rle_receiver_set_sdu_pool(receiver, buffers_nr) != 0) {
+		PRINT_ERROR("Pool without buffers set, or pool not set.");
+		goto out;
+	}
+
+	for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		sdu.size = cases[i].sdu_size;
+		if (send_pooled_sdu(transmitter, receiver, &sdu, &sdu_out, &sdus_nr) !=
+		    RLE_DECAP_OK || sdus_nr != 1) {
+			PRINT_ERROR("%zu-byte SDU not received in the pool.", sdu.size);
+			goto out;
+		}
+		buffers[i] = sdu_out.buffer;
+		if (sdu_out.size != sdu.size || memcmp(sdu_out.buffer, sdu_buffer, sdu.size) != 0 ||
+		    rle_sdu_buffer_get_size(sdu_out.buffer) != cases[i].buffer_size) {
+			PRINT_ERROR("%zu-byte SDU wrongly received in a %zu-byte buffer.", sdu.size,
+			            rle_sdu_buffer_get_size(sdu_out.buffer));
+			goto out;
+		}
+	}
+
+	/* all the buffers are held */
+	sdu.size = 10;
+	if (send_pooled_sdu(transmitter, receiver, &sdu, &sdu_out, &sdus_nr) !=
+	    RLE_DECAP_ERR_SOME_DROP || sdus_nr != 0) {
+		PRINT_ERROR("SDU received while the pool is empty.");
+		goto out;
+	}
+
+	/* a small buffer released by another thread comes back to the receiver */
+	if (pthread_create(&thread, NULL, release_sdu_thread, buffers[0]) != 0) {
+		PRINT_ERROR("Error creating the releasing thread.");
+		goto out;
+	}
+	pthread_join(thread, NULL);
+	buffers[0] = NULL;
+	if (send_pooled_sdu(transmitter, receiver, &sdu, &sdu_out, &sdus_nr) != RLE_DECAP_OK ||
+	    sdus_nr != 1 || rle_sdu_buffer_get_size(sdu_out.buffer) != RLE_SDU_POOL_SMALL_SIZE ||
+	    memcmp(sdu_out.buffer, sdu_buffer, sdu.size) != 0) {
+		PRINT_ERROR("Released buffer not reused.");
+		goto out;
+	}
+	buffers[0] = sdu_out.buffer;
+
+	/* the buffers outlive the receiver */
+	rle_receiver_destroy(&receiver);
+	if (memcmp(buffers[3], sdu_buffer, cases[3].sdu_size) != 0) {
+		PRINT_ERROR("SDU buffer not valid once the receiver is destroyed.");
+		goto out;
+	}
+
+	output = true;
+
+out:
+	for (i = 0; i < sizeof(buffers) / sizeof(buffers[0]); i++) {
+		if (buffers[i] != NULL) {
+			rle_sdu_buffer_release(buffers[i]);
+		}
+	}
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_protection_policy(void)
+{
+	bool output = false;
+	struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_protection_policy policy = {
+		.burst_size = 60,
+		.seqnum_ppdus_max = 3,
+		.ppdu_loss_ppm = 0,
+		.sdu_loss_ppm_max = 0,
+	};
+	/* the SDUs, the PPDUs of 60 bytes they are sent in, and the trailer of each policy */
+	const struct {
+		size_t sdu_size;
+		size_t ppdus_nr;
+		bool use_crc_wo_loss;
+		bool use_crc_w_loss;
+	} cases[] = {
+		{ 40, 1, false, false },
+		{ 100, 2, false, true },
+		{ 200, 4, true, true },
+	};
+	unsigned char sdu_buffer[200];
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_transmitter *transmitter_seqnum = NULL;
+	struct rle_receiver *receiver = NULL;
+	struct rle_sdu sdu_out = { .buffer = buffer, .size = 0, .protocol_type = 0 };
+	size_t ppdus_nr;
+	bool use_crc;
+	size_t loss;
+	size_t i;
+
+	PRINT_TEST("ALPDU protection chosen per SDU.\n");
+
+	memcpy(sdu_buffer, payload_initializer, sizeof(sdu_buffer));
+
+	transmitter = rle_transmitter_new(&conf);
+	receiver = rle_receiver_new(&conf);
+	conf.allow_alpdu_crc = 0;
+	transmitter_seqnum = rle_transmitter_new(&conf);
+	if (transmitter == NULL || receiver == NULL || transmitter_seqnum == NULL) {
+		PRINT_ERROR("Error allocating transmitters or receiver.");
+		goto out;
+	}
+
+	/* the CRC is chosen for the SDUs of too many PPDUs, then also for the ones likely to lose
+	 * a PPDU on a link losing 20% of them, the receiver following the START PPDUs */
+	for (loss = 0; loss < 2; loss++) {
+		policy.ppdu_loss_ppm = (loss ? 200000 : 0);
+		policy.sdu_loss_ppm_max = 300000;
+		if (rle_transmitter_set_protection_policy(transmitter, &policy) != 0) {
+			PRINT_ERROR("Protection policy not set.");
+			goto out;
+		}
+		for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+			const struct rle_sdu sdu = {
+				.buffer = sdu_buffer,
+				.size = cases[i].sdu_size,
+				.protocol_type = RLE_PROTO_TYPE_IPV4_UNCOMP,
+			};
+			const bool expected_crc =
+				(loss ? cases[i].use_crc_w_loss : cases[i].use_crc_wo_loss);
+
+			if (!send_fragmented_sdu(transmitter, receiver, &sdu, &sdu_out, &ppdus_nr,
+			                         &use_crc) ||
+			    ppdus_nr != cases[i].ppdus_nr || use_crc != expected_crc) {
+				PRINT_ERROR("%zu-byte SDU sent in %zu PPDUs with %s, %zu PPDUs with %s "
+				            "expected.", sdu.size, ppdus_nr, use_crc ? "CRC" : "seqnum",
+				            cases[i].ppdus_nr, expected_crc ? "CRC" : "seqnum");
+				goto out;
+			}
+		}
+	}
+
+	/* the sequence number protects all the SDUs again without policy */
+	if (rle_transmitter_set_protection_policy(transmitter, NULL) != 0) {
+		PRINT_ERROR("Protection policy not unset.");
+		goto out;
+	}
+	{
+		const struct rle_sdu sdu = {
+			.buffer = sdu_buffer,
+			.size = sizeof(sdu_buffer),
+			.protocol_type = RLE_PROTO_TYPE_IPV4_UNCOMP,
+		};
+
+		if (!send_fragmented_sdu(transmitter, receiver, &sdu, &sdu_out, &ppdus_nr, &use_crc) ||
+		    use_crc) {
+			PRINT_ERROR("SDU not protected by a sequence number without policy.");
+			goto out;
+		}
+	}
+
+	/* the invalid requests are refused */
+	policy.burst_size = 4;
+	if (rle_transmitter_set_protection_policy(NULL, NULL) != 1 ||
+	    rle_transmitter_set_protection_policy(transmitter, &policy) != 1 ||
+	    rle_transmitter_set_protection_policy(transmitter_seqnum, NULL) != 0) {
+		PRINT_ERROR("Invalid protection policy request accepted.");
+		goto out;
+	}
+	policy.burst_size = 60;
+	if (rle_transmitter_set_protection_policy(transmitter_seqnum, &policy) != 1) {
+		PRINT_ERROR("Protection policy accepted without the CRC allowed.");
+		goto out;
+	}
+
+	output = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (transmitter_seqnum != NULL) {
+		rle_transmitter_destroy(&transmitter_seqnum);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_stats_fetch_and_reset(void)
+{
+	bool output = false;
+	struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 0,
+		.allow_alpdu_sequence_number = 1,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	unsigned char sdu_buffer[100];
+	const struct rle_sdu sdu = {
+		.buffer = sdu_buffer,
+		.size = sizeof(sdu_buffer),
+		.protocol_type = RLE_PROTO_TYPE_IPV4_UNCOMP,
+	};
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receiver = NULL;
+	struct rle_sdu sdu_out = { .buffer = buffer, .size = 0, .protocol_type = 0 };
+	struct rle_transmitter_stats tx_stats[RLE_MAX_FRAG_NUMBER];
+	struct rle_transmitter_stats tx_total;
+	struct rle_receiver_stats rx_stats[RLE_MAX_FRAG_NUMBER];
+	struct rle_receiver_stats rx_total;
+	struct sdus_thread sdus = { .transmitter = NULL, .sdus_nr = 100000, .sdus_sent = 0,
+	                            .done = false };
+	uint64_t sdus_sent = 0;
+	pthread_t thread;
+	size_t ppdus_nr;
+	bool use_crc;
+	size_t i;
+
+	PRINT_TEST("Statistics fetched and reset in a single pass.\n");
+
+	memcpy(sdu_buffer, payload_initializer, sizeof(sdu_buffer));
+
+	transmitter = rle_transmitter_new(&conf);
+	receiver = rle_receiver_new(&conf);
+	if (transmitter == NULL || receiver == NULL) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	/* the SDUs sent are fetched once, the counters read are reset meanwhile */
+	for (i = 0; i < 3; i++) {
+		if (!send_fragmented_sdu(transmitter, receiver, &sdu, &sdu_out, &ppdus_nr, &use_crc)) {
+			PRINT_ERROR("SDU not sent.");
+			goto out;
+		}
+	}
+	if (rle_transmitter_stats_fetch_and_reset(transmitter, tx_stats, &tx_total) != 0 ||
+	    tx_stats[0].sdus_sent != 3 || tx_total.sdus_in != 3 ||
+	    tx_total.bytes_in != 3 * sdu.size ||
+	    rle_receiver_stats_fetch_and_reset(receiver, rx_stats, &rx_total) != 0 ||
+	    rx_stats[0].sdus_reassembled != 3 || rx_total.sdus_received != 3 ||
+	    rx_total.bytes_reassembled != 3 * sdu.size) {
+		PRINT_ERROR("Wrong counters fetched.");
+		goto out;
+	}
+	if (rle_transmitter_stats_fetch_and_reset(transmitter, NULL, &tx_total) != 0 ||
+	    tx_total.sdus_in != 0 || tx_total.sdus_sent != 0 ||
+	    rle_receiver_stats_fetch_and_reset(receiver, NULL, &rx_total) != 0 ||
+	    rx_total.sdus_received != 0 || rx_total.sdus_reassembled != 0 ||
+	    rle_transmitter_stats_get_counter_sdus_sent(transmitter, 0) != 0 ||
+	    rle_receiver_stats_get_counter_sdus_reassembled(receiver, 0) != 0) {
+		PRINT_ERROR("Counters not reset once fetched.");
+		goto out;
+	}
+
+	/* the counters read and reset count the SDUs since the last fetch only */
+	if (!send_fragmented_sdu(transmitter, receiver, &sdu, &sdu_out, &ppdus_nr, &use_crc) ||
+	    rle_transmitter_stats_get_counter_sdus_sent(transmitter, 0) != 1 ||
+	    rle_receiver_stats_get_counter_sdus_reassembled(receiver, 0) != 1) {
+		PRINT_ERROR("SDU not counted after the fetch.");
+		goto out;
+	}
+	rle_transmitter_stats_reset_counters(transmitter, 0);
+	if (rle_transmitter_stats_fetch_and_reset(transmitter, tx_stats, NULL) != 0 ||
+	    tx_stats[0].sdus_sent != 0 ||
+	    rle_transmitter_stats_fetch_and_reset(NULL, NULL, NULL) != 1 ||
+	    rle_receiver_stats_fetch_and_reset(receiver, NULL, NULL) != 1) {
+		PRINT_ERROR("Wrong counters after a reset, or invalid request accepted.");
+		goto out;
+	}
+
+	/* no SDU is lost while they are fetched from another thread than the one sending them */
+	sdus.transmitter = transmitter;
+	if (pthread_create(&thread, NULL, send_sdus_thread, &sdus) != 0) {
+		PRINT_ERROR("Thread not created.");
+		goto out;
+	}
+	while (!__atomic_load_n(&sdus.done, __ATOMIC_ACQUIRE)) {
+		if (rle_transmitter_stats_fetch_and_reset(transmitter, NULL, &tx_total) != 0) {
+			break;
+		}
+		sdus_sent += tx_total.sdus_sent;
+	}
+	pthread_join(thread, NULL);
+	if (rle_transmitter_stats_fetch_and_reset(transmitter, NULL, &tx_total) != 0 ||
+	    sdus.sdus_sent != sdus.sdus_nr || sdus_sent + tx_total.sdus_sent != sdus.sdus_sent) {
+		PRINT_ERROR("%zu SDUs sent, %llu counted.", sdus.sdus_sent,
+		            (unsigned long long)(sdus_sent + tx_total.sdus_sent));
+		goto out;
+	}
+
+	output = true;
+
+out:
+	if (transmitter != NULL) {
+		rle_transmitter_destroy(&transmitter);
+	}
+	if (receiver != NULL) {
+		rle_receiver_destroy(&receiver);
+	}
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
+
+bool test_rle_realtime(void)
+{
+	bool output = false;
+	struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 0,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+		.realtime = 2,
+	};
+	const size_t sdu_sizes[] = { 1, 100, 1000, 3000, RLE_MAX_PDU_SIZE };
+	struct alloc_counters tx_counters = { 0, 0 };
+	struct alloc_counters rx_counters = { 0, 0 };
+	struct alloc_counters lib_counters = { 0, 0 };
+	const struct rle_allocator tx_allocator = { count_alloc, count_free, &tx_counters };
+	const struct rle_allocator rx_allocator = { count_alloc, count_free, &rx_counters };
+	const struct rle_allocator lib_allocator = { count_alloc, count_free, &lib_counters };
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	unsigned char buffer_out[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus_out[1] = { { .buffer = buffer_out, .size = 0, .protocol_type = 0 } };
+	unsigned char fpdu[1500];
+	struct rle_transmitter *transmitter = NULL;
+	struct rle_receiver *receivers[2] = { NULL, NULL };
+	unsigned char *rx_mem = NULL;
+	size_t rx_size;
+	size_t tx_allocs_nr;
+	size_t rx_allocs_nr;
+	size_t round;
+
+	PRINT_TEST("RLE real-time mode.\n");
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+	buffer[0] = 0x45;
+
+	if (rle_transmitter_new(&conf) != NULL || rle_receiver_new(&conf) != NULL) {
+		PRINT_ERROR("Real-time mode neither 0 nor 1 accepted.");
+		goto out;
+	}
+	conf.realtime = 0;
+	rx_size = rle_receiver_size(&conf);
+	conf.realtime = 1;
+	if (rle_receiver_size(&conf) <= rx_size) {
+		PRINT_ERROR("Reassembly storages not reserved in place.");
+		goto out;
+	}
+	rx_size = rle_receiver_size(&conf);
+
+	/* a queue, so that SDUs are also encapsulated behind the one being fragmented */
+	transmitter = rle_transmitter_new_with_allocator(&conf, &tx_allocator);
+	receivers[0] = rle_receiver_new_with_allocator(&conf, &rx_allocator);
+	rx_mem = (unsigned char *)aligned_alloc(RLE_IN_PLACE_ALIGNMENT, rx_size);
+	if (transmitter == NULL || receivers[0] == NULL || rx_mem == NULL ||
+	    rle_transmitter_set_queue_depth(transmitter, 0, 2) != 0) {
+		PRINT_ERROR("Error allocating transmitter or receiver.");
+		goto out;
+	}
+
+	/* the memory taken by the receiver initialized in place is counted */
+	if (rle_set_allocator(&lib_allocator) != 0) {
+		PRINT_ERROR("Library allocator not set.");
+		goto out;
+	}
+	receivers[1] = rle_receiver_init_in_place(rx_mem, rx_size, &conf);
+	if (receivers[1] == NULL) {
+		PRINT_ERROR("Receiver not initialized in place.");
+		goto out;
+	}
+	tx_allocs_nr = tx_counters.allocs_nr;
+	rx_allocs_nr = rx_counters.allocs_nr;
+
+	/* even the first SDUs of each size allocate nothing */
+	for (round = 0; round < 2 * 5 * sizeof(sdu_sizes) / sizeof(sdu_sizes[0]); round++) {
+		struct rle_receiver *const receiver = receivers[round % 2];
+		const struct rle_sdu sdu = {
+			.buffer = buffer,
+			.size = sdu_sizes[(round / 2) % (sizeof(sdu_sizes) / sizeof(sdu_sizes[0]))],
+			.protocol_type = 0x0800
+		};
+		size_t sdus_total = 0;
+
+		if (rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK ||
+		    rle_encapsulate(transmitter, &sdu, 0) != RLE_ENCAP_OK) {
+			PRINT_ERROR("SDUs of %zu bytes not encapsulated.", sdu.size);
+			goto out;
+		}
+		while (rle_transmitter_stats_get_queue_size(transmitter, 0) > 0) {
+			size_t fpdu_cur_pos = 0;
+			size_t fpdu_remain_size = sizeof(fpdu);
+			size_t used_size;
+			size_t sdus_nr = 0;
+
+			if (rle_fragment_pack(transmitter, 0, NULL, 0, fpdu, &fpdu_cur_pos,
+			                      &fpdu_remain_size, &used_size) != RLE_PACK_OK) {
+				PRINT_ERROR("SDU of %zu bytes not fragmented.", sdu.size);
+				goto out;
+			}
+			rle_pad(fpdu, fpdu_cur_pos, fpdu_remain_size);
+			if (rle_decapsulate(receiver, fpdu, sizeof(fpdu), sdus_out, 1, &sdus_nr, NULL,
+			                    0) != RLE_DECAP_OK) {
+				PRINT_ERROR("FPDU not decapsulated.");
+				goto out;
+			}
+			if (sdus_nr == 1 && (sdus_out[0].size != sdu.size ||
+			                     memcmp(sdus_out[0].buffer, sdu.buffer, sdu.size) != 0)) {
+				PRINT_ERROR("Wrong SDU of %zu bytes decapsulated.", sdu.size);
+				goto out;
+			}
+			sdus_total += sdus_nr;
+		}
+		if (sdus_total != 2) {
+			PRINT_ERROR("%zu SDUs of %zu bytes decapsulated, 2 expected.", sdus_total,
+			            sdu.size);
+			goto out;
+		}
+	}
+	if (tx_counters.allocs_nr != tx_allocs_nr || rx_counters.allocs_nr != rx_allocs_nr ||
+	    lib_counters.allocs_nr != 0) {
+		PRINT_ERROR("%zu transmitter, %zu receiver and %zu in-place receiver allocations "
+		            "in steady state.", tx_counters.allocs_nr - tx_allocs_nr,
+		            rx_counters.allocs_nr - rx_allocs_nr, lib_counters.allocs_nr);
+		goto out;
+	}
+
+	/* the reserved buffers are all released */
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receivers[0]);
+	rle_receiver_destroy(&receivers[1]);
+	if (tx_counters.frees_nr != tx_counters.allocs_nr ||
+	    rx_counters.frees_nr != rx_counters.allocs_nr) {
+		PRINT_ERROR("%zu/%zu transmitter and %zu/%zu receiver allocations released.",
+		            tx_counters.frees_nr, tx_counters.allocs_nr, rx_counters.frees_nr,
+		            rx_counters.allocs_nr);
+		goto out;
+	}
+
+	output = true;
+
+out:
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receivers[0]);
+	rle_receiver_destroy(&receivers[1]);
+	if (rle_set_allocator(NULL) != 0) {
+		output = false;
+	}
+	free(rx_mem);
+
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+
+	return output;
+}
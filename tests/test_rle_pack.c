@@ -432,3 +432,545 @@ bool test_pack_all(void)
 	printf("\n");
 	return output;
 }
+
+bool test_pack_fragment(void)
+{
+	PRINT_TEST("Test fused fragmentation and packing.");
+	bool output = false;
+
+	const size_t sdu_length = 1000;
+	const uint8_t frag_id = 2; /* Arbitrarly */
+	const size_t fpdu_length = 300;
+	const unsigned char label[3] = { 0xaa, 0xbb, 0xcc };
+	const size_t label_length = sizeof(label);
+	unsigned char fpdu_ref[fpdu_length];
+	unsigned char fpdu[fpdu_length];
+	size_t fpdu_ref_pos = 0;
+	size_t fpdu_ref_remaining_length = fpdu_length;
+	size_t fpdu_pos = 0;
+	size_t fpdu_remaining_length = fpdu_length;
+	size_t used_size = 0;
+	size_t nb_fpdus = 0;
+	unsigned char buffer[sdu_length];
+	struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = sdu_length,
+		.protocol_type = 0x0800
+	};
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_transmitter *transmitter_ref;
+	struct rle_transmitter *transmitter;
+
+	transmitter_ref = rle_transmitter_new(&conf);
+	assert(transmitter_ref != NULL);
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+
+	memcpy(buffer, payload_initializer, sdu_length);
+
+	if (rle_encapsulate(transmitter_ref, &sdu, frag_id) != RLE_ENCAP_OK ||
+	    rle_encapsulate(transmitter, &sdu, frag_id) != RLE_ENCAP_OK) {
+		PRINT_ERROR("SDU not encapsulated.");
+		goto exit_label;
+	}
+
+	/* an invalid label is rejected before anything is fragmented */
+	if (rle_fragment_pack(transmitter, frag_id, NULL, label_length, fpdu, &fpdu_pos,
+	                      &fpdu_remaining_length, &used_size) != RLE_PACK_ERR_INVALID_LAB) {
+		PRINT_ERROR("Invalid label not raised");
+		goto exit_label;
+	}
+
+	/* the FPDU label alone does not leave room for a PPDU */
+	fpdu_remaining_length = label_length;
+	if (rle_fragment_pack(transmitter, frag_id, label, label_length, fpdu, &fpdu_pos,
+	                      &fpdu_remaining_length, &used_size) != RLE_PACK_ERR_FPDU_TOO_SMALL ||
+	    fpdu_pos != 0 || used_size != 0) {
+		PRINT_ERROR("FPDU too small not raised");
+		goto exit_label;
+	}
+	fpdu_remaining_length = fpdu_length;
+
+	/* build FPDUs both ways until the ALPDU is exhausted, and compare them */
+	while (rle_transmitter_stats_get_queue_size(transmitter_ref, frag_id) > 0) {
+		unsigned char *ppdu = NULL;
+		size_t ppdu_length = 0;
+		size_t room = fpdu_ref_remaining_length;
+
+		if (fpdu_ref_pos == 0) {
+			if (rle_pack_init(label, label_length, fpdu_ref, &fpdu_ref_pos,
+			                  &fpdu_ref_remaining_length) != RLE_PACK_OK) {
+				PRINT_ERROR("reference FPDU not initialized.");
+				goto exit_label;
+			}
+			room = fpdu_ref_remaining_length;
+		}
+
+		if (rle_fragment(transmitter_ref, frag_id, room, &ppdu, &ppdu_length) != RLE_FRAG_OK ||
+		    rle_pack(ppdu, ppdu_length, label, label_length, fpdu_ref, &fpdu_ref_pos,
+		             &fpdu_ref_remaining_length) != RLE_PACK_OK) {
+			PRINT_ERROR("reference PPDU not packed.");
+			goto exit_label;
+		}
+
+		{
+			const size_t expected_used_size =
+				ppdu_length + (fpdu_pos == 0 ? label_length : 0);
+
+			if (rle_fragment_pack(transmitter, frag_id, label, label_length, fpdu, &fpdu_pos,
+			                      &fpdu_remaining_length, &used_size) != RLE_PACK_OK) {
+				PRINT_ERROR("PPDU not fragmented and packed.");
+				goto exit_label;
+			}
+
+			if (used_size != expected_used_size) {
+				PRINT_ERROR("unexpected used size %zu, expected %zu.", used_size,
+				            expected_used_size);
+				goto exit_label;
+			}
+		}
+
+		if (fpdu_pos != fpdu_ref_pos || fpdu_remaining_length != fpdu_ref_remaining_length ||
+		    memcmp(fpdu_ref, fpdu, fpdu_pos) != 0) {
+			PRINT_ERROR("FPDUs differ.");
+			goto exit_label;
+		}
+
+		/* start a new FPDU when the current one cannot hold another PPDU */
+		if (fpdu_remaining_length <= 2) {
+			fpdu_pos = 0;
+			fpdu_ref_pos = 0;
+			fpdu_remaining_length = fpdu_length;
+			fpdu_ref_remaining_length = fpdu_length;
+			nb_fpdus++;
+		}
+	}
+
+	if (nb_fpdus < 3) {
+		PRINT_ERROR("SDU not spread over several FPDUs.");
+		goto exit_label;
+	}
+
+	if (rle_transmitter_stats_get_queue_size(transmitter, frag_id) != 0 ||
+	    rle_transmitter_stats_get_counter_sdus_sent(transmitter, frag_id) != 1 ||
+	    rle_transmitter_stats_get_counter_bytes_sent(transmitter, frag_id) !=
+	    rle_transmitter_stats_get_counter_bytes_sent(transmitter_ref, frag_id)) {
+		PRINT_ERROR("fused fragmentation and packing not counted.");
+		goto exit_label;
+	}
+
+	/* the context is exhausted, nothing left to pack */
+	if (rle_fragment_pack(transmitter, frag_id, label, label_length, fpdu, &fpdu_pos,
+	                      &fpdu_remaining_length, &used_size) != RLE_PACK_ERR_INVALID_PPDU) {
+		PRINT_ERROR("empty context not raised.");
+		goto exit_label;
+	}
+
+	output = true;
+
+exit_label:
+	rle_transmitter_destroy(&transmitter_ref);
+	rle_transmitter_destroy(&transmitter);
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
+/**
+ * @brief         Build the FPDUs of a burst plan and decapsulate them in burst order.
+ *
+ * @param[in,out] transmitter              The transmitter the plan was built from.
+ * @param[in,out] receiver                 The receiver of the FPDUs.
+ * @param[in]     plan                     The PPDUs of the plan.
+ * @param[in]     plan_nr                  The number of PPDUs in the plan.
+ * @param[in]     burst_sizes              The sizes of the bursts.
+ * @param[in]     bursts_nr                The number of bursts, 4 at most.
+ * @param[in]     label                    The FPDU label, 3 bytes.
+ * @param[in]     sdu_lengths              The sizes of the SDUs expected, in order of delivery.
+ * @param[in]     sdus_nr                  The number of SDUs expected, 4 at most.
+ *
+ * @return        true if OK, else false.
+ */
+static bool test_pack_plan_run(struct rle_transmitter *const transmitter,
+                               struct rle_receiver *const receiver,
+                               const struct rle_burst_plan_ppdu plan[],
+                               const size_t plan_nr,
+                               const size_t burst_sizes[],
+                               const size_t bursts_nr,
+                               const unsigned char label[],
+                               const size_t sdu_lengths[],
+                               const size_t sdus_nr)
+{
+	bool output = false;
+	const size_t label_length = 3;
+	unsigned char fpdus_storage[4][RLE_MAX_PDU_SIZE];
+	unsigned char *fpdus[4];
+	size_t fpdus_pos[4];
+	size_t fpdus_remaining[4];
+	unsigned char sdus_storage[4][RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdus[4];
+	size_t sdus_out_nr = 0;
+	size_t burst;
+	size_t sdu;
+
+	assert(bursts_nr <= 4 && sdus_nr <= 4);
+
+	for (sdu = 0; sdu < 4; sdu++) {
+		sdus[sdu].buffer = sdus_storage[sdu];
+		sdus[sdu].size = RLE_MAX_PDU_SIZE;
+	}
+
+	for (burst = 0; burst < bursts_nr; burst++) {
+		fpdus[burst] = fpdus_storage[burst];
+		fpdus_pos[burst] = 0;
+		fpdus_remaining[burst] = burst_sizes[burst];
+	}
+
+	if (rle_pack_plan(transmitter, plan, plan_nr, label, label_length, fpdus, fpdus_pos,
+	                  fpdus_remaining) != RLE_PACK_OK) {
+		PRINT_ERROR("plan not packed.");
+		goto exit_label;
+	}
+
+	for (burst = 0; burst < bursts_nr; burst++) {
+		unsigned char label_out[3];
+		size_t nr = 0;
+
+		if (fpdus_pos[burst] == 0) {
+			continue;
+		}
+		rle_pad(fpdus[burst], fpdus_pos[burst], fpdus_remaining[burst]);
+
+		if (rle_decapsulate(receiver, fpdus[burst], burst_sizes[burst], sdus + sdus_out_nr,
+		                    4 - sdus_out_nr, &nr, label_out, label_length) != RLE_DECAP_OK) {
+			PRINT_ERROR("FPDU %zu not decapsulated.", burst);
+			goto exit_label;
+		}
+		if (memcmp(label_out, label, label_length) != 0) {
+			PRINT_ERROR("FPDU %zu label differs.", burst);
+			goto exit_label;
+		}
+		sdus_out_nr += nr;
+	}
+
+	if (sdus_out_nr != sdus_nr) {
+		PRINT_ERROR("%zu SDUs decapsulated, %zu expected.", sdus_out_nr, sdus_nr);
+		goto exit_label;
+	}
+	for (sdu = 0; sdu < sdus_nr; sdu++) {
+		if (sdus[sdu].size != sdu_lengths[sdu] ||
+		    memcmp(sdus[sdu].buffer, payload_initializer, sdu_lengths[sdu]) != 0) {
+			PRINT_ERROR("SDU %zu differs.", sdu);
+			goto exit_label;
+		}
+	}
+
+	output = true;
+
+exit_label:
+	return output;
+}
+
+bool test_pack_plan(void)
+{
+	PRINT_TEST("Test burst planning of fragmentation and packing.");
+	bool output = false;
+
+	const unsigned char label[3] = { 0xaa, 0xbb, 0xcc };
+	const size_t label_length = sizeof(label);
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_sdu sdu = {
+		.buffer = buffer,
+		.size = 0,
+		.protocol_type = 0x0800
+	};
+	struct rle_burst_plan_ppdu plan[16];
+	size_t plan_nr = 0;
+	size_t i;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_transmitter *transmitter;
+	struct rle_receiver *receiver;
+
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+	receiver = rle_receiver_new(&conf);
+	assert(receiver != NULL);
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+
+	/* nothing pending, empty plan */
+	{
+		const size_t burst_sizes[] = { 100 };
+
+		if (rle_plan_bursts(transmitter, burst_sizes, 1, label_length, plan, 16,
+		                    &plan_nr) != 0 || plan_nr != 0) {
+			PRINT_ERROR("empty transmitter not planned.");
+			goto exit_label;
+		}
+	}
+
+	/* three SDUs that a greedy fragmentation in context order would cut are sent whole, each one
+	 * in the burst it fits best */
+	{
+		const size_t sdu_lengths[] = { 300, 100, 60 };
+		const size_t burst_sizes[] = { 80, 120, 320 };
+		const size_t expected_bursts[] = { 2, 1, 0 };
+		size_t delivered_lengths[3];
+
+		for (i = 0; i < 3; i++) {
+			sdu.size = sdu_lengths[i];
+			if (rle_encapsulate(transmitter, &sdu, (uint8_t)i) != RLE_ENCAP_OK) {
+				PRINT_ERROR("SDU %zu not encapsulated.", i);
+				goto exit_label;
+			}
+		}
+
+		if (rle_plan_bursts(transmitter, burst_sizes, 3, label_length, plan, 2, &plan_nr) != 1) {
+			PRINT_ERROR("too small plan array not raised.");
+			goto exit_label;
+		}
+
+		if (rle_plan_bursts(transmitter, burst_sizes, 3, label_length, plan, 16,
+		                    &plan_nr) != 0 || plan_nr != 3) {
+			PRINT_ERROR("SDUs not planned whole.");
+			goto exit_label;
+		}
+		for (i = 0; i < plan_nr; i++) {
+			if (plan[i].burst != i || plan[i].burst != expected_bursts[plan[i].frag_id]) {
+				PRINT_ERROR("PPDU %zu of context %u planned in burst %zu.", i, plan[i].frag_id,
+				            plan[i].burst);
+				goto exit_label;
+			}
+			delivered_lengths[i] = sdu_lengths[plan[i].frag_id];
+		}
+
+		if (!test_pack_plan_run(transmitter, receiver, plan, plan_nr, burst_sizes, 3, label,
+		                        delivered_lengths, 3)) {
+			goto exit_label;
+		}
+	}
+
+	/* one SDU larger than every burst is cut in the largest bursts only, in burst order */
+	{
+		const size_t sdu_lengths[] = { 500 };
+		const size_t burst_sizes[] = { 200, 40, 200, 200 };
+		const size_t expected_bursts[] = { 0, 2, 3 };
+
+		sdu.size = sdu_lengths[0];
+		if (rle_encapsulate(transmitter, &sdu, 3) != RLE_ENCAP_OK) {
+			PRINT_ERROR("large SDU not encapsulated.");
+			goto exit_label;
+		}
+
+		if (rle_plan_bursts(transmitter, burst_sizes, 4, label_length, plan, 16,
+		                    &plan_nr) != 0 || plan_nr != 3) {
+			PRINT_ERROR("large SDU not planned in 3 PPDUs.");
+			goto exit_label;
+		}
+		for (i = 0; i < plan_nr; i++) {
+			if (plan[i].frag_id != 3 || plan[i].burst != expected_bursts[i]) {
+				PRINT_ERROR("PPDU %zu planned in burst %zu.", i, plan[i].burst);
+				goto exit_label;
+			}
+		}
+
+		if (!test_pack_plan_run(transmitter, receiver, plan, plan_nr, burst_sizes, 4, label,
+		                        sdu_lengths, 1)) {
+			goto exit_label;
+		}
+	}
+
+	if (rle_transmitter_stats_get_queue_size(transmitter, 3) != 0) {
+		PRINT_ERROR("plan not fully sent.");
+		goto exit_label;
+	}
+
+	output = true;
+
+exit_label:
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receiver);
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}
+
+bool test_pack_superframe(void)
+{
+	PRINT_TEST("Test superframe packing, compared to greedy fused fragmentation and packing.");
+	bool output = false;
+
+	const unsigned char label[3] = { 0xaa, 0xbb, 0xcc };
+	const size_t label_length = sizeof(label);
+	const size_t sdu_lengths[] = { 900, 350, 120, 90, 40 };
+	const size_t sdus_nr = sizeof(sdu_lengths) / sizeof(sdu_lengths[0]);
+	const size_t fpdus_sizes[] = { 400, 300, 300, 200, 150 };
+	const size_t fpdus_nr = sizeof(fpdus_sizes) / sizeof(fpdus_sizes[0]);
+	static unsigned char fpdus_storage[5][400];
+	static unsigned char sdus_storage[8][RLE_MAX_PDU_SIZE];
+	unsigned char *fpdus[5];
+	struct rle_sdu sdus[8];
+	size_t sdus_out_nr = 0;
+	unsigned char buffer[RLE_MAX_PDU_SIZE];
+	struct rle_burst_plan_ppdu plan[32];
+	size_t greedy_padding = 0;
+	size_t greedy_pending = 0;
+	size_t padding = 0;
+	size_t superframe;
+	size_t i;
+
+	const struct rle_config conf = {
+		.allow_ptype_omission = 0,
+		.use_compressed_ptype = 1,
+		.allow_alpdu_crc = 1,
+		.allow_alpdu_sequence_number = 0,
+		.use_explicit_payload_header_map = 0,
+		.implicit_protocol_type = 0x00,
+		.implicit_ppdu_label_size = 0,
+		.implicit_payload_label_size = 0,
+		.type_0_alpdu_label_size = 0,
+	};
+	struct rle_transmitter *transmitter_ref;
+	struct rle_transmitter *transmitter;
+	struct rle_receiver *receiver;
+
+	transmitter_ref = rle_transmitter_new(&conf);
+	assert(transmitter_ref != NULL);
+	transmitter = rle_transmitter_new(&conf);
+	assert(transmitter != NULL);
+	receiver = rle_receiver_new(&conf);
+	assert(receiver != NULL);
+
+	memcpy(buffer, payload_initializer, sizeof(buffer));
+
+	for (i = 0; i < fpdus_nr; i++) {
+		fpdus[i] = fpdus_storage[i];
+	}
+	for (i = 0; i < sdus_nr; i++) {
+		struct rle_sdu sdu = {
+			.buffer = buffer,
+			.size = sdu_lengths[i],
+			.protocol_type = 0x0800
+		};
+
+		if (rle_encapsulate(transmitter_ref, &sdu, (uint8_t)i) != RLE_ENCAP_OK ||
+		    rle_encapsulate(transmitter, &sdu, (uint8_t)i) != RLE_ENCAP_OK) {
+			PRINT_ERROR("SDU %zu not encapsulated.", i);
+			goto exit_label;
+		}
+	}
+	for (i = 0; i < 8; i++) {
+		sdus[i].buffer = sdus_storage[i];
+		sdus[i].size = RLE_MAX_PDU_SIZE;
+	}
+
+	/* reference: fill each FPDU in turn with the contexts in order, as long as PPDUs fit */
+	for (i = 0; i < fpdus_nr; i++) {
+		size_t fpdu_pos = 0;
+		size_t fpdu_remaining_length = fpdus_sizes[i];
+		size_t used_size;
+		uint8_t frag_id;
+
+		for (frag_id = 0; frag_id < sdus_nr; frag_id++) {
+			while (rle_fragment_pack(transmitter_ref, frag_id, label, label_length, fpdus[i],
+			                         &fpdu_pos, &fpdu_remaining_length,
+			                         &used_size) == RLE_PACK_OK) {
+			}
+		}
+		greedy_padding += fpdu_remaining_length;
+	}
+	for (i = 0; i < sdus_nr; i++) {
+		greedy_pending += rle_transmitter_stats_get_queue_size(transmitter_ref, (uint8_t)i);
+	}
+
+	if (rle_pack_superframe(transmitter, label, label_length, fpdus, fpdus_sizes, fpdus_nr, plan,
+	                        1, &padding) != RLE_PACK_ERR) {
+		PRINT_ERROR("too small plan array not raised.");
+		goto exit_label;
+	}
+
+	/* two superframes are needed, the first one is filled as much as possible, with fewer
+	 * fragments than the greedy packing, so with fewer PPDU headers and more ALPDU bytes */
+	for (superframe = 0; superframe < 2; superframe++) {
+		size_t pending = 0;
+
+		if (rle_pack_superframe(transmitter, label, label_length, fpdus, fpdus_sizes, fpdus_nr,
+		                        plan, 32, &padding) != RLE_PACK_OK) {
+			PRINT_ERROR("superframe %zu not packed.", superframe);
+			goto exit_label;
+		}
+
+		for (i = 0; i < sdus_nr; i++) {
+			pending += rle_transmitter_stats_get_queue_size(transmitter, (uint8_t)i);
+		}
+
+		if (superframe == 0) {
+			if (pending == 0 || (pending + padding) > (greedy_pending + greedy_padding) ||
+			    padding > (3 * fpdus_nr)) {
+				PRINT_ERROR("%zu padding bytes and %zu bytes pending, %zu and %zu for greedy "
+				            "packing.", padding, pending, greedy_padding, greedy_pending);
+				goto exit_label;
+			}
+		} else if (pending != 0) {
+			PRINT_ERROR("%zu bytes still pending.", pending);
+			goto exit_label;
+		}
+
+		for (i = 0; i < fpdus_nr; i++) {
+			unsigned char label_out[3];
+			size_t nr = 0;
+
+			if (rle_decapsulate(receiver, fpdus[i], fpdus_sizes[i], sdus + sdus_out_nr,
+			                    8 - sdus_out_nr, &nr, label_out,
+			                    label_length) != RLE_DECAP_OK ||
+			    memcmp(label_out, label, label_length) != 0) {
+				PRINT_ERROR("FPDU %zu of superframe %zu not decapsulated.", i, superframe);
+				goto exit_label;
+			}
+			sdus_out_nr += nr;
+		}
+	}
+
+	if (sdus_out_nr != sdus_nr) {
+		PRINT_ERROR("%zu SDUs decapsulated, %zu expected.", sdus_out_nr, sdus_nr);
+		goto exit_label;
+	}
+	for (i = 0; i < sdus_out_nr; i++) {
+		if (memcmp(sdus[i].buffer, payload_initializer, sdus[i].size) != 0) {
+			PRINT_ERROR("SDU %zu differs.", i);
+			goto exit_label;
+		}
+	}
+
+	output = true;
+
+exit_label:
+	rle_transmitter_destroy(&transmitter_ref);
+	rle_transmitter_destroy(&transmitter);
+	rle_receiver_destroy(&receiver);
+	PRINT_TEST_STATUS(output);
+	printf("\n");
+	return output;
+}